@@ -73,6 +73,9 @@ be used for advertising or product endorsement purposes.
 #endif
 #include <stdio.h>
 #include "silo_hdf5_private.h"
+#if HAVE_UNISTD_H
+#include <unistd.h> /*pread*/
+#endif
 #include "H5FDsilo.h"
 #if defined(HAVE_HDF5_H) && defined(HAVE_LIBHDF5) /* [ */
 
@@ -186,6 +189,10 @@ be used for advertising or product endorsement purposes.
 /* For Lindstrom compression libs */
 #define DB_HDF5_HZIP_ID (H5Z_FILTER_RESERVED+1)
 #define DB_HDF5_FPZIP_ID (H5Z_FILTER_RESERVED+2)
+
+/* Registered with The HDF Group, see the LZ4 and Zstandard section */
+#define DB_HDF5_LZ4_ID  32004
+#define DB_HDF5_ZSTD_ID 32015
 #ifdef HAVE_HZIP
 #include "hzip.h"
 #ifdef HAVE_LIBZ
@@ -201,6 +208,16 @@ static const unsigned SILO_HZIP_PERMUTATION[4] = {0,0,((unsigned) (0x00002130)),
 #include "H5Zzfp.h"
 extern void zfp_init_zfp();
 #endif
+#ifdef HAVE_ZSTD
+#include "zstd.h"
+#endif
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 /* Defining these to check overhead of PROTECT */
 #if 0
@@ -245,6 +262,30 @@ PRIVATE int hdf2silo_type(hid_t type);
 PRIVATE int db_hdf5_WriteCKZ(DBfile *_dbfile, char const *vname, void const *var,
               int const *dims, int ndims, int datatype, int nofilters);
 PRIVATE int db_hdf5_getslink(hid_t cwg, char const *in_candidate_link, char *out_target);
+PRIVATE void db_hdf5_stats(hid_t dset, hid_t mtype, hid_t mspace, int writing);
+
+/* Raw data staged by db_hdf5_StageObjects for db_hdf5_comprd */
+typedef struct db_hdf5_staged_t {
+    char                *name;          /* as referenced from object */
+    haddr_t             addr;           /* offset of data in file */
+    size_t              nbytes;         /* size of data in file */
+    hid_t               ftype;          /* file type of data */
+    int                 nelmts;         /* number of elements */
+    unsigned char const *data;          /* data within a staged range */
+} db_hdf5_staged_t;
+
+typedef struct db_hdf5_stage_t {
+    void                *handle;        /* VFD handle of the file read */
+    int                 n;              /* number of staged datasets */
+    int                 max;            /* allocated size of ds */
+    db_hdf5_staged_t    *ds;            /* staged datasets */
+    int                 nbufs;          /* number of ranges read */
+    unsigned char       **bufs;         /* buffers of ranges read */
+} db_hdf5_stage_t;
+
+PRIVATE db_hdf5_staged_t const *db_hdf5_stage_find(DBfile_hdf5 *dbfile, char const *name);
+PRIVATE void db_hdf5_stage_free(DBfile_hdf5 *dbfile);
+PRIVATE void db_hdf5_autocomp_finish(DBfile_hdf5 *dbfile);
 
 /* callbacks prototypes for file image ops */
 #if HDF5_VERSION_GE(1,8,9)
@@ -447,6 +488,9 @@ typedef struct DBquadvar_mt {
     int                 extensive;
     int                 centering;
     double              missing_value;
+    int                 has_range;
+    double              min_value;
+    double              max_value;
 } DBquadvar_mt;
 static hid_t    DBquadvar_mt5;
 
@@ -507,6 +551,9 @@ typedef struct DBucdvar_mt {
     int                 conserved;
     int                 extensive;
     double              missing_value;
+    int                 has_range;
+    double              min_value;
+    double              max_value;
 } DBucdvar_mt;
 static hid_t    DBucdvar_mt5;
 
@@ -617,6 +664,7 @@ typedef struct DBmultimesh_mt {
     int                 repr_block_idx;
     char                alt_nodenum_vars[256];
     char                alt_zonenum_vars[256];
+    char                bvh[256];
 } DBmultimesh_mt;
 static hid_t    DBmultimesh_mt5;
 
@@ -662,6 +710,7 @@ typedef struct DBmultivar_mt {
     int                 empty_cnt;
     int                 repr_block_idx;
     double              missing_value;
+    char                bvh[256];
 } DBmultivar_mt;
 static hid_t    DBmultivar_mt5;
 
@@ -756,6 +805,8 @@ typedef struct DBpointmesh_mt {
     char                ghost_node_labels[256];
     int                 gnznodtype;
     char                alt_nodenum_vars[256];
+    char                perm[256];
+    char                chunkidx[256];
 } DBpointmesh_mt;
 static hid_t    DBpointmesh_mt5;
 
@@ -848,12 +899,18 @@ static hid_t    T_llong = -1;
 static hid_t    T_float = -1;
 static hid_t    T_double = -1;
 static hid_t    T_str256 = -1;
+static hid_t    T_half = -1;
+static hid_t    T_bfloat16 = -1;
 static hid_t    SCALAR = -1;
 static hid_t    P_crprops = -1;
 static hid_t    P_ckcrprops = -1;
 static hid_t    P_rdprops = -1;
 static hid_t    P_ckrdprops = -1;
 
+/* METHOD=AUTO state for the dataset being created; see db_hdf5_autocomp_select */
+static char     db_hdf5_autocomp_params[1024];  /*params w/chosen method   */
+static int      db_hdf5_autocomp_active = 0;    /*a choice is in effect    */
+
 #define OPT(V)          ((V)?(V):"")
 #define OFFSET(P,F)     ((char*)&((P).F)-(char*)&(P))
 #define ENDOF(S)        ((S)+strlen(S))
@@ -1156,6 +1213,497 @@ db_hdf5_fpzip_filter_op(unsigned int flags, size_t cd_nelmts,
 static H5Z_class_t db_hdf5_fpzip_class;
 #endif /* HAVE_FPZIP } */
 
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_compression
+ *
+ * Purpose:     Return the compression parameters in effect for the dataset
+ *              being created. These are the file's parameters except when
+ *              they call for METHOD=AUTO in which case they are the
+ *              parameters with the method chosen for the dataset.
+ *
+ * Return:      Parameter string or NULL if no compression is to be used.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE char const *
+db_hdf5_compression(DBfile *dbfile)
+{
+    char const *params = DBGetCompressionFile(dbfile);
+
+    if (!params || !strstr(params, "METHOD=AUTO"))
+        return params;
+    if (db_hdf5_autocomp_active && db_hdf5_autocomp_params[0])
+        return db_hdf5_autocomp_params;
+    return 0;
+}
+
+/* The following section of code trims the precision of floating point
+   data ahead of shuffle and GZIP, SZIP, ZSTD or LZ4 compression.
+
+   The least significant bits of the mantissa of simulation data are
+   largely noise and defeat lossless compressors. The mantissa of each
+   value is rounded to nearest (ties to even) at the number of bits
+   requested with PRECISION= or DIGITS= in the compression string and
+   the remaining bits are zeroed. Shuffle then groups those zeros into
+   long runs the compressors do well with. NaNs and infinities are
+   untouched and values which would round up to infinity are truncated
+   instead.
+
+   The rounding is done to a copy of the caller's data just before it is
+   written. The file holds ordinary data compressed with ordinary filters
+   so nothing is needed to undo the rounding and any HDF5 reader with the
+   compression filter can read it.
+
+*/
+
+/* The loops below are free of branches so that compilers vectorize them */
+static void
+db_hdf5_groom_float(unsigned int *u, size_t n, int keepbits)
+{
+    int const drop = 23 - keepbits;
+    unsigned int const emask = 0x7F800000;
+    unsigned int const mask = ~((1U << drop) - 1);
+    unsigned int const half = (1U << (drop - 1)) - 1;
+    size_t i;
+
+    for (i = 0; i < n; i++)
+    {
+        unsigned int const x = u[i];
+        unsigned int const r = (x + half + ((x >> drop) & 1)) & mask;
+        unsigned int const t = (r & emask) == emask ? x & mask : r;
+        u[i] = (x & emask) == emask ? x : t;
+    }
+}
+
+static void
+db_hdf5_groom_double(unsigned long long *u, size_t n, int keepbits)
+{
+    int const drop = 52 - keepbits;
+    unsigned long long const emask = 0x7FF0000000000000ULL;
+    unsigned long long const mask = ~((1ULL << drop) - 1);
+    unsigned long long const half = (1ULL << (drop - 1)) - 1;
+    size_t i;
+
+    for (i = 0; i < n; i++)
+    {
+        unsigned long long const x = u[i];
+        unsigned long long const r = (x + half + ((x >> drop) & 1)) & mask;
+        unsigned long long const t = (r & emask) == emask ? x & mask : r;
+        u[i] = (x & emask) == emask ? x : t;
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_groom_bits
+ *
+ * Purpose:     Parse the PRECISION= and DIGITS= parameters for GZIP,
+ *              SZIP, ZSTD and LZ4 compression.
+ *
+ * Return:      Success:        Number of mantissa bits to keep or 0 if
+ *                              the precision is not to be trimmed.
+ *
+ *              Failure:        -1
+ *-------------------------------------------------------------------------
+ */
+PRIVATE int
+db_hdf5_groom_bits(char const *params)
+{
+    static char *me = "db_hdf5_groom_bits";
+    char const *ptr;
+    char *check;
+    long val;
+
+    if (!params ||
+        (!strstr(params, "METHOD=GZIP") && !strstr(params, "METHOD=SZIP") &&
+         !strstr(params, "METHOD=ZSTD") && !strstr(params, "METHOD=LZ4")))
+        return 0;
+
+    if ((ptr=strstr(params, "PRECISION=")) != NULL)
+    {
+        val = strtol(ptr+10, &check, 10);
+        if (check == ptr+10 || val < 1 || val > 52)
+            return db_perror(params, E_COMPRESSION, me);
+        return (int) val;
+    }
+    if ((ptr=strstr(params, "DIGITS=")) != NULL)
+    {
+        val = strtol(ptr+7, &check, 10);
+        if (check == ptr+7 || val < 1 || val > 15)
+            return db_perror(params, E_COMPRESSION, me);
+        /* ceil(digits * log2(10)) bits */
+        return (int) ((val * 3322 + 999) / 1000);
+    }
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_groom
+ *
+ * Purpose:     Round a copy of the N values of memory type MTYPE in BUF
+ *              to the precision the compression parameters PARAMS ask
+ *              for.
+ *
+ * Return:      The rounded copy, to be freed with free(), or NULL if the
+ *              data is to be written as is.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE void *
+db_hdf5_groom(char const *params, hid_t mtype, void const *buf, size_t n)
+{
+    int keepbits = db_hdf5_groom_bits(params);
+    size_t size;
+    void *copy;
+
+    if (keepbits <= 0 || !buf || H5Tget_class(mtype) != H5T_FLOAT)
+        return 0;
+    size = H5Tget_size(mtype);
+    if (!((size == sizeof(float) && keepbits < 23) ||
+          (size == sizeof(double) && keepbits < 52)))
+        return 0;
+    if ((copy = malloc(n * size)) == NULL)
+        return 0;
+
+    memcpy(copy, buf, n * size);
+    if (size == sizeof(float))
+        db_hdf5_groom_float((unsigned int *) copy, n, keepbits);
+    else
+        db_hdf5_groom_double((unsigned long long *) copy, n, keepbits);
+    return copy;
+}
+
+
+#if HDF5_VERSION_GE(1,8,0) /* { */
+
+/* The following section of code are HDF5 filters for fast lossless
+   compression with LZ4 and Zstandard, when Silo is built with them.
+
+   Both are intended to be used behind shuffle and get close to the
+   ratios of deflate at several times its throughput. The data they
+   write is in the format of the HDF5 LZ4 (32004) and Zstandard (32015)
+   registered filter plugins so files remain readable by other HDF5
+   tools with those plugins.
+
+   LZ4 uses the block compressor of the lz4 library. The chunk is split
+   into blocks of cd_values[0] bytes which are compressed and
+   decompressed independently and, when Silo is built with OpenMP, in
+   parallel. The output is the original size (8 bytes) and block size
+   (4 bytes) followed by the compressed size (4 bytes) and data of each
+   block, all big endian. A block which does not compress is stored as
+   is with its compressed size equal to its original size. cd_values[1]
+   is the LEVEL= in the compression string. Level 1 is LZ4's fast
+   compressor and higher levels are its HC compressor at that level.
+
+   Zstandard compresses the whole chunk as a single frame at the level
+   in cd_values[0], using several threads for large chunks.
+
+   THREADS= in the compression string sets the number of threads for
+   chunks of at least DB_HDF5_MT_MINBYTES. The default is the OpenMP
+   default.
+
+*/
+
+#define DB_HDF5_MT_MINBYTES  (1<<20)  /* smallest chunk using threads   */
+#define DB_HDF5_LZ4_BLOCK    (1<<20)  /* default LZ4 block size         */
+
+#ifdef HAVE_LZ4
+static H5Z_class_t db_hdf5_lz4_class;
+#endif
+#ifdef HAVE_ZSTD
+static H5Z_class_t db_hdf5_zstd_class;
+#endif
+static int db_hdf5_filter_threads = 0;  /* THREADS=, 0 for the default */
+
+#if defined(HAVE_ZSTD) || (defined(HAVE_LZ4) && defined(_OPENMP))
+static int
+db_hdf5_threads(size_t nbytes)
+{
+    int n = db_hdf5_filter_threads;
+    if (nbytes < DB_HDF5_MT_MINBYTES)
+        return 1;
+#ifdef _OPENMP
+    if (n <= 0)
+        n = omp_get_max_threads();
+#endif
+    return n > 0 ? n : 1;
+}
+#endif
+
+#if defined(HAVE_LZ4) || defined(HAVE_ZSTD)
+/*ARGSUSED*/
+static htri_t
+db_hdf5_lz4_can_apply(hid_t dcpl_id, hid_t type_id, hid_t space_id)
+{
+    return 1;
+}
+#endif
+
+#ifdef HAVE_LZ4
+static unsigned int
+db_hdf5_get_be32(unsigned char const *p)
+{
+    return ((unsigned int) p[0] << 24) | ((unsigned int) p[1] << 16) |
+           ((unsigned int) p[2] << 8) | (unsigned int) p[3];
+}
+
+static void
+db_hdf5_put_be32(unsigned char *p, unsigned int v)
+{
+    p[0] = (unsigned char) (v >> 24);
+    p[1] = (unsigned char) (v >> 16);
+    p[2] = (unsigned char) (v >> 8);
+    p[3] = (unsigned char) v;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_lz4_encode
+ *
+ * Purpose:     Compress n bytes of src into an LZ4 block in dst which
+ *              must hold LZ4_compressBound(n) bytes. Level 1 uses LZ4's
+ *              fast compressor and higher levels its HC compressor.
+ *
+ * Return:      Success:        compressed size
+ *
+ *              Failure:        -1
+ *-------------------------------------------------------------------------
+ */
+static int
+db_hdf5_lz4_encode(unsigned char const *src, int n, unsigned char *dst, int level)
+{
+    int const bound = LZ4_compressBound(n);
+    int clen;
+
+    if (level > 1)
+        clen = LZ4_compress_HC((char const *) src, (char *) dst, n, bound, level);
+    else
+        clen = LZ4_compress_default((char const *) src, (char *) dst, n, bound);
+    return clen > 0 ? clen : -1;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_lz4_filter_op
+ *
+ * Purpose:     The LZ4 filter. See the comment at the top of this section
+ *              for the format.
+ *
+ * Return:      Success:        size of the filtered data
+ *
+ *              Failure:        0
+ *-------------------------------------------------------------------------
+ */
+static size_t
+db_hdf5_lz4_filter_op(unsigned int flags, size_t cd_nelmts,
+    const unsigned int cd_values[], size_t nbytes, size_t *buf_size, void **buf)
+{
+    unsigned char const *in = (unsigned char const *) *buf;
+    unsigned char *out = 0;
+    size_t *off = 0, *len = 0, n, bsize, nblocks, pos, i;
+    int b, bad = 0;
+#ifdef _OPENMP
+    int nthreads;
+#endif
+
+    if (flags & H5Z_FLAG_REVERSE)
+    {
+        if (nbytes < 12)
+            return 0;
+        n = (size_t) (((unsigned long long) db_hdf5_get_be32(in) << 32) |
+                      db_hdf5_get_be32(in + 4));
+        bsize = db_hdf5_get_be32(in + 8);
+        if (n == 0 || bsize == 0)
+            return 0;
+        nblocks = (n + bsize - 1) / bsize;
+
+        /* Locate the blocks serially so they can be decoded in parallel */
+        off = (size_t *) malloc(nblocks * sizeof(size_t));
+        len = (size_t *) malloc(nblocks * sizeof(size_t));
+        out = (unsigned char *) malloc(n);
+        if (!off || !len || !out)
+            bad = 1;
+        for (i = 0, pos = 12; i < nblocks && !bad; i++)
+        {
+            if (nbytes - pos < 4)
+            {
+                bad = 1;
+                break;
+            }
+            len[i] = db_hdf5_get_be32(in + pos);
+            off[i] = pos + 4;
+            pos += 4 + len[i];
+            if (pos > nbytes)
+                bad = 1;
+        }
+
+        if (!bad)
+        {
+#ifdef _OPENMP
+            nthreads = db_hdf5_threads(n);
+#pragma omp parallel for reduction(+:bad) num_threads(nthreads) if (nthreads > 1 && nblocks > 1)
+#endif
+            for (b = 0; b < (int) nblocks; b++)
+            {
+                size_t const ulen = b == (int) nblocks - 1 ? n - b * bsize : bsize;
+                if (len[b] == ulen)
+                    memcpy(out + b * bsize, in + off[b], ulen);
+                else if (LZ4_decompress_safe((char const *) in + off[b],
+                             (char *) out + b * bsize, (int) len[b], (int) ulen) != (int) ulen)
+                    bad++;
+            }
+        }
+
+        free(off);
+        free(len);
+        if (bad)
+        {
+            free(out);
+            return 0;
+        }
+        free(*buf);
+        *buf = out;
+        *buf_size = n;
+        return n;
+    }
+
+    n = nbytes;
+    if (n == 0)
+        return 0;
+    bsize = cd_nelmts > 0 && cd_values[0] ? cd_values[0] : DB_HDF5_LZ4_BLOCK;
+    if (bsize > (1U << 30))
+        bsize = 1U << 30;
+    if (bsize > n)
+        bsize = n;
+    nblocks = (n + bsize - 1) / bsize;
+
+    /* Compress each block into its own slot and then pack them */
+    pos = 4 + (size_t) LZ4_compressBound((int) bsize);
+    out = (unsigned char *) malloc(12 + nblocks * pos);
+    len = (size_t *) malloc(nblocks * sizeof(size_t));
+    if (!out || !len)
+    {
+        free(out);
+        free(len);
+        return 0;
+    }
+
+#ifdef _OPENMP
+    nthreads = db_hdf5_threads(n);
+#pragma omp parallel for reduction(+:bad) num_threads(nthreads) if (nthreads > 1 && nblocks > 1)
+#endif
+    for (b = 0; b < (int) nblocks; b++)
+    {
+        size_t const ulen = b == (int) nblocks - 1 ? n - b * bsize : bsize;
+        unsigned char *slot = out + 12 + b * pos + 4;
+        int const clen = db_hdf5_lz4_encode(in + b * bsize, (int) ulen, slot,
+                             cd_nelmts > 1 ? (int) cd_values[1] : 1);
+        if (clen < 0)
+            bad++;
+        else if ((size_t) clen >= ulen)
+        {
+            memcpy(slot, in + b * bsize, ulen);
+            len[b] = ulen;
+        }
+        else
+        {
+            len[b] = (size_t) clen;
+        }
+    }
+    if (bad)
+    {
+        free(out);
+        free(len);
+        return 0;
+    }
+
+    db_hdf5_put_be32(out, (unsigned int) ((unsigned long long) n >> 32));
+    db_hdf5_put_be32(out + 4, (unsigned int) n);
+    db_hdf5_put_be32(out + 8, (unsigned int) bsize);
+    for (i = 0, n = 12; i < nblocks; i++)
+    {
+        db_hdf5_put_be32(out + n, (unsigned int) len[i]);
+        memmove(out + n + 4, out + 12 + i * pos + 4, len[i]);
+        n += 4 + len[i];
+    }
+    free(len);
+
+    free(*buf);
+    *buf = out;
+    *buf_size = 12 + nblocks * pos;
+    return n;
+}
+#endif /* HAVE_LZ4 */
+
+#ifdef HAVE_ZSTD
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_zstd_filter_op
+ *
+ * Purpose:     The Zstandard filter. cd_values[0] is the level. Chunks
+ *              of at least DB_HDF5_MT_MINBYTES are compressed by several
+ *              threads, each working on its own part of the chunk.
+ *
+ * Return:      Success:        size of the filtered data
+ *
+ *              Failure:        0
+ *-------------------------------------------------------------------------
+ */
+static size_t
+db_hdf5_zstd_filter_op(unsigned int flags, size_t cd_nelmts,
+    const unsigned int cd_values[], size_t nbytes, size_t *buf_size, void **buf)
+{
+    void *out;
+    size_t n;
+
+    if (flags & H5Z_FLAG_REVERSE)
+    {
+        unsigned long long const usize = ZSTD_getFrameContentSize(*buf, nbytes);
+        if (usize == ZSTD_CONTENTSIZE_ERROR || usize == ZSTD_CONTENTSIZE_UNKNOWN ||
+            !(out = malloc(usize ? (size_t) usize : 1)))
+            return 0;
+        n = ZSTD_decompress(out, (size_t) usize, *buf, nbytes);
+        if (ZSTD_isError(n) || n != usize)
+        {
+            free(out);
+            return 0;
+        }
+    }
+    else
+    {
+        ZSTD_CCtx *cctx;
+        int const nthreads = db_hdf5_threads(nbytes);
+        size_t const bound = ZSTD_compressBound(nbytes);
+
+        if (!(out = malloc(bound)))
+            return 0;
+        if (!(cctx = ZSTD_createCCtx()))
+        {
+            free(out);
+            return 0;
+        }
+        ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel,
+            cd_nelmts > 0 ? (int) cd_values[0] : 1);
+        ZSTD_CCtx_setParameter(cctx, ZSTD_c_contentSizeFlag, 1);
+        if (nthreads > 1 &&
+            !ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers, nthreads)))
+        {
+            size_t job = nbytes / nthreads + 1;
+            ZSTD_CCtx_setParameter(cctx, ZSTD_c_jobSize,
+                (int) (job < (512<<10) ? (512<<10) : job > (512<<20) ? (512<<20) : job));
+        }
+        n = ZSTD_compress2(cctx, out, bound, *buf, nbytes);
+        ZSTD_freeCCtx(cctx);
+        if (ZSTD_isError(n))
+        {
+            free(out);
+            return 0;
+        }
+    }
+
+    free(*buf);
+    *buf = out;
+    *buf_size = n;
+    return n;
+}
+#endif /* HAVE_ZSTD */
+
+#endif /* HDF5_VERSION_GE(1,8,0) } */
+
 #ifndef HAVE_HZIP /* { */
 /*ARGSUSED*/
 static void
@@ -1710,34 +2258,41 @@ friendly_name(DBfile *_dbfile, char const *base_name, char const *fmtstr, void c
 {
     static char retval[1024];
     static char totfmtstr[1024];
+    char const *cparams = DBGetCompressionFile(_dbfile);
+    char const *name = base_name;
     char typechar;
-    int i, flen;
+    int i, flen, autocomp;
 
-    if (DBGetFriendlyHDF5NamesFile(_dbfile) == FALSE)
+    /* METHOD=AUTO keys its choices on the name even if it is not used to
+       name the dataset; db_hdf5_compwrz decides which applies */
+    autocomp = cparams && strstr(cparams, "METHOD=AUTO");
+    if (DBGetFriendlyHDF5NamesFile(_dbfile) == FALSE && !autocomp)
         return 0;
 
-    if (fmtstr == 0)
-        return base_name;
-
-    sprintf(totfmtstr, "%s%s", base_name, fmtstr);
-    if (val == 0)
-        return totfmtstr;
-
-    flen = strlen(fmtstr);
-    for (i = 0; i < flen; i++)
+    if (fmtstr != 0)
     {
-        if (fmtstr[i] == '%')
-           break;
+        sprintf(totfmtstr, "%s%s", base_name, fmtstr);
+        name = totfmtstr;
     }
-    typechar = i+1 < flen ? fmtstr[i+1] : '\0';
-    switch (typechar)
+
+    if (fmtstr != 0 && val != 0)
     {
-        case 'd': sprintf(retval, totfmtstr, *((int const*) val)); break; 
-        case 's': sprintf(retval, totfmtstr, *((char const*) val)); break;
-        case 'f': sprintf(retval, totfmtstr, *((const float*) val)); break;
-        default: return totfmtstr;
+        flen = strlen(fmtstr);
+        for (i = 0; i < flen; i++)
+        {
+            if (fmtstr[i] == '%')
+               break;
+        }
+        typechar = i+1 < flen ? fmtstr[i+1] : '\0';
+        switch (typechar)
+        {
+            case 'd': sprintf(retval, totfmtstr, *((int const*) val)); name = retval; break; 
+            case 's': sprintf(retval, totfmtstr, *((char const*) val)); name = retval; break;
+            case 'f': sprintf(retval, totfmtstr, *((const float*) val)); name = retval; break;
+        }
     }
-    return retval;
+
+    return name;
 }
 
 /*-------------------------------------------------------------------------
@@ -2053,50 +2608,456 @@ hdf5_to_silo_error(char const *vname, char const *fname)
 }
 
 /*-------------------------------------------------------------------------
- * Function:    db_hdf5_init
- *
- * Purpose:     One-time initializations for this driver.
- *
- * Return:      void
- *
- * Programmer:  Robb Matzke
- *              Monday, March 22, 1999
- *
- * Modifications:
- *
- *   Mark C. Miller, Wed Sep  2 16:41:32 PDT 2009
- *   Made conditional compilation logic for VERSION_GE take into account
- *   H5_USE_16_API setting.
- *
- *   Mark C. Miller, Mon Sep 21 15:17:08 PDT 2009
- *   Adding support for long long type.
- *
- *   Mark C. Miller, Thu Feb 11 09:37:41 PST 2010
- *   Added logic to set HDF5's error output based on Silo's settings.
- *
- *   Mark C. Miller, Wed Jul 14 20:48:15 PDT 2010
- *   Added support for namescheme/empty_list options for multi-block objs.
+ * Reduced precision (16 bit) floating point storage.
+ *
+ * Floating point arrays may be stored on disk as IEEE binary16 ("half")
+ * or bfloat16. These are described to HDF5 as ordinary floating point
+ * types so any HDF5 reader can widen them. HDF5's generic software float
+ * conversion is slow though, so we register hard conversion paths between
+ * these and the native float and double types. Conversions round to
+ * nearest even, directly from the source precision.
  *-------------------------------------------------------------------------
  */
-PRIVATE void
-db_hdf5_init(void)
+#if defined(__F16C__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+PRIVATE unsigned short
+db_hdf5_float_to_half(float f)
 {
+    unsigned int x, sign;
 
-#if !(HDF5_VERSION_GE(1,8,4) && !HDF5_VERSION_GE(1,8,5))
-    static int          ncalls;
-    if (ncalls++) return;               /*already initialized*/
-#else
-    H5open();
-#endif
+    memcpy(&x, &f, sizeof(x));
+    sign = (x >> 16) & 0x8000;
+    x &= 0x7FFFFFFF;
 
-    /* Turn off error messages from the hdf5 library */
-    if (SILO_Globals._db_err_level_drvr == DB_ALL)
-        H5Eset_auto(H5E_DEFAULT, (H5E_auto2_t) H5Eprint2, stderr);
-    else
-        H5Eset_auto(H5E_DEFAULT, NULL, NULL);
+    if (x >= 0x47800000)                /* overflow, inf or nan */
+        return (unsigned short) (sign | (x > 0x7F800000 ? 0x7E00 : 0x7C00));
 
-    /* Define a scalar data space */
-    SCALAR = H5Screate(H5S_SCALAR);
+    if (x < 0x38800000)                 /* half subnormal or zero */
+    {
+        float a;
+        memcpy(&a, &x, sizeof(a));
+        a += 0.5f;
+        memcpy(&x, &a, sizeof(x));
+        return (unsigned short) (sign | (x - 0x3F000000));
+    }
+
+    x += 0xC8000FFF + ((x >> 13) & 1);  /* rebias exponent and round */
+    return (unsigned short) (sign | (x >> 13));
+}
+
+PRIVATE unsigned short
+db_hdf5_double_to_half(double d)
+{
+    unsigned long long x, sign;
+
+    memcpy(&x, &d, sizeof(x));
+    sign = (x >> 48) & 0x8000;
+    x &= 0x7FFFFFFFFFFFFFFFULL;
+
+    if (x >= 0x40EFFE0000000000ULL)     /* overflow, inf or nan */
+        return (unsigned short) (sign | (x > 0x7FF0000000000000ULL ? 0x7E00 : 0x7C00));
+
+    if (x < 0x3F10000000000000ULL)      /* half subnormal or zero */
+    {
+        double a;
+        memcpy(&a, &x, sizeof(a));
+        a += 268435456.0;               /* 2^28, whose ulp is 2^-24 */
+        memcpy(&x, &a, sizeof(x));
+        return (unsigned short) (sign | (x - 0x41B0000000000000ULL));
+    }
+
+    x += 0xC10001FFFFFFFFFFULL + ((x >> 42) & 1); /* rebias exponent and round */
+    return (unsigned short) (sign | (x >> 42));
+}
+
+PRIVATE float
+db_hdf5_half_to_float(unsigned short h)
+{
+    unsigned int x = ((unsigned int) h & 0x7FFF) << 13;
+    unsigned int exp = x & 0x0F800000;
+    float f;
+
+    x += 0x38000000;                    /* rebias exponent */
+    if (exp == 0x0F800000)              /* inf or nan */
+        x += 0x38000000;
+    else if (exp == 0)                  /* zero or subnormal */
+    {
+        float const magic = 6.103515625e-05f; /* 2^-14 */
+        x += 0x00800000;
+        memcpy(&f, &x, sizeof(f));
+        f -= magic;
+        memcpy(&x, &f, sizeof(x));
+    }
+    x |= ((unsigned int) h & 0x8000) << 16;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+PRIVATE unsigned short
+db_hdf5_float_to_bfloat16(float f)
+{
+    unsigned int x;
+
+    memcpy(&x, &f, sizeof(x));
+    if ((x & 0x7FFFFFFF) > 0x7F800000)  /* quiet the nan */
+        return (unsigned short) ((x >> 16) | 0x0040);
+    x += 0x7FFF + ((x >> 16) & 1);
+    return (unsigned short) (x >> 16);
+}
+
+PRIVATE unsigned short
+db_hdf5_double_to_bfloat16(double d)
+{
+    unsigned long long x, sign;
+
+    memcpy(&x, &d, sizeof(x));
+    sign = (x >> 48) & 0x8000;
+    x &= 0x7FFFFFFFFFFFFFFFULL;
+
+    if (x >= 0x47EFF00000000000ULL)     /* overflow, inf or nan */
+        return (unsigned short) (sign | (x > 0x7FF0000000000000ULL ? 0x7FC0 : 0x7F80));
+
+    if (x < 0x3810000000000000ULL)      /* bfloat16 subnormal or zero */
+    {
+        double a;
+        memcpy(&a, &x, sizeof(a));
+        a += 4.1359030627651384e-25;    /* 2^-81, whose ulp is 2^-133 */
+        memcpy(&x, &a, sizeof(x));
+        return (unsigned short) (sign | (x - 0x3AE0000000000000ULL));
+    }
+
+    x += 0xC8000FFFFFFFFFFFULL + ((x >> 45) & 1); /* rebias exponent and round */
+    return (unsigned short) (sign | (x >> 45));
+}
+
+PRIVATE float
+db_hdf5_bfloat16_to_float(unsigned short b)
+{
+    unsigned int x = (unsigned int) b << 16;
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+/* Packed, in-place conversion of n floats to halves (forward) */
+PRIVATE void
+db_hdf5_narrow_half(unsigned char *buf, size_t n)
+{
+    size_t i = 0;
+#if defined(__AVX512F__)
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i h = _mm512_cvtps_ph(_mm512_loadu_ps((float*)(buf+4*i)),
+                        _MM_FROUND_TO_NEAREST_INT);
+        _mm256_storeu_si256((__m256i*)(buf+2*i), h);
+    }
+#elif defined(__F16C__)
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps((float*)(buf+4*i)),
+                        _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)(buf+2*i), h);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        float f;
+        unsigned short h;
+        memcpy(&f, buf+4*i, sizeof(f));
+        h = db_hdf5_float_to_half(f);
+        memcpy(buf+2*i, &h, sizeof(h));
+    }
+}
+
+/* Packed, in-place conversion of n halves to floats (backward) */
+PRIVATE void
+db_hdf5_widen_half(unsigned char *buf, size_t n)
+{
+    size_t i = n;
+#if defined(__AVX512F__)
+    size_t const w = 16;
+#elif defined(__F16C__)
+    size_t const w = 8;
+#else
+    size_t const w = n + 1;
+#endif
+    for (; i % w; i--)
+    {
+        unsigned short h;
+        float f;
+        memcpy(&h, buf+2*(i-1), sizeof(h));
+        f = db_hdf5_half_to_float(h);
+        memcpy(buf+4*(i-1), &f, sizeof(f));
+    }
+#if defined(__AVX512F__)
+    for (; i; i -= 16)
+    {
+        __m512 f = _mm512_cvtph_ps(_mm256_loadu_si256((__m256i*)(buf+2*(i-16))));
+        _mm512_storeu_ps((float*)(buf+4*(i-16)), f);
+    }
+#elif defined(__F16C__)
+    for (; i; i -= 8)
+    {
+        __m256 f = _mm256_cvtph_ps(_mm_loadu_si128((__m128i*)(buf+2*(i-8))));
+        _mm256_storeu_ps((float*)(buf+4*(i-8)), f);
+    }
+#endif
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_half_overflow
+ *
+ * Purpose:     Count the finite values of a float or double array whose
+ *              magnitude is too large to be stored as a half.
+ *
+ * Return:      Number of such values
+ *-------------------------------------------------------------------------
+ */
+PRIVATE size_t
+db_hdf5_half_overflow(int dtype, void const *buf, size_t n)
+{
+    size_t i, cnt = 0;
+
+    if (dtype == DB_DOUBLE)
+    {
+        unsigned long long x;
+        for (i = 0; i < n; i++)
+        {
+            memcpy(&x, (char const *) buf + i*sizeof(x), sizeof(x));
+            x &= 0x7FFFFFFFFFFFFFFFULL;
+            cnt += x >= 0x40EFFE0000000000ULL && x < 0x7FF0000000000000ULL;
+        }
+    }
+    else if (dtype == DB_FLOAT)
+    {
+        unsigned int x;
+        for (i = 0; i < n; i++)
+        {
+            memcpy(&x, (char const *) buf + i*sizeof(x), sizeof(x));
+            x &= 0x7FFFFFFF;
+            cnt += x >= 0x477FF000 && x < 0x7F800000;
+        }
+    }
+    return cnt;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_conv_reduced
+ *
+ * Purpose:     HDF5 hard conversion function between native float or
+ *              double and the 16 bit half or bfloat16 types.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *-------------------------------------------------------------------------
+ */
+PRIVATE herr_t
+db_hdf5_conv_reduced(hid_t src, hid_t dst, H5T_cdata_t *cdata, size_t nelmts,
+    size_t buf_stride, size_t bkg_stride, void *_buf, int bf16)
+{
+    unsigned char *buf = (unsigned char *) _buf;
+    size_t ssize, dsize, sstride, dstride, i;
+
+    switch (cdata->command)
+    {
+        case H5T_CONV_INIT:
+            if (H5Tget_class(src) != H5T_FLOAT || H5Tget_class(dst) != H5T_FLOAT)
+                return -1;
+            cdata->need_bkg = H5T_BKG_NO;
+            return 0;
+        case H5T_CONV_FREE:
+            return 0;
+        case H5T_CONV_CONV:
+            break;
+        default:
+            return -1;
+    }
+
+    ssize = H5Tget_size(src);
+    dsize = H5Tget_size(dst);
+    sstride = buf_stride ? buf_stride : ssize;
+    dstride = buf_stride ? buf_stride : dsize;
+
+    if (ssize > 2)      /* narrowing; walk forward */
+    {
+        if (ssize == sizeof(float) && !bf16 && !buf_stride)
+        {
+            db_hdf5_narrow_half(buf, nelmts);
+            return 0;
+        }
+        for (i = 0; i < nelmts; i++)
+        {
+            unsigned short h;
+            if (ssize == sizeof(double))
+            {
+                double d;
+                memcpy(&d, buf+i*sstride, sizeof(d));
+                h = bf16 ? db_hdf5_double_to_bfloat16(d) : db_hdf5_double_to_half(d);
+            }
+            else
+            {
+                float f;
+                memcpy(&f, buf+i*sstride, sizeof(f));
+                h = bf16 ? db_hdf5_float_to_bfloat16(f) : db_hdf5_float_to_half(f);
+            }
+            memcpy(buf+i*dstride, &h, sizeof(h));
+        }
+    }
+    else                /* widening; walk backward */
+    {
+        if (dsize == sizeof(float) && !bf16 && !buf_stride)
+        {
+            db_hdf5_widen_half(buf, nelmts);
+            return 0;
+        }
+        for (i = nelmts; i > 0; i--)
+        {
+            unsigned short h;
+            float f;
+            memcpy(&h, buf+(i-1)*sstride, sizeof(h));
+            f = bf16 ? db_hdf5_bfloat16_to_float(h) : db_hdf5_half_to_float(h);
+            if (dsize == sizeof(double))
+            {
+                double d = f;
+                memcpy(buf+(i-1)*dstride, &d, sizeof(d));
+            }
+            else
+            {
+                memcpy(buf+(i-1)*dstride, &f, sizeof(f));
+            }
+        }
+    }
+
+    return 0;
+}
+
+PRIVATE herr_t
+db_hdf5_conv_half(hid_t src, hid_t dst, H5T_cdata_t *cdata, size_t nelmts,
+    size_t buf_stride, size_t bkg_stride, void *buf, void *bkg, hid_t dxpl)
+{
+    return db_hdf5_conv_reduced(src, dst, cdata, nelmts, buf_stride, bkg_stride, buf, 0);
+}
+
+PRIVATE herr_t
+db_hdf5_conv_bfloat16(hid_t src, hid_t dst, H5T_cdata_t *cdata, size_t nelmts,
+    size_t buf_stride, size_t bkg_stride, void *buf, void *bkg, hid_t dxpl)
+{
+    return db_hdf5_conv_reduced(src, dst, cdata, nelmts, buf_stride, bkg_stride, buf, 1);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_init_reduced_types
+ *
+ * Purpose:     Define the half and bfloat16 types and register the fast
+ *              conversion paths to and from them. The types use the
+ *              native byte order so that the conversion kernels apply.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE void
+db_hdf5_init_reduced_types(void)
+{
+    T_half = H5Tcopy(H5T_NATIVE_FLOAT);     /*this is never freed!*/
+    H5Tset_fields(T_half, 15, 10, 5, 0, 10);
+    H5Tset_size(T_half, 2);
+    H5Tset_ebias(T_half, 15);
+
+    T_bfloat16 = H5Tcopy(H5T_NATIVE_FLOAT); /*this is never freed!*/
+    H5Tset_fields(T_bfloat16, 15, 7, 8, 0, 7);
+    H5Tset_size(T_bfloat16, 2);
+    H5Tset_ebias(T_bfloat16, 127);
+
+    H5Tregister(H5T_PERS_HARD, "silo_float_half", H5T_NATIVE_FLOAT, T_half, db_hdf5_conv_half);
+    H5Tregister(H5T_PERS_HARD, "silo_half_float", T_half, H5T_NATIVE_FLOAT, db_hdf5_conv_half);
+    H5Tregister(H5T_PERS_HARD, "silo_double_half", H5T_NATIVE_DOUBLE, T_half, db_hdf5_conv_half);
+    H5Tregister(H5T_PERS_HARD, "silo_half_double", T_half, H5T_NATIVE_DOUBLE, db_hdf5_conv_half);
+    H5Tregister(H5T_PERS_HARD, "silo_float_bf16", H5T_NATIVE_FLOAT, T_bfloat16, db_hdf5_conv_bfloat16);
+    H5Tregister(H5T_PERS_HARD, "silo_bf16_float", T_bfloat16, H5T_NATIVE_FLOAT, db_hdf5_conv_bfloat16);
+    H5Tregister(H5T_PERS_HARD, "silo_double_bf16", H5T_NATIVE_DOUBLE, T_bfloat16, db_hdf5_conv_bfloat16);
+    H5Tregister(H5T_PERS_HARD, "silo_bf16_double", T_bfloat16, H5T_NATIVE_DOUBLE, db_hdf5_conv_bfloat16);
+}
+
+/*-------------------------------------------------------------------------
+ * Macro:       DB_HDF5_TIMED_FILTER
+ *
+ * Purpose:     Define OP_timed, a filter callback that runs filter OP and
+ *              adds the time spent in it to the statistics of the API call
+ *              in progress.
+ *-------------------------------------------------------------------------
+ */
+#define DB_HDF5_TIMED_FILTER(OP)                                            \
+static size_t                                                               \
+OP ## _timed(unsigned int flags, size_t cd_nelmts,                          \
+    const unsigned int cd_values[], size_t nbytes,                          \
+    size_t *buf_size, void **buf)                                           \
+{                                                                           \
+    double t0 = db_stats_active() ? db_stats_clock() : 0;                   \
+    size_t retval = OP(flags, cd_nelmts, cd_values, nbytes, buf_size, buf); \
+    if (t0) db_stats_filter(db_stats_clock() - t0);                         \
+    return retval;                                                          \
+}
+
+#ifdef HAVE_FPZIP
+DB_HDF5_TIMED_FILTER(db_hdf5_fpzip_filter_op)
+#endif
+#if HDF5_VERSION_GE(1,8,0)
+#ifdef HAVE_LZ4
+DB_HDF5_TIMED_FILTER(db_hdf5_lz4_filter_op)
+#endif
+#ifdef HAVE_ZSTD
+DB_HDF5_TIMED_FILTER(db_hdf5_zstd_filter_op)
+#endif
+#endif
+#ifdef HAVE_HZIP
+DB_HDF5_TIMED_FILTER(db_hdf5_hzip_filter_op)
+#endif
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_init
+ *
+ * Purpose:     One-time initializations for this driver.
+ *
+ * Return:      void
+ *
+ * Programmer:  Robb Matzke
+ *              Monday, March 22, 1999
+ *
+ * Modifications:
+ *
+ *   Mark C. Miller, Wed Sep  2 16:41:32 PDT 2009
+ *   Made conditional compilation logic for VERSION_GE take into account
+ *   H5_USE_16_API setting.
+ *
+ *   Mark C. Miller, Mon Sep 21 15:17:08 PDT 2009
+ *   Adding support for long long type.
+ *
+ *   Mark C. Miller, Thu Feb 11 09:37:41 PST 2010
+ *   Added logic to set HDF5's error output based on Silo's settings.
+ *
+ *   Mark C. Miller, Wed Jul 14 20:48:15 PDT 2010
+ *   Added support for namescheme/empty_list options for multi-block objs.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE void
+db_hdf5_init(void)
+{
+
+#if !(HDF5_VERSION_GE(1,8,4) && !HDF5_VERSION_GE(1,8,5))
+    static int          ncalls;
+    if (ncalls++) return;               /*already initialized*/
+#else
+    H5open();
+#endif
+
+    /* Turn off error messages from the hdf5 library */
+    if (SILO_Globals._db_err_level_drvr == DB_ALL)
+        H5Eset_auto(H5E_DEFAULT, (H5E_auto2_t) H5Eprint2, stderr);
+    else
+        H5Eset_auto(H5E_DEFAULT, NULL, NULL);
+
+    /* Define a scalar data space */
+    SCALAR = H5Screate(H5S_SCALAR);
 
     /* Define atomic data types */
     T_char = H5T_NATIVE_UCHAR;
@@ -2110,6 +3071,8 @@ db_hdf5_init(void)
     T_str256 = H5Tcopy(H5T_C_S1);       /*this is never freed!*/
     H5Tset_size(T_str256, 256);
 
+    db_hdf5_init_reduced_types();
+
     P_ckcrprops = H5Pcreate(H5P_DATASET_CREATE); /* never freed */
     if (DBGetEnableChecksums())
        H5Pset_fletcher32(P_ckcrprops);
@@ -2130,10 +3093,42 @@ db_hdf5_init(void)
     db_hdf5_fpzip_class.name = "Lindstrom-fpzip";
     db_hdf5_fpzip_class.can_apply = db_hdf5_fpzip_can_apply;
     db_hdf5_fpzip_class.set_local = db_hdf5_fpzip_set_local;
-    db_hdf5_fpzip_class.filter = db_hdf5_fpzip_filter_op;
+    db_hdf5_fpzip_class.filter = db_hdf5_fpzip_filter_op_timed;
     H5Zregister(&db_hdf5_fpzip_class);
 #endif /* HAVE_FPZIP } */
 
+#if HDF5_VERSION_GE(1,8,0) /* { */
+#ifdef HAVE_LZ4
+#if !defined(H5_USE_16_API)
+    db_hdf5_lz4_class.version = H5Z_CLASS_T_VERS;
+    db_hdf5_lz4_class.encoder_present = 1;
+    db_hdf5_lz4_class.decoder_present = 1;
+#endif
+    db_hdf5_lz4_class.id = DB_HDF5_LZ4_ID;
+    db_hdf5_lz4_class.name = "HDF5 lz4 filter";
+    db_hdf5_lz4_class.can_apply = db_hdf5_lz4_can_apply;
+    db_hdf5_lz4_class.filter = db_hdf5_lz4_filter_op_timed;
+
+    /* Defer to the HDF Group's filter plugins when they are installed */
+    if (H5Zfilter_avail(DB_HDF5_LZ4_ID) <= 0)
+        H5Zregister(&db_hdf5_lz4_class);
+#endif
+
+#ifdef HAVE_ZSTD
+#if !defined(H5_USE_16_API)
+    db_hdf5_zstd_class.version = H5Z_CLASS_T_VERS;
+    db_hdf5_zstd_class.encoder_present = 1;
+    db_hdf5_zstd_class.decoder_present = 1;
+#endif
+    db_hdf5_zstd_class.id = DB_HDF5_ZSTD_ID;
+    db_hdf5_zstd_class.name = "Zstandard compression";
+    db_hdf5_zstd_class.can_apply = db_hdf5_lz4_can_apply;
+    db_hdf5_zstd_class.filter = db_hdf5_zstd_filter_op_timed;
+    if (H5Zfilter_avail(DB_HDF5_ZSTD_ID) <= 0)
+        H5Zregister(&db_hdf5_zstd_class);
+#endif
+#endif /* HDF5_VERSION_GE(1,8,0) } */
+
 #ifdef HAVE_HZIP /* { */
 
 #ifdef HAVE_LIBZ
@@ -2164,7 +3159,7 @@ db_hdf5_init(void)
     db_hdf5_hzip_class.name = "Lindstrom-hzip";
     db_hdf5_hzip_class.can_apply = db_hdf5_hzip_can_apply;
     db_hdf5_hzip_class.set_local = db_hdf5_hzip_set_local;
-    db_hdf5_hzip_class.filter = db_hdf5_hzip_filter_op;
+    db_hdf5_hzip_class.filter = db_hdf5_hzip_filter_op_timed;
 
     H5Zregister(&db_hdf5_hzip_class);
     /* Initialize support data structures for hzip */
@@ -2328,6 +3323,9 @@ db_hdf5_init(void)
         MEMBER_S(int,           extensive);
         MEMBER_S(int,           centering);
         MEMBER_S(double,        missing_value);
+        MEMBER_S(int,           has_range);
+        MEMBER_S(double,        min_value);
+        MEMBER_S(double,        max_value);
     } DEFINE;
 
     STRUCT(DBucdmesh) {
@@ -2386,6 +3384,9 @@ db_hdf5_init(void)
         MEMBER_S(int,           conserved);
         MEMBER_S(int,           extensive);
         MEMBER_S(double,        missing_value);
+        MEMBER_S(int,           has_range);
+        MEMBER_S(double,        min_value);
+        MEMBER_S(double,        max_value);
     } DEFINE;
 
     STRUCT(DBfacelist) {
@@ -2490,6 +3491,7 @@ db_hdf5_init(void)
         MEMBER_S(int,           repr_block_idx);
         MEMBER_S(str256,        alt_nodenum_vars);
         MEMBER_S(str256,        alt_zonenum_vars);
+        MEMBER_S(str256,        bvh);
     } DEFINE;
 
     STRUCT(DBmultimeshadj) {
@@ -2533,6 +3535,7 @@ db_hdf5_init(void)
         MEMBER_S(int,           empty_cnt);
         MEMBER_S(int,           repr_block_idx);
         MEMBER_S(double,        missing_value);
+        MEMBER_S(str256,        bvh);
     } DEFINE;
 
     STRUCT(DBmultimat) {
@@ -2623,6 +3626,8 @@ db_hdf5_init(void)
         MEMBER_S(int,           gnznodtype);
         MEMBER_S(str256,        ghost_node_labels);
         MEMBER_S(str256,        alt_nodenum_vars);
+        MEMBER_S(str256,        perm);
+        MEMBER_S(str256,        chunkidx);
     } DEFINE;
 
     STRUCT(DBpointvar) {
@@ -2915,6 +3920,7 @@ db_hdf5_InitCallbacks(DBfile_hdf5 *dbfile, int target)
     dbfile->pub.free_z = db_hdf5_FreeCompressionResources;
 
     dbfile->pub.sort_obo = db_hdf5_SortObjectsByOffset;
+    dbfile->pub.stage_objs = db_hdf5_StageObjects;
 }
 
 /*-------------------------------------------------------------------------
@@ -3135,6 +4141,47 @@ silof2hdff_type(DBfile_hdf5 *dbfile, int datatype)
     return ftype;
 }
 
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_stats
+ *
+ * Purpose:     Add a transfer of the points of MSPACE (all points of the
+ *              dataset for H5S_ALL) of memory type MTYPE to or from DSET
+ *              to the statistics of the API call in progress.
+ *
+ * Return:      void
+ *
+ * Modifications:
+ *
+ *-------------------------------------------------------------------------
+ */
+PRIVATE void
+db_hdf5_stats(hid_t dset, hid_t mtype, hid_t mspace, int writing)
+{
+    hid_t       fspace;
+    hssize_t    npoints, nsel;
+    long long   nbytes, stored = 0;
+
+    if (!db_stats_active())
+        return;
+
+    if ((fspace = H5Dget_space(dset)) < 0)
+        return;
+    npoints = H5Sget_simple_extent_npoints(fspace);
+    H5Sclose(fspace);
+    nsel = mspace == H5S_ALL ? npoints : H5Sget_select_npoints(mspace);
+    if (npoints <= 0 || nsel <= 0)
+        return;
+
+    /* The stored size of a partial transfer is prorated */
+    nbytes = (long long) nsel * (long long) H5Tget_size(mtype);
+    stored = (long long) ((double) H5Dget_storage_size(dset) * nsel / npoints);
+
+    if (writing)
+        db_stats_write(nbytes, stored);
+    else
+        db_stats_read(nbytes, stored);
+}
+
 /*-------------------------------------------------------------------------
  * Function:    hdf2silo_type
  *
@@ -3286,6 +4333,28 @@ hdf2hdf_type(hid_t ftype)
     return mtype;
 }
 
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_remove_lossless
+ *
+ * Purpose:     Remove shuffle and the lossless compression filters left on
+ *              the dataset creation properties by earlier compression
+ *              parameters, before ZSTD or LZ4 is added in their place.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE void
+db_hdf5_remove_lossless(void)
+{
+    H5E_BEGIN_TRY {
+        H5Premove_filter(P_ckcrprops, H5Z_FILTER_SHUFFLE);
+        H5Premove_filter(P_ckcrprops, H5Z_FILTER_DEFLATE);
+#ifdef H5_HAVE_FILTER_SZIP
+        H5Premove_filter(P_ckcrprops, H5Z_FILTER_SZIP);
+#endif
+        H5Premove_filter(P_ckcrprops, DB_HDF5_ZSTD_ID);
+        H5Premove_filter(P_ckcrprops, DB_HDF5_LZ4_ID);
+    } H5E_END_TRY;
+}
+
 /*-------------------------------------------------------------------------
  * Function:    db_hdf5_set_compression
  *
@@ -3311,12 +4380,14 @@ PRIVATE int
 db_hdf5_set_compression(DBfile *dbfile, int flags)
 {
     static char *me = "db_hdf5_set_compression";
+    char const *cparams = db_hdf5_compression(dbfile);
     char *ptr;
     char chararray[32];
     char *check;
     int level, block, nfilters;
     int nbits, prec;
     int have_gzip, have_szip, have_fpzip, have_hzip, have_zfp, i;
+    int have_zstd, have_lz4;
     H5Z_filter_t filtn;
     unsigned int filter_config_flags, opt_flag;
 
@@ -3326,6 +4397,8 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
     have_fpzip = FALSE;
     have_hzip = FALSE;
     have_zfp = FALSE;
+    have_zstd = FALSE;
+    have_lz4 = FALSE;
     if ((nfilters = H5Pget_nfilters(P_ckcrprops))<0)
     {
        db_perror("H5Pget_nfilters", E_CALLFAIL, me);
@@ -3351,12 +4424,16 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
         if (H5Z_FILTER_ZFP==filtn)
             have_zfp = TRUE;
 #endif
+        if (DB_HDF5_ZSTD_ID==filtn)
+            have_zstd = TRUE;
+        if (DB_HDF5_LZ4_ID==filtn)
+            have_lz4 = TRUE;
     }
 #ifndef _MSC_VER
 #warning WHAT ABOUT NULL RETURN FROM DBGETCOMPRESSION
 #endif
 /* Handle some global compression parameters */
-    if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+    if ((ptr=(char *)strstr(cparams, 
        "ERRMODE=")) != (char *)NULL) 
     {
         (void)strncpy(chararray, ptr+8, 4); 
@@ -3367,11 +4444,11 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
             SILO_Globals.compressionErrmode = COMPRESSION_ERRMODE_FAIL;
         else
         {
-            db_perror(DBGetCompressionFile(dbfile), E_COMPRESSION, me);
+            db_perror(cparams, E_COMPRESSION, me);
             return (-1);
         }
     }
-    if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+    if ((ptr=(char *)strstr(cparams, 
        "MINRATIO=")) != (char *)NULL) 
     {
         float mcr;
@@ -3381,15 +4458,31 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
             SILO_Globals.compressionMinratio = mcr;
         else
         {
-            db_perror(DBGetCompressionFile(dbfile), E_COMPRESSION, me);
+            db_perror(cparams, E_COMPRESSION, me);
+            return (-1);
+        }
+    }
+#if HDF5_VERSION_GE(1,8,0)
+    if ((ptr=(char *)strstr(cparams, 
+       "THREADS=")) != (char *)NULL) 
+    {
+        (void)strncpy(chararray, ptr+8, 4); 
+        chararray[4] = '\0';
+        db_hdf5_filter_threads = (int) strtol(chararray, &check, 10);
+        if (chararray == check || db_hdf5_filter_threads < 1)
+        {
+            db_perror(cparams, E_COMPRESSION, me);
             return (-1);
         }
     }
+    else
+        db_hdf5_filter_threads = 0;
+#endif
 #ifndef _MSC_VER
 #warning FIX MISSING .compressionMinsize member
 #endif
 #if 0
-    if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+    if ((ptr=(char *)strstr(cparams, 
        "MINSIZE=")) != (char *)NULL) 
     {
         unsigned int minsize;
@@ -3399,7 +4492,7 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
             SILO_Globals.compressionMinsize = minsize;
         else
         {
-            db_perror(DBGetCompressionFile(dbfile), E_COMPRESSION, me);
+            db_perror(cparams, E_COMPRESSION, me);
             return -1;
         }
     }
@@ -3411,13 +4504,18 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
     opt_flag = SILO_Globals.compressionErrmode == COMPRESSION_ERRMODE_FALLBACK ?
                    H5Z_FLAG_OPTIONAL : H5Z_FLAG_MANDATORY;
 
+    /* Precision trimming ahead of GZIP, SZIP, ZSTD and LZ4 is done to the
+       data by db_hdf5_compwrz. Just check the parameters here. */
+    if (db_hdf5_groom_bits(cparams) < 0)
+        return (-1);
+
     /* Select the compression algorthm */
-    if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+    if ((ptr=(char *)strstr(cparams, 
        "METHOD=GZIP")) != (char *)NULL) 
     {
        if (have_gzip == FALSE)
        {
-          if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+          if ((ptr=(char *)strstr(cparams, 
              "LEVEL=")) != (char *)NULL)
           {
              (void)strncpy(chararray, ptr+6, 1); 
@@ -3433,7 +4531,7 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
              }
              else
              {
-                db_perror(DBGetCompressionFile(dbfile), E_COMPRESSION, me);
+                db_perror(cparams, E_COMPRESSION, me);
                 return (-1);
              }
           }
@@ -3449,7 +4547,7 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
        }  /* if (have_gzip == FALSE) */
     }
 #ifdef H5_HAVE_FILTER_SZIP
-    else if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile),
+    else if ((ptr=(char *)strstr(cparams,
        "METHOD=SZIP"))!=(char *)NULL)
     {
        if (have_szip == FALSE)
@@ -3457,21 +4555,21 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
           filtn = H5Z_FILTER_SZIP;
           if (H5Zget_filter_info(filtn, &filter_config_flags)<0)
           {
-             db_perror(DBGetCompressionFile(dbfile), E_COMPRESSION, me);
+             db_perror(cparams, E_COMPRESSION, me);
              return (-1);
           }
           if ((filter_config_flags &
           (H5Z_FILTER_CONFIG_ENCODE_ENABLED|H5Z_FILTER_CONFIG_DECODE_ENABLED))==
           (H5Z_FILTER_CONFIG_ENCODE_ENABLED|H5Z_FILTER_CONFIG_DECODE_ENABLED))
           {
-             if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+             if ((ptr=(char *)strstr(cparams, 
                 "BLOCK=")) != (char *)NULL)
              {
                 (void)strncpy(chararray, ptr+6, 2); 
                 block = (int) strtol(chararray, &check, 10);
                 if ((chararray != check) && (block >= 0) && (block <=32))
                 { 
-                   if (strstr(DBGetCompressionFile(dbfile), 
+                   if (strstr(cparams, 
                       "MASK=EC") != NULL)
                    {
                       if (H5Pset_shuffle(P_ckcrprops)<0 ||
@@ -3481,7 +4579,7 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
                          return (-1);
                       }
                    }
-                   else if(strstr(DBGetCompressionFile(dbfile),
+                   else if(strstr(cparams,
                       "MASK=NN")!=NULL)
                    {
                       if (H5Pset_shuffle(P_ckcrprops)<0 ||
@@ -3503,7 +4601,7 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
                 }
                 else
                 {
-                   db_perror(DBGetCompressionFile(dbfile), E_COMPRESSION, me);
+                   db_perror(cparams, E_COMPRESSION, me);
                    return (-1);
                 }
              }
@@ -3521,12 +4619,12 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
     }
 #endif
 #ifdef HAVE_HZIP
-    else if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+    else if ((ptr=(char *)strstr(cparams, 
        "METHOD=HZIP")) != (char *)NULL) 
     {
        if (have_hzip == FALSE && (flags & ALLOW_MESH_COMPRESSION))
        {
-           if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+           if ((ptr=(char *)strstr(cparams, 
               "CODEC=")) != (char *)NULL)
            {
               (void)strncpy(chararray, ptr+6, 4); 
@@ -3550,7 +4648,7 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
                   return (-1);
               }
            }
-           if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+           if ((ptr=(char *)strstr(cparams, 
               "BITS=")) != (char *)NULL)
            {
               (void)strncpy(chararray, ptr+5, 2); 
@@ -3581,12 +4679,12 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
     }
 #endif
 #ifdef HAVE_FPZIP
-    else if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+    else if ((ptr=(char *)strstr(cparams, 
        "METHOD=FPZIP")) != (char *)NULL) 
     {
        if (have_fpzip == FALSE)
        {
-          if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+          if ((ptr=(char *)strstr(cparams, 
              "LOSS=")) != (char *)NULL)
           {
              (void)strncpy(chararray, ptr+5, 2); 
@@ -3597,7 +4695,7 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
              }
              else
              {
-                db_perror(DBGetCompressionFile(dbfile), E_COMPRESSION, me);
+                db_perror(cparams, E_COMPRESSION, me);
                 return (-1);
              }
           }
@@ -3611,7 +4709,7 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
     }
 #endif
 #ifdef HAVE_ZFP
-    else if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+    else if ((ptr=(char *)strstr(cparams, 
        "METHOD=ZFP")) != (char *)NULL) 
     {
        if (have_zfp == FALSE)
@@ -3621,7 +4719,7 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
           unsigned int cd_values[H5Z_ZFP_CD_NELMTS_MEM];
           int cd_nelmts = H5Z_ZFP_CD_NELMTS_MEM;
           
-          if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+          if ((ptr=(char *)strstr(cparams, 
              "RATE=")) != (char *)NULL)
           {
              strncpy(chararray, ptr+5, 8); 
@@ -3629,7 +4727,7 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
              if (chararray != check && errno == 0 && tmpdbl > 0)
                  H5Pset_zfp_rate_cdata(tmpdbl, cd_nelmts, cd_values);
           }
-          else if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+          else if ((ptr=(char *)strstr(cparams, 
              "PRECISION=")) != (char *)NULL)
           {
              strncpy(chararray, ptr+10, 2); 
@@ -3637,7 +4735,7 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
              if (chararray != check && errno == 0 && tmpuint > 0)
                  H5Pset_zfp_precision_cdata(tmpuint, cd_nelmts, cd_values);
           }
-          else if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+          else if ((ptr=(char *)strstr(cparams, 
              "ACCURACY=")) != (char *)NULL)
           {
              strncpy(chararray, ptr+9, 8); 
@@ -3645,7 +4743,7 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
              if (chararray != check && errno == 0 && tmpdbl > 0)
                  H5Pset_zfp_accuracy_cdata(tmpdbl, cd_nelmts, cd_values);
           }
-          else if ((ptr=(char *)strstr(DBGetCompressionFile(dbfile), 
+          else if ((ptr=(char *)strstr(cparams, 
              "EXPERT=")) != (char *)NULL)
           {
              int nvals, minexp; unsigned int minbits, maxbits, maxprec;
@@ -3654,14 +4752,14 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
              if (nvals == 4 && errno == 0)
                  H5Pset_zfp_expert_cdata(minbits, maxbits, maxprec, minexp, cd_nelmts, cd_values);
           }
-          else if ((ptr=(char *)strstr(SILO_Globals.compressionParams, 
+          else if ((ptr=(char *)strstr(cparams, 
              "REVERSIBLE")) != (char *)NULL)
           {
               H5Pset_zfp_reversible_cdata(cd_nelmts, cd_values);
           }
           else
           {
-              db_perror(DBGetCompressionFile(dbfile), E_COMPRESSION, me);
+              db_perror(cparams, E_COMPRESSION, me);
               return -1;
           }
 
@@ -3673,10 +4771,69 @@ db_hdf5_set_compression(DBfile *dbfile, int flags)
        }
     }
 #endif
-    else
+#if HDF5_VERSION_GE(1,8,0)
+#ifdef HAVE_ZSTD
+    else if ((ptr=(char *)strstr(cparams, 
+       "METHOD=ZSTD")) != (char *)NULL) 
     {
-       db_perror(DBGetCompressionFile(dbfile), E_COMPRESSION, me);
-       return (-1);
+       /* Always rebuilt so changes in LEVEL= and SHUFFLE= take effect */
+       unsigned int cd_values[1] = {1};
+       if ((ptr=(char *)strstr(cparams, 
+          "LEVEL=")) != (char *)NULL)
+       {
+          (void)strncpy(chararray, ptr+6, 2); 
+          chararray[2] = '\0';
+          level = (int) strtol(chararray, &check, 10);
+          if ((chararray == check) || (level < 1) || (level > 22))
+          {
+             db_perror(cparams, E_COMPRESSION, me);
+             return (-1);
+          }
+          cd_values[0] = (unsigned int) level;
+       }
+       if (have_gzip || have_szip || have_zstd || have_lz4)
+          db_hdf5_remove_lossless();
+       if ((!strstr(cparams, "SHUFFLE=0") && H5Pset_shuffle(P_ckcrprops)<0) ||
+           H5Pset_filter(P_ckcrprops, DB_HDF5_ZSTD_ID, opt_flag, 1, cd_values)<0)
+       {
+          db_perror("H5Pset_filter", E_CALLFAIL, me);
+          return (-1);
+       }
+    }
+#endif
+#ifdef HAVE_LZ4
+    else if ((ptr=(char *)strstr(cparams, 
+       "METHOD=LZ4")) != (char *)NULL) 
+    {
+       unsigned int cd_values[2] = {DB_HDF5_LZ4_BLOCK, 1};
+       if ((ptr=(char *)strstr(cparams, 
+          "LEVEL=")) != (char *)NULL)
+       {
+          (void)strncpy(chararray, ptr+6, 1); 
+          chararray[1] = '\0';
+          level = (int) strtol(chararray, &check, 10);
+          if ((chararray == check) || (level < 1) || (level > 9))
+          {
+             db_perror(cparams, E_COMPRESSION, me);
+             return (-1);
+          }
+          cd_values[1] = (unsigned int) level;
+       }
+       if (have_gzip || have_szip || have_zstd || have_lz4)
+          db_hdf5_remove_lossless();
+       if ((!strstr(cparams, "SHUFFLE=0") && H5Pset_shuffle(P_ckcrprops)<0) ||
+           H5Pset_filter(P_ckcrprops, DB_HDF5_LZ4_ID, opt_flag, 2, cd_values)<0)
+       {
+          db_perror("H5Pset_filter", E_CALLFAIL, me);
+          return (-1);
+       }
+    }
+#endif
+#endif
+    else
+    {
+       db_perror(cparams, E_COMPRESSION, me);
+       return (-1);
     }
     return 0;
 }
@@ -3705,13 +4862,13 @@ db_hdf5_set_properties(DBfile *dbfile, int rank, hsize_t size[])
     static char *me = "db_hdf5_set_properties";
     P_crprops = H5P_DEFAULT;
     if (DBGetEnableChecksumsFile(dbfile) && 
-        !DBGetCompressionFile(dbfile))
+        !db_hdf5_compression(dbfile))
     {
         H5Pset_chunk(P_ckcrprops, rank, size);
         P_crprops = P_ckcrprops;
     }
     else if (DBGetEnableChecksumsFile(dbfile) && 
-        DBGetCompressionFile(dbfile))
+        db_hdf5_compression(dbfile))
     {
         H5Pset_chunk(P_ckcrprops, rank, size);
         if (db_hdf5_set_compression(dbfile, 0)<0) {
@@ -3720,7 +4877,7 @@ db_hdf5_set_properties(DBfile *dbfile, int rank, hsize_t size[])
         }
         P_crprops = P_ckcrprops;
     }
-    else if (DBGetCompressionFile(dbfile))
+    else if (db_hdf5_compression(dbfile))
     {
         H5Pset_chunk(P_ckcrprops, rank, size);
         if (db_hdf5_set_compression(dbfile, 0)<0) {
@@ -3898,6 +5055,7 @@ db_hdf5_get_comp_var(DBfile *_dbfile, char const *name, hsize_t *nelmts,
                         }
                         retval = 0;
                     }
+                    db_hdf5_stats(d, mtype, H5S_ALL, 0);
                 }
                 H5Tclose(ftype);
                 H5Dclose(d);
@@ -4260,6 +5418,8 @@ db_hdf5_handle_ctdt(DBfile_hdf5 *dbfile, int ts, float t, int dts, double dt, in
                 space = H5Screate_simple(1, &one, &one);
             dset = H5Dcreate(dbfile->cwg, names[i], ftype, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
             H5Dwrite(dset, mtype, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf[i]);
+            db_stats_dataset();
+            db_hdf5_stats(dset, mtype, H5S_ALL, 1);
             H5Dclose(dset);
         }
 
@@ -4271,73 +5431,1186 @@ db_hdf5_handle_ctdt(DBfile_hdf5 *dbfile, int ts, float t, int dts, double dt, in
 }
 
 /*-------------------------------------------------------------------------
- * Function:    db_hdf5_compname
- *
- * Purpose:     Returns a new name relative to the link directory. The name
- *              is generated by reading the `nlinks' attribute of the link
- *              directory, incrementing it, creating a file name, and saving
- *              it back to the file.
- *
- * Return:      Success:        0, A new link name not more than 8 characters
- *                              long counting the null terminator is returned
- *                              through the NAME argument.
- *
- *              Failure:        -1
- *
- * Programmer:  Robb Matzke
- *              Tuesday, March 23, 1999
- *
- * Modifications:
+ * Function:    db_hdf5_compname
+ *
+ * Purpose:     Returns a new name relative to the link directory. The name
+ *              is generated by reading the `nlinks' attribute of the link
+ *              directory, incrementing it, creating a file name, and saving
+ *              it back to the file.
+ *
+ * Return:      Success:        0, A new link name not more than 8 characters
+ *                              long counting the null terminator is returned
+ *                              through the NAME argument.
+ *
+ *              Failure:        -1
+ *
+ * Programmer:  Robb Matzke
+ *              Tuesday, March 23, 1999
+ *
+ * Modifications:
+ *
+ *-------------------------------------------------------------------------
+ */
+PRIVATE int
+db_hdf5_compname(DBfile_hdf5 *dbfile, char name[8]/*out*/)
+{
+    static char *me = "db_hdf5_compname";
+    hid_t       attr=-1;
+    int         nlinks;
+
+    PROTECT {
+        /* Open or create the `nlinks' attribute of the link group */
+        H5E_BEGIN_TRY {
+            attr = H5Aopen_name(dbfile->link, "nlinks");
+        } H5E_END_TRY;
+        if (attr<0 && (attr=H5Acreate(dbfile->link, "nlinks", H5T_NATIVE_INT,
+                                      SCALAR, H5P_DEFAULT, H5P_DEFAULT))<0) {
+            db_perror("nlinks attribute", E_CALLFAIL, me);
+            UNWIND();
+        }
+
+        /* Increment the nlinks value */
+        if (H5Aread(attr, H5T_NATIVE_INT, &nlinks)<0) {
+            db_perror("nlinks attribute", E_CALLFAIL, me);
+            UNWIND();
+        }
+
+        nlinks++;
+        if (nlinks > 999999) {
+            db_perror("exceeded maximum number of nlinks", E_CALLFAIL, me);
+            UNWIND();
+        }
+
+        if (H5Awrite(attr, H5T_NATIVE_INT, &nlinks)<0) {
+            db_perror("nlinks attribute", E_CALLFAIL, me);
+            UNWIND();
+        }
+        H5Aclose(attr);
+
+        /* Create a name */
+        sprintf(name, "#%06d", nlinks);
+        
+    } CLEANUP {
+        H5E_BEGIN_TRY {
+            H5Aclose(attr);
+        } H5E_END_TRY;
+    } END_PROTECT;
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_float_storage_hint
+ *
+ * Purpose:     Note the DBOPT_FLOAT_STORAGE option of a Put call for the
+ *              arrays it writes. The hint is ignored by db_hdf5_compwrz
+ *              once the API call that gave it has returned.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE void
+db_hdf5_float_storage_hint(DBfile_hdf5 *dbfile, DBoptlist const *optlist)
+{
+    dbfile->float_storage_hint = (int const *) DBGetOption(optlist, DBOPT_FLOAT_STORAGE);
+    dbfile->float_storage_call = db_stats_call_id();
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_float_storage
+ *
+ * Purpose:     Determine how an array of the given type is to be stored.
+ *              The DBOPT_FLOAT_STORAGE option of the current Put call, if
+ *              any, takes precedence over the file's DBSetFloatStorage.
+ *
+ * Return:      One of the DB_FLOAT_STORAGE_XXX values
+ *-------------------------------------------------------------------------
+ */
+PRIVATE int
+db_hdf5_float_storage(DBfile_hdf5 *dbfile, int dtype)
+{
+    if (dtype != DB_FLOAT && dtype != DB_DOUBLE)
+        return DB_FLOAT_STORAGE_NATIVE;
+    if (dbfile->float_storage_hint)
+        return *dbfile->float_storage_hint;
+    return DBGetFloatStorageFile((DBfile*)dbfile);
+}
+
+/*-------------------------------------------------------------------------
+ * Content-hash deduplication of array data.
+ *
+ * When enabled with DBSetDeduplication(File), every array passing through
+ * db_hdf5_compwrz is hashed (two independent 64 bit hashes seeded with its
+ * type and shape) before it is written. If an identical array has already
+ * been written to this file, a hard link to the existing dataset is created
+ * instead of a new dataset. If an identical array exists in the file named
+ * by PREVFILE=, an external link into that file is created. The table of
+ * hashes is saved in the link group at close so that it is available to
+ * subsequent appends and to the next file in a sequence. Compression
+ * parameters are folded into the seed so that data written with lossy
+ * parameters is never linked in place of data written losslessly.
+ *-------------------------------------------------------------------------
+ */
+#define DEDUP_INDEX_NAME        LINKGRP "dedup"
+#define DEDUP_DEFAULT_MINSIZE   256
+
+typedef struct db_hdf5_dedup_ent_t {
+    unsigned long long  h0, h1;         /*independent hashes of data    */
+    unsigned long long  nbytes;         /*size of data; 0 if slot empty */
+    int                 dtype;          /*silo datatype of data         */
+    char                file[256];      /*file holding data; "" if this */
+    char                path[256];      /*absolute path of dataset      */
+    int                 used;           /*referenced from this file     */
+} db_hdf5_dedup_ent_t;
+
+typedef struct db_hdf5_dedup_t {
+    int                 nents;          /*number of occupied slots      */
+    int                 maxents;        /*number of slots; power of 2   */
+    db_hdf5_dedup_ent_t *ents;          /*open addressed hash table     */
+    char                prevfile[256];  /*prev. file index was read from*/
+    int                 dirty;          /*index needs to be saved       */
+} db_hdf5_dedup_t;
+
+#if HDF5_VERSION_GE(1,8,0)
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_dedup_params
+ *
+ * Purpose:     Parse the deduplication options for a file. A PREVFILE
+ *              name too long for the dedup index is ignored so data is
+ *              only deduplicated within the file.
+ *
+ * Return:      1 if deduplication is enabled, 0 otherwise.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE int
+db_hdf5_dedup_params(DBfile_hdf5 *dbfile, int *minsize, char prevfile[256])
+{
+    char const *opts = DBGetDeduplicationFile((DBfile*)dbfile);
+    char const *p;
+
+    if (!opts) return 0;
+
+    *minsize = DEDUP_DEFAULT_MINSIZE;
+    if ((p=strstr(opts, "MINSIZE=")))
+        *minsize = (int) strtol(p+8, 0, 10);
+
+    prevfile[0] = '\0';
+    if ((p=strstr(opts, "PREVFILE=")))
+    {
+        int n = 0;
+        p += 9;
+        while (p[n] && p[n] != ' ' && n < 255)
+        {
+            prevfile[n] = p[n];
+            n++;
+        }
+        prevfile[n] = '\0';
+        if (p[n] && p[n] != ' ')
+            prevfile[0] = '\0';
+    }
+
+    return 1;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_dedup_relpath
+ *
+ * Purpose:     Name the file TARGET, given relative to the current working
+ *              directory, as an external link target in the file FROM.
+ *              HDF5 resolves relative link targets against the directory
+ *              of the file holding the link.
+ *
+ * Return:      Success:    0; the name is returned in OUT.
+ *              Failure:    -1 (the name does not fit in OUT)
+ *-------------------------------------------------------------------------
+ */
+PRIVATE int
+db_hdf5_dedup_relpath(char const *target, char const *from, char out[256])
+{
+    char const *slash = from ? strrchr(from, '/') : 0;
+    size_t dirlen = slash ? (size_t) (slash - from) + 1 : 0;
+
+    out[0] = '\0';
+    if (target[0] == '/' || !dirlen)
+    {
+        if (strlen(target) >= 256) return -1;
+        strcpy(out, target);
+    }
+    else if (!strncmp(target, from, dirlen))
+    {
+        /* Target is in or below the directory of FROM */
+        if (strlen(target + dirlen) >= 256) return -1;
+        strcpy(out, target + dirlen);
+    }
+    else
+    {
+        /* Otherwise name it absolutely */
+#if HAVE_UNISTD_H
+        if (!getcwd(out, 256) || strlen(out) + strlen(target) + 1 >= 256)
+            return -1;
+        strcat(out, "/");
+        strcat(out, target);
+#else
+        if (strlen(target) >= 256) return -1;
+        strcpy(out, target);
+#endif
+    }
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_dedup_find
+ *
+ * Purpose:     Find the slot for the given key in the dedup table.
+ *
+ * Return:      Pointer to matching slot or to empty slot where the key
+ *              would be inserted. NULL if the table is empty.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE db_hdf5_dedup_ent_t *
+db_hdf5_dedup_find(db_hdf5_dedup_t *dd, unsigned long long h0,
+    unsigned long long h1, unsigned long long nbytes, int dtype)
+{
+    unsigned long long mask = (unsigned long long) dd->maxents - 1;
+    unsigned long long i = h0 & mask;
+
+    if (!dd->maxents) return 0;
+
+    while (dd->ents[i].nbytes)
+    {
+        db_hdf5_dedup_ent_t *e = &dd->ents[i];
+        if (e->h0 == h0 && e->h1 == h1 && e->nbytes == nbytes && e->dtype == dtype)
+            break;
+        i = (i + 1) & mask;
+    }
+    return &dd->ents[i];
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_dedup_insert
+ *
+ * Purpose:     Add an entry to the dedup table, growing it as necessary.
+ *              Entries for keys already in the table are ignored.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE void
+db_hdf5_dedup_insert(db_hdf5_dedup_t *dd, db_hdf5_dedup_ent_t const *ent)
+{
+    db_hdf5_dedup_ent_t *slot;
+
+    if (2 * (dd->nents + 1) > dd->maxents)
+    {
+        int i, oldmax = dd->maxents;
+        db_hdf5_dedup_ent_t *old = dd->ents;
+        dd->maxents = oldmax ? 2 * oldmax : 256;
+        dd->ents = (db_hdf5_dedup_ent_t *) calloc(dd->maxents, sizeof(*old));
+        for (i = 0; i < oldmax; i++)
+        {
+            if (!old[i].nbytes) continue;
+            *db_hdf5_dedup_find(dd, old[i].h0, old[i].h1, old[i].nbytes, old[i].dtype) = old[i];
+        }
+        FREE(old);
+    }
+
+    slot = db_hdf5_dedup_find(dd, ent->h0, ent->h1, ent->nbytes, ent->dtype);
+    if (slot->nbytes) return;
+    *slot = *ent;
+    dd->nents++;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_dedup_type
+ *
+ * Purpose:     Create the compound type used to store the dedup index.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE hid_t
+db_hdf5_dedup_type(void)
+{
+    hid_t t = H5Tcreate(H5T_COMPOUND, sizeof(db_hdf5_dedup_ent_t));
+    hid_t s = H5Tcopy(H5T_C_S1);
+
+    H5Tset_size(s, 256);
+    H5Tinsert(t, "h0", HOFFSET(db_hdf5_dedup_ent_t, h0), H5T_NATIVE_ULLONG);
+    H5Tinsert(t, "h1", HOFFSET(db_hdf5_dedup_ent_t, h1), H5T_NATIVE_ULLONG);
+    H5Tinsert(t, "nbytes", HOFFSET(db_hdf5_dedup_ent_t, nbytes), H5T_NATIVE_ULLONG);
+    H5Tinsert(t, "dtype", HOFFSET(db_hdf5_dedup_ent_t, dtype), H5T_NATIVE_INT);
+    H5Tinsert(t, "file", HOFFSET(db_hdf5_dedup_ent_t, file), s);
+    H5Tinsert(t, "path", HOFFSET(db_hdf5_dedup_ent_t, path), s);
+    H5Tclose(s);
+    return t;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_dedup_load
+ *
+ * Purpose:     Merge the dedup index stored in an HDF5 file into the
+ *              table. If `asfile' is non-NULL, entries local to that
+ *              file are recorded as residing in `asfile' and entries
+ *              linking elsewhere are made relative to the directory of
+ *              `asfile'. Entries whose file name would not fit in the
+ *              index are skipped.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1 (no index in the file)
+ *-------------------------------------------------------------------------
+ */
+PRIVATE int
+db_hdf5_dedup_load(db_hdf5_dedup_t *dd, hid_t fid, char const *asfile)
+{
+    hid_t dset = -1, space = -1, type = -1;
+    db_hdf5_dedup_ent_t *buf = 0;
+    hssize_t i, n = 0;
+    int retval = -1;
+
+    H5E_BEGIN_TRY {
+        dset = H5Dopen(fid, DEDUP_INDEX_NAME, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if (dset < 0) return -1;
+
+    type = db_hdf5_dedup_type();
+    space = H5Dget_space(dset);
+    if (space >= 0 && (n = H5Sget_simple_extent_npoints(space)) > 0)
+    {
+        buf = (db_hdf5_dedup_ent_t *) calloc((size_t) n, sizeof(db_hdf5_dedup_ent_t));
+        if (buf && H5Dread(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) >= 0)
+        {
+            for (i = 0; i < n; i++)
+            {
+                if (!buf[i].nbytes) continue;
+                if (asfile && !buf[i].file[0])
+                {
+                    if (strlen(asfile) >= sizeof(buf[i].file)) continue;
+                    strcpy(buf[i].file, asfile);
+                }
+                else if (asfile && buf[i].file[0] != '/' && strrchr(asfile, '/'))
+                {
+                    char tmp[sizeof(buf[i].file)];
+                    int dirlen = (int) (strrchr(asfile, '/') - asfile) + 1;
+                    int len = snprintf(tmp, sizeof(tmp), "%.*s%s", dirlen, asfile, buf[i].file);
+                    if (len < 0 || len >= (int) sizeof(tmp)) continue;
+                    strcpy(buf[i].file, tmp);
+                }
+                buf[i].used = 0;
+                db_hdf5_dedup_insert(dd, &buf[i]);
+            }
+            retval = 0;
+        }
+        FREE(buf);
+    }
+
+    H5Sclose(space);
+    H5Tclose(type);
+    H5Dclose(dset);
+    return retval;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_dedup_get
+ *
+ * Purpose:     Return the dedup table for the file, creating it on first
+ *              use and loading the file's own index (for appends) and
+ *              the index of the previous file, if any.
+ *
+ * Return:      Dedup table or NULL if deduplication is not enabled.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE db_hdf5_dedup_t *
+db_hdf5_dedup_get(DBfile_hdf5 *dbfile, int *minsize)
+{
+    db_hdf5_dedup_t *dd = dbfile->dedup;
+    char prevfile[256];
+
+    if (!db_hdf5_dedup_params(dbfile, minsize, prevfile))
+        return 0;
+
+    if (!dd)
+    {
+        dd = dbfile->dedup = (db_hdf5_dedup_t *) calloc(1, sizeof(db_hdf5_dedup_t));
+        db_hdf5_dedup_load(dd, dbfile->fid, 0);
+    }
+
+    /* Load index of the previous file once for each new PREVFILE setting */
+    if (prevfile[0] && strcmp(prevfile, dd->prevfile))
+    {
+        hid_t pfid = -1;
+        strcpy(dd->prevfile, prevfile);
+        H5E_BEGIN_TRY {
+            pfid = H5Fopen(prevfile, H5F_ACC_RDONLY, H5P_DEFAULT);
+        } H5E_END_TRY;
+        if (pfid >= 0)
+        {
+            char target[256];
+            if (db_hdf5_dedup_relpath(prevfile, dbfile->pub.name, target) == 0)
+                db_hdf5_dedup_load(dd, pfid, target);
+            H5Fclose(pfid);
+        }
+    }
+
+    return dd;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_dedup_link
+ *
+ * Purpose:     Satisfy a write with a link to existing, identical data.
+ *              The link is placed exactly where db_hdf5_compwrz would
+ *              have created the dataset.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *-------------------------------------------------------------------------
+ */
+PRIVATE int
+db_hdf5_dedup_link(DBfile_hdf5 *dbfile, db_hdf5_dedup_ent_t *ent,
+    char *name/*in,out*/, char const *fname)
+{
+    int friendly = DBGetFriendlyHDF5NamesFile((DBfile*)dbfile);
+    hid_t loc = dbfile->link;
+    char const *lname = name;
+    herr_t status;
+
+    if (friendly == 2 && fname)
+    {
+        loc = dbfile->cwg;
+        lname = fname;
+    }
+
+    H5E_BEGIN_TRY {
+        if (ent->file[0])
+            status = H5Lcreate_external(ent->file, ent->path, loc, lname, H5P_DEFAULT, H5P_DEFAULT);
+        else
+            status = H5Lcreate_hard(dbfile->fid, ent->path, loc, lname, H5P_DEFAULT, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if (status < 0) return -1;
+
+    if (friendly == 2 && fname)
+        strcpy(name, fname);
+    else if (friendly == 1 && fname)
+        H5Glink(dbfile->cwg, H5G_LINK_SOFT, name, fname);
+
+    if (ent->file[0] && !ent->used)
+        dbfile->dedup->dirty = 1;
+    ent->used = 1;
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_dedup_try
+ *
+ * Purpose:     Hash the data of a pending db_hdf5_compwrz call and, if
+ *              identical data has already been written, satisfy the write
+ *              with a link to it. HZIP'd data is excluded because
+ *              decompressing it depends upon the mesh it belongs to.
+ *
+ * Return:      2 if the write was satisfied with a link, 1 if the data
+ *              should be written and then recorded using `ent', 0 if
+ *              deduplication does not apply and -1 on failure.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE int
+db_hdf5_dedup_try(DBfile_hdf5 *dbfile, int dtype, int rank, int const _size[],
+    int nels, void const *buf, char *name/*in,out*/, char const *fname,
+    int compressionFlags, db_hdf5_dedup_ent_t *ent/*out*/)
+{
+    static char *me = "db_hdf5_dedup_try";
+    char const *cparams = DBGetCompressionFile((DBfile*)dbfile);
+    db_hdf5_dedup_t *dd;
+    db_hdf5_dedup_ent_t *match;
+    unsigned long long seed;
+    hid_t mtype;
+    int i, minsize, shape[11];
+
+    if (!(dd = db_hdf5_dedup_get(dbfile, &minsize)))
+        return 0;
+    if (compressionFlags && cparams && strstr(cparams, "METHOD=HZIP"))
+        return 0;
+    if ((mtype = silom2hdfm_type(dtype)) < 0 || rank > 8)
+        return 0;
+
+    memset(ent, 0, sizeof(*ent));
+    ent->nbytes = (unsigned long long) nels * H5Tget_size(mtype);
+    ent->dtype = dtype;
+    if (ent->nbytes < (unsigned long long) minsize)
+        return 0;
+
+    /* Seed the hashes with shape, storage and compression parameters so
+       that datasets differing in any of them are distinct. The parameters
+       may call for loss (e.g. PRECISION=, RATE=) */
+    shape[0] = rank;
+    shape[1] = dtype;
+    shape[2] = db_hdf5_float_storage(dbfile, dtype);
+    for (i=0; i<rank; i++) shape[i+3] = _size[i];
+    seed = db_hash64(shape, (rank+3) * sizeof(int), 0);
+    if (cparams)
+        seed = db_hash64(cparams, strlen(cparams), seed);
+    ent->h0 = db_hash64(buf, (size_t) ent->nbytes, seed);
+    ent->h1 = db_hash64(buf, (size_t) ent->nbytes, ~seed);
+
+    match = db_hdf5_dedup_find(dd, ent->h0, ent->h1, ent->nbytes, ent->dtype);
+    if (!match || !match->nbytes)
+        return 1;
+
+    if (!*name) {
+        strcpy(name, LINKGRP);
+        if (db_hdf5_compname(dbfile, ENDOF(name)/*out*/)<0)
+            return db_perror("compname", E_CALLFAIL, me);
+    }
+
+    return db_hdf5_dedup_link(dbfile, match, name, fname) == 0 ? 2 : 1;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_dedup_finish
+ *
+ * Purpose:     Save the dedup index (entries local to this file and those
+ *              in other files it links to) in the link group and free
+ *              the table.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE void
+db_hdf5_dedup_finish(DBfile_hdf5 *dbfile)
+{
+    db_hdf5_dedup_t *dd = dbfile->dedup;
+    db_hdf5_dedup_ent_t *buf;
+    int i, n = 0;
+
+    if (!dd) return;
+
+    if (dd->dirty && (buf = (db_hdf5_dedup_ent_t *) malloc(dd->nents * sizeof(*buf))))
+    {
+        for (i = 0; i < dd->maxents; i++)
+        {
+            if (!dd->ents[i].nbytes) continue;
+            if (dd->ents[i].file[0] && !dd->ents[i].used) continue;
+            buf[n++] = dd->ents[i];
+        }
+
+        H5E_BEGIN_TRY {
+            hsize_t size = (hsize_t) n;
+            hid_t type = db_hdf5_dedup_type();
+            hid_t space = H5Screate_simple(1, &size, &size);
+            hid_t dset;
+            H5Ldelete(dbfile->fid, DEDUP_INDEX_NAME, H5P_DEFAULT);
+            dset = H5Dcreate(dbfile->fid, DEDUP_INDEX_NAME, type, space,
+                       H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+            if (n) H5Dwrite(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+            H5Dclose(dset);
+            H5Sclose(space);
+            H5Tclose(type);
+        } H5E_END_TRY;
+
+        free(buf);
+    }
+
+    FREE(dd->ents);
+    FREE(dbfile->dedup);
+}
+#else
+PRIVATE int db_hdf5_dedup_try(DBfile_hdf5 *dbfile, int dtype, int rank, int const _size[],
+    int nels, void const *buf, char *name, char const *fname,
+    int compressionFlags, db_hdf5_dedup_ent_t *ent) {return 0;}
+PRIVATE void db_hdf5_dedup_insert(db_hdf5_dedup_t *dd, db_hdf5_dedup_ent_t const *ent) {}
+PRIVATE void db_hdf5_dedup_finish(DBfile_hdf5 *dbfile) {}
+#endif
+
+/*-------------------------------------------------------------------------
+ * Automatic selection of the compression method (METHOD=AUTO)
+ *
+ * When the compression parameters call for METHOD=AUTO, a few evenly
+ * spaced slabs of each array written are trial compressed, in an in-memory
+ * HDF5 file, with each method available in this build. The method which
+ * minimizes the time to compress plus the time to write what remains at
+ * BANDWIDTH= MB/s (default 500) is used for the whole array. The other
+ * parameters are passed along to each method. So, the methods are lossless
+ * unless those parameters permit loss (e.g. PRECISION=, DIGITS=, LOSS=,
+ * RATE=, ACCURACY=). Methods with a ratio below MINRATIO=, if given, are
+ * not used. Choices are cached by array name and type for the life of the
+ * process so an array is tried only once over a sequence of dumps. The
+ * choices used in a file are recorded in the link group.
+ *-------------------------------------------------------------------------
+ */
+#define AUTOCOMP_INDEX_NAME     LINKGRP "compression"
+#define AUTOCOMP_SAMPLE_NELS    16384   /*most values trial compressed  */
+#define AUTOCOMP_NSLABS         4       /*number of slabs sampled       */
+#define AUTOCOMP_MIN_NBYTES     4096    /*smaller arrays not compressed */
+#define AUTOCOMP_DEFAULT_BW     500.0   /*MB/s                          */
+#define AUTOCOMP_SCRATCH_MAX    (8<<20) /*scratch file size to recreate */
+
+typedef struct db_hdf5_autocomp_ent_t {
+    char                name[128];      /*array name; "" if slot empty  */
+    char                method[16];     /*chosen method or "NONE"       */
+    int                 dtype;          /*silo datatype of array        */
+} db_hdf5_autocomp_ent_t;
+
+typedef struct db_hdf5_autocomp_t {
+    int                 nents;          /*number of occupied slots      */
+    int                 maxents;        /*number of slots; power of 2   */
+    db_hdf5_autocomp_ent_t *ents;       /*open addressed hash table     */
+    int                 dirty;          /*table needs to be saved       */
+    hid_t               scratch;        /*in-memory file for trials     */
+} db_hdf5_autocomp_t;
+
+#if HDF5_VERSION_GE(1,8,0)
+static db_hdf5_autocomp_t db_hdf5_autocomp_cache; /*choices for process */
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_autocomp_find
+ *
+ * Purpose:     Find the slot for the given array in a table of choices.
+ *
+ * Return:      Pointer to matching slot or to empty slot where the array
+ *              would be inserted. NULL if the table is empty.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE db_hdf5_autocomp_ent_t *
+db_hdf5_autocomp_find(db_hdf5_autocomp_t *ac, char const *name, int dtype)
+{
+    unsigned long long mask = (unsigned long long) ac->maxents - 1;
+    unsigned long long i;
+
+    if (!ac->maxents) return 0;
+
+    i = db_hash64(name, strlen(name), (unsigned long long) dtype) & mask;
+    while (ac->ents[i].name[0])
+    {
+        db_hdf5_autocomp_ent_t *e = &ac->ents[i];
+        if (e->dtype == dtype && !strcmp(e->name, name))
+            break;
+        i = (i + 1) & mask;
+    }
+    return &ac->ents[i];
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_autocomp_insert
+ *
+ * Purpose:     Add or update the choice for an array in a table, growing
+ *              it as necessary.
+ *
+ * Return:      1 if the table changed, 0 otherwise.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE int
+db_hdf5_autocomp_insert(db_hdf5_autocomp_t *ac, db_hdf5_autocomp_ent_t const *ent)
+{
+    db_hdf5_autocomp_ent_t *slot;
+
+    if (2 * (ac->nents + 1) > ac->maxents)
+    {
+        int i, oldmax = ac->maxents;
+        db_hdf5_autocomp_ent_t *old = ac->ents;
+        ac->maxents = oldmax ? 2 * oldmax : 64;
+        ac->ents = (db_hdf5_autocomp_ent_t *) calloc(ac->maxents, sizeof(*old));
+        for (i = 0; i < oldmax; i++)
+        {
+            if (!old[i].name[0]) continue;
+            *db_hdf5_autocomp_find(ac, old[i].name, old[i].dtype) = old[i];
+        }
+        FREE(old);
+    }
+
+    slot = db_hdf5_autocomp_find(ac, ent->name, ent->dtype);
+    if (slot->name[0] && !strcmp(slot->method, ent->method))
+        return 0;
+    if (!slot->name[0])
+        ac->nents++;
+    *slot = *ent;
+    return 1;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_autocomp_type
+ *
+ * Purpose:     Create the compound type used to record the choices.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE hid_t
+db_hdf5_autocomp_type(void)
+{
+    hid_t t = H5Tcreate(H5T_COMPOUND, sizeof(db_hdf5_autocomp_ent_t));
+    hid_t s1 = H5Tcopy(H5T_C_S1);
+    hid_t s2 = H5Tcopy(H5T_C_S1);
+
+    H5Tset_size(s1, sizeof(((db_hdf5_autocomp_ent_t*)0)->name));
+    H5Tset_size(s2, sizeof(((db_hdf5_autocomp_ent_t*)0)->method));
+    H5Tinsert(t, "name", HOFFSET(db_hdf5_autocomp_ent_t, name), s1);
+    H5Tinsert(t, "method", HOFFSET(db_hdf5_autocomp_ent_t, method), s2);
+    H5Tinsert(t, "dtype", HOFFSET(db_hdf5_autocomp_ent_t, dtype), H5T_NATIVE_INT);
+    H5Tclose(s1);
+    H5Tclose(s2);
+    return t;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_autocomp_get
+ *
+ * Purpose:     Return the table of choices used in the file, creating it
+ *              on first use. Choices already recorded in the file (when
+ *              appending) are loaded into it and into the process cache.
+ *
+ * Return:      Table of choices or NULL if it cannot be allocated.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE db_hdf5_autocomp_t *
+db_hdf5_autocomp_get(DBfile_hdf5 *dbfile)
+{
+    hid_t dset = -1, space = -1, type = -1;
+    db_hdf5_autocomp_ent_t *buf = 0;
+    hssize_t i, n = 0;
+
+    if (dbfile->autocomp)
+        return dbfile->autocomp;
+    if (!(dbfile->autocomp = (db_hdf5_autocomp_t *) calloc(1, sizeof(db_hdf5_autocomp_t))))
+        return 0;
+    dbfile->autocomp->scratch = -1;
+
+    H5E_BEGIN_TRY {
+        dset = H5Dopen(dbfile->fid, AUTOCOMP_INDEX_NAME, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if (dset < 0) return dbfile->autocomp;
+
+    type = db_hdf5_autocomp_type();
+    space = H5Dget_space(dset);
+    if (space >= 0 && (n = H5Sget_simple_extent_npoints(space)) > 0 &&
+        (buf = (db_hdf5_autocomp_ent_t *) calloc((size_t) n, sizeof(*buf))))
+    {
+        if (H5Dread(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) >= 0)
+        {
+            for (i = 0; i < n; i++)
+            {
+                buf[i].name[sizeof(buf[i].name)-1] = '\0';
+                buf[i].method[sizeof(buf[i].method)-1] = '\0';
+                if (!buf[i].name[0]) continue;
+                db_hdf5_autocomp_insert(dbfile->autocomp, &buf[i]);
+                db_hdf5_autocomp_insert(&db_hdf5_autocomp_cache, &buf[i]);
+            }
+        }
+        free(buf);
+    }
+
+    H5Sclose(space);
+    H5Tclose(type);
+    H5Dclose(dset);
+    return dbfile->autocomp;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_autocomp_strip
+ *
+ * Purpose:     Remove all compression filters, but not the checksum,
+ *              from the dataset creation properties so the next method
+ *              starts from a clean slate.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE void
+db_hdf5_autocomp_strip(void)
+{
+    H5E_BEGIN_TRY {
+        H5Premove_filter(P_ckcrprops, H5Z_FILTER_SHUFFLE);
+        H5Premove_filter(P_ckcrprops, H5Z_FILTER_DEFLATE);
+#ifdef H5_HAVE_FILTER_SZIP
+        H5Premove_filter(P_ckcrprops, H5Z_FILTER_SZIP);
+#endif
+        H5Premove_filter(P_ckcrprops, DB_HDF5_FPZIP_ID);
+#ifdef HAVE_ZFP
+        H5Premove_filter(P_ckcrprops, H5Z_FILTER_ZFP);
+#endif
+        H5Premove_filter(P_ckcrprops, DB_HDF5_ZSTD_ID);
+        H5Premove_filter(P_ckcrprops, DB_HDF5_LZ4_ID);
+    } H5E_END_TRY;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_autocomp_use
+ *
+ * Purpose:     Put a method into effect by substituting it for AUTO in the
+ *              compression parameters. ZFP is made lossless with
+ *              REVERSIBLE unless the parameters select one of its lossy
+ *              modes.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE void
+db_hdf5_autocomp_use(char const *cparams, char const *method)
+{
+    char const *p = strstr(cparams, "METHOD=AUTO");
+
+    db_hdf5_autocomp_active = 1;
+    db_hdf5_autocomp_params[0] = '\0';
+    if (!strcmp(method, "NONE") ||
+        strlen(cparams) + 32 > sizeof(db_hdf5_autocomp_params))
+        return;
+
+    sprintf(db_hdf5_autocomp_params, "%.*sMETHOD=%s%s", (int) (p - cparams),
+        cparams, method, p + strlen("METHOD=AUTO"));
+    if (!strcmp(method, "ZFP") && !strstr(cparams, "RATE=") &&
+        !strstr(cparams, "PRECISION=") && !strstr(cparams, "ACCURACY=") &&
+        !strstr(cparams, "EXPERT=") && !strstr(cparams, "REVERSIBLE"))
+        strcat(db_hdf5_autocomp_params, " REVERSIBLE");
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_autocomp_sample
+ *
+ * Purpose:     Gather AUTOCOMP_NSLABS evenly spaced slabs of an array
+ *              into a sample of at most AUTOCOMP_SAMPLE_NELS values. The
+ *              slabs are whole rows of the slowest varying dimension, so
+ *              the sample has the shape of the array, unless even a few
+ *              rows are too big. Small arrays are their own sample.
+ *
+ * Return:      The sample, which is `buf' itself or a buffer the caller
+ *              must free (also returned in `tofree'). NULL on failure.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE void const *
+db_hdf5_autocomp_sample(void const *buf, size_t esize, int rank,
+    int const dims[], int *srank/*out*/, hsize_t ssize[]/*out*/,
+    void **tofree/*out*/)
+{
+    long long nels = 1, rowlen = 1, rows, len, start;
+    char *out;
+    int i, s;
+
+    for (i = 0; i < rank; i++) nels *= dims[i];
+    for (i = 1; i < rank; i++) rowlen *= dims[i];
+    *tofree = 0;
+
+    if (nels <= AUTOCOMP_SAMPLE_NELS)
+    {
+        *srank = rank;
+        for (i = 0; i < rank; i++) ssize[i] = (hsize_t) dims[i];
+        return buf;
+    }
+
+    if (!(out = (char *) malloc(AUTOCOMP_SAMPLE_NELS * esize)))
+        return 0;
+    *tofree = out;
+
+    if (rank > 1 && rowlen * AUTOCOMP_NSLABS <= AUTOCOMP_SAMPLE_NELS)
+    {
+        rows = AUTOCOMP_SAMPLE_NELS / (AUTOCOMP_NSLABS * rowlen);
+        len = rows * rowlen;
+        *srank = rank;
+        ssize[0] = (hsize_t) (AUTOCOMP_NSLABS * rows);
+        for (i = 1; i < rank; i++) ssize[i] = (hsize_t) dims[i];
+        for (s = 0; s < AUTOCOMP_NSLABS; s++)
+        {
+            start = s * (dims[0] - rows) / (AUTOCOMP_NSLABS - 1) * rowlen;
+            memcpy(out + s * len * esize, (char const *) buf + start * esize,
+                (size_t) (len * esize));
+        }
+    }
+    else
+    {
+        len = AUTOCOMP_SAMPLE_NELS / AUTOCOMP_NSLABS;
+        *srank = 1;
+        ssize[0] = (hsize_t) (AUTOCOMP_NSLABS * len);
+        for (s = 0; s < AUTOCOMP_NSLABS; s++)
+        {
+            start = s * (nels - len) / (AUTOCOMP_NSLABS - 1);
+            memcpy(out + s * len * esize, (char const *) buf + start * esize,
+                (size_t) (len * esize));
+        }
+    }
+    return out;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_autocomp_scratch
+ *
+ * Purpose:     Return the in-memory scratch file in which the file's
+ *              trials are run, creating it on first use. Trials unlink
+ *              their datasets so the space is reused, but the file is
+ *              recreated should it grow beyond AUTOCOMP_SCRATCH_MAX.
+ *
+ * Return:      Scratch file id or -1 if it cannot be created.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE hid_t
+db_hdf5_autocomp_scratch(db_hdf5_autocomp_t *ac)
+{
+    hsize_t size = 0;
+    hid_t fapl;
+
+    if (!ac) return -1;
+
+    H5E_BEGIN_TRY {
+        if (ac->scratch >= 0 && H5Fget_filesize(ac->scratch, &size) >= 0 &&
+            size > AUTOCOMP_SCRATCH_MAX)
+        {
+            H5Fclose(ac->scratch);
+            ac->scratch = -1;
+        }
+        if (ac->scratch < 0)
+        {
+            fapl = H5Pcreate(H5P_FILE_ACCESS);
+            H5Pset_fapl_core(fapl, (size_t) 1<<20, FALSE);
+            ac->scratch = H5Fcreate("silo_autocomp_scratch", H5F_ACC_TRUNC,
+                              H5P_DEFAULT, fapl);
+            H5Pclose(fapl);
+        }
+    } H5E_END_TRY;
+
+    return ac->scratch;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_autocomp_trial
+ *
+ * Purpose:     Compress a sample with the given method into a dataset in
+ *              the scratch file `fid'. The dataset is unlinked afterward.
+ *
+ * Return:      Success:    0 with seconds taken and bytes stored
+ *              Failure:    -1
+ *-------------------------------------------------------------------------
+ */
+PRIVATE int
+db_hdf5_autocomp_trial(DBfile_hdf5 *dbfile, hid_t fid, hid_t dapl,
+    char const *cparams, char const *method, hid_t mtype, int rank,
+    hsize_t const size[], void const *sample, double *secs/*out*/,
+    hsize_t *stored/*out*/)
+{
+    hid_t space = -1, dset = -1;
+    double t0;
+    void *trimmed;
+    hsize_t n = 1;
+    int i, retval = -1;
+
+    db_hdf5_autocomp_strip();
+    db_hdf5_autocomp_use(cparams, method);
+    if (H5Pset_chunk(P_ckcrprops, rank, size) < 0)
+        return -1;
+    if (db_hdf5_autocomp_params[0] &&
+        db_hdf5_set_compression((DBfile*)dbfile, 0) < 0)
+        return -1;
+
+    H5E_BEGIN_TRY {
+        space = H5Screate_simple(rank, size, size);
+        t0 = db_stats_clock();
+        for (i = 0; i < rank; i++) n *= size[i];
+        trimmed = db_hdf5_groom(db_hdf5_autocomp_params, mtype, sample, (size_t) n);
+        dset = H5Dcreate(fid, method, mtype, space, H5P_DEFAULT, P_ckcrprops, dapl);
+        if (dset >= 0 && H5Dwrite(dset, mtype, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                                  trimmed ? trimmed : sample) >= 0)
+        {
+            *secs = db_stats_clock() - t0;
+            *stored = H5Dget_storage_size(dset);
+            retval = 0;
+        }
+        H5Dclose(dset);
+        H5Ldelete(fid, method, H5P_DEFAULT);
+        H5Sclose(space);
+        FREE(trimmed);
+    } H5E_END_TRY;
+
+    return retval;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_autocomp_select
+ *
+ * Purpose:     Choose the compression method for an array about to be
+ *              written, when the compression parameters call for
+ *              METHOD=AUTO, and put it into effect for the dataset
+ *              creation properties until db_hdf5_autocomp_done. Arrays
+ *              too small to be worth compressing or written without data
+ *              are not compressed unless a choice was already made for
+ *              them.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE void
+db_hdf5_autocomp_select(DBfile_hdf5 *dbfile, char const *name, int dtype,
+    int rank, int const dims[], void const *buf)
+{
+    static char const *methods[] = {"NONE", "GZIP",
+#ifdef H5_HAVE_FILTER_SZIP
+        "SZIP",
+#endif
+#ifdef HAVE_FPZIP
+        "FPZIP",
+#endif
+#ifdef HAVE_ZFP
+        "ZFP",
+#endif
+#ifdef HAVE_ZSTD
+        "ZSTD",
+#endif
+#ifdef HAVE_LZ4
+        "LZ4",
+#endif
+        0};
+    char const *cparams = DBGetCompressionFile((DBfile*)dbfile);
+    char const *p;
+    db_hdf5_autocomp_t *ac;
+    db_hdf5_autocomp_ent_t ent, *hit;
+    hid_t mtype, fid = -1, dapl = -1;
+    hsize_t ssize[H5S_MAX_RANK], stored;
+    void const *sample = 0;
+    void *tofree = 0;
+    long long nels = 1;
+    size_t esize = 0;
+    double bw = AUTOCOMP_DEFAULT_BW, minratio = 0, secs, cost, best = -1;
+    int i, srank = 0, nsample = 1;
+
+    if (!cparams || !strstr(cparams, "METHOD=AUTO"))
+        return;
+
+    memset(&ent, 0, sizeof(ent));
+    if (name)
+        strncpy(ent.name, name, sizeof(ent.name)-1);
+    strcpy(ent.method, "NONE");
+    ent.dtype = dtype;
+    ac = db_hdf5_autocomp_get(dbfile);
+
+    /* Reuse the choice made for this array in this or an earlier file */
+    if (ent.name[0] &&
+        (hit = db_hdf5_autocomp_find(&db_hdf5_autocomp_cache, ent.name, dtype)) &&
+        hit->name[0])
+    {
+        strcpy(ent.method, hit->method);
+        if (ac && db_hdf5_autocomp_insert(ac, &ent))
+            ac->dirty = 1;
+        db_hdf5_autocomp_strip();
+        db_hdf5_autocomp_use(cparams, ent.method);
+        return;
+    }
+
+    for (i = 0; i < rank; i++) nels *= dims[i];
+    if ((mtype = silom2hdfm_type(dtype)) >= 0)
+        esize = H5Tget_size(mtype);
+    if (!buf || !esize || nels * (long long) esize < AUTOCOMP_MIN_NBYTES ||
+        rank > H5S_MAX_RANK)
+    {
+        db_hdf5_autocomp_strip();
+        db_hdf5_autocomp_use(cparams, "NONE");
+        return;
+    }
+
+    if ((p = strstr(cparams, "BANDWIDTH=")) && strtod(p+10, 0) > 0)
+        bw = strtod(p+10, 0);
+    if ((p = strstr(cparams, "MINRATIO=")))
+        minratio = strtod(p+9, 0);
+
+    /* Trial each method on a sample in a scratch file in memory */
+    sample = db_hdf5_autocomp_sample(buf, esize, rank, dims, &srank, ssize, &tofree);
+    if (!sample)
+    {
+        /* Do not remember a choice made without a trial */
+        db_hdf5_autocomp_strip();
+        db_hdf5_autocomp_use(cparams, "NONE");
+        return;
+    }
+    fid = db_hdf5_autocomp_scratch(ac);
+    H5E_BEGIN_TRY {
+        dapl = H5Pcreate(H5P_DATASET_ACCESS);
+        H5Pset_chunk_cache(dapl, 0, 0, 1.0);
+    } H5E_END_TRY;
+
+    for (i = 0; i < srank; i++) nsample *= (int) ssize[i];
+    for (i = 0; fid >= 0 && methods[i]; i++)
+    {
+        if ((!strcmp(methods[i], "FPZIP") || !strcmp(methods[i], "ZFP")) &&
+            dtype != DB_FLOAT && dtype != DB_DOUBLE)
+            continue;
+        if (db_hdf5_autocomp_trial(dbfile, fid, dapl, cparams, methods[i],
+                mtype, srank, ssize, sample, &secs, &stored) < 0)
+            continue;
+        if (i && (!stored || (double) nsample * esize / stored < minratio))
+            continue;
+        cost = secs + stored / (bw * 1.0e6);
+        if (best < 0 || cost < best)
+        {
+            best = cost;
+            strcpy(ent.method, methods[i]);
+        }
+    }
+
+    H5E_BEGIN_TRY {
+        H5Pclose(dapl);
+    } H5E_END_TRY;
+    FREE(tofree);
+
+    if (ent.name[0] && best >= 0)
+    {
+        db_hdf5_autocomp_insert(&db_hdf5_autocomp_cache, &ent);
+        if (ac && db_hdf5_autocomp_insert(ac, &ent))
+            ac->dirty = 1;
+    }
+    db_hdf5_autocomp_strip();
+    db_hdf5_autocomp_use(cparams, ent.method);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_autocomp_done
+ *
+ * Purpose:     End the choice put into effect by db_hdf5_autocomp_select
+ *              once the dataset has been created.
+ *-------------------------------------------------------------------------
+ */
+PRIVATE void
+db_hdf5_autocomp_done(void)
+{
+    if (!db_hdf5_autocomp_active) return;
+    db_hdf5_autocomp_strip();
+    db_hdf5_autocomp_active = 0;
+    db_hdf5_autocomp_params[0] = '\0';
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_autocomp_finish
  *
+ * Purpose:     Record the choices used in the file in the link group and
+ *              free the file's table and scratch file.
  *-------------------------------------------------------------------------
  */
-PRIVATE int
-db_hdf5_compname(DBfile_hdf5 *dbfile, char name[8]/*out*/)
+PRIVATE void
+db_hdf5_autocomp_finish(DBfile_hdf5 *dbfile)
 {
-    static char *me = "db_hdf5_compname";
-    hid_t       attr=-1;
-    int         nlinks;
+    db_hdf5_autocomp_t *ac = dbfile->autocomp;
+    db_hdf5_autocomp_ent_t *buf;
+    int i, n = 0;
 
-    PROTECT {
-        /* Open or create the `nlinks' attribute of the link group */
-        H5E_BEGIN_TRY {
-            attr = H5Aopen_name(dbfile->link, "nlinks");
-        } H5E_END_TRY;
-        if (attr<0 && (attr=H5Acreate(dbfile->link, "nlinks", H5T_NATIVE_INT,
-                                      SCALAR, H5P_DEFAULT, H5P_DEFAULT))<0) {
-            db_perror("nlinks attribute", E_CALLFAIL, me);
-            UNWIND();
-        }
+    if (!ac) return;
 
-        /* Increment the nlinks value */
-        if (H5Aread(attr, H5T_NATIVE_INT, &nlinks)<0) {
-            db_perror("nlinks attribute", E_CALLFAIL, me);
-            UNWIND();
+    if (ac->dirty && (buf = (db_hdf5_autocomp_ent_t *) malloc(ac->nents * sizeof(*buf))))
+    {
+        for (i = 0; i < ac->maxents; i++)
+        {
+            if (ac->ents[i].name[0])
+                buf[n++] = ac->ents[i];
         }
 
-        nlinks++;
-        if (nlinks > 999999) {
-            db_perror("exceeded maximum number of nlinks", E_CALLFAIL, me);
-            UNWIND();
-        }
+        H5E_BEGIN_TRY {
+            hsize_t size = (hsize_t) n;
+            hid_t type = db_hdf5_autocomp_type();
+            hid_t space = H5Screate_simple(1, &size, &size);
+            hid_t dset;
+            H5Ldelete(dbfile->fid, AUTOCOMP_INDEX_NAME, H5P_DEFAULT);
+            dset = H5Dcreate(dbfile->fid, AUTOCOMP_INDEX_NAME, type, space,
+                       H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+            if (n) H5Dwrite(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+            H5Dclose(dset);
+            H5Sclose(space);
+            H5Tclose(type);
+        } H5E_END_TRY;
 
-        if (H5Awrite(attr, H5T_NATIVE_INT, &nlinks)<0) {
-            db_perror("nlinks attribute", E_CALLFAIL, me);
-            UNWIND();
-        }
-        H5Aclose(attr);
+        free(buf);
+    }
 
-        /* Create a name */
-        sprintf(name, "#%06d", nlinks);
-        
-    } CLEANUP {
+    if (ac->scratch >= 0)
+    {
         H5E_BEGIN_TRY {
-            H5Aclose(attr);
+            H5Fclose(ac->scratch);
         } H5E_END_TRY;
-    } END_PROTECT;
-
-    return 0;
+    }
+    FREE(ac->ents);
+    FREE(dbfile->autocomp);
 }
+#else
+PRIVATE void db_hdf5_autocomp_select(DBfile_hdf5 *dbfile, char const *name, int dtype,
+    int rank, int const dims[], void const *buf) {}
+PRIVATE void db_hdf5_autocomp_done(void) {}
+PRIVATE void db_hdf5_autocomp_finish(DBfile_hdf5 *dbfile) {}
+#endif
 
 /*-------------------------------------------------------------------------
  * Function:    db_hdf5_compwrz
@@ -4388,10 +6661,23 @@ db_hdf5_compwrz(DBfile_hdf5 *dbfile, int dtype, int rank, int const _size[],
                int compressionFlags)
 {
     static char *me = "db_hdf5_compwr";
+    char const *key = fname;
     hid_t       dset=-1, mtype=-1, ftype=-1, space=-1;
     int         i, nels;
     hsize_t     size[8];
     int         alloc = 0;
+    int         dedup = 0;
+    db_hdf5_dedup_ent_t ent;
+    void       *trimmed = 0;
+
+    /* A float storage hint only applies during the Put call that gave it */
+    if (dbfile->float_storage_call != db_stats_call_id())
+        dbfile->float_storage_hint = 0;
+
+    /* The friendly name is the METHOD=AUTO key even when it is not used
+       to name the dataset */
+    if (DBGetFriendlyHDF5NamesFile((DBfile*)dbfile) == FALSE)
+        fname = 0;
 
     if (rank < 0)
     {
@@ -4402,10 +6688,24 @@ db_hdf5_compwrz(DBfile_hdf5 *dbfile, int dtype, int rank, int const _size[],
     /* Not an error if there is no data */
     for (i=0, nels=1; i<rank; i++) nels *= _size[i];
     if ((!buf || !nels) && !alloc) {
+        db_hdf5_autocomp_done();
         *name = '\0';
         return 0;
     }
 
+    /* Link to identical data already written, if any */
+    if (!alloc)
+    {
+        dedup = db_hdf5_dedup_try(dbfile, dtype, rank, _size, nels, buf,
+                    name, fname, compressionFlags, &ent);
+        if (dedup < 0 || dedup == 2)
+            db_hdf5_autocomp_done();
+        if (dedup < 0)
+            return -1;
+        if (dedup == 2)
+            return 0;
+    }
+
     PROTECT {
         /* Obtain a unique name for the dataset or use the name supplied */
         if (!*name) {
@@ -4423,6 +6723,18 @@ db_hdf5_compwrz(DBfile_hdf5 *dbfile, int dtype, int rank, int const _size[],
             UNWIND();
         }
 
+        /* Store floating point data in reduced precision if requested */
+        switch (db_hdf5_float_storage(dbfile, dtype))
+        {
+            case DB_FLOAT_STORAGE_HALF:     ftype = T_half; break;
+            case DB_FLOAT_STORAGE_BFLOAT16: ftype = T_bfloat16; break;
+        }
+        if (ftype == T_half && buf && db_hdf5_half_overflow(dtype, buf, (size_t) nels))
+        {
+            db_perror(name, E_COMPRESSION, me);
+            UNWIND();
+        }
+
         /* Create the dataset and write data */
         assert(rank>0 && (size_t)rank<=NELMTS(size));
         for (i=0; i<rank; i++) size[i] = _size[i];
@@ -4431,11 +6743,12 @@ db_hdf5_compwrz(DBfile_hdf5 *dbfile, int dtype, int rank, int const _size[],
             UNWIND();
         }
  
+        db_hdf5_autocomp_select(dbfile, key, dtype, rank, _size, buf);
         if (db_hdf5_set_properties((DBfile*) dbfile, rank, size) < 0 ) {
             db_perror("db_hdf5_set_properties", E_CALLFAIL, me);
             UNWIND();
         }
-        if (DBGetCompressionFile((DBfile*)dbfile) && compressionFlags)
+        if (db_hdf5_compression((DBfile*)dbfile) && compressionFlags)
         {
             if (db_hdf5_set_compression((DBfile*)dbfile, compressionFlags)<0)
             {
@@ -4452,6 +6765,7 @@ db_hdf5_compwrz(DBfile_hdf5 *dbfile, int dtype, int rank, int const _size[],
                     db_perror(name, E_CALLFAIL, me);
                     UNWIND();
                 }
+                db_stats_dataset();
                 strcpy(name, fname);
             }
             else
@@ -4460,6 +6774,7 @@ db_hdf5_compwrz(DBfile_hdf5 *dbfile, int dtype, int rank, int const _size[],
                     db_perror(name, E_CALLFAIL, me);
                     UNWIND();
                 }
+                db_stats_dataset();
             }
         }
         else
@@ -4468,14 +6783,32 @@ db_hdf5_compwrz(DBfile_hdf5 *dbfile, int dtype, int rank, int const _size[],
                 db_perror(name, E_CALLFAIL, me);
                 UNWIND();
             }
+            db_stats_dataset();
             if (fname && DBGetFriendlyHDF5NamesFile((DBfile*)dbfile) == 1)
                 H5Glink(dbfile->cwg, H5G_LINK_SOFT, name, fname);
         }
 
-        if (buf && H5Dwrite(dset, mtype, space, space, H5P_DEFAULT, buf)<0) {
+        /* Trim the precision of data to be compressed, if requested */
+        if (P_crprops == P_ckcrprops)
+            trimmed = db_hdf5_groom(db_hdf5_compression((DBfile*)dbfile),
+                          mtype, buf, (size_t) nels);
+        db_hdf5_autocomp_done();
+
+        if (buf && H5Dwrite(dset, mtype, space, space, H5P_DEFAULT,
+                            trimmed ? trimmed : buf)<0) {
             hdf5_to_silo_error(name, "db_hdf5_compwrz");
             UNWIND();
         }
+        if (buf) db_hdf5_stats(dset, mtype, space, 1);
+        FREE(trimmed);
+
+        /* Record this dataset as the home of its data */
+        if (dedup && H5Iget_name(dset, ent.path, sizeof(ent.path)) > 0 &&
+            strlen(ent.path) < sizeof(ent.path)-1)
+        {
+            db_hdf5_dedup_insert(dbfile->dedup, &ent);
+            dbfile->dedup->dirty = 1;
+        }
 
         /* Release resources */
         H5Dclose(dset);
@@ -4500,6 +6833,8 @@ db_hdf5_compwrz(DBfile_hdf5 *dbfile, int dtype, int rank, int const _size[],
         }
 
     } CLEANUP {
+        db_hdf5_autocomp_done();
+        FREE(trimmed);
         H5E_BEGIN_TRY {
             H5Dclose(dset);
             H5Sclose(space);
@@ -4609,18 +6944,27 @@ db_hdf5_comprd(DBfile_hdf5 *dbfile, char *name, int ignore_force_single)
     hid_t       d=-1, fspace=-1, ftype=-1, mtype=-1;
     int         i, nelmts;
     void       *retval = NULL;
+    db_hdf5_staged_t const *staged = NULL;
     
     PROTECT {
         if (name && *name) {
-            if ((d=H5Dopen(dbfile->cwg, name, H5P_DEFAULT))<0) {
-                db_perror(name, E_NOTFOUND, me);
-                UNWIND();
-            }
-            if ((fspace=H5Dget_space(d))<0 || (ftype=H5Dget_type(d))<0) {
-                db_perror(name, E_CALLFAIL, me);
-                UNWIND();
+            if ((staged=db_hdf5_stage_find(dbfile, name)) != NULL) {
+                if ((ftype=H5Tcopy(staged->ftype))<0) {
+                    db_perror(name, E_CALLFAIL, me);
+                    UNWIND();
+                }
+                nelmts = staged->nelmts;
+            } else {
+                if ((d=H5Dopen(dbfile->cwg, name, H5P_DEFAULT))<0) {
+                    db_perror(name, E_NOTFOUND, me);
+                    UNWIND();
+                }
+                if ((fspace=H5Dget_space(d))<0 || (ftype=H5Dget_type(d))<0) {
+                    db_perror(name, E_CALLFAIL, me);
+                    UNWIND();
+                }
+                nelmts = H5Sget_simple_extent_npoints(fspace);
             }
-            nelmts = H5Sget_simple_extent_npoints(fspace);
 
             /* Choose a memory type based on the file type */
             mtype = hdf2hdf_type(ftype);
@@ -4633,24 +6977,41 @@ db_hdf5_comprd(DBfile_hdf5 *dbfile, char *name, int ignore_force_single)
                 mtype = H5T_NATIVE_FLOAT;
 
             /* Read the data */
-            if (NULL==(buf=malloc(nelmts*H5Tget_size(mtype)))) {
-                db_perror(name, E_NOMEM, me);
-                UNWIND();
-            }
+            if (staged) {
+                /* Data staged by db_hdf5_StageObjects just needs conversion */
+                size_t bufsize = H5Tget_size(mtype) > H5Tget_size(ftype) ?
+                                 H5Tget_size(mtype) : H5Tget_size(ftype);
+                if (NULL==(buf=db_malloc(nelmts*bufsize))) {
+                    db_perror(name, E_NOMEM, me);
+                    UNWIND();
+                }
+                memcpy(buf, staged->data, staged->nbytes);
+                if (H5Tconvert(ftype, mtype, (size_t) nelmts, buf, NULL, H5P_DEFAULT)<0) {
+                    hdf5_to_silo_error(name, me);
+                    UNWIND();
+                }
+            } else {
+                if (NULL==(buf=db_malloc(nelmts*H5Tget_size(mtype)))) {
+                    db_perror(name, E_NOMEM, me);
+                    UNWIND();
+                }
 
-            P_rdprops = H5P_DEFAULT;
-            if (!DBGetEnableChecksumsFile((DBfile*)dbfile))
-                P_rdprops = P_ckrdprops;
+                P_rdprops = H5P_DEFAULT;
+                if (!DBGetEnableChecksumsFile((DBfile*)dbfile))
+                    P_rdprops = P_ckrdprops;
 
-            if (H5Dread(d, mtype, H5S_ALL, H5S_ALL, P_rdprops, buf)<0) {
-                hdf5_to_silo_error(name, me);
-                UNWIND();
+                if (H5Dread(d, mtype, H5S_ALL, H5S_ALL, P_rdprops, buf)<0) {
+                    hdf5_to_silo_error(name, me);
+                    UNWIND();
+                }
+                db_hdf5_stats(d, mtype, H5S_ALL, 0);
+
+                H5Dclose(d);
+                H5Sclose(fspace);
             }
 
             /* Free resources */
-            H5Dclose(d);
             H5Tclose(ftype);
-            H5Sclose(fspace);
 
             /* Setup return value */
             retval = buf;
@@ -4667,7 +7028,7 @@ db_hdf5_comprd(DBfile_hdf5 *dbfile, char *name, int ignore_force_single)
                 float *newbuf;
 
                 /* allocate a new buffer */
-                if (NULL==(newbuf=(float*)malloc(nelmts*sizeof(float)))) {
+                if (NULL==(newbuf=(float*)db_malloc(nelmts*sizeof(float)))) {
                     db_perror(name, E_NOMEM, me);
                     UNWIND();
                 }
@@ -4705,7 +7066,7 @@ db_hdf5_comprd(DBfile_hdf5 *dbfile, char *name, int ignore_force_single)
                 }
 
                 /* Free old buffer and setup return value */
-                free(buf);
+                db_free(buf);
                 retval = newbuf;
             }
         }
@@ -6088,6 +8449,9 @@ db_hdf5_Close(DBfile *_dbfile)
         PROTECT {
 
             FreeNodelists(dbfile, 0);
+            db_hdf5_dedup_finish(dbfile);
+            db_hdf5_autocomp_finish(dbfile);
+            db_hdf5_stage_free(dbfile);
 
             /* Free the private parts of the file */
             if (db_hdf5_initiate_close((DBfile*)dbfile)<0 ||
@@ -8064,6 +10428,7 @@ db_hdf5_GetVar(DBfile *_dbfile, char const *name)
                     hdf5_to_silo_error(name, me);
                     UNWIND();
                 }
+                db_hdf5_stats(dset, mtype, H5S_ALL, 0);
             }
 
             /* Close everything */
@@ -8142,6 +10507,7 @@ db_hdf5_ReadVar(DBfile *_dbfile, char const *vname, void *result)
                hdf5_to_silo_error(vname, me);
                UNWIND();
            }
+           db_hdf5_stats(dset, mtype, H5S_ALL, 0);
 
            /* Close everything */
            H5Dclose(dset);
@@ -8232,6 +10598,7 @@ db_hdf5_ReadVarSlice(DBfile *_dbfile, char const *vname, int const *offset, int
            hdf5_to_silo_error(vname, me);
            UNWIND();
        }
+       db_hdf5_stats(dset, mtype, mspace, 0);
    
        /* Close everything */
        H5Dclose(dset);
@@ -8353,6 +10720,7 @@ db_hdf5_ReadVarVals(DBfile *_dbfile, char const *vname, int mode,
                hdf5_to_silo_error(vname, me);
                UNWIND();
            }
+           db_hdf5_stats(dset, mtype, mspace, 0);
 
            H5Dclose(dset);
            p += H5Tget_size(mtype);
@@ -8464,6 +10832,7 @@ db_hdf5_WriteCKZ(DBfile *_dbfile, char const *vname, void const *var,
 
            if (nofilters == 0)
            {
+               db_hdf5_autocomp_select(dbfile, vname, datatype, ndims, dims, var);
                if (db_hdf5_set_properties(_dbfile, ndims, ds_size) < 0 ) {
                    db_perror("db_hdf5_set_properties", E_CALLFAIL, me);
                    UNWIND();
@@ -8474,6 +10843,8 @@ db_hdf5_WriteCKZ(DBfile *_dbfile, char const *vname, void const *var,
                    db_perror(vname, E_CALLFAIL, me);
                    UNWIND();
                }
+               db_hdf5_autocomp_done();
+               db_stats_dataset();
            }
            else
            {
@@ -8482,6 +10853,7 @@ db_hdf5_WriteCKZ(DBfile *_dbfile, char const *vname, void const *var,
                    db_perror(vname, E_CALLFAIL, me);
                    UNWIND();
                }
+               db_stats_dataset();
            }
        }
        
@@ -8511,11 +10883,13 @@ db_hdf5_WriteCKZ(DBfile *_dbfile, char const *vname, void const *var,
            db_perror(vname, E_CALLFAIL, me);
            UNWIND();
        }
+       db_hdf5_stats(dset, mtype, space, 1);
 
        /* Close everything */
        H5Dclose(dset);
        H5Sclose(space);
    } CLEANUP {
+       db_hdf5_autocomp_done();
        H5E_BEGIN_TRY {
            H5Dclose(dset);
            H5Sclose(space);
@@ -8564,6 +10938,7 @@ db_hdf5_WriteSlice(
    static char  *me = "db_hdf5_WriteSlice" ;
    hid_t        mtype=-1, ftype=-1, fspace=-1, mspace=-1, dset=-1;
    hsize_t      ds_size[H5S_MAX_RANK];
+   int          count[H5S_MAX_RANK];
    int          i;
 
    PROTECT {
@@ -8602,6 +10977,10 @@ db_hdf5_WriteSlice(
                UNWIND();
            }
 
+           /* Only the first slice is on hand to choose a method with */
+           for (i=0; i<ndims; i++)
+               count[i] = stride[i] ? (length[i]+stride[i]-1)/stride[i] : 1;
+           db_hdf5_autocomp_select(dbfile, vname, dtype, ndims, count, values);
            if (db_hdf5_set_properties(_dbfile, ndims, ds_size) < 0 ) {
                db_perror("db_hdf5_set_properties", E_CALLFAIL, me);
                UNWIND();
@@ -8612,6 +10991,8 @@ db_hdf5_WriteSlice(
                db_perror(vname, E_CALLFAIL, me);
                UNWIND();
            }
+           db_hdf5_autocomp_done();
+           db_stats_dataset();
            H5Sclose(fspace);
        }
 
@@ -8652,12 +11033,14 @@ db_hdf5_WriteSlice(
            db_perror(vname, E_CALLFAIL, me);
            UNWIND();
        }
+       db_hdf5_stats(dset, mtype, mspace, 1);
 
        /* Close everything */
        H5Dclose(dset);
        H5Sclose(fspace);
        H5Sclose(mspace);
    } CLEANUP {
+       db_hdf5_autocomp_done();
        H5E_BEGIN_TRY {
            H5Dclose(dset);
            H5Sclose(fspace);
@@ -8911,6 +11294,7 @@ db_hdf5_PutCurve(DBfile *_dbfile, char const *name, void const *xvals, void cons
 
     memset(&m, 0, sizeof m);
     PROTECT {
+        db_hdf5_float_storage_hint(dbfile, opts);
         /* Check datatype */
         if (DB_FLOAT!=dtype && DB_DOUBLE!=dtype) {
             db_perror("invalid floating-point datatype", E_BADARGS, me);
@@ -9380,6 +11764,7 @@ db_hdf5_PutCsgvar(DBfile *_dbfile, char const *vname, char const *meshname,
     memset(&m, 0, sizeof m);
 
     PROTECT {
+        db_hdf5_float_storage_hint(dbfile, optlist);
         db_ResetGlobalData_Csgmesh();
         db_ProcessOptlist(DB_CSGMESH, optlist);
 
@@ -10057,6 +12442,7 @@ db_hdf5_PutQuadmesh(DBfile *_dbfile, char const *name, char const * const *coord
     }
     
     PROTECT {
+        db_hdf5_float_storage_hint(dbfile, optlist);
         /* Check datatype */
         if (DB_FLOAT!=datatype && DB_DOUBLE!=datatype) {
             db_perror("invalid floating-point datatype", E_BADARGS, me);
@@ -10502,6 +12888,7 @@ db_hdf5_PutQuadvar(DBfile *_dbfile, char const *name, char const *meshname, int
     memset(&m, 0, sizeof m);
 
     PROTECT {
+        db_hdf5_float_storage_hint(dbfile, optlist);
         /* Set global options */
         _qm._coord_sys = DB_OTHER;
         _qm._facetype = DB_RECTILINEAR;
@@ -10587,6 +12974,23 @@ db_hdf5_PutQuadvar(DBfile *_dbfile, char const *name, char const *meshname, int
         strcpy(m.meshid, OPT(meshname));
         db_SetMissingValueForPut(m.missing_value, _qm._missing_value);
 
+        /* Record range of non-ghost values unless some may be missing */
+        if (!is_empty && _qm._missing_value == DB_MISSING_VALUE_NOT_SET) {
+            double range[2];
+            int r;
+            if ((ndims > 1 && centering == DB_EDGECENT) ||
+                (ndims > 2 && centering == DB_FACECENT))
+                r = _DBVarRange(nvars, vars, datatype, 1, &nels, 0, 0, range);
+            else
+                r = _DBVarRange(nvars, vars, datatype, ndims, dims,
+                        _qm._minindex, _qm._maxindex_n, range);
+            if (r == 0) {
+                m.has_range = 1;
+                m.min_value = range[0];
+                m.max_value = range[1];
+            }
+        }
+
         for (i=0; i<ndims; i++) {
             m.dims[i] = _qm._dims[i];
             m.zones[i] = _qm._zones[i];
@@ -10637,6 +13041,9 @@ db_hdf5_PutQuadvar(DBfile *_dbfile, char const *name, char const *meshname, int
             if (m.extensive)    MEMBER_S(int, extensive);
             if (m.centering)    MEMBER_S(int, centering);
             if (m.missing_value)MEMBER_S(double, missing_value);
+            if (m.has_range)    MEMBER_S(int, has_range);
+            if (m.has_range)    MEMBER_S(double, min_value);
+            if (m.has_range)    MEMBER_S(double, max_value);
             MEMBER_3(int, dims);
             MEMBER_3(int, zones);
             MEMBER_3(int, min_index);
@@ -10772,6 +13179,9 @@ db_hdf5_GetQuadvar(DBfile *_dbfile, char const *name)
         qv->extensive = m.extensive;
         qv->centering = db_fix_obsolete_centering(m.ndims, m.align, m.centering);
         db_SetMissingValueForGet(qv->missing_value, m.missing_value);
+        qv->has_range = m.has_range;
+        qv->min_value = m.min_value;
+        qv->max_value = m.max_value;
         for (stride=1, i=0; i<m.ndims; stride*=m.dims[i++]) {
             qv->dims[i] = m.dims[i];
             qv->stride[i] = stride;
@@ -10907,6 +13317,7 @@ db_hdf5_PutUcdmesh(DBfile *_dbfile, char const *name, int ndims, char const * co
     memset(&m, 0, sizeof m);
 
     PROTECT {
+        db_hdf5_float_storage_hint(dbfile, optlist);
         /* Check datatype */
         if (DB_FLOAT!=datatype && DB_DOUBLE!=datatype) {
             db_perror("invalid floating-point datatype", E_BADARGS, me);
@@ -11487,6 +13898,7 @@ db_hdf5_PutUcdvar(DBfile *_dbfile, char const *name, char const *meshname, int n
     memset(&m, 0, sizeof m);
 
     PROTECT {
+        db_hdf5_float_storage_hint(dbfile, optlist);
         /* Set global options  - based on previous PutUcdmesh() call */
         saved_ndims = _um._ndims;
         saved_nnodes = _um._nnodes;
@@ -11561,6 +13973,21 @@ db_hdf5_PutUcdvar(DBfile *_dbfile, char const *name, char const *meshname, int n
         strcpy(m.label, OPT(_um._label));
         strcpy(m.units, OPT(_um._unit));
 
+        /* Record range of non-ghost values unless some may be missing */
+        if (nels > 0 && _um._missing_value == DB_MISSING_VALUE_NOT_SET) {
+            double range[2];
+            int lo = 0, hi = nels-1;
+            if (centering == DB_ZONECENT) {
+                if (_um._lo_offset_set) lo = _um._lo_offset;
+                if (_um._hi_offset_set) hi = _um._hi_offset;
+            }
+            if (_DBVarRange(nvars, vars, datatype, 1, &nels, &lo, &hi, range) == 0) {
+                m.has_range = 1;
+                m.min_value = range[0];
+                m.max_value = range[1];
+            }
+        }
+
         /* Write header to file */
         STRUCT(DBucdvar) {
             MEMBER_R(str(m.value[_j]), value, nvars);
@@ -11584,6 +14011,9 @@ db_hdf5_PutUcdvar(DBfile *_dbfile, char const *name, char const *meshname, int n
             if (m.conserved)    MEMBER_S(int, conserved);
             if (m.extensive)    MEMBER_S(int, extensive);
             if (m.missing_value)MEMBER_S(double, missing_value);
+            if (m.has_range)    MEMBER_S(int, has_range);
+            if (m.has_range)    MEMBER_S(double, min_value);
+            if (m.has_range)    MEMBER_S(double, max_value);
             MEMBER_S(str(m.label), label);
             MEMBER_S(str(m.units), units);
             MEMBER_S(str(m.region_pnames), region_pnames);
@@ -11751,6 +14181,9 @@ db_hdf5_GetUcdvar(DBfile *_dbfile, char const *name)
         uv->conserved = m.conserved;
         uv->extensive = m.extensive;
         db_SetMissingValueForGet(uv->missing_value, m.missing_value);
+        uv->has_range = m.has_range;
+        uv->min_value = m.min_value;
+        uv->max_value = m.max_value;
 
         /* If var is compressed, we need to do some work to decompress it */
         PrepareForUcdvarDecompression(_dbfile, name, uv->meshname?uv->meshname:"", m.value, m.nvals);
@@ -13150,6 +15583,7 @@ db_hdf5_PutMultimesh(DBfile *_dbfile, char const *name, int nmesh,
     int                 i, len;
     char                *s=NULL;
     char                *t=NULL;
+    double              *bvh=NULL;
     
     memset(&m, 0, sizeof m);
     PROTECT {
@@ -13189,6 +15623,14 @@ db_hdf5_PutMultimesh(DBfile *_dbfile, char const *name, int nmesh,
             sizes[1] = _mm._extentssize;
             db_hdf5_compwr(dbfile, DB_DOUBLE, 2, sizes, _mm._extents,
                 m.extents/*out*/, friendly_name(_dbfile,name,"_extents",0));
+
+            /* Spatial index of the blocks for DBQueryMultimeshBlocks */
+            bvh = db_MakeBlockBVH(nmesh, _mm._extentssize, _mm._extents,
+                      meshnames, _mm._empty_list, _mm._empty_cnt, &len);
+            if (bvh)
+                db_hdf5_compwr(dbfile, DB_DOUBLE, 1, &len, bvh,
+                    m.bvh/*out*/, friendly_name(_dbfile,name,"_bvh",0));
+            FREE(bvh);
         }
         if (_mm._zonecounts) {
             db_hdf5_compwr(dbfile, DB_INT, 1, &nmesh, _mm._zonecounts,
@@ -13292,6 +15734,7 @@ db_hdf5_PutMultimesh(DBfile *_dbfile, char const *name, int nmesh,
             if (m.repr_block_idx)   MEMBER_S(int, repr_block_idx);
             MEMBER_S(str(m.alt_nodenum_vars), alt_nodenum_vars);
             MEMBER_S(str(m.alt_zonenum_vars), alt_zonenum_vars);
+            MEMBER_S(str(m.bvh), bvh);
         } OUTPUT(dbfile, DB_MULTIMESH, name, &m);
 
         /* Free resources */
@@ -13299,6 +15742,7 @@ db_hdf5_PutMultimesh(DBfile *_dbfile, char const *name, int nmesh,
         
     } CLEANUP {
         FREE(s);
+        FREE(bvh);
     } END_PROTECT;
     return 0;
 }
@@ -13694,6 +16138,7 @@ db_hdf5_PutMultimeshadj(DBfile *_dbfile, char const *name, int nmesh,
                    db_perror("partial write", E_CALLFAIL, me);
                    UNWIND();
                }
+               db_hdf5_stats(nldset, mtype, mspace, 1);
 
                /* Close everything */
                H5Sclose(fspace);
@@ -13728,6 +16173,7 @@ db_hdf5_PutMultimeshadj(DBfile *_dbfile, char const *name, int nmesh,
                    db_perror("partial write", E_CALLFAIL, me);
                    UNWIND();
                }
+               db_hdf5_stats(zldset, mtype, mspace, 1);
 
                /* Close everything */
                H5Sclose(fspace);
@@ -13924,6 +16370,7 @@ db_hdf5_GetMultimeshadj(DBfile *_dbfile, char const *name, int nmesh,
                      hdf5_to_silo_error(name, me);
                      UNWIND();
                  }
+                 db_hdf5_stats(nldset, mtype, mspace, 0);
 
                  /* Close everything */
                  H5Sclose(fspace);
@@ -13972,6 +16419,7 @@ db_hdf5_GetMultimeshadj(DBfile *_dbfile, char const *name, int nmesh,
                      hdf5_to_silo_error(name, me);
                      UNWIND();
                  }
+                 db_hdf5_stats(zldset, mtype, mspace, 0);
 
                  /* Close everything */
                  H5Sclose(fspace);
@@ -14053,6 +16501,7 @@ db_hdf5_PutMultivar(DBfile *_dbfile, char const *name, int nvars, char const * c
     DBmultivar_mt       m;
     int                 i, len;
     char                *s=NULL;
+    double              *bvh=NULL;
 
     memset(&m, 0, sizeof m);
     PROTECT {
@@ -14095,6 +16544,14 @@ db_hdf5_PutMultivar(DBfile *_dbfile, char const *name, int nvars, char const * c
             sizes[1] = _mm._extentssize;
             db_hdf5_compwr(dbfile, DB_DOUBLE, 2, sizes, _mm._extents,
                 m.extents/*out*/, friendly_name(_dbfile,name, "_extents", 0));
+
+            /* Value range index of the blocks for DBQueryMultivarBlocks */
+            bvh = db_MakeBlockRangeBVH(nvars, _mm._extentssize, _mm._extents,
+                      varnames, _mm._empty_list, _mm._empty_cnt, &len);
+            if (bvh)
+                db_hdf5_compwr(dbfile, DB_DOUBLE, 1, &len, bvh,
+                    m.bvh/*out*/, friendly_name(_dbfile,name,"_bvh",0));
+            FREE(bvh);
         }
 
         /* output mrgtree info if we have it */
@@ -14169,6 +16626,7 @@ db_hdf5_PutMultivar(DBfile *_dbfile, char const *name, int nvars, char const * c
             MEMBER_S(str(m.empty_list), empty_list);
             if (m.empty_cnt)   MEMBER_S(int, empty_cnt);
             if (m.repr_block_idx)   MEMBER_S(int, repr_block_idx);
+            MEMBER_S(str(m.bvh), bvh);
         } OUTPUT(dbfile, DB_MULTIVAR, name, &m);
 
         /* Free resources */
@@ -14176,6 +16634,7 @@ db_hdf5_PutMultivar(DBfile *_dbfile, char const *name, int nvars, char const * c
         
     } CLEANUP {
         FREE(s);
+        FREE(bvh);
     } END_PROTECT;
     return 0;
 }
@@ -14946,9 +17405,15 @@ db_hdf5_PutPointmesh(DBfile *_dbfile, char const *name, int ndims, DBVCP2_t _coo
     DBpointmesh_mt      m;
     int                 i;
     void const * const *coords = (void const * const *) _coords;
+    void                *sorted[3] = {0, 0, 0};
+    int                 *perm = NULL, idxlen = 0;
+    double              *chunkidx = NULL;
+    void                *gnodeno = NULL;
+    char                *ghost_labels = NULL;
     
     memset(&m, 0, sizeof m);
     PROTECT {
+        db_hdf5_float_storage_hint(dbfile, optlist);
         /* Check datatype */
         if (DB_FLOAT!=datatype && DB_DOUBLE!=datatype) {
             db_perror("invalid floating-point datatype", E_BADARGS, me);
@@ -14968,6 +17433,26 @@ db_hdf5_PutPointmesh(DBfile *_dbfile, char const *name, int ndims, DBVCP2_t _coo
         db_hdf5_handle_ctdt(dbfile, _pm._time_set, _pm._time,
             _pm._dtime_set, _pm._dtime, _pm._cycle);
 
+        /* Optionally order the non-ghost points along a space filling
+           curve. Per-point option arrays are reordered to match. */
+        if (nels>0 && _pm._spatial_sort == DB_SORT_MORTON &&
+            db_SortPointmesh(ndims, _coords, nels, _pm._lo_offset, _pm._hi_offset,
+                datatype, _pm._sort_chunk_size, sorted, &perm, &chunkidx,
+                &idxlen) == 0)
+        {
+            coords = (void const * const *) sorted;
+            if (_pm._gnodeno)
+                _pm._gnodeno = gnodeno = db_PermuteArray(_pm._gnodeno, nels,
+                    _pm._llong_gnodeno ? sizeof(long long) : sizeof(int), perm);
+            if (_pm._ghost_node_labels)
+                _pm._ghost_node_labels = ghost_labels = (char *)
+                    db_PermuteArray(_pm._ghost_node_labels, nels, 1, perm);
+            db_hdf5_compwr(dbfile, DB_INT, 1, &nels, perm,
+                m.perm/*out*/, friendly_name(_dbfile,name, "_perm", 0));
+            db_hdf5_compwr(dbfile, DB_DOUBLE, 1, &idxlen, chunkidx,
+                m.chunkidx/*out*/, friendly_name(_dbfile,name, "_chunkidx", 0));
+        }
+
         /* Write raw data arrays */
         for (i=0; i<ndims && nels>0; i++) {
             db_hdf5_compwr(dbfile, datatype, 1, &nels, coords[i],
@@ -15059,11 +17544,24 @@ db_hdf5_PutPointmesh(DBfile *_dbfile, char const *name, int ndims, DBVCP2_t _coo
             if (m.gnznodtype    )MEMBER_S(int, gnznodtype);
             MEMBER_S(str(m.ghost_node_labels), ghost_node_labels);
             MEMBER_S(str(m.alt_nodenum_vars), alt_nodenum_vars);
+            MEMBER_S(str(m.perm), perm);
+            MEMBER_S(str(m.chunkidx), chunkidx);
         } OUTPUT(dbfile, DB_POINTMESH, name, &m);
 
     } CLEANUP {
-        /*void*/
+        for (i=0; i<3; i++)
+            FREE(sorted[i]);
+        FREE(perm);
+        FREE(chunkidx);
+        FREE(gnodeno);
+        FREE(ghost_labels);
     } END_PROTECT;
+    for (i=0; i<3; i++)
+        FREE(sorted[i]);
+    FREE(perm);
+    FREE(chunkidx);
+    FREE(gnodeno);
+    FREE(ghost_labels);
     return 0;
 }
 
@@ -15232,6 +17730,7 @@ db_hdf5_PutPointvar(DBfile *_dbfile, char const *name, char const *meshname, int
 
     memset(&m, 0, sizeof m);
     PROTECT {
+        db_hdf5_float_storage_hint(dbfile, optlist);
         /* Set global options */
         saved_ndims = _pm._ndims;
         memset(&_pm, 0, sizeof _pm);
@@ -16730,6 +19229,338 @@ db_hdf5_SortObjectsByOffset(DBfile *_dbfile, int nobjs,
     return 0;
 }
 
+/*-------------------------------------------------------------------------
+ * Batch reading of objects.
+ *
+ * db_hdf5_StageObjects gathers the raw datasets of a list of objects,
+ * sorts them by their offsets in the file and reads them with as few
+ * large reads as possible, merging the byte ranges of datasets which
+ * are closer than a gap tolerance. db_hdf5_comprd then takes the data
+ * of staged datasets from memory, converting it to the memory type,
+ * instead of reading it from the file. Only datasets with contiguous
+ * (unfiltered) storage in files opened with the sec2 driver can be
+ * staged, and only those reached through a hard link which are stored
+ * in the file itself. Others (e.g. those deduplicated into a previous
+ * file via external links) are read by db_hdf5_comprd as usual.
+ * Datasets are staged by their absolute names.
+ *-------------------------------------------------------------------------
+ */
+#define STAGE_DEFAULT_GAP       (64*1024)
+
+static int
+db_hdf5_stage_cmp_name(void const *a, void const *b)
+{
+    return strcmp(((db_hdf5_staged_t const *)a)->name,
+                  ((db_hdf5_staged_t const *)b)->name);
+}
+
+static int
+db_hdf5_stage_cmp_addr(void const *a, void const *b)
+{
+    haddr_t a1 = ((db_hdf5_staged_t const *)a)->addr;
+    haddr_t a2 = ((db_hdf5_staged_t const *)b)->addr;
+    return a1 < a2 ? -1 : (a1 > a2 ? 1 : 0);
+}
+
+PRIVATE void
+db_hdf5_stage_free(DBfile_hdf5 *dbfile)
+{
+    db_hdf5_stage_t *stage = dbfile->stage;
+    int i;
+
+    if (!stage) return;
+    for (i = 0; i < stage->n; i++)
+    {
+        free(stage->ds[i].name);
+        H5Tclose(stage->ds[i].ftype);
+    }
+    for (i = 0; i < stage->nbufs; i++)
+        free(stage->bufs[i]);
+    FREE(stage->ds);
+    FREE(stage->bufs);
+    free(stage);
+    dbfile->stage = 0;
+}
+
+PRIVATE db_hdf5_staged_t const *
+db_hdf5_stage_find(DBfile_hdf5 *dbfile, char const *name)
+{
+    db_hdf5_staged_t key;
+    db_hdf5_staged_t const *found;
+    char cwgname[4096];
+    char *full = 0;
+
+    if (!dbfile->stage || !dbfile->stage->nbufs)
+        return 0;
+
+    /* A relative name is opened from the current working group */
+    if (name[0] != '/' && db_hdf5_GetDir((DBfile*)dbfile, cwgname)>=0)
+        full = db_join_path(cwgname, name);
+    key.name = full ? full : (char *) name;
+    found = (db_hdf5_staged_t const *) bsearch(&key, dbfile->stage->ds,
+        dbfile->stage->n, sizeof(db_hdf5_staged_t), db_hdf5_stage_cmp_name);
+    if (full) free(full);
+    return found;
+}
+
+/* Add the named dataset to the stage if its storage permits. */
+static void
+db_hdf5_stage_dataset(DBfile_hdf5 *dbfile, db_hdf5_stage_t *stage,
+    char const *name, hid_t d)
+{
+    hid_t dfid = -1, dfapl = -1, dcpl = -1, fspace = -1, ftype = -1;
+    db_hdf5_staged_t ds, *tmp;
+    hssize_t npoints;
+    void *handle = 0;
+
+    H5E_BEGIN_TRY {
+        /* Only data in the file whose handle we read can be staged */
+        if ((dfid=H5Iget_file_id(d))>=0 &&
+            (dfapl=H5Fget_access_plist(dfid))>=0 &&
+            H5Fget_vfd_handle(dfid, dfapl, &handle)>=0 &&
+            handle==stage->handle &&
+            (dcpl=H5Dget_create_plist(d))>=0 &&
+            H5Pget_layout(dcpl)==H5D_CONTIGUOUS &&
+            (ds.addr=H5Dget_offset(d))!=HADDR_UNDEF &&
+            (fspace=H5Dget_space(d))>=0 &&
+            (npoints=H5Sget_simple_extent_npoints(fspace))>0 &&
+            (ftype=H5Dget_type(d))>=0 &&
+            H5Tget_class(ftype)!=H5T_VLEN && !H5Tis_variable_str(ftype) &&
+            (ds.nbytes=(size_t)H5Dget_storage_size(d))==(size_t)npoints*H5Tget_size(ftype))
+        {
+            /* Out of memory, the dataset is just not staged */
+            if (stage->n == stage->max)
+            {
+                int max = stage->max ? 2 * stage->max : 64;
+                if ((tmp=(db_hdf5_staged_t *) realloc(stage->ds,
+                        max * sizeof(db_hdf5_staged_t)))!=0)
+                {
+                    stage->ds = tmp;
+                    stage->max = max;
+                }
+            }
+            if (stage->n < stage->max && (ds.name=STRDUP(name))!=0)
+            {
+                ds.ftype = ftype;
+                ds.nelmts = (int) npoints;
+                ds.data = 0;
+                stage->ds[stage->n++] = ds;
+                ftype = -1;
+            }
+        }
+        if (ftype>=0) H5Tclose(ftype);
+        if (fspace>=0) H5Sclose(fspace);
+        if (dcpl>=0) H5Pclose(dcpl);
+        if (dfapl>=0) H5Pclose(dfapl);
+        if (dfid>=0) H5Fclose(dfid);
+    } H5E_END_TRY;
+}
+
+/* Stage the datasets referenced by string members of an object's header.
+   Members naming the zonelists and facelists which the Get call of the
+   object also reads (e.g. those of a ucdmesh) are followed too. Members
+   are resolved relative to the object's directory, as its Get call
+   resolves them. */
+static void
+db_hdf5_stage_object(DBfile_hdf5 *dbfile, db_hdf5_stage_t *stage,
+    char const *name, int follow)
+{
+    hid_t o = -1, attr = -1, atype = -1;
+    unsigned char *hdr = 0;
+    int i, nmembs, objtype = DB_INVALID_OBJECT;
+
+    H5E_BEGIN_TRY {
+        if ((o=H5Topen(dbfile->cwg, name, H5P_DEFAULT))>=0 &&
+            (attr=H5Aopen_name(o, "silo_type"))>=0)
+        {
+            H5Aread(attr, H5T_NATIVE_INT, &objtype);
+            H5Aclose(attr);
+            attr = -1;
+        }
+        if (o>=0 &&
+            (follow || objtype == DB_ZONELIST || objtype == DB_PHZONELIST ||
+             objtype == DB_FACELIST || objtype == DB_CSGZONELIST) &&
+            (attr=H5Aopen_name(o, "silo"))>=0 &&
+            (atype=H5Aget_type(attr))>=0 &&
+            H5Tget_class(atype)==H5T_COMPOUND &&
+            (hdr=(unsigned char *)calloc(1, H5Tget_size(atype)))!=0 &&
+            H5Aread(attr, atype, hdr)>=0)
+        {
+            nmembs = H5Tget_nmembers(atype);
+            for (i = 0; i < nmembs; i++)
+            {
+                hid_t mtype = H5Tget_member_type(atype, (unsigned) i);
+                size_t off = H5Tget_member_offset(atype, (unsigned) i);
+                char val[256];
+
+                if (mtype>=0 && H5Tget_class(mtype)==H5T_STRING &&
+                    !H5Tis_variable_str(mtype))
+                {
+                    size_t len = H5Tget_size(mtype);
+                    char *full = 0;
+                    H5L_info_t linfo;
+                    hid_t d;
+
+                    if (len >= sizeof(val)) len = sizeof(val)-1;
+                    memcpy(val, hdr+off, len);
+                    val[len] = '\0';
+                    if (val[0])
+                        full = STRDUP(db_hdf5_resolvename((DBfile*)dbfile, name, val));
+
+                    if (full && *full && (d=H5Dopen(dbfile->cwg, full, H5P_DEFAULT))>=0)
+                    {
+                        /* Soft and external links may lead to other files */
+                        if (H5Lget_info(dbfile->cwg, full, &linfo, H5P_DEFAULT)>=0 &&
+                            linfo.type==H5L_TYPE_HARD)
+                            db_hdf5_stage_dataset(dbfile, stage, full, d);
+                        H5Dclose(d);
+                    }
+                    else if (full && *full && follow)
+                    {
+                        db_hdf5_stage_object(dbfile, stage, full, 0);
+                    }
+                    if (full) free(full);
+                }
+                if (mtype>=0) H5Tclose(mtype);
+            }
+        }
+        if (atype>=0) H5Tclose(atype);
+        if (attr>=0) H5Aclose(attr);
+        if (o>=0) H5Tclose(o);
+    } H5E_END_TRY;
+
+    FREE(hdr);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_hdf5_StageObjects
+ *
+ * Purpose:     Read the raw data of the named objects into memory using
+ *              large reads in file offset order. Byte ranges separated
+ *              by no more than GAP bytes are merged into a single read.
+ *              Calling with NOBJS of zero releases staged data.
+ *
+ * Return:      Success:        Number of reads performed.
+ *
+ *              Failure:        -1
+ *-------------------------------------------------------------------------
+ */
+SILO_CALLBACK int
+db_hdf5_StageObjects(DBfile *_dbfile, int nobjs, char const * const *names, int gap)
+{
+    static char *me = "db_hdf5_StageObjects";
+    DBfile_hdf5 *dbfile = (DBfile_hdf5*)_dbfile;
+    db_hdf5_stage_t *stage;
+    hid_t fapl = -1;
+    unsigned intent = 0;
+    void *handle = 0;
+    int fd, i, j, ok;
+
+    db_hdf5_stage_free(dbfile);
+    if (nobjs <= 0)
+        return 0;
+    if (gap < 0)
+        gap = STAGE_DEFAULT_GAP;
+
+#ifndef HAVE_UNISTD_H
+    /* No pread() */
+    return 0;
+#else
+
+    /* We read the file directly and can do so only for the sec2 driver */
+    H5E_BEGIN_TRY {
+        ok = (fapl=H5Fget_access_plist(dbfile->fid))>=0 &&
+             H5Pget_driver(fapl)==H5FD_SEC2 &&
+             H5Fget_vfd_handle(dbfile->fid, fapl, &handle)>=0 && handle &&
+             H5Fget_intent(dbfile->fid, &intent)>=0;
+        if (fapl>=0) H5Pclose(fapl);
+    } H5E_END_TRY;
+    if (!ok)
+        return 0;
+    fd = *((int *) handle);
+
+    /* Data being written may still be in HDF5's caches */
+    if ((intent & H5F_ACC_RDWR) && H5Fflush(dbfile->fid, H5F_SCOPE_LOCAL)<0)
+        return db_perror(dbfile->pub.name, E_CALLFAIL, me);
+
+    if ((stage=(db_hdf5_stage_t *) calloc(1, sizeof(db_hdf5_stage_t)))==0)
+        return db_perror(dbfile->pub.name, E_NOMEM, me);
+    stage->handle = handle;
+    dbfile->stage = stage;
+    for (i = 0; i < nobjs; i++)
+    {
+        if (names[i] && !strchr(names[i], ':'))
+            db_hdf5_stage_object(dbfile, stage, names[i], 1);
+    }
+    if (!stage->n)
+        return 0;
+
+    /* Objects may share datasets (e.g. a zonelist) */
+    qsort(stage->ds, stage->n, sizeof(db_hdf5_staged_t), db_hdf5_stage_cmp_name);
+    for (i = 1, j = 0; i < stage->n; i++)
+    {
+        if (strcmp(stage->ds[i].name, stage->ds[j].name))
+            stage->ds[++j] = stage->ds[i];
+        else
+        {
+            free(stage->ds[i].name);
+            H5Tclose(stage->ds[i].ftype);
+        }
+    }
+    stage->n = j+1;
+
+    /* Read merged byte ranges in offset order */
+    qsort(stage->ds, stage->n, sizeof(db_hdf5_staged_t), db_hdf5_stage_cmp_addr);
+    if ((stage->bufs=(unsigned char **) malloc(stage->n * sizeof(unsigned char *)))==0)
+    {
+        db_hdf5_stage_free(dbfile);
+        return db_perror(dbfile->pub.name, E_NOMEM, me);
+    }
+    for (i = 0; i < stage->n; i = j)
+    {
+        haddr_t start = stage->ds[i].addr;
+        haddr_t end = start + stage->ds[i].nbytes;
+        unsigned char *buf;
+        size_t nread = 0;
+
+        for (j = i+1; j < stage->n && stage->ds[j].addr <= end + (haddr_t) gap; j++)
+        {
+            if (stage->ds[j].addr + stage->ds[j].nbytes > end)
+                end = stage->ds[j].addr + stage->ds[j].nbytes;
+        }
+
+        if ((buf=(unsigned char *)malloc((size_t)(end-start)))==0)
+        {
+            db_hdf5_stage_free(dbfile);
+            return db_perror(dbfile->pub.name, E_NOMEM, me);
+        }
+        while (nread < (size_t)(end-start))
+        {
+            ssize_t n = pread(fd, buf+nread, (size_t)(end-start)-nread,
+                              (off_t)(start+nread));
+            if (n <= 0)
+            {
+                if (n < 0 && errno == EINTR) continue;
+                free(buf);
+                db_hdf5_stage_free(dbfile);
+                return db_perror(dbfile->pub.name, E_SYSTEMERR, me);
+            }
+            nread += (size_t) n;
+        }
+        db_stats_read((long long) nread, (long long) nread);
+
+        stage->bufs[stage->nbufs++] = buf;
+        for (; i < j; i++)
+            stage->ds[i].data = buf + (stage->ds[i].addr - start);
+    }
+
+    /* Sort by name for lookups from db_hdf5_comprd */
+    qsort(stage->ds, stage->n, sizeof(db_hdf5_staged_t), db_hdf5_stage_cmp_name);
+
+    return stage->nbufs;
+#endif
+}
+
 #if HDF5_VERSION_GE(1,8,9)
 /* Definition of callbacks for file image operations. [ */
 
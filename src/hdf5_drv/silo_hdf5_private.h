@@ -92,6 +92,11 @@ typedef struct DBfile_hdf5 {
     hid_t       T_double;               /*target DB_DOUBLE type         */
     hid_t       T_str256;               /*target 256-char string        */
     hid_t       (*T_str)(char*);        /*target character string       */
+    struct db_hdf5_dedup_t *dedup;      /*content-hash dedup index      */
+    int const   *float_storage_hint;    /*DBOPT_FLOAT_STORAGE of Put call*/
+    unsigned long float_storage_call;   /*API call that gave the hint   */
+    struct db_hdf5_stage_t *stage;      /*data staged by DBReadObjects  */
+    struct db_hdf5_autocomp_t *autocomp; /*METHOD=AUTO choices in file  */
 } DBfile_hdf5;
 
 #ifndef SILO_NO_CALLBACKS
@@ -395,6 +400,8 @@ SILO_CALLBACK int db_hdf5_FreeCompressionResources(DBfile *_dbfile,
 
 SILO_CALLBACK int db_hdf5_SortObjectsByOffset(DBfile *_dbfile, int nobjs,
                  char const *const *const names, int *ordering);
+SILO_CALLBACK int db_hdf5_StageObjects(DBfile *_dbfile, int nobjs,
+                 char const * const *names, int gap);
 
 #endif /* !SILO_NO_CALLBACKS */
 
@@ -293,8 +293,10 @@ INTERNAL int
 PJ_write (PDBfile *file, char *name, char *type, void *var) {
 
    char          *newname = pj_fixname(file, name);
+   int            retval = lite_PD_write(file, newname, type, var);
 
-   return (lite_PD_write(file, newname, type, var));
+   if (retval) db_stats_dataset();
+   return retval;
 }
 #endif /* PDB_WRITE */
 
@@ -320,9 +322,11 @@ PJ_write_alt (PDBfile *file, char const *name, char const *type,
     void const *var, int nd, long const *ind) {
 
    char          *newname = pj_fixname(file, name);
+   int            retval = lite_PD_write_alt(file, newname, (char *) type,
+                               (void *) var, nd, (long *) ind);
 
-   return (lite_PD_write_alt(file, newname, (char *) type,
-              (void *) var, nd, (long *) ind));
+   if (retval) db_stats_dataset();
+   return retval;
 }
 #endif /* PDB_WRITE */
 
@@ -358,7 +362,10 @@ PJ_write_len (PDBfile *file, char const *name, char const *type, void const *var
       ind[i * 3 + 2] = 1;
    }
 
-   return (lite_PD_write_alt(file, newname, (char*) type, (void*) var, nd, ind));
+   if (!lite_PD_write_alt(file, newname, (char*) type, (void*) var, nd, ind))
+      return 0;
+   db_stats_dataset();
+   return 1;
 }
 #endif /* PDB_WRITE */
 /* END pjjacket.c */
@@ -2058,6 +2065,40 @@ db_pdb_flush(DBfile *_dbfile)
    return retval;
 }
 
+/*-------------------------------------------------------------------------
+ * Function:    db_pdb_stats_fread, db_pdb_stats_fwrite
+ *
+ * Purpose:     PDB lite i/o hooks that count the bytes moved through the
+ *              file toward the statistics of the API call in progress.
+ *              PDB does not compress so raw and stored bytes are equal.
+ *-------------------------------------------------------------------------*/
+#ifndef USING_PDB_PROPER
+static size_t
+db_pdb_stats_fread(lite_SC_byte *ptr, size_t size, size_t nitems, void *stream)
+{
+    size_t n = fread(ptr, size, nitems, (FILE *) stream);
+    db_stats_read((long long) (n * size), (long long) (n * size));
+    return n;
+}
+
+static size_t
+db_pdb_stats_fwrite(void *ptr, size_t size, size_t nitems, void *stream)
+{
+    size_t n = fwrite(ptr, size, nitems, (FILE *) stream);
+    db_stats_write((long long) (n * size), (long long) (n * size));
+    return n;
+}
+
+static void
+db_pdb_stats_hooks(void)
+{
+    if (lite_io_read_hook == (PFfread) fread)
+        lite_io_read_hook = db_pdb_stats_fread;
+    if (lite_io_write_hook == (PFfwrite) fwrite)
+        lite_io_write_hook = db_pdb_stats_fwrite;
+}
+#endif
+
 /*-------------------------------------------------------------------------
  * Function:    db_pdb_Open
  *
@@ -2112,6 +2153,9 @@ db_pdb_Open(char const *name, int mode, int opts_set_id)
         db_perror("not readable", E_NOFILE, me);
         return NULL;
     }
+#ifndef USING_PDB_PROPER
+    db_pdb_stats_hooks();
+#endif
     if (mode == DB_READ)
     {
         if (NULL == (pdb = lite_PD_open((char*)name, "r")))
@@ -2260,6 +2304,9 @@ db_pdb_Create (char const *name, int mode, int target, int opts_set_id, char con
 #endif
     db_pdb_InitCallbacks((DBfile *) dbfile);
 
+#ifndef USING_PDB_PROPER
+    db_pdb_stats_hooks();
+#endif
     if (NULL == (dbfile->pdb = lite_PD_open((char*)name, "w")))
     {
         FREE(dbfile->pub.name);
@@ -4020,8 +4067,10 @@ db_pdb_GetMultimesh (DBfile *_dbfile, char const *objname)
        *----------------------------------------*/
 
       if (tmpnames != NULL) {
-         if (mm->nblocks > 0)
-             db_StringListToStringArrayMBOpt(tmpnames, &(mm->meshnames), &(mm->meshnames_alloc), mm->nblocks);
+         /* On success, the names array owns tmpnames */
+         if (mm->nblocks > 0 &&
+             db_StringListToStringArrayMBOpt(tmpnames, &(mm->meshnames), &(mm->meshnames_alloc), mm->nblocks) == 0)
+             tmpnames = NULL;
          FREE(tmpnames);
       }
       if ((tmpgnames != NULL) && (mm->lgroupings > 0)) {
@@ -4298,8 +4347,10 @@ db_pdb_GetMultivar (DBfile *_dbfile, char const *objname)
        *----------------------------------------*/
 
       if (tmpnames != NULL) {
-         if (mv->nvars > 0)
-             db_StringListToStringArrayMBOpt(tmpnames, &(mv->varnames), &(mv->varnames_alloc), mv->nvars);
+         /* On success, the names array owns tmpnames */
+         if (mv->nvars > 0 &&
+             db_StringListToStringArrayMBOpt(tmpnames, &(mv->varnames), &(mv->varnames_alloc), mv->nvars) == 0)
+             tmpnames = NULL;
          FREE(tmpnames);
       }
 
@@ -4437,8 +4488,10 @@ db_pdb_GetMultimat (DBfile *_dbfile, char const *objname)
        *----------------------------------------*/
 
       if (tmpnames != NULL) {
-          if (mt->nmats > 0)
-              db_StringListToStringArrayMBOpt(tmpnames, &(mt->matnames), &(mt->matnames_alloc), mt->nmats);
+          /* On success, the names array owns tmpnames */
+          if (mt->nmats > 0 &&
+              db_StringListToStringArrayMBOpt(tmpnames, &(mt->matnames), &(mt->matnames_alloc), mt->nmats) == 0)
+              tmpnames = NULL;
           FREE(tmpnames);
       }
 
@@ -4558,8 +4611,10 @@ db_pdb_GetMultimatspecies (DBfile *_dbfile, char const *objname)
 
       if (tmpnames != NULL)
       {
-          if (mms->nspec > 0)
-              db_StringListToStringArrayMBOpt(tmpnames, &(mms->specnames), &(mms->specnames_alloc), mms->nspec);
+          /* On success, the names array owns tmpnames */
+          if (mms->nspec > 0 &&
+              db_StringListToStringArrayMBOpt(tmpnames, &(mms->specnames), &(mms->specnames_alloc), mms->nspec) == 0)
+              tmpnames = NULL;
           FREE(tmpnames);
       }
 
@@ -5121,6 +5176,9 @@ db_pdb_GetQuadvar (DBfile *_dbfile, char const *objname)
    DEFINE_OBJ("conserved", &tmpqv.conserved, DB_INT);
    DEFINE_OBJ("conserved", &tmpqv.extensive, DB_INT);
    DEFINE_OBJ("missing_value", &tmpqv.missing_value, DB_DOUBLE);
+   DEFINE_OBJ("has_range", &tmpqv.has_range, DB_INT);
+   DEFINE_OBJ("min_value", &tmpqv.min_value, DB_DOUBLE);
+   DEFINE_OBJ("max_value", &tmpqv.max_value, DB_DOUBLE);
 
    /* Arrays */
    DEFINE_OBJ("min_index", tmpqv.min_index, DB_INT);
@@ -5624,6 +5682,9 @@ db_pdb_GetUcdvar (DBfile *_dbfile, char const *objname)
    DEFINE_OBJ("conserved", &tmpuv.conserved, DB_INT);
    DEFINE_OBJ("extensive", &tmpuv.extensive, DB_INT);
    DEFINE_OBJ("missing_value", &tmpuv.missing_value, DB_DOUBLE);
+   DEFINE_OBJ("has_range", &tmpuv.has_range, DB_INT);
+   DEFINE_OBJ("min_value", &tmpuv.min_value, DB_DOUBLE);
+   DEFINE_OBJ("max_value", &tmpuv.max_value, DB_DOUBLE);
 
    if (PJ_GetObject(dbfile->pdb, objname, &tmp_obj, DB_UCDVAR) < 0)
       return NULL;
@@ -8554,6 +8615,7 @@ db_pdb_PutMultimesh (DBfile *dbfile, char const *name, int nmesh,
    DBobject      *obj;
    char          *tmp = NULL, *cur = NULL;
    char          *gtmp = NULL;
+   double        *bvh = NULL;
 
    /*-------------------------------------------------------------
     *  Initialize global data, and process options.
@@ -8563,7 +8625,7 @@ db_pdb_PutMultimesh (DBfile *dbfile, char const *name, int nmesh,
    /*-------------------------------------------------------------
     *  Build object description from literals and var-id's
     *-------------------------------------------------------------*/
-   obj = DBMakeObject(name, DB_MULTIMESH, 31);
+   obj = DBMakeObject(name, DB_MULTIMESH, 32);
    DBAddIntComponent(obj, "nblocks", nmesh);
    DBAddIntComponent(obj, "ngroups", _mm._ngroups);
    DBAddIntComponent(obj, "blockorigin", _mm._blockorigin);
@@ -8640,6 +8702,15 @@ db_pdb_PutMultimesh (DBfile *dbfile, char const *name, int nmesh,
       count[0] = _mm._extentssize * nmesh;
       DBWriteComponent(dbfile, obj, "extents", name, "double", _mm._extents,
                        1, count);
+
+      /* Spatial index of the blocks for DBQueryMultimeshBlocks */
+      bvh = db_MakeBlockBVH(nmesh, _mm._extentssize, _mm._extents,
+                meshnames, _mm._empty_list, _mm._empty_cnt, &len);
+      if (bvh) {
+         count[0] = len;
+         DBWriteComponent(dbfile, obj, "bvh", name, "double", bvh, 1, count);
+         FREE(bvh);
+      }
    }
 
    /*-------------------------------------------------------------
@@ -9047,6 +9118,7 @@ db_pdb_PutMultivar (DBfile *dbfile, char const *name, int nvars,
    long           count[3];
    char          *tmp = NULL, *cur = NULL;
    DBobject      *obj;
+   double        *bvh = NULL;
 
    /*-------------------------------------------------------------
     *  Initialize global data, and process options.
@@ -9056,7 +9128,7 @@ db_pdb_PutMultivar (DBfile *dbfile, char const *name, int nvars,
    /*-------------------------------------------------------------
     *  Build object description from literals and var-id's
     *-------------------------------------------------------------*/
-   obj = DBMakeObject(name, DB_MULTIVAR, 32);
+   obj = DBMakeObject(name, DB_MULTIVAR, 33);
    DBAddIntComponent(obj, "nvars", nvars);
    DBAddIntComponent(obj, "ngroups", _mm._ngroups);
    DBAddIntComponent(obj, "blockorigin", _mm._blockorigin);
@@ -9141,6 +9213,15 @@ db_pdb_PutMultivar (DBfile *dbfile, char const *name, int nvars,
       count[0] = _mm._extentssize * nvars;
       DBWriteComponent(dbfile, obj, "extents", name, "double", _mm._extents,
                        1, count);
+
+      /* Value range index of the blocks for DBQueryMultivarBlocks */
+      bvh = db_MakeBlockRangeBVH(nvars, _mm._extentssize, _mm._extents,
+                varnames, _mm._empty_list, _mm._empty_cnt, &len);
+      if (bvh) {
+         count[0] = len;
+         DBWriteComponent(dbfile, obj, "bvh", name, "double", bvh, 1, count);
+         FREE(bvh);
+      }
    }
 
    /*-------------------------------------------------------------
@@ -9674,12 +9755,41 @@ db_pdb_PutPointmesh (DBfile *dbfile, char const *name, int ndims, DBVCP2_t _coor
    double         dmin_extents[3], dmax_extents[3];
    static char   *me = "db_pdb_PutPointmesh";
    void const * const *coords = (void const * const *) _coords;
+   void          *sorted[3] = {0, 0, 0};
+   int           *perm = NULL, idxlen = 0;
+   double        *chunkidx = NULL;
+   void          *gnodeno = NULL;
+   char          *ghost_labels = NULL;
 
    /*-------------------------------------------------------------
     *  Initialize global data, and process options.
     *-------------------------------------------------------------*/
    db_InitPoint(dbfile, optlist, ndims, nels);
-   obj = DBMakeObject(name, DB_POINTMESH, 31);
+   obj = DBMakeObject(name, DB_POINTMESH, 33);
+
+   /*-------------------------------------------------------------
+    *  Optionally order the non-ghost points along a space filling
+    *  curve. Per-point option arrays are reordered to match.
+    *-------------------------------------------------------------*/
+   if (nels > 0 && _pm._spatial_sort == DB_SORT_MORTON &&
+       db_SortPointmesh(ndims, _coords, nels, _pm._lo_offset, _pm._hi_offset,
+           datatype, _pm._sort_chunk_size, sorted, &perm, &chunkidx,
+           &idxlen) == 0)
+   {
+      coords = (void const * const *) sorted;
+      if (_pm._gnodeno)
+         _pm._gnodeno = gnodeno = db_PermuteArray(_pm._gnodeno, nels,
+            _pm._llong_gnodeno ? sizeof(long long) : sizeof(int), perm);
+      if (_pm._ghost_node_labels)
+         _pm._ghost_node_labels = ghost_labels = (char *)
+            db_PermuteArray(_pm._ghost_node_labels, nels, 1, perm);
+
+      count[0] = nels;
+      DBWriteComponent(dbfile, obj, "perm", name, "integer", perm, 1, count);
+      count[0] = idxlen;
+      DBWriteComponent(dbfile, obj, "chunkidx", name, "double", chunkidx,
+                       1, count);
+   }
 
    /*-------------------------------------------------------------
     *  Write coordinate arrays.
@@ -9831,6 +9941,12 @@ db_pdb_PutPointmesh (DBfile *dbfile, char const *name, int ndims, DBVCP2_t _coor
     *-------------------------------------------------------------*/
    DBWriteObject(dbfile, obj, TRUE);
    DBFreeObject(obj);
+   for (i = 0; i < 3; i++)
+      FREE(sorted[i]);
+   FREE(perm);
+   FREE(chunkidx);
+   FREE(gnodeno);
+   FREE(ghost_labels);
 
    return (OKAY);
 }
@@ -10294,7 +10410,7 @@ db_pdb_PutQuadvar (DBfile *_dbfile, char const *name, char const *meshname, int
     *-------------------------------------------------------------*/
    db_InitQuad(_dbfile, meshname, optlist, dims, ndims);
 
-   obj = DBMakeObject(name, DB_QUADVAR, (1+(mixlen!=0))*nvars + 30);
+   obj = DBMakeObject(name, DB_QUADVAR, (1+(mixlen!=0))*nvars + 33);
 
    DBAddStrComponent(obj, "meshid", meshname);
 
@@ -10472,6 +10588,24 @@ db_pdb_PutQuadvar (DBfile *_dbfile, char const *name, char const *meshname, int
       else
           DBAddDblComponent(obj, "missing_value", _qm._missing_value);
    }
+   else if (!is_empty)
+   {
+      /* Record range of non-ghost values unless some may be missing */
+      double range[2];
+      int r;
+      if ((ndims > 1 && centering == DB_EDGECENT) ||
+          (ndims > 2 && centering == DB_FACECENT))
+         r = _DBVarRange(nvars, _vars, datatype, 1, &nels, 0, 0, range);
+      else
+         r = _DBVarRange(nvars, _vars, datatype, ndims, dims,
+                 _qm._lo_offset, maxindex, range);
+      if (r == 0)
+      {
+         DBAddIntComponent(obj, "has_range", 1);
+         DBAddDblComponent(obj, "min_value", range[0]);
+         DBAddDblComponent(obj, "max_value", range[1]);
+      }
+   }
 
    /*-------------------------------------------------------------
     *  Write quad-var object to output file.
@@ -11320,7 +11454,7 @@ db_pdb_PutUcdvar (DBfile *_dbfile, char const *name, char const *meshname, int n
    db_InitUcd(_dbfile, meshname, optlist, ndims, nnodes, nzones);
 #endif
 
-   obj = DBMakeObject(name, DB_UCDVAR, (1+(mixlen!=0)) * nvars + 22);
+   obj = DBMakeObject(name, DB_UCDVAR, (1+(mixlen!=0)) * nvars + 25);
 
    DBAddStrComponent(obj, "meshid", meshname);
 
@@ -11434,6 +11568,23 @@ db_pdb_PutUcdvar (DBfile *_dbfile, char const *name, char const *meshname, int n
       else
           DBAddDblComponent(obj, "missing_value", _um._missing_value);
    }
+   else if (nels > 0)
+   {
+      /* Record range of non-ghost values unless some may be missing */
+      double range[2];
+      int lo = 0, hi = nels-1;
+      if (centering == DB_ZONECENT)
+      {
+         if (_um._lo_offset_set == TRUE) lo = _um._lo_offset;
+         if (_um._hi_offset_set == TRUE) hi = _um._hi_offset;
+      }
+      if (_DBVarRange(nvars, _vars, datatype, 1, &nels, &lo, &hi, range) == 0)
+      {
+         DBAddIntComponent(obj, "has_range", 1);
+         DBAddDblComponent(obj, "min_value", range[0]);
+         DBAddDblComponent(obj, "max_value", range[1]);
+      }
+   }
 
    /*-------------------------------------------------------------
     *  Write ucd-mesh object to output file.
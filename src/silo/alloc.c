@@ -54,6 +54,13 @@ be used for advertising or product endorsement purposes.
 
 #include "silo_private.h"
 
+/* The DBAllocXxx routines take memory from the allocation scope of the
+   DBGetXxx call, if any, in which they are called (see db_malloc) */
+#undef ALLOC
+#undef ALLOC_N
+#define ALLOC(T)                ((T*)db_calloc((size_t)1,sizeof(T)))
+#define ALLOC_N(T,N)            ((T*)((N)>0?db_calloc((size_t)(N),sizeof(T)):0))
+
 /*======================================================================
  *||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
  *======================================================================
@@ -104,6 +111,425 @@ be used for advertising or product endorsement purposes.
  *
  */
 
+/*
+ * Memory of the objects built during a DBGetXxx call comes from the
+ * arena or allocator in effect for the file being read. The call is
+ * bracketed by db_alloc_begin/db_alloc_end, which maintain a small stack
+ * of allocation scopes. Outside of any scope, or when neither an arena
+ * nor an allocator is in effect, plain malloc/calloc are used.
+ *
+ * Because all this memory is released with db_free (via the FREE macro),
+ * db_free needs to know where a pointer came from. Arena memory lies in
+ * one of the (few, geometrically growing) blocks of a live arena and is
+ * not released individually. Memory from a user allocator is recorded in
+ * a pointer map along with the free function to hand it back to. Anything
+ * else goes to free(). While no arena is live and no user allocation is
+ * outstanding, db_free is just free().
+ */
+
+#define DB_ARENA_ALIGN          16
+#define DB_ARENA_ROUND(N)       (((N)+DB_ARENA_ALIGN-1)&~((size_t)DB_ARENA_ALIGN-1))
+#define DB_ARENA_BLOCKSIZE      (1<<20)
+#define DB_ALLOC_MAXDEPTH       32
+
+typedef struct db_arena_block_t {
+    struct db_arena_block_t *next;
+    char *base;                 /* first byte of (aligned) space */
+    size_t size;                /* bytes of space */
+    size_t used;                /* bytes handed out */
+} db_arena_block_t;
+
+struct DBarena {
+    size_t blocksize;           /* minimum size of a block */
+    size_t total;               /* total bytes of all blocks */
+    db_arena_block_t *blocks;   /* newest block first */
+    int nobjs, maxobjs;         /* objects to free with the arena */
+    int *objtypes;
+    void **objs;
+    struct DBarena *next;       /* list of live arenas */
+};
+
+typedef struct db_alloc_scope_t {
+    DBarena *arena;
+    DBAllocFunc alloc;
+    DBFreeFunc free;
+    void *user;
+} db_alloc_scope_t;
+
+typedef struct db_user_free_t {
+    DBFreeFunc free;
+    void *user;
+    struct db_user_free_t *next;
+} db_user_free_t;
+
+/* Open addressed map from pointers to pointers */
+typedef struct db_ptrmap_t {
+    size_t n, cap;
+    void const **keys;
+    void **vals;
+} db_ptrmap_t;
+
+static DBarena *db_arenas = 0;
+static db_alloc_scope_t db_alloc_stack[DB_ALLOC_MAXDEPTH];
+static int db_alloc_depth = 0;
+static db_ptrmap_t db_user_ptrs = {0, 0, 0, 0};     /* ptr -> db_user_free_t */
+static db_ptrmap_t db_arena_objs = {0, 0, 0, 0};    /* obj -> DBarena */
+static db_user_free_t *db_user_frees = 0;
+
+static size_t
+db_ptrmap_slot(db_ptrmap_t const *m, void const *key)
+{
+    size_t h = (size_t) key;
+    h ^= h >> 17;
+    h *= (size_t) 0x9E3779B97F4A7C15ULL;
+    return (h ^ (h >> 29)) & (m->cap - 1);
+}
+
+static int
+db_ptrmap_insert(db_ptrmap_t *m, void const *key, void *val)
+{
+    size_t i;
+
+    if (2 * (m->n + 1) > m->cap)
+    {
+        db_ptrmap_t g;
+        g.n = 0;
+        g.cap = m->cap ? 2 * m->cap : 64;
+        g.keys = (void const **) calloc(g.cap, sizeof(void*));
+        g.vals = (void **) calloc(g.cap, sizeof(void*));
+        if (!g.keys || !g.vals)
+        {
+            free(g.keys);
+            free(g.vals);
+            return -1;
+        }
+        for (i = 0; i < m->cap; i++)
+            if (m->keys[i])
+                db_ptrmap_insert(&g, m->keys[i], m->vals[i]);
+        free(m->keys);
+        free(m->vals);
+        *m = g;
+    }
+
+    for (i = db_ptrmap_slot(m, key); m->keys[i]; i = (i + 1) & (m->cap - 1))
+        if (m->keys[i] == key)
+            break;
+    if (!m->keys[i])
+        m->n++;
+    m->keys[i] = key;
+    m->vals[i] = val;
+    return 0;
+}
+
+/* Remove KEY from the map, returning its value or NULL if not present */
+static void *
+db_ptrmap_remove(db_ptrmap_t *m, void const *key)
+{
+    size_t i, j, k;
+    void *val;
+
+    if (!m->n)
+        return 0;
+    for (i = db_ptrmap_slot(m, key); m->keys[i] != key; i = (i + 1) & (m->cap - 1))
+        if (!m->keys[i])
+            return 0;
+    val = m->vals[i];
+
+    /* Shift back any following entries that probed past slot i */
+    for (j = (i + 1) & (m->cap - 1); m->keys[j]; j = (j + 1) & (m->cap - 1))
+    {
+        k = db_ptrmap_slot(m, m->keys[j]);
+        if ((j > i && (k <= i || k > j)) || (j < i && (k <= i && k > j)))
+        {
+            m->keys[i] = m->keys[j];
+            m->vals[i] = m->vals[j];
+            i = j;
+        }
+    }
+    m->keys[i] = 0;
+    m->vals[i] = 0;
+    m->n--;
+    return val;
+}
+
+static DBarena *
+db_arena_owner(void const *ptr)
+{
+    DBarena *a;
+    db_arena_block_t *b;
+
+    for (a = db_arenas; a; a = a->next)
+        for (b = a->blocks; b; b = b->next)
+            if ((char const *) ptr >= b->base && (char const *) ptr < b->base + b->size)
+                return a;
+    return 0;
+}
+
+static void *
+db_arena_alloc(DBarena *arena, size_t nbytes)
+{
+    db_arena_block_t *b = arena->blocks;
+    void *p;
+
+    nbytes = DB_ARENA_ROUND(nbytes ? nbytes : 1);
+    if (!b || b->size - b->used < nbytes)
+    {
+        /* Grow geometrically so that the number of blocks, which db_free
+           searches, stays logarithmic in the arena's size. */
+        size_t size = arena->blocksize;
+        if (size < arena->total) size = arena->total;
+        if (size < nbytes) size = nbytes;
+        if (NULL == (b = (db_arena_block_t *) malloc(DB_ARENA_ROUND(sizeof(*b)) + size)))
+            return 0;
+        b->base = (char *) b + DB_ARENA_ROUND(sizeof(*b));
+        b->size = size;
+        b->used = 0;
+        b->next = arena->blocks;
+        arena->blocks = b;
+        arena->total += size;
+    }
+    p = b->base + b->used;
+    b->used += nbytes;
+    return p;
+}
+
+INTERNAL void
+db_alloc_push(DBarena *arena, DBAllocFunc alloc, DBFreeFunc free, void *user)
+{
+    db_alloc_scope_t *s;
+
+    if (db_alloc_depth >= DB_ALLOC_MAXDEPTH)
+    {
+        /* Too deep to be a real call chain. Just use the same scope. */
+        db_alloc_depth++;
+        return;
+    }
+    s = &db_alloc_stack[db_alloc_depth++];
+    s->arena = arena;
+    s->alloc = arena ? 0 : alloc;
+    s->free = arena ? 0 : free;
+    s->user = arena ? 0 : user;
+}
+
+/*----------------------------------------------------------------------
+ *  Function                                              db_alloc_end
+ *
+ *  Purpose
+ *
+ *     End the allocation scope of a DBGetXxx call. When returning to
+ *     the user, an object allocated from an arena is recorded with the
+ *     arena so that DBFreeArena can release any of its memory that did
+ *     not come from the arena.
+ *----------------------------------------------------------------------*/
+INTERNAL void
+db_alloc_end(int type, void *obj)
+{
+    DBarena *arena;
+
+    if (db_alloc_depth <= 0)
+        return;
+    if (--db_alloc_depth > 0 || !obj)
+        return;
+
+    arena = db_alloc_stack[0].arena;
+    if (!arena || db_arena_owner(obj) != arena)
+        return;
+
+    if (arena->nobjs == arena->maxobjs)
+    {
+        int n = arena->maxobjs ? 2 * arena->maxobjs : 64;
+        int *t = (int *) realloc(arena->objtypes, n * sizeof(int));
+        void **o = t ? (void **) realloc(arena->objs, n * sizeof(void*)) : 0;
+        if (t) arena->objtypes = t;
+        if (!o) return;
+        arena->objs = o;
+        arena->maxobjs = n;
+    }
+    if (db_ptrmap_insert(&db_arena_objs, obj, arena) < 0)
+        return;
+    arena->objtypes[arena->nobjs] = type;
+    arena->objs[arena->nobjs++] = obj;
+}
+
+/* Abandon all allocation scopes after an error unwinds an API call */
+INTERNAL void
+db_alloc_reset(void)
+{
+    db_alloc_depth = 0;
+}
+
+INTERNAL void *
+db_malloc(size_t nbytes)
+{
+    db_alloc_scope_t const *s;
+    db_user_free_t *uf;
+    void *p;
+
+    if (db_alloc_depth <= 0)
+        return malloc(nbytes);
+
+    s = &db_alloc_stack[(db_alloc_depth > DB_ALLOC_MAXDEPTH ?
+                         DB_ALLOC_MAXDEPTH : db_alloc_depth) - 1];
+    if (s->arena)
+        return db_arena_alloc(s->arena, nbytes);
+    if (!s->alloc)
+        return malloc(nbytes);
+
+    /* Find (or make) the record of where to hand this memory back to */
+    for (uf = db_user_frees; uf; uf = uf->next)
+        if (uf->free == s->free && uf->user == s->user)
+            break;
+    if (!uf)
+    {
+        if (NULL == (uf = (db_user_free_t *) malloc(sizeof(*uf))))
+            return 0;
+        uf->free = s->free;
+        uf->user = s->user;
+        uf->next = db_user_frees;
+        db_user_frees = uf;
+    }
+
+    if (NULL == (p = s->alloc(nbytes, s->user)))
+        return 0;
+    if (db_ptrmap_insert(&db_user_ptrs, p, uf) < 0)
+    {
+        s->free(p, s->user);
+        return 0;
+    }
+    return p;
+}
+
+INTERNAL void *
+db_calloc(size_t n, size_t size)
+{
+    void *p;
+
+    if (db_alloc_depth <= 0)
+        return calloc(n, size);
+    if ((p = db_malloc(n * size)))
+        memset(p, 0, n * size);
+    return p;
+}
+
+INTERNAL void
+db_free(void *ptr)
+{
+    db_user_free_t *uf;
+
+    if (!ptr)
+        return;
+
+    if (!db_arenas && !db_user_ptrs.n)
+    {
+        free(ptr);
+        return;
+    }
+
+    /* Arena memory lives until DBFreeArena. But, an object freed by the
+       caller no longer needs to be freed by DBFreeArena. */
+    if (db_arena_owner(ptr))
+    {
+        db_ptrmap_remove(&db_arena_objs, ptr);
+        return;
+    }
+
+    if ((uf = (db_user_free_t *) db_ptrmap_remove(&db_user_ptrs, ptr)))
+    {
+        uf->free(ptr, uf->user);
+        return;
+    }
+
+    free(ptr);
+}
+
+/*----------------------------------------------------------------------
+ *  Function                                               DBMakeArena
+ *
+ *  Purpose
+ *
+ *     Create an arena for the memory of objects returned by DBGetXxx
+ *     calls. Memory is taken from the arena in blocks of at least
+ *     BLOCKSIZE bytes (0 selects a default of 1 megabyte). The blocks
+ *     grow geometrically as the arena fills.
+ *----------------------------------------------------------------------*/
+PUBLIC DBarena *
+DBMakeArena(size_t blocksize)
+{
+    DBarena *arena;
+
+    API_BEGIN("DBMakeArena", DBarena *, NULL) {
+        if (NULL == (arena = (DBarena *) calloc(1, sizeof(DBarena))))
+            API_ERROR(NULL, E_NOMEM);
+        arena->blocksize = blocksize ? DB_ARENA_ROUND(blocksize) : DB_ARENA_BLOCKSIZE;
+        arena->next = db_arenas;
+        db_arenas = arena;
+        API_RETURN(arena);
+    }
+    API_END_NOPOP;
+}
+
+/* Number of bytes handed out by an arena */
+PUBLIC size_t
+DBGetArenaSize(DBarena const *arena)
+{
+    size_t n = 0;
+    db_arena_block_t const *b;
+
+    if (!arena)
+        return 0;
+    for (b = arena->blocks; b; b = b->next)
+        n += b->used;
+    return n;
+}
+
+/*----------------------------------------------------------------------
+ *  Function                                               DBFreeArena
+ *
+ *  Purpose
+ *
+ *     Release all the objects allocated from an arena, and the arena
+ *     itself, in one call. Objects the caller has already released with
+ *     DBFreeXxx calls are skipped. The arena is unset globally and in
+ *     all open files.
+ *----------------------------------------------------------------------*/
+PUBLIC int
+DBFreeArena(DBarena *arena)
+{
+    DBarena **pa;
+    db_arena_block_t *b, *next;
+    int i;
+
+    API_BEGIN("DBFreeArena", int, -1) {
+        if (!arena)
+            API_ERROR("arena", E_BADARGS);
+        for (pa = &db_arenas; *pa && *pa != arena; pa = &(*pa)->next)
+            /*void*/;
+        if (!*pa)
+            API_ERROR("arena", E_BADARGS);
+
+        /* Objects may hold memory not from the arena (e.g. strings) */
+        for (i = 0; i < arena->nobjs; i++)
+        {
+            if (db_ptrmap_remove(&db_arena_objs, arena->objs[i]) != arena)
+                continue;
+            DBFreeObjects(1, &arena->objtypes[i], &arena->objs[i]);
+        }
+
+        db_ForgetArena(arena);
+        *pa = arena->next;
+        for (b = arena->blocks; b; b = next)
+        {
+            next = b->next;
+            free(b);
+        }
+        free(arena->objtypes);
+        free(arena->objs);
+        free(arena);
+        API_RETURN(0);
+    }
+    API_END_NOPOP;
+}
+
 /*----------------------------------------------------------------------
  *  Function                                            DBAllocDefvars
  *
@@ -1835,6 +2261,49 @@ DBFreeMaterial(DBmaterial *mats)
     FREE(mats);
 }
 
+/*----------------------------------------------------------------------
+ *  Function                                        DBAllocMaterialCSR
+ *
+ *  Purpose
+ *
+ *     Allocate and initialize a CSR material-data object.
+ *----------------------------------------------------------------------*/
+PUBLIC DBmaterialcsr *
+DBAllocMaterialCSR(void)
+{
+    DBmaterialcsr *csr;
+
+    API_BEGIN("DBAllocMaterialCSR", DBmaterialcsr *, NULL) {
+        if (NULL == (csr = ALLOC(DBmaterialcsr)))
+            API_ERROR(NULL, E_NOMEM);
+
+        /* Initialize all memory to zero. */
+        memset(csr, 0, sizeof(DBmaterialcsr));
+    }
+    API_END;
+
+    return (csr);
+}
+/*----------------------------------------------------------------------
+ *  Function                                         DBFreeMaterialCSR
+ *
+ *  Purpose
+ *
+ *     Release all storage associated with the given CSR material object.
+ *----------------------------------------------------------------------*/
+PUBLIC void
+DBFreeMaterialCSR(DBmaterialcsr *csr)
+{
+    if (csr == NULL)
+        return;
+
+    FREE(csr->matnos);
+    FREE(csr->offsets);
+    FREE(csr->matids);
+    FREE(csr->vf);
+    FREE(csr);
+}
+
 PUBLIC int
 DBIsEmptyMaterial(DBmaterial const *mats)
 {
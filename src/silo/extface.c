@@ -886,3 +886,429 @@ AllocFace(void)
 
     return face;
 }
+
+/*
+ * Number of faces before the polyhedral facelist computation uses
+ * threads.
+ */
+#define PH_PARALLEL (1<<15)
+
+/***********************************************************************
+ *
+ * Purpose:  Compute a hash of the node loop of a face that is the same
+ *           for every starting node and either direction, and return
+ *           the position and direction of the canonical walk.
+ *
+ * Input arguments:
+ *    nodes    : The nodes making up the face.
+ *    nNodes   : The number of nodes in the face.
+ *
+ * Output arguments:
+ *    iStart   : Index of the minimum node.
+ *    dir      : 1 or -1, the direction of the walk from iStart.
+ *
+ **********************************************************************/
+
+PRIVATE unsigned long long
+HashLoop(int const *nodes, int nNodes, int *iStart, int *dir)
+{
+    int       i, j, iMin = 0, d = 1;
+    unsigned long long h = 14695981039346656037ULL;
+
+    for (i = 1; i < nNodes; i++)
+        if (nodes[i] < nodes[iMin]) iMin = i;
+    if (nNodes > 2 &&
+        nodes[(iMin + nNodes - 1) % nNodes] < nodes[(iMin + 1) % nNodes])
+        d = -1;
+
+    h = (h ^ (unsigned long long) nNodes) * 1099511628211ULL;
+    for (i = 0, j = iMin; i < nNodes; i++, j = (j + d + nNodes) % nNodes)
+        h = (h ^ (unsigned long long) (unsigned) nodes[j]) * 1099511628211ULL;
+
+    *iStart = iMin;
+    *dir = d;
+    return h;
+}
+
+/***********************************************************************
+ *
+ * Purpose:  Determine if two faces are made of the same loop of nodes,
+ *           in either direction.
+ *
+ **********************************************************************/
+
+PRIVATE int
+SameLoop(int const *a, int na, int const *b, int nb)
+{
+    int       i, ia, da, ib, db, ja, jb;
+
+    if (na != nb)
+        return 0;
+    HashLoop(a, na, &ia, &da);
+    HashLoop(b, nb, &ib, &db);
+    for (i = 0, ja = ia, jb = ib; i < na; i++)
+    {
+        if (a[ja] != b[jb])
+            return 0;
+        ja = (ja + da + na) % na;
+        jb = (jb + db + nb) % nb;
+    }
+    return 1;
+}
+
+/***********************************************************************
+ *
+ * Purpose:  Calculate the external faces of a polyhedral zonelist.
+ *
+ * Input arguments:
+ *    zl        : The polyhedral zonelist.
+ *    matList   : Zonal array giving material numbers (else NULL).
+ *    bndMethod : Method to use regarding boundaries.
+ *
+ * Output arguments:
+ *    err       : The error code if NULL is returned.
+ *
+ * Notes
+ *
+ *    A face of the zonelist's face table used by one zone is a candidate
+ *    external face and one used by two zones is internal. This needs no
+ *    searching and the uses are counted in parallel when Silo is built
+ *    with OpenMP. Faces used by more than two zones are ignored.
+ *
+ *    Some writers list a face shared by two zones twice in the face
+ *    table, once for each zone. So the candidates are then matched by
+ *    hashing their node loops and candidates with the same loop of
+ *    nodes are internal too.
+ *
+ **********************************************************************/
+
+PRIVATE DBfacelist *
+CalcExternalFacesPH(DBphzonelist const *zl, int const *matList,
+                    int bndMethod, int *err)
+{
+    int       i, j, k, f, z;
+    int       nFaces = zl->nfaces, nZones = zl->nzones;
+    int       nCand = 0, nOut = 0, nShapes = 0, lShapeList = 10, bad = 0;
+    int       lFaceList = 0;
+    int       *nodeOff = NULL, *zoneOff = NULL, *cnt = NULL, *use = NULL;
+    int       *cand = NULL, *partner = NULL, *table = NULL;
+    int       *outUse = NULL, *outFace = NULL, *outOff = NULL;
+    int       *faceList = NULL, *zoneNo = NULL;
+    int       *shapeSize = NULL, *shapeCnt = NULL, *shapeOff = NULL;
+    char      *keep = NULL;
+    unsigned long long *hash = NULL;
+    size_t    tableSize;
+    DBfacelist *fl = NULL;
+
+    *err = E_NOMEM;
+    nodeOff = MALLOC_N(int, nFaces + 1);
+    zoneOff = MALLOC_N(int, nZones + 1);
+    cnt     = (int *) calloc(nFaces + 1, sizeof(int));
+    use     = MALLOC_N(int, 2 * nFaces + 1);
+    cand    = MALLOC_N(int, nFaces + 1);
+    keep    = (char *) calloc(nFaces + 1, sizeof(char));
+    if (!nodeOff || !zoneOff || !cnt || !use || !cand || !keep)
+        goto done;
+
+    *err = E_BADARGS;
+    nodeOff[0] = 0;
+    for (f = 0; f < nFaces; f++)
+    {
+        if (zl->nodecnt[f] < 0)
+            goto done;
+        nodeOff[f+1] = nodeOff[f] + zl->nodecnt[f];
+    }
+    zoneOff[0] = 0;
+    for (z = 0; z < nZones; z++)
+    {
+        if (zl->facecnt[z] < 0)
+            goto done;
+        zoneOff[z+1] = zoneOff[z] + zl->facecnt[z];
+    }
+    if (nodeOff[nFaces] > zl->lnodelist || zoneOff[nZones] > zl->lfacelist)
+        goto done;
+
+    /*
+     * Record the first two uses of each face, as twice the zone number
+     * plus one if the zone uses the face reversed.
+     */
+#ifdef _OPENMP
+#pragma omp parallel for private(j,k,f) reduction(+:bad) if (nFaces >= PH_PARALLEL)
+#endif
+    for (z = 0; z < nZones; z++)
+    {
+        for (j = zoneOff[z]; j < zoneOff[z+1]; j++)
+        {
+            int id = zl->facelist[j];
+            f = id < 0 ? ~id : id;
+            if (f >= nFaces)
+            {
+                bad++;
+                break;
+            }
+#ifdef _OPENMP
+#pragma omp atomic capture
+#endif
+            k = cnt[f]++;
+            if (k < 2)
+                use[2*f+k] = 2 * z + (id < 0);
+        }
+    }
+    if (bad)
+        goto done;
+
+    /*
+     * Faces used once are candidates. Faces used twice are internal
+     * unless they separate materials, in which case both sides are kept.
+     * The two uses are recorded in whichever order the threads got to
+     * them, so put them in zone order for the output.
+     */
+    for (f = 0; f < nFaces; f++)
+    {
+        if (cnt[f] == 2 && use[2*f] > use[2*f+1])
+        {
+            int t = use[2*f];
+            use[2*f] = use[2*f+1];
+            use[2*f+1] = t;
+        }
+        if (cnt[f] == 1)
+            cand[nCand++] = f;
+        else if (cnt[f] == 2 && bndMethod != 0 &&
+                 matList[use[2*f]/2] != matList[use[2*f+1]/2])
+            keep[f] = 2;
+    }
+
+    /*
+     * Match candidates made of the same loop of nodes using an open
+     * addressing hash table.
+     */
+    *err = E_NOMEM;
+    for (tableSize = 16; tableSize < 2 * (size_t) nCand; tableSize *= 2)
+        ;
+    hash    = MALLOC_N(unsigned long long, nCand + 1);
+    partner = MALLOC_N(int, nCand + 1);
+    table   = MALLOC_N(int, tableSize);
+    if (!hash || !partner || !table)
+        goto done;
+
+#ifdef _OPENMP
+#pragma omp parallel for private(f) if (nCand >= PH_PARALLEL)
+#endif
+    for (i = 0; i < nCand; i++)
+    {
+        int iMin, dir;
+        f = cand[i];
+        hash[i] = HashLoop(zl->nodelist + nodeOff[f], zl->nodecnt[f],
+                           &iMin, &dir);
+        partner[i] = -1;
+    }
+
+    for (i = 0; i < (int) tableSize; i++)
+        table[i] = -1;
+    for (i = 0; i < nCand; i++)
+    {
+        int fi = cand[i];
+        size_t s = (size_t) (hash[i] & (tableSize - 1));
+
+        for (; table[s] >= 0; s = (s + 1) & (tableSize - 1))
+        {
+            int c = table[s], fc = cand[c];
+            if (partner[c] < 0 && hash[c] == hash[i] &&
+                SameLoop(zl->nodelist + nodeOff[fc], zl->nodecnt[fc],
+                         zl->nodelist + nodeOff[fi], zl->nodecnt[fi]))
+            {
+                partner[c] = i;
+                partner[i] = c;
+                break;
+            }
+        }
+        if (partner[i] < 0)
+            table[s] = i;
+    }
+
+    for (i = 0; i < nCand; i++)
+    {
+        int c = partner[i];
+        if (c < 0 || (bndMethod != 0 &&
+            matList[use[2*cand[i]]/2] != matList[use[2*cand[c]]/2]))
+            keep[cand[i]] = 1;
+    }
+    FREE(table);
+    FREE(partner);
+    FREE(hash);
+
+    /*
+     * Gather the kept uses of faces of real zones, assigning each to a
+     * shape by its number of nodes in order of first appearance.
+     */
+    outUse    = MALLOC_N(int, 2 * nFaces + 1);
+    outFace   = MALLOC_N(int, 2 * nFaces + 1);
+    outOff    = MALLOC_N(int, 2 * nFaces + 1);
+    shapeSize = MALLOC_N(int, lShapeList);
+    shapeCnt  = MALLOC_N(int, lShapeList);
+    if (!outUse || !outFace || !outOff || !shapeSize || !shapeCnt)
+        goto done;
+
+    for (f = 0; f < nFaces; f++)
+    {
+        for (k = 0; k < keep[f]; k++)
+        {
+            z = use[2*f+k] / 2;
+            if (z < zl->lo_offset || z > zl->hi_offset)
+                continue;
+
+            for (j = 0; j < nShapes; j++)
+                if (shapeSize[j] == zl->nodecnt[f]) break;
+            if (j == nShapes)
+            {
+                if (nShapes >= lShapeList)
+                {
+                    lShapeList += 10;
+                    shapeSize = REALLOC_N(shapeSize, int, lShapeList);
+                    shapeCnt  = REALLOC_N(shapeCnt, int, lShapeList);
+                }
+                shapeSize[nShapes] = zl->nodecnt[f];
+                shapeCnt[nShapes++] = 0;
+            }
+            outFace[nOut] = f;
+            outUse[nOut] = use[2*f+k];
+            outOff[nOut++] = j;
+            shapeCnt[j]++;
+            lFaceList += zl->nodecnt[f];
+        }
+    }
+
+    /*
+     * Turn the shape of each face into its position in the output.
+     */
+    shapeOff = MALLOC_N(int, 2 * (nShapes + 1));
+    faceList = MALLOC_N(int, lFaceList + 1);
+    zoneNo   = MALLOC_N(int, nOut + 1);
+    if (!shapeOff || !faceList || !zoneNo)
+        goto done;
+    for (j = 0, k = 0, i = 0; j < nShapes; j++)
+    {
+        shapeOff[2*j]   = k;
+        shapeOff[2*j+1] = i;
+        k += shapeCnt[j];
+        i += shapeCnt[j] * shapeSize[j];
+    }
+    for (i = 0; i < nOut; i++)
+    {
+        j = outOff[i];
+        outOff[i] = shapeOff[2*j];
+        zoneNo[shapeOff[2*j]] = outUse[i] / 2 + zl->origin;
+        shapeOff[2*j] += 1;
+        outUse[i] = (outUse[i] & 1) | (shapeOff[2*j+1] << 1);
+        shapeOff[2*j+1] += shapeSize[j];
+    }
+
+    /*
+     * Copy the nodes of each face in the orientation its zone gives it,
+     * starting from its lowest node.
+     */
+#ifdef _OPENMP
+#pragma omp parallel for private(j,f) if (nOut >= PH_PARALLEL)
+#endif
+    for (i = 0; i < nOut; i++)
+    {
+        int const *nodes;
+        int n, iMin = 0, rev, *dst;
+
+        f     = outFace[i];
+        n     = zl->nodecnt[f];
+        nodes = zl->nodelist + nodeOff[f];
+        rev   = outUse[i] & 1;
+        dst   = faceList + (outUse[i] >> 1);
+        for (j = 1; j < n; j++)
+            if (nodes[j] < nodes[iMin]) iMin = j;
+        for (j = 0; j < n; j++)
+            dst[j] = nodes[rev ? (iMin - j + n) % n : (iMin + j) % n];
+    }
+
+    fl = DBAllocFacelist();
+    if (!fl)
+        goto done;
+    fl->ndims     = 3;
+    fl->nfaces    = nOut;
+    fl->origin    = zl->origin;
+    fl->nodelist  = faceList;
+    fl->lnodelist = lFaceList;
+    fl->nshapes   = nShapes;
+    fl->shapecnt  = shapeCnt;
+    fl->shapesize = shapeSize;
+    fl->zoneno    = zoneNo;
+    faceList = zoneNo = shapeCnt = shapeSize = NULL;
+    *err = 0;
+
+done:
+    FREE(nodeOff);
+    FREE(zoneOff);
+    FREE(cnt);
+    FREE(use);
+    FREE(cand);
+    FREE(keep);
+    FREE(hash);
+    FREE(partner);
+    FREE(table);
+    FREE(outUse);
+    FREE(outFace);
+    FREE(outOff);
+    FREE(shapeOff);
+    FREE(faceList);
+    FREE(zoneNo);
+    FREE(shapeSize);
+    FREE(shapeCnt);
+
+    return fl;
+}
+
+/***********************************************************************
+ *
+ * Purpose:  Given a polyhedral zonelist, calculate a facelist describing
+ *           all of the external faces.
+ *
+ * Input arguments:
+ *    zl        : The polyhedral zonelist.
+ *    matList   : Zonal array giving material numbers (else NULL).
+ *    bndMethod : Method to use regarding boundaries.
+ *
+ * Output arguments:
+ *
+ * Input/Output arguments:
+ *
+ * Notes
+ *
+ *    As for DBCalcExternalFacelist2, a non-zero bndMethod keeps faces
+ *    between zones of different materials, once for each zone, and
+ *    faces of ghost zones are dropped. Faces are grouped by their
+ *    number of nodes.
+ *
+ **********************************************************************/
+
+PUBLIC DBfacelist *
+DBCalcExternalFacelistPH(DBphzonelist const *zl, int const *matList,
+                         int bndMethod)
+{
+    DBfacelist *fl = NULL;
+    int       err = E_BADARGS;
+
+    API_BEGIN("DBCalcExternalFacelistPH", DBfacelist *, NULL) {
+        if (!zl)
+            API_ERROR("zl", E_BADARGS);
+        if (zl->nfaces < 0 || zl->nzones < 0)
+            API_ERROR("zl", E_BADARGS);
+        if ((zl->nfaces > 0 && (!zl->nodecnt || !zl->nodelist)) ||
+            (zl->nzones > 0 && (!zl->facecnt || !zl->facelist)))
+            API_ERROR("zl", E_BADARGS);
+        if (bndMethod != 0 && !matList)
+            API_ERROR("matList", E_BADARGS);
+
+        fl = CalcExternalFacesPH(zl, matList, bndMethod, &err);
+        if (!fl)
+            API_ERROR("DBCalcExternalFacelistPH", err);
+
+        API_RETURN(fl);
+    }
+    API_END_NOPOP;
+}
@@ -121,10 +121,25 @@ product endorsement purposes.
  * processor then returns from the PMPIO_WaitForBaton() call it is waiting.
  * This process continues with each processor in a group handing off a baton
  * to the next processor.
+ *
+ * For large groups, waiting for the baton can dominate. PMPIO_Aggregate()
+ * replaces the baton chain with two phases. Every processor serializes its
+ * objects into a buffer. The buffers of a group are then sent to the /first/
+ * processor of the group which keeps the file open and writes them all,
+ * one after the other.
+ *
+ *        PMPIO_baton_t *bat = PMPIO_Init(MPI_COMM_WORLD,...)
+ *        serialize this processor's objects into buf
+ *        PMPIO_Aggregate(bat, a, b, buf, len, writeCb, maxBytes)
  *-----------------------------------------------------------------------------
  */
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 /*-----------------------------------------------------------------------------
  * Audience:    Public
@@ -199,6 +214,30 @@ typedef void * (*PMPIO_OpenFileCallBack)(const char *fname, const char *nsname,
  */
 typedef void  (*PMPIO_CloseFileCallBack)(void *file, void *udata);
 
+/*-----------------------------------------------------------------------------
+ * Audience:    Public
+ * Chapter:     Write Buffer Callback
+ * Description:
+ * Defines the write buffer callback interface used by PMPIO_Aggregate(). It
+ * is called on the first processor of each group, once for each processor in
+ * the group, in rank order. It should 1) create the namespace nsname in the
+ * file, 2) set the file to that namespace and 3) write the objects serialized
+ * in buf. The buffer is owned by PMPIO and is only valid during the call.
+ *
+ *     typedef int (*PMPIO_WriteBufferCallBack)(
+ *         void *file,         pointer to the file object to write to
+ *         const char *nsname, namespace of the processor that sent buf
+ *         const void *buf,    the serialized objects
+ *         size_t len,         the size of buf in bytes
+ *         void *udata         optional user data passed by PMPIO
+ *     );
+ *
+ * It should return 0 on success.
+ *-----------------------------------------------------------------------------
+ */
+typedef int (*PMPIO_WriteBufferCallBack)(void *file, const char *nsname,
+                                         const void *buf, size_t len, void *udata);
+
 typedef struct _PMPIO_baton_t
 {
     PMPIO_iomode_t ioMode;
@@ -430,6 +469,168 @@ PMPIO_HandOffBaton(
     }
 }
 
+/* MPI counts are ints. Byte buffers of 2 GiB or more are sent as a count of
+   1 GiB chunks followed by the remainder, as two messages. */
+#ifndef PMPIO_CHUNK_BYTES
+#define PMPIO_CHUNK_BYTES (1<<30)
+#endif
+
+static void
+PMPIO_IsendBytes(const void *buf, size_t len, int dest, int tag, MPI_Comm comm,
+    MPI_Request req[2])
+{
+    size_t nchunks = len / PMPIO_CHUNK_BYTES, rest = len % PMPIO_CHUNK_BYTES;
+
+    req[0] = req[1] = MPI_REQUEST_NULL;
+    if (nchunks > 0)
+    {
+        MPI_Datatype chunk;
+        MPI_Type_contiguous(PMPIO_CHUNK_BYTES, MPI_BYTE, &chunk);
+        MPI_Type_commit(&chunk);
+        MPI_Isend((void *) buf, (int) nchunks, chunk, dest, tag, comm, &req[0]);
+        MPI_Type_free(&chunk);
+    }
+    if (rest > 0)
+        MPI_Isend((char *) buf + nchunks * PMPIO_CHUNK_BYTES, (int) rest, MPI_BYTE,
+            dest, tag, comm, &req[1]);
+}
+
+static void
+PMPIO_IrecvBytes(void *buf, size_t len, int src, int tag, MPI_Comm comm,
+    MPI_Request req[2])
+{
+    size_t nchunks = len / PMPIO_CHUNK_BYTES, rest = len % PMPIO_CHUNK_BYTES;
+
+    req[0] = req[1] = MPI_REQUEST_NULL;
+    if (nchunks > 0)
+    {
+        MPI_Datatype chunk;
+        MPI_Type_contiguous(PMPIO_CHUNK_BYTES, MPI_BYTE, &chunk);
+        MPI_Type_commit(&chunk);
+        MPI_Irecv(buf, (int) nchunks, chunk, src, tag, comm, &req[0]);
+        MPI_Type_free(&chunk);
+    }
+    if (rest > 0)
+        MPI_Irecv((char *) buf + nchunks * PMPIO_CHUNK_BYTES, (int) rest, MPI_BYTE,
+            src, tag, comm, &req[1]);
+}
+
+/*-----------------------------------------------------------------------------
+ * Audience:    Public
+ * Chapter:     Aggregation
+ * Purpose:     Write a group's serialized objects from its first processor
+ * Description:
+ * Takes the place of PMPIO_WaitForBaton(), the local work and
+ * PMPIO_HandOffBaton() for PMPIO_WRITE. Every processor passes the objects
+ * it would have written in its namespace, serialized into a buffer.
+ *
+ * Other processors send their namespace and buffer to the first processor of
+ * their group with non-blocking sends and return when the sends complete.
+ *
+ * The first processor calls the create callback once, with a NULL namespace,
+ * and keeps the file open while it calls writeCb for its own buffer and then
+ * for each of the others, in rank order. Receives are posted ahead of the
+ * writes so communication overlaps I/O, but no more than maxBytes of buffers
+ * (or one buffer, if that is larger) are held at once. Finally, it calls the
+ * close callback.
+ *
+ * Returns PMPIO_BATON_OK on success. On the first processor of a group,
+ * returns PMPIO_BATON_ERR if the create callback or any writeCb call fails.
+ *-----------------------------------------------------------------------------
+ */
+static int
+PMPIO_Aggregate(
+    PMPIO_baton_t *Bat,         /* The PMPIO baton obtained from a PMPIO_Init() call. */
+    const char *fname,          /* The name of the file for this processor's group. */
+    const char *nsname,         /* The name of the namespace in the file for this processor. */
+    const void *buf,            /* This processor's serialized objects. */
+    size_t len,                 /* The size of buf in bytes. */
+    PMPIO_WriteBufferCallBack writeCb, /* Writes a processor's buffer into the file. */
+    size_t maxBytes             /* Bound on the bytes of buffers held on the first
+                                   processor while writing. */
+)
+{
+    int nInGroup, leader, i, retval = PMPIO_BATON_OK;
+
+    if (Bat->ioMode != PMPIO_WRITE || writeCb == 0)
+        return PMPIO_BATON_ERR;
+
+    leader = Bat->rankInComm - Bat->rankInGroup;
+    nInGroup = Bat->groupRank < Bat->numGroupsWithExtraProc ?
+               Bat->groupSize + 1 : Bat->groupSize;
+
+    if (Bat->rankInGroup > 0)
+    {
+        /* Header is the namespace and buffer sizes. Message order between
+           a pair of processors with the same tag is preserved by MPI. */
+        MPI_Request req[5];
+        long long hdr[2];
+        hdr[0] = nsname ? (long long) strlen(nsname) + 1 : 0;
+        hdr[1] = (long long) len;
+        MPI_Isend(hdr, 2, MPI_LONG_LONG, leader, Bat->mpiTag, Bat->mpiComm, &req[0]);
+        PMPIO_IsendBytes(nsname, (size_t) hdr[0], leader, Bat->mpiTag,
+            Bat->mpiComm, &req[1]);
+        PMPIO_IsendBytes(buf, len, leader, Bat->mpiTag, Bat->mpiComm, &req[3]);
+        MPI_Waitall(5, req, MPI_STATUSES_IGNORE);
+        return PMPIO_BATON_OK;
+    }
+    else
+    {
+        long long *hdr = (long long *) malloc(2 * nInGroup * sizeof(long long));
+        MPI_Request *req = (MPI_Request *) malloc(5 * nInGroup * sizeof(MPI_Request));
+        char **rbuf = (char **) calloc(nInGroup, sizeof(char *));
+        size_t held = 0;
+        int next = 1;
+        void *file;
+
+        /* Sizes from every other processor of the group, all at once */
+        for (i = 1; i < nInGroup; i++)
+            MPI_Irecv(&hdr[2*i], 2, MPI_LONG_LONG, leader + i, Bat->mpiTag,
+                Bat->mpiComm, &req[5*i]);
+        for (i = 1; i < nInGroup; i++)
+            MPI_Wait(&req[5*i], MPI_STATUS_IGNORE);
+
+        file = Bat->createCb(fname, 0, Bat->userData);
+        if (file == 0 || writeCb(file, nsname, buf, len, Bat->userData) != 0)
+            retval = PMPIO_BATON_ERR;
+
+        for (i = 1; i < nInGroup; i++)
+        {
+            /* Post receives ahead, within the bound on held bytes */
+            while (next < nInGroup &&
+                   (next == i || held + (size_t) (hdr[2*next] + hdr[2*next+1]) <= maxBytes))
+            {
+                size_t nsz = (size_t) hdr[2*next], bsz = (size_t) hdr[2*next+1];
+                rbuf[next] = (char *) malloc(nsz + bsz + 1);
+                PMPIO_IrecvBytes(rbuf[next], nsz, leader + next, Bat->mpiTag,
+                    Bat->mpiComm, &req[5*next+1]);
+                PMPIO_IrecvBytes(rbuf[next] + nsz, bsz, leader + next, Bat->mpiTag,
+                    Bat->mpiComm, &req[5*next+3]);
+                held += nsz + bsz;
+                next++;
+            }
+
+            MPI_Waitall(4, &req[5*i+1], MPI_STATUSES_IGNORE);
+            if (retval == PMPIO_BATON_OK &&
+                writeCb(file, hdr[2*i] > 0 ? rbuf[i] : 0, rbuf[i] + hdr[2*i],
+                        (size_t) hdr[2*i+1], Bat->userData) != 0)
+                retval = PMPIO_BATON_ERR;
+            held -= (size_t) (hdr[2*i] + hdr[2*i+1]);
+            free(rbuf[i]);
+            rbuf[i] = 0;
+        }
+
+        if (file)
+            Bat->closeCb(file, Bat->userData);
+        free(hdr);
+        free(req);
+        free(rbuf);
+    }
+
+    Bat->mpiVal = retval;
+    return retval;
+}
+
 /*-----------------------------------------------------------------------------
  * Audience:    Public
  * Chapter:     Ranking 
@@ -485,6 +686,499 @@ PMPIO_RankInGroup(const PMPIO_baton_t *Bat, int rankInComm)
     return retval;
 }
 
+/*-----------------------------------------------------------------------------
+ * Audience:    Public
+ * Chapter:     Auto Tuning
+ * Purpose:     Results of choosing the number of files
+ * Description:
+ * Filled in by PMPIO_AutoNumFiles(). Log it to see how the number of files
+ * was chosen. Throughputs are aggregate bytes per second over all
+ * processors, or zero for candidates read from a profile without one.
+ *-----------------------------------------------------------------------------
+ */
+#define PMPIO_MAX_CANDIDATES 16
+
+typedef struct _PMPIO_autotune_t
+{
+    int commSize;                               /* Processors tuned for */
+    int numFiles;                               /* The chosen number of files */
+    int fromProfile;                            /* Non-zero if read from a profile */
+    int numCandidates;
+    int candidates[PMPIO_MAX_CANDIDATES];       /* Numbers of files tried */
+    double throughput[PMPIO_MAX_CANDIDATES];    /* Bytes/second for each */
+} PMPIO_autotune_t;
+
+static void *
+PMPIO_ProbeCreate(const char *fname, const char *nsname, void *udata)
+{
+    return (void *) fopen(fname, "wb");
+}
+
+static void *
+PMPIO_ProbeOpen(const char *fname, const char *nsname, PMPIO_iomode_t ioMode, void *udata)
+{
+    return (void *) fopen(fname, "ab");
+}
+
+static void
+PMPIO_ProbeClose(void *file, void *udata)
+{
+    FILE *f = (FILE *) file;
+    if (!f)
+        return;
+    fflush(f);
+#ifndef _WIN32
+    fsync(fileno(f));
+#endif
+    fclose(f);
+}
+
+/* Find the last line of the profile for commSize. Line format is...
+   commSize numFiles numCandidates candidate throughput ... */
+static int
+PMPIO_ReadProfile(const char *profile, int commSize, PMPIO_autotune_t *info)
+{
+    char line[1024];
+    int found = 0;
+    FILE *f = profile ? fopen(profile, "r") : 0;
+
+    if (!f)
+        return 0;
+    while (fgets(line, sizeof(line), f))
+    {
+        PMPIO_autotune_t tmp;
+        char *p = line, *q;
+        int i;
+
+        memset(&tmp, 0, sizeof(tmp));
+        if (line[0] == '#')
+            continue;
+        tmp.commSize = (int) strtol(p, &q, 10);
+        if (q == p || tmp.commSize != commSize) continue;
+        p = q;
+        tmp.numFiles = (int) strtol(p, &q, 10);
+        if (q == p || tmp.numFiles < 1 || tmp.numFiles > commSize) continue;
+        p = q;
+        tmp.numCandidates = (int) strtol(p, &q, 10);
+        if (q == p || tmp.numCandidates < 0) continue;
+        p = q;
+        if (tmp.numCandidates > PMPIO_MAX_CANDIDATES)
+            tmp.numCandidates = PMPIO_MAX_CANDIDATES;
+        for (i = 0; i < tmp.numCandidates; i++)
+        {
+            tmp.candidates[i] = (int) strtol(p, &q, 10);
+            if (q == p) break;
+            p = q;
+            tmp.throughput[i] = strtod(p, &q);
+            if (q == p) break;
+            p = q;
+        }
+        tmp.numCandidates = i;
+        tmp.fromProfile = 1;
+        *info = tmp;
+        found = 1;
+    }
+    fclose(f);
+    return found;
+}
+
+/*-----------------------------------------------------------------------------
+ * Audience:    Public
+ * Chapter:     Auto Tuning
+ * Purpose:     Choose the number of files to pass to PMPIO_Init()
+ * Description:
+ * If profile names a file with an entry for the size of mpiComm, the number
+ * of files is taken from it. Otherwise, a short write probe is run. For each
+ * candidate number of files, every processor writes probeBytes with the
+ * baton passing pattern of PMPIO_WaitForBaton() and PMPIO_HandOffBaton()
+ * to files in probeDir. The candidate with the highest aggregate throughput
+ * is chosen, the probe files are removed and, if profile is given, the
+ * result is appended to it so later runs on the same file system and
+ * processor count need not probe again.
+ *
+ * The candidates default to powers of two from 1 to the size of mpiComm.
+ * All processors must call this function with identical arguments. It
+ * returns the chosen number of files on all processors and, if info is not
+ * NULL, fills it in with the candidates and their measured throughputs.
+ *-----------------------------------------------------------------------------
+ */
+static int
+PMPIO_AutoNumFiles(
+    MPI_Comm mpiComm,           /* The MPI communicator that will be passed to PMPIO_Init() */
+    int mpiTag,                 /* The message tag to use for probe baton passing. */
+    const char *probeDir,       /* Directory for the probe files. Pass 0 for the current
+                                   directory. It should be on the file system to be tuned for. */
+    const char *profile,        /* Optional, the name of a profile file to read and update. */
+    const int *candidates,      /* Optional, the numbers of files to try. */
+    int numCandidates,          /* The number of candidates. */
+    size_t probeBytes,          /* Bytes each processor writes for each candidate. Pass 0
+                                   for the default of 1 megabyte. */
+    PMPIO_autotune_t *info      /* Optional, returns how the number of files was chosen. */
+)
+{
+    PMPIO_autotune_t res;
+    int commSize, rankInComm, i, best = 0;
+    char *buf;
+
+    MPI_Comm_size(mpiComm, &commSize);
+    MPI_Comm_rank(mpiComm, &rankInComm);
+
+    memset(&res, 0, sizeof(res));
+    res.commSize = commSize;
+
+    /* A persisted profile saves the probe */
+    if (rankInComm == 0)
+        PMPIO_ReadProfile(profile, commSize, &res);
+    MPI_Bcast(&res, (int) sizeof(res), MPI_BYTE, 0, mpiComm);
+    if (res.fromProfile)
+    {
+        if (info)
+            *info = res;
+        return res.numFiles;
+    }
+
+    if (candidates && numCandidates > 0)
+    {
+        for (i = 0; i < numCandidates && res.numCandidates < PMPIO_MAX_CANDIDATES; i++)
+            if (candidates[i] >= 1 && candidates[i] <= commSize)
+                res.candidates[res.numCandidates++] = candidates[i];
+    }
+    else
+    {
+        for (i = 1; i <= commSize && res.numCandidates < PMPIO_MAX_CANDIDATES; i *= 2)
+            res.candidates[res.numCandidates++] = i;
+        if (res.candidates[res.numCandidates-1] != commSize &&
+            res.numCandidates < PMPIO_MAX_CANDIDATES)
+            res.candidates[res.numCandidates++] = commSize;
+    }
+    if (res.numCandidates == 0)
+        res.candidates[res.numCandidates++] = 1;
+
+    if (probeBytes == 0)
+        probeBytes = 1<<20;
+    buf = (char *) malloc(probeBytes);
+    memset(buf, rankInComm & 0xFF, probeBytes);
+
+    for (i = 0; i < res.numCandidates; i++)
+    {
+        PMPIO_baton_t *bat = PMPIO_Init(res.candidates[i], PMPIO_WRITE, mpiComm,
+            mpiTag, PMPIO_ProbeCreate, PMPIO_ProbeOpen, PMPIO_ProbeClose, 0);
+        char fname[1024];
+        double t0, t, tmax;
+        FILE *f;
+
+        snprintf(fname, sizeof(fname), "%s%spmpio_probe_%03d_%03d",
+            probeDir ? probeDir : "", probeDir ? "/" : "", i, bat->groupRank);
+
+        MPI_Barrier(mpiComm);
+        t0 = MPI_Wtime();
+        f = (FILE *) PMPIO_WaitForBaton(bat, fname, 0);
+        if (f)
+            fwrite(buf, 1, probeBytes, f);
+        PMPIO_HandOffBaton(bat, f);
+        t = MPI_Wtime() - t0;
+        MPI_Allreduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, mpiComm);
+
+        res.throughput[i] = tmax > 0 ? (double) probeBytes * commSize / tmax : 0;
+        if (res.throughput[i] > res.throughput[best])
+            best = i;
+
+        if (bat->rankInGroup == 0)
+            remove(fname);
+        PMPIO_Finish(bat);
+    }
+    free(buf);
+
+    res.numFiles = res.candidates[best];
+
+    if (rankInComm == 0 && profile)
+    {
+        FILE *f = fopen(profile, "a");
+        if (f)
+        {
+            fprintf(f, "%d %d %d", res.commSize, res.numFiles, res.numCandidates);
+            for (i = 0; i < res.numCandidates; i++)
+                fprintf(f, " %d %.6g", res.candidates[i], res.throughput[i]);
+            fprintf(f, "\n");
+            fclose(f);
+        }
+    }
+
+    if (info)
+        *info = res;
+    return res.numFiles;
+}
+
+/*-----------------------------------------------------------------------------
+ * Audience:    Public
+ * Chapter:     Restart Reads
+ * Purpose:     Plan for reading domains on a different number of processors
+ * Description:
+ * Made by PMPIO_PlanRead(). owner[] gives the processor assigned each
+ * domain, or -1 for a domain with no file. This processor's domains are
+ * myDomains[], ordered by file, and reading them opens myNumFiles files.
+ *-----------------------------------------------------------------------------
+ */
+typedef struct _PMPIO_readplan_t
+{
+    int numDomains;
+    int *owner;
+    int myNumDomains;
+    int *myDomains;
+    int myNumFiles;
+    char **fnames;
+    char **nsnames;
+} PMPIO_readplan_t;
+
+/*-----------------------------------------------------------------------------
+ * Audience:    Public
+ * Chapter:     Read Domain Callback
+ * Description:
+ * Defines the read domain callback interface used by PMPIO_ExecuteRead().
+ * It is called once for each domain assigned to the processor with the file
+ * containing it already open. It should set the file to the namespace nsname
+ * and read the domain.
+ *
+ *     typedef int (*PMPIO_ReadDomainCallBack)(
+ *         void *file,         pointer to the open file object
+ *         const char *nsname, namespace of the domain in the file
+ *         int domain,         index of the domain
+ *         void *udata         optional user data passed by PMPIO
+ *     );
+ *
+ * It should return 0 on success.
+ *-----------------------------------------------------------------------------
+ */
+typedef int (*PMPIO_ReadDomainCallBack)(void *file, const char *nsname, int domain,
+                                        void *udata);
+
+/* A domain of the read plan, with the index of the first domain in its file */
+typedef struct _PMPIO_domref_t
+{
+    const char *fname;
+    int index;
+    int first;
+} PMPIO_domref_t;
+
+static int
+PMPIO_CompareByName(const void *a, const void *b)
+{
+    const PMPIO_domref_t *x = (const PMPIO_domref_t *) a, *y = (const PMPIO_domref_t *) b;
+    int c = strcmp(x->fname, y->fname);
+    return c ? c : x->index - y->index;
+}
+
+static int
+PMPIO_CompareByFirst(const void *a, const void *b)
+{
+    const PMPIO_domref_t *x = (const PMPIO_domref_t *) a, *y = (const PMPIO_domref_t *) b;
+    return x->first != y->first ? x->first - y->first : x->index - y->index;
+}
+
+/*-----------------------------------------------------------------------------
+ * Audience:    Public
+ * Chapter:     Restart Reads
+ * Purpose:     Assign domains to processors for reading
+ * Description:
+ * Given the inventory of domains, that is, the file and namespace of each,
+ * assigns the domains to the processors of mpiComm, independent of how many
+ * processors wrote them. The inventory is needed only on processor 0 of
+ * mpiComm, which broadcasts it.
+ *
+ * Domains are ordered by file, in order of first appearance, and then by
+ * index. This order is cut into one contiguous piece per processor of about
+ * equal total cost. So, each processor opens as few files as possible and
+ * each file is opened by as few processors as possible, while the work is
+ * balanced. A domain whose file name is NULL, such as an "EMPTY" block, is
+ * not assigned.
+ *
+ * All processors must call this function. Free the plan with
+ * PMPIO_FreeReadPlan().
+ *-----------------------------------------------------------------------------
+ */
+static PMPIO_readplan_t *
+PMPIO_PlanRead(
+    MPI_Comm mpiComm,           /* The MPI communicator of the processors to read with. */
+    int numDomains,             /* The number of domains (processor 0 only). */
+    const char * const *fnames, /* The file name of each domain (processor 0 only). */
+    const char * const *nsnames,/* The namespace of each domain (processor 0 only). */
+    const double *costs         /* Optional, the relative cost of reading each domain
+                                   (processor 0 only). Pass 0 for equal costs. */
+)
+{
+    PMPIO_readplan_t *plan;
+    PMPIO_domref_t *refs;
+    int commSize, rankInComm, i, j, n, prev = -1;
+    int *fileOf;
+    double *cost, total = 0, cum = 0;
+    long long len = 0;
+    char *pack = 0, *p;
+
+    MPI_Comm_size(mpiComm, &commSize);
+    MPI_Comm_rank(mpiComm, &rankInComm);
+
+    /* Broadcast the inventory as one buffer of NUL terminated names */
+    if (rankInComm == 0)
+    {
+        for (i = 0; i < numDomains; i++)
+            len += (fnames[i] ? strlen(fnames[i]) : 0) + 1 +
+                   (nsnames[i] ? strlen(nsnames[i]) : 0) + 1;
+    }
+    MPI_Bcast(&numDomains, 1, MPI_INT, 0, mpiComm);
+    MPI_Bcast(&len, 1, MPI_LONG_LONG, 0, mpiComm);
+    n = numDomains > 0 ? numDomains : 1;
+    pack = (char *) malloc((size_t) len + 1);
+    cost = (double *) malloc(n * sizeof(double));
+    if (rankInComm == 0)
+    {
+        for (p = pack, i = 0; i < numDomains; i++)
+        {
+            strcpy(p, fnames[i] ? fnames[i] : "");
+            p += strlen(p) + 1;
+            strcpy(p, nsnames[i] ? nsnames[i] : "");
+            p += strlen(p) + 1;
+            cost[i] = costs && costs[i] > 0 ? costs[i] : (costs ? 0 : 1);
+        }
+    }
+    MPI_Bcast(pack, (int) len, MPI_CHAR, 0, mpiComm);
+    MPI_Bcast(cost, numDomains, MPI_DOUBLE, 0, mpiComm);
+
+    plan = (PMPIO_readplan_t *) calloc(1, sizeof(PMPIO_readplan_t));
+    plan->numDomains = numDomains;
+    plan->owner = (int *) malloc(n * sizeof(int));
+    plan->myDomains = (int *) malloc(n * sizeof(int));
+    plan->fnames = (char **) calloc(n, sizeof(char *));
+    plan->nsnames = (char **) calloc(n, sizeof(char *));
+    fileOf = (int *) malloc(n * sizeof(int));
+    refs = (PMPIO_domref_t *) malloc(n * sizeof(PMPIO_domref_t));
+
+    for (n = 0, p = pack, i = 0; i < numDomains; i++)
+    {
+        fileOf[i] = -1;
+        if (*p)
+        {
+            plan->fnames[i] = strdup(p);
+            refs[n].fname = plan->fnames[i];
+            refs[n++].index = i;
+            total += cost[i];
+        }
+        p += strlen(p) + 1;
+        plan->nsnames[i] = strdup(p);
+        p += strlen(p) + 1;
+        plan->owner[i] = -1;
+    }
+
+    /* Order by file, in order of first appearance, then index. Sorting by
+       name groups the domains of each file with its first domain leading. */
+    qsort(refs, n, sizeof(PMPIO_domref_t), PMPIO_CompareByName);
+    for (i = 0; i < n; i++)
+        refs[i].first = i > 0 && !strcmp(refs[i].fname, refs[i-1].fname) ?
+                        refs[i-1].first : refs[i].index;
+    qsort(refs, n, sizeof(PMPIO_domref_t), PMPIO_CompareByFirst);
+    for (i = 0, j = -1; i < n; i++)
+    {
+        if (i == 0 || refs[i].first != refs[i-1].first)
+            j++;
+        fileOf[refs[i].index] = j;
+    }
+
+    /* Cut into pieces of equal cost. Each domain goes to the processor its
+       cost midpoint falls in. */
+    for (i = 0; i < n; i++)
+    {
+        int d = refs[i].index;
+        int r = total > 0 ? (int) ((cum + cost[d] / 2) * commSize / total) : 0;
+        if (r >= commSize)
+            r = commSize - 1;
+        plan->owner[d] = r;
+        cum += cost[d];
+        if (r == rankInComm)
+        {
+            plan->myDomains[plan->myNumDomains++] = d;
+            if (fileOf[d] != prev)
+                plan->myNumFiles++;
+            prev = fileOf[d];
+        }
+    }
+
+    free(pack);
+    free(cost);
+    free(fileOf);
+    free(refs);
+    return plan;
+}
+
+/*-----------------------------------------------------------------------------
+ * Audience:    Public
+ * Chapter:     Restart Reads
+ * Purpose:     Read this processor's domains of a read plan
+ * Description:
+ * Opens each file with this processor's domains once, with the open file
+ * callback in PMPIO_READ mode and a NULL namespace, calls readCb for each of
+ * its domains in the file and closes it with the close file callback. There
+ * is no baton. All processors read concurrently.
+ *
+ * Returns PMPIO_BATON_OK if all files were opened and all readCb calls
+ * succeeded, PMPIO_BATON_ERR otherwise.
+ *-----------------------------------------------------------------------------
+ */
+static int
+PMPIO_ExecuteRead(
+    const PMPIO_readplan_t *plan,       /* The plan obtained from PMPIO_PlanRead(). */
+    PMPIO_OpenFileCallBack openCb,      /* Opens a file for reading. */
+    PMPIO_ReadDomainCallBack readCb,    /* Reads a domain from the open file. */
+    PMPIO_CloseFileCallBack closeCb,    /* Closes a file. */
+    void *userData                      /* Optional, user data passed to the callbacks. */
+)
+{
+    int i, retval = PMPIO_BATON_OK;
+    const char *curName = 0;
+    void *file = 0;
+
+    for (i = 0; i < plan->myNumDomains; i++)
+    {
+        int d = plan->myDomains[i];
+        if (!curName || strcmp(curName, plan->fnames[d]))
+        {
+            if (file)
+                closeCb(file, userData);
+            curName = plan->fnames[d];
+            file = openCb(curName, 0, PMPIO_READ, userData);
+        }
+        if (!file || readCb(file, plan->nsnames[d], d, userData) != 0)
+            retval = PMPIO_BATON_ERR;
+    }
+    if (file)
+        closeCb(file, userData);
+    return retval;
+}
+
+/*-----------------------------------------------------------------------------
+ * Audience:    Public
+ * Chapter:     Restart Reads
+ * Purpose:     Free a read plan
+ *-----------------------------------------------------------------------------
+ */
+static void
+PMPIO_FreeReadPlan(
+    PMPIO_readplan_t *plan
+)
+{
+    int i;
+    if (!plan)
+        return;
+    for (i = 0; i < plan->numDomains; i++)
+    {
+        free(plan->fnames[i]);
+        free(plan->nsnames[i]);
+    }
+    free(plan->fnames);
+    free(plan->nsnames);
+    free(plan->owner);
+    free(plan->myDomains);
+    free(plan);
+}
+
 /* Define this Default PMPIO functions only if we have silo.h. We use existence
 of 'DB_HDF5' as indication that silo.h is present. */
 #ifdef DB_HDF5X
@@ -549,6 +1243,73 @@ PMPIO_DefaultClose(void *file, void *userData)
     if (siloFile)
         DBClose(siloFile);
 }
+
+/*-----------------------------------------------------------------------------
+ * Audience:    Public
+ * Chapter:     Restart Reads
+ * Purpose:     Make the domain inventory for PMPIO_PlanRead from a multimesh
+ *
+ * Description: Splits each block name of the multimesh, read from the file
+ * named rootName, into the file and the directory holding the block. Files
+ * are relative to the directory of rootName, as in the block names. Blocks
+ * without a file part are in rootName itself and "EMPTY" blocks get a NULL
+ * file name. Returns the number of blocks, or -1 if the multimesh has no
+ * explicit block names. Free each name and the arrays with free().
+ *-----------------------------------------------------------------------------
+ */
+static int
+PMPIO_SiloDomainInventory(const char *rootName, const DBmultimesh *mm,
+    char ***fnames, char ***nsnames)
+{
+    const char *slash = strrchr(rootName, '/');
+    int i, dirlen = slash ? (int) (slash - rootName) + 1 : 0;
+
+    if (!mm || !mm->meshnames)
+        return -1;
+    *fnames = (char **) calloc(mm->nblocks > 0 ? mm->nblocks : 1, sizeof(char *));
+    *nsnames = (char **) calloc(mm->nblocks > 0 ? mm->nblocks : 1, sizeof(char *));
+    for (i = 0; i < mm->nblocks; i++)
+    {
+        const char *name = mm->meshnames[i];
+        const char *colon = strchr(name, ':');
+        const char *path = colon ? colon + 1 : name;
+        const char *last = strrchr(path, '/');
+
+        if (!strcmp(name, "EMPTY"))
+        {
+            (*nsnames)[i] = strdup("");
+            continue;
+        }
+        if (colon && name[0] != '/')
+        {
+            (*fnames)[i] = (char *) malloc(dirlen + (colon - name) + 1);
+            memcpy((*fnames)[i], rootName, dirlen);
+            memcpy((*fnames)[i] + dirlen, name, colon - name);
+            (*fnames)[i][dirlen + (colon - name)] = '\0';
+        }
+        else if (colon)
+        {
+            (*fnames)[i] = (char *) malloc((colon - name) + 1);
+            memcpy((*fnames)[i], name, colon - name);
+            (*fnames)[i][colon - name] = '\0';
+        }
+        else
+        {
+            (*fnames)[i] = strdup(rootName);
+        }
+        if (last && last != path)
+        {
+            (*nsnames)[i] = (char *) malloc((last - path) + 1);
+            memcpy((*nsnames)[i], path, last - path);
+            (*nsnames)[i][last - path] = '\0';
+        }
+        else
+        {
+            (*nsnames)[i] = strdup("/");
+        }
+    }
+    return mm->nblocks;
+}
 #endif
 
 #endif
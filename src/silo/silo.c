@@ -81,6 +81,7 @@ be used for advertising or product endorsement purposes.
                        Also for SDX driver detection.  */
 #include <stdio.h>
 #include <float.h>
+#include <limits.h>
 #include <math.h>
 #if HAVE_STDLIB_H
 #include <stdlib.h>         /* For abort(). */
@@ -120,6 +121,10 @@ be used for advertising or product endorsement purposes.
 #endif
 
 #include <stdarg.h>
+#include <time.h>           /* for clock_gettime */
+#if HAVE_SYS_TIME_H
+#include <sys/time.h>       /* for gettimeofday */
+#endif
 
 /* DB_MAIN must be defined before including silo_private.h. */
 #define DB_MAIN
@@ -301,6 +306,12 @@ SILO_Globals_t SILO_Globals = {
     0,     /* compressionParams (null) */
     2.0,   /* compressionMinratio */
     0,     /* compressionErrmode (fallback) */
+    0,     /* dedupParams (null) */
+    DB_FLOAT_STORAGE_NATIVE, /* floatStorage */
+    0,     /* allocFunc (malloc) */
+    0,     /* freeFunc (free) */
+    0,     /* allocUser */
+    0,     /* arena */
     0,     /* compatability mode */
     {      /* file options sets [32 of them] */
         0, 0, 0, 0, 0, 0, 0, 0,
@@ -2547,6 +2558,7 @@ DB_SETGET(int, DeprecateWarnings, maxDeprecateWarnings, DB_INTBOOL_NOT_SET)
 DB_SETGET(int, AllowLongStrComponents, allowLongStrComponents, DB_INTBOOL_NOT_SET) 
 DB_SETGET(unsigned long long, DataReadMask2, dataReadMask, DB_MASK_NOT_SET) 
 DB_SETGET(int, CompatibilityMode, compatibilityMode, DB_INTBOOL_NOT_SET)
+DB_SETGET(int, FloatStorage, floatStorage, DB_INTBOOL_NOT_SET)
 #ifndef _WIN32
 #warning WHAT ABOUT FORCESINGLE SHOWERRORS
 #endif
@@ -2622,4422 +2634,6243 @@ DBGetCompressionFile(DBfile *f)
     return db_SetGetCompressionFile(f, 0, 0);
 }
 
-PUBLIC int
-DBFreeCompressionResources(DBfile *dbfile, const char *meshname)
+/* Deduplication params are a string property like compression params
+   except that an empty string means 'enabled with default settings' */
+static void _db_set_dedup_params(char **dst, char const *s)
 {
-    int retval = 0;
+    if (*dst && *dst != DB_CHAR_PTR_NOT_SET)
+        FREE(*dst);
+    *dst = 0;
+    if (s)
+    {
+        *dst = ALLOC_N(char,strlen(s)+1);
+        strcpy(*dst, s);
+    }
+}
 
-    API_BEGIN2("DBFreeCompressionResources", int, -1, api_dummy) {
+/*----------------------------------------------------------------------
+ * Routine:  DBSetDeduplication
+ *
+ * Purpose:  Set the content-hash deduplication options for array data.
+ *
+ * Description:  A NULL string disables deduplication. An empty string
+ *    enables it with default settings. Otherwise, the string is a
+ *    space separated list of KEY=VALUE pairs. Currently, only the HDF5
+ *    driver honors these settings.
+ *--------------------------------------------------------------------*/
+PUBLIC void
+DBSetDeduplication(char const *s)
+{
+    _db_set_dedup_params(&SILO_Globals.dedupParams, s);
+}
 
-        if (!dbfile->pub.free_z)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
-        retval = ((dbfile->pub.free_z) (dbfile, meshname));
+PUBLIC char const * 
+DBGetDeduplication()
+{
+    return SILO_Globals.dedupParams;
+}
 
+static char const *db_SetGetDeduplicationFile(DBfile *f, char const *val, int set)
+{
+    char const *retval;
+    API_BEGIN("DB(Set|Get)DeduplicationFile", char const *, 0) {
+        if (!f)
+            API_ERROR("DBfile*", E_BADARGS);
+        if (set)
+            _db_set_dedup_params(&(f->pub.file_scope_globals->dedupParams), val);
+        retval = f->pub.file_scope_globals->dedupParams;
+        if (retval == DB_CHAR_PTR_NOT_SET)
+            retval = DBGetDeduplication();
         API_RETURN(retval);
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    API_END_NOPOP;
 }
 
-#define CHECK_FOR_FRIENDLY(ON,SU)					\
-    ntotal += toc->n ## ON;						\
-    for (i = 0; i < toc->n ## ON; i++)					\
-    {									\
-        char tmp[1024];							\
-        snprintf(tmp, sizeof(tmp), "%s_%s", toc->ON ## _names[i], SU);	\
-        if (DBInqVarExists(f, tmp))					\
-            nfriendly++;						\
-    }
+PUBLIC void
+DBSetDeduplicationFile(DBfile *f, char const *s)
+{
+    db_SetGetDeduplicationFile(f, s, 1);
+}
+
+PUBLIC char const * 
+DBGetDeduplicationFile(DBfile *f)
+{
+    return db_SetGetDeduplicationFile(f, 0, 0);
+}
 
 /*----------------------------------------------------------------------
- * Routine:  db_guess_has_friendly_HDF5_names_r 
+ * Routine:  DBSetAllocator
  *
- * Purpose:  Recursive helper func for DBGuessHasFriendlyHDF5Names 
- *           names.
- *
- * Programmer: Mark C. Miller, Wed Sep  2 15:27:06 PDT 2009
+ * Purpose:  Set the allocator for the memory of objects returned by
+ *    DBGetXxx calls.
  *
+ * Description:  ALLOC is called as alloc(nbytes, user) for the object
+ *    structs and the (large) data arrays of objects returned by DBGetXxx
+ *    calls. The memory is handed back via free(ptr, user) by the DBFreeXxx
+ *    calls. A NULL alloc restores malloc/free. The file-level variant
+ *    overrides the global setting for one file.
  *--------------------------------------------------------------------*/
-PRIVATE int
-db_guess_has_friendly_HDF5_names_r(DBfile *f)
+PUBLIC int
+DBSetAllocator(DBAllocFunc alloc, DBFreeFunc free, void *user)
 {
-    int i, ntotal = 0, nfriendly = 0;
-    int retval;
-    DBtoc *toc;
-
-    toc = DBGetToc(f);
-
-    if (!toc) return 0;
-
-    CHECK_FOR_FRIENDLY(multimesh, "meshnames");
-    CHECK_FOR_FRIENDLY(multivar, "varnames");
-    CHECK_FOR_FRIENDLY(multimat, "matnames");
-    CHECK_FOR_FRIENDLY(qmesh, "coord0");
-    CHECK_FOR_FRIENDLY(qvar, "data");
-    CHECK_FOR_FRIENDLY(ucdmesh, "coord0");
-    CHECK_FOR_FRIENDLY(ucdvar, "data");
-    CHECK_FOR_FRIENDLY(ptmesh, "coord0");
-    CHECK_FOR_FRIENDLY(ptvar, "data");
-    CHECK_FOR_FRIENDLY(csgmesh, "_coeffs");
-    CHECK_FOR_FRIENDLY(csgvar, "data");
-    CHECK_FOR_FRIENDLY(mat, "_matlist");
-    CHECK_FOR_FRIENDLY(matspecies, "_speclist");
-    CHECK_FOR_FRIENDLY(curve, "_yvals");
-    CHECK_FOR_FRIENDLY(obj, "_nodelist");
-
-    if (ntotal >= 3) /* arb. min of 3 objects */
-    {
-        if (nfriendly >= ntotal/2)
-            return 1;
-        else
-            return 0;
+    API_BEGIN("DBSetAllocator", int, -1) {
+        if ((alloc && !free) || (!alloc && free))
+            API_ERROR("alloc/free", E_BADARGS);
+        SILO_Globals.allocFunc = alloc;
+        SILO_Globals.freeFunc = free;
+        SILO_Globals.allocUser = alloc ? user : 0;
+        API_RETURN(0);
     }
+    API_END_NOPOP;
+}
 
-    retval = -1;
-    for (i = 0; i < toc->ndir && retval == -1; i++)
-    {
-        DBSetDir(f, toc->dir_names[i]);
-        retval = db_guess_has_friendly_HDF5_names_r(f);
-        DBSetDir(f, "..");
+PUBLIC int
+DBSetAllocatorFile(DBfile *f, DBAllocFunc alloc, DBFreeFunc free, void *user)
+{
+    API_BEGIN("DBSetAllocatorFile", int, -1) {
+        if (!f)
+            API_ERROR("DBfile*", E_BADARGS);
+        if ((alloc && !free) || (!alloc && free))
+            API_ERROR("alloc/free", E_BADARGS);
+        f->pub.file_scope_globals->allocFunc = alloc;
+        f->pub.file_scope_globals->freeFunc = free;
+        f->pub.file_scope_globals->allocUser = alloc ? user : 0;
+        API_RETURN(0);
     }
-
-    return retval;
+    API_END_NOPOP;
 }
 
 /*----------------------------------------------------------------------
- * Routine:  DBGuessHasFriendlyHDF5Names
- *
- * Purpose:  Determine if it looks like a given file has HDF5 friendly 
- *           names.
+ * Routine:  DBSetArena
  *
- * Programmer: Mark C. Miller, Wed Sep  2 15:27:06 PDT 2009
+ * Purpose:  Set the arena from which the objects returned by DBGetXxx
+ *    calls are allocated and return the previous one.
  *
+ * Description:  While an arena is set, it takes precedence over any
+ *    allocator set with DBSetAllocator. A NULL arena turns arena
+ *    allocation off. The file-level variant overrides the global setting
+ *    for one file.
  *--------------------------------------------------------------------*/
-PUBLIC int
-DBGuessHasFriendlyHDF5Names(DBfile *f)
+PUBLIC DBarena *
+DBSetArena(DBarena *arena)
 {
-    char cwd[1024];
-    int retval;
+    DBarena *old = SILO_Globals.arena;
+    SILO_Globals.arena = arena;
+    return old;
+}
 
-#ifdef DB_HDF5X
-    if (DBGetDriverType(f) != DB_HDF5X)
-        return 0;
-#endif
+PUBLIC DBarena *
+DBGetArena(void)
+{
+    return SILO_Globals.arena;
+}
 
-    DBGetDir(f, cwd);
-    retval = db_guess_has_friendly_HDF5_names_r(f);
-    DBSetDir(f, cwd);    
+static DBarena *db_SetGetArenaFile(DBfile *f, DBarena *arena, int set)
+{
+    DBarena *retval;
+    API_BEGIN("DB(Set|Get)ArenaFile", DBarena *, 0) {
+        if (!f)
+            API_ERROR("DBfile*", E_BADARGS);
+        retval = f->pub.file_scope_globals->arena;
+        if (set)
+            f->pub.file_scope_globals->arena = arena;
+        if (retval == DB_VOID_PTR_NOT_SET)
+            retval = DBGetArena();
+        API_RETURN(retval);
+    }
+    API_END_NOPOP;
+}
 
-    return retval;
+PUBLIC DBarena *
+DBSetArenaFile(DBfile *f, DBarena *arena)
+{
+    return db_SetGetArenaFile(f, arena, 1);
+}
+
+PUBLIC DBarena *
+DBGetArenaFile(DBfile *f)
+{
+    return db_SetGetArenaFile(f, 0, 0);
 }
 
 /*----------------------------------------------------------------------
- * Routine:  DBSetUnknownDriverPriority
+ * I/O statistics and tracing.
  *
- * Purpose:  Set priority order of drivers used by unknown driver. 
+ * The outermost API call in progress is timed, and the drivers add the
+ * bytes it moves and the datasets it creates to it via db_stats_read,
+ * db_stats_write, db_stats_dataset and db_stats_filter. When the call
+ * returns, it is added to the entry for its name in the table of its
+ * file and, if a trace file is open, written to it as a trace event.
+ *--------------------------------------------------------------------*/
+typedef struct db_stats_t {
+    int            ncalls;
+    int            maxcalls;
+    DBcallstats   *calls;
+} db_stats_t;
+
+PRIVATE db_stats_t *_db_stats[DB_NFILES];   /*per file call statistics */
+PRIVATE struct {
+    unsigned long  id;          /*number of the outermost API call */
+    int            active;      /*an API call is being timed */
+    int            fileid;      /*its file, or -1 */
+    double         start;       /*clock when it began */
+    DBcallstats    io;          /*what it has done so far */
+    char           file[256];   /*its file name, escaped for the trace */
+} _db_stats_call;
+PRIVATE FILE *_db_trace = NULL;             /*trace event file */
+PRIVATE int _db_trace_nevents = 0;
+
+/*----------------------------------------------------------------------
+ * Routine:  db_stats_clock
  *
- * Programmer:  Mark C. Miller, May 1, 2006 
+ * Purpose:  Return wall clock time in seconds for timing calls.
+ *--------------------------------------------------------------------*/
+INTERNAL double
+db_stats_clock(void)
+{
+#if defined(_WIN32)
+    return (double) clock() / CLOCKS_PER_SEC;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec + 1e-6 * tv.tv_usec;
+#endif
+}
+
+/*----------------------------------------------------------------------
+ * Routine:  db_stats_objtype
  *
- * Description:  This routine sets the flag that controls whether
- *               checksums are computed on client data.
+ * Purpose:  Return the object type an API call handles, judged from its
+ *    name, or DB_INVALID_OBJECT.
  *--------------------------------------------------------------------*/
-PUBLIC int const * 
-DBSetUnknownDriverPriorities(const int *priorities)
+static int
+db_stats_objtype(char const *name)
 {
-    int i = 0;
-    static int oldPriorities[MAX_FILE_OPTIONS_SETS+DB_NFORMATS+1];
-    memcpy(oldPriorities, SILO_Globals.unknownDriverPriorities, sizeof(oldPriorities));
-    while (i < (MAX_FILE_OPTIONS_SETS+DB_NFORMATS+1) && priorities[i] >= 0)
+    /* longer stems before the stems they begin with */
+    static struct {char const *stem; int type;} const types[] = {
+        {"Quadmesh", DB_QUADMESH},       {"Quadvar", DB_QUADVAR},
+        {"Ucdmesh", DB_UCDMESH},         {"Ucdvar", DB_UCDVAR},
+        {"Pointmesh", DB_POINTMESH},     {"Pointvar", DB_POINTVAR},
+        {"Csgmesh", DB_CSGMESH},         {"Csgvar", DB_CSGVAR},
+        {"CSGZonelist", DB_CSGZONELIST}, {"PHZonelist", DB_PHZONELIST},
+        {"Zonelist", DB_ZONELIST},       {"Facelist", DB_FACELIST},
+        {"Edgelist", DB_EDGELIST},       {"Multimeshadj", DB_MULTIMESHADJ},
+        {"Multimesh", DB_MULTIMESH},     {"Multivar", DB_MULTIVAR},
+        {"Multimatspecies", DB_MULTIMATSPECIES},
+        {"Multimat", DB_MULTIMAT},       {"Matspecies", DB_MATSPECIES},
+        {"Material", DB_MATERIAL},       {"Curve", DB_CURVE},
+        {"Compoundarray", DB_ARRAY},     {"Defvars", DB_DEFVARS},
+        {"Mrgtree", DB_MRGTREE},         {"Mrgvar", DB_MRGVAR},
+        {"Groupelmap", DB_GROUPELMAP},   {"Var", DB_VARIABLE}
+    };
+    size_t i;
+
+    if (!strncmp(name, "DBReadVar", 9) || !strncmp(name, "DBWrite", 7))
+        return strncmp(name, "DBWriteObject", 13) &&
+               strncmp(name, "DBWriteComponent", 16) ? DB_VARIABLE : DB_INVALID_OBJECT;
+    if (strncmp(name, "DBPut", 5) && strncmp(name, "DBGet", 5))
+        return DB_INVALID_OBJECT;
+    for (i = 0; i < sizeof(types)/sizeof(types[0]); i++)
     {
-        SILO_Globals.unknownDriverPriorities[i] = priorities[i];
-        i++;
+        if (!strncmp(name+5, types[i].stem, strlen(types[i].stem)))
+            return types[i].type;
     }
-    if (i < (MAX_FILE_OPTIONS_SETS+DB_NFORMATS+1))
-        SILO_Globals.unknownDriverPriorities[i] = -1;
-    return oldPriorities;
+    return DB_INVALID_OBJECT;
 }
 
-PUBLIC int const *
-DBGetUnknownDriverPriorities()
+/* the trace event category of a call is the type of object it handles */
+static char const *
+db_stats_category(char const *name)
 {
-    static int priorities[MAX_FILE_OPTIONS_SETS+DB_NFORMATS+1];
-    memcpy(priorities, SILO_Globals.unknownDriverPriorities, sizeof(priorities));
-    return priorities;
+    int type = db_stats_objtype(name);
+
+    if (type == DB_INVALID_OBJECT)
+        return "silo";
+    if (type == DB_VARIABLE)
+        return "variable";
+    return DBGetObjtypeName(type);
 }
 
-PUBLIC int
-DBRegisterFileOptionsSet(const DBoptlist *opts)
+/*----------------------------------------------------------------------
+ * Routine:  db_stats_entry
+ *
+ * Purpose:  Find or add the entry for the call NAME in the statistics
+ *    of file FILEID.
+ *
+ * Description:  Call names are the string literals of the API_BEGIN
+ *    macros, so they are first compared by address.
+ *--------------------------------------------------------------------*/
+static DBcallstats *
+db_stats_entry(int fileid, char const *name)
 {
+    db_stats_t *st = _db_stats[fileid];
+    DBcallstats *c;
     int i;
 
-    API_BEGIN("DBRegisterFileOptionsSet", int, -1) {
-        for (i = 0; i < MAX_FILE_OPTIONS_SETS; i++)
-        {
-            if (SILO_Globals.fileOptionsSets[i] == 0)
-            {
-                SILO_Globals.fileOptionsSets[i] = opts;
-                API_RETURN(i+NUM_DEFAULT_FILE_OPTIONS_SETS);
-            }
-        }
-        API_ERROR("Silo library", E_MAXFILEOPTSETS);
+    if (!st)
+    {
+        if (!(st = (db_stats_t *) calloc(1, sizeof(db_stats_t))))
+            return 0;
+        _db_stats[fileid] = st;
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    for (i = 0; i < st->ncalls; i++)
+        if (st->calls[i].name == name) return &st->calls[i];
+    for (i = 0; i < st->ncalls; i++)
+        if (!strcmp(st->calls[i].name, name)) return &st->calls[i];
+
+    if (st->ncalls == st->maxcalls)
+    {
+        int n = st->maxcalls ? 2 * st->maxcalls : 32;
+        DBcallstats *p = (DBcallstats *) realloc(st->calls, n * sizeof(DBcallstats));
+        if (!p) return 0;
+        st->calls = p;
+        st->maxcalls = n;
+    }
+    c = &st->calls[st->ncalls++];
+    memset(c, 0, sizeof(*c));
+    c->name = name;
+    c->objtype = db_stats_objtype(name);
+    return c;
 }
 
-PUBLIC int
-DBUnregisterFileOptionsSet(int opts_set_id)
+static void
+db_stats_add(DBcallstats *to, DBcallstats const *c)
 {
-    int _opts_set_id = opts_set_id-NUM_DEFAULT_FILE_OPTIONS_SETS;
-
-    API_BEGIN("DBUnregisterFileOptionsSet", int, -1) {
-        if (SILO_Globals.fileOptionsSets[_opts_set_id] == 0)
-            API_ERROR("opts_set_id", E_BADARGS);
-        SILO_Globals.fileOptionsSets[_opts_set_id] = 0;
-        API_RETURN(0);
-    }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    to->count += c->count;
+    to->seconds += c->seconds;
+    to->bytes_read += c->bytes_read;
+    to->bytes_written += c->bytes_written;
+    to->stored_read += c->stored_read;
+    to->stored_written += c->stored_written;
+    to->datasets += c->datasets;
+    to->filter_seconds += c->filter_seconds;
 }
 
-PUBLIC void
-DBUnregisterAllFileOptionsSets()
+/*----------------------------------------------------------------------
+ * Routine:  db_stats_begin
+ *
+ * Purpose:  Start timing the outermost API call NAME on DBFILE, which
+ *    may be NULL for calls not made on a file.
+ *
+ * Description:  Called by the API_BEGIN macros. Calls not made on a file
+ *    cost nothing unless they are traced.
+ *--------------------------------------------------------------------*/
+INTERNAL void
+db_stats_begin(DBfile *dbfile, char const *name)
 {
-    int i;
+    int fileid = dbfile ? dbfile->pub.fileid : -1;
 
-    for (i = 0; i < MAX_FILE_OPTIONS_SETS; i++)
-        SILO_Globals.fileOptionsSets[i] = 0;
+    _db_stats_call.id++;
+    if (fileid < 0 || fileid >= DB_NFILES)
+        fileid = -1;
+    _db_stats_call.active = fileid >= 0 || _db_trace;
+    if (!_db_stats_call.active)
+        return;
+    _db_stats_call.fileid = fileid;
+    memset(&_db_stats_call.io, 0, sizeof(_db_stats_call.io));
+    _db_stats_call.io.name = name;
+    _db_stats_call.io.count = 1;
+    _db_stats_call.file[0] = '\0';
+    if (_db_trace && dbfile)
+        db_stats_file(dbfile);
+    _db_stats_call.start = db_stats_clock();
 }
 
-const int* db_get_used_file_options_sets_ids()
+/*----------------------------------------------------------------------
+ * Routine:  db_stats_file
+ *
+ * Purpose:  Charge the call in progress to DBFILE, as DBOpen and DBCreate
+ *    do once they have made the file.
+ *--------------------------------------------------------------------*/
+INTERNAL void
+db_stats_file(DBfile *dbfile)
 {
-    int i,n;
-    static int used_slots[MAX_FILE_OPTIONS_SETS+NUM_DEFAULT_FILE_OPTIONS_SETS+1];
+    char const *s;
+    size_t n = 0;
 
-   
-    /* For the default cases, only return those that 'matter' in that
-       they could possibly have an impact on Silo's ability to actually
-       open the file. In addtion, put them in some kind of priority order */
-    n = 0;
-    used_slots[n++] = DB_FILE_OPTS_H5_DEFAULT_SILO;
-    used_slots[n++] = DB_FILE_OPTS_H5_DEFAULT_SPLIT;
-    used_slots[n++] = DB_FILE_OPTS_H5_DEFAULT_DIRECT;
-    used_slots[n++] = DB_FILE_OPTS_H5_DEFAULT_FAMILY;
-    used_slots[n++] = DB_FILE_OPTS_H5_DEFAULT_MPIO;
-    used_slots[n++] = DB_FILE_OPTS_H5_DEFAULT_MPIP;
-    for (i = n; i < MAX_FILE_OPTIONS_SETS+NUM_DEFAULT_FILE_OPTIONS_SETS+1; i++)
-        used_slots[i] = -1;
+    if (!_db_stats_call.active || !dbfile ||
+        dbfile->pub.fileid < 0 || dbfile->pub.fileid >= DB_NFILES)
+        return;
+    _db_stats_call.fileid = dbfile->pub.fileid;
 
-    /* fill in with used options set slots */
-    for (i = 0; i < MAX_FILE_OPTIONS_SETS; i++)
+    /* keep an escaped copy of the name for the trace event */
+    if (!_db_trace || !dbfile->pub.name)
+        return;
+    for (s = dbfile->pub.name; *s && n < sizeof(_db_stats_call.file) - 3; s++)
     {
-        if (SILO_Globals.fileOptionsSets[i]==0)
-            continue;
-        used_slots[n++] = i+NUM_DEFAULT_FILE_OPTIONS_SETS;
+        if (*s == '"' || *s == '\\')
+            _db_stats_call.file[n++] = '\\';
+        _db_stats_call.file[n++] = (unsigned char) *s < ' ' ? '?' : *s;
     }
-
-    return used_slots;
+    _db_stats_call.file[n] = '\0';
 }
 
 /*----------------------------------------------------------------------
- * Routine:  DBGrabDriver
- *
- * Purpose:  Set and return the low level driver file handle
- *
- * Programmer:  Thomas R. Treadway, Tue May 29 15:52:19 PDT 2007
- *
- * Description:  This routine returns a ponter to the driver-native
- * file handle.
+ * Routine:  db_stats_cancel
  *
- * Modifications
- *   Mark C. Miller, Thu Oct 11 15:36:10 PDT 2007
- *   Record fact file was grabbed by adding var at top-level
+ * Purpose:  Stop timing the call in progress without recording it.
  *--------------------------------------------------------------------*/
-PUBLIC void * 
-DBGrabDriver(DBfile *file)
+INTERNAL void
+db_stats_cancel(void)
 {
-    void *rtn = 0;
-    if (file) {
-       if (file->pub.GrabId > (void *) 0) {
-          int grab_val = 1;
-          DBWrite(file, "/_was_grabbed", &grab_val, &grab_val, 1, DB_INT);
-#ifndef _WIN32
-#warning FIX GLOBAL LOCK
-#endif
-          SILO_Globals.enableGrabDriver = TRUE;
-          rtn = (void *) file->pub.GrabId;
-       }
-    }
-    return rtn;
+    _db_stats_call.active = 0;
 }
+
 /*----------------------------------------------------------------------
- * Routine:  DBGetDriverType
- *
- * Purpose:  Return the drive type 
+ * Routine:  db_stats_end
  *
- * Programmer:  Thomas R. Treadway, Thu Jun  7 13:19:48 PDT 2007
+ * Purpose:  Record the call in progress, if any.
  *
- * Description:  This routine returns a the driver type
+ * Description:  Called by the API_END, API_RETURN and API_ERROR macros
+ *    and when unwinding an error out of an API call.
  *--------------------------------------------------------------------*/
-PUBLIC int
-DBGetDriverType(const DBfile *file)
+INTERNAL void
+db_stats_end(void)
 {
-    if (file) {
-       return file->pub.type;
+    DBcallstats *c = &_db_stats_call.io;
+    DBcallstats *e;
+    double now;
+
+    if (!_db_stats_call.active)
+        return;
+    _db_stats_call.active = 0;
+    now = db_stats_clock();
+    c->seconds = now - _db_stats_call.start;
+
+    if (_db_stats_call.fileid >= 0 &&
+        (e = db_stats_entry(_db_stats_call.fileid, c->name)))
+        db_stats_add(e, c);
+
+    if (_db_trace)
+    {
+        fprintf(_db_trace, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+            "\"pid\":%d,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,\"args\":{"
+            "\"file\":\"%s\",\"bytes_read\":%lld,\"bytes_written\":%lld,"
+            "\"stored_read\":%lld,\"stored_written\":%lld,\"datasets\":%lld,"
+            "\"filter_us\":%.3f}}",
+            _db_trace_nevents++ ? ",\n" : "", c->name, db_stats_category(c->name),
+#if defined(_WIN32)
+            0,
+#else
+            (int) getpid(),
+#endif
+            1e6 * _db_stats_call.start, 1e6 * c->seconds, _db_stats_call.file,
+            c->bytes_read, c->bytes_written, c->stored_read, c->stored_written,
+            c->datasets, 1e6 * c->filter_seconds);
     }
-    return DB_UNKNOWN;
 }
 
 /*----------------------------------------------------------------------
- * Routine:  DBGetDriverTypeFromPath
- *
- * Purpose:  Return the drive type 
- *
- * Programmer:  Thomas R. Treadway, Tue Jul  3 15:24:58 PDT 2007
- *
- * Description:  This routine returns a the driver type
- *
- * Modifications:
- *
- * Thomas R. Treadway, Thu Jul  5 11:57:03 PDT 2007
- * DB_HDR5 is conditional
+ * Routine:  db_stats_call_id
  *
- * Mark C. Miller, Mon Nov 19 10:45:05 PST 2007
- * Removed conditional compilation on HDF5 driver
- *
- * Mark C. Miller, Mon Oct 25 16:12:49 PDT 2010
- * Initialize buf to ensure it will be null terminated no matter
- * what happens during open/read.
+ * Purpose:  Return a number identifying the outermost API call in
+ *    progress. Each call the application makes gets a new number, so
+ *    drivers can tell state left by an earlier call from their own.
  *--------------------------------------------------------------------*/
-PUBLIC int
-DBGetDriverTypeFromPath(const char *path)
+INTERNAL unsigned long
+db_stats_call_id(void)
 {
-   char buf[9] = {'\0','\0','\0','\0','\0','\0','\0','\0','\0'};
-   int fd;
-   int nbytes;
-   int flags = O_RDONLY;
-   if ((fd = open(path, flags)) < 0) {
-      printf("cannot open `%s'\n", path);
-      return -1;
-   }
-   if ((nbytes = read(fd, (char *)buf, 8)) == -1) {
-      printf("cannot read `%s'\n", path);
-      close(fd);
-      return -1;
-   }
-   if (nbytes <= 5) {
-      printf("cannot read `%s' buffer too small\n", path);
-      close(fd);
-      return -1;
-   }
-   (void) close(fd);
-   if (strstr(buf, "PDB"))
-      return DB_PDB;
-#ifdef DB_HDF5X
-   if (strstr(buf, "HDF"))
-      return DB_HDF5X;
-#endif
-   return DB_UNKNOWN;
+    return _db_stats_call.id;
 }
 
 /*----------------------------------------------------------------------
- * Routine:  DBJoinPath
- *
- * Purpose:  Given paths with possible relative naming, combine them
- *           into a single absolute path. 
+ * Routine:  db_stats_read, db_stats_write, db_stats_dataset,
+ *           db_stats_filter
  *
- * Programmer:  Mark C. Miller, July 20, 2008 
+ * Purpose:  Add to the statistics of the call in progress. NBYTES is
+ *    the size of the data in memory and STORED its size in the file.
  *--------------------------------------------------------------------*/
-PUBLIC char * 
-DBJoinPath(const char *first, const char *second)
+INTERNAL int
+db_stats_active(void)
 {
-    API_BEGIN("DBJoinPath", char *, NULL) {
-        API_RETURN(db_join_path(first, second));
-    }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    return _db_stats_call.active;
 }
 
-/*----------------------------------------------------------------------
- * Routine:  DBUngrabDriver
- *
- * Purpose:  Return control of the low level driver
- *
- * Programmer:  Thomas R. Treadway, Thu Jun  7 13:19:48 PDT 2007
- *
- * Description:  This routine returns a the driver-native type
- *--------------------------------------------------------------------*/
-PUBLIC int
-DBUngrabDriver(DBfile *file, const void *driver_handle)
+INTERNAL void
+db_stats_read(long long nbytes, long long stored)
 {
-    if (file) {
-       SILO_Globals.enableGrabDriver = FALSE;
-       return file->pub.type;
-    }
-    return DB_UNKNOWN;
+    if (!_db_stats_call.active) return;
+    _db_stats_call.io.bytes_read += nbytes;
+    _db_stats_call.io.stored_read += stored;
 }
 
-static int 
-db_IncObjectComponentCount(DBobject *obj)
+INTERNAL void
+db_stats_write(long long nbytes, long long stored)
 {
-    int new_maxcomps = 0;
-    char **new_comp_names = 0;
-    char **new_pdb_names = 0;
+    if (!_db_stats_call.active) return;
+    _db_stats_call.io.bytes_written += nbytes;
+    _db_stats_call.io.stored_written += stored;
+}
 
-    obj->ncomponents++;
-    if (obj->ncomponents < obj->maxcomponents)
-        return 1;
+INTERNAL void
+db_stats_dataset(void)
+{
+    if (!_db_stats_call.active) return;
+    _db_stats_call.io.datasets++;
+}
 
-    new_maxcomps = obj->maxcomponents * 1.5 + 1; /* golden rule + 1 */
-    new_comp_names = REALLOC_N(obj->comp_names, char *, new_maxcomps);
-    if (!new_comp_names)
-    {
-        db_perror(0, E_NOMEM, "db_IncObjectComponentCount");
-        return 0;
-    }
-    new_pdb_names = REALLOC_N(obj->pdb_names, char *, new_maxcomps);
-    if (!new_pdb_names)
+INTERNAL void
+db_stats_filter(double seconds)
+{
+    if (!_db_stats_call.active) return;
+    _db_stats_call.io.filter_seconds += seconds;
+}
+
+/*----------------------------------------------------------------------
+ * Routine:  db_stats_forget
+ *
+ * Purpose:  Discard the statistics of file FILEID when it is closed.
+ *--------------------------------------------------------------------*/
+INTERNAL void
+db_stats_forget(int fileid)
+{
+    if (fileid < 0 || fileid >= DB_NFILES)
+        return;
+    if (_db_stats[fileid])
     {
-        FREE(new_comp_names);
-        db_perror(0, E_NOMEM, "db_IncObjectComponentCount");
-        return 0;
+        free(_db_stats[fileid]->calls);
+        free(_db_stats[fileid]);
+        _db_stats[fileid] = 0;
     }
-
-    obj->maxcomponents = new_maxcomps;
-    obj->comp_names = new_comp_names;
-    obj->pdb_names = new_pdb_names;
-
-    return 1;
+    if (_db_stats_call.fileid == fileid)
+        _db_stats_call.fileid = -1;
 }
 
 /*----------------------------------------------------------------------
- *  Routine                                                 DBMakeObject
- *
- *  Purpose
- *
- *      Allocate an object of the requested length and initialize it.
- *
- *  Programmer
- *
- *      Jeffery W. Long, NSSD-B
+ * Routine:  DBGetFileStats
  *
- *  Modified
- *    Robb Matzke, Tue Nov 8 11:41:23 PST 1994
- *    Added error mechanism
+ * Purpose:  Return the statistics of the API calls made on a file
+ *    since it was opened or its statistics were last reset.
  *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
+ * Description:  The result is a copy, freed with DBFreeFileStats. The
+ *    calls to get and reset the statistics are not counted.
  *--------------------------------------------------------------------*/
-PUBLIC DBobject *
-DBMakeObject(const char *name, int type, int maxcomps)
+PUBLIC DBfilestats *
+DBGetFileStats(DBfile *dbfile)
 {
-    DBobject      *object = NULL;
+    DBfilestats *stats;
 
-    API_BEGIN("DBMakeObject", DBobject *, NULL) {
+    API_BEGIN2("DBGetFileStats", DBfilestats *, NULL, api_dummy) {
+        db_stats_t const *st;
+        int i;
 
-        if (!name || !*name)
-            API_ERROR("object name", E_BADARGS);
-        if (db_VariableNameValid(name) == 0)
-            API_ERROR("object name", E_INVALIDNAME);
-        if (NULL == (object = ALLOC(DBobject)))
+        db_stats_cancel();
+        if (!dbfile || dbfile->pub.fileid < 0 || dbfile->pub.fileid >= DB_NFILES)
+            API_ERROR(NULL, E_NOFILE);
+        st = _db_stats[dbfile->pub.fileid];
+        if (!(stats = (DBfilestats *) calloc(1, sizeof(DBfilestats))))
             API_ERROR(NULL, E_NOMEM);
-
-        if (maxcomps <= 0) maxcomps = 30;
-        object->name = STRDUP(name);
-        object->type = STRDUP(DBGetObjtypeName(type));
-        object->comp_names = ALLOC_N(char *, maxcomps);
-        object->pdb_names = ALLOC_N(char *, maxcomps);
-
-        if (!object->name || !object->type ||
-            !object->comp_names || !object->pdb_names)
+        stats->total.name = "total";
+        stats->total.objtype = DB_INVALID_OBJECT;
+        if (st && st->ncalls)
         {
-            FREE(object->name);
-            FREE(object->type);
-            FREE(object->comp_names);
-            FREE(object->pdb_names);
-            API_ERROR(NULL, E_NOMEM);
+            if (!(stats->calls = (DBcallstats *) malloc(st->ncalls * sizeof(DBcallstats))))
+            {
+                free(stats);
+                API_ERROR(NULL, E_NOMEM);
+            }
+            memcpy(stats->calls, st->calls, st->ncalls * sizeof(DBcallstats));
+            stats->ncalls = st->ncalls;
+            for (i = 0; i < st->ncalls; i++)
+                db_stats_add(&stats->total, &st->calls[i]);
         }
+        API_RETURN(stats);
+    }
+    API_END_NOPOP;
+}
 
-        object->ncomponents = 0;
-        object->maxcomponents = maxcomps;
-
-        API_RETURN(object);
+PUBLIC int
+DBResetFileStats(DBfile *dbfile)
+{
+    API_BEGIN2("DBResetFileStats", int, -1, api_dummy) {
+        db_stats_cancel();
+        if (!dbfile || dbfile->pub.fileid < 0 || dbfile->pub.fileid >= DB_NFILES)
+            API_ERROR(NULL, E_NOFILE);
+        if (_db_stats[dbfile->pub.fileid])
+            _db_stats[dbfile->pub.fileid]->ncalls = 0;
+        API_RETURN(0);
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    API_END_NOPOP;
+}
+
+PUBLIC void
+DBFreeFileStats(DBfilestats *stats)
+{
+    if (!stats) return;
+    free(stats->calls);
+    free(stats);
 }
 
 /*----------------------------------------------------------------------
- *  Routine                                                DBFreeObject
- *
- *  Purpose
- *
- *      Release the storage associated with the given object list.
- *
- *  Programmer
- *
- *      Jeffery W. Long, NSSD-B
- *
- *  Returns
- *
- *      Returns OKAY on success, OOPS on failure.
- *
- *  Modified
- *    Robb Matzke, Thu Nov 10 17:28:39 EST 1994
- *    Added error mechanism.
+ * Routine:  DBSetTraceFile
  *
- *    Robb Matzke, Fri Dec 2 13:14:18 PST 1994
- *    Removed all references to SCORE memory management.
+ * Purpose:  Write a trace event for every API call to FILENAME, or stop
+ *    tracing if FILENAME is NULL.
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
+ * Description:  The file is in the Chrome trace event format that the
+ *    chrome://tracing and Perfetto timeline viewers load. Each outermost
+ *    API call is one complete ("X") event with the file and the counts of
+ *    its statistics as arguments. Timestamps are microseconds of the
+ *    monotonic clock, so the traces of processes on one node line up.
+ *    The viewers accept a file that was never closed.
  *--------------------------------------------------------------------*/
 PUBLIC int
-DBFreeObject(DBobject *object)
+DBSetTraceFile(char const *filename)
 {
-    int            i;
-
-    API_BEGIN("DBFreeObject", int, -1) {
-
-        if (!object)
-            API_ERROR("object pointer", E_BADARGS);
-        if (object->ncomponents < 0) {
-            API_ERROR("object ncomponents", E_BADARGS);
-        }
-
-        for (i = 0; i < object->ncomponents; i++) {
-            FREE(object->comp_names[i]);
-            FREE(object->pdb_names[i]);
+    API_BEGIN("DBSetTraceFile", int, -1) {
+        db_stats_cancel();
+        if (_db_trace)
+        {
+            fprintf(_db_trace, "\n]\n");
+            fclose(_db_trace);
+            _db_trace = NULL;
         }
-        for (i = 0; i < DB_MAX_H5_OBJ_VALS; i++) {
-            FREE(object->h5_names[i]);
+        if (filename)
+        {
+            if (!(_db_trace = fopen(filename, "w")))
+                API_ERROR(filename, E_FILENOWRITE);
+            fprintf(_db_trace, "[\n");
+            _db_trace_nevents = 0;
         }
-
-        FREE(object->comp_names);
-        FREE(object->pdb_names);
-        FREE(object->name);
-        FREE(object->type);
-        FREE(object);
+        API_RETURN(0);
     }
-    API_END;
+    API_END_NOPOP;
+}
 
-    return(0);  /* Always succeeds by the time we get here */
+/*----------------------------------------------------------------------
+ * Routine:  db_alloc_begin
+ *
+ * Purpose:  Begin allocating the memory of an object read from DBFILE
+ *    with the arena or allocator in effect for that file. Every call is
+ *    paired with a db_alloc_end call.
+ *--------------------------------------------------------------------*/
+INTERNAL void
+db_alloc_begin(DBfile *dbfile)
+{
+    SILO_Globals_t const *fg = dbfile->pub.file_scope_globals;
+    DBarena *arena = SILO_Globals.arena;
+    DBAllocFunc alloc = SILO_Globals.allocFunc;
+    DBFreeFunc free = SILO_Globals.freeFunc;
+    void *user = SILO_Globals.allocUser;
+
+    if (fg && fg->arena != DB_VOID_PTR_NOT_SET)
+        arena = fg->arena;
+    if (fg && fg->allocFunc != (DBAllocFunc) DB_VOID_PTR_NOT_SET)
+    {
+        alloc = fg->allocFunc;
+        free = fg->freeFunc;
+        user = fg->allocUser;
+    }
+
+    db_alloc_push(arena, alloc, free, user);
 }
 
 /*----------------------------------------------------------------------
- *  Routine                                                DBClearObject
- *
- *  Purpose
- *
- *      Remove all components from the given object and reset counters.
- *
- *  Programmer
+ * Routine:  db_ForgetArena
  *
- *      Jeffery W. Long, NSSD-B
- *
- *  Returns
- *
- *      Returns OKAY on success, OOPS on failure.
- *
- *  Modified
- *    Robb Matzke, Tue Nov 8 07:46:29 PST 1994
- *    Added error mechanism
- *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
+ * Purpose:  Unset ARENA globally and in every open file before it is
+ *    released.
  *--------------------------------------------------------------------*/
+INTERNAL void
+db_ForgetArena(DBarena *arena)
+{
+    int i;
+
+    if (SILO_Globals.arena == arena)
+        SILO_Globals.arena = 0;
+    for (i = 0; i < DB_NFILES; i++)
+    {
+        DBfile *f = _db_regstatus[i].f;
+        if (f && f->pub.file_scope_globals &&
+            f->pub.file_scope_globals->arena == arena)
+            f->pub.file_scope_globals->arena = 0;
+    }
+}
+
 PUBLIC int
-DBClearObject(DBobject *object)
+DBFreeCompressionResources(DBfile *dbfile, const char *meshname)
 {
-    int            i;
+    int retval = 0;
 
-    API_BEGIN("DBClearObject", int, -1) {
-        if (!object)
-            API_ERROR("object pointer", E_BADARGS);
-        if (object->ncomponents < 0) {
-            API_ERROR("object ncomponents", E_BADARGS);
-        }
+    API_BEGIN2("DBFreeCompressionResources", int, -1, api_dummy) {
 
-        /* Reset values, but do not free */
-        for (i = 0; i < object->maxcomponents; i++) {
-            object->comp_names[i] = NULL;
-            object->pdb_names[i] = NULL;
-        }
+        if (!dbfile->pub.free_z)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+        retval = ((dbfile->pub.free_z) (dbfile, meshname));
 
-        object->name = NULL;
-        object->type = NULL;
-        object->ncomponents = 0;
+        API_RETURN(retval);
     }
-    API_END;
-
-    return(0);
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
+#define CHECK_FOR_FRIENDLY(ON,SU)					\
+    ntotal += toc->n ## ON;						\
+    for (i = 0; i < toc->n ## ON; i++)					\
+    {									\
+        char tmp[1024];							\
+        snprintf(tmp, sizeof(tmp), "%s_%s", toc->ON ## _names[i], SU);	\
+        if (DBInqVarExists(f, tmp))					\
+            nfriendly++;						\
+    }
+
 /*----------------------------------------------------------------------
- *  Routine                                            DBAddVarComponent
- *
- *  Purpose
- *
- *      Add a variable component to the given object structure.
- *
- *  Programmer
- *
- *      Jeffery W. Long, NSSD-B
- *
- *  Returns
- *
- *      Returns OKAY on success, OOPS on failure.
- *
- *  Modified
- *    Robb Matzke, Tue Nov 8 07:43:38 PST 1994
- *    Added error mechanism
+ * Routine:  db_guess_has_friendly_HDF5_names_r 
  *
- *    Robb Matzke, Fri Dec 2 13:14:46 PST 1994
- *    Removed all references to SCORE memory management.
+ * Purpose:  Recursive helper func for DBGuessHasFriendlyHDF5Names 
+ *           names.
  *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
+ * Programmer: Mark C. Miller, Wed Sep  2 15:27:06 PDT 2009
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.  Correct spelling.
  *--------------------------------------------------------------------*/
-PUBLIC int
-DBAddVarComponent(DBobject *object, const char *compname, const char *pdbname)
+PRIVATE int
+db_guess_has_friendly_HDF5_names_r(DBfile *f)
 {
-    API_BEGIN("DBAddVarComponent", int, -1) {
-        if (!object)
-            API_ERROR("object pointer", E_BADARGS);
-        if (!compname || !*compname)
-            API_ERROR("component name", E_BADARGS);
-        if (db_VariableNameValid(compname) == 0)
-            API_ERROR("component name", E_INVALIDNAME);
-        if (!pdbname || !*pdbname)
-            API_ERROR("pdb name", E_BADARGS);
-        if (object->ncomponents >= object->maxcomponents) {
-            API_ERROR("object ncomponents", E_BADARGS);
-        }
+    int i, ntotal = 0, nfriendly = 0;
+    int retval;
+    DBtoc *toc;
 
-        if (NULL == (object->comp_names[object->ncomponents] =
-                     STRDUP(compname)) ||
-            NULL == (object->pdb_names[object->ncomponents] =
-                     STRDUP(pdbname))) {
-            FREE(object->comp_names[object->ncomponents]);
-            API_ERROR(NULL, E_NOMEM);
-        }
+    toc = DBGetToc(f);
 
-        if (!db_IncObjectComponentCount(object))
-            API_ERROR(NULL, E_NOMEM);
+    if (!toc) return 0;
+
+    CHECK_FOR_FRIENDLY(multimesh, "meshnames");
+    CHECK_FOR_FRIENDLY(multivar, "varnames");
+    CHECK_FOR_FRIENDLY(multimat, "matnames");
+    CHECK_FOR_FRIENDLY(qmesh, "coord0");
+    CHECK_FOR_FRIENDLY(qvar, "data");
+    CHECK_FOR_FRIENDLY(ucdmesh, "coord0");
+    CHECK_FOR_FRIENDLY(ucdvar, "data");
+    CHECK_FOR_FRIENDLY(ptmesh, "coord0");
+    CHECK_FOR_FRIENDLY(ptvar, "data");
+    CHECK_FOR_FRIENDLY(csgmesh, "_coeffs");
+    CHECK_FOR_FRIENDLY(csgvar, "data");
+    CHECK_FOR_FRIENDLY(mat, "_matlist");
+    CHECK_FOR_FRIENDLY(matspecies, "_speclist");
+    CHECK_FOR_FRIENDLY(curve, "_yvals");
+    CHECK_FOR_FRIENDLY(obj, "_nodelist");
 
+    if (ntotal >= 3) /* arb. min of 3 objects */
+    {
+        if (nfriendly >= ntotal/2)
+            return 1;
+        else
+            return 0;
     }
-    API_END;
 
-    return(0);
+    retval = -1;
+    for (i = 0; i < toc->ndir && retval == -1; i++)
+    {
+        DBSetDir(f, toc->dir_names[i]);
+        retval = db_guess_has_friendly_HDF5_names_r(f);
+        DBSetDir(f, "..");
+    }
+
+    return retval;
 }
 
 /*----------------------------------------------------------------------
- *  Routine                                            DBAddIntComponent
- *
- *  Purpose
- *
- *      Add an integer literal component to the given object structure.
- *
- *  Programmer
- *
- *      Jeffery W. Long, NSSD-B
- *
- *  Returns
- *
- *      Returns OKAY on success, OOPS on failure.
- *
- *  Modifications
- *    Robb Matzke, Tue Nov 8 07:06:11 PST 1994
- *    Added error mechanism. Returns 0 on success, -1 on failure.
+ * Routine:  DBGuessHasFriendlyHDF5Names
  *
- *    Robb Matzke, Fri Dec 2 13:15:06 PST 1994
- *    Removed all references to SCORE memory management.
+ * Purpose:  Determine if it looks like a given file has HDF5 friendly 
+ *           names.
  *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
+ * Programmer: Mark C. Miller, Wed Sep  2 15:27:06 PDT 2009
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
  *--------------------------------------------------------------------*/
 PUBLIC int
-DBAddIntComponent(DBobject *object, const char *compname, int ii)
-{
-    return DBAddIntNComponent(object, compname, 1, &ii);
-}
-
-PUBLIC int
-DBAddIntNComponent(DBobject *object, const char *compname, int n, int const *ii)
+DBGuessHasFriendlyHDF5Names(DBfile *f)
 {
-    int            i;
-    char           tmp[256];
-
-    API_BEGIN("DBAddIntComponent", int, -1) {
-        if (!object)
-            API_ERROR("object pointer", E_BADARGS);
-        if (!compname || !*compname)
-            API_ERROR("component name", E_BADARGS);
-        if (db_VariableNameValid(compname) == 0)
-            API_ERROR("component name", E_INVALIDNAME);
-        if (n < 1)
-            API_ERROR("n", E_BADARGS);
-        if (!ii)
-            API_ERROR("ii array", E_BADARGS);
-        if (object->ncomponents >= object->maxcomponents)
-            API_ERROR("object ncomponents", E_BADARGS);
-
-        sprintf(tmp, "'<i>%d", ii[0]);
-        for (i = 1; i < n; i++)
-        {
-            char tmp2[32];
-            snprintf(tmp2, sizeof(tmp2), ",%d", ii[i]);
-            strcat(tmp, tmp2);
-        }
-        strcat(tmp, "'");
-
-        if (NULL == (object->comp_names[object->ncomponents] =
-                     STRDUP(compname)) ||
-            NULL == (object->pdb_names[object->ncomponents] =
-                     STRDUP(tmp))) {
-            FREE(object->comp_names[object->ncomponents]);
-            API_ERROR(NULL, E_NOMEM);
-        }
+    char cwd[1024];
+    int retval;
 
-        if (!db_IncObjectComponentCount(object))
-            API_ERROR(NULL, E_NOMEM);
+#ifdef DB_HDF5X
+    if (DBGetDriverType(f) != DB_HDF5X)
+        return 0;
+#endif
 
-    }
-    API_END;
+    DBGetDir(f, cwd);
+    retval = db_guess_has_friendly_HDF5_names_r(f);
+    DBSetDir(f, cwd);    
 
-    return(0);
+    return retval;
 }
 
 /*----------------------------------------------------------------------
- *  Routine                                            DBAddFltComponent
- *
- *  Purpose
+ * Routine:  DBSetUnknownDriverPriority
  *
- *      Add a floating point literal component to the given object
- *      structure.
+ * Purpose:  Set priority order of drivers used by unknown driver. 
  *
- *  Programmer
+ * Programmer:  Mark C. Miller, May 1, 2006 
  *
- *      Jeffery W. Long, NSSD-B
- *
- *  Returns
- *
- *      Returns OKAY on success, OOPS on failure.
- *
- *  Modified:
- *    Robb Matzke, Tue Nov 8 07:04:15 PST 1994
- *    Added error mechanism.  Return -1 on failure, 0 on success.
- *
- *    Robb Matzke, Fri Dec 2 13:15:28 PST 1994
- *    Removed all references to SCORE memory management.
- *
- *    Eric Brugger, Tue Feb  7 09:06:58 PST 1995
- *    I modified the argument declarations to reflect argument promotions.
- *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
- *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
+ * Description:  This routine sets the flag that controls whether
+ *               checksums are computed on client data.
  *--------------------------------------------------------------------*/
-PUBLIC int
-DBAddFltComponent(DBobject *object, const char *compname, double ff)
+PUBLIC int const * 
+DBSetUnknownDriverPriorities(const int *priorities)
 {
-    return DBAddFltNComponent(object, compname, 1, &ff);
+    int i = 0;
+    static int oldPriorities[MAX_FILE_OPTIONS_SETS+DB_NFORMATS+1];
+    memcpy(oldPriorities, SILO_Globals.unknownDriverPriorities, sizeof(oldPriorities));
+    while (i < (MAX_FILE_OPTIONS_SETS+DB_NFORMATS+1) && priorities[i] >= 0)
+    {
+        SILO_Globals.unknownDriverPriorities[i] = priorities[i];
+        i++;
+    }
+    if (i < (MAX_FILE_OPTIONS_SETS+DB_NFORMATS+1))
+        SILO_Globals.unknownDriverPriorities[i] = -1;
+    return oldPriorities;
 }
 
-PUBLIC int
-DBAddFltNComponent(DBobject *object, const char *compname, int n, double const *ff)
+PUBLIC int const *
+DBGetUnknownDriverPriorities()
 {
-    int            i;
-    char           tmp[256];
+    static int priorities[MAX_FILE_OPTIONS_SETS+DB_NFORMATS+1];
+    memcpy(priorities, SILO_Globals.unknownDriverPriorities, sizeof(priorities));
+    return priorities;
+}
 
-    API_BEGIN("DBAddFltComponent", int, -1) {
-        if (!object)
-            API_ERROR("object pointer", E_BADARGS);
-        if (!compname || !*compname)
-            API_ERROR("component name", E_BADARGS);
-        if (n < 1)
-            API_ERROR("n", E_BADARGS);
-        if (!ff)
-            API_ERROR("ff array", E_BADARGS);
-        if (db_VariableNameValid(compname) == 0)
-            API_ERROR("component name", E_INVALIDNAME);
-        if (object->ncomponents >= object->maxcomponents) {
-            API_ERROR("object ncomponents", E_BADARGS);
-        }
+PUBLIC int
+DBRegisterFileOptionsSet(const DBoptlist *opts)
+{
+    int i;
 
-        sprintf(tmp, "'<f>%g", ff[0]);
-        for (i = 1; i < n; i++)
+    API_BEGIN("DBRegisterFileOptionsSet", int, -1) {
+        for (i = 0; i < MAX_FILE_OPTIONS_SETS; i++)
         {
-            char tmp2[32];
-            snprintf(tmp2, sizeof(tmp2), ",%g", ff[i]);
-        }
-        strcat(tmp, "'");
-
-        if (NULL == (object->comp_names[object->ncomponents] =
-                     STRDUP(compname)) ||
-            NULL == (object->pdb_names[object->ncomponents] =
-                     STRDUP(tmp))) {
-            FREE(object->comp_names[object->ncomponents]);
-            API_ERROR(NULL, E_NOMEM);
+            if (SILO_Globals.fileOptionsSets[i] == 0)
+            {
+                SILO_Globals.fileOptionsSets[i] = opts;
+                API_RETURN(i+NUM_DEFAULT_FILE_OPTIONS_SETS);
+            }
         }
-        if (!db_IncObjectComponentCount(object))
-            API_ERROR(NULL, E_NOMEM);
+        API_ERROR("Silo library", E_MAXFILEOPTSETS);
     }
-    API_END;
-
-    return(0);
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-/*----------------------------------------------------------------------
- *  Routine                                            DBAddDblComponent
- *
- *  Purpose
- *
- *      Add a double precision floating point literal component to 
- *      the given object structure.
- *
- *  Programmer
- *
- *      Brad Whitlock, Thu Jan 20 09:43:13 PDT 2000
- *
- *  Returns
- *
- *      Returns OKAY on success, OOPS on failure.
- *
- *  Modified:
- *
- *--------------------------------------------------------------------*/
 PUBLIC int
-DBAddDblComponent(DBobject *object, const char *compname, double dd)
+DBUnregisterFileOptionsSet(int opts_set_id)
 {
-    return DBAddDblNComponent(object, compname, 1, &dd);
+    int _opts_set_id = opts_set_id-NUM_DEFAULT_FILE_OPTIONS_SETS;
+
+    API_BEGIN("DBUnregisterFileOptionsSet", int, -1) {
+        if (SILO_Globals.fileOptionsSets[_opts_set_id] == 0)
+            API_ERROR("opts_set_id", E_BADARGS);
+        SILO_Globals.fileOptionsSets[_opts_set_id] = 0;
+        API_RETURN(0);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-PUBLIC int
-DBAddDblNComponent(DBobject *object, const char *compname, int n, double const *dd)
+PUBLIC void
+DBUnregisterAllFileOptionsSets()
 {
-    int            i;
-    char           tmp[256];
+    int i;
 
-    API_BEGIN("DBAddDblComponent", int, -1) {
-        if (!object)
-            API_ERROR("object pointer", E_BADARGS);
-        if (!compname || !*compname)
-            API_ERROR("component name", E_BADARGS);
-        if (n < 1)
-            API_ERROR("n", E_BADARGS);
-        if (!dd)
-            API_ERROR("dd array", E_BADARGS);
-        if (db_VariableNameValid(compname) == 0)
-            API_ERROR("component name", E_INVALIDNAME);
-        if (object->ncomponents >= object->maxcomponents) {
-            API_ERROR("object ncomponents", E_BADARGS);
-        }
+    for (i = 0; i < MAX_FILE_OPTIONS_SETS; i++)
+        SILO_Globals.fileOptionsSets[i] = 0;
+}
 
-        sprintf(tmp, "'<d>%.30g", dd[0]);
-        for (i = 1; i < n; i++)
-        {
-            char tmp2[64];
-            snprintf(tmp2, sizeof(tmp2), ",%.30g", dd[i]);
-        }
-        strcat(tmp, "'");
+const int* db_get_used_file_options_sets_ids()
+{
+    int i,n;
+    static int used_slots[MAX_FILE_OPTIONS_SETS+NUM_DEFAULT_FILE_OPTIONS_SETS+1];
 
-        if (NULL == (object->comp_names[object->ncomponents] =
-                     STRDUP(compname)) ||
-            NULL == (object->pdb_names[object->ncomponents] =
-                     STRDUP(tmp))) {
-            FREE(object->comp_names[object->ncomponents]);
-            API_ERROR(NULL, E_NOMEM);
-        }
-        if (!db_IncObjectComponentCount(object))
-            API_ERROR(NULL, E_NOMEM);
+   
+    /* For the default cases, only return those that 'matter' in that
+       they could possibly have an impact on Silo's ability to actually
+       open the file. In addtion, put them in some kind of priority order */
+    n = 0;
+    used_slots[n++] = DB_FILE_OPTS_H5_DEFAULT_SILO;
+    used_slots[n++] = DB_FILE_OPTS_H5_DEFAULT_SPLIT;
+    used_slots[n++] = DB_FILE_OPTS_H5_DEFAULT_DIRECT;
+    used_slots[n++] = DB_FILE_OPTS_H5_DEFAULT_FAMILY;
+    used_slots[n++] = DB_FILE_OPTS_H5_DEFAULT_MPIO;
+    used_slots[n++] = DB_FILE_OPTS_H5_DEFAULT_MPIP;
+    for (i = n; i < MAX_FILE_OPTIONS_SETS+NUM_DEFAULT_FILE_OPTIONS_SETS+1; i++)
+        used_slots[i] = -1;
+
+    /* fill in with used options set slots */
+    for (i = 0; i < MAX_FILE_OPTIONS_SETS; i++)
+    {
+        if (SILO_Globals.fileOptionsSets[i]==0)
+            continue;
+        used_slots[n++] = i+NUM_DEFAULT_FILE_OPTIONS_SETS;
     }
-    API_END;
 
-    return(0);
+    return used_slots;
 }
 
 /*----------------------------------------------------------------------
- *  Routine                                            DBAddStrComponent
- *
- *  Purpose
- *
- *      Add a string literal component to the given object structure.
- *
- *  Programmer
- *
- *      Jeffery W. Long, NSSD-B
+ * Routine:  DBGrabDriver
  *
- *  Returns
+ * Purpose:  Set and return the low level driver file handle
  *
- *      Returns OKAY on success, OOPS on failure.
+ * Programmer:  Thomas R. Treadway, Tue May 29 15:52:19 PDT 2007
  *
- *  Modified
- *    Robb Matzke, Tue Nov 8 07:08:33 PST 1994
- *    Added error mechanism.  Return 0 on success, -1 on failure.
+ * Description:  This routine returns a ponter to the driver-native
+ * file handle.
  *
- *    Robb Matzke, Fri Dec 2 13:15:49 PST 1994
- *    Removed all references to SCORE memory management.
+ * Modifications
+ *   Mark C. Miller, Thu Oct 11 15:36:10 PDT 2007
+ *   Record fact file was grabbed by adding var at top-level
+ *--------------------------------------------------------------------*/
+PUBLIC void * 
+DBGrabDriver(DBfile *file)
+{
+    void *rtn = 0;
+    if (file) {
+       if (file->pub.GrabId > (void *) 0) {
+          int grab_val = 1;
+          DBWrite(file, "/_was_grabbed", &grab_val, &grab_val, 1, DB_INT);
+#ifndef _WIN32
+#warning FIX GLOBAL LOCK
+#endif
+          SILO_Globals.enableGrabDriver = TRUE;
+          rtn = (void *) file->pub.GrabId;
+       }
+    }
+    return rtn;
+}
+/*----------------------------------------------------------------------
+ * Routine:  DBGetDriverType
  *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
+ * Purpose:  Return the drive type 
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
+ * Programmer:  Thomas R. Treadway, Thu Jun  7 13:19:48 PDT 2007
  *
- *    Mark C. Miller, Thu Apr  2 09:48:57 PDT 2015
- *    Added Al Nichols' enhancement for arb. length str components.
+ * Description:  This routine returns a the driver type
  *--------------------------------------------------------------------*/
 PUBLIC int
-DBAddStrComponent(DBobject *object, const char *compname, const char *ss)
+DBGetDriverType(const DBfile *file)
 {
-    char *tmp = 0;
+    if (file) {
+       return file->pub.type;
+    }
+    return DB_UNKNOWN;
+}
 
-    API_BEGIN("DBAddStrComponent", int, -1) {
-        if (!object)
-            API_ERROR("object pointer", E_BADARGS);
-        if (!compname || !*compname)
-            API_ERROR("component name", E_BADARGS);
-        if (db_VariableNameValid(compname) == 0)
-            API_ERROR("component name", E_INVALIDNAME);
-        if (object->ncomponents >= object->maxcomponents) {
-            API_ERROR("object ncomponents", E_BADARGS);
-        }
-        if (!ss)
-        {
-            if (!DBGetAllowEmptyObjects())
-                API_ERROR("string literal component", E_BADARGS);
-            tmp = malloc(10);
-            sprintf(tmp, "'<s>null'");
-        }
-        else
-        {
-            tmp = malloc(strlen(ss)+6);
-            sprintf(tmp, "'<s>%s'", ss);
-        }
-
-        if (NULL == (object->comp_names[object->ncomponents] =
-                     STRDUP(compname)) ||
-            NULL == (object->pdb_names[object->ncomponents] =
-                     STRDUP(tmp))) {
-            FREE(tmp);
-            FREE(object->comp_names[object->ncomponents]);
-            API_ERROR(NULL, E_NOMEM);
-        }
-        if (!db_IncObjectComponentCount(object))
-        {
-            FREE(tmp);
-            API_ERROR(NULL, E_NOMEM);
-        }
-        FREE(tmp);
-    }
-    API_END;
-
-    return(0);
-}
-
-/*-------------------------------------------------------------------------
- * Function:    DBShowErrors
- *
- * Purpose:     Set the method by which errors are displayed.  The
- *              `level' parameter is one of the following:
- *
- *                 DB_ALL       -- Show all errors, beginning with the
- *                                 routine that first detected the error
- *                                 and continuing up the call stack to
- *                                 the application.
- *
- *                 DB_ABORT     -- Same as DB_ALL except abort() is called
- *                                 after the error message is printed.
- *
- *                 DB_TOP       -- (default) Only the top-level API functions
- *                                 issue error messages.
- *
- *                 DB_NONE      -- The library does not handle error messages.
- *                                 The application is responsible for
- *                                 checking the API return values and
- *                                 handling the error.
- *
- *                 DB_SUSPEND   -- This is used internally to temporarily
- *                                 suspend the issuance of error messages
- *                                 by changing the error level to DB_NONE.
- *
- *                 DB_RESTORE   -- This is used internally to restore the
- *                                 previous error level after a DB_SUSPEND.
- *
- *              The `func' parameter can point to an application-level
- *              error handling function that will be passed a string that
- *              is part of the error message (similar to the argument for
- *              perror()).  If the function pointer is null, then
- *              the library will issue error messages to the standard
- *              error stream.
+/*----------------------------------------------------------------------
+ * Routine:  DBGetDriverTypeFromPath
  *
- *              The error text and erring function name can
- *              be obtained by calling DBErrString() or DBErrFunc().
+ * Purpose:  Return the drive type 
  *
- * Return:      void
+ * Programmer:  Thomas R. Treadway, Tue Jul  3 15:24:58 PDT 2007
  *
- * Programmer:  matzke@viper
- *              Mon Nov  7 09:58:43 PST 1994
+ * Description:  This routine returns a the driver type
  *
  * Modifications:
- *    Robb Matzke, Mon Dec 12 14:25:04 EST 1994
- *    Added DB_SUSPEND and DB_RESUME in order to get
- *    db_unk_Open to work properly [the Open callback for
- *    the SILO-Unknown driver].
  *
- *    Eric Brugger, Tue Feb  7 09:06:58 PST 1995
- *    I modified the function declaration and changed the default error
- *    reporting level to DB_NONE.
+ * Thomas R. Treadway, Thu Jul  5 11:57:03 PDT 2007
+ * DB_HDR5 is conditional
  *
- *    Eric Brugger, Wed Mar  1 17:07:39 PST 1995
- *    I shrouded the prototypes for non-ansi compilers.
- * 
- *    Hank Childs, Thu Mar  2 13:34:35 PST 2000
- *    Add check to ensure that nested DBShowErrors to suspend error 
- *    messages would work correctly.
+ * Mark C. Miller, Mon Nov 19 10:45:05 PST 2007
+ * Removed conditional compilation on HDF5 driver
  *
- *-------------------------------------------------------------------------*/
-#ifndef _WIN32
-#warning ADD DBSHOWERRORSFILE
-#endif
-PUBLIC void
-DBShowErrors(int level, void(*func)(char*))
+ * Mark C. Miller, Mon Oct 25 16:12:49 PDT 2010
+ * Initialize buf to ensure it will be null terminated no matter
+ * what happens during open/read.
+ *--------------------------------------------------------------------*/
+PUBLIC int
+DBGetDriverTypeFromPath(const char *path)
 {
-    static int     old_level = DB_NONE;
-    static int     old_level_drvr = DB_NONE;
-    static int     nested_suspend = 0;
-
-    SILO_Globals._db_err_level_drvr = DB_NONE;
-    if (level == DB_ALL_AND_DRVR)
-    {
-        level = DB_ALL;
-	SILO_Globals._db_err_level_drvr = DB_ALL;
-    }
-
-#ifndef _WIN32
-#warning GET RID OF SUSPEND/RESUME STUFF
+   char buf[9] = {'\0','\0','\0','\0','\0','\0','\0','\0','\0'};
+   int fd;
+   int nbytes;
+   int flags = O_RDONLY;
+   if ((fd = open(path, flags)) < 0) {
+      printf("cannot open `%s'\n", path);
+      return -1;
+   }
+   if ((nbytes = read(fd, (char *)buf, 8)) == -1) {
+      printf("cannot read `%s'\n", path);
+      close(fd);
+      return -1;
+   }
+   if (nbytes <= 5) {
+      printf("cannot read `%s' buffer too small\n", path);
+      close(fd);
+      return -1;
+   }
+   (void) close(fd);
+   if (strstr(buf, "PDB"))
+      return DB_PDB;
+#ifdef DB_HDF5X
+   if (strstr(buf, "HDF"))
+      return DB_HDF5X;
 #endif
-    switch (level) {
-        case DB_SUSPEND:
-            if (nested_suspend++ == 0)
-            {
-                old_level = SILO_Globals._db_err_level;
-                old_level_drvr = SILO_Globals._db_err_level_drvr;
-            }
-            SILO_Globals._db_err_level = DB_NONE;
-	    SILO_Globals._db_err_level_drvr = DB_NONE;
-            break;
-        case DB_RESUME:
-            if (--nested_suspend == 0)
-            {
-                SILO_Globals._db_err_level = old_level;
-	        SILO_Globals._db_err_level_drvr = old_level_drvr;
-            }
-            break;
-        default:
-            SILO_Globals._db_err_level = level;
-            SILO_Globals._db_err_func = func;
-            break;
-    }
+   return DB_UNKNOWN;
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBErrString
- *
- * Purpose:     Return the error message of the last error.
- *
- * Return:      Success:        ptr to static error message
- *
- *              Failure:        ptr to static message for db_errno=0
+/*----------------------------------------------------------------------
+ * Routine:  DBJoinPath
  *
- * Programmer:  robb@cloud
- *              Tue Feb 21 08:23:48 EST 1995
+ * Purpose:  Given paths with possible relative naming, combine them
+ *           into a single absolute path. 
  *
- * Modifications:
- *-------------------------------------------------------------------------*/
-PUBLIC char const *
-DBErrString(void)
+ * Programmer:  Mark C. Miller, July 20, 2008 
+ *--------------------------------------------------------------------*/
+PUBLIC char * 
+DBJoinPath(const char *first, const char *second)
 {
-    static char    s[128];
-
-    if (db_errno < 0 || db_errno >= NELMTS(_db_err_list)) {
-        sprintf(s, "Error %d", db_errno);
-        return s;
+    API_BEGIN("DBJoinPath", char *, NULL) {
+        API_RETURN(db_join_path(first, second));
     }
-
-    return _db_err_list[db_errno];
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
+/*----------------------------------------------------------------------
+ * Routine:  DBUngrabDriver
+ *
+ * Purpose:  Return control of the low level driver
+ *
+ * Programmer:  Thomas R. Treadway, Thu Jun  7 13:19:48 PDT 2007
+ *
+ * Description:  This routine returns a the driver-native type
+ *--------------------------------------------------------------------*/
 PUBLIC int
-DBErrno(void)
-{
-    return db_errno;
-}
-
-PUBLIC char const *
-DBErrFuncname(void)
+DBUngrabDriver(DBfile *file, const void *driver_handle)
 {
-    return db_errfunc;
+    if (file) {
+       SILO_Globals.enableGrabDriver = FALSE;
+       return file->pub.type;
+    }
+    return DB_UNKNOWN;
 }
 
-PUBLIC DBErrFunc_t
-DBErrfunc(void)
+static int 
+db_IncObjectComponentCount(DBobject *obj)
 {
-    return SILO_Globals._db_err_func;
-}
+    int new_maxcomps = 0;
+    char **new_comp_names = 0;
+    char **new_pdb_names = 0;
 
-PUBLIC int
-DBErrlvl(void)
-{
-    return SILO_Globals._db_err_level;
-}
+    obj->ncomponents++;
+    if (obj->ncomponents < obj->maxcomponents)
+        return 1;
 
-/*-------------------------------------------------------------------------
- * Function: db_parse_version_digits_from_string
- *
- * str: version string
- * sep: separator character (typically '.')
- * digits: array of digits to return
- * ndigits: size of digits array
- *
- * returns 0 on successful conversion, non-zero on failure
- *-----------------------------------------------------------------------*/
-static int
-db_parse_version_digits_from_string(char const *str, char sep, int *digits, int ndigits)
-{
-    int i, nseps, non_digits, retval = 0;
-    char *p, *ostr;
-    
-    if (!str || !*str)
-        return 1;
-
-    ostr = strdup(str);
-    p = ostr;
-
-    /* Examine string for seperator chars and non-digits */
-    nseps = 0;
-    non_digits = 0;
-    while (*p)
-    {
-        if (*p == sep)
-        {
-            *p = '\0';
-            nseps++;
-        }
-        else if (!strncmp(p, "-pre", 4) ||
-                 !strncmp(p, "-pos", 4))
-        {
-            *(p+0) = '\0';
-            *(p+1) = '0';
-            *(p+2) = '0';
-            *(p+3) = '0';
-            nseps++;
-            p += 3;
-        }
-        else if (*p < '0' || *p > '9')
-        {
-            non_digits = 1;
-        }
-        p++;
-    }
-    nseps++;
-
-    /* Make a second pass over string converting all the digits */
-    if (!non_digits)
+    new_maxcomps = obj->maxcomponents * 1.5 + 1; /* golden rule + 1 */
+    new_comp_names = REALLOC_N(obj->comp_names, char *, new_maxcomps);
+    if (!new_comp_names)
     {
-        p = ostr;
-        errno = 0;
-        for (i = 0; i < ndigits; i++)
-            digits[i] = 0;
-        for (i = 0; i < nseps && ndigits && errno == 0; i++, ndigits--)
-        {
-            digits[i] = strtol(p, 0, 10);
-            while (*p != '\0') p++;
-            p++;
-        }
-        if (errno)
-            retval = 1;
+        db_perror(0, E_NOMEM, "db_IncObjectComponentCount");
+        return 0;
     }
-    else
+    new_pdb_names = REALLOC_N(obj->pdb_names, char *, new_maxcomps);
+    if (!new_pdb_names)
     {
-        retval = 1;
+        FREE(new_comp_names);
+        db_perror(0, E_NOMEM, "db_IncObjectComponentCount");
+        return 0;
     }
 
-    free(ostr);
-
-    return retval;
-}
+    obj->maxcomponents = new_maxcomps;
+    obj->comp_names = new_comp_names;
+    obj->pdb_names = new_pdb_names;
 
-static int
-db_compare_version_digits(int const *a_digits, int const *b_digits, int ndigits)
-{
-    int i;
-    for (i = 0; i < ndigits; i++)
-    {
-        if (a_digits[i] < b_digits[i])
-            return -1;
-        else if (a_digits[i] > b_digits[i])
-            return 1;
-    }
-    return 0;
+    return 1;
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBVersion
+/*----------------------------------------------------------------------
+ *  Routine                                                 DBMakeObject
  *
- * Purpose:     Return the version number of the library as a string.
+ *  Purpose
  *
- * Returns:     ptr to version number
+ *      Allocate an object of the requested length and initialize it.
  *
- * Programmer:  Hank Childs
- *              Tue Oct 17 14:08:45 PDT 2000
+ *  Programmer
  *
- * Modifications:
+ *      Jeffery W. Long, NSSD-B
  *
- *   Mark C. Miller, Tue Oct 24 12:39:31 PDT 2006
- *   Changed to use SILO_VSTRING
- *-------------------------------------------------------------------------*/
-PUBLIC char const *
-DBVersion(void)
+ *  Modified
+ *    Robb Matzke, Tue Nov 8 11:41:23 PST 1994
+ *    Added error mechanism
+ *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *--------------------------------------------------------------------*/
+PUBLIC DBobject *
+DBMakeObject(const char *name, int type, int maxcomps)
 {
-    static char version[256];
-    strcpy(version, SILO_VSTRING);
+    DBobject      *object = NULL;
 
-    return version;
-}
+    API_BEGIN("DBMakeObject", DBobject *, NULL) {
 
-PUBLIC int
-DBVersionDigits(int *maj, int *min, int *pat, int *pre)
-{
-    int digits[4] = {0,0,0,0};
+        if (!name || !*name)
+            API_ERROR("object name", E_BADARGS);
+        if (db_VariableNameValid(name) == 0)
+            API_ERROR("object name", E_INVALIDNAME);
+        if (NULL == (object = ALLOC(DBobject)))
+            API_ERROR(NULL, E_NOMEM);
 
-    if (!db_parse_version_digits_from_string(DBVersion(), '.',
-             digits, sizeof(digits)/sizeof(digits[0])))
-    {
-        if (maj) *maj = digits[0];
-        if (min) *min = digits[1];
-        if (pat) *pat = digits[2];
-        if (pre) *pre = digits[3];
-        return 0;
+        if (maxcomps <= 0) maxcomps = 30;
+        object->name = STRDUP(name);
+        object->type = STRDUP(DBGetObjtypeName(type));
+        object->comp_names = ALLOC_N(char *, maxcomps);
+        object->pdb_names = ALLOC_N(char *, maxcomps);
+
+        if (!object->name || !object->type ||
+            !object->comp_names || !object->pdb_names)
+        {
+            FREE(object->name);
+            FREE(object->type);
+            FREE(object->comp_names);
+            FREE(object->pdb_names);
+            API_ERROR(NULL, E_NOMEM);
+        }
+
+        object->ncomponents = 0;
+        object->maxcomponents = maxcomps;
+
+        API_RETURN(object);
     }
-    return -1;
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBVersionGE
+/*----------------------------------------------------------------------
+ *  Routine                                                DBFreeObject
  *
- * Purpose:     Return whether or not the version of the library is greater
- *              than or equal to the version specified by Maj, Min, Pat.
- *              This is a run-time equiv. of the SILO_VERSION_GE macro.
+ *  Purpose
  *
- * Returns:     integer indicating if true (1) or false (0) 
+ *      Release the storage associated with the given object list.
  *
- * Programmer:  Mark C. Miller, Mon Jan 12 20:59:30 PST 2009
- *-------------------------------------------------------------------------*/
-PUBLIC int 
-DBVersionGE(int Maj, int Min, int Pat)
-{
-    int a_digits[3] = {SILO_VERS_MAJ, SILO_VERS_MIN, SILO_VERS_PAT};
-    int b_digits[3] = {Maj<0?0:Maj, Min<0?0:Min, Pat<0?0:Pat};
-    return db_compare_version_digits(a_digits, b_digits, 3) >= 0;
-}
-
-PUBLIC int
-DBVersionGEFileVersion(const DBfile *dbfile)
-{
-    int a_digits[3];
-    int b_digits[3] = {4, 5, 0}; /* earliest version we have version info in file */
-    DBVersionDigits(&a_digits[0], &a_digits[1], &a_digits[2], 0);
-    DBFileVersionDigits(dbfile, &b_digits[0], &b_digits[1], &b_digits[2], 0);
-    return db_compare_version_digits(a_digits, b_digits, 3) >= 0;
-}
-
-/*-------------------------------------------------------------------------
- * Function:    DBFileVersion
+ *  Programmer
  *
- * Purpose:     Return the version number of the library that created the
- *              given file as a string.
+ *      Jeffery W. Long, NSSD-B
  *
- * Returns:     ptr to version number
+ *  Returns
  *
- * Programmer:  Mark C. Miller, Mon Jan 12 20:59:30 PST 2009
- *-------------------------------------------------------------------------*/
-PUBLIC char const *
-DBFileVersion(const DBfile *dbfile)
-{
-    static char version[256];
-    if (dbfile->pub.file_lib_version)
-        strcpy(version, dbfile->pub.file_lib_version);
-    else
-        strcpy(version, "unknown; 4.5 or older");
-    return version;
-}
-
-PUBLIC int
-DBFileVersionDigits(const DBfile *dbfile, int *maj, int *min, int *pat, int *pre)
-{
-    int digits[4] = {0,0,0,0};
-    if (!db_parse_version_digits_from_string(DBFileVersion(dbfile), '.',
-             digits, sizeof(digits)/sizeof(digits[0])))
-    {
-        if (maj) *maj = digits[0];
-        if (min) *min = digits[1];
-        if (pat) *pat = digits[2];
-        if (pre) *pre = digits[3];
-        return 0;
-    }
-    return -1;
-}
-
-/*-------------------------------------------------------------------------
- * Function:    DBFileVersionGE
+ *      Returns OKAY on success, OOPS on failure.
  *
- * Purpose:     Return whether or not the given file was created with a 
- *              version of the library greater than or equal to the
- *              version specified by Maj, Min, Pat 
+ *  Modified
+ *    Robb Matzke, Thu Nov 10 17:28:39 EST 1994
+ *    Added error mechanism.
  *
- * Returns:     1 if file version is greather than or equal to Maj/Min/Pat
- *              0 if file version is less than Maj/Min/Pat
- *             -1 if unable to determine.
+ *    Robb Matzke, Fri Dec 2 13:14:18 PST 1994
+ *    Removed all references to SCORE memory management.
  *
- * Programmer:  Mark C. Miller, Mon Jan 12 20:59:30 PST 2009
- *-------------------------------------------------------------------------*/
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *--------------------------------------------------------------------*/
 PUBLIC int
-DBFileVersionGE(const DBfile *dbfile, int Maj, int Min, int Pat)
+DBFreeObject(DBobject *object)
 {
-    int retval = -1;
-    int unknown = 0;
-    int a_digits[3];
-    int b_digits[3] = {Maj<0?0:Maj, Min<0?0:Min, Pat<0?0:Pat};
-    char *version = STRDUP(DBFileVersion(dbfile));
+    int            i;
 
-    if (strncmp(version, "unknown", 7) == 0)
-    {
-        /* We started maintaining library version information in the file
-           in version 4.5.1. So, if it is 'unknown', we can return something
-           useful ONLY if the version we're comparing against is 4.5.1 or
-           greater. */
-        a_digits[0] = 4;
-        a_digits[1] = 5;
-        a_digits[2] = 0;
-        unknown = 1;
-    }
-    else
-    {
-        if (db_parse_version_digits_from_string(version, '.',
-                 a_digits, sizeof(a_digits)/sizeof(a_digits[0])))
-        {
-            free(version);
-            return -1;
-        }
-    }
+    API_BEGIN("DBFreeObject", int, -1) {
 
-    free(version);
+        if (!object)
+            API_ERROR("object pointer", E_BADARGS);
+        if (object->ncomponents < 0) {
+            API_ERROR("object ncomponents", E_BADARGS);
+        }
 
-    retval = db_compare_version_digits(a_digits, b_digits, 3) >= 0; 
+        for (i = 0; i < object->ncomponents; i++) {
+            FREE(object->comp_names[i]);
+            FREE(object->pdb_names[i]);
+        }
+        for (i = 0; i < DB_MAX_H5_OBJ_VALS; i++) {
+            FREE(object->h5_names[i]);
+        }
 
-    if (unknown)
-    {
-        if (retval)
-            retval = -1;
+        FREE(object->comp_names);
+        FREE(object->pdb_names);
+        FREE(object->name);
+        FREE(object->type);
+        FREE(object);
     }
+    API_END;
 
-    return retval;
+    return(0);  /* Always succeeds by the time we get here */
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBFileName
+/*----------------------------------------------------------------------
+ *  Routine                                                DBClearObject
  *
- * Purpose:     Return the name of the associated file.
+ *  Purpose
  *
- * Returns:     ptr to string holding the name of the file or "unknown".
+ *      Remove all components from the given object and reset counters.
  *
- * Programmer:  Mark C. Miller, Tue May 24 12:45:53 PDT 2016
- *-------------------------------------------------------------------------*/
-PUBLIC char const *
-DBFileName(const DBfile *dbfile)
-{
-    static char name[256];
-    if (dbfile->pub.name)
-        strcpy(name, dbfile->pub.name);
-    else
-        strcpy(name, "unknown");
-    return name;
-}
-
-static void
-db_InitFileGlobals(DBfile *dbfile, int mode)
+ *  Programmer
+ *
+ *      Jeffery W. Long, NSSD-B
+ *
+ *  Returns
+ *
+ *      Returns OKAY on success, OOPS on failure.
+ *
+ *  Modified
+ *    Robb Matzke, Tue Nov 8 07:46:29 PST 1994
+ *    Added error mechanism
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *--------------------------------------------------------------------*/
+PUBLIC int
+DBClearObject(DBobject *object)
 {
-    int i;
-
-    dbfile->pub.file_scope_globals = (SILO_Globals_t*) malloc(sizeof(SILO_Globals_t));
-    /* since most entries are ints and we want to init them to the NOT-SET value
-       this call averts *some* mistakes where SILO_Globals_t might get updated with
-       new int members but failed to be explicitly initialize here. The value of
-       DB_INTBOOL_NOT_SET is accepted as int but is ultimately cast to unsigned char
-       internally in memset(). Given that its integer value is -1 (0xFFFFFFFF), its
-       conversion to unsigned char will be 0xFF and will have the effect of setting
-       all int members of SILO_Globals_t to -1 or DB_INTBOOL_NOT_SET. */
-    memset(dbfile->pub.file_scope_globals, DB_INTBOOL_NOT_SET, sizeof(SILO_Globals_t));
+    int            i;
 
-    /* Initialize to NOT-SET values so that, initially, a file is set to
-       inheret *and* track all behaviors from Silo's globals. The first time
-       any of these values are changed to a NOT_SET value, then forevermore, 
-       that particular behavior is governed by the file */
-    dbfile->pub.file_scope_globals->dataReadMask            = DB_MASK_NOT_SET;
-    dbfile->pub.file_scope_globals->allowOverwrites         = DB_INTBOOL_NOT_SET;
-    dbfile->pub.file_scope_globals->allowEmptyObjects       = DB_INTBOOL_NOT_SET;
-    dbfile->pub.file_scope_globals->enableChecksums         = DB_INTBOOL_NOT_SET;
-    dbfile->pub.file_scope_globals->enableFriendlyHDF5Names = DB_INTBOOL_NOT_SET;
-    dbfile->pub.file_scope_globals->enableGrabDriver        = DB_INTBOOL_NOT_SET;
-    dbfile->pub.file_scope_globals->darshanEnabled          = DB_INTBOOL_NOT_SET;
-    dbfile->pub.file_scope_globals->allowLongStrComponents  = DB_INTBOOL_NOT_SET;
-    dbfile->pub.file_scope_globals->maxDeprecateWarnings    = DB_INTBOOL_NOT_SET;
-#ifndef _WIN32
-#warning ADD compressionMinSize
-#endif
-    dbfile->pub.file_scope_globals->compressionMinratio     = DB_FLOAT_NOT_SET;
-#ifndef _WIN32
-#warning CORRECT INITIALIZATION OF compressionErrmode
-#endif
-    dbfile->pub.file_scope_globals->compressionErrmode      = DB_INTBOOL_NOT_SET;
-    dbfile->pub.file_scope_globals->compatibilityMode       = DB_INTBOOL_NOT_SET;
-    dbfile->pub.file_scope_globals->compressionParams       = (char*) DB_CHAR_PTR_NOT_SET;
-    dbfile->pub.file_scope_globals->_db_err_level           = DB_INTBOOL_NOT_SET;
-    dbfile->pub.file_scope_globals->_db_err_func            = DB_VOID_PTR_NOT_SET;
-    dbfile->pub.file_scope_globals->_db_err_level_drvr      = DB_INTBOOL_NOT_SET;
+    API_BEGIN("DBClearObject", int, -1) {
+        if (!object)
+            API_ERROR("object pointer", E_BADARGS);
+        if (object->ncomponents < 0) {
+            API_ERROR("object ncomponents", E_BADARGS);
+        }
 
-    /* Jstk only relevant for lib as a whole, not specific to a file */
-    dbfile->pub.file_scope_globals->Jstk = 0;
+        /* Reset values, but do not free */
+        for (i = 0; i < object->maxcomponents; i++) {
+            object->comp_names[i] = NULL;
+            object->pdb_names[i] = NULL;
+        }
 
-    for (i = 0; i < MAX_FILE_OPTIONS_SETS; i++)
-        dbfile->pub.file_scope_globals->fileOptionsSets[i] = 0;
+        object->name = NULL;
+        object->type = NULL;
+        object->ncomponents = 0;
+    }
+    API_END;
 
-    /* If compatibility is set in mode, then set it in file_scope_globals too */
-    if (mode & 0x000000F0)
-        dbfile->pub.file_scope_globals->compatibilityMode = mode & 0x000000F0;
+    return(0);
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBOpen
- *
- * Purpose:     Open a data file.
+/*----------------------------------------------------------------------
+ *  Routine                                            DBAddVarComponent
  *
- * Return:      Success:        pointer to new file descriptor
+ *  Purpose
  *
- *              Failure:        NULL
+ *      Add a variable component to the given object structure.
  *
- * Programmer:  matzke@viper
- *              Mon Nov  7 10:25:08 PST 1994
+ *  Programmer
  *
- * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
+ *      Jeffery W. Long, NSSD-B
  *
- *    Robb Matzke, Tue Feb 28 10:51:19 EST 1995
- *    When a file is opened, it is given a unique ID number wrt all other
- *    open files.  The ID is a small integer [0..DB_NFILES-1].
+ *  Returns
  *
- *    Robb Matzke, Tue Feb 28 11:38:08 EST 1995
- *    For each registered filter, call the non-null `init' functions for
- *    every file that is opened.
+ *      Returns OKAY on success, OOPS on failure.
  *
- *    Sean Ahern, Mon Jan  8 17:38:18 PST 1996
- *    Added the mode parameter.
+ *  Modified
+ *    Robb Matzke, Tue Nov 8 07:43:38 PST 1994
+ *    Added error mechanism
  *
- *    Lisa J. Nafziger, Wed Mar  6 10:20:48 PST 1996
- *    Added code to check for file existence, to check if it is a
- *    directory and to check for read permission.  This allows more
- *    specific error messages to be returned.
+ *    Robb Matzke, Fri Dec 2 13:14:46 PST 1994
+ *    Removed all references to SCORE memory management.
  *
- *    Lisa J. Nafziger, Tue Mar 12 14:15:06 PST 1996
- *    Modified code to check file attributes so that stat() rather
- *    than access() is used.  The former is POSIX compliant.
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
  *
- *    Eric Brugger, Tue Jun 17 10:25:57 PDT 1997
- *    I modified the routine to only check file validity if the type
- *    is not an SDX connection.
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.  Correct spelling.
+ *--------------------------------------------------------------------*/
+PUBLIC int
+DBAddVarComponent(DBobject *object, const char *compname, const char *pdbname)
+{
+    API_BEGIN("DBAddVarComponent", int, -1) {
+        if (!object)
+            API_ERROR("object pointer", E_BADARGS);
+        if (!compname || !*compname)
+            API_ERROR("component name", E_BADARGS);
+        if (db_VariableNameValid(compname) == 0)
+            API_ERROR("component name", E_INVALIDNAME);
+        if (!pdbname || !*pdbname)
+            API_ERROR("pdb name", E_BADARGS);
+        if (object->ncomponents >= object->maxcomponents) {
+            API_ERROR("object ncomponents", E_BADARGS);
+        }
+
+        if (NULL == (object->comp_names[object->ncomponents] =
+                     STRDUP(compname)) ||
+            NULL == (object->pdb_names[object->ncomponents] =
+                     STRDUP(pdbname))) {
+            FREE(object->comp_names[object->ncomponents]);
+            API_ERROR(NULL, E_NOMEM);
+        }
+
+        if (!db_IncObjectComponentCount(object))
+            API_ERROR(NULL, E_NOMEM);
+
+    }
+    API_END;
+
+    return(0);
+}
+
+/*----------------------------------------------------------------------
+ *  Routine                                            DBAddIntComponent
  *
- *    Jeremy Meredith, Fri Jul 23 09:31:14 PDT 1999
- *    I added error reporting to the result of stat().
+ *  Purpose
  *
- *    Jeremy Meredith, Mon Jul 26 10:39:49 PDT 1999
- *    Made stat() error reporting POSIX.1 compliant.
+ *      Add an integer literal component to the given object structure.
  *
- *    Sean Ahern, Wed Jul  5 15:35:48 PDT 2000
- *    Renamed the function to DBOpenReal.  Client code now calls a macro
- *    called DBOpen.
+ *  Programmer
  *
- *    Mark C. Miller, Wed Feb  2 07:59:53 PST 2005
- *    Added printing of error message from stat() with strerror
+ *      Jeffery W. Long, NSSD-B
  *
- *    Mark C. Miller, Wed Feb 23 08:51:35 PST 2005
- *    Added code to reset _db_fstatus slot to 0 if open fails
+ *  Returns
  *
- *    Thomas R. Treadway, Tue Jun 27 13:59:21 PDT 2006
- *    Added HAVE_STRERROR wrappers
+ *      Returns OKAY on success, OOPS on failure.
  *
- *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
- *    Added code to register the returned file pointer
+ *  Modifications
+ *    Robb Matzke, Tue Nov 8 07:06:11 PST 1994
+ *    Added error mechanism. Returns 0 on success, -1 on failure.
  *
- *    Mark C. Miller, Mon Jan 12 20:50:41 PST 2009
- *    Removed DB_SDX conditionally compiled code blocks.
+ *    Robb Matzke, Fri Dec 2 13:15:06 PST 1994
+ *    Removed all references to SCORE memory management.
  *
- *    Mark C. Miller, Wed Feb 25 23:50:06 PST 2009
- *    Moved call to db_isregistered_file to AFTER calls to stat the file
- *    add changed db_isregistered_file to accept stat struct instead of name.
- *    Changed call to db_register_file to accpet stat struct.
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
  *
- *    Mark C. Miller, Fri Feb 12 08:22:41 PST 2010
- *    Replaced stat/stat64 calls with db_silo_stat. Replaced conditional
- *    compilation logic for SIZEOF_OFF64_T with db_silo_stat_struct.
- *------------------------------------------------------------------------- */
-PUBLIC DBfile *
-DBOpenReal(const char *name, int type, int mode)
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *--------------------------------------------------------------------*/
+PUBLIC int
+DBAddIntComponent(DBobject *object, const char *compname, int ii)
 {
-    char           ascii[16];
-    DBfile        *dbfile;
-    int            fileid, i;
-    int            origtype = type;
-    int            opts_set_id;
-    db_silo_stat_t filestate;
-
-    API_BEGIN("DBOpen", DBfile *, NULL) {
-        if (DB_NOBJ_TYPES != _db_nobj_types)
-            API_ERROR("Silo TOC not configured corretly", E_INTERNAL);
-
-        if (!name)
-            API_ERROR(NULL, E_NOFILE);
-
-        /* deal with extended driver type specifications */
-        db_DriverTypeAndFileOptionsSetId(origtype, &type, &opts_set_id);
-
-        if (type < 0 || type >= DB_NFORMATS) {
-            sprintf(ascii, "%d", type);
-            API_ERROR(ascii, E_BADFTYPE);
-        }
-        if (((mode & 0x0000000F) != DB_READ) && ((mode & 0x0000000F) != DB_APPEND))
-        {
-            sprintf(ascii, "%d", mode);
-            API_ERROR(ascii, E_BADARGS);
-        }
-        if (!DBOpenCB[type]) {
-            sprintf(ascii, "%d", type);
-            API_ERROR(ascii, E_NOTIMP);
-        }
+    return DBAddIntNComponent(object, compname, 1, &ii);
+}
 
-        /****************************************************/
-        /* Check to make sure the file exists and has the   */
-        /* correct permissions.                             */
-        /****************************************************/
-        if (db_silo_stat(name, &filestate, type==DB_UNKNOWN?-1:opts_set_id) != 0)
-        {
-            if( errno == ENOENT )
-            {
-                /********************************/
-                /* File doesn't exist.          */
-                /********************************/
-                API_ERROR((char *)name, E_NOFILE);
-            }
-            else
-            {
-                /********************************/
-                /* System level error occured.  */
-                /********************************/
-#if SIZEOF_OFF64_T > 4 && (defined(HAVE_STAT64) || !defined(HAVE_STAT))
-                printf("stat64() failed with error: ");
-#else
-                printf("stat() failed with error: ");
-#endif
-                switch (errno)
-                {
-                  case EACCES:       printf("EACCES\n");       break;
-                  case EBADF:        printf("EBADF\n");        break;
-                  case ENAMETOOLONG: printf("ENAMETOOLONG\n"); break;
-                  case ENOTDIR:      printf("ENOTDIR\n");      break;
-#ifdef EOVERFLOW
-                  case EOVERFLOW:    
-#ifdef HAVE_STRERROR
-                                     printf("EOVERFLOW: \"%s\"\n", 
-                                        strerror(errno));
-#else
-                                     printf("EOVERFLOW: errno=%d\n", errno);
-#endif
-                                     printf("Silo may need to be re-compiled with "
-                                            "Large File Support (LFS)\n");
-                                     break;
-#endif
-                  default:           
-#ifdef HAVE_STRERROR
-                                     printf("\"%s\"\n",
-                                        strerror(errno));
-#else
-                                     printf("errno=%d\n", errno);
-#endif
-                                     break;
-                }
-                API_ERROR((char *)name, E_SYSTEMERR);
-            }
-        }
+PUBLIC int
+DBAddIntNComponent(DBobject *object, const char *compname, int n, int const *ii)
+{
+    int            i;
+    char           tmp[256];
 
-        /* Check if file is already opened. If so, none can
-           have it opened for write, including this new one */ 
-        i = db_isregistered_file(0, &filestate);
-        if (i != -1)
-        {
-            if (_db_regstatus[i].w != 0 || (mode & 0x0000000F) != DB_READ)
-                API_ERROR(name, E_CONCURRENT);
-        }
+    API_BEGIN("DBAddIntComponent", int, -1) {
+        if (!object)
+            API_ERROR("object pointer", E_BADARGS);
+        if (!compname || !*compname)
+            API_ERROR("component name", E_BADARGS);
+        if (db_VariableNameValid(compname) == 0)
+            API_ERROR("component name", E_INVALIDNAME);
+        if (n < 1)
+            API_ERROR("n", E_BADARGS);
+        if (!ii)
+            API_ERROR("ii array", E_BADARGS);
+        if (object->ncomponents >= object->maxcomponents)
+            API_ERROR("object ncomponents", E_BADARGS);
 
-        if( ( filestate.s.st_mode & S_IFDIR ) != 0 )
-        {
-            /************************************/
-            /* File is actually a directory.    */
-            /************************************/
-            API_ERROR((char *)name, E_FILEISDIR);
-        }
-        if( ( filestate.s.st_mode & S_IREAD ) == 0 )
-        {
-            /****************************************/
-            /* File is missing read permissions.    */
-            /****************************************/
-            API_ERROR((char *)name, E_FILENOREAD);
-        }
-        if (DB_READ!=(mode&0x0000000F) && (filestate.s.st_mode & S_IWUSR) == 0)
+        sprintf(tmp, "'<i>%d", ii[0]);
+        for (i = 1; i < n; i++)
         {
-            /****************************************/
-            /* File is open for write and missing write permission. */
-            /****************************************/
-            API_ERROR((char *)name, E_FILENOWRITE);
+            char tmp2[32];
+            snprintf(tmp2, sizeof(tmp2), ",%d", ii[i]);
+            strcat(tmp, tmp2);
         }
+        strcat(tmp, "'");
 
-        if ((fileid = db_get_fileid(DB_ISOPEN)) < 0)
-            API_ERROR((char *)name, E_MAXOPEN);
-        if (NULL == (dbfile = (DBOpenCB[type]) (name, mode, opts_set_id)))
-        {
-            _db_fstatus[fileid] = 0;
-            API_RETURN(NULL);
+        if (NULL == (object->comp_names[object->ncomponents] =
+                     STRDUP(compname)) ||
+            NULL == (object->pdb_names[object->ncomponents] =
+                     STRDUP(tmp))) {
+            FREE(object->comp_names[object->ncomponents]);
+            API_ERROR(NULL, E_NOMEM);
         }
-        dbfile->pub.fileid = fileid;
-        db_InitFileGlobals(dbfile, mode);
-        db_register_file(dbfile, &filestate, (mode&0x0000000F)!=DB_READ);
 
-        /*
-         * Install filters.  First, all `init' filters, then the
-         * specified filters.
-         */
-        for (i = 0; i < DB_NFILTERS; i++) {
-            if (_db_filter[i].name && _db_filter[i].init) {
-                (void)(_db_filter[i].init) (dbfile, _db_filter[i].name);
-            }
-        }
-        db_filter_install(dbfile);
-        if (DBInqVarExists(dbfile, SILO_VSTRING_NAME))
-            dbfile->pub.file_lib_version = (char*)DBGetVar(dbfile, SILO_VSTRING_NAME);
+        if (!db_IncObjectComponentCount(object))
+            API_ERROR(NULL, E_NOMEM);
 
-        API_RETURN(dbfile);
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    API_END;
+
+    return(0);
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBCreateReal
- *
- * Purpose:     Create a data file
- *
- * Return:      Success:        pointer to file descriptor
- *
- *              Failure:        NULL
- *
- * Programmer:  matzke@viper
- *              Mon Nov  7 10:29:23 PST 1994
- *
- * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
+/*----------------------------------------------------------------------
+ *  Routine                                            DBAddFltComponent
  *
- *    Robb Matzke, Tue Feb 28 10:57:06 EST 1995
- *    A file ID is assigned to the new file.
+ *  Purpose
  *
- *    Robb Matzke, 15 May 1996
- *    Removed the unused `statue' auto variable.
+ *      Add a floating point literal component to the given object
+ *      structure.
  *
- *    Sean Ahern, Wed Jul  5 15:35:48 PDT 2000
- *    Renamed the function to DBCreateReal.  Client code now calls a macro
- *    called DBCreate.
+ *  Programmer
  *
- *    Mark C. Miller, Wed Feb 23 08:51:35 PST 2005
- *    Added code to reset _db_fstatus slot to 0 if create fails
+ *      Jeffery W. Long, NSSD-B
  *
- *    Mark C. Miller, Wed Apr  5 10:17:31 PDT 2006
- *    Added code to output silo library version string to the file
+ *  Returns
  *
- *    Mark C. Miller, Mon Nov 19 10:45:05 PST 2007
- *    Added hdf5 driver warning.
+ *      Returns OKAY on success, OOPS on failure.
  *
- *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
- *    Added code to register the returned file pointer
+ *  Modified:
+ *    Robb Matzke, Tue Nov 8 07:04:15 PST 1994
+ *    Added error mechanism.  Return -1 on failure, 0 on success.
  *
- *    Mark C. Miller, Mon Nov 17 19:04:39 PST 2008
- *    Added code to check to see if name is a directory.
+ *    Robb Matzke, Fri Dec 2 13:15:28 PST 1994
+ *    Removed all references to SCORE memory management.
  *
- *    Mark C. Miller, Wed Feb 25 23:52:05 PST 2009
- *    Moved call to db_isregistered_file to after stat calls. Stat the
- *    file after its created so we can get information to register it.
+ *    Eric Brugger, Tue Feb  7 09:06:58 PST 1995
+ *    I modified the argument declarations to reflect argument promotions.
  *
- *    Mark C. Miller, Fri Feb 12 08:22:41 PST 2010
- *    Replaced stat/stat64 calls with db_silo_stat. Replaced conditional
- *    compilation logic for SIZEOF_OFF64_T with db_silo_stat_struct.
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
  *
- *    Mark C. Miller, Thu Aug 30 17:41:24 PDT 2012
- *    Added logic to temporarily disable any compression settings prior
- *    to writing silo library info and then re-enabling it.
- *-------------------------------------------------------------------------*/
-PUBLIC DBfile *
-DBCreateReal(const char *name, int mode, int target, const char *info, int type)
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *--------------------------------------------------------------------*/
+PUBLIC int
+DBAddFltComponent(DBobject *object, const char *compname, double ff)
 {
-    char           ascii[16];
-    char           *tmpcs = 0;
-    DBfile        *dbfile;
-    int            fileid, i, n;
-    int            origtype = type;
-    int            opts_set_id = 0;
-    db_silo_stat_t filestate;
-
-    API_BEGIN("DBCreate", DBfile *, NULL) {
-        if (DB_NOBJ_TYPES != _db_nobj_types)
-            API_ERROR("Silo TOC not configured corretly", E_INTERNAL);
-
-        if (!name)
-            API_ERROR(NULL, E_NOFILE);
-
-        /* deal with extended driver type specifications */
-        db_DriverTypeAndFileOptionsSetId(origtype, &type, &opts_set_id);
-
-        if (type < 0 || type >= DB_NFORMATS) {
-            sprintf(ascii, "%d", type);
-            API_ERROR(ascii, E_BADFTYPE);
-        }
-
-        if (db_silo_stat(name, &filestate, opts_set_id) == 0)  /* Success - File exists */
-        {
-            if ((mode & 0x0000000F) == DB_NOCLOBBER)
-            {
-                API_ERROR((char *)name, E_FEXIST);
-            }
-            if ((filestate.s.st_mode & S_IFDIR) != 0)
-            {
-                API_ERROR((char *)name, E_FILEISDIR);
-            }
+    return DBAddFltNComponent(object, compname, 1, &ff);
+}
 
-            /* Check if file is already opened. If so, none can
-               have it opened for write, including this new one */
-            i = db_isregistered_file(0, &filestate);
-            if (i != -1)
-            {
-                API_ERROR(name, E_CONCURRENT);
-            }
-        }
+PUBLIC int
+DBAddFltNComponent(DBobject *object, const char *compname, int n, double const *ff)
+{
+    int            i;
+    char           tmp[256];
 
-        if (!DBCreateCB[type]) {
-            sprintf(ascii, "%d", type);
-            if (type == 7)
-            {
-                API_ERROR(ascii, E_NOHDF5);
-            }
-            else
-            {
-                API_ERROR(ascii, E_NOTIMP);
-            }
+    API_BEGIN("DBAddFltComponent", int, -1) {
+        if (!object)
+            API_ERROR("object pointer", E_BADARGS);
+        if (!compname || !*compname)
+            API_ERROR("component name", E_BADARGS);
+        if (n < 1)
+            API_ERROR("n", E_BADARGS);
+        if (!ff)
+            API_ERROR("ff array", E_BADARGS);
+        if (db_VariableNameValid(compname) == 0)
+            API_ERROR("component name", E_INVALIDNAME);
+        if (object->ncomponents >= object->maxcomponents) {
+            API_ERROR("object ncomponents", E_BADARGS);
         }
 
-        if ((fileid = db_get_fileid(DB_ISOPEN)) < 0)
-            API_ERROR((char *)name, E_MAXOPEN);
-        dbfile = ((DBCreateCB[type]) (name, mode, target, opts_set_id,
-                                      info));
-        if (!dbfile)
+        sprintf(tmp, "'<f>%g", ff[0]);
+        for (i = 1; i < n; i++)
         {
-            _db_fstatus[fileid] = 0;
-            API_RETURN(NULL);
-        }
-        dbfile->pub.fileid = fileid;
-        db_InitFileGlobals(dbfile, mode);
-        db_silo_stat(name, &filestate, opts_set_id);
-        db_register_file(dbfile, &filestate, 1);
-
-        /*
-         * Install filters.  First all `init' routines, then the specified
-         * `open' routines.
-         */
-        for (i = 0; i < DB_NFILTERS; i++) {
-            if (_db_filter[i].name && _db_filter[i].init) {
-                (void)(_db_filter[i].init) (dbfile, _db_filter[i].name);
-            }
+            char tmp2[32];
+            snprintf(tmp2, sizeof(tmp2), ",%g", ff[i]);
         }
-        db_filter_install(dbfile);
+        strcat(tmp, "'");
 
-        /* write silo library version information to the file */
-        /* Temporarily turn off any compression settings and then re-enable */
-        if (DBGetCompression())
-        {
-    
-            n = strlen(DBGetCompression());
-            tmpcs = ALLOC_N(char,n+1);
-            strncpy(tmpcs, DBGetCompression(), n);
-            tmpcs[n] = '\0';
-            DBSetCompression(0);
-        }
-        n = strlen(SILO_VSTRING)+1;
-        DBWrite(dbfile, SILO_VSTRING_NAME, SILO_VSTRING, &n, 1, DB_CHAR);
-        dbfile->pub.file_lib_version = STRDUP(SILO_VSTRING);
-        if (tmpcs)
-        {
-            DBSetCompression(tmpcs);
-            FREE(tmpcs);
+        if (NULL == (object->comp_names[object->ncomponents] =
+                     STRDUP(compname)) ||
+            NULL == (object->pdb_names[object->ncomponents] =
+                     STRDUP(tmp))) {
+            FREE(object->comp_names[object->ncomponents]);
+            API_ERROR(NULL, E_NOMEM);
         }
-
-        API_RETURN(dbfile);
+        if (!db_IncObjectComponentCount(object))
+            API_ERROR(NULL, E_NOMEM);
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    API_END;
+
+    return(0);
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBClose
- *
- * Purpose:     Close the specified data file and return NULL.
+/*----------------------------------------------------------------------
+ *  Routine                                            DBAddDblComponent
  *
- * Return:      Success:        NULL
+ *  Purpose
  *
- *              Failure:        NULL
+ *      Add a double precision floating point literal component to 
+ *      the given object structure.
  *
- * Programmer:  matzke@viper
- *              Mon Nov  7 10:31:41 PST 1994
+ *  Programmer
  *
- * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
+ *      Brad Whitlock, Thu Jan 20 09:43:13 PDT 2000
  *
- *    Eric Brugger, Mon Feb 27 15:03:01 PST 1995
- *    I changed the return value to be an integer instead of a pointer
- *    to a DBfile.
+ *  Returns
  *
- *    Robb Matzke, Tue Feb 28 10:57:57 EST 1995
- *    The file status slot is cleared so it can be reused.
+ *      Returns OKAY on success, OOPS on failure.
  *
- *    Eric Brugger, Mon Jul 10 07:42:24 PDT 1995
- *    I moved the reseting of _db_fstatus to before the return statement,
- *    so that the instruction would get executed.
+ *  Modified:
  *
- *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
- *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
- *    Added code to UNregister the given file pointer.
- *-------------------------------------------------------------------------*/
+ *--------------------------------------------------------------------*/
 PUBLIC int
-DBClose(DBfile *dbfile)
+DBAddDblComponent(DBobject *object, const char *compname, double dd)
 {
-    int            id;
-    int            retval;
-    SILO_Globals_t *tmp_file_scope_globals;
+    return DBAddDblNComponent(object, compname, 1, &dd);
+}
 
-    API_BEGIN2("DBClose", int, -1, api_dummy) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (NULL == dbfile->pub.close)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
-#ifndef _WIN32
-#warning IS ORDER OF OPS CORRECT HERE
-#endif
-        id = dbfile->pub.fileid;
-        if (id >= 0 && id < DB_NFILES)
-            _db_fstatus[id] = 0;
+PUBLIC int
+DBAddDblNComponent(DBobject *object, const char *compname, int n, double const *dd)
+{
+    int            i;
+    char           tmp[256];
 
-        if (dbfile->pub.file_lib_version)
-            free(dbfile->pub.file_lib_version);
-        db_unregister_file(dbfile);
+    API_BEGIN("DBAddDblComponent", int, -1) {
+        if (!object)
+            API_ERROR("object pointer", E_BADARGS);
+        if (!compname || !*compname)
+            API_ERROR("component name", E_BADARGS);
+        if (n < 1)
+            API_ERROR("n", E_BADARGS);
+        if (!dd)
+            API_ERROR("dd array", E_BADARGS);
+        if (db_VariableNameValid(compname) == 0)
+            API_ERROR("component name", E_INVALIDNAME);
+        if (object->ncomponents >= object->maxcomponents) {
+            API_ERROR("object ncomponents", E_BADARGS);
+        }
 
-	tmp_file_scope_globals = dbfile->pub.file_scope_globals; 
-        retval = (dbfile->pub.close) (dbfile);
-        free(tmp_file_scope_globals);
-        API_RETURN(retval);
+        sprintf(tmp, "'<d>%.30g", dd[0]);
+        for (i = 1; i < n; i++)
+        {
+            char tmp2[64];
+            snprintf(tmp2, sizeof(tmp2), ",%.30g", dd[i]);
+        }
+        strcat(tmp, "'");
+
+        if (NULL == (object->comp_names[object->ncomponents] =
+                     STRDUP(compname)) ||
+            NULL == (object->pdb_names[object->ncomponents] =
+                     STRDUP(tmp))) {
+            FREE(object->comp_names[object->ncomponents]);
+            API_ERROR(NULL, E_NOMEM);
+        }
+        if (!db_IncObjectComponentCount(object))
+            API_ERROR(NULL, E_NOMEM);
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
-}
+    API_END;
 
+    return(0);
+}
 
-/*-------------------------------------------------------------------------
- * Function:    DBFlush
+/*----------------------------------------------------------------------
+ *  Routine                                            DBAddStrComponent
  *
- * Purpose:     Flush the specified file contents to disk.
+ *  Purpose
  *
- * Return:      Success:        NULL
+ *      Add a string literal component to the given object structure.
  *
- *              Failure:        NULL
+ *  Programmer
  *
- * Programmer:  Mark C. Miller, Fri Nov  6 09:38:05 PST 2015
+ *      Jeffery W. Long, NSSD-B
  *
- * Modifications:
- *-------------------------------------------------------------------------*/
-PUBLIC int
-DBFlush(DBfile *dbfile)
-{
-    int            id;
-    int            retval;
-
-    API_BEGIN2("DBFlush", int, -1, api_dummy) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (NULL == dbfile->pub.flush)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
-        retval = (dbfile->pub.flush) (dbfile);
-        API_RETURN(retval);
-    }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
-}
-
-/*----------------------------------------------------------------------
- * Routine:  db_inq_file_has_silo_objects_r
+ *  Returns
  *
- * Purpose:  Recursive helper func for DBInqFileHasObjects 
+ *      Returns OKAY on success, OOPS on failure.
  *
- * Programmer: Mark C. Miller, Wed Sep 23 11:34:01 PDT 2009
+ *  Modified
+ *    Robb Matzke, Tue Nov 8 07:08:33 PST 1994
+ *    Added error mechanism.  Return 0 on success, -1 on failure.
  *
- * Modifications:
- *   Mark C. Miller, Mon Nov 16 10:28:41 PST 2009
- *   Fixed dir recursion by copying dir-related toc entries. Removed
- *   misc. vars from count of silo objects.
+ *    Robb Matzke, Fri Dec 2 13:15:49 PST 1994
+ *    Removed all references to SCORE memory management.
+ *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *
+ *    Mark C. Miller, Thu Apr  2 09:48:57 PDT 2015
+ *    Added Al Nichols' enhancement for arb. length str components.
  *--------------------------------------------------------------------*/
-
-PRIVATE int
-db_inq_file_has_silo_objects_r(DBfile *f)
+PUBLIC int
+DBAddStrComponent(DBobject *object, const char *compname, const char *ss)
 {
-    int i, ndir, retval = 0;
-    char **dirnames;
-    DBtoc *toc = DBGetToc(f);
-
-    if (!toc)
-        return -1;
+    char *tmp = 0;
 
-    /* save dirnames so we don't loose 'em as we get new tocs */
-    ndir = toc->ndir;
-    dirnames = (char **) malloc(ndir * sizeof(char*));
-    for (i = 0; i < ndir; i++)
-        dirnames[i] = STRDUP(toc->dir_names[i]);
-     
-    /* We exclude dirs and misc. vars because a non-Silo file may
-     * contain them. */
-    retval = toc->ncurve + toc->ncsgmesh + toc->ncsgvar + toc->ndefvars +
-        toc->nmultimesh + toc->nmultimeshadj + toc->nmultivar +
-        toc->nmultimat + toc->nmultimatspecies + toc->nqmesh +
-        toc->nqvar + toc->nucdmesh + toc->nucdvar + toc->nptmesh +
-        toc->nptvar + toc->nmat + toc->nmatspecies +
-        toc->nobj + toc->nmrgtree + toc->ngroupelmap +
-        toc->nmrgvar + toc->narray;
+    API_BEGIN("DBAddStrComponent", int, -1) {
+        if (!object)
+            API_ERROR("object pointer", E_BADARGS);
+        if (!compname || !*compname)
+            API_ERROR("component name", E_BADARGS);
+        if (db_VariableNameValid(compname) == 0)
+            API_ERROR("component name", E_INVALIDNAME);
+        if (object->ncomponents >= object->maxcomponents) {
+            API_ERROR("object ncomponents", E_BADARGS);
+        }
+        if (!ss)
+        {
+            if (!DBGetAllowEmptyObjects())
+                API_ERROR("string literal component", E_BADARGS);
+            tmp = malloc(10);
+            sprintf(tmp, "'<s>null'");
+        }
+        else
+        {
+            tmp = malloc(strlen(ss)+6);
+            sprintf(tmp, "'<s>%s'", ss);
+        }
 
-    /* Recurse on directories. */
-    for (i = 0; i < ndir && retval == 0; i++)
-    {
-        DBSetDir(f, dirnames[i]);
-        retval += db_inq_file_has_silo_objects_r(f);
-        DBSetDir(f, "..");
+        if (NULL == (object->comp_names[object->ncomponents] =
+                     STRDUP(compname)) ||
+            NULL == (object->pdb_names[object->ncomponents] =
+                     STRDUP(tmp))) {
+            FREE(tmp);
+            FREE(object->comp_names[object->ncomponents]);
+            API_ERROR(NULL, E_NOMEM);
+        }
+        if (!db_IncObjectComponentCount(object))
+        {
+            FREE(tmp);
+            API_ERROR(NULL, E_NOMEM);
+        }
+        FREE(tmp);
     }
+    API_END;
 
-    /* free the dirnames */
-    for (i = 0; i < ndir; i++)
-        free(dirnames[i]);
-    free(dirnames);
-
-    return retval;
+    return(0);
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBInqFileHasObjects
+ * Function:    DBShowErrors
  *
- * Purpose:     See if the file contains any silo objects, excluding
- *              directories in the search.
+ * Purpose:     Set the method by which errors are displayed.  The
+ *              `level' parameter is one of the following:
  *
- * Return:      Success:         >0 ==> yes, the file has silo objects.
- *                              ==0 ==> no, the file has no silo objects.
+ *                 DB_ALL       -- Show all errors, beginning with the
+ *                                 routine that first detected the error
+ *                                 and continuing up the call stack to
+ *                                 the application.
  *
- *              Failure:        -1 
+ *                 DB_ABORT     -- Same as DB_ALL except abort() is called
+ *                                 after the error message is printed.
  *
- * Programmer:  Mark C. Miller, Wed Sep 23 09:42:27 PDT 2009
+ *                 DB_TOP       -- (default) Only the top-level API functions
+ *                                 issue error messages.
+ *
+ *                 DB_NONE      -- The library does not handle error messages.
+ *                                 The application is responsible for
+ *                                 checking the API return values and
+ *                                 handling the error.
+ *
+ *                 DB_SUSPEND   -- This is used internally to temporarily
+ *                                 suspend the issuance of error messages
+ *                                 by changing the error level to DB_NONE.
+ *
+ *                 DB_RESTORE   -- This is used internally to restore the
+ *                                 previous error level after a DB_SUSPEND.
+ *
+ *              The `func' parameter can point to an application-level
+ *              error handling function that will be passed a string that
+ *              is part of the error message (similar to the argument for
+ *              perror()).  If the function pointer is null, then
+ *              the library will issue error messages to the standard
+ *              error stream.
+ *
+ *              The error text and erring function name can
+ *              be obtained by calling DBErrString() or DBErrFunc().
+ *
+ * Return:      void
+ *
+ * Programmer:  matzke@viper
+ *              Mon Nov  7 09:58:43 PST 1994
  *
  * Modifications:
- *   Mark C. Miller, Mon Nov 16 10:29:36 PST 2009
- *   Added logic to test from some well known, tell-tale silo variables.
+ *    Robb Matzke, Mon Dec 12 14:25:04 EST 1994
+ *    Added DB_SUSPEND and DB_RESUME in order to get
+ *    db_unk_Open to work properly [the Open callback for
+ *    the SILO-Unknown driver].
+ *
+ *    Eric Brugger, Tue Feb  7 09:06:58 PST 1995
+ *    I modified the function declaration and changed the default error
+ *    reporting level to DB_NONE.
+ *
+ *    Eric Brugger, Wed Mar  1 17:07:39 PST 1995
+ *    I shrouded the prototypes for non-ansi compilers.
+ * 
+ *    Hank Childs, Thu Mar  2 13:34:35 PST 2000
+ *    Add check to ensure that nested DBShowErrors to suspend error 
+ *    messages would work correctly.
+ *
  *-------------------------------------------------------------------------*/
-
-PUBLIC int
-DBInqFileHasObjects(DBfile *f)
+#ifndef _WIN32
+#warning ADD DBSHOWERRORSFILE
+#endif
+PUBLIC void
+DBShowErrors(int level, void(*func)(char*))
 {
-    char cwd[4096];
-    int retval;
-
-    if (f == 0)
-        return -1;
-
-    if (DBInqVarExists(f, "_silolibinfo"))
-        return 1;
-    if (DBInqVarExists(f, "_hdf5libinfo"))
-        return 1;
+    static int     old_level = DB_NONE;
+    static int     old_level_drvr = DB_NONE;
+    static int     nested_suspend = 0;
 
-    DBGetDir(f, cwd);
-    retval = db_inq_file_has_silo_objects_r(f);
-    DBSetDir(f, cwd);    
+    SILO_Globals._db_err_level_drvr = DB_NONE;
+    if (level == DB_ALL_AND_DRVR)
+    {
+        level = DB_ALL;
+	SILO_Globals._db_err_level_drvr = DB_ALL;
+    }
 
-    return retval;
+#ifndef _WIN32
+#warning GET RID OF SUSPEND/RESUME STUFF
+#endif
+    switch (level) {
+        case DB_SUSPEND:
+            if (nested_suspend++ == 0)
+            {
+                old_level = SILO_Globals._db_err_level;
+                old_level_drvr = SILO_Globals._db_err_level_drvr;
+            }
+            SILO_Globals._db_err_level = DB_NONE;
+	    SILO_Globals._db_err_level_drvr = DB_NONE;
+            break;
+        case DB_RESUME:
+            if (--nested_suspend == 0)
+            {
+                SILO_Globals._db_err_level = old_level;
+	        SILO_Globals._db_err_level_drvr = old_level_drvr;
+            }
+            break;
+        default:
+            SILO_Globals._db_err_level = level;
+            SILO_Globals._db_err_func = func;
+            break;
+    }
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBInqFileReal
+ * Function:    DBErrString
  *
- * Purpose:     Determines if the filename is a Silo file.
+ * Purpose:     Return the error message of the last error.
  *
- * Return:      0  if filename is not a Silo file, 
- *              >0 if filename is a Silo file,
- *              <0 if an error occurred.
+ * Return:      Success:        ptr to static error message
  *
- * Programmer:  Hank Childs
- *              Tue Feb 29 16:24:01 PST 2000
+ *              Failure:        ptr to static message for db_errno=0
  *
- * Modifications:
- *    Sean Ahern, Wed Jul  5 15:35:48 PDT 2000
- *    Renamed the function to DBInqFileReal.  Client code now calls a macro
- *    called DBInqFile.
+ * Programmer:  robb@cloud
+ *              Tue Feb 21 08:23:48 EST 1995
  *
- *    Mark C. Miller, Wed Sep 23 11:48:19 PDT 2009
- *    Added logic to confirm that indeed the successfully opened file has
- *    some silo objects in it.
+ * Modifications:
  *-------------------------------------------------------------------------*/
-PUBLIC int
-DBInqFileReal(const char *filename)
+PUBLIC char const *
+DBErrString(void)
 {
-    DBfile *dbfile = NULL;
-    int hasobjects = -1;
-
-    API_BEGIN("DBInqFile", int, -1) {
-        if (!filename || ! *filename)
-            API_ERROR("filename", E_BADARGS);
+    static char    s[128];
 
-        /* 
-         * Turn the error handling off so user won't see errors, 
-         * won't abort, etc.
-         */
-        DBShowErrors(DB_SUSPEND, NULL);
+    if (db_errno < 0 || db_errno >= NELMTS(_db_err_list)) {
+        sprintf(s, "Error %d", db_errno);
+        return s;
+    }
 
-        /*
-         * Must protect this code so that the error handling can be
-         * restored afterwards.
-         */
-        PROTECT {
-            dbfile = DBOpen(filename, DB_UNKNOWN, DB_READ);
-            if (dbfile)
-                hasobjects = DBInqFileHasObjects(dbfile);
-        } CLEANUP {
-            CANCEL_UNWIND;
-        } END_PROTECT;
+    return _db_err_list[db_errno];
+}
 
-        /* 
-         * Turn the error handling back on. 
-         */
-        DBShowErrors(DB_RESUME, NULL);
+PUBLIC int
+DBErrno(void)
+{
+    return db_errno;
+}
 
-        if (dbfile != NULL)
-        {
-            DBClose(dbfile);
-            API_RETURN(hasobjects);
-        }
- 
-        API_RETURN(0);
-    }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+PUBLIC char const *
+DBErrFuncname(void)
+{
+    return db_errfunc;
 }
 
-/*----------------------------------------------------------------------
- *  Routine                                               DBInqVarExists
- *
- *  Purpose
- *
- *      Determine if the given variable object exists in the SILO file.
- *      Return non-zero if it does and 0 if it doesn't.
- *
- *  Programmer
- *
- *      Sean Ahern, Thu Jul 20 11:53:40 PDT 1995
+PUBLIC DBErrFunc_t
+DBErrfunc(void)
+{
+    return SILO_Globals._db_err_func;
+}
+
+PUBLIC int
+DBErrlvl(void)
+{
+    return SILO_Globals._db_err_level;
+}
+
+/*-------------------------------------------------------------------------
+ * Function: db_parse_version_digits_from_string
  *
- *  Modifications
- *    Mon Aug 28 11:15:21 PDT 1995
- *    (ahern) Changed the API_BEGIN to API_BEGIN2.
+ * str: version string
+ * sep: separator character (typically '.')
+ * digits: array of digits to return
+ * ndigits: size of digits array
  *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
- *--------------------------------------------------------------------*/
-PUBLIC int
-DBInqVarExists(DBfile *dbfile, const char *varname)
+ * returns 0 on successful conversion, non-zero on failure
+ *-----------------------------------------------------------------------*/
+static int
+db_parse_version_digits_from_string(char const *str, char sep, int *digits, int ndigits)
 {
-    int retval;
+    int i, nseps, non_digits, retval = 0;
+    char *p, *ostr;
+    
+    if (!str || !*str)
+        return 1;
 
-    API_BEGIN2("DBInqVarExists", int, 0, varname) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (!varname || !*varname)
-            API_ERROR("variable name", E_BADARGS);
-        if (dbfile->pub.exist == NULL)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
-        retval = (dbfile->pub.exist) (dbfile, varname);
-        API_RETURN(retval);
+    ostr = strdup(str);
+    p = ostr;
+
+    /* Examine string for seperator chars and non-digits */
+    nseps = 0;
+    non_digits = 0;
+    while (*p)
+    {
+        if (*p == sep)
+        {
+            *p = '\0';
+            nseps++;
+        }
+        else if (!strncmp(p, "-pre", 4) ||
+                 !strncmp(p, "-pos", 4))
+        {
+            *(p+0) = '\0';
+            *(p+1) = '0';
+            *(p+2) = '0';
+            *(p+3) = '0';
+            nseps++;
+            p += 3;
+        }
+        else if (*p < '0' || *p > '9')
+        {
+            non_digits = 1;
+        }
+        p++;
     }
-    API_END_NOPOP; /* BEWARE: If API_RETURN above is removed use API_END */
+    nseps++;
+
+    /* Make a second pass over string converting all the digits */
+    if (!non_digits)
+    {
+        p = ostr;
+        errno = 0;
+        for (i = 0; i < ndigits; i++)
+            digits[i] = 0;
+        for (i = 0; i < nseps && ndigits && errno == 0; i++, ndigits--)
+        {
+            digits[i] = strtol(p, 0, 10);
+            while (*p != '\0') p++;
+            p++;
+        }
+        if (errno)
+            retval = 1;
+    }
+    else
+    {
+        retval = 1;
+    }
+
+    free(ostr);
+
+    return retval;
+}
+
+static int
+db_compare_version_digits(int const *a_digits, int const *b_digits, int ndigits)
+{
+    int i;
+    for (i = 0; i < ndigits; i++)
+    {
+        if (a_digits[i] < b_digits[i])
+            return -1;
+        else if (a_digits[i] > b_digits[i])
+            return 1;
+    }
+    return 0;
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBForceSingle
- *
- * Purpose:     If 'status' is non-zero, then any 'datatype'd arrays are
- *              converted on read from whatever their native datatype is to
- *              float. A 'datatype'd array is an array that is part of some
- *              Silo object containing a 'datatype' member which indicates
- *              the type of data in the array. So, for example, a DBucdvar
- *              has a 'datatype' member to indicate the type of data in the
- *              var and mixvar arrays. Such arrays will be converted on read
- *              if 'status' here is non-zero. However, a DBmaterial object 
- *              is ALWAYS integer data. There is no 'datatype' member for
- *              such an object and so its data will NEVER be converted to
- *              float on read regardless of force single status set here.
- *
- *              I believe this function's original intention was to convert
- *              only double precision arrays to single precision. However,
- *              the PDB driver was apparently never designed that way and
- *              the PDB driver's behavior sort of established the defacto
- *              meaning of force single. So, now, as of Silo version 4.8
- *              the HDF5 driver obeys it as well. Though, in fact the HDF5
- *              driver was originally written to support the original
- *              intention of force single status and it worked in this
- *              ('buggy') fashion for many years before we started
- *              encountering real problems with it in VisIt.
+ * Function:    DBVersion
  *
- * Return:      Success:        0 if all drivers succeeded or did not
- *                              implement this function.
+ * Purpose:     Return the version number of the library as a string.
  *
- *              Failure:        -1 if any driver returned failure.
+ * Returns:     ptr to version number
  *
- * Programmer:  matzke@viper
- *              Tue Jan 10 11:01:24 PST 1995
+ * Programmer:  Hank Childs
+ *              Tue Oct 17 14:08:45 PDT 2000
  *
  * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
  *
- *    Mark C. Miller, Fri Jul 16 19:28:23 PDT 2010
- *    Updated 'Purpose' above to reflect current understanding of the
- *    meaning of force single.
+ *   Mark C. Miller, Tue Oct 24 12:39:31 PDT 2006
+ *   Changed to use SILO_VSTRING
  *-------------------------------------------------------------------------*/
-PUBLIC int
-DBForceSingle(int status)
+PUBLIC char const *
+DBVersion(void)
 {
-    int            i;
+    static char version[256];
+    strcpy(version, SILO_VSTRING);
 
-    API_BEGIN("DBForceSingle", int, -1) {
-        for (i = 0; i < DB_NFORMATS; i++) {
-            if (DBFSingleCB[i]) {
-                if (((DBFSingleCB[i]) (status)) < 0) {
-                    char           dname[32];
+    return version;
+}
 
-                    sprintf(dname, "driver-%d", i);
-                    API_ERROR(dname, E_CALLFAIL);
-                }
-            }
-        }
-    }
-    API_END;
+PUBLIC int
+DBVersionDigits(int *maj, int *min, int *pat, int *pre)
+{
+    int digits[4] = {0,0,0,0};
 
-    return(0);
+    if (!db_parse_version_digits_from_string(DBVersion(), '.',
+             digits, sizeof(digits)/sizeof(digits[0])))
+    {
+        if (maj) *maj = digits[0];
+        if (min) *min = digits[1];
+        if (pat) *pat = digits[2];
+        if (pre) *pre = digits[3];
+        return 0;
+    }
+    return -1;
 }
 
-/*----------------------------------------------------------------------
- *  Routine                                                DBMakeOptlist
+/*-------------------------------------------------------------------------
+ * Function:    DBVersionGE
  *
- *  Purpose
+ * Purpose:     Return whether or not the version of the library is greater
+ *              than or equal to the version specified by Maj, Min, Pat.
+ *              This is a run-time equiv. of the SILO_VERSION_GE macro.
  *
- *      Allocate an option list of the requested length and initialize it.
+ * Returns:     integer indicating if true (1) or false (0) 
  *
- *  Programmer
- *
- *      Jeffery W. Long, NSSD-B
- *
- *  Modified
- *    Robb Matzke, Tue Nov 8 06:58:04 PST 1994
- *    Added error mechanism
- *--------------------------------------------------------------------*/
-PUBLIC DBoptlist *
-DBMakeOptlist(int maxopts)
+ * Programmer:  Mark C. Miller, Mon Jan 12 20:59:30 PST 2009
+ *-------------------------------------------------------------------------*/
+PUBLIC int 
+DBVersionGE(int Maj, int Min, int Pat)
 {
-    DBoptlist     *optlist = NULL;
-
-    API_BEGIN("DBMakeOptlist", DBoptlist *, NULL) {
-        if (maxopts <= 0)
-            API_ERROR("maxopts", E_BADARGS);
-        optlist = ALLOC(DBoptlist);
-        if (!optlist) API_ERROR(NULL, E_NOMEM);
-        optlist->options = ALLOC_N(int, maxopts);
-        optlist->values = ALLOC_N(void *, maxopts);
-
-        if (!optlist->options || !optlist->values)
-        {
-            FREE(optlist->values);
-            FREE(optlist->options);
-            FREE(optlist);
-            API_ERROR(NULL, E_NOMEM);
-        }
-
-        optlist->numopts = 0;
-        optlist->maxopts = maxopts;
-
-        API_RETURN(optlist);
-    }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    int a_digits[3] = {SILO_VERS_MAJ, SILO_VERS_MIN, SILO_VERS_PAT};
+    int b_digits[3] = {Maj<0?0:Maj, Min<0?0:Min, Pat<0?0:Pat};
+    return db_compare_version_digits(a_digits, b_digits, 3) >= 0;
 }
 
-/*----------------------------------------------------------------------
- *  Routine                                                DBFreeOptlist
- *
- *  Purpose
- *
- *      Release the storage associated with the given optlist list.
- *
- *  Programmer
- *
- *      Jeffery W. Long, NSSD-B
- *
- *  Returns
- *
- *      Returns 0 on success, -1 on failure.
- *
- *  Modified
- *    Robb Matzke, Tue Nov 8 07:56:34 PST 1994
- *    Added error mechanism.
- *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
- *--------------------------------------------------------------------*/
 PUBLIC int
-DBFreeOptlist(DBoptlist *optlist)
+DBVersionGEFileVersion(const DBfile *dbfile)
 {
-    API_BEGIN("DBFreeOptlist", int, -1) {
-        if (!optlist || optlist->numopts < 0) {
-            API_ERROR("optlist pointer", E_BADARGS);
-        }
-        FREE(optlist->options);
-        FREE(optlist->values);
-        FREE(optlist);
-    }
-    API_END;
-
-    return(0);
+    int a_digits[3];
+    int b_digits[3] = {4, 5, 0}; /* earliest version we have version info in file */
+    DBVersionDigits(&a_digits[0], &a_digits[1], &a_digits[2], 0);
+    DBFileVersionDigits(dbfile, &b_digits[0], &b_digits[1], &b_digits[2], 0);
+    return db_compare_version_digits(a_digits, b_digits, 3) >= 0;
 }
 
-/*----------------------------------------------------------------------
- *  Routine                                                DBClearOptlist
- *
- *  Purpose
- *
- *      Remove all options from the given optlist and reset counters.
- *
- *  Programmer
- *
- *      Jeffery W. Long, NSSD-B
- *
- *  Returns
+/*-------------------------------------------------------------------------
+ * Function:    DBFileVersion
  *
- *      Returns OKAY on success, OOPS on failure.
+ * Purpose:     Return the version number of the library that created the
+ *              given file as a string.
  *
- *  Modified
- *    Robb Matzke, Tue Nov 8 07:48:52 PST 1994
- *    Added error mechanism.
+ * Returns:     ptr to version number
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
- *--------------------------------------------------------------------*/
-PUBLIC int
-DBClearOptlist(DBoptlist *optlist)
+ * Programmer:  Mark C. Miller, Mon Jan 12 20:59:30 PST 2009
+ *-------------------------------------------------------------------------*/
+PUBLIC char const *
+DBFileVersion(const DBfile *dbfile)
 {
-    int            i;
-
-    API_BEGIN("DBClearOptlist", int, -1) {
-        if (!optlist || optlist->numopts < 0) {
-            API_ERROR("optlist pointer", E_BADARGS);
-        }
-
-        /* Reset values, but do not free */
-        for (i = 0; i < optlist->maxopts; i++) {
-            optlist->options[i] = 0;
-            optlist->values[i] = (void *)NULL;
-        }
+    static char version[256];
+    if (dbfile->pub.file_lib_version)
+        strcpy(version, dbfile->pub.file_lib_version);
+    else
+        strcpy(version, "unknown; 4.5 or older");
+    return version;
+}
 
-        optlist->numopts = 0;
+PUBLIC int
+DBFileVersionDigits(const DBfile *dbfile, int *maj, int *min, int *pat, int *pre)
+{
+    int digits[4] = {0,0,0,0};
+    if (!db_parse_version_digits_from_string(DBFileVersion(dbfile), '.',
+             digits, sizeof(digits)/sizeof(digits[0])))
+    {
+        if (maj) *maj = digits[0];
+        if (min) *min = digits[1];
+        if (pat) *pat = digits[2];
+        if (pre) *pre = digits[3];
+        return 0;
     }
-    API_END;
-
-    return(0);
+    return -1;
 }
 
-/*----------------------------------------------------------------------
- *  Routine                                                  DBAddOption
- *
- *  Purpose
- *
- *      Add an option to the given option list structure.
- *
- *  Programmer
- *
- *      Jeffery W. Long, NSSD-B
- *
- *  Returns
+/*-------------------------------------------------------------------------
+ * Function:    DBFileVersionGE
  *
- *      Returns OKAY on success, OOPS on failure.
+ * Purpose:     Return whether or not the given file was created with a 
+ *              version of the library greater than or equal to the
+ *              version specified by Maj, Min, Pat 
  *
- *  Modified:
- *    Robb Matzke, Tue Nov 8 07:00:55 PST 1994
- *    Added error mechanism.  Returns -1 on failure, 0 on success.
+ * Returns:     1 if file version is greather than or equal to Maj/Min/Pat
+ *              0 if file version is less than Maj/Min/Pat
+ *             -1 if unable to determine.
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
- *--------------------------------------------------------------------*/
+ * Programmer:  Mark C. Miller, Mon Jan 12 20:59:30 PST 2009
+ *-------------------------------------------------------------------------*/
 PUBLIC int
-DBAddOption(DBoptlist *optlist, int option, void *value)
+DBFileVersionGE(const DBfile *dbfile, int Maj, int Min, int Pat)
 {
-    API_BEGIN("DBAddOption", int, -1) {
-        if (!optlist)
-            API_ERROR("optlist pointer", E_BADARGS);
-        if (optlist->numopts >= optlist->maxopts)
-            API_ERROR("optlist nopts", E_BADARGS);
-
-        optlist->options[optlist->numopts] = option;
-        optlist->values[optlist->numopts] = value;
-        optlist->numopts++;
+    int retval = -1;
+    int unknown = 0;
+    int a_digits[3];
+    int b_digits[3] = {Maj<0?0:Maj, Min<0?0:Min, Pat<0?0:Pat};
+    char *version = STRDUP(DBFileVersion(dbfile));
 
-        if (optlist->numopts >= optlist->maxopts)
+    if (strncmp(version, "unknown", 7) == 0)
+    {
+        /* We started maintaining library version information in the file
+           in version 4.5.1. So, if it is 'unknown', we can return something
+           useful ONLY if the version we're comparing against is 4.5.1 or
+           greater. */
+        a_digits[0] = 4;
+        a_digits[1] = 5;
+        a_digits[2] = 0;
+        unknown = 1;
+    }
+    else
+    {
+        if (db_parse_version_digits_from_string(version, '.',
+                 a_digits, sizeof(a_digits)/sizeof(a_digits[0])))
         {
-            int new_maxopts = optlist->maxopts * 1.5 + 1; /* golden rule + 1 */
-            int *new_options = REALLOC_N(optlist->options, int, new_maxopts);
-            void **new_values = REALLOC_N(optlist->values, void*, new_maxopts);
+            free(version);
+            return -1;
+        }
+    }
 
-            if (!new_options || !new_values)
-            {
-                FREE(new_options);
-                FREE(new_values);
-                API_ERROR(0, E_NOMEM);
-            }
+    free(version);
 
-            optlist->maxopts = new_maxopts;
-            optlist->options = new_options;
-            optlist->values  = new_values;
-        }
+    retval = db_compare_version_digits(a_digits, b_digits, 3) >= 0; 
 
+    if (unknown)
+    {
+        if (retval)
+            retval = -1;
     }
-    API_END;
 
-    return(0);
+    return retval;
 }
 
-/*----------------------------------------------------------------------
- *  Routine                                                DBClearOption
- *
- *  Purpose
- *
- *      Remove a given option from the given optlist and re-order
- *      the remaining options.
+/*-------------------------------------------------------------------------
+ * Function:    DBFileName
  *
- *  Programmer
+ * Purpose:     Return the name of the associated file.
  *
- *      Mark C. Miller, August 18, 2005 
+ * Returns:     ptr to string holding the name of the file or "unknown".
  *
- *--------------------------------------------------------------------*/
-PUBLIC int
-DBClearOption(DBoptlist *optlist, int option)
+ * Programmer:  Mark C. Miller, Tue May 24 12:45:53 PDT 2016
+ *-------------------------------------------------------------------------*/
+PUBLIC char const *
+DBFileName(const DBfile *dbfile)
 {
-    int            i, j, foundit=0;
-
-    API_BEGIN("DBClearOption", int, -1) {
-        if (!optlist || optlist->numopts < 0) {
-            API_ERROR("optlist pointer", E_BADARGS);
-        }
-
-        /* Shift values down in list by one entry */
-        for (i = 0; i < optlist->numopts; i++) {
-            if (optlist->options[i] == option) {
-                foundit = 1;
-                for (j = i; j < optlist->numopts-1; j++) {
-                    optlist->options[j] = optlist->options[j+1];
-                    optlist->values[j]  = optlist->values[j+1];
-                }
-                break;
-            }
-        }
-
-        if (foundit) {
-            optlist->numopts--;
-            optlist->options[optlist->numopts] = 0;
-            optlist->values[optlist->numopts]  = 0;
-        }
-    }
-    API_END;
-
-    return(0);
+    static char name[256];
+    if (dbfile->pub.name)
+        strcpy(name, dbfile->pub.name);
+    else
+        strcpy(name, "unknown");
+    return name;
 }
 
-/*----------------------------------------------------------------------
- *  Routine                                                DBGetOption
- *
- *  Purpose
- *
- *      Return value set for a given option from the given optlist.
- *
- *  Programmer
- *
- *      Mark C. Miller, August 18, 2005 
- *
- *  Modifications:
- *
- *      Mark C. Miller, Wed Jul 14 20:35:50 PDT 2010
- *      Replaced 'return' with 'API_RETURN'
- *
- *      Mark C. Miller, Tue Aug 10 23:49:51 PDT 2010
- *      Removed API_BEGIN/END stuff so that function can be handed
- *      a null optlist and it will behave well.
- *--------------------------------------------------------------------*/
-PUBLIC void * 
-DBGetOption(const DBoptlist *optlist, int option)
+static void
+db_InitFileGlobals(DBfile *dbfile, int mode)
 {
-    int            i;
+    int i;
 
-    if (!optlist) return 0;
+    dbfile->pub.file_scope_globals = (SILO_Globals_t*) malloc(sizeof(SILO_Globals_t));
+    /* since most entries are ints and we want to init them to the NOT-SET value
+       this call averts *some* mistakes where SILO_Globals_t might get updated with
+       new int members but failed to be explicitly initialize here. The value of
+       DB_INTBOOL_NOT_SET is accepted as int but is ultimately cast to unsigned char
+       internally in memset(). Given that its integer value is -1 (0xFFFFFFFF), its
+       conversion to unsigned char will be 0xFF and will have the effect of setting
+       all int members of SILO_Globals_t to -1 or DB_INTBOOL_NOT_SET. */
+    memset(dbfile->pub.file_scope_globals, DB_INTBOOL_NOT_SET, sizeof(SILO_Globals_t));
 
-    /* find the given option in the optlist and return its value */
-    for (i = 0; i < optlist->numopts; i++)
-        if (optlist->options[i] == option)
-            return optlist->values[i];
+    /* Initialize to NOT-SET values so that, initially, a file is set to
+       inheret *and* track all behaviors from Silo's globals. The first time
+       any of these values are changed to a NOT_SET value, then forevermore, 
+       that particular behavior is governed by the file */
+    dbfile->pub.file_scope_globals->dataReadMask            = DB_MASK_NOT_SET;
+    dbfile->pub.file_scope_globals->allowOverwrites         = DB_INTBOOL_NOT_SET;
+    dbfile->pub.file_scope_globals->allowEmptyObjects       = DB_INTBOOL_NOT_SET;
+    dbfile->pub.file_scope_globals->enableChecksums         = DB_INTBOOL_NOT_SET;
+    dbfile->pub.file_scope_globals->enableFriendlyHDF5Names = DB_INTBOOL_NOT_SET;
+    dbfile->pub.file_scope_globals->enableGrabDriver        = DB_INTBOOL_NOT_SET;
+    dbfile->pub.file_scope_globals->darshanEnabled          = DB_INTBOOL_NOT_SET;
+    dbfile->pub.file_scope_globals->allowLongStrComponents  = DB_INTBOOL_NOT_SET;
+    dbfile->pub.file_scope_globals->maxDeprecateWarnings    = DB_INTBOOL_NOT_SET;
+#ifndef _WIN32
+#warning ADD compressionMinSize
+#endif
+    dbfile->pub.file_scope_globals->compressionMinratio     = DB_FLOAT_NOT_SET;
+#ifndef _WIN32
+#warning CORRECT INITIALIZATION OF compressionErrmode
+#endif
+    dbfile->pub.file_scope_globals->compressionErrmode      = DB_INTBOOL_NOT_SET;
+    dbfile->pub.file_scope_globals->compatibilityMode       = DB_INTBOOL_NOT_SET;
+    dbfile->pub.file_scope_globals->compressionParams       = (char*) DB_CHAR_PTR_NOT_SET;
+    dbfile->pub.file_scope_globals->dedupParams             = (char*) DB_CHAR_PTR_NOT_SET;
+    dbfile->pub.file_scope_globals->floatStorage            = DB_INTBOOL_NOT_SET;
+    dbfile->pub.file_scope_globals->allocFunc               = (DBAllocFunc) DB_VOID_PTR_NOT_SET;
+    dbfile->pub.file_scope_globals->freeFunc                = (DBFreeFunc) DB_VOID_PTR_NOT_SET;
+    dbfile->pub.file_scope_globals->allocUser               = 0;
+    dbfile->pub.file_scope_globals->arena                   = (DBarena*) DB_VOID_PTR_NOT_SET;
+    dbfile->pub.file_scope_globals->_db_err_level           = DB_INTBOOL_NOT_SET;
+    dbfile->pub.file_scope_globals->_db_err_func            = DB_VOID_PTR_NOT_SET;
+    dbfile->pub.file_scope_globals->_db_err_level_drvr      = DB_INTBOOL_NOT_SET;
 
-    return 0;
+    /* Jstk only relevant for lib as a whole, not specific to a file */
+    dbfile->pub.file_scope_globals->Jstk = 0;
+
+    for (i = 0; i < MAX_FILE_OPTIONS_SETS; i++)
+        dbfile->pub.file_scope_globals->fileOptionsSets[i] = 0;
+
+    /* If compatibility is set in mode, then set it in file_scope_globals too */
+    if (mode & 0x000000F0)
+        dbfile->pub.file_scope_globals->compatibilityMode = mode & 0x000000F0;
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetToc
+ * Function:    DBOpen
  *
- * Purpose:     Return a pointer to table of contents of the file.  Note
- *              that the pointer is the same as the one in the DBfile
- *              so it should not be modified and may become invalid after
- *              calling the next silo routine.
+ * Purpose:     Open a data file.
  *
- * Return:      Success:        Pointer to the table of contents structure.
+ * Return:      Success:        pointer to new file descriptor
  *
  *              Failure:        NULL
  *
  * Programmer:  matzke@viper
- *              Mon Nov  7 10:35:47 PST 1994
+ *              Mon Nov  7 10:25:08 PST 1994
  *
  * Modifications:
- *    Eric Brugger, Fri Jan 27 08:23:43 PST 1995
- *    I changed the interface and function of the routine.
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
  *
- *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
- *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
- *-------------------------------------------------------------------------*/
-PUBLIC DBtoc  *
-DBGetToc(DBfile *dbfile)
-{
-    API_BEGIN2("DBGetToc", DBtoc *, NULL, api_dummy) {
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("", E_GRABBED) ; 
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-
-        DBNewToc(dbfile);
-        API_RETURN(dbfile->pub.toc);
-    }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
-}
-
-/*-------------------------------------------------------------------------
- * Function:    DBInqVarType
+ *    Robb Matzke, Tue Feb 28 10:51:19 EST 1995
+ *    When a file is opened, it is given a unique ID number wrt all other
+ *    open files.  The ID is a small integer [0..DB_NFILES-1].
  *
- * Purpose:     Return the DBObjectType for a given object name
+ *    Robb Matzke, Tue Feb 28 11:38:08 EST 1995
+ *    For each registered filter, call the non-null `init' functions for
+ *    every file that is opened.
  *
- * Return:      Success:        the ObjectType for the given object
+ *    Sean Ahern, Mon Jan  8 17:38:18 PST 1996
+ *    Added the mode parameter.
  *
- *              Failure:        DB_INVALID_OBJECT
+ *    Lisa J. Nafziger, Wed Mar  6 10:20:48 PST 1996
+ *    Added code to check for file existence, to check if it is a
+ *    directory and to check for read permission.  This allows more
+ *    specific error messages to be returned.
  *
- * Programmer:  Sean Ahern,
- *              Wed Oct 28 14:46:53 PST 1998
+ *    Lisa J. Nafziger, Tue Mar 12 14:15:06 PST 1996
+ *    Modified code to check file attributes so that stat() rather
+ *    than access() is used.  The former is POSIX compliant.
  *
- * Modifications:
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
+ *    Eric Brugger, Tue Jun 17 10:25:57 PDT 1997
+ *    I modified the routine to only check file validity if the type
+ *    is not an SDX connection.
  *
- *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
- *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
- *-------------------------------------------------------------------------*/
-PUBLIC DBObjectType
-DBInqVarType(DBfile *dbfile, char const *varname)
-{
-    DBObjectType retval;
-
-    API_BEGIN2("DBInqVarType", DBObjectType, DB_INVALID_OBJECT, api_dummy) {
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("", E_GRABBED) ; 
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (!varname || !*varname)
-            API_ERROR("variable name", E_BADARGS);
-        if (!dbfile->pub.inqvartype)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
-
-        retval = (dbfile->pub.inqvartype) (dbfile, varname);
-        API_RETURN(retval);
-    }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
-}
-
-/*-------------------------------------------------------------------------
- * Function:    DBNewToc
+ *    Jeremy Meredith, Fri Jul 23 09:31:14 PDT 1999
+ *    I added error reporting to the result of stat().
  *
- * Purpose:     Used to be called `DBGetToc', this function installs a
- *              new table of contents in the specified file from that
- *              file's current working directory.  The old table of contents
- *              is destroyed.
+ *    Jeremy Meredith, Mon Jul 26 10:39:49 PDT 1999
+ *    Made stat() error reporting POSIX.1 compliant.
  *
- * Return:      Success:        0
+ *    Sean Ahern, Wed Jul  5 15:35:48 PDT 2000
+ *    Renamed the function to DBOpenReal.  Client code now calls a macro
+ *    called DBOpen.
  *
- *              Failure:        -1
+ *    Mark C. Miller, Wed Feb  2 07:59:53 PST 2005
+ *    Added printing of error message from stat() with strerror
  *
- * Programmer:  robb@cloud
- *              Tue Mar  7 10:26:23 EST 1995
+ *    Mark C. Miller, Wed Feb 23 08:51:35 PST 2005
+ *    Added code to reset _db_fstatus slot to 0 if open fails
  *
- * Modifications:
- *              Robb Matzke, 2000-05-23
- *              If nothing has changed then this function just returns
- *              success, leaving the original table of contents in place.
- *              Any function that potentially changes the table of
- *              contents should call db_FreeToc() on the file handle.
- *-------------------------------------------------------------------------*/
-PUBLIC int
-DBNewToc(DBfile *dbfile)
+ *    Thomas R. Treadway, Tue Jun 27 13:59:21 PDT 2006
+ *    Added HAVE_STRERROR wrappers
+ *
+ *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
+ *    Added code to register the returned file pointer
+ *
+ *    Mark C. Miller, Mon Jan 12 20:50:41 PST 2009
+ *    Removed DB_SDX conditionally compiled code blocks.
+ *
+ *    Mark C. Miller, Wed Feb 25 23:50:06 PST 2009
+ *    Moved call to db_isregistered_file to AFTER calls to stat the file
+ *    add changed db_isregistered_file to accept stat struct instead of name.
+ *    Changed call to db_register_file to accpet stat struct.
+ *
+ *    Mark C. Miller, Fri Feb 12 08:22:41 PST 2010
+ *    Replaced stat/stat64 calls with db_silo_stat. Replaced conditional
+ *    compilation logic for SIZEOF_OFF64_T with db_silo_stat_struct.
+ *------------------------------------------------------------------------- */
+PUBLIC DBfile *
+DBOpenReal(const char *name, int type, int mode)
 {
-    int retval;
+    char           ascii[16];
+    DBfile        *dbfile;
+    int            fileid, i;
+    int            origtype = type;
+    int            opts_set_id;
+    db_silo_stat_t filestate;
 
-    API_BEGIN("DBNewToc", int, -1) {
-        if (!dbfile)
+    API_BEGIN("DBOpen", DBfile *, NULL) {
+        if (DB_NOBJ_TYPES != _db_nobj_types)
+            API_ERROR("Silo TOC not configured corretly", E_INTERNAL);
+
+        if (!name)
             API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("", E_GRABBED) ; 
-        if (!dbfile->pub.newtoc)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
-        if (dbfile->pub.toc)
-            API_RETURN(0);
-        retval = (dbfile->pub.newtoc) (dbfile);
-        API_RETURN(retval);
-    }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
-}
-
-/*
-This logic is necessary to support callers accessing standard (e.g. non-DB_USERDEF)
-objects via the generic interface to ensure logic for specially handled component
-values is consistent with the standard object's DBGetXXX methods.
-To ensure a zero for the component in the file means either not-present or
-not-set, certain components, especially those for which a zero value is a valid
-value for the data producer to use, special handling is required and that logic
-is sprinkled about in the DBPutXXX and DBGetXXX methods of the drivers and so
-to is it required here. Its a nasty maintenance issue.
-*/
-
-static int
-db_IsComponentNameStandardWithSpecialHandling(char const *compname)
-{
-    if (!strcmp(compname, "missing_value")) return 1;
-    if (!strcmp(compname, "topo_dim")) return 1;
-    if (!strcmp(compname, "repr_block_idx")) return 1;
-    return 0;
-}
-
-/* For use in the DBGetComponent call */
-static void
-db_AdjustSpeciallyHandledStandardObjectComponentValue(
-    void *val_ptr, int obj_type, char const *comp_name)
-{
-    if (!val_ptr || !comp_name) return;
-
-    if (!strcmp(comp_name, "missing_value") &&
-        (obj_type == DB_UCDVAR || obj_type == DB_QUADVAR || obj_type == DB_CURVE ||
-         obj_type == DB_POINTVAR || obj_type == DB_MULTIVAR))
-    {
-        double val_for_mem, val_from_file = *((double*)val_ptr);
-        db_SetMissingValueForGet(val_for_mem, val_from_file);
-        *((double*)val_ptr) = val_for_mem;
-    }
-    else if (!strcmp(comp_name, "repr_block_idx") &&
-        (obj_type == DB_MULTIMESH || obj_type == DB_MULTIVAR ||
-         obj_type == DB_MULTIMAT || obj_type == DB_MULTIMATSPECIES))
-    {
-        int val_for_mem, val_from_file = *((int*)val_ptr);
-        val_for_mem = val_from_file - 1;
-        *((int*)val_ptr) = val_for_mem;
-    }
-    else if (!strcmp(comp_name, "topo_dim") &&
-        (obj_type == DB_MULTIMESH || obj_type == DB_UCDMESH))
-    {
-        int val_for_mem, val_from_file = *((int*)val_ptr);
-        val_for_mem = val_from_file - 1;
-        *((int*)val_ptr) = val_for_mem;
-    }
-}
 
-/* For use in the DBGetObject call */
-static void
-db_AdjustSpeciallyHandledStandardObjectComponentValues(DBobject *obj)
-{
-    int i, obj_type;
+        /* deal with extended driver type specifications */
+        db_DriverTypeAndFileOptionsSetId(origtype, &type, &opts_set_id);
 
-    if (!obj) return;
+        if (type < 0 || type >= DB_NFORMATS) {
+            sprintf(ascii, "%d", type);
+            API_ERROR(ascii, E_BADFTYPE);
+        }
+        if (((mode & 0x0000000F) != DB_READ) && ((mode & 0x0000000F) != DB_APPEND))
+        {
+            sprintf(ascii, "%d", mode);
+            API_ERROR(ascii, E_BADARGS);
+        }
+        if (!DBOpenCB[type]) {
+            sprintf(ascii, "%d", type);
+            API_ERROR(ascii, E_NOTIMP);
+        }
 
-    obj_type = DBGetObjtypeTag(obj->type);
-    if (obj_type == DB_USERDEF) return;
+        /****************************************************/
+        /* Check to make sure the file exists and has the   */
+        /* correct permissions.                             */
+        /****************************************************/
+        if (db_silo_stat(name, &filestate, type==DB_UNKNOWN?-1:opts_set_id) != 0)
+        {
+            if( errno == ENOENT )
+            {
+                /********************************/
+                /* File doesn't exist.          */
+                /********************************/
+                API_ERROR((char *)name, E_NOFILE);
+            }
+            else
+            {
+                /********************************/
+                /* System level error occured.  */
+                /********************************/
+#if SIZEOF_OFF64_T > 4 && (defined(HAVE_STAT64) || !defined(HAVE_STAT))
+                printf("stat64() failed with error: ");
+#else
+                printf("stat() failed with error: ");
+#endif
+                switch (errno)
+                {
+                  case EACCES:       printf("EACCES\n");       break;
+                  case EBADF:        printf("EBADF\n");        break;
+                  case ENAMETOOLONG: printf("ENAMETOOLONG\n"); break;
+                  case ENOTDIR:      printf("ENOTDIR\n");      break;
+#ifdef EOVERFLOW
+                  case EOVERFLOW:    
+#ifdef HAVE_STRERROR
+                                     printf("EOVERFLOW: \"%s\"\n", 
+                                        strerror(errno));
+#else
+                                     printf("EOVERFLOW: errno=%d\n", errno);
+#endif
+                                     printf("Silo may need to be re-compiled with "
+                                            "Large File Support (LFS)\n");
+                                     break;
+#endif
+                  default:           
+#ifdef HAVE_STRERROR
+                                     printf("\"%s\"\n",
+                                        strerror(errno));
+#else
+                                     printf("errno=%d\n", errno);
+#endif
+                                     break;
+                }
+                API_ERROR((char *)name, E_SYSTEMERR);
+            }
+        }
 
-    for (i = 0; i < obj->ncomponents; i++)
-    {
-        char tmp[256];
+        /* Check if file is already opened. If so, none can
+           have it opened for write, including this new one */ 
+        i = db_isregistered_file(0, &filestate);
+        if (i != -1)
+        {
+            if (_db_regstatus[i].w != 0 || (mode & 0x0000000F) != DB_READ)
+                API_ERROR(name, E_CONCURRENT);
+        }
 
-        if (!strcmp(obj->comp_names[i], "missing_value") &&
-            (obj_type == DB_UCDVAR || obj_type == DB_QUADVAR || obj_type == DB_CURVE ||
-             obj_type == DB_POINTVAR || obj_type == DB_MULTIVAR))
+        if( ( filestate.s.st_mode & S_IFDIR ) != 0 )
         {
-            double val_for_mem, val_from_file = strtod(obj->pdb_names[i]+4,0);
-            db_SetMissingValueForGet(val_for_mem, val_from_file);
-            sprintf(tmp, "'<d>%.30g'", val_for_mem);
+            /************************************/
+            /* File is actually a directory.    */
+            /************************************/
+            API_ERROR((char *)name, E_FILEISDIR);
         }
-        else if (!strcmp(obj->comp_names[i], "repr_block_idx") &&
-            (obj_type == DB_MULTIMESH || obj_type == DB_MULTIVAR ||
-             obj_type == DB_MULTIMAT || obj_type == DB_MULTIMATSPECIES))
+        if( ( filestate.s.st_mode & S_IREAD ) == 0 )
         {
-            int val_for_mem, val_from_file = (int) strtol(obj->pdb_names[i]+4,0,10);
-            val_for_mem = val_from_file - 1;
-            sprintf(tmp, "'<i>%d'", val_for_mem);
+            /****************************************/
+            /* File is missing read permissions.    */
+            /****************************************/
+            API_ERROR((char *)name, E_FILENOREAD);
         }
-        else if (!strcmp(obj->comp_names[i], "topo_dim") &&
-            (obj_type == DB_MULTIMESH || obj_type == DB_UCDMESH))
+        if (DB_READ!=(mode&0x0000000F) && (filestate.s.st_mode & S_IWUSR) == 0)
         {
-            int val_for_mem, val_from_file = (int) strtol(obj->pdb_names[i]+4,0,10);
-            val_for_mem = val_from_file - 1;
-            sprintf(tmp, "'<i>%d'", val_for_mem);
+            /****************************************/
+            /* File is open for write and missing write permission. */
+            /****************************************/
+            API_ERROR((char *)name, E_FILENOWRITE);
         }
-        else
+
+        if ((fileid = db_get_fileid(DB_ISOPEN)) < 0)
+            API_ERROR((char *)name, E_MAXOPEN);
+        if (NULL == (dbfile = (DBOpenCB[type]) (name, mode, opts_set_id)))
         {
-            continue;
+            _db_fstatus[fileid] = 0;
+            API_RETURN(NULL);
+        }
+        dbfile->pub.fileid = fileid;
+        db_InitFileGlobals(dbfile, mode);
+        db_stats_file(dbfile);
+        db_register_file(dbfile, &filestate, (mode&0x0000000F)!=DB_READ);
+
+        /*
+         * Install filters.  First, all `init' filters, then the
+         * specified filters.
+         */
+        for (i = 0; i < DB_NFILTERS; i++) {
+            if (_db_filter[i].name && _db_filter[i].init) {
+                (void)(_db_filter[i].init) (dbfile, _db_filter[i].name);
+            }
         }
+        db_filter_install(dbfile);
+        if (DBInqVarExists(dbfile, SILO_VSTRING_NAME))
+            dbfile->pub.file_lib_version = (char*)DBGetVar(dbfile, SILO_VSTRING_NAME);
 
-        FREE(obj->pdb_names[i]);
-        obj->pdb_names[i] = STRDUP(tmp);
+        API_RETURN(dbfile);
     }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-/*----------------------------------------------------------------------
- *  Routine                                                DBGetComponent
- *
- *  Purpose
- *
- *      Return the requested component value for the given object.
- *
- *  Programmer
- *
- *      Jeffery W. Long, NSSD-B
+/*-------------------------------------------------------------------------
+ * Function:    DBCreateReal
  *
- *  Parameters
+ * Purpose:     Create a data file
  *
- *      dbfile           {In}    {Pointer to current file}
- *      objname          {In}    {Name of object to inquire about}
- *      compname         {In}    {Name of component to return}
+ * Return:      Success:        pointer to file descriptor
  *
- *  Notes
+ *              Failure:        NULL
  *
- *  Modified
- *    Robb Matzke, Tue Nov 8 08:22:42 PST 1994
- *    Added error mechanism
+ * Programmer:  matzke@viper
+ *              Mon Nov  7 10:29:23 PST 1994
  *
+ * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
  *    I replaced API_END with API_END_NOPOP.
  *
- *    Eric Brugger, Wed Mar 10 16:59:34 PST 1999
- *    Changed API_BEGIN2 to API_BEGIN so that Silo directory information
- *    would be processed at the driver level, since the pdb driver
- *    version of this routine handles silo directory paths as well as
- *    file system directory paths, which API_BEGIN2 does not.
- *
- *    Eric Brugger, Thu Mar 11 12:33:15 PST 1999
- *    I forgot to remove the fourth argument when I changed API_BEGIN2
- *    to API_BEGIN.  I did so now.
+ *    Robb Matzke, Tue Feb 28 10:57:06 EST 1995
+ *    A file ID is assigned to the new file.
  *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
+ *    Robb Matzke, 15 May 1996
+ *    Removed the unused `statue' auto variable.
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
+ *    Sean Ahern, Wed Jul  5 15:35:48 PDT 2000
+ *    Renamed the function to DBCreateReal.  Client code now calls a macro
+ *    called DBCreate.
+ *
+ *    Mark C. Miller, Wed Feb 23 08:51:35 PST 2005
+ *    Added code to reset _db_fstatus slot to 0 if create fails
+ *
+ *    Mark C. Miller, Wed Apr  5 10:17:31 PDT 2006
+ *    Added code to output silo library version string to the file
+ *
+ *    Mark C. Miller, Mon Nov 19 10:45:05 PST 2007
+ *    Added hdf5 driver warning.
  *
  *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
- *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
- *--------------------------------------------------------------------*/
-PUBLIC void   *
-DBGetComponent(DBfile *dbfile, char const *objname, char const *compname)
+ *    Added code to register the returned file pointer
+ *
+ *    Mark C. Miller, Mon Nov 17 19:04:39 PST 2008
+ *    Added code to check to see if name is a directory.
+ *
+ *    Mark C. Miller, Wed Feb 25 23:52:05 PST 2009
+ *    Moved call to db_isregistered_file to after stat calls. Stat the
+ *    file after its created so we can get information to register it.
+ *
+ *    Mark C. Miller, Fri Feb 12 08:22:41 PST 2010
+ *    Replaced stat/stat64 calls with db_silo_stat. Replaced conditional
+ *    compilation logic for SIZEOF_OFF64_T with db_silo_stat_struct.
+ *
+ *    Mark C. Miller, Thu Aug 30 17:41:24 PDT 2012
+ *    Added logic to temporarily disable any compression settings prior
+ *    to writing silo library info and then re-enabling it.
+ *-------------------------------------------------------------------------*/
+PUBLIC DBfile *
+DBCreateReal(const char *name, int mode, int target, const char *info, int type)
 {
-    void *retval = NULL;
+    char           ascii[16];
+    char           *tmpcs = 0;
+    DBfile        *dbfile;
+    int            fileid, i, n;
+    int            origtype = type;
+    int            opts_set_id = 0;
+    db_silo_stat_t filestate;
 
-    API_BEGIN2("DBGetComponent", void *, NULL, api_dummy) {
-        if (!dbfile)
+    API_BEGIN("DBCreate", DBfile *, NULL) {
+        if (DB_NOBJ_TYPES != _db_nobj_types)
+            API_ERROR("Silo TOC not configured corretly", E_INTERNAL);
+
+        if (!name)
             API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetComponent", E_GRABBED) ; 
-        if (!objname || !*objname)
-            API_ERROR("object name", E_BADARGS);
-        if (!compname || !*compname)
-            API_ERROR("component name", E_BADARGS);
-        if (!dbfile->pub.g_comp)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_comp) (dbfile, objname, compname);
+        /* deal with extended driver type specifications */
+        db_DriverTypeAndFileOptionsSetId(origtype, &type, &opts_set_id);
 
-        if (db_IsComponentNameStandardWithSpecialHandling(compname))
-            db_AdjustSpeciallyHandledStandardObjectComponentValue(retval,
-                DBInqVarType(dbfile, objname), compname);
+        if (type < 0 || type >= DB_NFORMATS) {
+            sprintf(ascii, "%d", type);
+            API_ERROR(ascii, E_BADFTYPE);
+        }
 
-        API_RETURN(retval);
+        if (db_silo_stat(name, &filestate, opts_set_id) == 0)  /* Success - File exists */
+        {
+            if ((mode & 0x0000000F) == DB_NOCLOBBER)
+            {
+                API_ERROR((char *)name, E_FEXIST);
+            }
+            if ((filestate.s.st_mode & S_IFDIR) != 0)
+            {
+                API_ERROR((char *)name, E_FILEISDIR);
+            }
+
+            /* Check if file is already opened. If so, none can
+               have it opened for write, including this new one */
+            i = db_isregistered_file(0, &filestate);
+            if (i != -1)
+            {
+                API_ERROR(name, E_CONCURRENT);
+            }
+        }
+
+        if (!DBCreateCB[type]) {
+            sprintf(ascii, "%d", type);
+            if (type == 7)
+            {
+                API_ERROR(ascii, E_NOHDF5);
+            }
+            else
+            {
+                API_ERROR(ascii, E_NOTIMP);
+            }
+        }
+
+        if ((fileid = db_get_fileid(DB_ISOPEN)) < 0)
+            API_ERROR((char *)name, E_MAXOPEN);
+        dbfile = ((DBCreateCB[type]) (name, mode, target, opts_set_id,
+                                      info));
+        if (!dbfile)
+        {
+            _db_fstatus[fileid] = 0;
+            API_RETURN(NULL);
+        }
+        dbfile->pub.fileid = fileid;
+        db_InitFileGlobals(dbfile, mode);
+        db_stats_file(dbfile);
+        db_silo_stat(name, &filestate, opts_set_id);
+        db_register_file(dbfile, &filestate, 1);
+
+        /*
+         * Install filters.  First all `init' routines, then the specified
+         * `open' routines.
+         */
+        for (i = 0; i < DB_NFILTERS; i++) {
+            if (_db_filter[i].name && _db_filter[i].init) {
+                (void)(_db_filter[i].init) (dbfile, _db_filter[i].name);
+            }
+        }
+        db_filter_install(dbfile);
+
+        /* write silo library version information to the file */
+        /* Temporarily turn off any compression settings and then re-enable */
+        if (DBGetCompression())
+        {
+    
+            n = strlen(DBGetCompression());
+            tmpcs = ALLOC_N(char,n+1);
+            strncpy(tmpcs, DBGetCompression(), n);
+            tmpcs[n] = '\0';
+            DBSetCompression(0);
+        }
+        n = strlen(SILO_VSTRING)+1;
+        DBWrite(dbfile, SILO_VSTRING_NAME, SILO_VSTRING, &n, 1, DB_CHAR);
+        dbfile->pub.file_lib_version = STRDUP(SILO_VSTRING);
+        if (tmpcs)
+        {
+            DBSetCompression(tmpcs);
+            FREE(tmpcs);
+        }
+
+        API_RETURN(dbfile);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-/*----------------------------------------------------------------------
- *  Routine                                           DBGetComponentType
+/*-------------------------------------------------------------------------
+ * Function:    DBClose
  *
- *  Purpose
+ * Purpose:     Close the specified data file and return NULL.
  *
- *      Return the type of a component for the given object.
+ * Return:      Success:        NULL
  *
- *  Programmer
+ *              Failure:        NULL
  *
- *      Brad Whitlock, Thu Jan 20 11:54:54 PDT 2000
+ * Programmer:  matzke@viper
+ *              Mon Nov  7 10:31:41 PST 1994
  *
- *  Parameters
+ * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
  *
- *      dbfile           {In}    {Pointer to current file}
- *      objname          {In}    {Name of object to inquire about}
- *      compname         {In}    {Name of component to return}
+ *    Eric Brugger, Mon Feb 27 15:03:01 PST 1995
+ *    I changed the return value to be an integer instead of a pointer
+ *    to a DBfile.
  *
- *  Modified
+ *    Robb Matzke, Tue Feb 28 10:57:57 EST 1995
+ *    The file status slot is cleared so it can be reused.
+ *
+ *    Eric Brugger, Mon Jul 10 07:42:24 PDT 1995
+ *    I moved the reseting of _db_fstatus to before the return statement,
+ *    so that the instruction would get executed.
  *
  *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
  *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
- *--------------------------------------------------------------------*/
-
+ *    Added code to UNregister the given file pointer.
+ *-------------------------------------------------------------------------*/
 PUBLIC int
-DBGetComponentType(DBfile *dbfile, char const *objname, char const *compname)
+DBClose(DBfile *dbfile)
 {
-    int retval = DB_NOTYPE;
+    int            id;
+    int            retval;
+    SILO_Globals_t *tmp_file_scope_globals;
 
-    API_BEGIN2("DBGetComponentType", int, DB_NOTYPE, api_dummy) {
+    API_BEGIN2("DBClose", int, -1, api_dummy) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("", E_GRABBED) ; 
-        if (!objname || !*objname)
-            API_ERROR("object name", E_BADARGS);
-        if (!compname || !*compname)
-            API_ERROR("component name", E_BADARGS);
-        if (!dbfile->pub.g_comptyp)
+        if (NULL == dbfile->pub.close)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
+#ifndef _WIN32
+#warning IS ORDER OF OPS CORRECT HERE
+#endif
+        id = dbfile->pub.fileid;
+        if (id >= 0 && id < DB_NFILES)
+            _db_fstatus[id] = 0;
 
-        retval = (dbfile->pub.g_comptyp) (dbfile, objname, compname);
+        if (dbfile->pub.file_lib_version)
+            free(dbfile->pub.file_lib_version);
+        db_unregister_file(dbfile);
+
+	tmp_file_scope_globals = dbfile->pub.file_scope_globals; 
+        retval = (dbfile->pub.close) (dbfile);
+        db_stats_forget(id);
+        if (tmp_file_scope_globals->dedupParams != DB_CHAR_PTR_NOT_SET)
+            FREE(tmp_file_scope_globals->dedupParams);
+        free(tmp_file_scope_globals);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-/*----------------------------------------------------------------------
- *  Routine                                                     DBGetDir
+
+/*-------------------------------------------------------------------------
+ * Function:    DBFlush
  *
- *  Purpose
+ * Purpose:     Flush the specified file contents to disk.
  *
- *      Get the name of the current directory, return in space provided.
+ * Return:      Success:        NULL
  *
- *  Modified
- *    Robb Matzke, Tue Nov 8 08:48:12 PST 1994
- *    Added error mechanism
+ *              Failure:        NULL
  *
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
+ * Programmer:  Mark C. Miller, Fri Nov  6 09:38:05 PST 2015
  *
- *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
- *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
- *--------------------------------------------------------------------*/
+ * Modifications:
+ *-------------------------------------------------------------------------*/
 PUBLIC int
-DBGetDir(DBfile *dbfile, char *path)
+DBFlush(DBfile *dbfile)
 {
-    int retval;
+    int            id;
+    int            retval;
 
-    API_BEGIN2("DBGetDir", int, -1, api_dummy) {
+    API_BEGIN2("DBFlush", int, -1, api_dummy) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetDir", E_GRABBED) ; 
-        if (!path)
-            API_ERROR("path", E_BADARGS);
-        if (!dbfile->pub.g_dir)
+        if (NULL == dbfile->pub.flush)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
-
-        retval = (dbfile->pub.g_dir) (dbfile, path);
+        retval = (dbfile->pub.flush) (dbfile);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBSetDir
- *
- * Purpose:     Sets the current directory within the database.
+/*----------------------------------------------------------------------
+ * Routine:  db_inq_file_has_silo_objects_r
  *
- * Return:      Success:        0
+ * Purpose:  Recursive helper func for DBInqFileHasObjects 
  *
- *              Failure:        -1
- *
- * Programmer:  robb@cloud
- *              Wed Nov  9 13:09:23 EST 1994
+ * Programmer: Mark C. Miller, Wed Sep 23 11:34:01 PDT 2009
  *
  * Modifications:
- *    Robb Matzke, Mon Nov 21 21:31:17 EST 1994
- *    Added error mechanism.
+ *   Mark C. Miller, Mon Nov 16 10:28:41 PST 2009
+ *   Fixed dir recursion by copying dir-related toc entries. Removed
+ *   misc. vars from count of silo objects.
+ *--------------------------------------------------------------------*/
+
+PRIVATE int
+db_inq_file_has_silo_objects_r(DBfile *f)
+{
+    int i, ndir, retval = 0;
+    char **dirnames;
+    DBtoc *toc = DBGetToc(f);
+
+    if (!toc)
+        return -1;
+
+    /* save dirnames so we don't loose 'em as we get new tocs */
+    ndir = toc->ndir;
+    dirnames = (char **) malloc(ndir * sizeof(char*));
+    for (i = 0; i < ndir; i++)
+        dirnames[i] = STRDUP(toc->dir_names[i]);
+     
+    /* We exclude dirs and misc. vars because a non-Silo file may
+     * contain them. */
+    retval = toc->ncurve + toc->ncsgmesh + toc->ncsgvar + toc->ndefvars +
+        toc->nmultimesh + toc->nmultimeshadj + toc->nmultivar +
+        toc->nmultimat + toc->nmultimatspecies + toc->nqmesh +
+        toc->nqvar + toc->nucdmesh + toc->nucdvar + toc->nptmesh +
+        toc->nptvar + toc->nmat + toc->nmatspecies +
+        toc->nobj + toc->nmrgtree + toc->ngroupelmap +
+        toc->nmrgvar + toc->narray;
+
+    /* Recurse on directories. */
+    for (i = 0; i < ndir && retval == 0; i++)
+    {
+        DBSetDir(f, dirnames[i]);
+        retval += db_inq_file_has_silo_objects_r(f);
+        DBSetDir(f, "..");
+    }
+
+    /* free the dirnames */
+    for (i = 0; i < ndir; i++)
+        free(dirnames[i]);
+    free(dirnames);
+
+    return retval;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBInqFileHasObjects
  *
- *    Robb Matzke, Fri Jan 6 07:34:29 PST 1995
- *    Checkes for changing to `.' since that is a no-op.
+ * Purpose:     See if the file contains any silo objects, excluding
+ *              directories in the search.
  *
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
+ * Return:      Success:         >0 ==> yes, the file has silo objects.
+ *                              ==0 ==> no, the file has no silo objects.
  *
- *    Robb Matzke, 2000-05-23
- *    The old table of contents is discarded if the directory changes.
+ *              Failure:        -1 
  *
- *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
- *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ * Programmer:  Mark C. Miller, Wed Sep 23 09:42:27 PDT 2009
+ *
+ * Modifications:
+ *   Mark C. Miller, Mon Nov 16 10:29:36 PST 2009
+ *   Added logic to test from some well known, tell-tale silo variables.
  *-------------------------------------------------------------------------*/
+
 PUBLIC int
-DBSetDir(DBfile *dbfile, const char *path)
+DBInqFileHasObjects(DBfile *f)
 {
-    char           tmp[256];
+    char cwd[4096];
     int retval;
 
-    API_BEGIN2("DBSetDir", int, -1, api_dummy) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBSetDir", E_GRABBED) ; 
-        if (!path || !*path)
-            API_ERROR("path", E_BADARGS);
-        if (STR_EQUAL(path, "."))
-        {
-            API_RETURN(0);
-        }
-        if (DBGetDir(dbfile, tmp) < 0)
-            API_ERROR("DBGetDir", E_CALLFAIL);
-        if (STR_EQUAL(tmp, path))
-        {
-            API_RETURN(0);
-        }
-        if (!dbfile->pub.cd)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+    if (f == 0)
+        return -1;
 
-        retval = (dbfile->pub.cd) (dbfile, path);
-        db_FreeToc(dbfile);
-        API_RETURN(retval);
-    }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    if (DBInqVarExists(f, "_silolibinfo"))
+        return 1;
+    if (DBInqVarExists(f, "_hdf5libinfo"))
+        return 1;
+
+    DBGetDir(f, cwd);
+    retval = db_inq_file_has_silo_objects_r(f);
+    DBSetDir(f, cwd);    
+
+    return retval;
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBFilters
- *
- * Purpose:     List the names of filters installed for the specified
- *              file.  The list is sent to the specified stream.
+ * Function:    DBInqFileReal
  *
- * Return:      Success:        0
+ * Purpose:     Determines if the filename is a Silo file.
  *
- *              Failure:        -1
+ * Return:      0  if filename is not a Silo file, 
+ *              >0 if filename is a Silo file,
+ *              <0 if an error occurred.
  *
- * Programmer:  robb@cloud
- *              Tue Mar  7 10:51:58 EST 1995
+ * Programmer:  Hank Childs
+ *              Tue Feb 29 16:24:01 PST 2000
  *
  * Modifications:
+ *    Sean Ahern, Wed Jul  5 15:35:48 PDT 2000
+ *    Renamed the function to DBInqFileReal.  Client code now calls a macro
+ *    called DBInqFile.
  *
- *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
- *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ *    Mark C. Miller, Wed Sep 23 11:48:19 PDT 2009
+ *    Added logic to confirm that indeed the successfully opened file has
+ *    some silo objects in it.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBFilters(DBfile *dbfile, FILE *stream)
+DBInqFileReal(const char *filename)
 {
-    int retval;
+    DBfile *dbfile = NULL;
+    int hasobjects = -1;
 
-    API_BEGIN2("DBFilters", int, -1, api_dummy) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBFilters", E_GRABBED) ; 
-        if (!stream)
-            stream = stdout;
-        if (!dbfile->pub.module)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+    API_BEGIN("DBInqFile", int, -1) {
+        if (!filename || ! *filename)
+            API_ERROR("filename", E_BADARGS);
 
-        retval = (dbfile->pub.module) (dbfile, stream);
-        API_RETURN(retval);
+        /* 
+         * Turn the error handling off so user won't see errors, 
+         * won't abort, etc.
+         */
+        DBShowErrors(DB_SUSPEND, NULL);
+
+        /*
+         * Must protect this code so that the error handling can be
+         * restored afterwards.
+         */
+        PROTECT {
+            dbfile = DBOpen(filename, DB_UNKNOWN, DB_READ);
+            if (dbfile)
+                hasobjects = DBInqFileHasObjects(dbfile);
+        } CLEANUP {
+            CANCEL_UNWIND;
+        } END_PROTECT;
+
+        /* 
+         * Turn the error handling back on. 
+         */
+        DBShowErrors(DB_RESUME, NULL);
+
+        if (dbfile != NULL)
+        {
+            DBClose(dbfile);
+            API_RETURN(hasobjects);
+        }
+ 
+        API_RETURN(0);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBMkDir & DBMkDirP
- *
- * Purpose:     Creates a new directory in the database. The P variant
- *              obeys unix `mkdir -p` semantics making parent directories
- *              as necessary as does so *above* any specific driver using
- *              calls to DBGetDir(), DBSetDir() and DBMkDir().
+/*----------------------------------------------------------------------
+ *  Routine                                               DBInqVarExists
  *
- * Return:      Success:        directory ID
+ *  Purpose
  *
- *              Failure:        -1
+ *      Determine if the given variable object exists in the SILO file.
+ *      Return non-zero if it does and 0 if it doesn't.
  *
- * Programmer:  matzke@viper
- *              Tue Nov  8 11:46:21 PST 1994
+ *  Programmer
  *
- * Modifications:
- *    Robb Matzke, Mon Nov 21 21:36:44 EST 1994
- *    Added error mechanism.
+ *      Sean Ahern, Thu Jul 20 11:53:40 PDT 1995
  *
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
+ *  Modifications
+ *    Mon Aug 28 11:15:21 PDT 1995
+ *    (ahern) Changed the API_BEGIN to API_BEGIN2.
  *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
- *
- *    Robb Matzke, 2000-05-23
- *    The old table of contents is discarded if the directory changes.
- *
- *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
- *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
- *-------------------------------------------------------------------------*/
+ *--------------------------------------------------------------------*/
 PUBLIC int
-DBMkDir(DBfile *dbfile, const char *name)
+DBInqVarExists(DBfile *dbfile, const char *varname)
 {
     int retval;
 
-    API_BEGIN2("DBMkDir", int, -1, api_dummy) {
+    API_BEGIN2("DBInqVarExists", int, 0, varname) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBMkDir", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("directory name", E_BADARGS);
-        if (db_VariableNameValid(name) == 0)
-            API_ERROR("directory name", E_INVALIDNAME);
-        if (!dbfile->pub.mkdir)
+        if (!varname || !*varname)
+            API_ERROR("variable name", E_BADARGS);
+        if (dbfile->pub.exist == NULL)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
-
-        retval = (dbfile->pub.mkdir) (dbfile, name);
-        db_FreeToc(dbfile);
+        retval = (dbfile->pub.exist) (dbfile, varname);
         API_RETURN(retval);
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    API_END_NOPOP; /* BEWARE: If API_RETURN above is removed use API_END */
 }
 
-PUBLIC int
-DBMkDirP(DBfile *dbfile, const char *name)
-{
-    char        cwg[1024], *p;
-    char       *abspath = 0;
-    int         abslen = 0;
-    int         retval = 0;
-
-    API_BEGIN2("DBMkDirP", int, -1, api_dummy) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBMkDir", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("directory name", E_BADARGS);
-        if (db_VariableNameValid(name) == 0)
-            API_ERROR("directory name", E_INVALIDNAME);
-
-        /* Save cwg */
-        cwg[0] = '\0';
-        DBGetDir(dbfile, cwg);
-        abspath = db_absoluteOf_path(cwg,name);
-        abslen = strlen(abspath);
+/*-------------------------------------------------------------------------
+ * Function:    DBForceSingle
+ *
+ * Purpose:     If 'status' is non-zero, then any 'datatype'd arrays are
+ *              converted on read from whatever their native datatype is to
+ *              float. A 'datatype'd array is an array that is part of some
+ *              Silo object containing a 'datatype' member which indicates
+ *              the type of data in the array. So, for example, a DBucdvar
+ *              has a 'datatype' member to indicate the type of data in the
+ *              var and mixvar arrays. Such arrays will be converted on read
+ *              if 'status' here is non-zero. However, a DBmaterial object 
+ *              is ALWAYS integer data. There is no 'datatype' member for
+ *              such an object and so its data will NEVER be converted to
+ *              float on read regardless of force single status set here.
+ *
+ *              I believe this function's original intention was to convert
+ *              only double precision arrays to single precision. However,
+ *              the PDB driver was apparently never designed that way and
+ *              the PDB driver's behavior sort of established the defacto
+ *              meaning of force single. So, now, as of Silo version 4.8
+ *              the HDF5 driver obeys it as well. Though, in fact the HDF5
+ *              driver was originally written to support the original
+ *              intention of force single status and it worked in this
+ *              ('buggy') fashion for many years before we started
+ *              encountering real problems with it in VisIt.
+ *
+ * Return:      Success:        0 if all drivers succeeded or did not
+ *                              implement this function.
+ *
+ *              Failure:        -1 if any driver returned failure.
+ *
+ * Programmer:  matzke@viper
+ *              Tue Jan 10 11:01:24 PST 1995
+ *
+ * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
+ *    Mark C. Miller, Fri Jul 16 19:28:23 PDT 2010
+ *    Updated 'Purpose' above to reflect current understanding of the
+ *    meaning of force single.
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBForceSingle(int status)
+{
+    int            i;
 
-        /* iterate setting and making one dir */
-        p = abspath+abslen;
+    API_BEGIN("DBForceSingle", int, -1) {
+        for (i = 0; i < DB_NFORMATS; i++) {
+            if (DBFSingleCB[i]) {
+                if (((DBFSingleCB[i]) (status)) < 0) {
+                    char           dname[32];
 
-        /* Walk up path finding nearest existing parent */
-        while (p > abspath)
-        {
-            if (DBInqVarType(dbfile, abspath[0]=='\0'?"/":abspath) == DB_DIR) break;
-            while (p>abspath && '/'!=*p) p--;
-            *p = '\0';
+                    sprintf(dname, "driver-%d", i);
+                    API_ERROR(dname, E_CALLFAIL);
+                }
+            }
         }
+    }
+    API_END;
 
-        /* Walk down path creating missing parents */
-        while (!retval && p < abspath+abslen)
+    return(0);
+}
+
+/*----------------------------------------------------------------------
+ *  Routine                                                DBMakeOptlist
+ *
+ *  Purpose
+ *
+ *      Allocate an option list of the requested length and initialize it.
+ *
+ *  Programmer
+ *
+ *      Jeffery W. Long, NSSD-B
+ *
+ *  Modified
+ *    Robb Matzke, Tue Nov 8 06:58:04 PST 1994
+ *    Added error mechanism
+ *--------------------------------------------------------------------*/
+PUBLIC DBoptlist *
+DBMakeOptlist(int maxopts)
+{
+    DBoptlist     *optlist = NULL;
+
+    API_BEGIN("DBMakeOptlist", DBoptlist *, NULL) {
+        if (maxopts <= 0)
+            API_ERROR("maxopts", E_BADARGS);
+        optlist = ALLOC(DBoptlist);
+        if (!optlist) API_ERROR(NULL, E_NOMEM);
+        optlist->options = ALLOC_N(int, maxopts);
+        optlist->values = ALLOC_N(void *, maxopts);
+
+        if (!optlist->options || !optlist->values)
         {
-            DBSetDir(dbfile, abspath[0]=='\0'?"/":abspath);
-            retval = DBMkDir(dbfile, p+1);
-            *p = '/';
-            while (p<abspath+abslen && '\0'!=*p) p++;
+            FREE(optlist->values);
+            FREE(optlist->options);
+            FREE(optlist);
+            API_ERROR(NULL, E_NOMEM);
         }
 
-        /* restore cwg */
-        DBSetDir(dbfile, cwg);
-        free(abspath);
+        optlist->numopts = 0;
+        optlist->maxopts = maxopts;
 
-        API_RETURN(retval);
+        API_RETURN(optlist);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-
-/*-------------------------------------------------------------------------
- * Function:    DBCpDir
+/*----------------------------------------------------------------------
+ *  Routine                                                DBFreeOptlist
  *
- * Purpose:     Copies a directory tree from one file to another
+ *  Purpose
  *
- * Return:      Success:        directory ID
+ *      Release the storage associated with the given optlist list.
  *
- *              Failure:        -1
+ *  Programmer
  *
- * Programmer:  Mark C. Miller, Wed Aug  6 15:14:33 PDT 2008
+ *      Jeffery W. Long, NSSD-B
  *
- *-------------------------------------------------------------------------*/
+ *  Returns
+ *
+ *      Returns 0 on success, -1 on failure.
+ *
+ *  Modified
+ *    Robb Matzke, Tue Nov 8 07:56:34 PST 1994
+ *    Added error mechanism.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *--------------------------------------------------------------------*/
 PUBLIC int
-DBCpDir(DBfile *dbfile, char const *srcDir,
-        DBfile *dstFile, char const *dstDir)
+DBFreeOptlist(DBoptlist *optlist)
 {
-    int retval;
-
-    API_DEPRECATE2("DBCpDir", int, -1, api_dummy, 4, 11, "DBCp") {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (!dstFile)
-            API_ERROR(NULL, E_NOFILE);
-        if (db_isregistered_file(dstFile,0)==-1)
-            API_ERROR(NULL, E_NOTREG);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR(NULL, E_GRABBED) ; 
-        if (!srcDir || !*srcDir)
-            API_ERROR("source directory name", E_BADARGS);
-        if (!dstDir || !*dstDir)
-            API_ERROR("destination directory name", E_BADARGS);
-        if (db_VariableNameValid(dstDir) == 0)
-            API_ERROR("destination directory name", E_INVALIDNAME);
-        if (!dbfile->pub.cpdir)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
-
-        retval = (dbfile->pub.cpdir) (dbfile, srcDir, dstFile, dstDir);
-        db_FreeToc(dbfile);
-        API_RETURN(retval);
+    API_BEGIN("DBFreeOptlist", int, -1) {
+        if (!optlist || optlist->numopts < 0) {
+            API_ERROR("optlist pointer", E_BADARGS);
+        }
+        FREE(optlist->options);
+        FREE(optlist->values);
+        FREE(optlist);
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    API_END;
+
+    return(0);
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBMkSymlink
+/*----------------------------------------------------------------------
+ *  Routine                                                DBClearOptlist
  *
- * Purpose:     Create symbolic link in silo file's CWD with name link and 
- *              referencing target. If target string contains ':', then
- *              chars before ':' are interpreted as another silo file
- *              and chars after ':' are interpreted as object within that
- *              file. If file part specifies a relative path, then path is
- *              relative to directory in which dbfile exists in
- *              file system.
+ *  Purpose
  *
- * Return:      Success:        directory ID
+ *      Remove all options from the given optlist and reset counters.
  *
- *              Failure:        -1
+ *  Programmer
  *
- * Programmer:  Mark C. Miller, Mon Apr 16 14:52:05 PDT 2018
+ *      Jeffery W. Long, NSSD-B
  *
- *-------------------------------------------------------------------------*/
+ *  Returns
+ *
+ *      Returns OKAY on success, OOPS on failure.
+ *
+ *  Modified
+ *    Robb Matzke, Tue Nov 8 07:48:52 PST 1994
+ *    Added error mechanism.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *--------------------------------------------------------------------*/
 PUBLIC int
-DBMkSymlink(DBfile *dbfile, char const *target, char const *link)
+DBClearOptlist(DBoptlist *optlist)
 {
-    int retval;
+    int            i;
 
-    API_BEGIN2("DBMkSymlink", int, -1, api_dummy) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBMkDir", E_GRABBED) ; 
-        if (!target || !*target)
-            API_ERROR("target", E_BADARGS);
-        if (db_VariableNameValid(target) == 0)
-            API_ERROR("target", E_INVALIDNAME);
-        if (!link || !*link)
-            API_ERROR("link", E_BADARGS);
-        if (db_VariableNameValid(link) == 0)
-            API_ERROR("link", E_INVALIDNAME);
-        if (!dbfile->pub.mksymlink)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+    API_BEGIN("DBClearOptlist", int, -1) {
+        if (!optlist || optlist->numopts < 0) {
+            API_ERROR("optlist pointer", E_BADARGS);
+        }
 
-        retval = (dbfile->pub.mksymlink) (dbfile, target, link);
-        db_FreeToc(dbfile);
-        API_RETURN(retval);
+        /* Reset values, but do not free */
+        for (i = 0; i < optlist->maxopts; i++) {
+            optlist->options[i] = 0;
+            optlist->values[i] = (void *)NULL;
+        }
+
+        optlist->numopts = 0;
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
-}
+    API_END;
 
-/* return 0 if the toc_entry is not a symlink or the target of the
- * symlink if it is */
-PUBLIC char const *
-DBIsSymlink(DBtoc const *toc, char const *toc_entry)
-{
-    int i;
-
-    if (!toc) return 0;
-    if (!toc_entry || !*toc_entry) return 0;
-
-    /* note: could use pointer compare instead of string
-       compare if could guarantee the toc_entry is one of
-       the members from this toc because symlink_name entry
-       is really just a copy of other toc entry's name
-       pointers */
-
-    for (i = 0; i < toc->nsymlink; i++)
-    {
-        if (!strcmp(toc->symlink_names[i], toc_entry))
-            return toc->symlink_target_names[i];
-    }
-
-    return 0;
-}
+    return(0);
+}
 
+/*----------------------------------------------------------------------
+ *  Routine                                                  DBAddOption
+ *
+ *  Purpose
+ *
+ *      Add an option to the given option list structure.
+ *
+ *  Programmer
+ *
+ *      Jeffery W. Long, NSSD-B
+ *
+ *  Returns
+ *
+ *      Returns OKAY on success, OOPS on failure.
+ *
+ *  Modified:
+ *    Robb Matzke, Tue Nov 8 07:00:55 PST 1994
+ *    Added error mechanism.  Returns -1 on failure, 0 on success.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *--------------------------------------------------------------------*/
 PUBLIC int
-DBGetSymlink(DBfile *dbfile, char const *in_candidate_link, char *out_target)
+DBAddOption(DBoptlist *optlist, int option, void *value)
 {
-    int retval;
-    API_BEGIN2("DBGetSymlink", int, -1, api_dummy) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetSymlink", E_GRABBED);
-        if (!in_candidate_link || !*in_candidate_link)
-            API_ERROR("in_candidate_link", E_BADARGS);
-        if (!dbfile->pub.g_symlink)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+    API_BEGIN("DBAddOption", int, -1) {
+        if (!optlist)
+            API_ERROR("optlist pointer", E_BADARGS);
+        if (optlist->numopts >= optlist->maxopts)
+            API_ERROR("optlist nopts", E_BADARGS);
 
-        retval = (dbfile->pub.g_symlink) (dbfile, in_candidate_link, out_target);
-        db_FreeToc(dbfile);
-        API_RETURN(retval);
-    }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
-}
+        optlist->options[optlist->numopts] = option;
+        optlist->values[optlist->numopts] = value;
+        optlist->numopts++;
 
-PRIVATE void
-CheckForComponentSeries(DBobject const *srcObj, int i,
-    int *isser, int *nser, char **sernm, char **sertstr, void **serd)
-{
-    char *p = 0;
-    int pass = 0;
-    int dtyp = DB_NOTYPE;
-    int i0 = i;
-    int nd = (int) strcspn(srcObj->comp_names[i0], "0123456789");
+        if (optlist->numopts >= optlist->maxopts)
+        {
+            int new_maxopts = optlist->maxopts * 1.5 + 1; /* golden rule + 1 */
+            int *new_options = REALLOC_N(optlist->options, int, new_maxopts);
+            void **new_values = REALLOC_N(optlist->values, void*, new_maxopts);
 
-    /* advance while component names match in first nd chars */
-    i++;
-    while (i < srcObj->ncomponents)
-    {
-        if (strncmp(srcObj->comp_names[i], srcObj->comp_names[i0], nd) ||
-            strncmp(srcObj->pdb_names[i], "'<", 2) ||
-           !strncmp(srcObj->pdb_names[i], "'<s>/.silo/#", 12))
-            break;
-        i++;
-    }
+            if (!new_options || !new_values)
+            {
+                FREE(new_options);
+                FREE(new_values);
+                API_ERROR(0, E_NOMEM);
+            }
+
+            optlist->maxopts = new_maxopts;
+            optlist->options = new_options;
+            optlist->values  = new_values;
+        }
 
-    /* If the series is of length one (or less) its not a series */
-    if ((i-i0) <= 1)
-    {
-        *isser = 0;
-        return;
     }
+    API_END;
 
-    *isser = 1;
-    *nser = i-i0;
-    *sernm = db_strndup(srcObj->comp_names[i0], nd);
+    return(0);
+}
 
-    /* first pass get size, second pass fill buffer */
-    for (pass = 0; pass < 2; pass++)
-    {
-        int j;
+/*----------------------------------------------------------------------
+ *  Routine                                                DBClearOption
+ *
+ *  Purpose
+ *
+ *      Remove a given option from the given optlist and re-order
+ *      the remaining options.
+ *
+ *  Programmer
+ *
+ *      Mark C. Miller, August 18, 2005 
+ *
+ *--------------------------------------------------------------------*/
+PUBLIC int
+DBClearOption(DBoptlist *optlist, int option)
+{
+    int            i, j, foundit=0;
 
-        if (pass == 1)
-        {
-            p = (char *) malloc((size_t)p);
-            *serd = p;
+    API_BEGIN("DBClearOption", int, -1) {
+        if (!optlist || optlist->numopts < 0) {
+            API_ERROR("optlist pointer", E_BADARGS);
         }
 
-        for (j = i0; j < i; j++)
-        {
-            if      (!strncmp(srcObj->pdb_names[j], "'<i>", 4))
-            {
-                if (pass == 1)
-                    *((int*)p) = (int) strtol(srcObj->pdb_names[j]+4, NULL, 0);
-                p += sizeof(int);
-                if (dtyp == DB_NOTYPE) dtyp = DB_INT;
-            }
-            else if (!strncmp(srcObj->pdb_names[j], "'<f>", 4))
-            {
-                if (pass == 1)
-                     *((float*)p) = (float) strtod(srcObj->pdb_names[j]+4, NULL);
-                p += sizeof(float);
-                if (dtyp == DB_NOTYPE) dtyp = DB_FLOAT;
-            }
-            else if (!strncmp(srcObj->pdb_names[j], "'<d>", 4))
-            {
-                if (pass == 1)
-                    *((double*)p) = strtod(srcObj->pdb_names[j]+4, NULL);
-                p += sizeof(double);
-                if (dtyp == DB_NOTYPE) dtyp = DB_DOUBLE;
-            }
-            else if (!strncmp(srcObj->pdb_names[j], "'<s>", 4))
-            {
-                int len = (int) strlen(srcObj->pdb_names[j])-5;
-                if (pass == 1)
-                {
-                     strcpy(p, srcObj->pdb_names[j]+4);
-                     p[len] = '\0';
+        /* Shift values down in list by one entry */
+        for (i = 0; i < optlist->numopts; i++) {
+            if (optlist->options[i] == option) {
+                foundit = 1;
+                for (j = i; j < optlist->numopts-1; j++) {
+                    optlist->options[j] = optlist->options[j+1];
+                    optlist->values[j]  = optlist->values[j+1];
                 }
-                p += (len+1);
-                if (dtyp == DB_NOTYPE) dtyp = DB_CHAR;
-            }
-            else
-            {
-                int len = (int) strlen(srcObj->pdb_names[j]);
-                if (pass == 1)
-                     strcpy(p, srcObj->pdb_names[j]);
-                p += (len+1);
+                break;
             }
         }
+
+        if (foundit) {
+            optlist->numopts--;
+            optlist->options[optlist->numopts] = 0;
+            optlist->values[optlist->numopts]  = 0;
+        }
     }
+    API_END;
 
-    *sertstr = db_GetDatatypeString(dtyp);
+    return(0);
 }
 
-static int
-db_validate_copy_step(int pass, int recurse,
-    char const *srcName, char const *srcAbsName, int srcType,
-    char const *dstName, char const *dstAbsName, int dstType)
+/*----------------------------------------------------------------------
+ *  Routine                                                DBGetOption
+ *
+ *  Purpose
+ *
+ *      Return value set for a given option from the given optlist.
+ *
+ *  Programmer
+ *
+ *      Mark C. Miller, August 18, 2005 
+ *
+ *  Modifications:
+ *
+ *      Mark C. Miller, Wed Jul 14 20:35:50 PDT 2010
+ *      Replaced 'return' with 'API_RETURN'
+ *
+ *      Mark C. Miller, Tue Aug 10 23:49:51 PDT 2010
+ *      Removed API_BEGIN/END stuff so that function can be handed
+ *      a null optlist and it will behave well.
+ *--------------------------------------------------------------------*/
+PUBLIC void * 
+DBGetOption(const DBoptlist *optlist, int option)
 {
-    /* We validate everything 1rst pass so on 2nd, just ignore */
-    if (pass == 1) return 1;
-
-    /* Validate source object first */
-    if (srcType == DB_INVALID_OBJECT)
-    {
-        db_perror("src object does not exist", E_BADARGS, srcName);
-        return 0;
-    }
+    int            i;
 
-    if (srcType == DB_DIR && !recurse)
-    {
-        db_perror("src is a directory (not copied)", E_BADARGS, srcName);
-        return 0;
-    }
+    if (!optlist) return 0;
 
-    /* If destination does not exist, that is fine */
-    if (dstType == DB_INVALID_OBJECT)
-        return 1;
+    /* find the given option in the optlist and return its value */
+    for (i = 0; i < optlist->numopts; i++)
+        if (optlist->options[i] == option)
+            return optlist->values[i];
 
-    /* If pre-existing destination type isn't same as src, that is a problem */
-    if (dstType != srcType)
-    {
-        db_perror("pre-existing dst object type mismatch with src", E_BADARGS,
-            dstName?dstName:srcName);
-        return 0;
-    }
+    return 0;
+}
 
-    /* If we get here, we're overwriting the destination object and that
-       is ok only if AllowOverwrites is enabled *and* the src object
-       can fit within the space used by the dst object, the latter piece
-       of logic we cannot currently check. */
-    if (!DBGetAllowOverwrites())
-    {
-#ifndef _WIN32
-#warning ONLY IF SRC SIZE SMALLER THAN DST SIZE
-#endif
-        db_perror("overwrite of pre-existing dst prevented due "
-            "to DBSetAllowOverwrites(0)", E_BADARGS, dstName?dstName:srcName);
-        return 0;
-    }
-
-    return 1;
-}
+/*-------------------------------------------------------------------------
+ * Function:    DBGetToc
+ *
+ * Purpose:     Return a pointer to table of contents of the file.  Note
+ *              that the pointer is the same as the one in the DBfile
+ *              so it should not be modified and may become invalid after
+ *              calling the next silo routine.
+ *
+ * Return:      Success:        Pointer to the table of contents structure.
+ *
+ *              Failure:        NULL
+ *
+ * Programmer:  matzke@viper
+ *              Mon Nov  7 10:35:47 PST 1994
+ *
+ * Modifications:
+ *    Eric Brugger, Fri Jan 27 08:23:43 PST 1995
+ *    I changed the interface and function of the routine.
+ *
+ *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
+ *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ *-------------------------------------------------------------------------*/
+PUBLIC DBtoc  *
+DBGetToc(DBfile *dbfile)
+{
+    API_BEGIN2("DBGetToc", DBtoc *, NULL, api_dummy) {
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("", E_GRABBED) ; 
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
 
-#define COPY_TOC_ENTRY(TOC, NM, NUM, NAM)                        \
-    NUM = TOC->n ## NM;                                          \
-    NAM = (char **) malloc(NUM * sizeof(char*));                 \
-    for (int q = 0 ; q < NUM; q++)                               \
-    {                                                            \
-        int len = strlen(TOC->NM ## _names[q]);                  \
-        NAM[q] = (char*) calloc(len+1,1);                        \
-        strncpy(NAM[q], TOC->NM ## _names[q],len);               \
+        DBNewToc(dbfile);
+        API_RETURN(dbfile->pub.toc);
     }
-
-#define FREE_COPIED_TOC_ENTRY(NUM, NAM)                          \
-    for (int q = 0; q < NUM; q++)                                \
-        FREE(NAM[q]);                                            \
-    FREE(NAM);
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
 
 /*-------------------------------------------------------------------------
- * Function: db_can_overwrite_dstobj_with_srcobj
+ * Function:    DBInqVarType
  *
- * Purpose: Compare two objects, member-by-member, to ensure the source
- * object is smaller than (e.g. will fit into the same file space as) the
- * destination object. There is possible recursion if the object contains
- * sub-objects (e.g. a zonelist object within an ucd mesh object).
+ * Purpose:     Return the DBObjectType for a given object name
  *
- * Returns: 1 if source object matches destination object *and* fits in
- *            in same space destination object occupies.
- *          0 otherwise.
+ * Return:      Success:        the ObjectType for the given object
  *
- * Programmer:  Mark C. Miller, Wed Apr 18 09:23:55  PDT 2018
+ *              Failure:        DB_INVALID_OBJECT
+ *
+ * Programmer:  Sean Ahern,
+ *              Wed Oct 28 14:46:53 PST 1998
+ *
+ * Modifications:
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
  *
+ *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
+ *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
  *-------------------------------------------------------------------------*/
-static int
-db_can_overwrite_dstobj_with_srcobj(
-    DBfile *srcFile, char const *srcAbsName,
-    DBfile *dstFile, char const *dstAbsName)
+PUBLIC DBObjectType
+DBInqVarType(DBfile *dbfile, char const *varname)
 {
-    int q;
-    int retval = 0; /* assume it won't work */
-    DBobject *srcObj = 0;
-    DBobject *dstObj = 0;
-
-    srcObj = DBGetObject(srcFile, srcAbsName);
-    if (!srcObj) goto done;
-
-    dstObj = DBGetObject(dstFile, dstAbsName);
-    if (!dstObj) goto done;
-
-    for (q = 0; q < srcObj->ncomponents; q++)
-    {
-        int r, dstr = -1;
-        char const *curr_compname = srcObj->comp_names[q];
-
-        for (r = 0; r < dstObj->ncomponents && dstr==-1; r++)
-            if (!strcmp(curr_compname, dstObj->comp_names[r]))
-                dstr = r;
-
-        if (dstr == -1) goto done; /* no matching comp in dst */
-
-        if (!strncmp(srcObj->pdb_names[q], "'<i>", 4))
-            continue;
-        else if (!strncmp(srcObj->pdb_names[q], "'<f>", 4))
-            continue;
-        else if (!strncmp(srcObj->pdb_names[q], "'<d>", 4))
-            continue;
-        else /* possible sub-object */
-        {
-            int srcLen, dstLen, can_overwrite;
-            DBObjectType srcSubObjType, dstSubObjType;
-            char *srcSubObjName, *srcSubObjDirName, *srcSubObjAbsName;
-            char *dstSubObjName, *dstSubObjDirName, *dstSubObjAbsName;
-
-            if (!strncmp(srcObj->pdb_names[q], "'<s>", 4))
-                srcSubObjName = db_strndup(srcObj->pdb_names[q]+4, strlen(srcObj->pdb_names[q])-5);
-            else
-                srcSubObjName = db_strndup(srcObj->pdb_names[q], strlen(srcObj->pdb_names[q]));
-            srcSubObjDirName = db_dirname(srcAbsName);
-            srcSubObjAbsName = db_join_path(srcSubObjDirName, srcSubObjName);
-
-            if (!strncmp(dstObj->pdb_names[dstr], "'<s>", 4))
-                dstSubObjName = db_strndup(dstObj->pdb_names[dstr]+4, strlen(dstObj->pdb_names[dstr])-5);
-            else
-                dstSubObjName = db_strndup(dstObj->pdb_names[dstr], strlen(dstObj->pdb_names[dstr]));
-            dstSubObjDirName = db_dirname(dstAbsName);
-            dstSubObjAbsName = db_join_path(dstSubObjDirName, dstSubObjName);
-
-            /* To make exiting and cleanup logic here a tad simpler, we do all
-               the work we *might* need to with the strings and then free them. */
-#ifndef _WIN32
-#warning SHOULDNT WE USE FILE LENGTH FUNCTIONS HERE
-#endif
-            srcSubObjType = DBInqVarType(srcFile, srcSubObjAbsName);
-            srcLen = DBGetVarByteLength(srcFile, srcSubObjAbsName);
-            dstSubObjType = DBInqVarType(dstFile, dstSubObjAbsName);
-            dstLen = DBGetVarByteLength(dstFile, dstSubObjAbsName);
-
-            if (dstSubObjType == DB_VARIABLE)
-                can_overwrite = 1;
-            else if (dstSubObjType == DB_DIR)
-                can_overwrite = 0;
-#ifndef _WIN32
-#warning DISALLOW SIMLINKS FOR NOW
-#endif
-            else if (dstSubObjType == DB_SYMLINK)
-                can_overwrite = 0;
-            else
-                can_overwrite = db_can_overwrite_dstobj_with_srcobj(
-                    srcFile, srcSubObjAbsName, dstFile, dstSubObjAbsName); /* recursive call */
+    DBObjectType retval;
 
-            FREE(srcSubObjName);
-            FREE(srcSubObjDirName);
-            FREE(srcSubObjAbsName);
-            FREE(dstSubObjName);
-            FREE(dstSubObjDirName);
-            FREE(dstSubObjAbsName);
+    API_BEGIN2("DBInqVarType", DBObjectType, DB_INVALID_OBJECT, api_dummy) {
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("", E_GRABBED) ; 
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (!varname || !*varname)
+            API_ERROR("variable name", E_BADARGS);
+        if (!dbfile->pub.inqvartype)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-            /* decide if its ok to proceed or not */
-            if (srcSubObjType == DB_VARIABLE && dstSubObjType == DB_VARIABLE)
-            {
-                if (srcLen > dstLen) goto done; /* simple src var doesn't fit in dst */
-            }
-            else if (srcSubObjType == dstSubObjType)
-            {
-                if (!can_overwrite) goto done; /* src object doesn't fit in dst */
-            }
-            else
-            {
-                goto done; /* src & dst disagree on subobject's type */
-            }
-        }
+        retval = (dbfile->pub.inqvartype) (dbfile, varname);
+        API_RETURN(retval);
     }
-
-    /* indicate it will work */
-    retval = 1;
-
-done:
-
-    if (srcObj) DBFreeObject(srcObj);
-    if (dstObj) DBFreeObject(dstObj);
-
-    return retval;
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:   db_copy_single_object_abspath
+ * Function:    DBNewToc
  *
- * Purpose: Copy a single source *object* to a destination object or
- * directory using the generic object routines. The source cannot be a
- * directory. If destination does not exist, ensure its parent is an
- * existing directory. If destination is a pre-existing object, overwrite
- * that object as per options and as long as it fits. If destination is a
- * pre-existing directory, copy the source object *into* that directory.
+ * Purpose:     Used to be called `DBGetToc', this function installs a
+ *              new table of contents in the specified file from that
+ *              file's current working directory.  The old table of contents
+ *              is destroyed.
  *
- * Returns: 1 If the copy succeeds.
- *          0 Otherwise.
+ * Return:      Success:        0
  *
- * Programmer:  Mark C. Miller, Wed Apr 18 09:23:55  PDT 2018
+ *              Failure:        -1
+ *
+ * Programmer:  robb@cloud
+ *              Tue Mar  7 10:26:23 EST 1995
  *
+ * Modifications:
+ *              Robb Matzke, 2000-05-23
+ *              If nothing has changed then this function just returns
+ *              success, leaving the original table of contents in place.
+ *              Any function that potentially changes the table of
+ *              contents should call db_FreeToc() on the file handle.
  *-------------------------------------------------------------------------*/
-static int
-db_copy_single_object_abspath(char const *opts,
-    DBfile *srcFile, char const *srcObjAbsName, DBObjectType srcType,
-    DBfile *dstFile, char const *dstObjAbsName, DBObjectType dstType)
+PUBLIC int
+DBNewToc(DBfile *dbfile)
 {
-    int q;
-    char *_dstObjAbsName;
-    DBobject *dstObj, *srcObj;
+    int retval;
 
-#ifndef _WIN32
-#warning CHECK ARGS HERE. ALLOW FOR NULL dstFile AND dstObjAbsName
-#warning WHY CHECK dstType HERE
-#endif
+    API_BEGIN("DBNewToc", int, -1) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("", E_GRABBED) ; 
+        if (!dbfile->pub.newtoc)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+        if (dbfile->pub.toc)
+            API_RETURN(0);
+        retval = (dbfile->pub.newtoc) (dbfile);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
 
-    /* Query type information if not already known */
-    if (srcType == DB_INVALID_OBJECT)
-        srcType = DBInqVarType(srcFile, srcObjAbsName);
-    if (dstType == DB_INVALID_OBJECT)
-        dstType = DBInqVarType(dstFile, dstObjAbsName);
+/*
+This logic is necessary to support callers accessing standard (e.g. non-DB_USERDEF)
+objects via the generic interface to ensure logic for specially handled component
+values is consistent with the standard object's DBGetXXX methods.
+To ensure a zero for the component in the file means either not-present or
+not-set, certain components, especially those for which a zero value is a valid
+value for the data producer to use, special handling is required and that logic
+is sprinkled about in the DBPutXXX and DBGetXXX methods of the drivers and so
+to is it required here. Its a nasty maintenance issue.
+*/
 
-    /* Source object cannot be a directory */
-    if (srcType == DB_INVALID_OBJECT || srcType == DB_DIR)
-        return 0;
+static int
+db_IsComponentNameStandardWithSpecialHandling(char const *compname)
+{
+    if (!strcmp(compname, "missing_value")) return 1;
+    if (!strcmp(compname, "topo_dim")) return 1;
+    if (!strcmp(compname, "repr_block_idx")) return 1;
+    return 0;
+}
 
-    /* If destination is a directory, dstObjAbsName needs to be adjusted
-       to append last component of srcObjAbsName */
-    if (dstType == DB_DIR)
+/* For use in the DBGetComponent call */
+static void
+db_AdjustSpeciallyHandledStandardObjectComponentValue(
+    void *val_ptr, int obj_type, char const *comp_name)
+{
+    if (!val_ptr || !comp_name) return;
+
+    if (!strcmp(comp_name, "missing_value") &&
+        (obj_type == DB_UCDVAR || obj_type == DB_QUADVAR || obj_type == DB_CURVE ||
+         obj_type == DB_POINTVAR || obj_type == DB_MULTIVAR))
     {
-        char *bname = db_basename(srcObjAbsName);
-        _dstObjAbsName = db_join_path(dstObjAbsName, bname);
-        FREE(bname);
+        double val_for_mem, val_from_file = *((double*)val_ptr);
+        db_SetMissingValueForGet(val_for_mem, val_from_file);
+        *((double*)val_ptr) = val_for_mem;
     }
-    /* If destination is a pre-existing non-directory object, this implies
-       it will be overwritten by source. But, in that case, dstFile needs
-       to allow overwrites and the source needs to be small enough to fit
-       into the space the destination object occupies. */
-    else if (dstType != DB_INVALID_OBJECT)
+    else if (!strcmp(comp_name, "repr_block_idx") &&
+        (obj_type == DB_MULTIMESH || obj_type == DB_MULTIVAR ||
+         obj_type == DB_MULTIMAT || obj_type == DB_MULTIMATSPECIES))
     {
-        int srcSize, dstSize;
-#ifndef _WIN32
-#warning USE FILE-BASED FUNCTION WHEN AVAILABLE
-#endif
-        if (!DBGetAllowOverwrites())
-        {
-            db_perror("overwrite of pre-existing dst prevented due "
-                "to DBSetAllowOverwrites(0)", E_BADARGS, dstObjAbsName);
-            return 0;
-        }
-        if (!db_can_overwrite_dstobj_with_srcobj(
-             srcFile, srcObjAbsName, dstFile, dstObjAbsName))
-        {
-            db_perror("overwrite of pre-existing dst prevented due "
-                "to insufficient space for src object", E_BADARGS, dstObjAbsName);
-            return 0;
-        }
-        _dstObjAbsName = STRDUP(dstObjAbsName);
+        int val_for_mem, val_from_file = *((int*)val_ptr);
+        val_for_mem = val_from_file - 1;
+        *((int*)val_ptr) = val_for_mem;
     }
-    else
+    else if (!strcmp(comp_name, "topo_dim") &&
+        (obj_type == DB_MULTIMESH || obj_type == DB_UCDMESH))
     {
-        _dstObjAbsName = STRDUP(dstObjAbsName);
+        int val_for_mem, val_from_file = *((int*)val_ptr);
+        val_for_mem = val_from_file - 1;
+        *((int*)val_ptr) = val_for_mem;
     }
+}
 
-    /* Access the source object using generic interface */
-    srcObj = DBGetObject(srcFile, srcObjAbsName);
-    if (!srcObj)
-    {
-        db_perror("Unable to access source object for copy operation",
-            E_NOTFOUND, srcObjAbsName);
-        return 0;
-    }
+/* For use in the DBGetObject call */
+static void
+db_AdjustSpeciallyHandledStandardObjectComponentValues(DBobject *obj)
+{
+    int i, obj_type;
 
-    /* Handle funniness with quadmesh type strings */
-    if (srcType == DB_QUADMESH)
-    {
-        if (strstr(srcObj->type, "rect"))
-            srcType = DB_QUAD_RECT;
-        else if (strstr(srcObj->type, "curv"))
-            srcType = DB_QUAD_CURV;
-    }
+    if (!obj) return;
 
-    /* Ok, lets do what we came here to do...create the dst object and
-       start populating it */
-    dstObj = DBMakeObject(_dstObjAbsName, srcType, srcObj->ncomponents);
-    for (q = 0; q < srcObj->ncomponents; q++)
+    obj_type = DBGetObjtypeTag(obj->type);
+    if (obj_type == DB_USERDEF) return;
+
+    for (i = 0; i < obj->ncomponents; i++)
     {
-        int isser = 0, nser = 0;
-        char *sernm = 0, *sertstr = 0;
-        void *serd = 0;
-        CheckForComponentSeries(srcObj, q, &isser, &nser, &sernm, &sertstr, &serd);
-        if (isser)
+        char tmp[256];
+
+        if (!strcmp(obj->comp_names[i], "missing_value") &&
+            (obj_type == DB_UCDVAR || obj_type == DB_QUADVAR || obj_type == DB_CURVE ||
+             obj_type == DB_POINTVAR || obj_type == DB_MULTIVAR))
         {
-            long tmpn = (long) nser;
-            DBWriteComponent(dstFile, dstObj, sernm,
-                dstObj->name, sertstr, serd, 1, &tmpn);
-            free(sernm);
-            free(sertstr);
-            free(serd);
-            q += (nser-1);
+            double val_for_mem, val_from_file = strtod(obj->pdb_names[i]+4,0);
+            db_SetMissingValueForGet(val_for_mem, val_from_file);
+            sprintf(tmp, "'<d>%.30g'", val_for_mem);
+        }
+        else if (!strcmp(obj->comp_names[i], "repr_block_idx") &&
+            (obj_type == DB_MULTIMESH || obj_type == DB_MULTIVAR ||
+             obj_type == DB_MULTIMAT || obj_type == DB_MULTIMATSPECIES))
+        {
+            int val_for_mem, val_from_file = (int) strtol(obj->pdb_names[i]+4,0,10);
+            val_for_mem = val_from_file - 1;
+            sprintf(tmp, "'<i>%d'", val_for_mem);
+        }
+        else if (!strcmp(obj->comp_names[i], "topo_dim") &&
+            (obj_type == DB_MULTIMESH || obj_type == DB_UCDMESH))
+        {
+            int val_for_mem, val_from_file = (int) strtol(obj->pdb_names[i]+4,0,10);
+            val_for_mem = val_from_file - 1;
+            sprintf(tmp, "'<i>%d'", val_for_mem);
         }
-        else if (!strncmp(srcObj->pdb_names[q], "'<i>", 4))
-            DBAddIntComponent(dstObj, srcObj->comp_names[q],
-                (int) strtol(srcObj->pdb_names[q]+4, NULL, 0));
-        else if (!strncmp(srcObj->pdb_names[q], "'<f>", 4))
-            DBAddFltComponent(dstObj, srcObj->comp_names[q],
-                (float) strtod(srcObj->pdb_names[q]+4, NULL));
-        else if (!strncmp(srcObj->pdb_names[q], "'<d>", 4))
-            DBAddDblComponent(dstObj, srcObj->comp_names[q],
-                strtod(srcObj->pdb_names[q]+4, NULL));
         else
         {
-            DBObjectType subObjType;
-            char *subObjName;
-            char *srcObjDirName, *srcSubObjAbsName;
-             
-            if (!strncmp(srcObj->pdb_names[q], "'<s>", 4))
-                subObjName = db_strndup(srcObj->pdb_names[q]+4, strlen(srcObj->pdb_names[q])-5);
-            else
-                subObjName = db_strndup(srcObj->pdb_names[q], strlen(srcObj->pdb_names[q]));
-
-            srcObjDirName = db_dirname(srcObjAbsName);
-            srcSubObjAbsName = db_join_path(srcObjDirName, subObjName);
-
-            subObjType = DBInqVarType(srcFile, srcSubObjAbsName);
-            if (subObjType == DB_VARIABLE) /* raw data copy */
-            {
-                int j, dims[32];
-                long ldims[32];
-                int idtype = DBGetVarType(srcFile, srcSubObjAbsName);
-                int ndims = DBGetVarDims(srcFile, srcSubObjAbsName, 32, dims);
-                void *data = DBGetVar(srcFile, srcSubObjAbsName);
-                char *dtype = db_GetDatatypeString(idtype);
-                for (j = 0; j < ndims; ldims[j] = (long) dims[j], j++);
-                DBWriteComponent(dstFile, dstObj, srcObj->comp_names[q],
-                    dstObj->name, dtype, data, ndims, ldims);
-                FREE(dtype);
-                FREE(data);
-            }
-            else if (((srcType == DB_UCDMESH) && /* possible recurse on sub-object */
-                      (subObjType == DB_FACELIST || subObjType == DB_EDGELIST ||
-                       subObjType == DB_ZONELIST || subObjType == DB_PHZONELIST)) ||
-                     (srcType == DB_CSGMESH && subObjType == DB_CSGZONELIST)) 
-            {
-                char *dstObjDirName = db_dirname(dstObjAbsName);
-                char *dstSubObjAbsName = db_join_path(dstObjDirName, subObjName);
-
-                db_copy_single_object_abspath(opts, /* recursive call */
-                   srcFile, srcSubObjAbsName, subObjType,
-                   dstFile, dstSubObjAbsName, DB_INVALID_OBJECT);
-
-                DBAddStrComponent(dstObj, srcObj->comp_names[q], subObjName);
-
-                FREE(dstObjDirName);
-                FREE(dstSubObjAbsName);
-            }
-            free(subObjName);
-            free(srcObjDirName);
-            free(srcSubObjAbsName);
+            continue;
         }
-    }
-
-    DBWriteObject(dstFile, dstObj, SILO_Globals.allowOverwrites);
-    DBFreeObject(srcObj);
-    DBFreeObject(dstObj);
-    FREE(_dstObjAbsName);
 
-    return 1;
+        FREE(obj->pdb_names[i]);
+        obj->pdb_names[i] = STRDUP(tmp);
+    }
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBCp
+/*----------------------------------------------------------------------
+ *  Routine                                                DBGetComponent
  *
- * Purpose:     The Silo equivalent of a unix `cp` command obeying all unix
- *              semantics and applicable flags. In particular...
+ *  Purpose
  *
- *    Single src object to single dst object
- *        DBCp(char const *opts, DBfile *srcFile, DBfile *dstFile,
- *            char const *srcPATH, char const *dstPATH, DB_EOA);
+ *      Return the requested component value for the given object.
  *
- *    Multiple src objects to single dst (dir) object
- *        DBCp(char const *opts, DBfile *srcFile, DBfile *dstFile,
- *            char const *srcPATH1, char const *srcPATH2, ...,
- *            char const *dstDIR, DB_EOA);
+ *  Programmer
  *
- *    Multiple src objects to multiple dst objects
- *        DBCp("-2...", DBfile *srcFile, DBfile *dstFile,
- *            char const *srcPATH1, char const *dstPATH1,
- *            char const *srcPATH2, char const *dstPATH2,
- *            char const *srcPATH3, char const *dstPATH3, ..., DB_EOA);
+ *      Jeffery W. Long, NSSD-B
  *
- *    srcFile and dstFile may be the same Silo file. srcFile cannot be null.
- *    dstFile may be null in which case it is assumed same as srcFile.
- *    The argument list *must* be terminated by the DB_EOA sentinel. Just as
- *    for unix `cp`, the options and their meanings are...
+ *  Parameters
  *
- *      -R/-r recurse on any directory objects
- *      -L/-P dereference links / never dereference links
- *      -d    preserve links
- *      -s/-l don't actually copy, just sym/hard link
- *            (only possible when srcFile==dstFile)
+ *      dbfile           {In}    {Pointer to current file}
+ *      objname          {In}    {Name of object to inquire about}
+ *      compname         {In}    {Name of component to return}
  *
- *    Other rules:
- *       * If any src is a dir, then it is an error without -R/-r.
- *       * If cooresponding dst exists and is a dir, src is copied
- *         into (e.g. becomes a child of) dst.
- *       * If cooresponding dst exists and is not a dir (e.g. is just a
- *         normal Silo object), then it is an error if src is not also the 
- *         same kind of Silo object. The copy overwrites (destructive) dst.
+ *  Notes
+ *
+ *  Modified
+ *    Robb Matzke, Tue Nov 8 08:22:42 PST 1994
+ *    Added error mechanism
+ *
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
+ *    Eric Brugger, Wed Mar 10 16:59:34 PST 1999
+ *    Changed API_BEGIN2 to API_BEGIN so that Silo directory information
+ *    would be processed at the driver level, since the pdb driver
+ *    version of this routine handles silo directory paths as well as
+ *    file system directory paths, which API_BEGIN2 does not.
+ *
+ *    Eric Brugger, Thu Mar 11 12:33:15 PST 1999
+ *    I forgot to remove the fourth argument when I changed API_BEGIN2
+ *    to API_BEGIN.  I did so now.
+ *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *
+ *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
+ *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ *--------------------------------------------------------------------*/
+PUBLIC void   *
+DBGetComponent(DBfile *dbfile, char const *objname, char const *compname)
+{
+    void *retval = NULL;
+
+    API_BEGIN2("DBGetComponent", void *, NULL, api_dummy) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBGetComponent", E_GRABBED) ; 
+        if (!objname || !*objname)
+            API_ERROR("object name", E_BADARGS);
+        if (!compname || !*compname)
+            API_ERROR("component name", E_BADARGS);
+        if (!dbfile->pub.g_comp)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        retval = (dbfile->pub.g_comp) (dbfile, objname, compname);
+
+        if (db_IsComponentNameStandardWithSpecialHandling(compname))
+            db_AdjustSpeciallyHandledStandardObjectComponentValue(retval,
+                DBInqVarType(dbfile, objname), compname);
+
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+/*----------------------------------------------------------------------
+ *  Routine                                           DBGetComponentType
+ *
+ *  Purpose
+ *
+ *      Return the type of a component for the given object.
+ *
+ *  Programmer
+ *
+ *      Brad Whitlock, Thu Jan 20 11:54:54 PDT 2000
+ *
+ *  Parameters
+ *
+ *      dbfile           {In}    {Pointer to current file}
+ *      objname          {In}    {Name of object to inquire about}
+ *      compname         {In}    {Name of component to return}
+ *
+ *  Modified
+ *
+ *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
+ *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ *--------------------------------------------------------------------*/
+
+PUBLIC int
+DBGetComponentType(DBfile *dbfile, char const *objname, char const *compname)
+{
+    int retval = DB_NOTYPE;
+
+    API_BEGIN2("DBGetComponentType", int, DB_NOTYPE, api_dummy) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("", E_GRABBED) ; 
+        if (!objname || !*objname)
+            API_ERROR("object name", E_BADARGS);
+        if (!compname || !*compname)
+            API_ERROR("component name", E_BADARGS);
+        if (!dbfile->pub.g_comptyp)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        retval = (dbfile->pub.g_comptyp) (dbfile, objname, compname);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+/*----------------------------------------------------------------------
+ *  Routine                                                     DBGetDir
+ *
+ *  Purpose
+ *
+ *      Get the name of the current directory, return in space provided.
+ *
+ *  Modified
+ *    Robb Matzke, Tue Nov 8 08:48:12 PST 1994
+ *    Added error mechanism
+ *
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
+ *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
+ *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ *--------------------------------------------------------------------*/
+PUBLIC int
+DBGetDir(DBfile *dbfile, char *path)
+{
+    int retval;
+
+    API_BEGIN2("DBGetDir", int, -1, api_dummy) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBGetDir", E_GRABBED) ; 
+        if (!path)
+            API_ERROR("path", E_BADARGS);
+        if (!dbfile->pub.g_dir)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        retval = (dbfile->pub.g_dir) (dbfile, path);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBSetDir
+ *
+ * Purpose:     Sets the current directory within the database.
+ *
+ * Return:      Success:        0
+ *
+ *              Failure:        -1
+ *
+ * Programmer:  robb@cloud
+ *              Wed Nov  9 13:09:23 EST 1994
+ *
+ * Modifications:
+ *    Robb Matzke, Mon Nov 21 21:31:17 EST 1994
+ *    Added error mechanism.
+ *
+ *    Robb Matzke, Fri Jan 6 07:34:29 PST 1995
+ *    Checkes for changing to `.' since that is a no-op.
+ *
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
+ *    Robb Matzke, 2000-05-23
+ *    The old table of contents is discarded if the directory changes.
+ *
+ *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
+ *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBSetDir(DBfile *dbfile, const char *path)
+{
+    char           tmp[256];
+    int retval;
+
+    API_BEGIN2("DBSetDir", int, -1, api_dummy) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBSetDir", E_GRABBED) ; 
+        if (!path || !*path)
+            API_ERROR("path", E_BADARGS);
+        if (STR_EQUAL(path, "."))
+        {
+            API_RETURN(0);
+        }
+        if (DBGetDir(dbfile, tmp) < 0)
+            API_ERROR("DBGetDir", E_CALLFAIL);
+        if (STR_EQUAL(tmp, path))
+        {
+            API_RETURN(0);
+        }
+        if (!dbfile->pub.cd)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        retval = (dbfile->pub.cd) (dbfile, path);
+        db_FreeToc(dbfile);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBFilters
+ *
+ * Purpose:     List the names of filters installed for the specified
+ *              file.  The list is sent to the specified stream.
+ *
+ * Return:      Success:        0
+ *
+ *              Failure:        -1
+ *
+ * Programmer:  robb@cloud
+ *              Tue Mar  7 10:51:58 EST 1995
+ *
+ * Modifications:
+ *
+ *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
+ *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBFilters(DBfile *dbfile, FILE *stream)
+{
+    int retval;
+
+    API_BEGIN2("DBFilters", int, -1, api_dummy) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBFilters", E_GRABBED) ; 
+        if (!stream)
+            stream = stdout;
+        if (!dbfile->pub.module)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        retval = (dbfile->pub.module) (dbfile, stream);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBMkDir & DBMkDirP
+ *
+ * Purpose:     Creates a new directory in the database. The P variant
+ *              obeys unix `mkdir -p` semantics making parent directories
+ *              as necessary as does so *above* any specific driver using
+ *              calls to DBGetDir(), DBSetDir() and DBMkDir().
+ *
+ * Return:      Success:        directory ID
+ *
+ *              Failure:        -1
+ *
+ * Programmer:  matzke@viper
+ *              Tue Nov  8 11:46:21 PST 1994
+ *
+ * Modifications:
+ *    Robb Matzke, Mon Nov 21 21:36:44 EST 1994
+ *    Added error mechanism.
+ *
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *
+ *    Robb Matzke, 2000-05-23
+ *    The old table of contents is discarded if the directory changes.
+ *
+ *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
+ *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBMkDir(DBfile *dbfile, const char *name)
+{
+    int retval;
+
+    API_BEGIN2("DBMkDir", int, -1, api_dummy) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBMkDir", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("directory name", E_BADARGS);
+        if (db_VariableNameValid(name) == 0)
+            API_ERROR("directory name", E_INVALIDNAME);
+        if (!dbfile->pub.mkdir)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        retval = (dbfile->pub.mkdir) (dbfile, name);
+        db_FreeToc(dbfile);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+PUBLIC int
+DBMkDirP(DBfile *dbfile, const char *name)
+{
+    char        cwg[1024], *p;
+    char       *abspath = 0;
+    int         abslen = 0;
+    int         retval = 0;
+
+    API_BEGIN2("DBMkDirP", int, -1, api_dummy) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBMkDir", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("directory name", E_BADARGS);
+        if (db_VariableNameValid(name) == 0)
+            API_ERROR("directory name", E_INVALIDNAME);
+
+        /* Save cwg */
+        cwg[0] = '\0';
+        DBGetDir(dbfile, cwg);
+        abspath = db_absoluteOf_path(cwg,name);
+        abslen = strlen(abspath);
+
+        /* iterate setting and making one dir */
+        p = abspath+abslen;
+
+        /* Walk up path finding nearest existing parent */
+        while (p > abspath)
+        {
+            if (DBInqVarType(dbfile, abspath[0]=='\0'?"/":abspath) == DB_DIR) break;
+            while (p>abspath && '/'!=*p) p--;
+            *p = '\0';
+        }
+
+        /* Walk down path creating missing parents */
+        while (!retval && p < abspath+abslen)
+        {
+            DBSetDir(dbfile, abspath[0]=='\0'?"/":abspath);
+            retval = DBMkDir(dbfile, p+1);
+            *p = '/';
+            while (p<abspath+abslen && '\0'!=*p) p++;
+        }
+
+        /* restore cwg */
+        DBSetDir(dbfile, cwg);
+        free(abspath);
+
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+
+/*-------------------------------------------------------------------------
+ * Function:    DBCpDir
+ *
+ * Purpose:     Copies a directory tree from one file to another
+ *
+ * Return:      Success:        directory ID
+ *
+ *              Failure:        -1
+ *
+ * Programmer:  Mark C. Miller, Wed Aug  6 15:14:33 PDT 2008
+ *
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBCpDir(DBfile *dbfile, char const *srcDir,
+        DBfile *dstFile, char const *dstDir)
+{
+    int retval;
+
+    API_DEPRECATE2("DBCpDir", int, -1, api_dummy, 4, 11, "DBCp") {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (!dstFile)
+            API_ERROR(NULL, E_NOFILE);
+        if (db_isregistered_file(dstFile,0)==-1)
+            API_ERROR(NULL, E_NOTREG);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR(NULL, E_GRABBED) ; 
+        if (!srcDir || !*srcDir)
+            API_ERROR("source directory name", E_BADARGS);
+        if (!dstDir || !*dstDir)
+            API_ERROR("destination directory name", E_BADARGS);
+        if (db_VariableNameValid(dstDir) == 0)
+            API_ERROR("destination directory name", E_INVALIDNAME);
+        if (!dbfile->pub.cpdir)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        retval = (dbfile->pub.cpdir) (dbfile, srcDir, dstFile, dstDir);
+        db_FreeToc(dbfile);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBMkSymlink
+ *
+ * Purpose:     Create symbolic link in silo file's CWD with name link and 
+ *              referencing target. If target string contains ':', then
+ *              chars before ':' are interpreted as another silo file
+ *              and chars after ':' are interpreted as object within that
+ *              file. If file part specifies a relative path, then path is
+ *              relative to directory in which dbfile exists in
+ *              file system.
+ *
+ * Return:      Success:        directory ID
+ *
+ *              Failure:        -1
+ *
+ * Programmer:  Mark C. Miller, Mon Apr 16 14:52:05 PDT 2018
+ *
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBMkSymlink(DBfile *dbfile, char const *target, char const *link)
+{
+    int retval;
+
+    API_BEGIN2("DBMkSymlink", int, -1, api_dummy) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBMkDir", E_GRABBED) ; 
+        if (!target || !*target)
+            API_ERROR("target", E_BADARGS);
+        if (db_VariableNameValid(target) == 0)
+            API_ERROR("target", E_INVALIDNAME);
+        if (!link || !*link)
+            API_ERROR("link", E_BADARGS);
+        if (db_VariableNameValid(link) == 0)
+            API_ERROR("link", E_INVALIDNAME);
+        if (!dbfile->pub.mksymlink)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        retval = (dbfile->pub.mksymlink) (dbfile, target, link);
+        db_FreeToc(dbfile);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+/* return 0 if the toc_entry is not a symlink or the target of the
+ * symlink if it is */
+PUBLIC char const *
+DBIsSymlink(DBtoc const *toc, char const *toc_entry)
+{
+    int i;
+
+    if (!toc) return 0;
+    if (!toc_entry || !*toc_entry) return 0;
+
+    /* note: could use pointer compare instead of string
+       compare if could guarantee the toc_entry is one of
+       the members from this toc because symlink_name entry
+       is really just a copy of other toc entry's name
+       pointers */
+
+    for (i = 0; i < toc->nsymlink; i++)
+    {
+        if (!strcmp(toc->symlink_names[i], toc_entry))
+            return toc->symlink_target_names[i];
+    }
+
+    return 0;
+}
+
+PUBLIC int
+DBGetSymlink(DBfile *dbfile, char const *in_candidate_link, char *out_target)
+{
+    int retval;
+    API_BEGIN2("DBGetSymlink", int, -1, api_dummy) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBGetSymlink", E_GRABBED);
+        if (!in_candidate_link || !*in_candidate_link)
+            API_ERROR("in_candidate_link", E_BADARGS);
+        if (!dbfile->pub.g_symlink)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        retval = (dbfile->pub.g_symlink) (dbfile, in_candidate_link, out_target);
+        db_FreeToc(dbfile);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+PRIVATE void
+CheckForComponentSeries(DBobject const *srcObj, int i,
+    int *isser, int *nser, char **sernm, char **sertstr, void **serd)
+{
+    char *p = 0;
+    int pass = 0;
+    int dtyp = DB_NOTYPE;
+    int i0 = i;
+    int nd = (int) strcspn(srcObj->comp_names[i0], "0123456789");
+
+    /* advance while component names match in first nd chars */
+    i++;
+    while (i < srcObj->ncomponents)
+    {
+        if (strncmp(srcObj->comp_names[i], srcObj->comp_names[i0], nd) ||
+            strncmp(srcObj->pdb_names[i], "'<", 2) ||
+           !strncmp(srcObj->pdb_names[i], "'<s>/.silo/#", 12))
+            break;
+        i++;
+    }
+
+    /* If the series is of length one (or less) its not a series */
+    if ((i-i0) <= 1)
+    {
+        *isser = 0;
+        return;
+    }
+
+    *isser = 1;
+    *nser = i-i0;
+    *sernm = db_strndup(srcObj->comp_names[i0], nd);
+
+    /* first pass get size, second pass fill buffer */
+    for (pass = 0; pass < 2; pass++)
+    {
+        int j;
+
+        if (pass == 1)
+        {
+            p = (char *) malloc((size_t)p);
+            *serd = p;
+        }
+
+        for (j = i0; j < i; j++)
+        {
+            if      (!strncmp(srcObj->pdb_names[j], "'<i>", 4))
+            {
+                if (pass == 1)
+                    *((int*)p) = (int) strtol(srcObj->pdb_names[j]+4, NULL, 0);
+                p += sizeof(int);
+                if (dtyp == DB_NOTYPE) dtyp = DB_INT;
+            }
+            else if (!strncmp(srcObj->pdb_names[j], "'<f>", 4))
+            {
+                if (pass == 1)
+                     *((float*)p) = (float) strtod(srcObj->pdb_names[j]+4, NULL);
+                p += sizeof(float);
+                if (dtyp == DB_NOTYPE) dtyp = DB_FLOAT;
+            }
+            else if (!strncmp(srcObj->pdb_names[j], "'<d>", 4))
+            {
+                if (pass == 1)
+                    *((double*)p) = strtod(srcObj->pdb_names[j]+4, NULL);
+                p += sizeof(double);
+                if (dtyp == DB_NOTYPE) dtyp = DB_DOUBLE;
+            }
+            else if (!strncmp(srcObj->pdb_names[j], "'<s>", 4))
+            {
+                int len = (int) strlen(srcObj->pdb_names[j])-5;
+                if (pass == 1)
+                {
+                     strcpy(p, srcObj->pdb_names[j]+4);
+                     p[len] = '\0';
+                }
+                p += (len+1);
+                if (dtyp == DB_NOTYPE) dtyp = DB_CHAR;
+            }
+            else
+            {
+                int len = (int) strlen(srcObj->pdb_names[j]);
+                if (pass == 1)
+                     strcpy(p, srcObj->pdb_names[j]);
+                p += (len+1);
+            }
+        }
+    }
+
+    *sertstr = db_GetDatatypeString(dtyp);
+}
+
+static int
+db_validate_copy_step(int pass, int recurse,
+    char const *srcName, char const *srcAbsName, int srcType,
+    char const *dstName, char const *dstAbsName, int dstType)
+{
+    /* We validate everything 1rst pass so on 2nd, just ignore */
+    if (pass == 1) return 1;
+
+    /* Validate source object first */
+    if (srcType == DB_INVALID_OBJECT)
+    {
+        db_perror("src object does not exist", E_BADARGS, srcName);
+        return 0;
+    }
+
+    if (srcType == DB_DIR && !recurse)
+    {
+        db_perror("src is a directory (not copied)", E_BADARGS, srcName);
+        return 0;
+    }
+
+    /* If destination does not exist, that is fine */
+    if (dstType == DB_INVALID_OBJECT)
+        return 1;
+
+    /* If pre-existing destination type isn't same as src, that is a problem */
+    if (dstType != srcType)
+    {
+        db_perror("pre-existing dst object type mismatch with src", E_BADARGS,
+            dstName?dstName:srcName);
+        return 0;
+    }
+
+    /* If we get here, we're overwriting the destination object and that
+       is ok only if AllowOverwrites is enabled *and* the src object
+       can fit within the space used by the dst object, the latter piece
+       of logic we cannot currently check. */
+    if (!DBGetAllowOverwrites())
+    {
+#ifndef _WIN32
+#warning ONLY IF SRC SIZE SMALLER THAN DST SIZE
+#endif
+        db_perror("overwrite of pre-existing dst prevented due "
+            "to DBSetAllowOverwrites(0)", E_BADARGS, dstName?dstName:srcName);
+        return 0;
+    }
+
+    return 1;
+}
+
+#define COPY_TOC_ENTRY(TOC, NM, NUM, NAM)                        \
+    NUM = TOC->n ## NM;                                          \
+    NAM = (char **) malloc(NUM * sizeof(char*));                 \
+    for (int q = 0 ; q < NUM; q++)                               \
+    {                                                            \
+        int len = strlen(TOC->NM ## _names[q]);                  \
+        NAM[q] = (char*) calloc(len+1,1);                        \
+        strncpy(NAM[q], TOC->NM ## _names[q],len);               \
+    }
+
+#define FREE_COPIED_TOC_ENTRY(NUM, NAM)                          \
+    for (int q = 0; q < NUM; q++)                                \
+        FREE(NAM[q]);                                            \
+    FREE(NAM);
+
+/*-------------------------------------------------------------------------
+ * Function: db_can_overwrite_dstobj_with_srcobj
+ *
+ * Purpose: Compare two objects, member-by-member, to ensure the source
+ * object is smaller than (e.g. will fit into the same file space as) the
+ * destination object. There is possible recursion if the object contains
+ * sub-objects (e.g. a zonelist object within an ucd mesh object).
+ *
+ * Returns: 1 if source object matches destination object *and* fits in
+ *            in same space destination object occupies.
+ *          0 otherwise.
+ *
+ * Programmer:  Mark C. Miller, Wed Apr 18 09:23:55  PDT 2018
+ *
+ *-------------------------------------------------------------------------*/
+static int
+db_can_overwrite_dstobj_with_srcobj(
+    DBfile *srcFile, char const *srcAbsName,
+    DBfile *dstFile, char const *dstAbsName)
+{
+    int q;
+    int retval = 0; /* assume it won't work */
+    DBobject *srcObj = 0;
+    DBobject *dstObj = 0;
+
+    srcObj = DBGetObject(srcFile, srcAbsName);
+    if (!srcObj) goto done;
+
+    dstObj = DBGetObject(dstFile, dstAbsName);
+    if (!dstObj) goto done;
+
+    for (q = 0; q < srcObj->ncomponents; q++)
+    {
+        int r, dstr = -1;
+        char const *curr_compname = srcObj->comp_names[q];
+
+        for (r = 0; r < dstObj->ncomponents && dstr==-1; r++)
+            if (!strcmp(curr_compname, dstObj->comp_names[r]))
+                dstr = r;
+
+        if (dstr == -1) goto done; /* no matching comp in dst */
+
+        if (!strncmp(srcObj->pdb_names[q], "'<i>", 4))
+            continue;
+        else if (!strncmp(srcObj->pdb_names[q], "'<f>", 4))
+            continue;
+        else if (!strncmp(srcObj->pdb_names[q], "'<d>", 4))
+            continue;
+        else /* possible sub-object */
+        {
+            int srcLen, dstLen, can_overwrite;
+            DBObjectType srcSubObjType, dstSubObjType;
+            char *srcSubObjName, *srcSubObjDirName, *srcSubObjAbsName;
+            char *dstSubObjName, *dstSubObjDirName, *dstSubObjAbsName;
+
+            if (!strncmp(srcObj->pdb_names[q], "'<s>", 4))
+                srcSubObjName = db_strndup(srcObj->pdb_names[q]+4, strlen(srcObj->pdb_names[q])-5);
+            else
+                srcSubObjName = db_strndup(srcObj->pdb_names[q], strlen(srcObj->pdb_names[q]));
+            srcSubObjDirName = db_dirname(srcAbsName);
+            srcSubObjAbsName = db_join_path(srcSubObjDirName, srcSubObjName);
+
+            if (!strncmp(dstObj->pdb_names[dstr], "'<s>", 4))
+                dstSubObjName = db_strndup(dstObj->pdb_names[dstr]+4, strlen(dstObj->pdb_names[dstr])-5);
+            else
+                dstSubObjName = db_strndup(dstObj->pdb_names[dstr], strlen(dstObj->pdb_names[dstr]));
+            dstSubObjDirName = db_dirname(dstAbsName);
+            dstSubObjAbsName = db_join_path(dstSubObjDirName, dstSubObjName);
+
+            /* To make exiting and cleanup logic here a tad simpler, we do all
+               the work we *might* need to with the strings and then free them. */
+#ifndef _WIN32
+#warning SHOULDNT WE USE FILE LENGTH FUNCTIONS HERE
+#endif
+            srcSubObjType = DBInqVarType(srcFile, srcSubObjAbsName);
+            srcLen = DBGetVarByteLength(srcFile, srcSubObjAbsName);
+            dstSubObjType = DBInqVarType(dstFile, dstSubObjAbsName);
+            dstLen = DBGetVarByteLength(dstFile, dstSubObjAbsName);
+
+            if (dstSubObjType == DB_VARIABLE)
+                can_overwrite = 1;
+            else if (dstSubObjType == DB_DIR)
+                can_overwrite = 0;
+#ifndef _WIN32
+#warning DISALLOW SIMLINKS FOR NOW
+#endif
+            else if (dstSubObjType == DB_SYMLINK)
+                can_overwrite = 0;
+            else
+                can_overwrite = db_can_overwrite_dstobj_with_srcobj(
+                    srcFile, srcSubObjAbsName, dstFile, dstSubObjAbsName); /* recursive call */
+
+            FREE(srcSubObjName);
+            FREE(srcSubObjDirName);
+            FREE(srcSubObjAbsName);
+            FREE(dstSubObjName);
+            FREE(dstSubObjDirName);
+            FREE(dstSubObjAbsName);
+
+            /* decide if its ok to proceed or not */
+            if (srcSubObjType == DB_VARIABLE && dstSubObjType == DB_VARIABLE)
+            {
+                if (srcLen > dstLen) goto done; /* simple src var doesn't fit in dst */
+            }
+            else if (srcSubObjType == dstSubObjType)
+            {
+                if (!can_overwrite) goto done; /* src object doesn't fit in dst */
+            }
+            else
+            {
+                goto done; /* src & dst disagree on subobject's type */
+            }
+        }
+    }
+
+    /* indicate it will work */
+    retval = 1;
+
+done:
+
+    if (srcObj) DBFreeObject(srcObj);
+    if (dstObj) DBFreeObject(dstObj);
+
+    return retval;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:   db_copy_single_object_abspath
+ *
+ * Purpose: Copy a single source *object* to a destination object or
+ * directory using the generic object routines. The source cannot be a
+ * directory. If destination does not exist, ensure its parent is an
+ * existing directory. If destination is a pre-existing object, overwrite
+ * that object as per options and as long as it fits. If destination is a
+ * pre-existing directory, copy the source object *into* that directory.
+ *
+ * Returns: 1 If the copy succeeds.
+ *          0 Otherwise.
+ *
+ * Programmer:  Mark C. Miller, Wed Apr 18 09:23:55  PDT 2018
+ *
+ *-------------------------------------------------------------------------*/
+static int
+db_copy_single_object_abspath(char const *opts,
+    DBfile *srcFile, char const *srcObjAbsName, DBObjectType srcType,
+    DBfile *dstFile, char const *dstObjAbsName, DBObjectType dstType)
+{
+    int q;
+    char *_dstObjAbsName;
+    DBobject *dstObj, *srcObj;
+
+#ifndef _WIN32
+#warning CHECK ARGS HERE. ALLOW FOR NULL dstFile AND dstObjAbsName
+#warning WHY CHECK dstType HERE
+#endif
+
+    /* Query type information if not already known */
+    if (srcType == DB_INVALID_OBJECT)
+        srcType = DBInqVarType(srcFile, srcObjAbsName);
+    if (dstType == DB_INVALID_OBJECT)
+        dstType = DBInqVarType(dstFile, dstObjAbsName);
+
+    /* Source object cannot be a directory */
+    if (srcType == DB_INVALID_OBJECT || srcType == DB_DIR)
+        return 0;
+
+    /* If destination is a directory, dstObjAbsName needs to be adjusted
+       to append last component of srcObjAbsName */
+    if (dstType == DB_DIR)
+    {
+        char *bname = db_basename(srcObjAbsName);
+        _dstObjAbsName = db_join_path(dstObjAbsName, bname);
+        FREE(bname);
+    }
+    /* If destination is a pre-existing non-directory object, this implies
+       it will be overwritten by source. But, in that case, dstFile needs
+       to allow overwrites and the source needs to be small enough to fit
+       into the space the destination object occupies. */
+    else if (dstType != DB_INVALID_OBJECT)
+    {
+        int srcSize, dstSize;
+#ifndef _WIN32
+#warning USE FILE-BASED FUNCTION WHEN AVAILABLE
+#endif
+        if (!DBGetAllowOverwrites())
+        {
+            db_perror("overwrite of pre-existing dst prevented due "
+                "to DBSetAllowOverwrites(0)", E_BADARGS, dstObjAbsName);
+            return 0;
+        }
+        if (!db_can_overwrite_dstobj_with_srcobj(
+             srcFile, srcObjAbsName, dstFile, dstObjAbsName))
+        {
+            db_perror("overwrite of pre-existing dst prevented due "
+                "to insufficient space for src object", E_BADARGS, dstObjAbsName);
+            return 0;
+        }
+        _dstObjAbsName = STRDUP(dstObjAbsName);
+    }
+    else
+    {
+        _dstObjAbsName = STRDUP(dstObjAbsName);
+    }
+
+    /* Access the source object using generic interface */
+    srcObj = DBGetObject(srcFile, srcObjAbsName);
+    if (!srcObj)
+    {
+        db_perror("Unable to access source object for copy operation",
+            E_NOTFOUND, srcObjAbsName);
+        return 0;
+    }
+
+    /* Handle funniness with quadmesh type strings */
+    if (srcType == DB_QUADMESH)
+    {
+        if (strstr(srcObj->type, "rect"))
+            srcType = DB_QUAD_RECT;
+        else if (strstr(srcObj->type, "curv"))
+            srcType = DB_QUAD_CURV;
+    }
+
+    /* Ok, lets do what we came here to do...create the dst object and
+       start populating it */
+    dstObj = DBMakeObject(_dstObjAbsName, srcType, srcObj->ncomponents);
+    for (q = 0; q < srcObj->ncomponents; q++)
+    {
+        int isser = 0, nser = 0;
+        char *sernm = 0, *sertstr = 0;
+        void *serd = 0;
+        CheckForComponentSeries(srcObj, q, &isser, &nser, &sernm, &sertstr, &serd);
+        if (isser)
+        {
+            long tmpn = (long) nser;
+            DBWriteComponent(dstFile, dstObj, sernm,
+                dstObj->name, sertstr, serd, 1, &tmpn);
+            free(sernm);
+            free(sertstr);
+            free(serd);
+            q += (nser-1);
+        }
+        else if (!strncmp(srcObj->pdb_names[q], "'<i>", 4))
+            DBAddIntComponent(dstObj, srcObj->comp_names[q],
+                (int) strtol(srcObj->pdb_names[q]+4, NULL, 0));
+        else if (!strncmp(srcObj->pdb_names[q], "'<f>", 4))
+            DBAddFltComponent(dstObj, srcObj->comp_names[q],
+                (float) strtod(srcObj->pdb_names[q]+4, NULL));
+        else if (!strncmp(srcObj->pdb_names[q], "'<d>", 4))
+            DBAddDblComponent(dstObj, srcObj->comp_names[q],
+                strtod(srcObj->pdb_names[q]+4, NULL));
+        else
+        {
+            DBObjectType subObjType;
+            char *subObjName;
+            char *srcObjDirName, *srcSubObjAbsName;
+             
+            if (!strncmp(srcObj->pdb_names[q], "'<s>", 4))
+                subObjName = db_strndup(srcObj->pdb_names[q]+4, strlen(srcObj->pdb_names[q])-5);
+            else
+                subObjName = db_strndup(srcObj->pdb_names[q], strlen(srcObj->pdb_names[q]));
+
+            srcObjDirName = db_dirname(srcObjAbsName);
+            srcSubObjAbsName = db_join_path(srcObjDirName, subObjName);
+
+            subObjType = DBInqVarType(srcFile, srcSubObjAbsName);
+            if (subObjType == DB_VARIABLE) /* raw data copy */
+            {
+                int j, dims[32];
+                long ldims[32];
+                int idtype = DBGetVarType(srcFile, srcSubObjAbsName);
+                int ndims = DBGetVarDims(srcFile, srcSubObjAbsName, 32, dims);
+                void *data = DBGetVar(srcFile, srcSubObjAbsName);
+                char *dtype = db_GetDatatypeString(idtype);
+                for (j = 0; j < ndims; ldims[j] = (long) dims[j], j++);
+                DBWriteComponent(dstFile, dstObj, srcObj->comp_names[q],
+                    dstObj->name, dtype, data, ndims, ldims);
+                FREE(dtype);
+                FREE(data);
+            }
+            else if (((srcType == DB_UCDMESH) && /* possible recurse on sub-object */
+                      (subObjType == DB_FACELIST || subObjType == DB_EDGELIST ||
+                       subObjType == DB_ZONELIST || subObjType == DB_PHZONELIST)) ||
+                     (srcType == DB_CSGMESH && subObjType == DB_CSGZONELIST)) 
+            {
+                char *dstObjDirName = db_dirname(dstObjAbsName);
+                char *dstSubObjAbsName = db_join_path(dstObjDirName, subObjName);
+
+                db_copy_single_object_abspath(opts, /* recursive call */
+                   srcFile, srcSubObjAbsName, subObjType,
+                   dstFile, dstSubObjAbsName, DB_INVALID_OBJECT);
+
+                DBAddStrComponent(dstObj, srcObj->comp_names[q], subObjName);
+
+                FREE(dstObjDirName);
+                FREE(dstSubObjAbsName);
+            }
+            free(subObjName);
+            free(srcObjDirName);
+            free(srcSubObjAbsName);
+        }
+    }
+
+    DBWriteObject(dstFile, dstObj, SILO_Globals.allowOverwrites);
+    DBFreeObject(srcObj);
+    DBFreeObject(dstObj);
+    FREE(_dstObjAbsName);
+
+    return 1;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBCp
+ *
+ * Purpose:     The Silo equivalent of a unix `cp` command obeying all unix
+ *              semantics and applicable flags. In particular...
+ *
+ *    Single src object to single dst object
+ *        DBCp(char const *opts, DBfile *srcFile, DBfile *dstFile,
+ *            char const *srcPATH, char const *dstPATH, DB_EOA);
+ *
+ *    Multiple src objects to single dst (dir) object
+ *        DBCp(char const *opts, DBfile *srcFile, DBfile *dstFile,
+ *            char const *srcPATH1, char const *srcPATH2, ...,
+ *            char const *dstDIR, DB_EOA);
+ *
+ *    Multiple src objects to multiple dst objects
+ *        DBCp("-2...", DBfile *srcFile, DBfile *dstFile,
+ *            char const *srcPATH1, char const *dstPATH1,
+ *            char const *srcPATH2, char const *dstPATH2,
+ *            char const *srcPATH3, char const *dstPATH3, ..., DB_EOA);
+ *
+ *    srcFile and dstFile may be the same Silo file. srcFile cannot be null.
+ *    dstFile may be null in which case it is assumed same as srcFile.
+ *    The argument list *must* be terminated by the DB_EOA sentinel. Just as
+ *    for unix `cp`, the options and their meanings are...
+ *
+ *      -R/-r recurse on any directory objects
+ *      -L/-P dereference links / never dereference links
+ *      -d    preserve links
+ *      -s/-l don't actually copy, just sym/hard link
+ *            (only possible when srcFile==dstFile)
+ *
+ *    Other rules:
+ *       * If any src is a dir, then it is an error without -R/-r.
+ *       * If cooresponding dst exists and is a dir, src is copied
+ *         into (e.g. becomes a child of) dst.
+ *       * If cooresponding dst exists and is not a dir (e.g. is just a
+ *         normal Silo object), then it is an error if src is not also the 
+ *         same kind of Silo object. The copy overwrites (destructive) dst.
  *         However, if the file space dst object occupies is smaller than
  *         that needed to copy src, behavior is indeterminate but most 
  *         likely will result the dst file (not just the dst object) being
  *         corrupted.
  *
- *    The following options are specific to Silo's DBCp method and are
- *    mutually exclusive...
+ *    The following options are specific to Silo's DBCp method and are
+ *    mutually exclusive...
+ *
+ *      -2 treat varargs list of args as src/dst path pairs and where any
+ *         null dst is inferred to have same path as associated src except
+           that relative paths are interpreted relative to dst files cwg.
+ *      -1 like -2 except caller passes only src paths. All dst paths are
+ *         inferred to be same as associated src path. The dst file's cwg
+ *         will then determine how any relative src paths are interpreted.
+ *      -3 only 3 args follow the dstFile arg...
+ *         int N                number of objects in the following lists
+ *         DBCAS_t srcPathNames list of N source path names
+ *         DBCAS_t dstPathNames list of N destination path names
+ *      -4 Like -3, except 3rd arg is treated as a single dest. dir name
+ *         int N                number of paths in srcPathNames
+ *         DBCAS_t srcPathNames list of N source path names
+ *         char const *dstDIR   pre-existing destination dir path name.
+ *      -5 Internal use only...like -4 except used only internally when
+ *         DBCp recursively calls itself.
+ *
+ *      If none of the preceding numeric arguments are specified, then
+ *      the varags list of args is treated as (default) where the last
+ *      is a pre-existing destination directory and all the others are
+ *      the paths of source objects to be copied into that directory.
+ *
+ *      Relative path names are interpreted relative to the current working
+ *      directory of the associated (src or dst) file when DBCp is invoked.
+ *
+ *      In all the different ways this function can be invoked, there are
+ *      really just two fundamentally different interpretations of the list(s)
+ *      of names. Either each source path is paired also with a destination
+ *      path or all source paths go into a single destination path which, just
+ *      as for linux cp, must then also be a directory already present in the
+ *      destination.
+ *
+ * Return:      Success:        0
+ *              Failure:       -1
+ *
+ * Programmer:  Mark C. Miller, Wed Apr 18 09:23:55  PDT 2018
+ *
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBCp(char const *opts, DBfile *srcFile, DBfile *dstFile, ...)
+{
+#ifndef _WIN32
+#warning WHAT ABOUT API MACROS. MAYBE NOT NEEDED SINCE NOT CALLING DOWN INTO DRIVERS
+#warning WHAT ABOUT -f (force) OPTION
+#endif
+    char const *me = "DBCp";
+    int i, j, pass, all_ok;
+    int recurse_on_dirs = 0;
+    int preserve_links = 0;
+    int deref_links = 0;
+    int never_deref_links = 0;
+    int dont_copy_just_symlink = 0;
+    int dont_copy_just_hardlink = 0;
+    int src_dst_pairs = 0;
+    int srcs_only = 0;
+    int n_src_dst_triple = 0;
+    int n_src_dir_triple = 0;
+    int recursive_call = 0;
+    char const *many_to_one_dir = 0;
+    int N = 0;
+    char const **srcPathNames = 0, **dstPathNames = 0;
+    char srcStartCwg[1024], dstStartCwg[1024];
+
+#ifndef _WIN32
+#warning WARN ABOUT CERTAIN OPTIONS NOT YET SUPPORTED
+#endif
+    /* process any options in the opts string */
+    for (i = 0; opts && opts[i]; i++)
+    {
+        switch (opts[i])
+        {
+            case ' ':
+            case '-': continue;
+            case 'R':
+            case 'r': recurse_on_dirs = 1; break;
+            case 'd': preserve_links = 1; break;
+            case 'L': deref_links = 1; break;
+            case 'P': never_deref_links = 1; break;
+            case 's': dont_copy_just_symlink = 1; break;
+            case 'l': dont_copy_just_hardlink = 1; break;
+            case '2': src_dst_pairs = 1; break;
+            case '1': srcs_only = 1; break;
+            case '3': n_src_dst_triple = 1; break;
+            case '4': n_src_dir_triple = 1; break;
+            case '5': n_src_dir_triple = 1; recursive_call = 1; break;
+            default: return db_perror(&opts[i], E_BADARGS, me);
+        }
+    }
+
+    /* Sanity checks */
+    if (!dstFile)
+        dstFile = srcFile;
+
+    if (!srcFile)
+        return db_perror("srcFile cannot be null", E_BADARGS, me);
+
+    if ((dont_copy_just_symlink || dont_copy_just_hardlink) && srcFile != dstFile)
+        return db_perror("srcFile and dstFile must be same for -s or -l", E_BADARGS, me);
+
+
+    if (n_src_dst_triple || n_src_dir_triple) // -3 or -4
+    {
+        va_list ap;
+        va_start(ap, dstFile);
+        N = va_arg(ap, int);
+        srcPathNames = va_arg(ap, char const **);
+        if (n_src_dst_triple)
+            dstPathNames = va_arg(ap, char const **);
+        else
+            many_to_one_dir = va_arg(ap, char const *);
+        va_end(ap);
+    }
+    else
+    {
+        /* Process varargs in two passes. Pass 1, count them. Pass 2
+           allocate space and capture them. */
+        int pass;
+
+        for (pass = 0; pass < 2; pass++)
+        {
+            int n = 0;
+            char const *arg;
+            va_list ap;
+            va_start(ap, dstFile);
+            if (pass == 1)
+            {
+                srcPathNames = (char const **) malloc(N * sizeof(char const *));
+                if (src_dst_pairs)
+                    dstPathNames = (char const **) malloc(N * sizeof(char const *));
+            }
+            while ((arg = va_arg(ap, char const *)) != DB_EOA)
+            {
+                if (pass == 1)
+                {
+                    if (src_dst_pairs)
+                    {
+                        if (n%2) dstPathNames[n/2] = arg;
+                        else     srcPathNames[n/2] = arg;
+                    }
+                    else
+                    {
+                        srcPathNames[n] = arg;
+                    }
+                }
+                n++;
+            }
+            va_end(ap);
+            N = src_dst_pairs?n/2:n;
+        }
+    }
+
+#ifndef _WIN32
+#warning FIX LEAKS WITH EARLY RETURN HERE
+#endif
+
+    if (n_src_dir_triple && N == 0)
+        return 0;
+    if (!n_src_dir_triple && N < 2)
+        return db_perror("src or dst unspecified", E_BADARGS, me);
+    if (src_dst_pairs && N%2)
+        return db_perror("non-even arg count for -2 option", E_BADARGS, me);
+
+    /* target dir is at end of list of sources */
+    if (!many_to_one_dir && !src_dst_pairs && !n_src_dst_triple && !n_src_dir_triple)
+    {
+        many_to_one_dir = srcPathNames[N-1];
+        N--;
+    }
+
+    if (many_to_one_dir)
+    {
+        int q;
+        dstPathNames = (char const **) malloc(N * sizeof(char const *));
+        for (q = 0; q < N; q++)
+            dstPathNames[q] = many_to_one_dir; /* all point to same char* */
+    }
+
+    DBGetDir(srcFile, srcStartCwg);
+    DBGetDir(dstFile, dstStartCwg);
+
+    for (i = 0; i < N; i++)
+    {
+        DBObjectType srcType, dstType;
+        char *srcObjAbsName, *dstObjAbsName;
+        char savcwg[1024], srccwg[1024], dstcwg[1024];
+        char opts2[16] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+        char **dirItems, **otherItems;
+        int  dirItemCount, otherItemCount;
+
+        if (i == 0)
+        {
+            DBGetDir(srcFile, srccwg);
+            DBGetDir(dstFile, dstcwg);
+        }
+
+        srcObjAbsName = db_join_path(srccwg, srcPathNames[i]);
+        srcType = DBInqVarType(srcFile, srcObjAbsName);
+
+        dstObjAbsName = db_join_path(dstcwg, dstPathNames[i]?dstPathNames[i]:srcPathNames[i]);
+        dstType = DBInqVarType(dstFile, dstObjAbsName);
+
+        if (srcType == DB_INVALID_OBJECT)
+        {
+            db_perror(DBSPrintf("\"%s\" invalid object", srcObjAbsName), E_BADARGS, me);
+            goto endLoop;
+        }
+
+        if (srcType != DB_DIR)
+        {
+            if (!db_copy_single_object_abspath(opts, 
+                    srcFile, srcObjAbsName, srcType,
+                    dstFile, dstObjAbsName, dstType))
+            {
+                db_perror("Object copy failed", E_CALLFAIL, me);
+                goto endLoop;
+            }
+            continue;
+        }
+
+        /* If we get this far into the loop body here, then src is a dir */
+        if (!recurse_on_dirs)
+        {
+            db_perror(DBSPrintf("Cannot copy dir \"%s\" without -r flag",
+                srcObjAbsName), E_BADARGS, me);
+            goto endLoop;
+        }
+
+        if (dstType != DB_INVALID_OBJECT && dstType != DB_DIR)
+        {
+            db_perror(DBSPrintf("Cannot copy dir \"%s\" onto pre-existing non-dir \"%s\"",
+                srcObjAbsName, dstObjAbsName), E_BADARGS, me);
+            goto endLoop;
+        }
+
+#if 0
+        /* get the contents of this dir in two lists; all the dirs, everything else */
+        DBLs(srcFile, DBSPrintf("-d %s", srcObjAbsName), 0, &dirItemCount); /* just count it first */
+        dirItems = ALLOC_N(char*, ++dirItemCount);
+        DBLs(srcFile, DBSPrintf("-d %s", srcObjAbsName), dirItems, &dirItemCount);
+
+        DBLs(srcFile, DBSPrintf("-a -d %s", srcObjAbsName), 0, &otherItemCount); /* just count it first */
+        otherItems = ALLOC_N(char*, ++otherItemCount);
+        DBLs(srcFile, DBSPrintf("-a -d %s", srcObjAbsName), otherItems, &otherItemCount);
+#endif
+        /* get the contents of this dir */
+        DBSetDir(srcFile, srcObjAbsName);
+        DBLs(srcFile, "-a -x", 0, &dirItemCount); /* just count it first */
+        dirItems = ALLOC_N(char*, dirItemCount);
+        DBLs(srcFile, "-a -x", dirItems, &dirItemCount);
+
+        if (dstType == DB_INVALID_OBJECT)
+        {
+            DBMkDir(dstFile, dstObjAbsName);
+            DBSetDir(dstFile, dstObjAbsName);
+        }
+        else if (dstType == DB_DIR)
+        {
+            char *srcDirBaseName = db_basename(srcObjAbsName);
+            DBMkDir(dstFile, srcDirBaseName);
+            DBSetDir(dstFile, srcDirBaseName);
+            free(srcDirBaseName);
+        }
+
+        if (n_src_dir_triple)
+            DBCp(opts, srcFile, dstFile, dirItemCount, dirItems, ".");
+        else
+            DBCp(DBSPrintf("%s -4", opts), srcFile, dstFile, dirItemCount, dirItems, ".");
+
+        DBSetDir(srcFile, "..");
+        DBSetDir(dstFile, "..");
+
+endLoop:
+        FREE(srcObjAbsName);
+        FREE(dstObjAbsName);
+    }
+
+    DBSetDir(srcFile, srcStartCwg);
+    DBSetDir(dstFile, dstStartCwg);
+
+    return 0;
+}
+
+#if 1
+PUBLIC int
+DBCpListedObjects(int nobjs,
+    DBfile *dbfile, char const * const *srcObjs,
+    DBfile *dstFile, char const * const *dstObjs)
+{
+    int retval;
+
+    API_BEGIN2("DBCpListedObjects", int, -1, api_dummy) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (!dstFile)
+            API_ERROR(NULL, E_NOFILE);
+        if (db_isregistered_file(dstFile,0)==-1)
+            API_ERROR(NULL, E_NOTREG);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR(NULL, E_GRABBED); 
+        if (nobjs > 0)
+        {
+            if (!srcObjs)
+                API_ERROR("source object names list", E_BADARGS);
+            if (dstObjs)
+            {
+                int i;
+                for (i = 0; i < nobjs; i++)
+                {
+                    if (dstObjs[i] == 0 || dstObjs[i][0] == '\0')
+                        continue;
+                    if (db_VariableNameValid(dstObjs[i]) == 0)
+                        API_ERROR(dstObjs[i], E_INVALIDNAME);
+                }
+            }
+        }
+        if (!dbfile->pub.cpnobjs)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+        retval = (dbfile->pub.cpnobjs) (nobjs, dbfile, srcObjs, dstFile, dstObjs);
+        db_FreeToc(dbfile);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+#else
+#warning REMOVE ABOVE IF STATEMENT
+PUBLIC int
+DBCpListedObjects(int nobjs,
+    DBfile *dbfile, char const * const *srcObjs,
+    DBfile *dstFile, char const * const *dstObjs)
+{
+}
+#endif
+
+/*-------------------------------------------------------------------------
+ * Function:    DBChangeObject
+ *
+ * Purpose:     Overwrites an object with a new object.  This is usually
+ *              the same function as called by DBWriteObject but with
+ *              OVER_WRITE as the flag.  However, we keep it as a separate
+ *              callback so existing drivers that don't support overwriting
+ *              don't need to be changed and so that the silo API doesn't
+ *              change by changing the meaning of the `freemem' argument
+ *              to DBWriteObject.
+ *
+ * Return:      Success:        0
+ *
+ *              Failure:        -1
+ *
+ * Programmer:  Robb Matzke
+ *              robb@maya.nuance.mdn.com
+ *              Mar  7 1997
+ *
+ * Modifications:
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Completely reformatted the code so a human can read it.  Made the error
+ *    messages a little better.
+ *
+ *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
+ *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBChangeObject (DBfile *dbfile, DBobject const *obj)
+{
+    int             retval;
+
+    API_BEGIN2("DBChangeObject", int, -1, api_dummy)
+    {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBChangeObject", E_GRABBED) ; 
+        if (!obj)
+            API_ERROR("object pointer", E_BADARGS);
+        if (!dbfile->pub.c_obj)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+        retval = (dbfile->pub.c_obj) (dbfile, obj, OVER_WRITE);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP;                     /* BEWARE: If API_RETURN is removed 
+                                        * use API_END */
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBWriteObject
+ *
+ * Purpose:     Write an object into the data file.
+ *
+ * Return:      Success:        0
+ *
+ *              Failure:        -1
+ *
+ * Programmer:  matzke@viper
+ *              Mon Nov  7 10:45:14 PST 1994
+ *
+ * Modifications:
+ *    Robb Matzke, Mon Nov 21 21:37:54 EST 1994
+ *    Added error mechanism.
+ *
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
+ *    Robb Matzke, 7 Mar 1997
+ *    The freemem value passed to the driver is either FREE_MEM or zero
+ *    so that drivers that overload this function with DBChangeObject
+ *    are guaranteed to be able to tell the difference.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *
+ *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
+ *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBWriteObject(DBfile *dbfile, DBobject const *obj, int freemem)
+{
+    int retval;
+
+    API_BEGIN2("DBWriteObject", int, -1, api_dummy)
+    {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBWriteObject", E_GRABBED) ; 
+        if (!obj)
+            API_ERROR("object pointer", E_BADARGS);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, obj->name))
+            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
+        if (!dbfile->pub.w_obj)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        retval = (dbfile->pub.w_obj) (dbfile, obj, freemem?FREE_MEM:0);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+PUBLIC void *
+DBGetPartialObject(DBfile *dbfile, char const *name, int nvals, int ndims,
+    int index_mode, void const *indices, DBoptlist *options)
+{
+#ifndef _WIN32
+#warning FIX THIS METHOD
+#endif
+
+
+
+    /* call directly down into driver */
+
+    /* get type */
+    DBObjectType otype = DBInqVarType(dbfile, name);
+
+    /* set mask and read object header */
+
+    /* get list of datasets */
+
+    /* If dense, do partial I/O on the datasets */
+    /* Else... do object specific partial I/O */
+    /* Handle mixed values on variables */
+
+    return 0;
+}
+
+PUBLIC DBmaterial *
+DBGetPartialMaterial(DBfile *dbfile, char const *name, int mode, int nvals,
+    int ndims, void const *indices, DBoptlist *options)
+{
+    return (DBmaterial *) DBGetPartialObject(dbfile, name, mode, nvals, ndims, indices, options);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBGetObject
+ *
+ * Purpose:     Reads an object from a file.
+ *
+ * Return:      Success:        Ptr to the new object.
+ *
+ *              Failure:        NULL
+ *
+ * Programmer:  Robb Matzke
+ *              matzke@viper.llnl.gov
+ *              Dec  2 1996
+ *
+ * Modifications:
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *
+ *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
+ *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ *-------------------------------------------------------------------------*/
+PUBLIC DBobject *
+DBGetObject (DBfile *dbfile, char const *objname)
+{
+    DBobject       *retval = NULL;
+
+    API_BEGIN2("DBGetObject", DBobject *, NULL, api_dummy)
+    {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBGetObject", E_GRABBED) ; 
+        if (!objname)
+            API_ERROR("object name", E_BADARGS);
+        if (!dbfile->pub.g_obj)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+        retval = (dbfile->pub.g_obj) (dbfile, (char const *)objname);
+        db_AdjustSpeciallyHandledStandardObjectComponentValues(retval);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP;                     /* BEWARE:  If API_RETURN above is
+                                        * removed use API_END */
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBWriteComponent
+ *
+ * Purpose:     Add a variable component to the given object structure, AND
+ *              write out the associated data.
+ *
+ * Return:      Success:        0
+ *
+ *              Failure:        -1
+ *
+ * Programmer:  matzke@viper
+ *              Mon Nov  7 10:47:29 PST 1994
+ *
+ * Modifications:
+ *    Robb Matzke, Mon Nov 21 21:39:06 EST 1994
+ *    Added error mechanism.
+ *
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
+ *    Sean Ahern, Tue Mar 31 17:16:24 PST 1998
+ *    I added a check for zero-length data arrays.
+ *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *
+ *    Robb Matzke, 2000-05-23
+ *    The old table of contents is discarded if the directory changes.
+ *
+ *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
+ *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBWriteComponent(DBfile *dbfile, DBobject *obj, char const *comp_name,
+                 char const *prefix, char const *datatype, void const *var, int nd,
+                 long const *count)
+{
+    int retval;
+    int nvals, i;
+
+    API_BEGIN2("DBWriteComponent", int, -1, api_dummy) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBWriteComponent", E_GRABBED) ;
+        if (!obj)
+            API_ERROR("object pointer", E_BADARGS);
+        if (DBGetAllowEmptyObjectsFile(dbfile))
+        {
+            if (nd<=0) API_RETURN(0);
+            if (!count) API_RETURN(0);
+            if (!var) API_RETURN(0);
+            for(nvals=1,i=0;i<nd;i++)
+                nvals *= count[i];
+            if (nvals<=0) API_RETURN(0);
+        }
+        if (!comp_name || !*comp_name)
+            API_ERROR("component name", E_BADARGS);
+        if (db_VariableNameValid((char *)comp_name) == 0)
+            API_ERROR("component name", E_INVALIDNAME);
+#if 0
+        /* We don't know what name to pass to DBInqVarExists here because it
+           is the driver that knows how to construct component names */
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, obj->name))
+            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
+#endif
+        if (!prefix || !*prefix)
+            API_ERROR("prefix", E_BADARGS);
+        if (db_VariableNameValid((char *)prefix) == 0)
+            API_ERROR("prefix", E_INVALIDNAME);
+        if (!datatype || !*datatype)
+            API_ERROR("data type", E_BADARGS);
+        if (!var)
+            API_ERROR("var pointer", E_BADARGS);
+        if (nd <= 0)
+            API_ERROR("nd", E_BADARGS);
+        if (!count && nd)
+            API_ERROR("count", E_BADARGS);
+        for(nvals=1,i=0;i<nd;i++)
+        {
+            nvals *= count[i];
+        }
+        if (nvals == 0) {
+            API_ERROR("Zero-length write attempted", E_BADARGS);
+        }
+        if (!dbfile->pub.w_comp)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        /* Note that the work to add the variable component to the object is
+           handled down in the drivers due to the fact that the drivers may
+           use different rules to construct the object component names */
+
+        retval = (dbfile->pub.w_comp) (dbfile, obj, comp_name, prefix,
+                                       datatype, var, nd, count);
+        db_FreeToc(dbfile);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBWrite
+ *
+ * Purpose:     Writes a single variable into the database.
+ *
+ * Return:      Success:        0
+ *
+ *              Failure:        -1
+ *
+ * Programmer:  robb@cloud
+ *              Wed Nov  9 13:19:49 EST 1994
+ *
+ * Modifications:
+ *    Robb Matzke, Mon Nov 21 21:42:27 EST 1994
+ *    Added error mecanism.
+ *
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
+ *    Sean Ahern, Tue Mar 31 17:17:44 PST 1998
+ *    I added a check for zero-length arrays.
+ *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *
+ *    Robb Matzke, 2000-05-23
+ *    The old table of contents is discarded if the directory changes.
+ *
+ *    Mark C. Miller, Mon Jan 11 17:42:51 PST 2010
+ *    Allow special variable names in the magic /.silo dir for HDF5 files.
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBWrite(DBfile *dbfile, char const *vname, void const *var, int const *dims,
+    int ndims, int datatype)
+{
+    int retval;
+    int nvals, i;
+
+    API_BEGIN2("DBWrite", int, -1, vname) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBWrite", E_GRABBED) ; 
+        if (!vname || !*vname)
+            API_ERROR("variable name", E_BADARGS);
+        if (strncmp("/.silo/#", vname, 8) != 0 &&
+            db_VariableNameValid(vname) == 0)
+            API_ERROR("variable name", E_INVALIDNAME);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, vname))
+            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
+        if (ndims < 0)
+            API_ERROR("ndims", E_BADARGS);
+        if (ndims == 0 && !DBGetAllowEmptyObjectsFile(dbfile))
+            API_ERROR("ndims==0", E_EMPTYOBJECT);
+        if (!dims && ndims)
+            API_ERROR("dims", E_BADARGS);
+        for(nvals=ndims>0?1:0,i=0;i<ndims;i++)
+            nvals *= dims[i];
+        if (nvals == 0 && !DBGetAllowEmptyObjectsFile(dbfile))
+            API_ERROR("Zero length write attempted", E_EMPTYOBJECT);
+        if (db_FullyDeprecatedConvention(vname))
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+        if (!dbfile->pub.write)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        retval = (dbfile->pub.write) (dbfile, vname, var, dims,
+                                      ndims, datatype);
+
+        /* diddle with retval if its an empty case */
+        if ((ndims == 0 || nvals == 0) && retval == 1) retval = 0;
+
+        db_FreeToc(dbfile);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBWriteSlice
+ *
+ * Purpose:     Similar to DBWrite except only part of the data is
+ *              written.  If VNAME doesn't exist, space is reserved for
+ *              the entire variable based on DIMS; otherwise we check
+ *              that DIMS has the same value as originally.  Then we
+ *              write the specified slice to the file.
  *
- *      -2 treat varargs list of args as src/dst path pairs and where any
- *         null dst is inferred to have same path as associated src except
-           that relative paths are interpreted relative to dst files cwg.
- *      -1 like -2 except caller passes only src paths. All dst paths are
- *         inferred to be same as associated src path. The dst file's cwg
- *         will then determine how any relative src paths are interpreted.
- *      -3 only 3 args follow the dstFile arg...
- *         int N                number of objects in the following lists
- *         DBCAS_t srcPathNames list of N source path names
- *         DBCAS_t dstPathNames list of N destination path names
- *      -4 Like -3, except 3rd arg is treated as a single dest. dir name
- *         int N                number of paths in srcPathNames
- *         DBCAS_t srcPathNames list of N source path names
- *         char const *dstDIR   pre-existing destination dir path name.
- *      -5 Internal use only...like -4 except used only internally when
- *         DBCp recursively calls itself.
+ * Return:      Success:        0
  *
- *      If none of the preceding numeric arguments are specified, then
- *      the varags list of args is treated as (default) where the last
- *      is a pre-existing destination directory and all the others are
- *      the paths of source objects to be copied into that directory.
+ *              Failure:        -1
+ *
+ * Programmer:  Robb Matzke
+ *              robb@callisto.nuance.com
+ *              May  9, 1996
+ *
+ * Modifications:
+ *    Sean Ahern, Tue Mar 31 17:19:38 PST 1998
+ *    I added a check for zero-length writes.
+ *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *
+ *    Robb Matzke, 2000-05-23
+ *    The old table of contents is discarded if the directory changes.
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBWriteSlice (DBfile *dbfile, const char *vname, void const *values, int dtype,
+              int const *offset, int const *length, int const *stride, int const *dims,
+              int ndims)
+{
+    int retval;
+    int nvals,i;
+
+    API_BEGIN2("DBWriteSlice", int, -1, vname)
+    {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBWriteSlice", E_GRABBED) ; 
+        if (!vname || !*vname)
+            API_ERROR("variable name", E_BADARGS);
+        if (db_VariableNameValid(vname) == 0)
+            API_ERROR("variable name", E_INVALIDNAME);
+        if (!values)
+            API_ERROR("values", E_BADARGS);
+        if (!offset)
+            API_ERROR("offset", E_BADARGS);
+        if (!length)
+            API_ERROR("length", E_BADARGS);
+        if (!stride)
+            API_ERROR("stride", E_BADARGS);
+        if (!dims)
+            API_ERROR("dims", E_BADARGS);
+        if (ndims <= 0 || ndims > 3)
+            API_ERROR("ndims", E_BADARGS);
+        for(nvals=1,i=0;i<ndims;i++)
+        {
+            nvals *= length[i];
+        }
+        if (nvals == 0)
+            API_ERROR("Zero-length write attempted", E_BADARGS);
+        if (!dbfile->pub.writeslice)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        retval = (dbfile->pub.writeslice) (dbfile, vname, values,
+                                           dtype, offset, length, stride,
+                                           dims, ndims);
+        db_FreeToc(dbfile);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP;     /* BEWARE: If API_RETURN above is removed use API_END */
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBGetCompoundarray
+ *
+ * Purpose:     Read a compound array object from the file.
+ *
+ * Return:      Success:        pointer to fresh compound array obj.
+ *
+ *              Failure:        NULL
+ *
+ * Programmer:  matzke@viper
+ *              Mon Nov  7 10:50:29 PST 1994
+ *
+ * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *-------------------------------------------------------------------------*/
+PUBLIC DBcompoundarray *
+DBGetCompoundarray(DBfile *dbfile, char const *name)
+{
+    DBcompoundarray *retval = NULL;
+
+    API_BEGIN2("DBGetCompoundarray", DBcompoundarray *, NULL, name) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBGetCompoundarray", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("array name", E_BADARGS);
+        if (NULL == dbfile->pub.g_ca)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_ca) (dbfile, name);
+        db_alloc_end(DB_ARRAY, retval);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBGetCurve
+ *
+ * Purpose:     Read a curve object from the file.
+ *
+ * Return:      Success:        pointer to fresh curve obj
+ *
+ *              Failure:        NULL
+ *
+ * Programmer:  Robb Matzke
+ *              robb@callisto.nuance.com
+ *              May 16, 1996
+ *
+ * Modifications:
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *-------------------------------------------------------------------------*/
+PUBLIC DBcurve *
+DBGetCurve (DBfile *dbfile, char const *name)
+{
+    DBcurve *retval = NULL;
+
+    API_BEGIN2("DBGetCurve", DBcurve *, NULL, name)
+    {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBGetCurve", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("curve name", E_BADARGS);
+        if (NULL == dbfile->pub.g_cu)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_cu) (dbfile, name);
+        db_alloc_end(DB_CURVE, retval);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP;  /* BEWARE: If API_RETURN above is removed use API_END */
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBGetDefvars
+ *
+ * Purpose:     Read a defvars object from the file.
+ *
+ * Return:      Success:        pointer to fresh defvars obj
+ *
+ *              Failure:        NULL
+ *
+ * Programmer:  Mark C. Miller 
+ *              August 8, 2005 
+ *
+ *-------------------------------------------------------------------------*/
+PUBLIC DBdefvars *
+DBGetDefvars (DBfile *dbfile, const char *name)
+{
+    DBdefvars *retval = NULL;
+
+    API_BEGIN2("DBGetDefvars", DBdefvars *, NULL, name)
+    {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBGetDefvars", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("defvars name", E_BADARGS);
+        if (NULL == dbfile->pub.g_defv)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_defv) (dbfile, name);
+        db_alloc_end(DB_DEFVARS, retval);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP;  /* BEWARE: If API_RETURN above is removed use API_END */
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBGetMaterial
  *
- *      Relative path names are interpreted relative to the current working
- *      directory of the associated (src or dst) file when DBCp is invoked.
+ * Purpose:     Allocates a DBmaterial data structure, reads material data
+ *              from the database, and returns a pointer to that struct.
  *
- *      In all the different ways this function can be invoked, there are
- *      really just two fundamentally different interpretations of the list(s)
- *      of names. Either each source path is paired also with a destination
- *      path or all source paths go into a single destination path which, just
- *      as for linux cp, must then also be a directory already present in the
- *      destination.
+ * Return:      Success:        pointer to a new DBmaterial structure
  *
- * Return:      Success:        0
- *              Failure:       -1
+ *              Failure:        NULL
  *
- * Programmer:  Mark C. Miller, Wed Apr 18 09:23:55  PDT 2018
+ * Programmer:  matzke@viper
+ *              Tue Nov  8 09:32:17 PST 1994
+ *
+ * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
  *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
  *-------------------------------------------------------------------------*/
-PUBLIC int
-DBCp(char const *opts, DBfile *srcFile, DBfile *dstFile, ...)
+PUBLIC DBmaterial *
+DBGetMaterial(DBfile *dbfile, const char *name)
 {
-#ifndef _WIN32
-#warning WHAT ABOUT API MACROS. MAYBE NOT NEEDED SINCE NOT CALLING DOWN INTO DRIVERS
-#warning WHAT ABOUT -f (force) OPTION
-#endif
-    char const *me = "DBCp";
-    int i, j, pass, all_ok;
-    int recurse_on_dirs = 0;
-    int preserve_links = 0;
-    int deref_links = 0;
-    int never_deref_links = 0;
-    int dont_copy_just_symlink = 0;
-    int dont_copy_just_hardlink = 0;
-    int src_dst_pairs = 0;
-    int srcs_only = 0;
-    int n_src_dst_triple = 0;
-    int n_src_dir_triple = 0;
-    int recursive_call = 0;
-    char const *many_to_one_dir = 0;
-    int N = 0;
-    char const **srcPathNames = 0, **dstPathNames = 0;
-    char srcStartCwg[1024], dstStartCwg[1024];
+    DBmaterial *retval = NULL;
 
-#ifndef _WIN32
-#warning WARN ABOUT CERTAIN OPTIONS NOT YET SUPPORTED
-#endif
-    /* process any options in the opts string */
-    for (i = 0; opts && opts[i]; i++)
-    {
-        switch (opts[i])
-        {
-            case ' ':
-            case '-': continue;
-            case 'R':
-            case 'r': recurse_on_dirs = 1; break;
-            case 'd': preserve_links = 1; break;
-            case 'L': deref_links = 1; break;
-            case 'P': never_deref_links = 1; break;
-            case 's': dont_copy_just_symlink = 1; break;
-            case 'l': dont_copy_just_hardlink = 1; break;
-            case '2': src_dst_pairs = 1; break;
-            case '1': srcs_only = 1; break;
-            case '3': n_src_dst_triple = 1; break;
-            case '4': n_src_dir_triple = 1; break;
-            case '5': n_src_dir_triple = 1; recursive_call = 1; break;
-            default: return db_perror(&opts[i], E_BADARGS, me);
-        }
+    API_BEGIN2("DBGetMaterial", DBmaterial *, NULL, name) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBGetMaterial", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("material name", E_BADARGS);
+        if (!dbfile->pub.g_ma)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_ma) (dbfile, name);
+        db_alloc_end(DB_MATERIAL, retval);
+        API_RETURN(retval);
     }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
 
-    /* Sanity checks */
-    if (!dstFile)
-        dstFile = srcFile;
+/*-------------------------------------------------------------------------
+ * Function:    DBGetMaterialCSR
+ *
+ * Purpose:     Read a material and return it in compressed sparse row
+ *              (CSR) form.
+ *
+ * Return:      Success:        pointer to a new DBmaterialcsr structure
+ *
+ *              Failure:        NULL
+ *
+ * Description: The material is read with DBGetMaterial and converted with
+ *              DBCalcMaterialCSRFromMaterial so each zone's material ids
+ *              and volume fractions are contiguous and can be accessed
+ *              without chasing mix_next links.
+ *-------------------------------------------------------------------------*/
+PUBLIC DBmaterialcsr *
+DBGetMaterialCSR(DBfile *dbfile, const char *name)
+{
+    DBmaterial *mat = NULL;
+    DBmaterialcsr *retval = NULL;
 
-    if (!srcFile)
-        return db_perror("srcFile cannot be null", E_BADARGS, me);
+    API_BEGIN2("DBGetMaterialCSR", DBmaterialcsr *, NULL, name) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (!name || !*name)
+            API_ERROR("material name", E_BADARGS);
+        if (NULL == (mat = DBGetMaterial(dbfile, name)))
+            API_ERROR("DBGetMaterial", E_CALLFAIL);
+        retval = DBCalcMaterialCSRFromMaterial(mat);
+        DBFreeMaterial(mat);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
 
-    if ((dont_copy_just_symlink || dont_copy_just_hardlink) && srcFile != dstFile)
-        return db_perror("srcFile and dstFile must be same for -s or -l", E_BADARGS, me);
+/*----------------------------------------------------------------------
+ *  Routine                                             DBGetMatspecies
+ *
+ *  Purpose
+ *
+ *      Read a matspecies-data structure from the given database.
+ *
+ *  Programmer
+ *
+ *      Jeffery W. Long, NSSD-B
+ *
+ *  Parameters
+ *
+ *      DBGetMatspecies {Out}    {Pointer to matspecies structure}
+ *      dbfile           {In}    {Pointer to current file}
+ *      name             {In}    {Name of matspecies-data to read}
+ *
+ *  Notes
+ *
+ *  Modifications
+ *    Al Leibee, Tue Jul 26 08:44:01 PDT 1994
+ *    Replaced composition by species.
+ *
+ *    Robb Matzke, Tue Nov 29 13:21:27 PST 1994
+ *    Modified for device independence.  Added error mechanism.
+ *
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *--------------------------------------------------------------------*/
+PUBLIC DBmatspecies *
+DBGetMatspecies(DBfile *dbfile, const char *name)
+{
+    DBmatspecies *retval = NULL;
 
+    API_BEGIN2("DBGetMatspecies", DBmatspecies *, NULL, name) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBGetMatspecies", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("material species name", E_BADARGS);
+        if (!dbfile->pub.g_ms)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-    if (n_src_dst_triple || n_src_dir_triple) // -3 or -4
-    {
-        va_list ap;
-        va_start(ap, dstFile);
-        N = va_arg(ap, int);
-        srcPathNames = va_arg(ap, char const **);
-        if (n_src_dst_triple)
-            dstPathNames = va_arg(ap, char const **);
-        else
-            many_to_one_dir = va_arg(ap, char const *);
-        va_end(ap);
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_ms) (dbfile, name);
+        db_alloc_end(DB_MATSPECIES, retval);
+        API_RETURN(retval);
     }
-    else
-    {
-        /* Process varargs in two passes. Pass 1, count them. Pass 2
-           allocate space and capture them. */
-        int pass;
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
 
-        for (pass = 0; pass < 2; pass++)
-        {
-            int n = 0;
-            char const *arg;
-            va_list ap;
-            va_start(ap, dstFile);
-            if (pass == 1)
-            {
-                srcPathNames = (char const **) malloc(N * sizeof(char const *));
-                if (src_dst_pairs)
-                    dstPathNames = (char const **) malloc(N * sizeof(char const *));
-            }
-            while ((arg = va_arg(ap, char const *)) != DB_EOA)
-            {
-                if (pass == 1)
-                {
-                    if (src_dst_pairs)
-                    {
-                        if (n%2) dstPathNames[n/2] = arg;
-                        else     srcPathNames[n/2] = arg;
-                    }
-                    else
-                    {
-                        srcPathNames[n] = arg;
-                    }
-                }
-                n++;
-            }
-            va_end(ap);
-            N = src_dst_pairs?n/2:n;
-        }
-    }
+/*-------------------------------------------------------------------------
+ * Function:    DBGetMultimesh
+ *
+ * Purpose:     Allocates a DBmultimesh data structure, reads a multi-block
+ *              mesh from the database, and returns a pointer to the
+ *              new structure.
+ *
+ * Return:      Success:        pointer to the new DBmultimesh
+ *
+ *              Failure:        NULL
+ *
+ * Programmer:  matzke@viper
+ *              Tue Nov  8 09:35:38 PST 1994
+ *
+ * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *-------------------------------------------------------------------------*/
+PUBLIC DBmultimesh *
+DBGetMultimesh(DBfile *dbfile, const char *name)
+{
+    DBmultimesh * retval = NULL;
 
-#ifndef _WIN32
-#warning FIX LEAKS WITH EARLY RETURN HERE
-#endif
+    API_BEGIN2("DBGetMultimesh", DBmultimesh *, NULL, name) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBGetMultimesh", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("multimesh name", E_BADARGS);
+        if (!dbfile->pub.g_mm)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_mm) (dbfile, name);
+        db_alloc_end(DB_MULTIMESH, retval);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
 
-    if (n_src_dir_triple && N == 0)
-        return 0;
-    if (!n_src_dir_triple && N < 2)
-        return db_perror("src or dst unspecified", E_BADARGS, me);
-    if (src_dst_pairs && N%2)
-        return db_perror("non-even arg count for -2 option", E_BADARGS, me);
+/*-------------------------------------------------------------------------
+ * Function:    db_NonEmptyBlocks
+ *
+ * Purpose:     List the blocks of a multi-block object that are neither
+ *              in its empty list nor named "EMPTY".
+ *
+ * Return:      Success:        Number of blocks. Their indices, in
+ *                              increasing order, are returned in *BLOCKS,
+ *                              which the caller must free().
+ *
+ *              Failure:        -1
+ *-------------------------------------------------------------------------*/
+static int
+db_NonEmptyBlocks(int nblocks, char const * const *names,
+    int const *empty_list, int empty_cnt, int **blocks)
+{
+    char *empty = (char *) calloc(nblocks > 0 ? nblocks : 1, 1);
+    int i, n = 0;
 
-    /* target dir is at end of list of sources */
-    if (!many_to_one_dir && !src_dst_pairs && !n_src_dst_triple && !n_src_dir_triple)
+    *blocks = (int *) malloc((nblocks > 0 ? nblocks : 1) * sizeof(int));
+    if (!empty || !*blocks)
     {
-        many_to_one_dir = srcPathNames[N-1];
-        N--;
+        FREE(empty);
+        FREE(*blocks);
+        return -1;
     }
 
-    if (many_to_one_dir)
+    for (i = 0; i < empty_cnt && empty_list; i++)
+        if (0 <= empty_list[i] && empty_list[i] < nblocks)
+            empty[empty_list[i]] = 1;
+    for (i = 0; i < nblocks; i++)
     {
-        int q;
-        dstPathNames = (char const **) malloc(N * sizeof(char const *));
-        for (q = 0; q < N; q++)
-            dstPathNames[q] = many_to_one_dir; /* all point to same char* */
+        if (empty[i] || (names && names[i] && !strcmp(names[i], "EMPTY")))
+            continue;
+        (*blocks)[n++] = i;
     }
+    free(empty);
+    return n;
+}
 
-    DBGetDir(srcFile, srcStartCwg);
-    DBGetDir(dstFile, dstStartCwg);
+/*-------------------------------------------------------------------------
+ * Function:    DBQueryMultimeshBlocks
+ *
+ * Purpose:     Find the blocks of a multi-block mesh whose extents meet a
+ *              point, box, ray or line segment. This uses the bounding
+ *              volume hierarchy stored with the multimesh when it was
+ *              written with DBOPT_EXTENTS. For older files, the hierarchy
+ *              is built from the multimesh extents as needed. When the
+ *              multimesh has no extents, all non-empty blocks are
+ *              returned.
+ *
+ * Return:      Success:        Number of blocks. Their zero-origin
+ *                              indices, in increasing order, are returned
+ *                              in *BLOCKS, which the caller must free().
+ *
+ *              Failure:        -1
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBQueryMultimeshBlocks(DBfile *dbfile, char const *name, int querytype,
+    double const *query, int **blocks)
+{
+    int retval = -1;
 
-    for (i = 0; i < N; i++)
-    {
-        DBObjectType srcType, dstType;
-        char *srcObjAbsName, *dstObjAbsName;
-        char savcwg[1024], srccwg[1024], dstcwg[1024];
-        char opts2[16] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
-        char **dirItems, **otherItems;
-        int  dirItemCount, otherItemCount;
+    API_BEGIN2("DBQueryMultimeshBlocks", int, -1, name) {
+        double *bvh = NULL;
+        int len = 0;
 
-        if (i == 0)
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBQueryMultimeshBlocks", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("multimesh name", E_BADARGS);
+        if (querytype != DB_QUERY_POINT && querytype != DB_QUERY_BOX &&
+            querytype != DB_QUERY_RAY && querytype != DB_QUERY_SEGMENT)
+            API_ERROR("querytype", E_BADARGS);
+        if (!query)
+            API_ERROR("query", E_BADARGS);
+        if (!blocks)
+            API_ERROR("blocks", E_BADARGS);
+        *blocks = NULL;
+
+        /* Read just the stored hierarchy, if there is one */
+        if (dbfile->pub.g_comp)
         {
-            DBGetDir(srcFile, srccwg);
-            DBGetDir(dstFile, dstcwg);
+            DBShowErrors(DB_SUSPEND, NULL);
+            PROTECT {
+                bvh = (double *) (dbfile->pub.g_comp) (dbfile, name, "bvh");
+            } CLEANUP {
+                CANCEL_UNWIND;
+            } END_PROTECT;
+            DBShowErrors(DB_RESUME, NULL);
+            if (bvh && bvh[0] == DB_BVH_VERSION)
+                len = DB_BVH_HDRLEN + (int) bvh[2] * DB_BVH_RECLEN((int) bvh[1]);
         }
 
-        srcObjAbsName = db_join_path(srccwg, srcPathNames[i]);
-        srcType = DBInqVarType(srcFile, srcObjAbsName);
-
-        dstObjAbsName = db_join_path(dstcwg, dstPathNames[i]?dstPathNames[i]:srcPathNames[i]);
-        dstType = DBInqVarType(dstFile, dstObjAbsName);
-
-        if (srcType == DB_INVALID_OBJECT)
+        /* Otherwise, build it from the multimesh */
+        if (len == 0)
         {
-            db_perror(DBSPrintf("\"%s\" invalid object", srcObjAbsName), E_BADARGS, me);
-            goto endLoop;
-        }
+            DBmultimesh *mm = DBGetMultimesh(dbfile, name);
 
-        if (srcType != DB_DIR)
-        {
-            if (!db_copy_single_object_abspath(opts, 
-                    srcFile, srcObjAbsName, srcType,
-                    dstFile, dstObjAbsName, dstType))
+            FREE(bvh);
+            if (!mm)
+                API_ERROR(name, E_CALLFAIL);
+            if (mm->extents && mm->extentssize > 0)
             {
-                db_perror("Object copy failed", E_CALLFAIL, me);
-                goto endLoop;
+                bvh = db_MakeBlockBVH(mm->nblocks, mm->extentssize, mm->extents,
+                          (char const * const *) mm->meshnames, mm->empty_list,
+                          mm->empty_cnt, &len);
+                if (!bvh)
+                    retval = 0;
             }
-            continue;
-        }
-
-        /* If we get this far into the loop body here, then src is a dir */
-        if (!recurse_on_dirs)
-        {
-            db_perror(DBSPrintf("Cannot copy dir \"%s\" without -r flag",
-                srcObjAbsName), E_BADARGS, me);
-            goto endLoop;
-        }
-
-        if (dstType != DB_INVALID_OBJECT && dstType != DB_DIR)
-        {
-            db_perror(DBSPrintf("Cannot copy dir \"%s\" onto pre-existing non-dir \"%s\"",
-                srcObjAbsName, dstObjAbsName), E_BADARGS, me);
-            goto endLoop;
+            else
+            {
+                /* Without extents, any non-empty block may meet the query */
+                retval = db_NonEmptyBlocks(mm->nblocks,
+                             (char const * const *) mm->meshnames,
+                             mm->empty_list, mm->empty_cnt, blocks);
+            }
+            DBFreeMultimesh(mm);
+            if (retval < 0 && !bvh)
+                API_ERROR(name, E_NOMEM);
         }
 
-#if 0
-        /* get the contents of this dir in two lists; all the dirs, everything else */
-        DBLs(srcFile, DBSPrintf("-d %s", srcObjAbsName), 0, &dirItemCount); /* just count it first */
-        dirItems = ALLOC_N(char*, ++dirItemCount);
-        DBLs(srcFile, DBSPrintf("-d %s", srcObjAbsName), dirItems, &dirItemCount);
-
-        DBLs(srcFile, DBSPrintf("-a -d %s", srcObjAbsName), 0, &otherItemCount); /* just count it first */
-        otherItems = ALLOC_N(char*, ++otherItemCount);
-        DBLs(srcFile, DBSPrintf("-a -d %s", srcObjAbsName), otherItems, &otherItemCount);
-#endif
-        /* get the contents of this dir */
-        DBSetDir(srcFile, srcObjAbsName);
-        DBLs(srcFile, "-a -x", 0, &dirItemCount); /* just count it first */
-        dirItems = ALLOC_N(char*, dirItemCount);
-        DBLs(srcFile, "-a -x", dirItems, &dirItemCount);
-
-        if (dstType == DB_INVALID_OBJECT)
-        {
-            DBMkDir(dstFile, dstObjAbsName);
-            DBSetDir(dstFile, dstObjAbsName);
-        }
-        else if (dstType == DB_DIR)
+        if (bvh)
         {
-            char *srcDirBaseName = db_basename(srcObjAbsName);
-            DBMkDir(dstFile, srcDirBaseName);
-            DBSetDir(dstFile, srcDirBaseName);
-            free(srcDirBaseName);
+            retval = db_QueryBlockBVH(bvh, len, querytype, query, blocks);
+            FREE(bvh);
+            if (retval < 0)
+                API_ERROR(name, E_INTERNAL);
         }
 
-        if (n_src_dir_triple)
-            DBCp(opts, srcFile, dstFile, dirItemCount, dirItems, ".");
-        else
-            DBCp(DBSPrintf("%s -4", opts), srcFile, dstFile, dirItemCount, dirItems, ".");
-
-        DBSetDir(srcFile, "..");
-        DBSetDir(dstFile, "..");
-
-endLoop:
-        FREE(srcObjAbsName);
-        FREE(dstObjAbsName);
+        API_RETURN(retval);
     }
-
-    DBSetDir(srcFile, srcStartCwg);
-    DBSetDir(dstFile, dstStartCwg);
-
-    return 0;
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-#if 1
-PUBLIC int
-DBCpListedObjects(int nobjs,
-    DBfile *dbfile, char const * const *srcObjs,
-    DBfile *dstFile, char const * const *dstObjs)
+/*-------------------------------------------------------------------------
+ * Function:    DBGetMultimeshadj
+ *
+ * Purpose:     Allocates a DBmultimeshdj data structure, reads a
+ *              multi-block mesh adjacency object from the database, and
+ *              returns a pointer to the new structure.
+ *
+ * Return:      Success:        pointer to the new DBmultimeshadj
+ *
+ *              Failure:        NULL
+ *
+ * Programmer:  Mark C. Miller 
+ *              August 24, 2005 
+ *
+ *-------------------------------------------------------------------------*/
+PUBLIC DBmultimeshadj *
+DBGetMultimeshadj(DBfile *dbfile, const char *name, int nmesh,
+   const int *block_map)
 {
-    int retval;
+    DBmultimeshadj * retval = NULL;
 
-    API_BEGIN2("DBCpListedObjects", int, -1, api_dummy) {
+    API_BEGIN2("DBGetMultimeshadj", DBmultimeshadj *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
-        if (!dstFile)
-            API_ERROR(NULL, E_NOFILE);
-        if (db_isregistered_file(dstFile,0)==-1)
-            API_ERROR(NULL, E_NOTREG);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR(NULL, E_GRABBED); 
-        if (nobjs > 0)
-        {
-            if (!srcObjs)
-                API_ERROR("source object names list", E_BADARGS);
-            if (dstObjs)
-            {
-                int i;
-                for (i = 0; i < nobjs; i++)
-                {
-                    if (dstObjs[i] == 0 || dstObjs[i][0] == '\0')
-                        continue;
-                    if (db_VariableNameValid(dstObjs[i]) == 0)
-                        API_ERROR(dstObjs[i], E_INVALIDNAME);
-                }
-            }
-        }
-        if (!dbfile->pub.cpnobjs)
+            API_ERROR("DBGetMultimeshadj", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("multimesh name", E_BADARGS);
+        if (!dbfile->pub.g_mmadj)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
-        retval = (dbfile->pub.cpnobjs) (nobjs, dbfile, srcObjs, dstFile, dstObjs);
-        db_FreeToc(dbfile);
+
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_mmadj) (dbfile, name, nmesh,
+                                        block_map);
+        db_alloc_end(DB_MULTIMESHADJ, retval);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
-#else
-#warning REMOVE ABOVE IF STATEMENT
-PUBLIC int
-DBCpListedObjects(int nobjs,
-    DBfile *dbfile, char const * const *srcObjs,
-    DBfile *dstFile, char const * const *dstObjs)
-{
-}
-#endif
+
+
+
+
 
 /*-------------------------------------------------------------------------
- * Function:    DBChangeObject
+ * Function:    DBGetMultivar
  *
- * Purpose:     Overwrites an object with a new object.  This is usually
- *              the same function as called by DBWriteObject but with
- *              OVER_WRITE as the flag.  However, we keep it as a separate
- *              callback so existing drivers that don't support overwriting
- *              don't need to be changed and so that the silo API doesn't
- *              change by changing the meaning of the `freemem' argument
- *              to DBWriteObject.
+ * Purpose:     Allocates a DBmultivar data structure, reads a multi-block
+ *              variable from the database, and returns a pointer to the
+ *              new structure.
  *
- * Return:      Success:        0
+ * Return:      Success:        pointer to the new DBmultivar
  *
- *              Failure:        -1
+ *              Failure:        NULL
  *
- * Programmer:  Robb Matzke
- *              robb@maya.nuance.mdn.com
- *              Mar  7 1997
+ * Programmer:  matzke@cloud
+ *              Tue Feb 21 11:27:46 EST 1995
  *
  * Modifications:
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Completely reformatted the code so a human can read it.  Made the error
- *    messages a little better.
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
  *
- *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
- *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
-PUBLIC int
-DBChangeObject (DBfile *dbfile, DBobject const *obj)
+PUBLIC DBmultivar *
+DBGetMultivar(DBfile *dbfile, const char *name)
 {
-    int             retval;
+    DBmultivar * retval = NULL;
 
-    API_BEGIN2("DBChangeObject", int, -1, api_dummy)
-    {
+    API_BEGIN2("DBGetMultivar", DBmultivar *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBChangeObject", E_GRABBED) ; 
-        if (!obj)
-            API_ERROR("object pointer", E_BADARGS);
-        if (!dbfile->pub.c_obj)
+            API_ERROR("DBGetMultivar", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("multivar name", E_BADARGS);
+        if (!dbfile->pub.g_mv)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
-        retval = (dbfile->pub.c_obj) (dbfile, obj, OVER_WRITE);
+
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_mv) (dbfile, name);
+        db_alloc_end(DB_MULTIVAR, retval);
         API_RETURN(retval);
     }
-    API_END_NOPOP;                     /* BEWARE: If API_RETURN is removed 
-                                        * use API_END */
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBWriteObject
+ * Function:    DBQueryMultivarBlocks
  *
- * Purpose:     Write an object into the data file.
+ * Purpose:     Find the blocks of a multi-block variable whose value range
+ *              overlaps the closed interval [LO,HI]. This uses the range
+ *              index stored with the multivar when it was written with
+ *              extents. For older files, the index is built from the
+ *              multivar extents as needed. When the multivar has no
+ *              extents, all non-empty blocks are returned.
  *
- * Return:      Success:        0
+ * Return:      Success:        Number of blocks. Their zero-origin
+ *                              indices, in increasing order, are returned
+ *                              in *BLOCKS, which the caller must free().
  *
  *              Failure:        -1
- *
- * Programmer:  matzke@viper
- *              Mon Nov  7 10:45:14 PST 1994
- *
- * Modifications:
- *    Robb Matzke, Mon Nov 21 21:37:54 EST 1994
- *    Added error mechanism.
- *
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
- *
- *    Robb Matzke, 7 Mar 1997
- *    The freemem value passed to the driver is either FREE_MEM or zero
- *    so that drivers that overload this function with DBChangeObject
- *    are guaranteed to be able to tell the difference.
- *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
- *
- *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
- *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBWriteObject(DBfile *dbfile, DBobject const *obj, int freemem)
+DBQueryMultivarBlocks(DBfile *dbfile, char const *name, double lo, double hi,
+    int **blocks)
 {
-    int retval;
+    int retval = -1;
+
+    API_BEGIN2("DBQueryMultivarBlocks", int, -1, name) {
+        double *bvh = NULL;
+        double q[2];
+        int len = 0;
 
-    API_BEGIN2("DBWriteObject", int, -1, api_dummy)
-    {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBWriteObject", E_GRABBED) ; 
-        if (!obj)
-            API_ERROR("object pointer", E_BADARGS);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, obj->name))
-            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (!dbfile->pub.w_obj)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+            API_ERROR("DBQueryMultivarBlocks", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("multivar name", E_BADARGS);
+        if (!(lo <= hi))
+            API_ERROR("lo > hi", E_BADARGS);
+        if (!blocks)
+            API_ERROR("blocks", E_BADARGS);
+        *blocks = NULL;
+        q[0] = lo;
+        q[1] = hi;
+
+        /* Read just the stored index, if there is one */
+        if (dbfile->pub.g_comp)
+        {
+            DBShowErrors(DB_SUSPEND, NULL);
+            PROTECT {
+                bvh = (double *) (dbfile->pub.g_comp) (dbfile, name, "bvh");
+            } CLEANUP {
+                CANCEL_UNWIND;
+            } END_PROTECT;
+            DBShowErrors(DB_RESUME, NULL);
+            if (bvh && bvh[0] == DB_BVH_VERSION && bvh[1] == 1)
+                len = DB_BVH_HDRLEN + (int) bvh[2] * DB_BVH_RECLEN(1);
+        }
+
+        /* Otherwise, build it from the multivar */
+        if (len == 0)
+        {
+            DBmultivar *mv = DBGetMultivar(dbfile, name);
+
+            FREE(bvh);
+            if (!mv)
+                API_ERROR(name, E_CALLFAIL);
+            if (mv->extents && mv->extentssize > 0)
+            {
+                bvh = db_MakeBlockRangeBVH(mv->nvars, mv->extentssize, mv->extents,
+                          (char const * const *) mv->varnames, mv->empty_list,
+                          mv->empty_cnt, &len);
+                if (!bvh)
+                    retval = 0;
+            }
+            else
+            {
+                /* Without extents, any non-empty block may overlap */
+                retval = db_NonEmptyBlocks(mv->nvars,
+                             (char const * const *) mv->varnames,
+                             mv->empty_list, mv->empty_cnt, blocks);
+            }
+            DBFreeMultivar(mv);
+            if (retval < 0 && !bvh)
+                API_ERROR(name, E_NOMEM);
+        }
+
+        if (bvh)
+        {
+            retval = db_QueryBlockBVH(bvh, len, DB_QUERY_BOX, q, blocks);
+            FREE(bvh);
+            if (retval < 0)
+                API_ERROR(name, E_INTERNAL);
+        }
 
-        retval = (dbfile->pub.w_obj) (dbfile, obj, freemem?FREE_MEM:0);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-PUBLIC void *
-DBGetPartialObject(DBfile *dbfile, char const *name, int nvals, int ndims,
-    int index_mode, void const *indices, DBoptlist *options)
+/* Value I of a DB_FLOAT or DB_DOUBLE coordinate array */
+static double
+db_coord_value(void const *arr, int datatype, size_t i)
 {
-#ifndef _WIN32
-#warning FIX THIS METHOD
-#endif
+    return datatype == DB_DOUBLE ? ((double const *) arr)[i] : ((float const *) arr)[i];
+}
+
+/* Name of the array holding component COMP of OBJ, or NULL if there is none */
+static char *
+db_ComponentArrayName(DBobject const *obj, char const *comp)
+{
+    int i;
 
+    for (i = 0; obj && i < obj->ncomponents; i++)
+    {
+        char const *p = obj->pdb_names[i];
+        size_t n;
+        char *retval;
 
+        if (strcmp(obj->comp_names[i], comp))
+            continue;
+        if (!strncmp(p, "'<s>", 4))
+            p += 4;
+        else if (p[0] == '\'')
+            return NULL; /* a literal value, not an array */
+        n = strlen(p);
+        if (n > 0 && p[n-1] == '\'')
+            n--;
+        if (n == 0 || (retval = (char *) malloc(n + 1)) == NULL)
+            return NULL;
+        memcpy(retval, p, n);
+        retval[n] = '\0';
+        return retval;
+    }
+    return NULL;
+}
 
-    /* call directly down into driver */
+/* Read elements [START,START+LEN) of the 1D array NAME into BUF */
+static int
+db_ReadArrayRun(DBfile *dbfile, char const *name, int start, int len, void *buf)
+{
+    int stride = 1;
+    return DBReadVarSlice(dbfile, name, &start, &len, &stride, 1, buf);
+}
 
-    /* get type */
-    DBObjectType otype = DBInqVarType(dbfile, name);
+/*----------------------------------------------------------------------
+ * Routine                                         db_GetPointmeshRegion
+ *
+ * Purpose: Read the points of a point mesh that lie in BOX. See
+ *     DBGetPointmeshRegion. If SEL is not NULL, *SEL receives the sorted
+ *     storage indices of the returned points.
+ *
+ * Return: A DBpointmesh or NULL on failure.
+ *
+ * Description: For a mesh written with DBOPT_SPATIAL_SORT, the chunk
+ *     index is queried for the chunks whose bounding boxes meet BOX and
+ *     only those runs of the coordinate arrays are read, with
+ *     DBReadVarSlice. Consecutive chunks are read together. Any other
+ *     point mesh is read whole and filtered.
+ *--------------------------------------------------------------------*/
+static DBpointmesh *
+db_GetPointmeshRegion(DBfile *dbfile, char const *name, double const *box,
+    int **sel, int *nsel)
+{
+    DBpointmesh *pm = NULL, *full = NULL;
+    DBobject *obj = NULL;
+    double *idx = NULL;
+    char *cname[3] = {NULL, NULL, NULL}, *iname = NULL;
+    int *chunks = NULL, *runs = NULL, *keep = NULL;
+    void *out[3] = {NULL, NULL, NULL}, *ids = NULL;
+    int i, d, j, k, n, nchunks = 0, nruns = 0, cs = 0, total = 0;
+    int ndims, nels, dtype = -1, idtype = DB_INT;
+    size_t size, idsize = sizeof(int);
+    unsigned long long mask;
+
+    if (sel)
+    {
+        *sel = NULL;
+        *nsel = 0;
+    }
 
-    /* set mask and read object header */
+    /* Header only */
+    mask = DBSetDataReadMask2File(dbfile, DBNone);
+    pm = DBGetPointmesh(dbfile, name);
+    DBSetDataReadMask2File(dbfile, mask);
+    if (!pm)
+        return NULL;
+    ndims = pm->ndims;
+    nels = pm->nels;
 
-    /* get list of datasets */
+    /* The chunk index and the arrays to slice */
+    if (nels > 0 && dbfile->pub.g_comp)
+    {
+        DBShowErrors(DB_SUSPEND, NULL);
+        PROTECT {
+            idx = (double *) (dbfile->pub.g_comp) (dbfile, name, "chunkidx");
+            if (idx && idx[0] == DB_PMIDX_VERSION && idx[1] == ndims && idx[2] == nels)
+            {
+                obj = DBGetObject(dbfile, name);
+                for (d = 0; d < ndims; d++)
+                {
+                    char cn[16];
+                    sprintf(cn, "coord%d", d);
+                    cname[d] = db_ComponentArrayName(obj, cn);
+                }
+                if ((iname = db_ComponentArrayName(obj, "gnodeno")) != NULL)
+                    idtype = pm->gnznodtype == DB_LONG_LONG ? DB_LONG_LONG : DB_INT;
+                else
+                    iname = db_ComponentArrayName(obj, "perm");
+                if (cname[0])
+                    dtype = DBGetVarType(dbfile, cname[0]);
+            }
+        } CLEANUP {
+            CANCEL_UNWIND;
+        } END_PROTECT;
+        DBShowErrors(DB_RESUME, NULL);
+    }
 
-    /* If dense, do partial I/O on the datasets */
-    /* Else... do object specific partial I/O */
-    /* Handle mixed values on variables */
+    if (dtype == DB_FLOAT || dtype == DB_DOUBLE)
+    {
+        double const *bvh = idx + DB_PMIDX_HDRLEN;
+        int len = DB_BVH_HDRLEN + (int) bvh[2] * DB_BVH_RECLEN((int) bvh[1]);
 
-    return 0;
-}
+        for (d = 0; d < ndims; d++)
+            if (!cname[d]) dtype = -1;
+        cs = (int) idx[3];
+        nchunks = db_QueryBlockBVH(bvh, len, DB_QUERY_BOX, box, &chunks);
+        if (nchunks < 0 || cs <= 0 || !iname)
+            dtype = -1;
+    }
 
-PUBLIC DBmaterial *
-DBGetPartialMaterial(DBfile *dbfile, char const *name, int mode, int nvals,
-    int ndims, void const *indices, DBoptlist *options)
-{
-    return (DBmaterial *) DBGetPartialObject(dbfile, name, mode, nvals, ndims, indices, options);
+    if (dtype == DB_FLOAT || dtype == DB_DOUBLE)
+    {
+        /* Merge consecutive chunks into runs of points */
+        runs = (int *) malloc((nchunks > 0 ? nchunks : 1) * 2 * sizeof(int));
+        for (i = 0; runs && i < nchunks; i++)
+        {
+            int start = chunks[i] * cs;
+            int end = (int) MIN((long long) nels, ((long long) chunks[i] + 1) * cs);
+            if (nruns > 0 && runs[2*nruns-2] + runs[2*nruns-1] == start)
+                runs[2*nruns-1] += end - start;
+            else
+            {
+                runs[2*nruns] = start;
+                runs[2*nruns+1] = end - start;
+                nruns++;
+            }
+            total += end - start;
+        }
+    }
+    else
+    {
+        /* No usable index, so read it all */
+        full = DBGetPointmesh(dbfile, name);
+        if (!full)
+            goto fail;
+        dtype = full->datatype;
+        if (full->gnodeno)
+            idtype = full->gnznodtype == DB_LONG_LONG ? DB_LONG_LONG : DB_INT;
+        runs = (int *) malloc(2 * sizeof(int));
+        if (runs && nels > 0)
+        {
+            runs[0] = 0;
+            runs[1] = total = nels;
+            nruns = 1;
+        }
+    }
+    if (!runs)
+        goto fail;
+
+    size = dtype == DB_DOUBLE ? sizeof(double) : sizeof(float);
+    idsize = idtype == DB_LONG_LONG ? sizeof(long long) : sizeof(int);
+    for (d = 0; d < ndims; d++)
+        if ((out[d] = malloc((size_t) total * size + 1)) == NULL)
+            goto fail;
+    ids = malloc((size_t) total * idsize + 1);
+    keep = (int *) malloc((size_t) total * sizeof(int) + 1);
+    if (!ids || !keep)
+        goto fail;
+
+    /* Read each run in place, then compact the points in the box */
+    for (i = k = n = 0; i < nruns; i++)
+    {
+        int start = runs[2*i], len = runs[2*i+1];
+
+        for (d = 0; d < ndims; d++)
+        {
+            char *dst = (char *) out[d] + (size_t) k * size;
+            if (full)
+                memcpy(dst, (char *) full->coords[d] + (size_t) start * size, (size_t) len * size);
+            else if (db_ReadArrayRun(dbfile, cname[d], start, len, dst) < 0)
+                goto fail;
+        }
+        if (full && full->gnodeno)
+            memcpy((char *) ids + (size_t) k * idsize,
+                (char *) full->gnodeno + (size_t) start * idsize, (size_t) len * idsize);
+        else if (!full && db_ReadArrayRun(dbfile, iname, start, len,
+                              (char *) ids + (size_t) k * idsize) < 0)
+            goto fail;
+        else if (full)
+            for (j = 0; j < len; j++)
+                ((int *) ids)[k+j] = start + j;
+
+        for (j = 0; j < len; j++, k++)
+        {
+            for (d = 0; d < ndims; d++)
+            {
+                double c = db_coord_value(out[d], dtype, k);
+                if (!(box[d] <= c && c <= box[ndims+d]))
+                    break;
+            }
+            if (d < ndims)
+                continue;
+            for (d = 0; d < ndims; d++)
+                memmove((char *) out[d] + (size_t) n * size,
+                        (char *) out[d] + (size_t) k * size, size);
+            memmove((char *) ids + (size_t) n * idsize,
+                    (char *) ids + (size_t) k * idsize, idsize);
+            keep[n++] = start + j;
+        }
+    }
+
+    /* Fill in the returned mesh */
+    for (d = 0; d < ndims; d++)
+    {
+        double lo = HUGE_VAL, hi = -HUGE_VAL;
+        for (j = 0; j < n; j++)
+        {
+            double c = db_coord_value(out[d], dtype, j);
+            if (c < lo) lo = c;
+            if (c > hi) hi = c;
+        }
+        if (n == 0)
+            lo = hi = 0;
+        if (dtype == DB_DOUBLE)
+        {
+            ((double *) pm->min_extents)[d] = lo;
+            ((double *) pm->max_extents)[d] = hi;
+        }
+        else
+        {
+            pm->min_extents[d] = (float) lo;
+            pm->max_extents[d] = (float) hi;
+        }
+        pm->coords[d] = out[d];
+        out[d] = NULL;
+    }
+    FREE(pm->gnodeno);
+    pm->gnodeno = ids;
+    pm->gnznodtype = idtype == DB_LONG_LONG ? DB_LONG_LONG : DB_INT;
+    pm->datatype = dtype;
+    pm->nels = n;
+    ids = NULL;
+    if (sel)
+    {
+        *sel = keep;
+        *nsel = n;
+        keep = NULL;
+    }
+    if (full) DBFreePointmesh(full);
+    if (obj) DBFreeObject(obj);
+    for (d = 0; d < 3; d++)
+        FREE(cname[d]);
+    FREE(iname);
+    FREE(idx);
+    FREE(chunks);
+    FREE(runs);
+    FREE(keep);
+    return pm;
+
+fail:
+    if (full) DBFreePointmesh(full);
+    if (obj) DBFreeObject(obj);
+    DBFreePointmesh(pm);
+    for (d = 0; d < 3; d++)
+    {
+        FREE(cname[d]);
+        FREE(out[d]);
+    }
+    FREE(iname);
+    FREE(idx);
+    FREE(chunks);
+    FREE(runs);
+    FREE(ids);
+    FREE(keep);
+    return NULL;
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetObject
+ * Function:    DBGetPointmeshRegion
  *
- * Purpose:     Reads an object from a file.
+ * Purpose:     Read only the points of a point mesh that lie in a box.
  *
- * Return:      Success:        Ptr to the new object.
+ * Return:      Success:        pointer to a new DBpointmesh structure
  *
  *              Failure:        NULL
  *
- * Programmer:  Robb Matzke
- *              matzke@viper.llnl.gov
- *              Dec  2 1996
- *
- * Modifications:
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
- *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
- *
- *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
- *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ * Description: BOX is lo[ndims] followed by hi[ndims]. The gnodeno member
+ *              of the result holds the global node numbers of the points.
+ *              When the mesh was written without DBOPT_NODENUM, these are
+ *              the indices of the points as originally given to
+ *              DBPutPointmesh.
  *-------------------------------------------------------------------------*/
-PUBLIC DBobject *
-DBGetObject (DBfile *dbfile, char const *objname)
+PUBLIC DBpointmesh *
+DBGetPointmeshRegion(DBfile *dbfile, char const *name, double const *box)
 {
-    DBobject       *retval = NULL;
+    DBpointmesh *retval = NULL;
 
-    API_BEGIN2("DBGetObject", DBobject *, NULL, api_dummy)
-    {
+    API_BEGIN2("DBGetPointmeshRegion", DBpointmesh *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetObject", E_GRABBED) ; 
-        if (!objname)
-            API_ERROR("object name", E_BADARGS);
-        if (!dbfile->pub.g_obj)
+            API_ERROR("DBGetPointmeshRegion", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("pointmesh name", E_BADARGS);
+        if (!box)
+            API_ERROR("box", E_BADARGS);
+        if (!dbfile->pub.g_pm)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
-        retval = (dbfile->pub.g_obj) (dbfile, (char const *)objname);
-        db_AdjustSpeciallyHandledStandardObjectComponentValues(retval);
+
+        retval = db_GetPointmeshRegion(dbfile, name, box, NULL, NULL);
+        if (!retval)
+            API_ERROR(name, E_CALLFAIL);
         API_RETURN(retval);
     }
-    API_END_NOPOP;                     /* BEWARE:  If API_RETURN above is
-                                        * removed use API_END */
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBWriteComponent
- *
- * Purpose:     Add a variable component to the given object structure, AND
- *              write out the associated data.
- *
- * Return:      Success:        0
- *
- *              Failure:        -1
- *
- * Programmer:  matzke@viper
- *              Mon Nov  7 10:47:29 PST 1994
- *
- * Modifications:
- *    Robb Matzke, Mon Nov 21 21:39:06 EST 1994
- *    Added error mechanism.
- *
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
+ * Function:    DBGetPointvarRegion
  *
- *    Sean Ahern, Tue Mar 31 17:16:24 PST 1998
- *    I added a check for zero-length data arrays.
- *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
+ * Purpose:     Read only the values of a point variable on the points of
+ *              its mesh that lie in a box.
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
+ * Return:      Success:        pointer to a new DBmeshvar structure
  *
- *    Robb Matzke, 2000-05-23
- *    The old table of contents is discarded if the directory changes.
+ *              Failure:        NULL
  *
- *    Mark C. Miller, Wed Jul 23 00:15:15 PDT 2008
- *    Changed to API_BEGIN2 to help detect attempted ops on closed files.
+ * Description: The values are one-to-one with the points returned by
+ *              DBGetPointmeshRegion for the same box. They are read in
+ *              runs spanning the selected points.
  *-------------------------------------------------------------------------*/
-PUBLIC int
-DBWriteComponent(DBfile *dbfile, DBobject *obj, char const *comp_name,
-                 char const *prefix, char const *datatype, void const *var, int nd,
-                 long const *count)
+PUBLIC DBmeshvar *
+DBGetPointvarRegion(DBfile *dbfile, char const *name, double const *box)
 {
-    int retval;
-    int nvals, i;
+    DBmeshvar *retval = NULL;
+
+    API_BEGIN2("DBGetPointvarRegion", DBmeshvar *, NULL, name) {
+        DBpointmesh *pm = NULL;
+        DBobject *obj = NULL;
+        int *sel = NULL, nsel = 0, i, j, v, dtype;
+        unsigned long long mask;
+        size_t size;
+        char *buf = NULL;
 
-    API_BEGIN2("DBWriteComponent", int, -1, api_dummy) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBWriteComponent", E_GRABBED) ;
-        if (!obj)
-            API_ERROR("object pointer", E_BADARGS);
-        if (DBGetAllowEmptyObjectsFile(dbfile))
-        {
-            if (nd<=0) API_RETURN(0);
-            if (!count) API_RETURN(0);
-            if (!var) API_RETURN(0);
-            for(nvals=1,i=0;i<nd;i++)
-                nvals *= count[i];
-            if (nvals<=0) API_RETURN(0);
-        }
-        if (!comp_name || !*comp_name)
-            API_ERROR("component name", E_BADARGS);
-        if (db_VariableNameValid((char *)comp_name) == 0)
-            API_ERROR("component name", E_INVALIDNAME);
-#if 0
-        /* We don't know what name to pass to DBInqVarExists here because it
-           is the driver that knows how to construct component names */
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, obj->name))
-            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-#endif
-        if (!prefix || !*prefix)
-            API_ERROR("prefix", E_BADARGS);
-        if (db_VariableNameValid((char *)prefix) == 0)
-            API_ERROR("prefix", E_INVALIDNAME);
-        if (!datatype || !*datatype)
-            API_ERROR("data type", E_BADARGS);
-        if (!var)
-            API_ERROR("var pointer", E_BADARGS);
-        if (nd <= 0)
-            API_ERROR("nd", E_BADARGS);
-        if (!count && nd)
-            API_ERROR("count", E_BADARGS);
-        for(nvals=1,i=0;i<nd;i++)
+            API_ERROR("DBGetPointvarRegion", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("pointvar name", E_BADARGS);
+        if (!box)
+            API_ERROR("box", E_BADARGS);
+        if (!dbfile->pub.g_pv)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        mask = DBSetDataReadMask2File(dbfile, DBNone);
+        retval = DBGetPointvar(dbfile, name);
+        DBSetDataReadMask2File(dbfile, mask);
+        if (!retval)
+            API_ERROR(name, E_CALLFAIL);
+        if (!retval->meshname ||
+            !(pm = db_GetPointmeshRegion(dbfile, retval->meshname, box, &sel, &nsel)))
         {
-            nvals *= count[i];
-        }
-        if (nvals == 0) {
-            API_ERROR("Zero-length write attempted", E_BADARGS);
+            DBFreeMeshvar(retval);
+            API_ERROR(name, E_CALLFAIL);
         }
-        if (!dbfile->pub.w_comp)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+        DBFreePointmesh(pm);
 
-        /* Note that the work to add the variable component to the object is
-           handled down in the drivers due to the fact that the drivers may
-           use different rules to construct the object component names */
+        obj = DBGetObject(dbfile, name);
+        FREE(retval->vals);
+        retval->vals = (void **) calloc(retval->nvals > 0 ? retval->nvals : 1, sizeof(void*));
+        dtype = retval->datatype;
+        for (v = 0; obj && retval->vals && v < retval->nvals; v++)
+        {
+            char cn[32], *vn;
 
-        retval = (dbfile->pub.w_comp) (dbfile, obj, comp_name, prefix,
-                                       datatype, var, nd, count);
-        db_FreeToc(dbfile);
+            /* The drivers name the value arrays differently */
+            sprintf(cn, "data%d", v);
+            if ((vn = db_ComponentArrayName(obj, cn)) == NULL)
+            {
+                if (retval->nvals == 1) strcpy(cn, "_data");
+                else sprintf(cn, "%d_data", v);
+                vn = db_ComponentArrayName(obj, cn);
+            }
+            if (!vn)
+                break;
+            if (v == 0)
+                dtype = DBGetVarType(dbfile, vn);
+            size = (size_t) db_GetMachDataSize(dtype);
+            retval->vals[v] = malloc((size_t) nsel * size + 1);
+
+            /* Read spans of nearby selected points and gather */
+            for (i = 0; retval->vals[v] && i < nsel; i = j)
+            {
+                int len;
+                for (j = i + 1; j < nsel && sel[j] - sel[j-1] <= DB_PMIDX_CHUNK; j++)
+                    ;
+                len = sel[j-1] - sel[i] + 1;
+                if ((buf = (char *) realloc(buf, (size_t) len * size)) == NULL ||
+                    db_ReadArrayRun(dbfile, vn, sel[i], len, buf) < 0)
+                {
+                    FREE(retval->vals[v]);
+                    break;
+                }
+                for (len = i; len < j; len++)
+                    memcpy((char *) retval->vals[v] + (size_t) len * size,
+                           buf + (size_t) (sel[len] - sel[i]) * size, size);
+            }
+            free(vn);
+            if (!retval->vals[v])
+                break;
+        }
+        FREE(buf);
+        FREE(sel);
+        if (obj) DBFreeObject(obj);
+        if (!retval->vals || v < retval->nvals)
+        {
+            DBFreeMeshvar(retval);
+            API_ERROR(name, E_CALLFAIL);
+        }
+        retval->datatype = dtype;
+        retval->nels = nsel;
+        retval->min_index[0] = 0;
+        retval->max_index[0] = nsel - 1;
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBWrite
+ * Function:    DBGetMultimat
  *
- * Purpose:     Writes a single variable into the database.
+ * Purpose:     Allocates a DBmultimat data structure, reads a multi-
+ *              material from the database, and returns a pointer to the
+ *              new structure.
  *
- * Return:      Success:        0
+ * Return:      Success:        pointer to the new DBmultimat
  *
- *              Failure:        -1
+ *              Failure:        NULL
  *
- * Programmer:  robb@cloud
- *              Wed Nov  9 13:19:49 EST 1994
+ * Programmer:  matzke@cloud
+ *              Tue Feb 21 11:27:46 EST 1995
  *
  * Modifications:
- *    Robb Matzke, Mon Nov 21 21:42:27 EST 1994
- *    Added error mecanism.
- *
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
- *
- *    Sean Ahern, Tue Mar 31 17:17:44 PST 1998
- *    I added a check for zero-length arrays.
- *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
  *
- *    Robb Matzke, 2000-05-23
- *    The old table of contents is discarded if the directory changes.
- *
- *    Mark C. Miller, Mon Jan 11 17:42:51 PST 2010
- *    Allow special variable names in the magic /.silo dir for HDF5 files.
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
-PUBLIC int
-DBWrite(DBfile *dbfile, char const *vname, void const *var, int const *dims,
-    int ndims, int datatype)
+PUBLIC DBmultimat *
+DBGetMultimat(DBfile *dbfile, const char *name)
 {
-    int retval;
-    int nvals, i;
+    DBmultimat * retval = NULL;
 
-    API_BEGIN2("DBWrite", int, -1, vname) {
+    API_BEGIN2("DBGetMultimat", DBmultimat *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBWrite", E_GRABBED) ; 
-        if (!vname || !*vname)
-            API_ERROR("variable name", E_BADARGS);
-        if (strncmp("/.silo/#", vname, 8) != 0 &&
-            db_VariableNameValid(vname) == 0)
-            API_ERROR("variable name", E_INVALIDNAME);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, vname))
-            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (ndims < 0)
-            API_ERROR("ndims", E_BADARGS);
-        if (ndims == 0 && !DBGetAllowEmptyObjectsFile(dbfile))
-            API_ERROR("ndims==0", E_EMPTYOBJECT);
-        if (!dims && ndims)
-            API_ERROR("dims", E_BADARGS);
-        for(nvals=ndims>0?1:0,i=0;i<ndims;i++)
-            nvals *= dims[i];
-        if (nvals == 0 && !DBGetAllowEmptyObjectsFile(dbfile))
-            API_ERROR("Zero length write attempted", E_EMPTYOBJECT);
-        if (db_FullyDeprecatedConvention(vname))
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
-        if (!dbfile->pub.write)
+            API_ERROR("DBGetMultimat", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("multimat name", E_BADARGS);
+        if (!dbfile->pub.g_mt)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.write) (dbfile, vname, var, dims,
-                                      ndims, datatype);
-
-        /* diddle with retval if its an empty case */
-        if ((ndims == 0 || nvals == 0) && retval == 1) retval = 0;
-
-        db_FreeToc(dbfile);
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_mt) (dbfile, name);
+        db_alloc_end(DB_MULTIMAT, retval);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBWriteSlice
+ * Function:    DBGetMultimatspecies
  *
- * Purpose:     Similar to DBWrite except only part of the data is
- *              written.  If VNAME doesn't exist, space is reserved for
- *              the entire variable based on DIMS; otherwise we check
- *              that DIMS has the same value as originally.  Then we
- *              write the specified slice to the file.
+ * Purpose:     Allocates a DBmultimatspecies data structure, reads a
+ *              multi-material-species from the database, and returns
+ *              a pointer to the new structure.
  *
- * Return:      Success:        0
+ * Return:      Success:        pointer to the new DBmultimatspecies
  *
- *              Failure:        -1
+ *              Failure:        NULL
  *
- * Programmer:  Robb Matzke
- *              robb@callisto.nuance.com
- *              May  9, 1996
+ * Programmer:  Jeremy S. Meredith  
+ *              Sept 17 1998
  *
  * Modifications:
- *    Sean Ahern, Tue Mar 31 17:19:38 PST 1998
- *    I added a check for zero-length writes.
- *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
  *
- *    Robb Matzke, 2000-05-23
- *    The old table of contents is discarded if the directory changes.
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
-PUBLIC int
-DBWriteSlice (DBfile *dbfile, const char *vname, void const *values, int dtype,
-              int const *offset, int const *length, int const *stride, int const *dims,
-              int ndims)
+PUBLIC DBmultimatspecies *
+DBGetMultimatspecies(DBfile *dbfile, const char *name)
 {
-    int retval;
-    int nvals,i;
+    DBmultimatspecies * retval = NULL;
 
-    API_BEGIN2("DBWriteSlice", int, -1, vname)
-    {
+    API_BEGIN2("DBGetMultimatspecies", DBmultimatspecies *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBWriteSlice", E_GRABBED) ; 
-        if (!vname || !*vname)
-            API_ERROR("variable name", E_BADARGS);
-        if (db_VariableNameValid(vname) == 0)
-            API_ERROR("variable name", E_INVALIDNAME);
-        if (!values)
-            API_ERROR("values", E_BADARGS);
-        if (!offset)
-            API_ERROR("offset", E_BADARGS);
-        if (!length)
-            API_ERROR("length", E_BADARGS);
-        if (!stride)
-            API_ERROR("stride", E_BADARGS);
-        if (!dims)
-            API_ERROR("dims", E_BADARGS);
-        if (ndims <= 0 || ndims > 3)
-            API_ERROR("ndims", E_BADARGS);
-        for(nvals=1,i=0;i<ndims;i++)
-        {
-            nvals *= length[i];
-        }
-        if (nvals == 0)
-            API_ERROR("Zero-length write attempted", E_BADARGS);
-        if (!dbfile->pub.writeslice)
+            API_ERROR("DBGetMultimatspecies", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("multimatspecies name", E_BADARGS);
+        if (!dbfile->pub.g_mms)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.writeslice) (dbfile, vname, values,
-                                           dtype, offset, length, stride,
-                                           dims, ndims);
-        db_FreeToc(dbfile);
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_mms) (dbfile, name);
+        db_alloc_end(DB_MULTIMATSPECIES, retval);
         API_RETURN(retval);
     }
-    API_END_NOPOP;     /* BEWARE: If API_RETURN above is removed use API_END */
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetCompoundarray
+ * Function:    DBGetPointmesh
  *
- * Purpose:     Read a compound array object from the file.
+ * Purpose:     Allocates a DBpointmesh data structure and reads a point
+ *              mesh from the database.
  *
- * Return:      Success:        pointer to fresh compound array obj.
+ * Return:      Success:        pointer to the new DBpointmesh struct.
  *
  *              Failure:        NULL
  *
  * Programmer:  matzke@viper
- *              Mon Nov  7 10:50:29 PST 1994
+ *              Tue Nov  8 09:37:55 PST 1994
  *
  * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
@@ -7045,114 +8878,179 @@ DBWriteSlice (DBfile *dbfile, const char *vname, void const *values, int dtype,
  *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
-PUBLIC DBcompoundarray *
-DBGetCompoundarray(DBfile *dbfile, char const *name)
+PUBLIC DBpointmesh *
+DBGetPointmesh(DBfile *dbfile, const char *name)
 {
-    DBcompoundarray *retval = NULL;
+    DBpointmesh * retval = NULL;
 
-    API_BEGIN2("DBGetCompoundarray", DBcompoundarray *, NULL, name) {
+    API_BEGIN2("DBGetPointmesh", DBpointmesh *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetCompoundarray", E_GRABBED) ; 
+            API_ERROR("DBGetPointmesh", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("array name", E_BADARGS);
-        if (NULL == dbfile->pub.g_ca)
+            API_ERROR("pointmesh name", E_BADARGS);
+        if (!dbfile->pub.g_pm)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_ca) (dbfile, name);
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_pm) (dbfile, name);
+        db_alloc_end(DB_POINTMESH, retval);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetCurve
+ * Function:    DBGetPointvar
  *
- * Purpose:     Read a curve object from the file.
+ * Purpose:     Allocates a DBmeshvar data structure and reads a variable
+ *              associated with a point mesh from the database.
  *
- * Return:      Success:        pointer to fresh curve obj
+ * Return:      Success:        pointer to the new DBmeshvar struct
  *
  *              Failure:        NULL
  *
- * Programmer:  Robb Matzke
- *              robb@callisto.nuance.com
- *              May 16, 1996
+ * Programmer:  matzke@viper
+ *              Tue Nov  8 09:41:21 PST 1994
  *
  * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
-PUBLIC DBcurve *
-DBGetCurve (DBfile *dbfile, char const *name)
+PUBLIC DBmeshvar *
+DBGetPointvar(DBfile *dbfile, const char *name)
 {
-    DBcurve *retval = NULL;
+    DBmeshvar * retval = NULL;
 
-    API_BEGIN2("DBGetCurve", DBcurve *, NULL, name)
-    {
+    API_BEGIN2("DBGetPointvar", DBmeshvar *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetCurve", E_GRABBED) ; 
+            API_ERROR("DBGetPointvar", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("curve name", E_BADARGS);
-        if (NULL == dbfile->pub.g_cu)
+            API_ERROR("pointvar name", E_BADARGS);
+        if (!dbfile->pub.g_pv)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_cu) (dbfile, name);
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_pv) (dbfile, name);
+        db_alloc_end(DB_POINTVAR, retval);
         API_RETURN(retval);
     }
-    API_END_NOPOP;  /* BEWARE: If API_RETURN above is removed use API_END */
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetDefvars
+ * Function:    DBGetQuadmesh
  *
- * Purpose:     Read a defvars object from the file.
+ * Purpose:     Allocates a DBquadmesh data structure and reads
+ *              a quadrilateral mesh from the databas.
  *
- * Return:      Success:        pointer to fresh defvars obj
+ * Return:      Success:        pointer to the new DBquadmesh struct.
+ *
+ *              Failure:        NULL
+ *
+ * Programmer:  matzke@viper
+ *              Tue Nov  8 09:44:26 PST 1994
+ *
+ * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
  *
- *              Failure:        NULL
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
  *
- * Programmer:  Mark C. Miller 
- *              August 8, 2005 
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ * 
+ *    Hank Childs, Fri Feb 25 09:48:40 PST 2000
+ *    Initialized start_index and size_index.
  *
  *-------------------------------------------------------------------------*/
-PUBLIC DBdefvars *
-DBGetDefvars (DBfile *dbfile, const char *name)
+PUBLIC DBquadmesh *
+DBGetQuadmesh(DBfile *dbfile, const char *name)
 {
-    DBdefvars *retval = NULL;
+    DBquadmesh    *qm = NULL;
+    int            i;
 
-    API_BEGIN2("DBGetDefvars", DBdefvars *, NULL, name)
-    {
+    API_BEGIN2("DBGetQuadmesh", DBquadmesh *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetDefvars", E_GRABBED) ; 
+            API_ERROR("DBGetQuadmesh", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("defvars name", E_BADARGS);
-        if (NULL == dbfile->pub.g_defv)
+            API_ERROR("quadmesh name", E_BADARGS);
+        if (!dbfile->pub.g_qm)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
+        db_alloc_begin(dbfile);
+        qm = (dbfile->pub.g_qm) (dbfile, name);
+        db_alloc_end(DB_QUADMESH, qm);
+        if (!qm)
+        {
+            API_RETURN(NULL);
+        }
 
-        retval = (dbfile->pub.g_defv) (dbfile, name);
-        API_RETURN(retval);
+        /*
+         * Put in default axis labels if none supplied.
+         */
+        switch (qm->ndims) {
+            case 3:
+                if (qm->labels[2] == NULL) {
+                    qm->labels[2] = ALLOC_N(char, 7);
+
+                    strcpy(qm->labels[2], "Z Axis");
+                }
+                /* Fall through */
+            case 2:
+                if (qm->labels[1] == NULL) {
+                    qm->labels[1] = ALLOC_N(char, 7);
+
+                    strcpy(qm->labels[1], "Y Axis");
+                }
+                /* Fall through */
+            case 1:
+                if (qm->labels[0] == NULL) {
+                    qm->labels[0] = ALLOC_N(char, 7);
+
+                    strcpy(qm->labels[0], "X Axis");
+                }
+                break;
+        }
+
+        for (i = 0 ; i < 3 ; i++)
+        {
+            qm->start_index[i] = 0;
+            qm->size_index[i]  = qm->dims[i];
+        }
+
+        API_RETURN(qm);
     }
-    API_END_NOPOP;  /* BEWARE: If API_RETURN above is removed use API_END */
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetMaterial
+ * Function:    DBGetQuadvar
  *
- * Purpose:     Allocates a DBmaterial data structure, reads material data
- *              from the database, and returns a pointer to that struct.
+ * Purpose:     Allocates a DBquadvar data structure and reads a variable
+ *              associated with a quadrilateral mesh from the database.
  *
- * Return:      Success:        pointer to a new DBmaterial structure
+ * Return:      Success:        Pointer to the new DBquadvar struct
  *
  *              Failure:        NULL
  *
  * Programmer:  matzke@viper
- *              Tue Nov  8 09:32:17 PST 1994
+ *              Tue Nov  8 09:46:57 PST 1994
  *
  * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
@@ -7160,309 +9058,390 @@ DBGetDefvars (DBfile *dbfile, const char *name)
  *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
-PUBLIC DBmaterial *
-DBGetMaterial(DBfile *dbfile, const char *name)
+PUBLIC DBquadvar *
+DBGetQuadvar(DBfile *dbfile, const char *name)
 {
-    DBmaterial *retval = NULL;
+    DBquadvar * retval = NULL;
 
-    API_BEGIN2("DBGetMaterial", DBmaterial *, NULL, name) {
+    API_BEGIN2("DBGetQuadvar", DBquadvar *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetMaterial", E_GRABBED) ; 
+            API_ERROR("DBGetQuadvar", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("material name", E_BADARGS);
-        if (!dbfile->pub.g_ma)
+            API_ERROR("quadvar name", E_BADARGS);
+        if (!dbfile->pub.g_qv)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_ma) (dbfile, name);
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_qv) (dbfile, name);
+        db_alloc_end(DB_QUADVAR, retval);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-/*----------------------------------------------------------------------
- *  Routine                                             DBGetMatspecies
+/*-------------------------------------------------------------------------
+ * Function:    DBAnnotateUcdmesh
  *
- *  Purpose
+ * Purpose:     Walks a DBucdmesh data structure and adds shapetype
+ *              info based on ndims and shapesize (spatial dimensions
+ *              and node count).
  *
- *      Read a matspecies-data structure from the given database.
+ * Return:      1:        One or more zones/shapes were annotated.
  *
- *  Programmer
+ *              0:        No annotation was performed.
  *
- *      Jeffery W. Long, NSSD-B
+ *              -1:       Annotation could not be performed (an
+ *                        error condition such as exhaustion of
+ *                        dynamic memory occurred).
  *
- *  Parameters
+ * Programmer:  reus@viper
+ *              Tue Oct  8 09:40:36 PDT 1996
  *
- *      DBGetMatspecies {Out}    {Pointer to matspecies structure}
- *      dbfile           {In}    {Pointer to current file}
- *      name             {In}    {Name of matspecies-data to read}
+ * Modifications:
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBAnnotateUcdmesh(DBucdmesh *m)
+{
+   if (m != NULL)
+   {
+      DBzonelist *z;
+
+      if ((z=m->zones) != NULL)
+         if (z->shapetype == NULL)
+         {
+            int N, dims;
+
+            if (m->topo_dim == 0 || m->topo_dim == 1 || m->topo_dim == 2)
+                dims = m->topo_dim;
+            else
+                dims = z->ndims;
+
+            N = z->nshapes;
+            if ((z->shapetype=(int *)malloc(N*sizeof(int))) != NULL)
+            {
+               int *numberOfNodes;
+
+               if ((numberOfNodes=z->shapesize) != NULL)
+               {
+                  int i;
+
+                  switch (dims)
+                  {
+                    case 1: for (i=0; i<N; ++i)
+                               z->shapetype[i] = DB_ZONETYPE_BEAM;
+                            break;
+                    case 2: for (i=0; i<N; ++i)
+                               switch (numberOfNodes[i])
+                               {
+                                 case 3:  z->shapetype[i] = DB_ZONETYPE_TRIANGLE;
+                                          break;
+                                 case 4:  z->shapetype[i] = DB_ZONETYPE_QUAD;
+                                          break;
+                                 default: z->shapetype[i] = DB_ZONETYPE_POLYGON;
+                                          break;
+                               }
+                            break;
+                    case 3: for (i=0; i<N; ++i)
+                               switch (numberOfNodes[i])
+                               {
+                                 case 4:  z->shapetype[i] = DB_ZONETYPE_TET;
+                                          break;
+                                 case 5:  z->shapetype[i] = DB_ZONETYPE_PYRAMID;
+                                          break;
+                                 case 6:  z->shapetype[i] = DB_ZONETYPE_PRISM;
+                                          break;
+                                 case 8:  z->shapetype[i] = DB_ZONETYPE_HEX;
+                                          break;
+                                 default: z->shapetype[i] = DB_ZONETYPE_POLYHEDRON;
+                                          break;
+                               }
+                            break;
+                  }
+                  return 1;
+               }
+               else
+                  return 0;
+            }
+            else
+               return -1;
+         }
+         else
+            return 0;
+      else
+         return 0;
+   }
+   else
+      return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBGetUcdmesh
  *
- *  Notes
+ * Purpose:     Allocates a DBucdmesh data structure and reads a UCD mesh
+ *              from the data file.
  *
- *  Modifications
- *    Al Leibee, Tue Jul 26 08:44:01 PDT 1994
- *    Replaced composition by species.
+ * Return:      Success:        Pointer to the new DBucdmesh struct
  *
- *    Robb Matzke, Tue Nov 29 13:21:27 PST 1994
- *    Modified for device independence.  Added error mechanism.
+ *              Failure:        NULL
  *
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
+ * Programmer:  matzke@viper
+ *              Tue Nov  8 09:57:59 PST 1994
  *
+ * Modifications:
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
  *
  *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
  *    Made the error messages a little better.
- *--------------------------------------------------------------------*/
-PUBLIC DBmatspecies *
-DBGetMatspecies(DBfile *dbfile, const char *name)
+ *-------------------------------------------------------------------------*/
+PUBLIC DBucdmesh *
+DBGetUcdmesh(DBfile *dbfile, const char *name)
 {
-    DBmatspecies *retval = NULL;
+    DBucdmesh     *um = NULL;
 
-    API_BEGIN2("DBGetMatspecies", DBmatspecies *, NULL, name) {
+    API_BEGIN2("DBGetUcdmesh", DBucdmesh *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetMatspecies", E_GRABBED) ; 
+            API_ERROR("DBGetUcdmesh", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("material species name", E_BADARGS);
-        if (!dbfile->pub.g_ms)
+            API_ERROR("UCDmesh name", E_BADARGS);
+        if (!dbfile->pub.g_um)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
+        db_alloc_begin(dbfile);
+        um = ((dbfile->pub.g_um) (dbfile, name));
+        db_alloc_end(DB_UCDMESH, um);
+        if (!um)
+        {
+            API_RETURN(NULL);
+        }
+
+        /*
+         * Put in default axis labels if none supplied.
+         */
+        switch (um->ndims) {
+            case 3:
+                if (um->labels[2] == NULL) {
+                    um->labels[2] = ALLOC_N(char, 7);
+
+                    if (!um->labels[2])
+                        API_ERROR(NULL, E_NOMEM);
+                    strcpy(um->labels[2], "Z Axis");
+                }
+                /*fall through */
+            case 2:
+                if (um->labels[1] == NULL) {
+                    um->labels[1] = ALLOC_N(char, 7);
+
+                    if (!um->labels[1])
+                        API_ERROR(NULL, E_NOMEM);
+                    strcpy(um->labels[1], "Y Axis");
+                }
+                /*fall through */
+            case 1:
+                if (um->labels[0] == NULL) {
+                    um->labels[0] = ALLOC_N(char, 7);
 
-        retval = (dbfile->pub.g_ms) (dbfile, name);
-        API_RETURN(retval);
+                    if (!um->labels[0])
+                        API_ERROR(NULL, E_NOMEM);
+                    strcpy(um->labels[0], "X Axis");
+                }
+        }
+        if (DBAnnotateUcdmesh(um) < 0)
+           API_ERROR(NULL, E_NOMEM);
+
+        API_RETURN(um);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetMultimesh
+ * Function:    DBGetUcdvar
  *
- * Purpose:     Allocates a DBmultimesh data structure, reads a multi-block
- *              mesh from the database, and returns a pointer to the
- *              new structure.
+ * Purpose:     Allocates a DBucdvar structure and reads a variable associated
+ *              with a UCD mesh from the database.
  *
- * Return:      Success:        pointer to the new DBmultimesh
+ * Return:      Success:        Pointer to the new DBucdvar struct
  *
  *              Failure:        NULL
  *
  * Programmer:  matzke@viper
- *              Tue Nov  8 09:35:38 PST 1994
+ *              Tue Nov  8 11:04:35 PST 1994
  *
  * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
- *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
  *
  *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
  *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
-PUBLIC DBmultimesh *
-DBGetMultimesh(DBfile *dbfile, const char *name)
-{
-    DBmultimesh * retval = NULL;
-
-    API_BEGIN2("DBGetMultimesh", DBmultimesh *, NULL, name) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetMultimesh", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("multimesh name", E_BADARGS);
-        if (!dbfile->pub.g_mm)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
-
-        retval = (dbfile->pub.g_mm) (dbfile, name);
-        API_RETURN(retval);
-    }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
-}
-
-/*-------------------------------------------------------------------------
- * Function:    DBGetMultimeshadj
- *
- * Purpose:     Allocates a DBmultimeshdj data structure, reads a
- *              multi-block mesh adjacency object from the database, and
- *              returns a pointer to the new structure.
- *
- * Return:      Success:        pointer to the new DBmultimeshadj
- *
- *              Failure:        NULL
- *
- * Programmer:  Mark C. Miller 
- *              August 24, 2005 
- *
- *-------------------------------------------------------------------------*/
-PUBLIC DBmultimeshadj *
-DBGetMultimeshadj(DBfile *dbfile, const char *name, int nmesh,
-   const int *block_map)
+PUBLIC DBucdvar *
+DBGetUcdvar(DBfile *dbfile, const char *name)
 {
-    DBmultimeshadj * retval = NULL;
+    DBucdvar * retval = NULL;
 
-    API_BEGIN2("DBGetMultimeshadj", DBmultimeshadj *, NULL, name) {
+    API_BEGIN2("DBGetUcdvar", DBucdvar *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetMultimeshadj", E_GRABBED) ; 
+            API_ERROR("DBGetUcdvar", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("multimesh name", E_BADARGS);
-        if (!dbfile->pub.g_mmadj)
+            API_ERROR("UCDvar name", E_BADARGS);
+        if (!dbfile->pub.g_uv)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_mmadj) (dbfile, name, nmesh,
-                                        block_map);
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_uv) (dbfile, name);
+        db_alloc_end(DB_UCDVAR, retval);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-
-
-
-
 /*-------------------------------------------------------------------------
- * Function:    DBGetMultivar
+ * Function:    DBGetFacelist
  *
- * Purpose:     Allocates a DBmultivar data structure, reads a multi-block
- *              variable from the database, and returns a pointer to the
- *              new structure.
+ * Purpose:     Allocate and read a DBfacelist structure.
  *
- * Return:      Success:        pointer to the new DBmultivar
+ * Return:      Success:        ptr to new DBfacelist
  *
  *              Failure:        NULL
  *
- * Programmer:  matzke@cloud
- *              Tue Feb 21 11:27:46 EST 1995
+ * Programmer:  robb@cloud
+ *              Wed Dec 14 13:50:44 EST 1994
  *
  * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
  *
  *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
  *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
-PUBLIC DBmultivar *
-DBGetMultivar(DBfile *dbfile, const char *name)
+PUBLIC DBfacelist *
+DBGetFacelist(DBfile *dbfile, const char *name)
 {
-    DBmultivar * retval = NULL;
+    DBfacelist * retval = NULL;
 
-    API_BEGIN2("DBGetMultivar", DBmultivar *, NULL, name) {
+    API_BEGIN2("DBGetFacelist", DBfacelist *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetMultivar", E_GRABBED) ; 
+            API_ERROR("DBGetFacelist", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("multivar name", E_BADARGS);
-        if (!dbfile->pub.g_mv)
+            API_ERROR("facelist name", E_BADARGS);
+        if (!dbfile->pub.g_fl)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_mv) (dbfile, name);
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_fl) (dbfile, name);
+        db_alloc_end(DB_FACELIST, retval);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetMultimat
+ * Function:    DBGetZonelist
  *
- * Purpose:     Allocates a DBmultimat data structure, reads a multi-
- *              material from the database, and returns a pointer to the
- *              new structure.
+ * Purpose:     Allocate and read a DBzonelist structure.
  *
- * Return:      Success:        pointer to the new DBmultimat
+ * Return:      Success:        ptr to new DBzonelist.
  *
  *              Failure:        NULL
  *
- * Programmer:  matzke@cloud
- *              Tue Feb 21 11:27:46 EST 1995
+ * Programmer:  robb@cloud
+ *              Wed Dec 14 13:59:51 EST 1994
  *
  * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
  *
  *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
  *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
-PUBLIC DBmultimat *
-DBGetMultimat(DBfile *dbfile, const char *name)
+PUBLIC DBzonelist *
+DBGetZonelist(DBfile *dbfile, const char *name)
 {
-    DBmultimat * retval = NULL;
+    DBzonelist * retval = NULL;
 
-    API_BEGIN2("DBGetMultimat", DBmultimat *, NULL, name) {
+    API_BEGIN2("DBGetZonelist", DBzonelist *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetMultimat", E_GRABBED) ; 
+            API_ERROR("DBGetZonelist", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("multimat name", E_BADARGS);
-        if (!dbfile->pub.g_mt)
+            API_ERROR("zonelist name", E_BADARGS);
+        if (!dbfile->pub.g_zl)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_mt) (dbfile, name);
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_zl) (dbfile, name);
+        db_alloc_end(DB_ZONELIST, retval);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetMultimatspecies
+ * Function:    DBGetPHZonelist
  *
- * Purpose:     Allocates a DBmultimatspecies data structure, reads a
- *              multi-material-species from the database, and returns
- *              a pointer to the new structure.
+ * Purpose:     Allocate and read a DBphzonelist structure.
  *
- * Return:      Success:        pointer to the new DBmultimatspecies
+ * Return:      Success:        ptr to new DBphzonelist.
  *
  *              Failure:        NULL
  *
- * Programmer:  Jeremy S. Meredith  
- *              Sept 17 1998
- *
- * Modifications:
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
+ * Programmer:  Mark C. Miller 
+ *              July 28, 2004 
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
-PUBLIC DBmultimatspecies *
-DBGetMultimatspecies(DBfile *dbfile, const char *name)
+PUBLIC DBphzonelist *
+DBGetPHZonelist(DBfile *dbfile, const char *name)
 {
-    DBmultimatspecies * retval = NULL;
+    DBphzonelist * retval = NULL;
 
-    API_BEGIN2("DBGetMultimatspecies", DBmultimatspecies *, NULL, name) {
+    API_BEGIN2("DBGetPHZonelist", DBphzonelist *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetMultimatspecies", E_GRABBED) ; 
+            API_ERROR("DBGetPHZonelist", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("multimatspecies name", E_BADARGS);
-        if (!dbfile->pub.g_mms)
+            API_ERROR("zonelist name", E_BADARGS);
+        if (!dbfile->pub.g_phzl)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_mms) (dbfile, name);
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_phzl) (dbfile, name);
+        db_alloc_end(DB_PHZONELIST, retval);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetPointmesh
+ * Function:    DBGetVar
  *
- * Purpose:     Allocates a DBpointmesh data structure and reads a point
- *              mesh from the database.
+ * Purpose:     Allocate space for a variable and read the variable from the
+ *              database.
  *
- * Return:      Success:        pointer to the new DBpointmesh struct.
+ * Return:      Success:        Pointer to the variable value.
  *
  *              Failure:        NULL
  *
  * Programmer:  matzke@viper
- *              Tue Nov  8 09:37:55 PST 1994
+ *              Tue Nov  8 11:11:29 PST 1994
  *
  * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
@@ -7470,43 +9449,40 @@ DBGetMultimatspecies(DBfile *dbfile, const char *name)
  *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
- *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
-PUBLIC DBpointmesh *
-DBGetPointmesh(DBfile *dbfile, const char *name)
+PUBLIC void   *
+DBGetVar(DBfile *dbfile, const char *name)
 {
-    DBpointmesh * retval = NULL;
+    void   * retval = NULL;
 
-    API_BEGIN2("DBGetPointmesh", DBpointmesh *, NULL, name) {
+    API_BEGIN2("DBGetVar", void *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetPointmesh", E_GRABBED) ; 
+            API_ERROR("DBGetVar", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("pointmesh name", E_BADARGS);
-        if (!dbfile->pub.g_pm)
+            API_ERROR("variable name", E_BADARGS);
+        if (!dbfile->pub.g_var)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_pm) (dbfile, name);
+        retval = (dbfile->pub.g_var) (dbfile, name);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetPointvar
+ * Function:    DBReadVar
  *
- * Purpose:     Allocates a DBmeshvar data structure and reads a variable
- *              associated with a point mesh from the database.
+ * Purpose:     Same as DBGetVar() except the user supplies the result
+ *              memory instead of the function allocating it on the heap.
  *
- * Return:      Success:        pointer to the new DBmeshvar struct
+ * Return:      Success:        0
  *
- *              Failure:        NULL
+ *              Failure:        -1
  *
- * Programmer:  matzke@viper
- *              Tue Nov  8 09:41:21 PST 1994
+ * Programmer:  robb@cloud
+ *              Wed Nov  9 13:00:07 EST 1994
  *
  * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
@@ -7518,383 +9494,363 @@ DBGetPointmesh(DBfile *dbfile, const char *name)
  *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
  *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
-PUBLIC DBmeshvar *
-DBGetPointvar(DBfile *dbfile, const char *name)
+PUBLIC int
+DBReadVar(DBfile *dbfile, const char *name, void *result)
 {
-    DBmeshvar * retval = NULL;
+    int retval;
 
-    API_BEGIN2("DBGetPointvar", DBmeshvar *, NULL, name) {
+    API_BEGIN2("DBReadVar", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetPointvar", E_GRABBED) ; 
+            API_ERROR("DBReadVar", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("pointvar name", E_BADARGS);
-        if (!dbfile->pub.g_pv)
+            API_ERROR("variable name", E_BADARGS);
+        if (!result)
+            API_ERROR("result pointer", E_BADARGS);
+        if (!dbfile->pub.r_var)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_pv) (dbfile, name);
+        retval = (dbfile->pub.r_var) (dbfile, name, result);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetQuadmesh
+ * Function:    DBReadVarSlice
  *
- * Purpose:     Allocates a DBquadmesh data structure and reads
- *              a quadrilateral mesh from the databas.
+ * Purpose:     Same as DBReadVarSlice() except the user can read a only
+ *              a slice of the variable.
  *
- * Return:      Success:        pointer to the new DBquadmesh struct.
+ * Return:      Success:        0
  *
- *              Failure:        NULL
+ *              Failure:        -1
  *
- * Programmer:  matzke@viper
- *              Tue Nov  8 09:44:26 PST 1994
+ * Programmer:  brugger@sgibird
+ *              Thu Feb 16 08:25:47 PST 1995
  *
  * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
- *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
  *
  *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
  *    Made the error messages a little better.
- * 
- *    Hank Childs, Fri Feb 25 09:48:40 PST 2000
- *    Initialized start_index and size_index.
- *
  *-------------------------------------------------------------------------*/
-PUBLIC DBquadmesh *
-DBGetQuadmesh(DBfile *dbfile, const char *name)
+PUBLIC int
+DBReadVarSlice(DBfile *dbfile, const char *name, int const *offset, int const *length,
+               int const *stride, int ndims, void *result)
 {
-    DBquadmesh    *qm = NULL;
-    int            i;
+    int retval;
 
-    API_BEGIN2("DBGetQuadmesh", DBquadmesh *, NULL, name) {
+    API_BEGIN2("DBReadVarSlice", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetQuadmesh", E_GRABBED) ; 
+            API_ERROR("DBReadVarSlice", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("quadmesh name", E_BADARGS);
-        if (!dbfile->pub.g_qm)
+            API_ERROR("variable name", E_BADARGS);
+        if (!offset)
+            API_ERROR("offset", E_BADARGS);
+        if (!length)
+            API_ERROR("length", E_BADARGS);
+        if (!stride)
+            API_ERROR("stride", E_BADARGS);
+        if (ndims <= 0)
+            API_ERROR("ndims", E_BADARGS);
+        if (!result)
+            API_ERROR("result pointer", E_BADARGS);
+        if (!dbfile->pub.r_varslice)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
-        qm = (dbfile->pub.g_qm) (dbfile, name);
-        if (!qm)
-        {
-            API_RETURN(NULL);
-        }
-
-        /*
-         * Put in default axis labels if none supplied.
-         */
-        switch (qm->ndims) {
-            case 3:
-                if (qm->labels[2] == NULL) {
-                    qm->labels[2] = ALLOC_N(char, 7);
-
-                    strcpy(qm->labels[2], "Z Axis");
-                }
-                /* Fall through */
-            case 2:
-                if (qm->labels[1] == NULL) {
-                    qm->labels[1] = ALLOC_N(char, 7);
-
-                    strcpy(qm->labels[1], "Y Axis");
-                }
-                /* Fall through */
-            case 1:
-                if (qm->labels[0] == NULL) {
-                    qm->labels[0] = ALLOC_N(char, 7);
-
-                    strcpy(qm->labels[0], "X Axis");
-                }
-                break;
-        }
-
-        for (i = 0 ; i < 3 ; i++)
-        {
-            qm->start_index[i] = 0;
-            qm->size_index[i]  = qm->dims[i];
-        }
 
-        API_RETURN(qm);
+        retval = (dbfile->pub.r_varslice) (dbfile, name, offset,
+                                           length, stride, ndims, result);
+        API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
-
 /*-------------------------------------------------------------------------
- * Function:    DBGetQuadvar
+ * Function:    DBReadVarVals
  *
- * Purpose:     Allocates a DBquadvar data structure and reads a variable
- *              associated with a quadrilateral mesh from the database.
+ * Purpose:     Like DBReadVarSlice() except the user can read a specifc
+ *              set of values of the variable.
  *
- * Return:      Success:        Pointer to the new DBquadvar struct
+ *              mode can be either DB_PARTIO_POINTS or DB_PARTIO_HSLABS.
  *
- *              Failure:        NULL
+ *              For DB_PARTIO_POINTS case, the indices array is treated as
+ *              NVALS x NDIMS values, each specifying the logical
+ *              coordinates of a single point in the array. A total of
+ *              NVALS values are returned in the same order as their
+ *              associated logical indices are specified.
  *
- * Programmer:  matzke@viper
- *              Tue Nov  8 09:46:57 PST 1994
+ *              For DB_PARTIO_HSLABS case, the indices array is treated as
+ *              NVALS x NDIMS x 3. NVALS is the number of hyper slabs.
+ *              NDIMS is the dimensionality of each hyper slab and 3 is
+ *              for a <start,count,stride> 3-tuple for each dimension
+ *              of a hyperslab. The number of returned values is the sum
+ *              of the sizes of the hyperslabs. If hyperslabs overlap,
+ *              values will be repeated in the results.
  *
- * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
+ * Return:      Success:        0
  *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
+ *              Failure:        -1
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
+ * Programmer : Mark C. Miller, Sat Jun  4 17:40:23 PDT 2016
  *-------------------------------------------------------------------------*/
-PUBLIC DBquadvar *
-DBGetQuadvar(DBfile *dbfile, const char *name)
+PUBLIC int
+DBReadVarVals(DBfile *dbfile, const char *name, int mode, int nvals,
+    int ndims, void const *indices, void **result, int *ncomps, int *nitems)
 {
-    DBquadvar * retval = NULL;
+    int retval;
 
-    API_BEGIN2("DBGetQuadvar", DBquadvar *, NULL, name) {
+    API_BEGIN2("DBReadVarVals", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetQuadvar", E_GRABBED) ; 
+            API_ERROR("DBReadVarVals", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("quadvar name", E_BADARGS);
-        if (!dbfile->pub.g_qv)
+            API_ERROR("variable name", E_BADARGS);
+        if (nvals <= 0)
+            API_ERROR("nvals", E_BADARGS);
+        if (ndims <= 0)
+            API_ERROR("ndims", E_BADARGS);
+        if (!result)
+            API_ERROR("result pointer", E_BADARGS);
+        if (!dbfile->pub.r_varvals)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_qv) (dbfile, name);
+        retval = (dbfile->pub.r_varvals) (dbfile, name, mode,
+            nvals, ndims, indices, result, ncomps, nitems);
+
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBAnnotateUcdmesh
- *
- * Purpose:     Walks a DBucdmesh data structure and adds shapetype
- *              info based on ndims and shapesize (spatial dimensions
- *              and node count).
+ * Function:    DBGetVarByteLength
  *
- * Return:      1:        One or more zones/shapes were annotated.
+ * Purpose:     Returns the in-memory length of the requested variable,
+ *              in bytes.
  *
- *              0:        No annotation was performed.
+ * Return:      Success:        length of variable in bytes.
  *
- *              -1:       Annotation could not be performed (an
- *                        error condition such as exhaustion of
- *                        dynamic memory occurred).
+ *              Failure:        -1
  *
- * Programmer:  reus@viper
- *              Tue Oct  8 09:40:36 PDT 1996
+ * Programmer:  matzke@viper
+ *              Tue Nov  8 11:18:35 PST 1994
  *
  * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
  *-------------------------------------------------------------------------*/
-PUBLIC int
-DBAnnotateUcdmesh(DBucdmesh *m)
+#ifndef _WIN32
+#warning DO WE NEED THIS METHOD
+#endif
+PRIVATE size_t
+db_get_obj_byte_length(DBfile *dbfile, char const *name)
 {
-   if (m != NULL)
-   {
-      DBzonelist *z;
-
-      if ((z=m->zones) != NULL)
-         if (z->shapetype == NULL)
-         {
-            int N, dims;
-
-            if (m->topo_dim == 0 || m->topo_dim == 1 || m->topo_dim == 2)
-                dims = m->topo_dim;
-            else
-                dims = z->ndims;
-
-            N = z->nshapes;
-            if ((z->shapetype=(int *)malloc(N*sizeof(int))) != NULL)
-            {
-               int *numberOfNodes;
-
-               if ((numberOfNodes=z->shapesize) != NULL)
-               {
-                  int i;
+    int q;
+    size_t sum = 0;
+    DBobject *srcObj = DBGetObject(dbfile, name);
+    if (!srcObj) return 0;
 
-                  switch (dims)
-                  {
-                    case 1: for (i=0; i<N; ++i)
-                               z->shapetype[i] = DB_ZONETYPE_BEAM;
-                            break;
-                    case 2: for (i=0; i<N; ++i)
-                               switch (numberOfNodes[i])
-                               {
-                                 case 3:  z->shapetype[i] = DB_ZONETYPE_TRIANGLE;
-                                          break;
-                                 case 4:  z->shapetype[i] = DB_ZONETYPE_QUAD;
-                                          break;
-                                 default: z->shapetype[i] = DB_ZONETYPE_POLYGON;
-                                          break;
-                               }
-                            break;
-                    case 3: for (i=0; i<N; ++i)
-                               switch (numberOfNodes[i])
-                               {
-                                 case 4:  z->shapetype[i] = DB_ZONETYPE_TET;
-                                          break;
-                                 case 5:  z->shapetype[i] = DB_ZONETYPE_PYRAMID;
-                                          break;
-                                 case 6:  z->shapetype[i] = DB_ZONETYPE_PRISM;
-                                          break;
-                                 case 8:  z->shapetype[i] = DB_ZONETYPE_HEX;
-                                          break;
-                                 default: z->shapetype[i] = DB_ZONETYPE_POLYHEDRON;
-                                          break;
-                               }
-                            break;
-                  }
-                  return 1;
-               }
-               else
-                  return 0;
-            }
-            else
-               return -1;
-         }
-         else
-            return 0;
-      else
-         return 0;
-   }
-   else
-      return 0;
+    for (q = 0; q < srcObj->ncomponents; q++)
+    {
+        if (!strncmp(srcObj->pdb_names[q], "'<i>", 4))
+            sum += sizeof(int);
+        else if (!strncmp(srcObj->pdb_names[q], "'<f>", 4))
+            sum += sizeof(float);
+        else if (!strncmp(srcObj->pdb_names[q], "'<d>", 4))
+            sum += sizeof(double);
+        else /* possible sub-object */
+        {
+            int bytlen;
+            char *subObjName, *srcObjDirName, *srcSubObjAbsName;
+             
+            if (!strncmp(srcObj->pdb_names[q], "'<s>", 4))
+                subObjName = db_strndup(srcObj->pdb_names[q]+4, strlen(srcObj->pdb_names[q])-5);
+            else
+                subObjName = db_strndup(srcObj->pdb_names[q], strlen(srcObj->pdb_names[q]));
+
+            srcObjDirName = db_dirname(name);
+            srcSubObjAbsName = db_join_path(srcObjDirName, subObjName);
+
+            bytlen = DBGetVarByteLength(dbfile, srcSubObjAbsName); /* recursion */
+            if (bytlen > 0) sum += bytlen;
+        }
+    }
+    return sum;
+}
+
+PUBLIC int
+DBGetVarByteLength(DBfile *dbfile, const char *name)
+{
+    int retval;
+
+    API_BEGIN2("DBGetVarByteLength", int, -1, name) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBGetVarByteLength", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("variable name", E_BADARGS);
+        if (!dbfile->pub.g_varbl)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        retval = (dbfile->pub.g_varbl) (dbfile, name);
+
+        if (retval < 0)
+            retval = (int) db_get_obj_byte_length(dbfile, name);
+
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetUcdmesh
+ * Function:    DBGetVarByteLengthInFile
  *
- * Purpose:     Allocates a DBucdmesh data structure and reads a UCD mesh
- *              from the data file.
+ * Purpose:     Returns the in-file length of the requested variable,
+ *              in bytes.
  *
- * Return:      Success:        Pointer to the new DBucdmesh struct
+ * Return:      Success:        length of variable in bytes.
  *
- *              Failure:        NULL
+ *              Failure:        -1
  *
  * Programmer:  matzke@viper
- *              Tue Nov  8 09:57:59 PST 1994
+ *              Tue Nov  8 11:18:35 PST 1994
  *
  * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
- *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
-PUBLIC DBucdmesh *
-DBGetUcdmesh(DBfile *dbfile, const char *name)
+PUBLIC int
+DBGetVarByteLengthInFile(DBfile *dbfile, const char *name)
 {
-    DBucdmesh     *um = NULL;
+    int retval;
 
-    API_BEGIN2("DBGetUcdmesh", DBucdmesh *, NULL, name) {
+    API_BEGIN2("DBGetVarByteLengthInFile", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetUcdmesh", E_GRABBED) ; 
+            API_ERROR("DBGetVarByteLengthInFile", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("UCDmesh name", E_BADARGS);
-        if (!dbfile->pub.g_um)
+            API_ERROR("variable name", E_BADARGS);
+        if (!dbfile->pub.g_varblf)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
-        um = ((dbfile->pub.g_um) (dbfile, name));
-        if (!um)
-        {
-            API_RETURN(NULL);
-        }
-
-        /*
-         * Put in default axis labels if none supplied.
-         */
-        switch (um->ndims) {
-            case 3:
-                if (um->labels[2] == NULL) {
-                    um->labels[2] = ALLOC_N(char, 7);
-
-                    if (!um->labels[2])
-                        API_ERROR(NULL, E_NOMEM);
-                    strcpy(um->labels[2], "Z Axis");
-                }
-                /*fall through */
-            case 2:
-                if (um->labels[1] == NULL) {
-                    um->labels[1] = ALLOC_N(char, 7);
-
-                    if (!um->labels[1])
-                        API_ERROR(NULL, E_NOMEM);
-                    strcpy(um->labels[1], "Y Axis");
-                }
-                /*fall through */
-            case 1:
-                if (um->labels[0] == NULL) {
-                    um->labels[0] = ALLOC_N(char, 7);
-
-                    if (!um->labels[0])
-                        API_ERROR(NULL, E_NOMEM);
-                    strcpy(um->labels[0], "X Axis");
-                }
-        }
-        if (DBAnnotateUcdmesh(um) < 0)
-           API_ERROR(NULL, E_NOMEM);
 
-        API_RETURN(um);
+        retval = (dbfile->pub.g_varblf) (dbfile, name);
+        API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetUcdvar
+ * Function:    DBGetVarLength
  *
- * Purpose:     Allocates a DBucdvar structure and reads a variable associated
- *              with a UCD mesh from the database.
+ * Purpose:     Returns the number of elements in the given variable.
  *
- * Return:      Success:        Pointer to the new DBucdvar struct
+ * Return:      Success:        number of elements
  *
- *              Failure:        NULL
+ *              Failure:        -1
  *
  * Programmer:  matzke@viper
- *              Tue Nov  8 11:04:35 PST 1994
+ *              Tue Nov  8 11:23:20 PST 1994
  *
  * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBGetVarLength(DBfile *dbfile, const char *name)
+{
+    int retval;
+
+    API_BEGIN2("DBGetVarLength", int, -1, name) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBGetVarLength", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("variable name", E_BADARGS);
+        if (!dbfile->pub.g_varlen)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        retval = (dbfile->pub.g_varlen) (dbfile, name);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBGetVarDims
+ *
+ * Purpose:     Returns information about the dimensions of a variable.
+ *              The user passes a buffer to hold the dimension sizes
+ *              and indicates the size of that buffer.
+ *
+ * Return:      Success:        The number of dimensions not exceeding
+ *                              MAXDIMS.  The dimension sizes are returned
+ *                              through DIMS.
+ *
+ *              Failure:        -1
  *
+ * Programmer:  Robb Matzke
+ *              robb@maya.nuance.mdn.com
+ *              Mar  6 1997
+ *
+ * Modifications:
  *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
+ *    Reformatted the code so that a human can read it.
  *-------------------------------------------------------------------------*/
-PUBLIC DBucdvar *
-DBGetUcdvar(DBfile *dbfile, const char *name)
+PUBLIC int
+DBGetVarDims(DBfile *dbfile, const char *name, int maxdims, int *dims)
 {
-    DBucdvar * retval = NULL;
+    int             retval = -1;
 
-    API_BEGIN2("DBGetUcdvar", DBucdvar *, NULL, name) {
+    API_BEGIN2("DBGetVarDims", int, -1, name)
+    {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetUcdvar", E_GRABBED) ; 
+            API_ERROR("DBGetVarDims", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("UCDvar name", E_BADARGS);
-        if (!dbfile->pub.g_uv)
+            API_ERROR("variable name", E_BADARGS);
+        if (maxdims <= 0)
+            API_ERROR("max dims", E_BADARGS);
+        if (!dims)
+            API_ERROR("dimension buffer pointer", E_BADARGS);
+        if (!dbfile->pub.g_vardims)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_uv) (dbfile, name);
+        retval = (dbfile->pub.g_vardims) (dbfile, name, maxdims, dims);
         API_RETURN(retval);
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    API_END_NOPOP;                     /* BEWARE: If API_RETURN above is
+                                        * removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetFacelist
+ * Function:    DBGetVarType
  *
- * Purpose:     Allocate and read a DBfacelist structure.
+ * Purpose:     Returns the data type of a variable.
  *
- * Return:      Success:        ptr to new DBfacelist
+ * Return:      Success:        type, such as DB_INT, DB_FLOAT, etc.
  *
- *              Failure:        NULL
+ *              Failure:        -1
  *
- * Programmer:  robb@cloud
- *              Wed Dec 14 13:50:44 EST 1994
+ * Programmer:  matzke@viper
+ *              Thu Dec 22 08:54:20 PST 1994
  *
  * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
@@ -7902,42 +9858,40 @@ DBGetUcdvar(DBfile *dbfile, const char *name)
  *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
- *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
-PUBLIC DBfacelist *
-DBGetFacelist(DBfile *dbfile, const char *name)
+PUBLIC int
+DBGetVarType(DBfile *dbfile, const char *name)
 {
-    DBfacelist * retval = NULL;
+    int retval;
 
-    API_BEGIN2("DBGetFacelist", DBfacelist *, NULL, name) {
+    API_BEGIN2("DBGetVarType", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetFacelist", E_GRABBED) ; 
+            API_ERROR("DBGetVarType", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("facelist name", E_BADARGS);
-        if (!dbfile->pub.g_fl)
+            API_ERROR("variable name", E_BADARGS);
+        if (!dbfile->pub.g_vartype)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_fl) (dbfile, name);
+        retval = (dbfile->pub.g_vartype) (dbfile, name);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetZonelist
+ * Function:    DBInqMeshname
  *
- * Purpose:     Allocate and read a DBzonelist structure.
+ * Purpose:     Returns the name of a mesh associated with a mesh
+ *              variable.
  *
- * Return:      Success:        ptr to new DBzonelist.
+ * Return:      Success:        0, name returned via `mname'
  *
- *              Failure:        NULL
+ *              Failure:        -1
  *
- * Programmer:  robb@cloud
- *              Wed Dec 14 13:59:51 EST 1994
+ * Programmer:  matzke@viper
+ *              Tue Nov  8 11:27:15 PST 1994
  *
  * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
@@ -7949,73 +9903,80 @@ DBGetFacelist(DBfile *dbfile, const char *name)
  *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
  *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
-PUBLIC DBzonelist *
-DBGetZonelist(DBfile *dbfile, const char *name)
+PUBLIC int
+DBInqMeshname(DBfile *dbfile, const char *vname, char *mname)
 {
-    DBzonelist * retval = NULL;
+    int retval;
 
-    API_BEGIN2("DBGetZonelist", DBzonelist *, NULL, name) {
+    API_BEGIN2("DBInqMeshname", int, -1, vname) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetZonelist", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("zonelist name", E_BADARGS);
-        if (!dbfile->pub.g_zl)
+            API_ERROR("DBInqMeshname", E_GRABBED) ; 
+        if (!vname || !*vname)
+            API_ERROR("variable name", E_BADARGS);
+        if (!mname)
+            API_ERROR("mesh name pointer", E_BADARGS);
+        if (!dbfile->pub.i_meshname)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_zl) (dbfile, name);
+        retval = (dbfile->pub.i_meshname) (dbfile, vname, mname);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetPHZonelist
+ * Function:    DBInqMeshtype
  *
- * Purpose:     Allocate and read a DBphzonelist structure.
+ * Purpose:     Returns the mesh type for the specified mesh.
  *
- * Return:      Success:        ptr to new DBphzonelist.
+ * Return:      Success:        mesh type constant
  *
- *              Failure:        NULL
+ *              Failure:        -1
  *
- * Programmer:  Mark C. Miller 
- *              July 28, 2004 
+ * Programmer:  matzke@viper
+ *              Tue Nov  8 11:31:56 PST 1994
+ *
+ * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
  *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
  *-------------------------------------------------------------------------*/
-PUBLIC DBphzonelist *
-DBGetPHZonelist(DBfile *dbfile, const char *name)
+PUBLIC int
+DBInqMeshtype(DBfile *dbfile, const char *name)
 {
-    DBphzonelist * retval = NULL;
+    int retval;
 
-    API_BEGIN2("DBGetPHZonelist", DBphzonelist *, NULL, name) {
+    API_BEGIN2("DBInqMeshtype", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetPHZonelist", E_GRABBED) ; 
+            API_ERROR("DBInqMeshtype", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("zonelist name", E_BADARGS);
-        if (!dbfile->pub.g_phzl)
+            API_ERROR("mesh name", E_BADARGS);
+        if (!dbfile->pub.i_meshtype)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_phzl) (dbfile, name);
+        retval = (dbfile->pub.i_meshtype) (dbfile, name);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetVar
+ * Function:    DBPutCompoundarray
  *
- * Purpose:     Allocate space for a variable and read the variable from the
- *              database.
+ * Purpose:     Write compoundarray information to a file.
  *
- * Return:      Success:        Pointer to the variable value.
+ * Return:      Success:        0
  *
- *              Failure:        NULL
+ *              Failure:        -1
  *
  * Programmer:  matzke@viper
- *              Tue Nov  8 11:11:29 PST 1994
+ *              Mon Nov  7 10:54:46 PST 1994
  *
  * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
@@ -8023,196 +9984,351 @@ DBGetPHZonelist(DBfile *dbfile, const char *name)
  *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *
+ *    Robb Matzke, 2000-05-23
+ *    The old table of contents is discarded if the directory changes.
  *-------------------------------------------------------------------------*/
-PUBLIC void   *
-DBGetVar(DBfile *dbfile, const char *name)
+PUBLIC int
+DBPutCompoundarray(
+    DBfile *dbfile,
+    char const *name,
+    char const * const *elemnames,
+    int const *elemlengths,
+    int nelems,
+    void const *values,
+    int nvalues,
+    int datatype,
+    DBoptlist const *opts
+)
 {
-    void   * retval = NULL;
+    int retval;
 
-    API_BEGIN2("DBGetVar", void *, NULL, name) {
+    API_BEGIN2("DBPutCompoundarray", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetVar", E_GRABBED) ; 
+            API_ERROR("DBPutCompoundarray", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("variable name", E_BADARGS);
-        if (!dbfile->pub.g_var)
+            API_ERROR("array name", E_BADARGS);
+        if (db_VariableNameValid(name) == 0)
+            API_ERROR("array name", E_INVALIDNAME);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
+            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
+        if (nelems < 0)
+            API_ERROR("nelems<0", E_BADARGS);
+        if (nelems)
+        {
+            if (!nelems)
+                API_ERROR("nelems=0", E_BADARGS);
+            if (!elemnames)
+                API_ERROR("elemnames=0", E_BADARGS);
+            if (nvalues <= 0)
+                API_ERROR("nvalues=0", E_BADARGS);
+            if (!values)
+                API_ERROR("values=0", E_BADARGS);
+        }
+        else if (!DBGetAllowEmptyObjectsFile(dbfile))
+        {
+            /* this is an empty object but we don't know if it was intentional */
+            API_ERROR("nelems=0", E_EMPTYOBJECT);
+        }
+        else
+        {
+            nvalues = 0;
+        }
+
+        if (NULL == dbfile->pub.p_ca)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_var) (dbfile, name);
+        retval = (dbfile->pub.p_ca) (dbfile, name, elemnames,
+                                     elemlengths, nelems, values, nvalues,
+                                     datatype, opts);
+        db_FreeToc(dbfile);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBReadVar
+ * Function:    DBPutCurve
  *
- * Purpose:     Same as DBGetVar() except the user supplies the result
- *              memory instead of the function allocating it on the heap.
+ * Purpose:     Writes curve information to a file.
  *
  * Return:      Success:        0
  *
  *              Failure:        -1
  *
- * Programmer:  robb@cloud
- *              Wed Nov  9 13:00:07 EST 1994
+ * Programmer:  Robb Matzke
+ *              robb@callisto.nuance.com
+ *              May 15, 1996
  *
  * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
+ *    Robb Matzke, 16 May 1996
+ *    Don't check for existence of XVALS and YVALS since the OPTS can
+ *    specify a PDB variable name which has already been added to the
+ *    file and which contains the necessary x or y values.  However,
+ *    the driver should check.
  *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
+ *    Robb Matzke, 2000-05-23
+ *    The old table of contents is discarded if the directory changes.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBReadVar(DBfile *dbfile, const char *name, void *result)
+DBPutCurve(
+    DBfile *dbfile,
+    char const *name,
+    void const *xvals,
+    void const *yvals,
+    int datatype,
+    int npts,
+    DBoptlist const *opts
+)
 {
     int retval;
 
-    API_BEGIN2("DBReadVar", int, -1, name) {
+    API_BEGIN2("DBPutCurve", int, -1, name)
+    {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBReadVar", E_GRABBED) ; 
+            API_ERROR("DBPutCurve", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("variable name", E_BADARGS);
-        if (!result)
-            API_ERROR("result pointer", E_BADARGS);
-        if (!dbfile->pub.r_var)
+            API_ERROR("curve name", E_BADARGS);
+        if (db_VariableNameValid(name) == 0)
+            API_ERROR("curve name", E_INVALIDNAME);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
+            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
+        if (npts < 0)
+            API_ERROR("npts<0", E_BADARGS);
+        if (npts)
+        {
+            if (DBGetOption(opts, DBOPT_REFERENCE))
+            {
+                if (yvals || xvals)
+                    API_ERROR("xvals & yvals must be null when using DBOPT_REFERENCE", E_BADARGS);
+            }
+            else
+            {
+                if (!xvals && !DBGetOption(opts, DBOPT_XVARNAME))
+                    API_ERROR("xvals=0 || DBOPT_XVARNAME", E_BADARGS);
+                if (!yvals && !DBGetOption(opts, DBOPT_YVARNAME))
+                    API_ERROR("yvals=0 || DBOPT_YVARNAME", E_BADARGS);
+#ifndef DB_HDF5X
+                if (xvals && DBGetOption(opts, DBOPT_XVARNAME))
+                    API_ERROR("xvals!=0 && DBOPT_XVARNAME", E_BADARGS);
+                if (yvals && DBGetOption(opts, DBOPT_YVARNAME))
+                    API_ERROR("yvals!=0 && DBOPT_YVARNAME", E_BADARGS);
+#else
+                if (DBGetDriverType(dbfile) != DB_HDF5X && xvals && DBGetOption(opts, DBOPT_XVARNAME))
+                    API_ERROR("xvals!=0 && DBOPT_XVARNAME", E_BADARGS);
+                if (DBGetDriverType(dbfile) != DB_HDF5X && yvals && DBGetOption(opts, DBOPT_YVARNAME))
+                    API_ERROR("yvals!=0 && DBOPT_YVARNAME", E_BADARGS);
+#endif
+            }
+        }
+        else if (!DBGetAllowEmptyObjectsFile(dbfile) &&
+                 !DBGetOption(opts, DBOPT_REFERENCE))
+        {
+            /* this is an empty object but we don't know if it was intentional */
+            API_ERROR("npts=0", E_EMPTYOBJECT);
+        }
+
+        if (NULL == dbfile->pub.p_cu)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.r_var) (dbfile, name, result);
+        retval = (dbfile->pub.p_cu) (dbfile, name, (void*)xvals, (void*)yvals,
+                                     datatype, npts, opts);
+
+        db_FreeToc(dbfile);
         API_RETURN(retval);
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    API_END_NOPOP; /* BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBReadVarSlice
+ * Function:    DBPutDefvars
  *
- * Purpose:     Same as DBReadVarSlice() except the user can read a only
- *              a slice of the variable.
+ * Purpose:     Writes a Defvars object to a file.
  *
  * Return:      Success:        0
  *
  *              Failure:        -1
  *
- * Programmer:  brugger@sgibird
- *              Thu Feb 16 08:25:47 PST 1995
- *
- * Modifications:
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
+ * Programmer:  Mark C. Miller 
+ *              August 8, 2005
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBReadVarSlice(DBfile *dbfile, const char *name, int const *offset, int const *length,
-               int const *stride, int ndims, void *result)
+DBPutDefvars(
+    DBfile *dbfile,
+    const char *name,
+    int ndefs,
+    char const * const *names,
+    int const *types,
+    char const * const *defns,
+    DBoptlist const * const *opts
+)
 {
     int retval;
 
-    API_BEGIN2("DBReadVarSlice", int, -1, name) {
+    API_BEGIN2("DBPutDefvars", int, -1, name)
+    {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBReadVarSlice", E_GRABBED) ; 
+            API_ERROR("DBPutDefvars", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("variable name", E_BADARGS);
-        if (!offset)
-            API_ERROR("offset", E_BADARGS);
-        if (!length)
-            API_ERROR("length", E_BADARGS);
-        if (!stride)
-            API_ERROR("stride", E_BADARGS);
-        if (ndims <= 0)
-            API_ERROR("ndims", E_BADARGS);
-        if (!result)
-            API_ERROR("result pointer", E_BADARGS);
-        if (!dbfile->pub.r_varslice)
+            API_ERROR("defvars name", E_BADARGS);
+        if (db_VariableNameValid(name) == 0)
+            API_ERROR("defvars name", E_INVALIDNAME);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
+            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
+        if (ndefs < 0)
+            API_ERROR("ndefs", E_BADARGS);
+        if (ndefs)
+        {
+            if (!names)
+                API_ERROR("names=0", E_BADARGS);
+            if (!types)
+                API_ERROR("types=0", E_BADARGS);
+            if (!defns)
+                API_ERROR("defns=0", E_BADARGS);
+        }
+        else if (!DBGetAllowEmptyObjectsFile(dbfile))
+        {
+            /* this is an empty object but we don't know if it was intentional */
+            API_ERROR("ndefs=0", E_EMPTYOBJECT);
+        }
+
+        if (NULL == dbfile->pub.p_defv)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.r_varslice) (dbfile, name, offset,
-                                           length, stride, ndims, result);
+        retval = (dbfile->pub.p_defv) (dbfile, name, ndefs, names,
+                                       types, defns, opts);
+        db_FreeToc(dbfile);
         API_RETURN(retval);
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    API_END_NOPOP; /* BEWARE: If API_RETURN above is removed use API_END */
 }
+
 /*-------------------------------------------------------------------------
- * Function:    DBReadVarVals
+ * Function:    DBPutFacelist
  *
- * Purpose:     Like DBReadVarSlice() except the user can read a specifc
- *              set of values of the variable.
+ * Purpose:     Writes a facelist object into the open database file.
  *
- *              mode can be either DB_PARTIO_POINTS or DB_PARTIO_HSLABS.
+ * Return:      Success:        0
  *
- *              For DB_PARTIO_POINTS case, the indices array is treated as
- *              NVALS x NDIMS values, each specifying the logical
- *              coordinates of a single point in the array. A total of
- *              NVALS values are returned in the same order as their
- *              associated logical indices are specified.
+ *              Failure:        -1
  *
- *              For DB_PARTIO_HSLABS case, the indices array is treated as
- *              NVALS x NDIMS x 3. NVALS is the number of hyper slabs.
- *              NDIMS is the dimensionality of each hyper slab and 3 is
- *              for a <start,count,stride> 3-tuple for each dimension
- *              of a hyperslab. The number of returned values is the sum
- *              of the sizes of the hyperslabs. If hyperslabs overlap,
- *              values will be repeated in the results.
+ * Programmer:  matzke@viper
+ *              Tue Nov  8 11:52:25 PST 1994
  *
- * Return:      Success:        0
+ * Modifications:
+ *    Robb Matzke, Thu Dec 1 10:34:09 PST 1994
+ *    The `zoneno' parameter is optional even if
+ *    the number of faces is zero.
  *
- *              Failure:        -1
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
  *
- * Programmer : Mark C. Miller, Sat Jun  4 17:40:23 PDT 2016
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *
+ *    Robb Matzke, 2000-05-23
+ *    The old table of contents is discarded if the directory changes.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBReadVarVals(DBfile *dbfile, const char *name, int mode, int nvals,
-    int ndims, void const *indices, void **result, int *ncomps, int *nitems)
+DBPutFacelist(DBfile *dbfile, const char *name, int nfaces, int ndims,
+              int const *nodelist, int lnodelist, int origin, int const *zoneno,
+              int const *shapesize, int const *shapecnt, int nshapes, int const *types,
+              int const *typelist, int ntypes)
 {
     int retval;
 
-    API_BEGIN2("DBReadVarVals", int, -1, name) {
+    API_BEGIN2("DBPutFacelist", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBReadVarVals", E_GRABBED) ; 
+            API_ERROR("DBPutFacelist", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("variable name", E_BADARGS);
-        if (nvals <= 0)
-            API_ERROR("nvals", E_BADARGS);
-        if (ndims <= 0)
-            API_ERROR("ndims", E_BADARGS);
-        if (!result)
-            API_ERROR("result pointer", E_BADARGS);
-        if (!dbfile->pub.r_varvals)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+            API_ERROR("facelist name", E_BADARGS);
+        if (db_VariableNameValid(name) == 0)
+            API_ERROR("facelist name", E_INVALIDNAME);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
+            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
+        if (nfaces < 0)
+            API_ERROR("nfaces<0", E_BADARGS);
+        if (nfaces)
+        {
+            if (nfaces <= 0)
+                API_ERROR("nfaces<=0", E_BADARGS);
+            if (ndims <= 0)
+                API_ERROR("ndims<=0", E_BADARGS);
+            if (lnodelist <= 0)
+                API_ERROR("lnodelist<0", E_BADARGS);
+            if (nshapes <= 0)
+                API_ERROR("nshapes<0", E_BADARGS);
+            if (!nodelist)
+                API_ERROR("nodelist==0", E_BADARGS);
+            if (!shapesize)
+                API_ERROR("shapesize==0", E_BADARGS);
+            if (!shapecnt)
+                API_ERROR("shapecnt==0", E_BADARGS);
+            if (ntypes < 0)
+                API_ERROR("ntypes<0", E_BADARGS);
+            if (origin != 0 && origin != 1)
+                API_ERROR("origin", E_BADARGS);
+        }
+        else if (!DBGetAllowEmptyObjectsFile(dbfile))
+        {
+            /* this is an empty object but we don't know if it was intentional */
+            API_ERROR("nfaces=0", E_EMPTYOBJECT);
+        }
+        else
+        {
+            nfaces = 0;
+            lnodelist = 0;
+            nshapes = 0;
+            ntypes = 0;
+        }
 
-        retval = (dbfile->pub.r_varvals) (dbfile, name, mode,
-            nvals, ndims, indices, result, ncomps, nitems);
+        if (!dbfile->pub.p_fl)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
 
+        retval = (dbfile->pub.p_fl) (dbfile, name, nfaces, ndims,
+                                     nodelist, lnodelist, origin, zoneno,
+                                     shapesize, shapecnt, nshapes, types,
+                                     typelist, ntypes);
+        db_FreeToc(dbfile);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetVarByteLength
+ * Function:    DBPutMaterial
  *
- * Purpose:     Returns the in-memory length of the requested variable,
- *              in bytes.
+ * Purpose:     Writes a material data object into the current open
+ *              database.  The minimum required information for a material
+ *              data object is supplied via the standard arguments to the
+ *              function.  The `optlist' argument must be used for
+ *              supplying any information not requested through the
+ *              standard arguments.
  *
- * Return:      Success:        length of variable in bytes.
+ * Return:      Success:        object ID
  *
  *              Failure:        -1
  *
  * Programmer:  matzke@viper
- *              Tue Nov  8 11:18:35 PST 1994
+ *              Tue Nov  8 12:05:23 PST 1994
  *
  * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
@@ -8220,297 +10336,569 @@ DBReadVarVals(DBfile *dbfile, const char *name, int mode, int nvals,
  *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *
+ *    Robb Matzke, 2000-05-23
+ *    The old table of contents is discarded if the directory changes.
+ *
+ *    Sean Ahern, Thu Jun  8 12:08:05 PDT 2000
+ *    Removed an unnecessary check on mix_zone.
  *-------------------------------------------------------------------------*/
-#ifndef _WIN32
-#warning DO WE NEED THIS METHOD
-#endif
-PRIVATE size_t
-db_get_obj_byte_length(DBfile *dbfile, char const *name)
-{
-    int q;
-    size_t sum = 0;
-    DBobject *srcObj = DBGetObject(dbfile, name);
-    if (!srcObj) return 0;
-
-    for (q = 0; q < srcObj->ncomponents; q++)
-    {
-        if (!strncmp(srcObj->pdb_names[q], "'<i>", 4))
-            sum += sizeof(int);
-        else if (!strncmp(srcObj->pdb_names[q], "'<f>", 4))
-            sum += sizeof(float);
-        else if (!strncmp(srcObj->pdb_names[q], "'<d>", 4))
-            sum += sizeof(double);
-        else /* possible sub-object */
-        {
-            int bytlen;
-            char *subObjName, *srcObjDirName, *srcSubObjAbsName;
-             
-            if (!strncmp(srcObj->pdb_names[q], "'<s>", 4))
-                subObjName = db_strndup(srcObj->pdb_names[q]+4, strlen(srcObj->pdb_names[q])-5);
-            else
-                subObjName = db_strndup(srcObj->pdb_names[q], strlen(srcObj->pdb_names[q]));
-
-            srcObjDirName = db_dirname(name);
-            srcSubObjAbsName = db_join_path(srcObjDirName, subObjName);
-
-            bytlen = DBGetVarByteLength(dbfile, srcSubObjAbsName); /* recursion */
-            if (bytlen > 0) sum += bytlen;
-        }
-    }
-    return sum;
-}
-
 PUBLIC int
-DBGetVarByteLength(DBfile *dbfile, const char *name)
+DBPutMaterial(
+    DBfile *dbfile,
+    char const *name,
+    char const *meshname,
+    int nmat,
+    int const *matnos,
+    int const *matlist,
+    int const *dims,
+    int ndims,
+    int const *mix_next,
+    int const *mix_mat,
+    int const *mix_zone,
+    DBVCP1_t mix_vf,
+    int mixlen,
+    int datatype,
+    DBoptlist const *optlist
+)
 {
-    int retval;
+    int i, retval, is_empty = 1;
+    int const zdims[10] = {0,0,0,0,0,0,0,0,0,0};
+    int const *zoneperm;
+    int *pmatlist = NULL, *pmix_zone = NULL;
 
-    API_BEGIN2("DBGetVarByteLength", int, -1, name) {
+    API_BEGIN2("DBPutMaterial", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetVarByteLength", E_GRABBED) ; 
+            API_ERROR("DBPutMaterial", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("variable name", E_BADARGS);
-        if (!dbfile->pub.g_varbl)
+            API_ERROR("material name", E_BADARGS);
+        if (db_VariableNameValid(name) == 0)
+            API_ERROR("material name", E_INVALIDNAME);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
+            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
+        if (nmat < 0)
+            API_ERROR("nmat<0", E_BADARGS);
+        if (ndims < 0)
+            API_ERROR("ndims<0", E_BADARGS);
+        if (!dims)
+            API_ERROR("dims=0", E_BADARGS);
+        for (i = 0; i < ndims; i++)
+        {
+            if (dims[i] != 0)
+            {
+                is_empty = 0;
+                break;
+            }
+        }
+        if (!is_empty)
+        {
+            for (i = 0; i < ndims && dims!=zdims; i++)
+                if (dims[i] == 0) dims = zdims;
+            if (!matnos) API_ERROR("matnos=0", E_BADARGS);
+            if (!matlist) API_ERROR("matlist=0", E_BADARGS);
+            if (!meshname || !*meshname) API_ERROR("mesh name", E_BADARGS);
+            if (!db_VariableNameValid(meshname)) API_ERROR("meshname", E_INVALIDNAME);
+            if (mixlen < 0)
+                API_ERROR("mixlen<0", E_BADARGS);
+            if (mixlen)
+            {
+                if (!mix_next)
+                    API_ERROR("mix_next=0", E_BADARGS);
+                if (!mix_mat)
+                    API_ERROR("mix_mat=0", E_BADARGS);
+                if (!mix_vf)
+                    API_ERROR("mix_vf=0", E_BADARGS);
+            }
+        }
+        else if (!DBGetAllowEmptyObjectsFile(dbfile))
+        {
+            API_ERROR("nmat=0", E_EMPTYOBJECT);
+        }
+        if (!dbfile->pub.p_ma)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_varbl) (dbfile, name);
+        /* Store the zones in the order given by DBOPT_ZONE_PERM, pointing
+           the mixed entries at the zones' new positions */
+        if (!is_empty && (zoneperm = (int const *) DBGetOption(optlist, DBOPT_ZONE_PERM)))
+        {
+            int n = 1, org = 0, *inv;
+            int *org_p = (int *) DBGetOption(optlist, DBOPT_ORIGIN);
+
+            for (i = 0; i < ndims; i++)
+                n *= dims[i];
+            if (org_p)
+                org = *org_p;
+            if ((inv = db_InvertPerm(zoneperm, n, n)) == NULL)
+                API_ERROR("DBOPT_ZONE_PERM", E_BADARGS);
+            pmatlist = (int *) db_PermuteArray(matlist, n, sizeof(int), zoneperm);
+            if (mixlen > 0 && mix_zone)
+                pmix_zone = (int *) malloc(mixlen * sizeof(int));
+            for (i = 0; pmix_zone && i < mixlen; i++)
+            {
+                int z = mix_zone[i] - org;
+                pmix_zone[i] = z >= 0 && z < n ? inv[z] + org : mix_zone[i];
+            }
+            FREE(inv);
+            if (!pmatlist || (mixlen > 0 && mix_zone && !pmix_zone))
+            {
+                FREE(pmatlist);
+                FREE(pmix_zone);
+                API_ERROR(name, E_NOMEM);
+            }
+            matlist = pmatlist;
+            if (pmix_zone)
+                mix_zone = pmix_zone;
+        }
 
-        if (retval < 0)
-            retval = (int) db_get_obj_byte_length(dbfile, name);
+        retval = (dbfile->pub.p_ma) (dbfile, name, meshname,
+                                     nmat, matnos, matlist, dims, ndims,
+                                     mix_next, mix_mat, mix_zone, mix_vf,
+                                     mixlen, datatype, optlist);
+#ifndef _WIN32
+#warning BETTER PLACE TO NULL THESE
+#endif
+        /* Zero out the _ma._matnames pointer so we can't accidentially use it
+         * again. Likewise for matcolors. */
+        _ma._matnames = NULL;
+        _ma._matcolors = NULL;
+        FREE(pmatlist);
+        FREE(pmix_zone);
 
+        db_FreeToc(dbfile);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetVarByteLengthInFile
+ * Function:    DBPutMaterialCSR
  *
- * Purpose:     Returns the in-file length of the requested variable,
- *              in bytes.
+ * Purpose:     Write a material given in compressed sparse row (CSR) form.
  *
- * Return:      Success:        length of variable in bytes.
+ * Return:      Success:        object ID
  *
  *              Failure:        -1
  *
- * Programmer:  matzke@viper
- *              Tue Nov  8 11:18:35 PST 1994
- *
- * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
- *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
+ * Description: The CSR arrays are converted with
+ *              DBCalcMaterialFromMaterialCSR and written with DBPutMaterial
+ *              so the object in the file has the standard layout and is
+ *              readable by any Silo reader.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBGetVarByteLengthInFile(DBfile *dbfile, const char *name)
+DBPutMaterialCSR(DBfile *dbfile, char const *name, char const *meshname,
+    int nmat, int const *matnos, int const *offsets, int const *matids,
+    void const *vf, int const *dims, int ndims, int datatype,
+    DBoptlist const *optlist)
 {
     int retval;
+    DBmaterial *mat = NULL;
 
-    API_BEGIN2("DBGetVarByteLengthInFile", int, -1, name) {
+    API_BEGIN2("DBPutMaterialCSR", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetVarByteLengthInFile", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("variable name", E_BADARGS);
-        if (!dbfile->pub.g_varblf)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
-
-        retval = (dbfile->pub.g_varblf) (dbfile, name);
+            API_ERROR("material name", E_BADARGS);
+        if (NULL == (mat = DBCalcMaterialFromMaterialCSR(nmat, matnos, ndims,
+                               dims, offsets, matids, datatype, vf)))
+            API_ERROR("DBCalcMaterialFromMaterialCSR", E_CALLFAIL);
+        retval = DBPutMaterial(dbfile, name, meshname, mat->nmat, mat->matnos,
+                     mat->matlist, mat->dims, mat->ndims, mat->mix_next,
+                     mat->mix_mat, mat->mix_zone, mat->mix_vf, mat->mixlen,
+                     mat->datatype, optlist);
+        DBFreeMaterial(mat);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBGetVarLength
+/*----------------------------------------------------------------------
+ *  Routine                                                DBPutMatspecies
  *
- * Purpose:     Returns the number of elements in the given variable.
+ *  Purpose
  *
- * Return:      Success:        number of elements
+ *      Write a material species object into the open file.
  *
- *              Failure:        -1
+ *  Programmer
  *
- * Programmer:  matzke@viper
- *              Tue Nov  8 11:23:20 PST 1994
+ *      Al Leibee, B-DSAD
+ *
+ *  Notes
+ *
+ *      One zonal array ('speclist') is used which contains either:
+ *      1) an index into the 'species_mf' array of the species mass fractions
+ *         of a clean zone's material.
+ *
+ *                                  OR
+ *      2) an index into the 'mix_speclist' array which contains an index
+ *         into the 'species_mf' of the species mass fractions of a mixed
+ *         zone's materials.
+ *
+ *  Modified
+ *    Robb Matzke, Mon Nov 28 15:19:50 EST 1994
+ *    Added device independence stuff.
  *
- * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
  *    I replaced API_END with API_END_NOPOP.
  *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
- *-------------------------------------------------------------------------*/
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *
+ *    Robb Matzke, 2000-05-23
+ *    The old table of contents is discarded if the directory changes.
+ *--------------------------------------------------------------------*/
 PUBLIC int
-DBGetVarLength(DBfile *dbfile, const char *name)
+DBPutMatspecies(DBfile *dbfile, const char *name, const char *matname,
+                int nmat, int const *nmatspec, int const *speclist, int const *dims,
+                int ndims, int nspecies_mf, DBVCP1_t species_mf,
+                int const *mix_speclist, int mixlen, int datatype,
+                DBoptlist const *optlist)
 {
-    int retval;
+    int i, retval, is_empty=1;
+    int const *zoneperm;
+    int *pspeclist = NULL;
 
-    API_BEGIN2("DBGetVarLength", int, -1, name) {
+    API_BEGIN2("DBPutMatspecies", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetVarLength", E_GRABBED) ; 
+            API_ERROR("DBPutMatspecies", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("variable name", E_BADARGS);
-        if (!dbfile->pub.g_varlen)
+            API_ERROR("matspecies name", E_BADARGS);
+        if (db_VariableNameValid(name) == 0)
+            API_ERROR("matspecies name", E_INVALIDNAME);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
+            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
+        if (nmat < 0)
+            API_ERROR("nmat<0", E_BADARGS);
+        if (ndims < 0)
+            API_ERROR("ndims<0", E_BADARGS);
+        if (!dims)
+            API_ERROR("dims=0", E_BADARGS);
+        if (nspecies_mf < 0)
+            API_ERROR("nspecies_mf<0", E_BADARGS);
+        for (i = 0; i < ndims; i++)
+        {
+            if (dims[i] != 0)
+            {
+                is_empty = 0;
+                break;
+            }
+        }
+        if (!is_empty && nspecies_mf > 0)
+        {
+            if (!matname || !*matname)
+                API_ERROR("material name", E_BADARGS);
+            if (db_VariableNameValid(matname) == 0)
+                API_ERROR("material name", E_INVALIDNAME);
+            if (ndims == 1 && dims[0] <= 0) API_ERROR("dims[0]<=0", E_BADARGS);
+            if (ndims == 2 && dims[1] <= 0) API_ERROR("dims[1]<=0", E_BADARGS);
+            if (ndims == 3 && dims[2] <= 0) API_ERROR("dims[2]<=0", E_BADARGS);
+            if (!nmatspec) API_ERROR("nmatspec=0", E_BADARGS);
+            if (!speclist) API_ERROR("speclist=0", E_BADARGS);
+            if (!species_mf) API_ERROR("species_mf=0", E_BADARGS);
+            if (mixlen < 0)
+                API_ERROR("mixlen", E_BADARGS);
+            if (!mix_speclist && mixlen)
+                API_ERROR("mix_speclist", E_BADARGS);
+        }
+        else if (!DBGetAllowEmptyObjectsFile(dbfile))
+        {
+            API_ERROR("dims[i]==0 for all i || nspecies_mf==0", E_EMPTYOBJECT);
+        }
+        if (!dbfile->pub.p_ms)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_varlen) (dbfile, name);
+        /* Store the zones in the order given by DBOPT_ZONE_PERM */
+        if (!is_empty && nspecies_mf > 0 &&
+            (zoneperm = (int const *) DBGetOption(optlist, DBOPT_ZONE_PERM)))
+        {
+            int n = 1, *inv;
+
+            for (i = 0; i < ndims; i++)
+                n *= dims[i];
+            if ((inv = db_InvertPerm(zoneperm, n, n)) == NULL)
+                API_ERROR("DBOPT_ZONE_PERM", E_BADARGS);
+            FREE(inv);
+            if ((pspeclist = (int *) db_PermuteArray(speclist, n, sizeof(int), zoneperm)) == NULL)
+                API_ERROR(name, E_NOMEM);
+            speclist = pspeclist;
+        }
+
+        retval = (dbfile->pub.p_ms) (dbfile, name, matname,
+                                     nmat, nmatspec, speclist, dims, ndims,
+                                     nspecies_mf, species_mf, mix_speclist,
+                                     mixlen, datatype, optlist);
+
+        /* Zero out the _ma._matnames pointer so we can't accidentially use it
+         * again. Likewise for matcolors. */
+        _ms._specnames = NULL;
+        _ms._speccolors = NULL;
+        FREE(pspeclist);
+
+        db_FreeToc(dbfile);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetVarDims
+ * Function:    DBPutMultimesh
  *
- * Purpose:     Returns information about the dimensions of a variable.
- *              The user passes a buffer to hold the dimension sizes
- *              and indicates the size of that buffer.
+ * Purpose:     Writes a multi-bloc kmesh object into the open database.
+ *              It accepts as input descriptions of the various sub-meshes
+ *              (blocks) which are part of this mesh.
  *
- * Return:      Success:        The number of dimensions not exceeding
- *                              MAXDIMS.  The dimension sizes are returned
- *                              through DIMS.
+ * Return:      Success:        object ID
  *
  *              Failure:        -1
  *
- * Programmer:  Robb Matzke
- *              robb@maya.nuance.mdn.com
- *              Mar  6 1997
+ * Programmer:  matzke@viper
+ *              Tue Nov  8 12:17:57 PST 1994
  *
  * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *
  *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Reformatted the code so that a human can read it.
+ *    Made the error messages a little better.
+ *
+ *    Robb Matzke, 2000-05-23
+ *    The old table of contents is discarded if the directory changes.
+ *
+ *    Mark C. Miller, Wed Jul 14 20:36:23 PDT 2010
+ *    Added support for nameschemes on multi-block objects. This meant
+ *    adjusting sanity checks for args as some can be null now.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBGetVarDims(DBfile *dbfile, const char *name, int maxdims, int *dims)
+DBPutMultimesh(DBfile *dbfile, char const *name, int nmesh,
+    char const * const *meshnames, int const *meshtypes,
+    DBoptlist const *optlist)
 {
-    int             retval = -1;
+    int retval;
 
-    API_BEGIN2("DBGetVarDims", int, -1, name)
-    {
+    API_BEGIN2("DBPutMultimesh", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetVarDims", E_GRABBED) ; 
+            API_ERROR("DBPutMultimesh", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("variable name", E_BADARGS);
-        if (maxdims <= 0)
-            API_ERROR("max dims", E_BADARGS);
-        if (!dims)
-            API_ERROR("dimension buffer pointer", E_BADARGS);
-        if (!dbfile->pub.g_vardims)
+            API_ERROR("multimesh name", E_BADARGS);
+        if (db_VariableNameValid(name) == 0)
+            API_ERROR("multimesh name", E_INVALIDNAME);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
+            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
+        if (nmesh < 0)
+            API_ERROR("nmesh", E_BADARGS);
+        if (nmesh)
+        {
+            if (!meshnames && (!optlist || 
+                (!DBGetOption(optlist, DBOPT_MB_FILE_NS) &&
+                 !DBGetOption(optlist, DBOPT_MB_BLOCK_NS))))
+                API_ERROR("mesh names", E_BADARGS);
+            if (!meshtypes && (!optlist ||
+                 !DBGetOption(optlist, DBOPT_MB_BLOCK_TYPE)))
+                API_ERROR("mesh types", E_BADARGS);
+        }
+        else if (!DBGetAllowEmptyObjectsFile(dbfile))
+        {
+            /* this is an empty object but we don't know if it was intentional */
+            API_ERROR("nmesh==0", E_EMPTYOBJECT);
+        }
+        if (!dbfile->pub.p_mm)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_vardims) (dbfile, name, maxdims, dims);
+        retval = (dbfile->pub.p_mm) (dbfile, name, nmesh, meshnames,
+                                     meshtypes, optlist);
+        db_FreeToc(dbfile);
         API_RETURN(retval);
     }
-    API_END_NOPOP;                     /* BEWARE: If API_RETURN above is
-                                        * removed use API_END */
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBGetVarType
+ * Function:    DBPutMultimeshadj
  *
- * Purpose:     Returns the data type of a variable.
+ * Purpose:     Writes a multi-mesh adjacency object into the
+ *              open database.
  *
- * Return:      Success:        type, such as DB_INT, DB_FLOAT, etc.
+ * Return:      Success:        object ID
  *
  *              Failure:        -1
  *
- * Programmer:  matzke@viper
- *              Thu Dec 22 08:54:20 PST 1994
+ * Programmer:  Mark C. Miller, August 23, 2005 
  *
- * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
+ * Notes:       This function is designed to support repeated calls where
+ *              Different parts of the same object are written at different
+ *              times.
  *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBGetVarType(DBfile *dbfile, const char *name)
+DBPutMultimeshadj(DBfile *dbfile, char const *name, int nmesh,
+                  int const *meshtypes, int const *nneighbors,
+                  int const *neighbors, int const *back,
+                  int const *lnodelists, int const * const *nodelists,
+                  int const *lzonelists, int const * const *zonelists,
+                  DBoptlist const *optlist)
 {
     int retval;
 
-    API_BEGIN2("DBGetVarType", int, -1, name) {
+    API_BEGIN2("DBPutMultimeshadj", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetVarType", E_GRABBED) ; 
+            API_ERROR("DBPutMultimeshadj", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("variable name", E_BADARGS);
-        if (!dbfile->pub.g_vartype)
+            API_ERROR("multimeshadj name", E_BADARGS);
+        if (db_VariableNameValid(name) == 0)
+            API_ERROR("multimeshadj name", E_INVALIDNAME);
+        if (nmesh < 0)
+            API_ERROR("nmesh", E_BADARGS);
+        if (!meshtypes && nmesh)
+            API_ERROR("mesh types", E_BADARGS);
+        if (!nneighbors && nmesh)
+            API_ERROR("nneighbors", E_BADARGS);
+        if (!neighbors && nmesh)
+            API_ERROR("neighbors", E_BADARGS);
+        if (lnodelists == NULL && nodelists != NULL)
+            API_ERROR("non-NULL nodelists", E_BADARGS);
+        if (lzonelists == NULL && zonelists != NULL)
+            API_ERROR("non-NULL zonelists", E_BADARGS);
+        if (!dbfile->pub.p_mmadj)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.g_vartype) (dbfile, name);
+        retval = (dbfile->pub.p_mmadj) (dbfile, name, nmesh, meshtypes,
+                                        nneighbors, neighbors, back,
+                                        lnodelists, nodelists, lzonelists, zonelists,
+                                        optlist);
+        db_FreeToc(dbfile);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBInqMeshname
+ * Function:    db_MultivarRangeExtents
  *
- * Purpose:     Returns the name of a mesh associated with a mesh
- *              variable.
- *
- * Return:      Success:        0, name returned via `mname'
- *
- *              Failure:        -1
- *
- * Programmer:  matzke@viper
- *              Tue Nov  8 11:27:15 PST 1994
- *
- * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
+ * Purpose:     Gather the value ranges stored with the blocks of a
+ *              multivar, for use as its DBOPT_EXTENTS. Only blocks in
+ *              this file are consulted and only the object headers are
+ *              read. Ranges are gathered only if every non-empty block is
+ *              a single component quad or ucd variable with a range.
+ *              The extents of empty blocks are NaN.
  *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
+ * Return:      Success:        Array of 2*NVAR doubles to free()
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
+ *              Failure:        NULL
  *-------------------------------------------------------------------------*/
-PUBLIC int
-DBInqMeshname(DBfile *dbfile, const char *vname, char *mname)
+static double *
+db_MultivarRangeExtents(DBfile *dbfile, int nvar, char const * const *varnames,
+    int const *vartypes, DBoptlist const *optlist)
 {
-    int retval;
+    double *extents;
+    char *empty;
+    int *p, i, ok = 1, block_type = 0, empty_cnt = 0;
+    int const *empty_list = NULL;
+    unsigned long long mask;
 
-    API_BEGIN2("DBInqMeshname", int, -1, vname) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBInqMeshname", E_GRABBED) ; 
-        if (!vname || !*vname)
-            API_ERROR("variable name", E_BADARGS);
-        if (!mname)
-            API_ERROR("mesh name pointer", E_BADARGS);
-        if (!dbfile->pub.i_meshname)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+    if (nvar <= 0 || !varnames)
+        return NULL;
+    if (optlist)
+    {
+        if ((p = (int *) DBGetOption(optlist, DBOPT_MB_BLOCK_TYPE)))
+            block_type = *p;
+        if ((p = (int *) DBGetOption(optlist, DBOPT_MB_EMPTY_COUNT)))
+            empty_cnt = *p;
+        empty_list = (int const *) DBGetOption(optlist, DBOPT_MB_EMPTY_LIST);
+    }
 
-        retval = (dbfile->pub.i_meshname) (dbfile, vname, mname);
-        API_RETURN(retval);
+    extents = (double *) malloc((size_t) nvar * 2 * sizeof(double));
+    empty = (char *) calloc(nvar, 1);
+    if (!extents || !empty)
+    {
+        FREE(extents);
+        FREE(empty);
+        return NULL;
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    for (i = 0; i < empty_cnt && empty_list; i++)
+        if (0 <= empty_list[i] && empty_list[i] < nvar)
+            empty[empty_list[i]] = 1;
+
+    mask = DBSetDataReadMask2File(dbfile, DBNone);
+    DBShowErrors(DB_SUSPEND, NULL);
+    for (i = 0; i < nvar && ok; i++)
+    {
+        int type = vartypes ? vartypes[i] : block_type;
+        int has_range = 0, nvals = 0;
+        double lo = 0, hi = 0;
+
+        /* Empty blocks have no range */
+        if (empty[i] || !varnames[i] || !strcmp(varnames[i], "EMPTY"))
+        {
+            extents[2*i] = extents[2*i+1] = NAN;
+            continue;
+        }
+        if (strchr(varnames[i], ':'))
+            ok = 0;
+        else if (type == DB_QUADVAR)
+        {
+            DBquadvar *qv = DBGetQuadvar(dbfile, varnames[i]);
+            if (qv)
+            {
+                has_range = qv->has_range;
+                nvals = qv->nvals;
+                lo = qv->min_value;
+                hi = qv->max_value;
+                DBFreeQuadvar(qv);
+            }
+        }
+        else if (type == DB_UCDVAR)
+        {
+            DBucdvar *uv = DBGetUcdvar(dbfile, varnames[i]);
+            if (uv)
+            {
+                has_range = uv->has_range;
+                nvals = uv->nvals;
+                lo = uv->min_value;
+                hi = uv->max_value;
+                DBFreeUcdvar(uv);
+            }
+        }
+        if (!has_range || nvals != 1)
+            ok = 0;
+        extents[2*i] = lo;
+        extents[2*i+1] = hi;
+    }
+    DBShowErrors(DB_RESUME, NULL);
+    DBSetDataReadMask2File(dbfile, mask);
+
+    free(empty);
+    if (!ok)
+        FREE(extents);
+    return extents;
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBInqMeshtype
+ * Function:    DBPutMultivar
  *
- * Purpose:     Returns the mesh type for the specified mesh.
+ * Purpose:     Writes a multi-block variable object to the database.
  *
- * Return:      Success:        mesh type constant
+ * Return:      Success:        object ID
  *
  *              Failure:        -1
  *
  * Programmer:  matzke@viper
- *              Tue Nov  8 11:31:56 PST 1994
+ *              Tue Nov  8 12:26:30 PST 1994
  *
  * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
@@ -8518,44 +10906,100 @@ DBInqMeshname(DBfile *dbfile, const char *vname, char *mname)
  *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *
+ *    Robb Matzke, 2000-05-23
+ *    The old table of contents is discarded if the directory changes.
+ *
+ *    Mark C. Miller, Wed Jul 14 20:36:23 PDT 2010
+ *    Added support for nameschemes on multi-block objects. This meant
+ *    adjusting sanity checks for args as some can be null now.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBInqMeshtype(DBfile *dbfile, const char *name)
+DBPutMultivar(DBfile *dbfile, const char *name, int nvar,
+              char const * const *varnames, int const *vartypes, DBoptlist const *optlist)
 {
     int retval;
+    int extentssize = 2;
+    double *extents = NULL;
+    DBoptlist *rangeopts = NULL;
 
-    API_BEGIN2("DBInqMeshtype", int, -1, name) {
+    API_BEGIN2("DBPutMultivar", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBInqMeshtype", E_GRABBED) ; 
+            API_ERROR("DBPutMultivar", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("mesh name", E_BADARGS);
-        if (!dbfile->pub.i_meshtype)
+            API_ERROR("multivar name", E_BADARGS);
+        if (db_VariableNameValid(name) == 0)
+            API_ERROR("multivar name", E_INVALIDNAME);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
+            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
+        if (nvar < 0)
+            API_ERROR("nvar", E_BADARGS);
+        if (nvar)
+        {
+            if (!varnames && (!optlist ||
+                 (!DBGetOption(optlist, DBOPT_MB_FILE_NS) &&
+                  !DBGetOption(optlist, DBOPT_MB_BLOCK_NS))))
+                API_ERROR("varnames", E_BADARGS);
+            if (!vartypes && (!optlist ||
+                 !DBGetOption(optlist, DBOPT_MB_BLOCK_TYPE)))
+                API_ERROR("vartypes", E_BADARGS);
+        }
+        else if (!DBGetAllowEmptyObjectsFile(dbfile))
+        {
+            /* this is an empty object but we don't know if it was intentional */
+            API_ERROR("nvar==0", E_EMPTYOBJECT);
+        }
+        if (!dbfile->pub.p_mv)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.i_meshtype) (dbfile, name);
+        /* Without caller extents, use the ranges stored with the blocks
+           if asked to. This reads the header of every block. */
+        if (nvar && optlist && !DBGetOption(optlist, DBOPT_EXTENTS) &&
+            DBGetOption(optlist, DBOPT_MB_BLOCK_RANGES) &&
+            *((int const *) DBGetOption(optlist, DBOPT_MB_BLOCK_RANGES)))
+            extents = db_MultivarRangeExtents(dbfile, nvar, varnames,
+                          vartypes, optlist);
+        if (extents)
+        {
+            int i;
+            rangeopts = DBMakeOptlist((optlist ? optlist->numopts : 0) + 2);
+            for (i = 0; optlist && i < optlist->numopts; i++)
+                if (optlist->options[i] != DBOPT_EXTENTS_SIZE)
+                    DBAddOption(rangeopts, optlist->options[i], optlist->values[i]);
+            DBAddOption(rangeopts, DBOPT_EXTENTS_SIZE, &extentssize);
+            DBAddOption(rangeopts, DBOPT_EXTENTS, extents);
+            optlist = rangeopts;
+        }
+
+        retval = (dbfile->pub.p_mv) (dbfile, name, nvar, varnames,
+                                     vartypes, optlist);
+        FREE(extents);
+        if (rangeopts)
+            DBFreeOptlist(rangeopts);
+        db_FreeToc(dbfile);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutCompoundarray
+ * Function:    DBPutMultimat
  *
- * Purpose:     Write compoundarray information to a file.
+ * Purpose:     Writes a multi-material object to the database.
  *
- * Return:      Success:        0
+ * Return:      Success:        object ID
  *
  *              Failure:        -1
  *
  * Programmer:  matzke@viper
- *              Mon Nov  7 10:54:46 PST 1994
+ *              Tue Feb 21 12:35:10 EST 1995
  *
  * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
- *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
  *
@@ -8564,62 +11008,55 @@ DBInqMeshtype(DBfile *dbfile, const char *name)
  *
  *    Robb Matzke, 2000-05-23
  *    The old table of contents is discarded if the directory changes.
+ *
+ *    Mark C. Miller, Wed Jul 14 20:36:23 PDT 2010
+ *    Added support for nameschemes on multi-block objects. This meant
+ *    adjusting sanity checks for args as some can be null now.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBPutCompoundarray(
-    DBfile *dbfile,
-    char const *name,
-    char const * const *elemnames,
-    int const *elemlengths,
-    int nelems,
-    void const *values,
-    int nvalues,
-    int datatype,
-    DBoptlist const *opts
-)
+DBPutMultimat(DBfile *dbfile, const char *name, int nmats,
+              char const * const *matnames, DBoptlist const *optlist)
 {
     int retval;
 
-    API_BEGIN2("DBPutCompoundarray", int, -1, name) {
+    API_BEGIN2("DBPutMultimat", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutCompoundarray", E_GRABBED) ; 
+            API_ERROR("DBPutMultimat", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("array name", E_BADARGS);
+            API_ERROR("multimat name", E_BADARGS);
         if (db_VariableNameValid(name) == 0)
-            API_ERROR("array name", E_INVALIDNAME);
+            API_ERROR("multimat name", E_INVALIDNAME);
         if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
             API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nelems < 0)
-            API_ERROR("nelems<0", E_BADARGS);
-        if (nelems)
+        if (nmats < 0)
+            API_ERROR("nmats", E_BADARGS);
+        if (nmats)
         {
-            if (!nelems)
-                API_ERROR("nelems=0", E_BADARGS);
-            if (!elemnames)
-                API_ERROR("elemnames=0", E_BADARGS);
-            if (nvalues <= 0)
-                API_ERROR("nvalues=0", E_BADARGS);
-            if (!values)
-                API_ERROR("values=0", E_BADARGS);
+            if (!matnames && (!optlist ||
+                 (!DBGetOption(optlist, DBOPT_MB_FILE_NS) && 
+                  !DBGetOption(optlist, DBOPT_MB_BLOCK_NS))))
+                API_ERROR("material-names", E_BADARGS);
         }
         else if (!DBGetAllowEmptyObjectsFile(dbfile))
         {
             /* this is an empty object but we don't know if it was intentional */
-            API_ERROR("nelems=0", E_EMPTYOBJECT);
-        }
-        else
-        {
-            nvalues = 0;
+            API_ERROR("nmats==0", E_EMPTYOBJECT);
         }
-
-        if (NULL == dbfile->pub.p_ca)
+        if (!dbfile->pub.p_mt)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.p_ca) (dbfile, name, elemnames,
-                                     elemlengths, nelems, values, nvalues,
-                                     datatype, opts);
+        retval = (dbfile->pub.p_mt) (dbfile, name, nmats, matnames,
+                                     optlist);
+#ifndef _WIN32
+#warning BETTER PLACE TO NULL THESE
+#endif
+        /* Zero out the _mm._matnames pointer so we can't accidentially use it
+         * again. Likewise for matcolors. */
+        _mm._matnames = NULL;
+        _mm._matcolors = NULL;
+
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
@@ -8627,186 +11064,195 @@ DBPutCompoundarray(
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutCurve
+ * Function:    DBPutMultimatspecies
  *
- * Purpose:     Writes curve information to a file.
+ * Purpose:     Writes a multi-material object to the database.
  *
- * Return:      Success:        0
+ * Return:      Success:        object ID
  *
  *              Failure:        -1
  *
- * Programmer:  Robb Matzke
- *              robb@callisto.nuance.com
- *              May 15, 1996
+ * Programmer:  Jeremy S. Meredith
+ *              Sept 17 1998
  *
  * Modifications:
- *    Robb Matzke, 16 May 1996
- *    Don't check for existence of XVALS and YVALS since the OPTS can
- *    specify a PDB variable name which has already been added to the
- *    file and which contains the necessary x or y values.  However,
- *    the driver should check.
- *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
  *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *
  *    Robb Matzke, 2000-05-23
  *    The old table of contents is discarded if the directory changes.
+ *
+ *    Mark C. Miller, Wed Jul 14 20:36:23 PDT 2010
+ *    Added support for nameschemes on multi-block objects. This meant
+ *    adjusting sanity checks for args as some can be null now.
  *-------------------------------------------------------------------------*/
-PUBLIC int
-DBPutCurve(
-    DBfile *dbfile,
-    char const *name,
-    void const *xvals,
-    void const *yvals,
-    int datatype,
-    int npts,
-    DBoptlist const *opts
-)
+PUBLIC int
+DBPutMultimatspecies(DBfile *dbfile, const char *name, int nspec,
+                     char const * const *specnames, DBoptlist const *optlist)
 {
     int retval;
 
-    API_BEGIN2("DBPutCurve", int, -1, name)
-    {
+    API_BEGIN2("DBPutMultimatspecies", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutCurve", E_GRABBED) ; 
+            API_ERROR("DBPutMultimatspecies", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("curve name", E_BADARGS);
+            API_ERROR("multimatspecies name", E_BADARGS);
         if (db_VariableNameValid(name) == 0)
-            API_ERROR("curve name", E_INVALIDNAME);
+            API_ERROR("multimatspecies name", E_INVALIDNAME);
         if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
             API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (npts < 0)
-            API_ERROR("npts<0", E_BADARGS);
-        if (npts)
+        if (nspec < 0)
+            API_ERROR("nspec", E_BADARGS);
+        if (nspec)
         {
-            if (DBGetOption(opts, DBOPT_REFERENCE))
-            {
-                if (yvals || xvals)
-                    API_ERROR("xvals & yvals must be null when using DBOPT_REFERENCE", E_BADARGS);
-            }
-            else
-            {
-                if (!xvals && !DBGetOption(opts, DBOPT_XVARNAME))
-                    API_ERROR("xvals=0 || DBOPT_XVARNAME", E_BADARGS);
-                if (!yvals && !DBGetOption(opts, DBOPT_YVARNAME))
-                    API_ERROR("yvals=0 || DBOPT_YVARNAME", E_BADARGS);
-#ifndef DB_HDF5X
-                if (xvals && DBGetOption(opts, DBOPT_XVARNAME))
-                    API_ERROR("xvals!=0 && DBOPT_XVARNAME", E_BADARGS);
-                if (yvals && DBGetOption(opts, DBOPT_YVARNAME))
-                    API_ERROR("yvals!=0 && DBOPT_YVARNAME", E_BADARGS);
-#else
-                if (DBGetDriverType(dbfile) != DB_HDF5X && xvals && DBGetOption(opts, DBOPT_XVARNAME))
-                    API_ERROR("xvals!=0 && DBOPT_XVARNAME", E_BADARGS);
-                if (DBGetDriverType(dbfile) != DB_HDF5X && yvals && DBGetOption(opts, DBOPT_YVARNAME))
-                    API_ERROR("yvals!=0 && DBOPT_YVARNAME", E_BADARGS);
-#endif
-            }
+            if (!specnames && (!optlist ||
+                 (!DBGetOption(optlist, DBOPT_MB_FILE_NS) && 
+                  !DBGetOption(optlist, DBOPT_MB_BLOCK_NS))))
+                API_ERROR("species-names", E_BADARGS);
         }
-        else if (!DBGetAllowEmptyObjectsFile(dbfile) &&
-                 !DBGetOption(opts, DBOPT_REFERENCE))
+        else if (!DBGetAllowEmptyObjectsFile(dbfile))
         {
             /* this is an empty object but we don't know if it was intentional */
-            API_ERROR("npts=0", E_EMPTYOBJECT);
+            API_ERROR("nspec==0", E_EMPTYOBJECT);
         }
-
-        if (NULL == dbfile->pub.p_cu)
+        if (!dbfile->pub.p_mms)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.p_cu) (dbfile, name, (void*)xvals, (void*)yvals,
-                                     datatype, npts, opts);
+        retval = (dbfile->pub.p_mms) (dbfile, name, nspec, specnames, optlist);
+
+        /* Zero out the _ma._matnames pointer so we can't accidentially use it
+         * again. Likewise for matcolors. */
+        _mm._specnames = NULL;
+        _mm._speccolors = NULL;
 
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
-    API_END_NOPOP; /* BEWARE: If API_RETURN above is removed use API_END */
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutDefvars
+ * Function:    DBPutPoinmesh
  *
- * Purpose:     Writes a Defvars object to a file.
+ * Purpose:     Accepts pointers to the coordinate arrays and writes the
+ *              mesh into the database.
  *
- * Return:      Success:        0
+ * Return:      Success:        object ID
  *
  *              Failure:        -1
  *
- * Programmer:  Mark C. Miller 
- *              August 8, 2005
+ * Programmer:  matzke@viper
+ *              Tue Nov  8 12:32:43 PST 1994
+ *
+ * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
  *
+ *    Robb Matzke, 2000-05-23
+ *    The old table of contents is discarded if the directory changes.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBPutDefvars(
-    DBfile *dbfile,
-    const char *name,
-    int ndefs,
-    char const * const *names,
-    int const *types,
-    char const * const *defns,
-    DBoptlist const * const *opts
-)
+DBPutPointmesh(DBfile *dbfile, const char *name, int ndims, DBVCP2_t coords,
+               int nels, int datatype, DBoptlist const *optlist)
 {
     int retval;
 
-    API_BEGIN2("DBPutDefvars", int, -1, name)
-    {
+    API_BEGIN2("DBPutPointmesh", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutDefvars", E_GRABBED) ; 
+            API_ERROR("DBPutPointmesh", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("defvars name", E_BADARGS);
+            API_ERROR("pointmesh name", E_BADARGS);
         if (db_VariableNameValid(name) == 0)
-            API_ERROR("defvars name", E_INVALIDNAME);
+            API_ERROR("pointmesh name", E_INVALIDNAME);
         if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
             API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (ndefs < 0)
-            API_ERROR("ndefs", E_BADARGS);
-        if (ndefs)
+        if (nels < 0)
+            API_ERROR("nels<0", E_BADARGS);
+        if (nels > 0)
         {
-            if (!names)
-                API_ERROR("names=0", E_BADARGS);
-            if (!types)
-                API_ERROR("types=0", E_BADARGS);
-            if (!defns)
-                API_ERROR("defns=0", E_BADARGS);
+            int i;
+            void **coords2 = (void**) coords;
+            if (ndims < 1 || ndims > 3)
+                API_ERROR("ndims < 1 || ndims > 3", E_BADARGS);
+            for (i = 0; i < ndims && coords; i++)
+                if (coords2[i] == 0) coords = 0;
+            if (!coords)
+                API_ERROR("coords=0 || coords[i]=0 for some i", E_BADARGS);
         }
         else if (!DBGetAllowEmptyObjectsFile(dbfile))
         {
-            /* this is an empty object but we don't know if it was intentional */
-            API_ERROR("ndefs=0", E_EMPTYOBJECT);
+            API_ERROR("nels==0", E_EMPTYOBJECT);
         }
 
-        if (NULL == dbfile->pub.p_defv)
+        if (!dbfile->pub.p_pm)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.p_defv) (dbfile, name, ndefs, names,
-                                       types, defns, opts);
+        retval = (dbfile->pub.p_pm) (dbfile, name, ndims, coords, nels,
+                                     datatype, optlist);
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
-    API_END_NOPOP; /* BEWARE: If API_RETURN above is removed use API_END */
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutFacelist
+ * Function:    db_GetPointmeshPerm
  *
- * Purpose:     Writes a facelist object into the open database file.
+ * Purpose:     Read the point permutation of a spatially sorted point mesh.
  *
- * Return:      Success:        0
+ * Return:      The permutation, to be freed with free(), if MNAME names a
+ *              point mesh of NELS points written with DBOPT_SPATIAL_SORT.
+ *              NULL otherwise.
+ *-------------------------------------------------------------------------*/
+static int *
+db_GetPointmeshPerm(DBfile *dbfile, char const *mname, int nels)
+{
+    int *perm = NULL, *n = NULL;
+
+    if (!mname || !dbfile->pub.g_comp)
+        return NULL;
+
+    DBShowErrors(DB_SUSPEND, NULL);
+    PROTECT {
+        n = (int *) (dbfile->pub.g_comp) (dbfile, mname, "nels");
+        if (n && *n == nels)
+            perm = (int *) (dbfile->pub.g_comp) (dbfile, mname, "perm");
+    } CLEANUP {
+        CANCEL_UNWIND;
+    } END_PROTECT;
+    DBShowErrors(DB_RESUME, NULL);
+
+    FREE(n);
+    return perm;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBPutPointvar
+ *
+ * Purpose:     Accepts pointers to the value arrays and writes the
+ *              variables into a point-variable object in the database.
+ *
+ * Return:      Success:        object ID
  *
  *              Failure:        -1
  *
  * Programmer:  matzke@viper
- *              Tue Nov  8 11:52:25 PST 1994
+ *              Tue Nov  8 12:38:22 PST 1994
  *
  * Modifications:
- *    Robb Matzke, Thu Dec 1 10:34:09 PST 1994
- *    The `zoneno' parameter is optional even if
- *    the number of faces is zero.
- *
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
  *    I replaced API_END with API_END_NOPOP.
  *
@@ -8820,67 +11266,115 @@ DBPutDefvars(
  *    The old table of contents is discarded if the directory changes.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBPutFacelist(DBfile *dbfile, const char *name, int nfaces, int ndims,
-              int const *nodelist, int lnodelist, int origin, int const *zoneno,
-              int const *shapesize, int const *shapecnt, int nshapes, int const *types,
-              int const *typelist, int ntypes)
+DBPutPointvar(DBfile *dbfile, const char *vname, const char *mname, int nvars,
+              DBVCP2_t vars, int nels, int datatype, DBoptlist const *optlist)
 {
     int retval;
+    int *perm = NULL;
+    void **pvars = NULL;
 
-    API_BEGIN2("DBPutFacelist", int, -1, name) {
+    API_BEGIN2("DBPutPointvar", int, -1, vname) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutFacelist", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("facelist name", E_BADARGS);
-        if (db_VariableNameValid(name) == 0)
-            API_ERROR("facelist name", E_INVALIDNAME);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
+            API_ERROR("DBPutPointvar", E_GRABBED) ; 
+        if (!vname || !*vname)
+            API_ERROR("pointvar name", E_BADARGS);
+        if (db_VariableNameValid(vname) == 0)
+            API_ERROR("pointvar name", E_INVALIDNAME);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, vname))
             API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nfaces < 0)
-            API_ERROR("nfaces<0", E_BADARGS);
-        if (nfaces)
+        if (nels < 0)
+            API_ERROR("nels<0", E_BADARGS);
+        if (nels)
         {
-            if (nfaces <= 0)
-                API_ERROR("nfaces<=0", E_BADARGS);
-            if (ndims <= 0)
-                API_ERROR("ndims<=0", E_BADARGS);
-            if (lnodelist <= 0)
-                API_ERROR("lnodelist<0", E_BADARGS);
-            if (nshapes <= 0)
-                API_ERROR("nshapes<0", E_BADARGS);
-            if (!nodelist)
-                API_ERROR("nodelist==0", E_BADARGS);
-            if (!shapesize)
-                API_ERROR("shapesize==0", E_BADARGS);
-            if (!shapecnt)
-                API_ERROR("shapecnt==0", E_BADARGS);
-            if (ntypes < 0)
-                API_ERROR("ntypes<0", E_BADARGS);
-            if (origin != 0 && origin != 1)
-                API_ERROR("origin", E_BADARGS);
+            int i;
+            void **vars2 = (void**) vars;
+            if (nvars <= 0)
+                API_ERROR("nvars<=0", E_BADARGS);
+            for (i = 0; i < nvars && vars; i++)
+                if (!vars2[i]) vars = 0;
+            if (!vars) API_ERROR("vars==0 || vars[i]==0", E_BADARGS);
+            if (!mname || !*mname)
+                API_ERROR("pointmesh name", E_BADARGS);
+            if (db_VariableNameValid(mname) == 0)
+                API_ERROR("pointmesh name", E_INVALIDNAME);
         }
         else if (!DBGetAllowEmptyObjectsFile(dbfile))
         {
-            /* this is an empty object but we don't know if it was intentional */
-            API_ERROR("nfaces=0", E_EMPTYOBJECT);
+            API_ERROR("nels=0", E_EMPTYOBJECT);
         }
-        else
+
+        if (!dbfile->pub.p_pv)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        /* Values on a spatially sorted point mesh are stored in the
+           mesh's point order */
+        if (nels > 0 && (perm = db_GetPointmeshPerm(dbfile, mname, nels)))
         {
-            nfaces = 0;
-            lnodelist = 0;
-            nshapes = 0;
-            ntypes = 0;
+            int i;
+            size_t size = (size_t) db_GetMachDataSize(datatype);
+            pvars = (void **) calloc(nvars, sizeof(void*));
+            for (i = 0; i < nvars && pvars && size > 0; i++)
+                pvars[i] = db_PermuteArray(((void const * const *) vars)[i],
+                                           nels, size, perm);
+            if (!pvars || size <= 0 || !pvars[nvars-1])
+            {
+                for (i = 0; i < nvars && pvars; i++)
+                    FREE(pvars[i]);
+                FREE(pvars);
+                FREE(perm);
+                API_ERROR(vname, E_NOMEM);
+            }
+            vars = (DBVCP2_t) pvars;
         }
 
-        if (!dbfile->pub.p_fl)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+        retval = (dbfile->pub.p_pv) (dbfile, vname, mname,
+                                     nvars, vars, nels, datatype, optlist);
+        if (pvars)
+        {
+            int i;
+            for (i = 0; i < nvars; i++)
+                FREE(pvars[i]);
+            FREE(pvars);
+        }
+        FREE(perm);
+        db_FreeToc(dbfile);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBPutPointvar1
+ *
+ * Purpose:     Same as DBPutPointvar except only one variable at a time.
+ *
+ * Return:      Success:        Object ID
+ *
+ *              Failure:        -1
+ *
+ * Programmer:  matzke@viper
+ *              Tue Nov  8 12:46:01 PST 1994
+ *
+ * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
+ *    Robb Matzke, 2000-05-23
+ *    The old table of contents is discarded if the directory changes.
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBPutPointvar1(DBfile *dbfile, const char *vname, const char *mname,
+               DBVCP1_t var, int nels, int datatype, DBoptlist const *optlist)
+{
+    DBVCP1_t vars[1] = {var};
+    int retval;
 
-        retval = (dbfile->pub.p_fl) (dbfile, name, nfaces, ndims,
-                                     nodelist, lnodelist, origin, zoneno,
-                                     shapesize, shapecnt, nshapes, types,
-                                     typelist, ntypes);
+    API_BEGIN2("DBPutPointvar1", int, -1, vname)
+    {
+        retval = DBPutPointvar(dbfile, vname, mname, 1, vars,
+                               nels, datatype, optlist);
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
@@ -8888,26 +11382,29 @@ DBPutFacelist(DBfile *dbfile, const char *name, int nfaces, int ndims,
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutMaterial
+ * Function:    DBPutQuadmesh
  *
- * Purpose:     Writes a material data object into the current open
- *              database.  The minimum required information for a material
- *              data object is supplied via the standard arguments to the
- *              function.  The `optlist' argument must be used for
- *              supplying any information not requested through the
- *              standard arguments.
+ * Purpose:     Accepts pointers to the coordinate arrays and writes the
+ *              mesh into a quad-mesh object in the database.
  *
- * Return:      Success:        object ID
+ * Return:      Success:        Object ID
  *
  *              Failure:        -1
  *
  * Programmer:  matzke@viper
- *              Tue Nov  8 12:05:23 PST 1994
+ *              Tue Nov  8 12:50:40 PST 1994
  *
  * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
  *    I replaced API_END with API_END_NOPOP.
  *
+ *    Sean Ahern, Mon Nov  2 17:51:55 PST 1998
+ *    Removed the requirement for a non-NULL coordnames parameter.
+ *
+ *    Sean Ahern, Wed Mar 17 10:12:39 PST 1999
+ *    Added a check for the coordtype.  It must be DB_COLLINEAR or
+ *    DB_NONCOLLINEAR.
+ *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
  *
@@ -8916,49 +11413,31 @@ DBPutFacelist(DBfile *dbfile, const char *name, int nfaces, int ndims,
  *
  *    Robb Matzke, 2000-05-23
  *    The old table of contents is discarded if the directory changes.
- *
- *    Sean Ahern, Thu Jun  8 12:08:05 PDT 2000
- *    Removed an unnecessary check on mix_zone.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBPutMaterial(
-    DBfile *dbfile,
-    char const *name,
-    char const *meshname,
-    int nmat,
-    int const *matnos,
-    int const *matlist,
-    int const *dims,
-    int ndims,
-    int const *mix_next,
-    int const *mix_mat,
-    int const *mix_zone,
-    DBVCP1_t mix_vf,
-    int mixlen,
-    int datatype,
-    DBoptlist const *optlist
-)
+DBPutQuadmesh(DBfile *dbfile, const char *name, char const * const *coordnames,
+              DBVCP2_t coords, int const *dims, int ndims, int datatype,
+              int coordtype, DBoptlist const *optlist)
 {
-    int i, retval, is_empty = 1;
-    int const zdims[10] = {0,0,0,0,0,0,0,0,0,0};
+    int i, retval, is_empty=1;
 
-    API_BEGIN2("DBPutMaterial", int, -1, name) {
+    API_BEGIN2("DBPutQuadmesh", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutMaterial", E_GRABBED) ; 
+            API_ERROR("DBPutQuadmesh", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("material name", E_BADARGS);
+            API_ERROR("quadmesh name", E_BADARGS);
         if (db_VariableNameValid(name) == 0)
-            API_ERROR("material name", E_INVALIDNAME);
+            API_ERROR("quadmesh name", E_INVALIDNAME);
         if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
             API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nmat < 0)
-            API_ERROR("nmat<0", E_BADARGS);
+        if ((coordtype != DB_COLLINEAR) && (coordtype != DB_NONCOLLINEAR))
+            API_ERROR("coordtype must be DB_COLLINEAR or DB_NONCOLLINEAR", E_BADARGS);
         if (ndims < 0)
-            API_ERROR("ndims<0", E_BADARGS);
+            API_ERROR("ndims", E_BADARGS);
         if (!dims)
-            API_ERROR("dims=0", E_BADARGS);
+            API_ERROR("dims==0", E_BADARGS);
         for (i = 0; i < ndims; i++)
         {
             if (dims[i] != 0)
@@ -8969,75 +11448,44 @@ DBPutMaterial(
         }
         if (!is_empty)
         {
-            for (i = 0; i < ndims && dims!=zdims; i++)
-                if (dims[i] == 0) dims = zdims;
-            if (!matnos) API_ERROR("matnos=0", E_BADARGS);
-            if (!matlist) API_ERROR("matlist=0", E_BADARGS);
-            if (!meshname || !*meshname) API_ERROR("mesh name", E_BADARGS);
-            if (!db_VariableNameValid(meshname)) API_ERROR("meshname", E_INVALIDNAME);
-            if (mixlen < 0)
-                API_ERROR("mixlen<0", E_BADARGS);
-            if (mixlen)
-            {
-                if (!mix_next)
-                    API_ERROR("mix_next=0", E_BADARGS);
-                if (!mix_mat)
-                    API_ERROR("mix_mat=0", E_BADARGS);
-                if (!mix_vf)
-                    API_ERROR("mix_vf=0", E_BADARGS);
-            }
+            void **coords2 = (void**) coords;
+            for (i = 0; i < ndims && coords; i++)
+                if (!coords2[i]) coords = 0;
+            if (!coords)
+                API_ERROR("coords==0 || coords[i]==0", E_BADARGS);
         }
         else if (!DBGetAllowEmptyObjectsFile(dbfile))
         {
-            API_ERROR("nmat=0", E_EMPTYOBJECT);
+            /* this is an empty object but we don't think it was intentional */
+            API_ERROR("dims[i]==0 for all i", E_EMPTYOBJECT);
         }
-        if (!dbfile->pub.p_ma)
+        if (!dbfile->pub.p_qm)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.p_ma) (dbfile, name, meshname,
-                                     nmat, matnos, matlist, dims, ndims,
-                                     mix_next, mix_mat, mix_zone, mix_vf,
-                                     mixlen, datatype, optlist);
-#ifndef _WIN32
-#warning BETTER PLACE TO NULL THESE
-#endif
-        /* Zero out the _ma._matnames pointer so we can't accidentially use it
-         * again. Likewise for matcolors. */
-        _ma._matnames = NULL;
-        _ma._matcolors = NULL;
-
+        retval = (dbfile->pub.p_qm) (dbfile, name, coordnames, coords,
+                                     dims, ndims, datatype, coordtype,
+                                     optlist);
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-/*----------------------------------------------------------------------
- *  Routine                                                DBPutMatspecies
- *
- *  Purpose
- *
- *      Write a material species object into the open file.
- *
- *  Programmer
- *
- *      Al Leibee, B-DSAD
+/*-------------------------------------------------------------------------
+ * Function:    DBPutQuadvar
  *
- *  Notes
+ * Purpose:     Writes a variable associated with a quad mesh into a
+ *              database. Variables will be either node-centered or zone-
+ *              centered.
  *
- *      One zonal array ('speclist') is used which contains either:
- *      1) an index into the 'species_mf' array of the species mass fractions
- *         of a clean zone's material.
+ * Return:      Success:        Object ID
  *
- *                                  OR
- *      2) an index into the 'mix_speclist' array which contains an index
- *         into the 'species_mf' of the species mass fractions of a mixed
- *         zone's materials.
+ *              Failure:        -1
  *
- *  Modified
- *    Robb Matzke, Mon Nov 28 15:19:50 EST 1994
- *    Added device independence stuff.
+ * Programmer:  matzke@viper
+ *              Tue Nov  8 12:57:08 PST 1994
  *
+ * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
  *    I replaced API_END with API_END_NOPOP.
  *
@@ -9049,35 +11497,40 @@ DBPutMaterial(
  *
  *    Robb Matzke, 2000-05-23
  *    The old table of contents is discarded if the directory changes.
- *--------------------------------------------------------------------*/
+ *
+ *    Mark C. Miller, Wed Nov 11 09:19:20 PST 2009
+ *    Added check for valid centering.
+ *
+ *    Mark C. Miller, Thu Feb  4 11:29:35 PST 2010
+ *    Removed upper bound restriction for nvars.
+ *-------------------------------------------------------------------------*/
 PUBLIC int
-DBPutMatspecies(DBfile *dbfile, const char *name, const char *matname,
-                int nmat, int const *nmatspec, int const *speclist, int const *dims,
-                int ndims, int nspecies_mf, DBVCP1_t species_mf,
-                int const *mix_speclist, int mixlen, int datatype,
-                DBoptlist const *optlist)
+DBPutQuadvar(DBfile *dbfile, const char *vname, const char *mname, int nvars,
+             char const * const *varnames, DBVCP2_t vars, int const *dims, int ndims,
+             DBVCP2_t mixvars, int mixlen, int datatype, int centering,
+             DBoptlist const *optlist)
 {
-    int i, retval, is_empty=1;
+    int i, retval, is_empty = 1;
 
-    API_BEGIN2("DBPutMatspecies", int, -1, name) {
+    API_BEGIN2("DBPutQuadvar", int, -1, vname) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutMatspecies", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("matspecies name", E_BADARGS);
-        if (db_VariableNameValid(name) == 0)
-            API_ERROR("matspecies name", E_INVALIDNAME);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
+            API_ERROR("DBPutQuadvar", E_GRABBED) ; 
+        if (!vname || !*vname)
+            API_ERROR("quadvar name", E_BADARGS);
+        if (db_VariableNameValid(vname) == 0)
+            API_ERROR("quadvar name", E_INVALIDNAME);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, vname))
             API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nmat < 0)
-            API_ERROR("nmat<0", E_BADARGS);
+        if (!mname || !*mname)
+            API_ERROR("quadmesh name", E_BADARGS);
+        if (db_VariableNameValid(mname) == 0)
+            API_ERROR("quadmesh name", E_INVALIDNAME);
         if (ndims < 0)
-            API_ERROR("ndims<0", E_BADARGS);
+            API_ERROR("ndims", E_BADARGS);
         if (!dims)
-            API_ERROR("dims=0", E_BADARGS);
-        if (nspecies_mf < 0)
-            API_ERROR("nspecies_mf<0", E_BADARGS);
+            API_ERROR("dims==0", E_BADARGS);
         for (i = 0; i < ndims; i++)
         {
             if (dims[i] != 0)
@@ -9086,39 +11539,49 @@ DBPutMatspecies(DBfile *dbfile, const char *name, const char *matname,
                 break;
             }
         }
-        if (!is_empty && nspecies_mf > 0)
+        if (!is_empty)
         {
-            if (!matname || !*matname)
-                API_ERROR("material name", E_BADARGS);
-            if (db_VariableNameValid(matname) == 0)
-                API_ERROR("material name", E_INVALIDNAME);
-            if (ndims == 1 && dims[0] <= 0) API_ERROR("dims[0]<=0", E_BADARGS);
-            if (ndims == 2 && dims[1] <= 0) API_ERROR("dims[1]<=0", E_BADARGS);
-            if (ndims == 3 && dims[2] <= 0) API_ERROR("dims[2]<=0", E_BADARGS);
-            if (!nmatspec) API_ERROR("nmatspec=0", E_BADARGS);
-            if (!speclist) API_ERROR("speclist=0", E_BADARGS);
-            if (!species_mf) API_ERROR("species_mf=0", E_BADARGS);
+            int i;
+            void **vars2 = (void**) vars;
+            for (i = 0; i < ndims && dims; i++)
+                if (!dims[i]) dims = 0;
+            if (!dims)
+                API_ERROR("dims=0 || dims[i]=0", E_BADARGS);
+            if (nvars < 1)
+                API_ERROR("nvars<1", E_BADARGS);
+            for (i = 0; i < nvars && vars; i++)
+                if (!vars2[i]) vars = 0;
+            vars2 = (void**) mixvars;
+            for (i = 0; i < nvars && mixvars; i++)
+                if (!vars2[i]) mixvars = 0;
+            for (i = 0; i < nvars && varnames; i++)
+                if (!varnames[i] && !*varnames[i]) varnames = 0;
+            if (!vars)
+                API_ERROR("vars=0 || vars[i]=0", E_BADARGS);
+            if (!varnames)
+                API_ERROR("varnames=0 || varnames[i]=0||\"\"", E_BADARGS);
             if (mixlen < 0)
                 API_ERROR("mixlen", E_BADARGS);
-            if (!mix_speclist && mixlen)
-                API_ERROR("mix_speclist", E_BADARGS);
+            if (!mixvars && mixlen)
+                API_ERROR("mixvars", E_BADARGS);
         }
         else if (!DBGetAllowEmptyObjectsFile(dbfile))
         {
-            API_ERROR("dims[i]==0 for all i || nspecies_mf==0", E_EMPTYOBJECT);
+            /* this is an empty object but we don't think it was intentional */
+            API_ERROR("ndims=0", E_EMPTYOBJECT);
         }
-        if (!dbfile->pub.p_ms)
+        if (centering != DB_NODECENT && centering != DB_ZONECENT &&
+            centering != DB_FACECENT && centering != DB_BNDCENT &&
+            centering != DB_EDGECENT && centering != DB_BLOCKCENT)
+            API_ERROR("centering", E_BADARGS);
+        if (!dbfile->pub.p_qv)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
-        retval = (dbfile->pub.p_ms) (dbfile, name, matname,
-                                     nmat, nmatspec, speclist, dims, ndims,
-                                     nspecies_mf, species_mf, mix_speclist,
-                                     mixlen, datatype, optlist);
 
-        /* Zero out the _ma._matnames pointer so we can't accidentially use it
-         * again. Likewise for matcolors. */
-        _ms._specnames = NULL;
-        _ms._speccolors = NULL;
 
+        retval = (dbfile->pub.p_qv) (dbfile, vname, mname,
+                                     nvars, varnames, vars, dims, ndims,
+                                     mixvars, mixlen, datatype, centering,
+                                     optlist);
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
@@ -9126,76 +11589,41 @@ DBPutMatspecies(DBfile *dbfile, const char *name, const char *matname,
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutMultimesh
+ * Function:    DBPutQuadvar1
  *
- * Purpose:     Writes a multi-bloc kmesh object into the open database.
- *              It accepts as input descriptions of the various sub-meshes
- *              (blocks) which are part of this mesh.
+ * Purpose:     Same as DBPutQuadvar except for scalar variables.
  *
- * Return:      Success:        object ID
+ * Return:      Success:        Object ID
  *
  *              Failure:        -1
  *
  * Programmer:  matzke@viper
- *              Tue Nov  8 12:17:57 PST 1994
+ *              Tue Nov  8 13:07:45 PST 1994
  *
  * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
  *    I replaced API_END with API_END_NOPOP.
  *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
- *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
- *
  *    Robb Matzke, 2000-05-23
  *    The old table of contents is discarded if the directory changes.
- *
- *    Mark C. Miller, Wed Jul 14 20:36:23 PDT 2010
- *    Added support for nameschemes on multi-block objects. This meant
- *    adjusting sanity checks for args as some can be null now.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBPutMultimesh(DBfile *dbfile, char const *name, int nmesh,
-    char const * const *meshnames, int const *meshtypes,
-    DBoptlist const *optlist)
+DBPutQuadvar1(DBfile *dbfile, const char *vname, const char *mname, void const *var,
+              int const *dims, int ndims, void const *mixvar, int mixlen, int datatype,
+              int centering, DBoptlist const *optlist)
 {
+    char const *varnames[1] = {vname};
+    void const *vars[1] = {var};
+    void const *mixvars[1] = {mixvar};
     int retval;
 
-    API_BEGIN2("DBPutMultimesh", int, -1, name) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutMultimesh", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("multimesh name", E_BADARGS);
-        if (db_VariableNameValid(name) == 0)
-            API_ERROR("multimesh name", E_INVALIDNAME);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
-            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nmesh < 0)
-            API_ERROR("nmesh", E_BADARGS);
-        if (nmesh)
-        {
-            if (!meshnames && (!optlist || 
-                (!DBGetOption(optlist, DBOPT_MB_FILE_NS) &&
-                 !DBGetOption(optlist, DBOPT_MB_BLOCK_NS))))
-                API_ERROR("mesh names", E_BADARGS);
-            if (!meshtypes && (!optlist ||
-                 !DBGetOption(optlist, DBOPT_MB_BLOCK_TYPE)))
-                API_ERROR("mesh types", E_BADARGS);
-        }
-        else if (!DBGetAllowEmptyObjectsFile(dbfile))
-        {
-            /* this is an empty object but we don't know if it was intentional */
-            API_ERROR("nmesh==0", E_EMPTYOBJECT);
-        }
-        if (!dbfile->pub.p_mm)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+    API_BEGIN2("DBPutQuadvar1", int, -1, vname) {
+
+        retval = DBPutQuadvar(dbfile, vname, mname, 1,
+                              varnames, vars, dims, ndims,
+                              mixvars, mixlen,
+                              datatype, centering, optlist);
 
-        retval = (dbfile->pub.p_mm) (dbfile, name, nmesh, meshnames,
-                                     meshtypes, optlist);
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
@@ -9203,82 +11631,207 @@ DBPutMultimesh(DBfile *dbfile, char const *name, int nmesh,
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutMultimeshadj
+ * Function:    db_PermuteOptlist
  *
- * Purpose:     Writes a multi-mesh adjacency object into the
- *              open database.
+ * Purpose:     Copy the optlist of an object whose N nodes or zones are
+ *              being stored in the order given by PERM.
  *
- * Return:      Success:        object ID
+ * Return:      Success:        a new optlist. BUFS[0..2] receive arrays
+ *                              it points to. Both are to be freed after
+ *                              the object is written.
  *
- *              Failure:        -1
+ *              Failure:        NULL
  *
- * Programmer:  Mark C. Miller, August 23, 2005 
+ * Description: The global numbers given with NUMOPT and the ghost labels
+ *              given with LBLOPT are permuted too. ALTNAME, the array in
+ *              the file holding PERM, is added to the names given with
+ *              ALTOPT so the original order can be recovered.
+ *-------------------------------------------------------------------------*/
+static DBoptlist *
+db_PermuteOptlist(DBoptlist const *optlist, int n, int const *perm,
+    int numopt, int lblopt, int altopt, char *altname, void **bufs)
+{
+    DBoptlist *opts;
+    int i, nalt = 0;
+    char **alt = (char **) DBGetOption(optlist, altopt);
+    void *num = DBGetOption(optlist, numopt);
+    char *lbl = (char *) DBGetOption(optlist, lblopt);
+    int *llong = (int *) DBGetOption(optlist, DBOPT_LLONGNZNUM);
+
+    bufs[0] = bufs[1] = bufs[2] = NULL;
+    if ((opts = DBMakeOptlist((optlist ? optlist->numopts : 0) + 3)) == NULL)
+        return NULL;
+    for (i = 0; optlist && i < optlist->numopts; i++)
+    {
+        int o = optlist->options[i];
+        if (o != numopt && o != lblopt && o != altopt &&
+            o != DBOPT_NODE_PERM && o != DBOPT_ZONE_PERM)
+            DBAddOption(opts, o, optlist->values[i]);
+    }
+
+    if (num)
+    {
+        size_t size = llong && *llong ? sizeof(long long) : sizeof(int);
+        if ((bufs[0] = db_PermuteArray(num, n, size, perm)) == NULL)
+            goto fail;
+        DBAddOption(opts, numopt, bufs[0]);
+    }
+    if (lbl)
+    {
+        if ((bufs[1] = db_PermuteArray(lbl, n, sizeof(char), perm)) == NULL)
+            goto fail;
+        DBAddOption(opts, lblopt, bufs[1]);
+    }
+    while (alt && alt[nalt])
+        nalt++;
+    if ((bufs[2] = calloc(nalt + 2, sizeof(char *))) == NULL)
+        goto fail;
+    for (i = 0; i < nalt; i++)
+        ((char **) bufs[2])[i] = alt[i];
+    ((char **) bufs[2])[nalt] = altname;
+    DBAddOption(opts, altopt, bufs[2]);
+    return opts;
+
+fail:
+    for (i = 0; i < 3; i++)
+        FREE(bufs[i]);
+    DBFreeOptlist(opts);
+    return NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    db_PermuteZonelist
  *
- * Notes:       This function is designed to support repeated calls where
- *              Different parts of the same object are written at different
- *              times.
+ * Purpose:     Make the nodelist of a zonelist whose zones are stored in
+ *              the order given by ZONEPERM and whose mesh's nodes are
+ *              stored in the order given by NODEPERM, of NNODES ints.
+ *              Either may be NULL.
  *
+ * Return:      Success:        new nodelist of LNODELIST ints
+ *
+ *              Failure:        NULL, if a permutation is not valid or
+ *                              memory is exhausted
+ *
+ * Description: A zone may only move within its shape group and within the
+ *              low ghost, real or high ghost range, so the shape and ghost
+ *              arguments of the zonelist stay valid.
  *-------------------------------------------------------------------------*/
-PUBLIC int
-DBPutMultimeshadj(DBfile *dbfile, char const *name, int nmesh,
-                  int const *meshtypes, int const *nneighbors,
-                  int const *neighbors, int const *back,
-                  int const *lnodelists, int const * const *nodelists,
-                  int const *lzonelists, int const * const *zonelists,
-                  DBoptlist const *optlist)
+static int *
+db_PermuteZonelist(int nzones, int const *nodelist, int lnodelist,
+    int origin, int lo_offset, int hi_offset, int const *shapetype,
+    int const *shapesize, int const *shapecnt, int nshapes,
+    int const *nodeperm, int nnodes, int const *zoneperm)
 {
-    int retval;
+    int *starts, *blk = NULL, *inv = NULL, *out = NULL, *zinv = NULL;
+    int i, j, z, pos, maxnode = -1;
 
-    API_BEGIN2("DBPutMultimeshadj", int, -1, name) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutMultimeshadj", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("multimeshadj name", E_BADARGS);
-        if (db_VariableNameValid(name) == 0)
-            API_ERROR("multimeshadj name", E_INVALIDNAME);
-        if (nmesh < 0)
-            API_ERROR("nmesh", E_BADARGS);
-        if (!meshtypes && nmesh)
-            API_ERROR("mesh types", E_BADARGS);
-        if (!nneighbors && nmesh)
-            API_ERROR("nneighbors", E_BADARGS);
-        if (!neighbors && nmesh)
-            API_ERROR("neighbors", E_BADARGS);
-        if (lnodelists == NULL && nodelists != NULL)
-            API_ERROR("non-NULL nodelists", E_BADARGS);
-        if (lzonelists == NULL && zonelists != NULL)
-            API_ERROR("non-NULL zonelists", E_BADARGS);
-        if (!dbfile->pub.p_mmadj)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+    starts = db_ZoneStarts(nzones, nodelist, lnodelist, lo_offset,
+                 hi_offset, shapetype, shapesize, shapecnt, nshapes, &blk);
+    if (!starts)
+        return NULL;
 
-        retval = (dbfile->pub.p_mmadj) (dbfile, name, nmesh, meshtypes,
-                                        nneighbors, neighbors, back,
-                                        lnodelists, nodelists, lzonelists, zonelists,
-                                        optlist);
-        db_FreeToc(dbfile);
-        API_RETURN(retval);
+    if (zoneperm)
+    {
+        if ((zinv = db_InvertPerm(zoneperm, nzones, nzones)) == NULL)
+            goto done;
+        for (j = 0; j < nzones; j++)
+            if (blk[zoneperm[j]] != blk[j])
+                goto done;
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+
+    if (nodeperm)
+    {
+        int maxlen = 0;
+        for (z = 0; z < nzones; z++)
+            maxlen = MAX(maxlen, starts[z+1] - starts[z]);
+        if ((inv = (int *) malloc((maxlen + 1) * sizeof(int))) == NULL)
+            goto done;
+        for (z = 0; z < nzones; z++)
+        {
+            int poly = shapetype && shapetype[blk[z]/3] == DB_ZONETYPE_POLYHEDRON;
+            int n = db_ZoneNodes(nodelist, starts[z], starts[z+1], poly, origin, inv);
+            if (n > 0 && inv[0] < 0)
+                goto done;
+            if (n > 0)
+                maxnode = MAX(maxnode, inv[n-1]);
+        }
+        FREE(inv);
+        if (maxnode >= 0 && (inv = db_InvertPerm(nodeperm, maxnode + 1, nnodes)) == NULL)
+            goto done;
+    }
+
+    if ((out = (int *) malloc(lnodelist * sizeof(int))) == NULL)
+        goto done;
+    for (j = pos = 0; j < nzones; j++)
+    {
+        int s, e;
+        z = zoneperm ? zoneperm[j] : j;
+        s = starts[z];
+        e = starts[z+1];
+        if (!inv)
+        {
+            memcpy(out + pos, nodelist + s, (e - s) * sizeof(int));
+            pos += e - s;
+        }
+        else if (shapetype && shapetype[blk[z]/3] == DB_ZONETYPE_POLYHEDRON)
+        {
+            int f, nf = nodelist[s++];
+            out[pos++] = nf;
+            for (f = 0; f < nf; f++)
+            {
+                int nn = nodelist[s++];
+                out[pos++] = nn;
+                for (i = 0; i < nn; i++)
+                    out[pos++] = inv[nodelist[s++] - origin] + origin;
+            }
+        }
+        else
+        {
+            for (i = s; i < e; i++)
+                out[pos++] = inv[nodelist[i] - origin] + origin;
+        }
+    }
+    if (lnodelist > pos)
+        memcpy(out + pos, nodelist + pos, (lnodelist - pos) * sizeof(int));
+
+done:
+    FREE(starts);
+    FREE(blk);
+    FREE(inv);
+    FREE(zinv);
+    return out;
+}
+
+/* Name of the array holding the permutation of the nodes or zones of NAME */
+static char *
+db_PermArrayName(char const *name, char const *what)
+{
+    char *retval = (char *) malloc(strlen(name) + strlen(what) + 8);
+    if (retval)
+        sprintf(retval, "%s_orig_%s", name, what);
+    return retval;
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutMultivar
+ * Function:    DBPutUcdmesh
  *
- * Purpose:     Writes a multi-block variable object to the database.
+ * Purpose:     Accepts pointers to the coordinate arrays and writes
+ *              the mesh into a UCD-mesh object in the database.
  *
- * Return:      Success:        object ID
+ * Return:      Success:        Object ID
  *
  *              Failure:        -1
  *
  * Programmer:  matzke@viper
- *              Tue Nov  8 12:26:30 PST 1994
+ *              Tue Nov  8 13:13:46 PST 1994
  *
  * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
  *    I replaced API_END with API_END_NOPOP.
  *
+ *    Sean Ahern, Mon Nov  2 17:51:55 PST 1998
+ *    Removed the requirement for a non-NULL coordnames parameter.
+ *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
  *
@@ -9288,49 +11841,136 @@ DBPutMultimeshadj(DBfile *dbfile, char const *name, int nmesh,
  *    Robb Matzke, 2000-05-23
  *    The old table of contents is discarded if the directory changes.
  *
- *    Mark C. Miller, Wed Jul 14 20:36:23 PDT 2010
- *    Added support for nameschemes on multi-block objects. This meant
- *    adjusting sanity checks for args as some can be null now.
+ *    Mark C. Miller, Thu Mar 26 12:40:20 PDT 2015
+ *    Add logic to support Kerbel's funky empty ucd mesh with a single
+ *    node and no zones.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBPutMultivar(DBfile *dbfile, const char *name, int nvar,
-              char const * const *varnames, int const *vartypes, DBoptlist const *optlist)
+DBPutUcdmesh(DBfile *dbfile, const char *name, int ndims,
+             char const * const *coordnames, DBVCP2_t coords, int nnodes,
+             int nzones, const char *zonel_name, const char *facel_name,
+             int datatype, DBoptlist const *optlist)
 {
     int retval;
+    char *zl_name;
+    int const *nodeperm;
+    void **pcoords = NULL, *bufs[3] = {NULL, NULL, NULL};
+    char *altname = NULL;
+    DBoptlist *popts = NULL;
 
-    API_BEGIN2("DBPutMultivar", int, -1, name) {
+    API_BEGIN2("DBPutUcdmesh", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutMultivar", E_GRABBED) ; 
+            API_ERROR("DBPutUcdmesh", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("multivar name", E_BADARGS);
+            API_ERROR("UCDmesh name", E_BADARGS);
         if (db_VariableNameValid(name) == 0)
-            API_ERROR("multivar name", E_INVALIDNAME);
+            API_ERROR("UCDmesh name", E_INVALIDNAME);
         if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
             API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nvar < 0)
-            API_ERROR("nvar", E_BADARGS);
-        if (nvar)
+        if (ndims < 0)
+            API_ERROR("ndims<0", E_BADARGS);
+        if (nnodes < 0)
+            API_ERROR("nnodes<0", E_BADARGS);
+        if (nnodes)
         {
-            if (!varnames && (!optlist ||
-                 (!DBGetOption(optlist, DBOPT_MB_FILE_NS) &&
-                  !DBGetOption(optlist, DBOPT_MB_BLOCK_NS))))
-                API_ERROR("varnames", E_BADARGS);
-            if (!vartypes && (!optlist ||
-                 !DBGetOption(optlist, DBOPT_MB_BLOCK_TYPE)))
-                API_ERROR("vartypes", E_BADARGS);
+            int i;
+            void **coords2 = (void**) coords;
+            if (nnodes > 1 && nzones <= 0)
+                API_ERROR("nzones<=0", E_BADARGS);
+            for (i = 0; i < ndims && coords; i++)
+                if (coords2[i] == 0) coords = 0;;
+            if (!coords)
+                API_ERROR("coords==0 || coords[i]==0", E_BADARGS);
+            if ((zl_name = (char*)DBGetOption(optlist, DBOPT_PHZONELIST)))
+            {
+                if (!zl_name || !*zl_name)
+                    API_ERROR("zonelist name specified with DBOPT_PHZONELIST is null or \"\"", E_BADARGS);
+                if (db_VariableNameValid(zl_name) == 0)
+                    API_ERROR("zonelist name specified with DBOPT_PHZONELIST", E_INVALIDNAME);
+            }
+            else if (zonel_name)
+            {
+                if (!*zonel_name)
+                    API_ERROR("zonel_name==\"\"", E_BADARGS);
+                if (db_VariableNameValid(zonel_name) == 0)
+                    API_ERROR("zonel_name", E_INVALIDNAME);
+            }
+            else if (facel_name)
+            {
+                if (!*facel_name)
+                    API_ERROR("facel_name==\"\"", E_BADARGS);
+                if (db_VariableNameValid(facel_name) == 0)
+                    API_ERROR("facel_name", E_INVALIDNAME);
+            }
+            else if (nzones > 0)
+            {
+                API_ERROR("no zonelist or facelist specified", E_BADARGS);
+            }
         }
         else if (!DBGetAllowEmptyObjectsFile(dbfile))
         {
-            /* this is an empty object but we don't know if it was intentional */
-            API_ERROR("nvar==0", E_EMPTYOBJECT);
+            /* this is an empty object but we don't know if it was intentional */
+            API_ERROR("ndims==0 || nnodes==0", E_EMPTYOBJECT);
+        }
+
+        if (!dbfile->pub.p_um)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        /* Store the nodes in the order given by DBOPT_NODE_PERM and keep
+           that order in an array named as an alternate node numbering */
+        if (nnodes > 0 && ndims > 0 &&
+            (nodeperm = (int const *) DBGetOption(optlist, DBOPT_NODE_PERM)))
+        {
+            int i, *inv = db_InvertPerm(nodeperm, nnodes, nnodes);
+            size_t size = (size_t) db_GetMachDataSize(datatype);
+
+            if (!inv)
+                API_ERROR("DBOPT_NODE_PERM", E_BADARGS);
+            FREE(inv);
+            if ((altname = db_PermArrayName(name, "nodenum")) == NULL)
+                API_ERROR(name, E_NOMEM);
+            if (DBWrite(dbfile, altname, (void *) nodeperm, &nnodes, 1, DB_INT) < 0)
+            {
+                FREE(altname);
+                API_ERROR("DBWrite", E_CALLFAIL);
+            }
+            pcoords = (void **) calloc(ndims, sizeof(void*));
+            for (i = 0; i < ndims && pcoords && size > 0; i++)
+                pcoords[i] = db_PermuteArray(((void const * const *) coords)[i],
+                                             nnodes, size, nodeperm);
+            if (pcoords && size > 0 && pcoords[ndims-1])
+                popts = db_PermuteOptlist(optlist, nnodes, nodeperm, DBOPT_NODENUM,
+                            DBOPT_GHOST_NODE_LABELS, DBOPT_ALT_NODENUM_VARS,
+                            altname, bufs);
+            if (!popts)
+            {
+                for (i = 0; i < ndims && pcoords; i++)
+                    FREE(pcoords[i]);
+                FREE(pcoords);
+                FREE(altname);
+                API_ERROR(name, E_NOMEM);
+            }
+            coords = (DBVCP2_t) pcoords;
+            optlist = popts;
+        }
+
+        retval = (dbfile->pub.p_um) (dbfile, name, ndims, coordnames,
+                                     coords, nnodes, nzones,
+                                     zonel_name, facel_name,
+                                     datatype, optlist);
+        if (popts)
+        {
+            int i;
+            for (i = 0; i < ndims; i++)
+                FREE(pcoords[i]);
+            FREE(pcoords);
+            for (i = 0; i < 3; i++)
+                FREE(bufs[i]);
+            DBFreeOptlist(popts);
+            FREE(altname);
         }
-        if (!dbfile->pub.p_mv)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
-
-        retval = (dbfile->pub.p_mv) (dbfile, name, nvar, varnames,
-                                     vartypes, optlist);
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
@@ -9338,75 +11978,56 @@ DBPutMultivar(DBfile *dbfile, const char *name, int nvar,
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutMultimat
+ * Function:    DBPutUcdsubmesh
  *
- * Purpose:     Writes a multi-material object to the database.
+ * Purpose:     Accepts names of parent mesh with coordinate arrays and writes
+ *              the mesh into a UCD-mesh object in the database.
  *
- * Return:      Success:        object ID
+ * Return:      Success:        Object ID
  *
  *              Failure:        -1
  *
- * Programmer:  matzke@viper
- *              Tue Feb 21 12:35:10 EST 1995
+ * Programmer:  reus@ferret
+ *              Wed Dec  9 15:17:00 PST 1998
  *
  * Modifications:
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
- *
  *    Robb Matzke, 2000-05-23
  *    The old table of contents is discarded if the directory changes.
- *
- *    Mark C. Miller, Wed Jul 14 20:36:23 PDT 2010
- *    Added support for nameschemes on multi-block objects. This meant
- *    adjusting sanity checks for args as some can be null now.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBPutMultimat(DBfile *dbfile, const char *name, int nmats,
-              char const * const *matnames, DBoptlist const *optlist)
+DBPutUcdsubmesh(DBfile *dbfile, const char *name, const char *parentmesh,
+                int nzones, const char *zonel_name, const char *facel_name,
+                DBoptlist const *optlist)
 {
     int retval;
 
-    API_BEGIN2("DBPutMultimat", int, -1, name) {
+    API_DEPRECATE2("DBPutUcdsubmesh", int, -1, name, 4, 6, "MRG Trees") {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutMultimat", E_GRABBED) ; 
+            API_ERROR("DBPutUcdsubmesh", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("multimat name", E_BADARGS);
+            API_ERROR("mesh name", E_BADARGS);
         if (db_VariableNameValid(name) == 0)
-            API_ERROR("multimat name", E_INVALIDNAME);
+            API_ERROR("mesh name", E_INVALIDNAME);
         if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
             API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nmats < 0)
-            API_ERROR("nmats", E_BADARGS);
-        if (nmats)
-        {
-            if (!matnames && (!optlist ||
-                 (!DBGetOption(optlist, DBOPT_MB_FILE_NS) && 
-                  !DBGetOption(optlist, DBOPT_MB_BLOCK_NS))))
-                API_ERROR("material-names", E_BADARGS);
-        }
-        else if (!DBGetAllowEmptyObjectsFile(dbfile))
-        {
-            /* this is an empty object but we don't know if it was intentional */
-            API_ERROR("nmats==0", E_EMPTYOBJECT);
-        }
-        if (!dbfile->pub.p_mt)
+        if (!parentmesh || !*parentmesh)
+            API_ERROR("parent mesh name", E_BADARGS);
+        if (db_VariableNameValid(parentmesh) == 0)
+            API_ERROR("parent mesh name", E_INVALIDNAME);
+        if (nzones < 0)
+            API_ERROR("nzones", E_BADARGS);
+        if (!dbfile->pub.p_sm)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.p_mt) (dbfile, name, nmats, matnames,
-                                     optlist);
-#ifndef _WIN32
-#warning BETTER PLACE TO NULL THESE
-#endif
-        /* Zero out the _mm._matnames pointer so we can't accidentially use it
-         * again. Likewise for matcolors. */
-        _mm._matnames = NULL;
-        _mm._matcolors = NULL;
 
+        retval = (dbfile->pub.p_sm) (dbfile, name, parentmesh,
+                                     nzones, zonel_name,
+                                     facel_name, optlist);
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
@@ -9414,18 +12035,28 @@ DBPutMultimat(DBfile *dbfile, const char *name, int nmats,
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutMultimatspecies
+ * Function:    DBPutUcdvar
  *
- * Purpose:     Writes a multi-material object to the database.
+ * Purpose:     Writes a variable associated with a UCD mesh into the
+ *              database.  Note that variables will be either node-centered
+ *              or zone-centered.  A UCD-var object contains the variable
+ *              values, plus the object ID of the associated UCD mesh.  Other
+ *              information can also be included.  This function is useful
+ *              for writing vector and tensor fields, wereas the companion
+ *              function, DBPutUcdvar1(), is appropriate for writing
+ *              scalar fields.
  *
- * Return:      Success:        object ID
+ * Return:      Success:        Object ID
  *
  *              Failure:        -1
  *
- * Programmer:  Jeremy S. Meredith
- *              Sept 17 1998
+ * Programmer:  robb@cloud
+ *              Wed Nov  9 12:02:56 EST 1994
  *
  * Modifications:
+ *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
+ *    I replaced API_END with API_END_NOPOP.
+ *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
  *
@@ -9435,51 +12066,114 @@ DBPutMultimat(DBfile *dbfile, const char *name, int nmats,
  *    Robb Matzke, 2000-05-23
  *    The old table of contents is discarded if the directory changes.
  *
- *    Mark C. Miller, Wed Jul 14 20:36:23 PDT 2010
- *    Added support for nameschemes on multi-block objects. This meant
- *    adjusting sanity checks for args as some can be null now.
+ *    Mark C. Miller, Wed Nov 11 09:19:20 PST 2009
+ *    Added check for valid centering.
+ *
+ *    Mark C. Miller, Thu Feb  4 11:28:55 PST 2010
+ *    Removed upper bound restriction on nvars.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBPutMultimatspecies(DBfile *dbfile, const char *name, int nspec,
-                     char const * const *specnames, DBoptlist const *optlist)
+DBPutUcdvar(DBfile *dbfile, const char *vname, const char *mname, int nvars,
+            char const * const *varnames, DBVCP2_t vars, int nels, DBVCP2_t mixvars,
+            int mixlen, int datatype, int centering, DBoptlist const *optlist)
 {
     int retval;
+    int const *perm = NULL;
+    void **pvars = NULL;
 
-    API_BEGIN2("DBPutMultimatspecies", int, -1, name) {
+    API_BEGIN2("DBPutUcdvar", int, -1, vname) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutMultimatspecies", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("multimatspecies name", E_BADARGS);
-        if (db_VariableNameValid(name) == 0)
-            API_ERROR("multimatspecies name", E_INVALIDNAME);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
+            API_ERROR("DBPutUcdvar", E_GRABBED) ; 
+        if (!vname || !*vname)
+            API_ERROR("UCDvar name", E_BADARGS);
+        if (db_VariableNameValid(vname) == 0)
+            API_ERROR("UCDvar name", E_INVALIDNAME);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, vname))
             API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nspec < 0)
-            API_ERROR("nspec", E_BADARGS);
-        if (nspec)
+        if (!mname || !*mname)
+            API_ERROR("UCDmesh name", E_BADARGS);
+        if (db_VariableNameValid(mname) == 0)
+            API_ERROR("UCDmesh name", E_INVALIDNAME);
+        if (nels < 0)
+            API_ERROR("nels<0", E_BADARGS);
+        if (nels)
         {
-            if (!specnames && (!optlist ||
-                 (!DBGetOption(optlist, DBOPT_MB_FILE_NS) && 
-                  !DBGetOption(optlist, DBOPT_MB_BLOCK_NS))))
-                API_ERROR("species-names", E_BADARGS);
+            int i;
+            void **vars2 = (void**) vars;
+            if (nvars <= 0)
+                API_ERROR("nvars<0", E_BADARGS);
+            for (i = 0; i < nvars && vars; i++)
+                if (vars2[i] == 0) vars = 0;
+            for (i = 0; i < nvars && varnames; i++)
+                if (!varnames[i] && !*varnames[i]) varnames = 0;
+            if (mixlen < 0)
+                API_ERROR("mixlen", E_BADARGS);
+            if (mixvars)
+            {
+                vars2 = (void**) mixvars;
+                for (i = 0; i < nvars && mixvars; i++)
+                    if (vars2[i] == 0) mixvars = 0;
+            }
+            if (!vars)
+                API_ERROR("vars=0 || vars[i]=0", E_BADARGS);
+            if (!varnames)
+                API_ERROR("varnames=0 || varnames[i]=0", E_BADARGS);
+            if (mixlen && !mixvars)
+                API_ERROR("mixvars=0 || mixvars[i]=0", E_BADARGS);
         }
         else if (!DBGetAllowEmptyObjectsFile(dbfile))
         {
             /* this is an empty object but we don't know if it was intentional */
-            API_ERROR("nspec==0", E_EMPTYOBJECT);
+            API_ERROR("nvars=0 || nels==0", E_EMPTYOBJECT);
         }
-        if (!dbfile->pub.p_mms)
+        if (centering != DB_NODECENT && centering != DB_ZONECENT &&
+            centering != DB_FACECENT && centering != DB_BNDCENT &&
+            centering != DB_EDGECENT && centering != DB_BLOCKCENT)
+            API_ERROR("centering", E_BADARGS);
+        if (!dbfile->pub.p_uv)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.p_mms) (dbfile, name, nspec, specnames, optlist);
-
-        /* Zero out the _ma._matnames pointer so we can't accidentially use it
-         * again. Likewise for matcolors. */
-        _mm._specnames = NULL;
-        _mm._speccolors = NULL;
+        /* Store the values in the order given by DBOPT_NODE_PERM or
+           DBOPT_ZONE_PERM, matching the mesh */
+        if (centering == DB_NODECENT)
+            perm = (int const *) DBGetOption(optlist, DBOPT_NODE_PERM);
+        else if (centering == DB_ZONECENT)
+            perm = (int const *) DBGetOption(optlist, DBOPT_ZONE_PERM);
+        if (nels > 0 && perm)
+        {
+            int i, *inv = db_InvertPerm(perm, nels, nels);
+            size_t size = (size_t) db_GetMachDataSize(datatype);
+
+            if (!inv)
+                API_ERROR(centering == DB_NODECENT ? "DBOPT_NODE_PERM" :
+                          "DBOPT_ZONE_PERM", E_BADARGS);
+            FREE(inv);
+            pvars = (void **) calloc(nvars, sizeof(void*));
+            for (i = 0; i < nvars && pvars && size > 0; i++)
+                pvars[i] = db_PermuteArray(((void const * const *) vars)[i],
+                                           nels, size, perm);
+            if (!pvars || size <= 0 || !pvars[nvars-1])
+            {
+                for (i = 0; i < nvars && pvars; i++)
+                    FREE(pvars[i]);
+                FREE(pvars);
+                API_ERROR(vname, E_NOMEM);
+            }
+            vars = (DBVCP2_t) pvars;
+        }
 
+        retval = (dbfile->pub.p_uv) (dbfile, vname, mname,
+                                     nvars, varnames, vars, nels, mixvars,
+                                     mixlen, datatype, centering, optlist);
+        if (pvars)
+        {
+            int i;
+            for (i = 0; i < nvars; i++)
+                FREE(pvars[i]);
+            FREE(pvars);
+        }
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
@@ -9487,71 +12181,40 @@ DBPutMultimatspecies(DBfile *dbfile, const char *name, int nspec,
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutPoinmesh
+ * Function:    DBPutUcdvar1
  *
- * Purpose:     Accepts pointers to the coordinate arrays and writes the
- *              mesh into the database.
+ * Purpose:     Same as DBPutUcdvar() except for scalar variables.
  *
- * Return:      Success:        object ID
+ * Return:      Success:        Object ID
  *
  *              Failure:        -1
  *
- * Programmer:  matzke@viper
- *              Tue Nov  8 12:32:43 PST 1994
+ * Programmer:  robb@cloud
+ *              Wed Nov  9 12:14:28 EST 1994
  *
  * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
  *    I replaced API_END with API_END_NOPOP.
  *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
- *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
- *
  *    Robb Matzke, 2000-05-23
  *    The old table of contents is discarded if the directory changes.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBPutPointmesh(DBfile *dbfile, const char *name, int ndims, DBVCP2_t coords,
-               int nels, int datatype, DBoptlist const *optlist)
+DBPutUcdvar1(DBfile *dbfile, const char *vname, const char *mname, void const *var,
+             int nels, void const *mixvar, int mixlen, int datatype, int centering,
+             DBoptlist const *optlist)
 {
-    int retval;
+    void const *vars[1] = {var};
+    void const *mixvars[1] = {mixvar};
+    char const *varnames[1] = {vname};
+    int            retval;
 
-    API_BEGIN2("DBPutPointmesh", int, -1, name) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutPointmesh", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("pointmesh name", E_BADARGS);
-        if (db_VariableNameValid(name) == 0)
-            API_ERROR("pointmesh name", E_INVALIDNAME);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
-            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nels < 0)
-            API_ERROR("nels<0", E_BADARGS);
-        if (nels > 0)
-        {
-            int i;
-            void **coords2 = (void**) coords;
-            if (ndims < 1 || ndims > 3)
-                API_ERROR("ndims < 1 || ndims > 3", E_BADARGS);
-            for (i = 0; i < ndims && coords; i++)
-                if (coords2[i] == 0) coords = 0;
-            if (!coords)
-                API_ERROR("coords=0 || coords[i]=0 for some i", E_BADARGS);
-        }
-        else if (!DBGetAllowEmptyObjectsFile(dbfile))
-        {
-            API_ERROR("nels==0", E_EMPTYOBJECT);
-        }
+    API_BEGIN2("DBPutUcdvar1", int, -1, vname)
+    {
 
-        if (!dbfile->pub.p_pm)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+        retval = DBPutUcdvar(dbfile, vname, mname, 1, varnames, vars,
+                     nels, mixvars, mixlen, datatype, centering, optlist);
 
-        retval = (dbfile->pub.p_pm) (dbfile, name, ndims, coords, nels,
-                                     datatype, optlist);
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
@@ -9559,17 +12222,18 @@ DBPutPointmesh(DBfile *dbfile, const char *name, int ndims, DBVCP2_t coords,
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutPointvar
+ * Function:    DBPutZonelist
  *
- * Purpose:     Accepts pointers to the value arrays and writes the
- *              variables into a point-variable object in the database.
+ * Purpose:     Writes a zonelist object into the open database.  The name
+ *              assigned to this object can in turn be used as the
+ *              `zonel_name' parameter to the DBPutUcdmesh() function.
  *
- * Return:      Success:        object ID
+ * Return:      Success:        0
  *
  *              Failure:        -1
  *
- * Programmer:  matzke@viper
- *              Tue Nov  8 12:38:22 PST 1994
+ * Programmer:  robb@cloud
+ *              Wed Nov  9 12:20:22 EST 1994
  *
  * Modifications:
  *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
@@ -9585,48 +12249,58 @@ DBPutPointmesh(DBfile *dbfile, const char *name, int ndims, DBVCP2_t coords,
  *    The old table of contents is discarded if the directory changes.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBPutPointvar(DBfile *dbfile, const char *vname, const char *mname, int nvars,
-              DBVCP2_t vars, int nels, int datatype, DBoptlist const *optlist)
+DBPutZonelist(DBfile *dbfile, const char *name, int nzones, int ndims,
+              int const *nodelist, int lnodelist, int origin, int const *shapesize,
+              int const *shapecnt, int nshapes)
 {
     int retval;
 
-    API_BEGIN2("DBPutPointvar", int, -1, vname) {
+    API_DEPRECATE2("DBPutZonelist", int, -1, name, 4, 6, "DBPutZonelist2()") {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutPointvar", E_GRABBED) ; 
-        if (!vname || !*vname)
-            API_ERROR("pointvar name", E_BADARGS);
-        if (db_VariableNameValid(vname) == 0)
-            API_ERROR("pointvar name", E_INVALIDNAME);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, vname))
+            API_ERROR("DBPutZonelist", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("zonelist name", E_BADARGS);
+        if (db_VariableNameValid(name) == 0)
+            API_ERROR("zonelist name", E_INVALIDNAME);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
             API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nels < 0)
-            API_ERROR("nels<0", E_BADARGS);
-        if (nels)
+        if (nzones < 0)
+            API_ERROR("nzones", E_BADARGS);
+        if (nzones)
         {
-            int i;
-            void **vars2 = (void**) vars;
-            if (nvars <= 0)
-                API_ERROR("nvars<=0", E_BADARGS);
-            for (i = 0; i < nvars && vars; i++)
-                if (!vars2[i]) vars = 0;
-            if (!vars) API_ERROR("vars==0 || vars[i]==0", E_BADARGS);
-            if (!mname || !*mname)
-                API_ERROR("pointmesh name", E_BADARGS);
-            if (db_VariableNameValid(mname) == 0)
-                API_ERROR("pointmesh name", E_INVALIDNAME);
+            if (ndims <= 0)
+                API_ERROR("ndims<=0", E_BADARGS);
+            if (lnodelist <= 0)
+                API_ERROR("lnodelist<=", E_BADARGS);
+            if (!nodelist)
+                API_ERROR("nodelist=0", E_BADARGS);
+            if (0 != origin && 1 != origin)
+                API_ERROR("origin!=0||1", E_BADARGS);
+            if (nshapes <= 0)
+                API_ERROR("nshapes<=0", E_BADARGS);
+            if (!shapesize)
+                API_ERROR("shapesize=0", E_BADARGS);
+            if (!shapecnt)
+                API_ERROR("shapecnt=0", E_BADARGS);
         }
         else if (!DBGetAllowEmptyObjectsFile(dbfile))
         {
-            API_ERROR("nels=0", E_EMPTYOBJECT);
+            /* this is an empty object but we don't know if it was intentional */
+            API_ERROR("nzones=0", E_EMPTYOBJECT);
         }
-
-        if (!dbfile->pub.p_pv)
+        else
+        {
+            lnodelist = 0;
+            nshapes = 0;
+        }
+        if (!dbfile->pub.p_zl)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.p_pv) (dbfile, vname, mname,
-                                     nvars, vars, nels, datatype, optlist);
+        retval = (dbfile->pub.p_zl) (dbfile, name, nzones, ndims,
+                                     nodelist, lnodelist, origin, shapesize,
+                                     shapecnt, nshapes);
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
@@ -9634,35 +12308,143 @@ DBPutPointvar(DBfile *dbfile, const char *vname, const char *mname, int nvars,
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutPointvar1
+ * Function:    DBPutZonelist2
  *
- * Purpose:     Same as DBPutPointvar except only one variable at a time.
+ * Purpose:     Writes a zonelist object into the open database.  The name
+ *              assigned to this object can in turn be used as the
+ *              `zonel_name' parameter to the DBPutUcdmesh() function.
  *
- * Return:      Success:        Object ID
+ * Return:      Success:        0
  *
  *              Failure:        -1
  *
- * Programmer:  matzke@viper
- *              Tue Nov  8 12:46:01 PST 1994
+ * Programmer:  brugger@kickit
+ *              Tue Mar 30 10:41:12 PST 1999
  *
  * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
+ *    Jeremy Meredith, Fri May 21 10:04:25 PDT 1999
+ *    Added an option list to the arguments and to the call to p_zl2().
+ *
+ *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
+ *    Added a check for variable name validity.
+ *
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
  *
  *    Robb Matzke, 2000-05-23
  *    The old table of contents is discarded if the directory changes.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBPutPointvar1(DBfile *dbfile, const char *vname, const char *mname,
-               DBVCP1_t var, int nels, int datatype, DBoptlist const *optlist)
+DBPutZonelist2(DBfile *dbfile, const char *name, int nzones, int ndims,
+               int const *nodelist, int lnodelist, int origin, int lo_offset,
+               int hi_offset, int const *shapetype, int const *shapesize, int const *shapecnt,
+               int nshapes, DBoptlist const *optlist)
 {
-    DBVCP1_t vars[1] = {var};
-    int retval;
+    int retval, nnodes = 0;
+    int const *nodeperm, *zoneperm;
+    int *pnodelist = NULL;
+    void *bufs[3] = {NULL, NULL, NULL};
+    char *altname = NULL;
+    DBoptlist *popts = NULL;
 
-    API_BEGIN2("DBPutPointvar1", int, -1, vname)
-    {
-        retval = DBPutPointvar(dbfile, vname, mname, 1, vars,
-                               nels, datatype, optlist);
+    API_BEGIN2("DBPutZonelist2", int, -1, name) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBPutZonelist2", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("zonelist name", E_BADARGS);
+        if (db_VariableNameValid(name) == 0)
+            API_ERROR("zonelist name", E_INVALIDNAME);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
+            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
+        if (nzones < 0)
+            API_ERROR("nzones", E_BADARGS);
+        if (nzones)
+        {
+            if (ndims <= 0)
+                API_ERROR("ndims<=0", E_BADARGS);
+            if (lnodelist <= 0)
+                API_ERROR("lnodelist<=0", E_BADARGS);
+            if (nshapes <= 0)
+                API_ERROR("nshapes<=0", E_BADARGS);
+            if (!nodelist)
+                API_ERROR("nodelist=0", E_BADARGS);
+            if (!shapetype)
+                API_ERROR("shapetype=0", E_BADARGS);
+            if (!shapesize)
+                API_ERROR("shapesize=0", E_BADARGS);
+            if (!shapecnt)
+                API_ERROR("shapecnt=0", E_BADARGS);
+            if (0 != origin && 1 != origin)
+                API_ERROR("origin!=0||1", E_BADARGS);
+            if (lo_offset < 0)
+                API_ERROR("lo_offset<0", E_BADARGS);
+            if (hi_offset < 0)
+                API_ERROR("hi_offset<0", E_BADARGS);
+#ifndef _MSC_VER
+#warning HI AND LO OFFSET NOT VALID IN PRESENCE OF EXPLICIT GHOST LABELS
+#endif
+        }
+        else if (!DBGetAllowEmptyObjectsFile(dbfile))
+        {
+            /* this is an empty object but we don't know if it was intentional */
+            API_ERROR("nzones=0", E_EMPTYOBJECT);
+        }
+        else
+        {
+            lnodelist = 0;
+            nshapes = 0;
+        }
+        if (!dbfile->pub.p_zl2)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+
+        /* Renumber the nodes by DBOPT_NODE_PERM and store the zones in the
+           order given by DBOPT_ZONE_PERM, keeping that order in an array
+           named as an alternate zone numbering */
+        nodeperm = (int const *) DBGetOption(optlist, DBOPT_NODE_PERM);
+        zoneperm = (int const *) DBGetOption(optlist, DBOPT_ZONE_PERM);
+        if (nodeperm && DBGetOption(optlist, DBOPT_NNODES))
+            nnodes = *((int const *) DBGetOption(optlist, DBOPT_NNODES));
+        if (nodeperm && nnodes <= 0)
+            API_ERROR("DBOPT_NODE_PERM without DBOPT_NNODES", E_BADARGS);
+        if (nzones > 0 && (nodeperm || zoneperm))
+        {
+            pnodelist = db_PermuteZonelist(nzones, nodelist, lnodelist, origin,
+                            lo_offset, hi_offset, shapetype, shapesize, shapecnt,
+                            nshapes, nodeperm, nnodes, zoneperm);
+            if (!pnodelist)
+                API_ERROR("DBOPT_NODE_PERM or DBOPT_ZONE_PERM", E_BADARGS);
+            if (zoneperm)
+            {
+                if ((altname = db_PermArrayName(name, "zonenum")) == NULL ||
+                    DBWrite(dbfile, altname, (void *) zoneperm, &nzones, 1, DB_INT) < 0 ||
+                    (popts = db_PermuteOptlist(optlist, nzones, zoneperm, DBOPT_ZONENUM,
+                                 DBOPT_GHOST_ZONE_LABELS, DBOPT_ALT_ZONENUM_VARS,
+                                 altname, bufs)) == NULL)
+                {
+                    FREE(pnodelist);
+                    FREE(altname);
+                    API_ERROR(name, E_CALLFAIL);
+                }
+                optlist = popts;
+            }
+            nodelist = pnodelist;
+        }
+
+        retval = (dbfile->pub.p_zl2) (dbfile, name, nzones, ndims,
+                                      nodelist, lnodelist, origin, lo_offset,
+                                      hi_offset, shapetype, shapesize,
+                                      shapecnt, nshapes, optlist);
+        if (popts)
+        {
+            int i;
+            for (i = 0; i < 3; i++)
+                FREE(bufs[i]);
+            DBFreeOptlist(popts);
+        }
+        FREE(altname);
+        FREE(pnodelist);
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
@@ -9670,89 +12452,86 @@ DBPutPointvar1(DBfile *dbfile, const char *vname, const char *mname,
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutQuadmesh
+ * Function:    DBPutPHZonelist 
  *
- * Purpose:     Accepts pointers to the coordinate arrays and writes the
- *              mesh into a quad-mesh object in the database.
+ * Purpose:     Writes a polyhedral zonelist object into the open database.
+ *              The name assigned to this object can in turn be used as the
+ *              parameter to a DBOPT_PHZONELIST option in the optlist passed to
+ *              the DBPutUcdmesh() function.
  *
- * Return:      Success:        Object ID
+ * Return:      Success:        0
  *
  *              Failure:        -1
  *
- * Programmer:  matzke@viper
- *              Tue Nov  8 12:50:40 PST 1994
- *
- * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
- *
- *    Sean Ahern, Mon Nov  2 17:51:55 PST 1998
- *    Removed the requirement for a non-NULL coordnames parameter.
- *
- *    Sean Ahern, Wed Mar 17 10:12:39 PST 1999
- *    Added a check for the coordtype.  It must be DB_COLLINEAR or
- *    DB_NONCOLLINEAR.
- *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
- *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
+ * Programmer:  Mark C. Miller
+ *              Tuesday, July 26, 2004 
  *
- *    Robb Matzke, 2000-05-23
- *    The old table of contents is discarded if the directory changes.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBPutQuadmesh(DBfile *dbfile, const char *name, char const * const *coordnames,
-              DBVCP2_t coords, int const *dims, int ndims, int datatype,
-              int coordtype, DBoptlist const *optlist)
+DBPutPHZonelist(DBfile *dbfile, const char *name,
+    int nfaces, int const *nodecnt, int lnodelist, int const *nodelist,
+    const char *extface, int nzones, int const *facecnt, int lfacelist,
+    int const *facelist, int origin, int lo_offset, int hi_offset,
+    DBoptlist const *optlist) 
 {
-    int i, retval, is_empty=1;
+    int retval;
+
+    API_BEGIN2("DBPutPHZonelist", int, -1, name) {
 
-    API_BEGIN2("DBPutQuadmesh", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutQuadmesh", E_GRABBED) ; 
+            API_ERROR("DBPutPHZonelist", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("quadmesh name", E_BADARGS);
+            API_ERROR("zonelist name", E_BADARGS);
         if (db_VariableNameValid(name) == 0)
-            API_ERROR("quadmesh name", E_INVALIDNAME);
+            API_ERROR("zonelist name", E_INVALIDNAME);
         if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
             API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if ((coordtype != DB_COLLINEAR) && (coordtype != DB_NONCOLLINEAR))
-            API_ERROR("coordtype must be DB_COLLINEAR or DB_NONCOLLINEAR", E_BADARGS);
-        if (ndims < 0)
-            API_ERROR("ndims", E_BADARGS);
-        if (!dims)
-            API_ERROR("dims==0", E_BADARGS);
-        for (i = 0; i < ndims; i++)
+        if (nfaces < 0)
+            API_ERROR("nfaces<0", E_BADARGS);
+        if (nfaces)
         {
-            if (dims[i] != 0)
+            if (0 != origin && 1 != origin)
+                API_ERROR("origin", E_BADARGS);
+            if (!nodecnt)
+                API_ERROR("nodecnt==0", E_BADARGS);
+            if (!lnodelist)
+                API_ERROR("lnodelist==0", E_BADARGS);
+            if (!nodelist)
+                API_ERROR("nodelist==0", E_BADARGS);
+            if (nzones < 0)
+                API_ERROR("nzones<0", E_BADARGS);
+            if (nzones)
             {
-                is_empty = 0;
-                break;
+                if ((lo_offset < 0) || (lo_offset >= nzones))
+                    API_ERROR("lo_offset", E_BADARGS);
+                if ((hi_offset < 0) || (hi_offset >= nzones))
+                    API_ERROR("hi_offset", E_BADARGS);
+                if (lo_offset > hi_offset)
+                    API_ERROR("hi_offset", E_BADARGS);
+                if (!facecnt)
+                    API_ERROR("facecnt==0", E_BADARGS);
+                if (!lfacelist)
+                    API_ERROR("lfacelist==0", E_BADARGS);
+                if (!facelist)
+                    API_ERROR("facelist==0", E_BADARGS);
             }
         }
-        if (!is_empty)
-        {
-            void **coords2 = (void**) coords;
-            for (i = 0; i < ndims && coords; i++)
-                if (!coords2[i]) coords = 0;
-            if (!coords)
-                API_ERROR("coords==0 || coords[i]==0", E_BADARGS);
-        }
         else if (!DBGetAllowEmptyObjectsFile(dbfile))
         {
-            /* this is an empty object but we don't think it was intentional */
-            API_ERROR("dims[i]==0 for all i", E_EMPTYOBJECT);
+            /* this is an empty object but we don't know if it was intentional */
+            API_ERROR("nfaces==0", E_EMPTYOBJECT);
         }
-        if (!dbfile->pub.p_qm)
+        if (!dbfile->pub.p_phzl)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.p_qm) (dbfile, name, coordnames, coords,
-                                     dims, ndims, datatype, coordtype,
-                                     optlist);
+        retval = (dbfile->pub.p_phzl) (dbfile, name, nfaces, nodecnt,
+                                       lnodelist, nodelist, extface,
+                                       nzones, facecnt, lfacelist, facelist,
+                                       origin, lo_offset, hi_offset,
+                                       optlist);
+
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
@@ -9760,116 +12539,67 @@ DBPutQuadmesh(DBfile *dbfile, const char *name, char const * const *coordnames,
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutQuadvar
+ * Function:    DBPutCsgmesh
  *
- * Purpose:     Writes a variable associated with a quad mesh into a
- *              database. Variables will be either node-centered or zone-
- *              centered.
+ * Purpose:     Writes a CSG (Constructive Solid Geometry) mesh object to
+ *              a silo database.
  *
  * Return:      Success:        Object ID
  *
  *              Failure:        -1
  *
- * Programmer:  matzke@viper
- *              Tue Nov  8 12:57:08 PST 1994
- *
- * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
- *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
- *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
- *
- *    Robb Matzke, 2000-05-23
- *    The old table of contents is discarded if the directory changes.
- *
- *    Mark C. Miller, Wed Nov 11 09:19:20 PST 2009
- *    Added check for valid centering.
- *
- *    Mark C. Miller, Thu Feb  4 11:29:35 PST 2010
- *    Removed upper bound restriction for nvars.
+ * Programmer:  Mark C. Miller
+ *              Wed Jul 27 14:22:03 PDT 2005 
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBPutQuadvar(DBfile *dbfile, const char *vname, const char *mname, int nvars,
-             char const * const *varnames, DBVCP2_t vars, int const *dims, int ndims,
-             DBVCP2_t mixvars, int mixlen, int datatype, int centering,
-             DBoptlist const *optlist)
+DBPutCsgmesh(DBfile *dbfile, const char *name, int ndims,
+             int nbounds,
+             const int *typeflags, const int *bndids/*optional*/,
+             const void *coeffs, int lcoeffs, int datatype,
+             const double *extents, const char *zonel_name, DBoptlist const *optlist)
 {
-    int i, retval, is_empty = 1;
+    int retval;
 
-    API_BEGIN2("DBPutQuadvar", int, -1, vname) {
+    API_BEGIN2("DBPutCsgmesh", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutQuadvar", E_GRABBED) ; 
-        if (!vname || !*vname)
-            API_ERROR("quadvar name", E_BADARGS);
-        if (db_VariableNameValid(vname) == 0)
-            API_ERROR("quadvar name", E_INVALIDNAME);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, vname))
+            API_ERROR("DBPutCsgmesh", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("CSGmesh name", E_BADARGS);
+        if (db_VariableNameValid(name) == 0)
+            API_ERROR("CSGmesh name", E_INVALIDNAME);
+        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
             API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (!mname || !*mname)
-            API_ERROR("quadmesh name", E_BADARGS);
-        if (db_VariableNameValid(mname) == 0)
-            API_ERROR("quadmesh name", E_INVALIDNAME);
-        if (ndims < 0)
-            API_ERROR("ndims", E_BADARGS);
-        if (!dims)
-            API_ERROR("dims==0", E_BADARGS);
-        for (i = 0; i < ndims; i++)
-        {
-            if (dims[i] != 0)
-            {
-                is_empty = 0;
-                break;
-            }
-        }
-        if (!is_empty)
+        if (nbounds < 0)
+            API_ERROR("nbounds<0", E_BADARGS);
+        if (nbounds)
         {
-            int i;
-            void **vars2 = (void**) vars;
-            for (i = 0; i < ndims && dims; i++)
-                if (!dims[i]) dims = 0;
-            if (!dims)
-                API_ERROR("dims=0 || dims[i]=0", E_BADARGS);
-            if (nvars < 1)
-                API_ERROR("nvars<1", E_BADARGS);
-            for (i = 0; i < nvars && vars; i++)
-                if (!vars2[i]) vars = 0;
-            vars2 = (void**) mixvars;
-            for (i = 0; i < nvars && mixvars; i++)
-                if (!vars2[i]) mixvars = 0;
-            for (i = 0; i < nvars && varnames; i++)
-                if (!varnames[i] && !*varnames[i]) varnames = 0;
-            if (!vars)
-                API_ERROR("vars=0 || vars[i]=0", E_BADARGS);
-            if (!varnames)
-                API_ERROR("varnames=0 || varnames[i]=0||\"\"", E_BADARGS);
-            if (mixlen < 0)
-                API_ERROR("mixlen", E_BADARGS);
-            if (!mixvars && mixlen)
-                API_ERROR("mixvars", E_BADARGS);
+            if (ndims < 0)
+                API_ERROR("ndims<0", E_BADARGS);
+            if (lcoeffs < 0)
+                API_ERROR("lcoeffs<0", E_BADARGS);
+            if (!(ndims == 2 || ndims == 3))
+                API_ERROR("ndims must be either 2 or 3", E_BADARGS);
+            if (!typeflags) API_ERROR("typeflags==0", E_BADARGS);
+            if (!coeffs) API_ERROR("coeffs==0", E_BADARGS);
+            if (!extents) API_ERROR("extents==0", E_BADARGS);
+            if (!zonel_name || !*zonel_name) API_ERROR("zonel_name", E_BADARGS);
+            if (db_VariableNameValid(zonel_name) == 0)
+                API_ERROR("zonelist name", E_INVALIDNAME);
         }
         else if (!DBGetAllowEmptyObjectsFile(dbfile))
         {
-            /* this is an empty object but we don't think it was intentional */
-            API_ERROR("ndims=0", E_EMPTYOBJECT);
+            API_ERROR("nbounds==0 || ndims==0 || lcoeffs==0", E_EMPTYOBJECT);
         }
-        if (centering != DB_NODECENT && centering != DB_ZONECENT &&
-            centering != DB_FACECENT && centering != DB_BNDCENT &&
-            centering != DB_EDGECENT && centering != DB_BLOCKCENT)
-            API_ERROR("centering", E_BADARGS);
-        if (!dbfile->pub.p_qv)
+        if (!dbfile->pub.p_csgm)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-
-        retval = (dbfile->pub.p_qv) (dbfile, vname, mname,
-                                     nvars, varnames, vars, dims, ndims,
-                                     mixvars, mixlen, datatype, centering,
+        retval = (dbfile->pub.p_csgm) (dbfile, name, ndims,
+                                     nbounds, typeflags, bndids, coeffs,
+                                     lcoeffs, datatype, extents, zonel_name,
                                      optlist);
+
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
@@ -9877,153 +12607,110 @@ DBPutQuadvar(DBfile *dbfile, const char *vname, const char *mname, int nvars,
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutQuadvar1
- *
- * Purpose:     Same as DBPutQuadvar except for scalar variables.
+ * Function:    DBGetCsgmesh
  *
- * Return:      Success:        Object ID
+ * Purpose:     Allocates a DBcsgmesh data structure and reads a CSG mesh
+ *              from the data file.
  *
- *              Failure:        -1
+ * Return:      Success:        Pointer to the new DBcsgmesh struct
  *
- * Programmer:  matzke@viper
- *              Tue Nov  8 13:07:45 PST 1994
+ *              Failure:        NULL
  *
- * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
+ * Programmer:  Mark C. Miller 
+ *              Wed Jul 27 14:22:03 PDT 2005 
  *
- *    Robb Matzke, 2000-05-23
- *    The old table of contents is discarded if the directory changes.
  *-------------------------------------------------------------------------*/
-PUBLIC int
-DBPutQuadvar1(DBfile *dbfile, const char *vname, const char *mname, void const *var,
-              int const *dims, int ndims, void const *mixvar, int mixlen, int datatype,
-              int centering, DBoptlist const *optlist)
+PUBLIC DBcsgmesh *
+DBGetCsgmesh(DBfile *dbfile, const char *name)
 {
-    char const *varnames[1] = {vname};
-    void const *vars[1] = {var};
-    void const *mixvars[1] = {mixvar};
-    int retval;
-
-    API_BEGIN2("DBPutQuadvar1", int, -1, vname) {
-
-        retval = DBPutQuadvar(dbfile, vname, mname, 1,
-                              varnames, vars, dims, ndims,
-                              mixvars, mixlen,
-                              datatype, centering, optlist);
+    DBcsgmesh     *csgm = NULL;
 
-        db_FreeToc(dbfile);
-        API_RETURN(retval);
+    API_BEGIN2("DBGetCsgmesh", DBcsgmesh *, NULL, name) {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (SILO_Globals.enableGrabDriver == TRUE)
+            API_ERROR("DBGetCsgmesh", E_GRABBED) ; 
+        if (!name || !*name)
+            API_ERROR("CSGmesh name", E_BADARGS);
+        if (!dbfile->pub.g_csgm)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
+        db_alloc_begin(dbfile);
+        csgm = ((dbfile->pub.g_csgm) (dbfile, name));
+        db_alloc_end(DB_CSGMESH, csgm);
+        if (!csgm)
+        {
+            API_RETURN(NULL);
+        }
+        API_RETURN(csgm);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutUcdmesh
+ * Function:    DBPutCSGZonelist
  *
- * Purpose:     Accepts pointers to the coordinate arrays and writes
- *              the mesh into a UCD-mesh object in the database.
+ * Purpose:     Writes a CSG zonelist object into the open database.
+ *              The name assigned to this object can in turn be used as the
+ *              `zonel_name' parameter to the DBPutCsgmesh() function.
  *
- * Return:      Success:        Object ID
+ * Return:      Success:        0
  *
  *              Failure:        -1
  *
- * Programmer:  matzke@viper
- *              Tue Nov  8 13:13:46 PST 1994
- *
- * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
- *
- *    Sean Ahern, Mon Nov  2 17:51:55 PST 1998
- *    Removed the requirement for a non-NULL coordnames parameter.
- *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
- *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
- *
- *    Robb Matzke, 2000-05-23
- *    The old table of contents is discarded if the directory changes.
- *
- *    Mark C. Miller, Thu Mar 26 12:40:20 PDT 2015
- *    Add logic to support Kerbel's funky empty ucd mesh with a single
- *    node and no zones.
+ * Programmer:  Mark C. Miller 
+ *              Wed Jul 27 14:22:03 PDT 2005
  *-------------------------------------------------------------------------*/
+
 PUBLIC int
-DBPutUcdmesh(DBfile *dbfile, const char *name, int ndims,
-             char const * const *coordnames, DBVCP2_t coords, int nnodes,
-             int nzones, const char *zonel_name, const char *facel_name,
-             int datatype, DBoptlist const *optlist)
+DBPutCSGZonelist(DBfile *dbfile, const char *name, int nregs,
+                 const int *typeflags,
+                 const int *leftids, const int *rightids,
+                 const void *xforms, int lxforms, int datatype,
+                 int nzones, const int *zonelist, DBoptlist const *optlist)
 {
     int retval;
-    char *zl_name;
 
-    API_BEGIN2("DBPutUcdmesh", int, -1, name) {
+    API_BEGIN2("DBPutCSGZonelist", int, -1, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutUcdmesh", E_GRABBED) ; 
+            API_ERROR("DBPutCSGZonelist", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("UCDmesh name", E_BADARGS);
+            API_ERROR("zonelist name", E_BADARGS);
         if (db_VariableNameValid(name) == 0)
-            API_ERROR("UCDmesh name", E_INVALIDNAME);
+            API_ERROR("zonelist name", E_INVALIDNAME);
         if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
             API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (ndims < 0)
-            API_ERROR("ndims<0", E_BADARGS);
-        if (nnodes < 0)
-            API_ERROR("nnodes<0", E_BADARGS);
-        if (nnodes)
+        if (nzones)
         {
-            int i;
-            void **coords2 = (void**) coords;
-            if (nnodes > 1 && nzones <= 0)
-                API_ERROR("nzones<=0", E_BADARGS);
-            for (i = 0; i < ndims && coords; i++)
-                if (coords2[i] == 0) coords = 0;;
-            if (!coords)
-                API_ERROR("coords==0 || coords[i]==0", E_BADARGS);
-            if ((zl_name = (char*)DBGetOption(optlist, DBOPT_PHZONELIST)))
-            {
-                if (!zl_name || !*zl_name)
-                    API_ERROR("zonelist name specified with DBOPT_PHZONELIST is null or \"\"", E_BADARGS);
-                if (db_VariableNameValid(zl_name) == 0)
-                    API_ERROR("zonelist name specified with DBOPT_PHZONELIST", E_INVALIDNAME);
-            }
-            else if (zonel_name)
-            {
-                if (!*zonel_name)
-                    API_ERROR("zonel_name==\"\"", E_BADARGS);
-                if (db_VariableNameValid(zonel_name) == 0)
-                    API_ERROR("zonel_name", E_INVALIDNAME);
-            }
-            else if (facel_name)
-            {
-                if (!*facel_name)
-                    API_ERROR("facel_name==\"\"", E_BADARGS);
-                if (db_VariableNameValid(facel_name) == 0)
-                    API_ERROR("facel_name", E_INVALIDNAME);
-            }
-            else if (nzones > 0)
-            {
-                API_ERROR("no zonelist or facelist specified", E_BADARGS);
-            }
+            if (nregs < 0)
+                API_ERROR("nregs", E_BADARGS);
+            if (nzones < 0)
+                API_ERROR("nzones", E_BADARGS);
+            if (!typeflags)
+                API_ERROR("typeflags", E_BADARGS);
+            if (!leftids)
+                API_ERROR("leftids", E_BADARGS);
+            if (!rightids)
+                API_ERROR("rightids", E_BADARGS);
+            if (!zonelist)
+                API_ERROR("zonelist", E_BADARGS);
+            if ((xforms && lxforms <= 0) || (!xforms && lxforms > 0))
+                API_ERROR("xforms and lxforms", E_BADARGS);
         }
         else if (!DBGetAllowEmptyObjectsFile(dbfile))
         {
             /* this is an empty object but we don't know if it was intentional */
-            API_ERROR("ndims==0 || nnodes==0", E_EMPTYOBJECT);
+            API_ERROR("nregs==0 || nzones==0", E_EMPTYOBJECT);
         }
 
-        if (!dbfile->pub.p_um)
+        if (!dbfile->pub.p_csgzl)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.p_um) (dbfile, name, ndims, coordnames,
-                                     coords, nnodes, nzones,
-                                     zonel_name, facel_name,
-                                     datatype, optlist);
+        retval = (dbfile->pub.p_csgzl) (dbfile, name, nregs,
+                                        typeflags, leftids, rightids,
+                                        xforms, lxforms, datatype, 
+                                        nzones, zonelist, optlist);
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
@@ -10031,205 +12718,107 @@ DBPutUcdmesh(DBfile *dbfile, const char *name, int ndims,
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutUcdsubmesh
- *
- * Purpose:     Accepts names of parent mesh with coordinate arrays and writes
- *              the mesh into a UCD-mesh object in the database.
+ * Function:    DBGetCSGZonelist
  *
- * Return:      Success:        Object ID
+ * Purpose:     Allocate and read a DBcsgzonelist structure.
  *
- *              Failure:        -1
+ * Return:      Success:        ptr to new DBcsgzonelist.
  *
- * Programmer:  reus@ferret
- *              Wed Dec  9 15:17:00 PST 1998
+ *              Failure:        NULL
  *
- * Modifications:
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
+ * Programmer:  Mark C. Miller 
+ *              Wed Jul 27 14:22:03 PDT 2005
  *
- *    Robb Matzke, 2000-05-23
- *    The old table of contents is discarded if the directory changes.
  *-------------------------------------------------------------------------*/
-PUBLIC int
-DBPutUcdsubmesh(DBfile *dbfile, const char *name, const char *parentmesh,
-                int nzones, const char *zonel_name, const char *facel_name,
-                DBoptlist const *optlist)
+PUBLIC DBcsgzonelist*
+DBGetCSGZonelist(DBfile *dbfile, const char *name)
 {
-    int retval;
+    DBcsgzonelist * retval = NULL;
 
-    API_DEPRECATE2("DBPutUcdsubmesh", int, -1, name, 4, 6, "MRG Trees") {
+    API_BEGIN2("DBGetCSGZonelist", DBcsgzonelist *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutUcdsubmesh", E_GRABBED) ; 
+            API_ERROR("DBGetCSGZonelist", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("mesh name", E_BADARGS);
-        if (db_VariableNameValid(name) == 0)
-            API_ERROR("mesh name", E_INVALIDNAME);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
-            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (!parentmesh || !*parentmesh)
-            API_ERROR("parent mesh name", E_BADARGS);
-        if (db_VariableNameValid(parentmesh) == 0)
-            API_ERROR("parent mesh name", E_INVALIDNAME);
-        if (nzones < 0)
-            API_ERROR("nzones", E_BADARGS);
-        if (!dbfile->pub.p_sm)
+            API_ERROR("CSG zonelist name", E_BADARGS);
+        if (!dbfile->pub.g_csgzl)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-
-        retval = (dbfile->pub.p_sm) (dbfile, name, parentmesh,
-                                     nzones, zonel_name,
-                                     facel_name, optlist);
-        db_FreeToc(dbfile);
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_csgzl) (dbfile, name);
+        db_alloc_end(DB_CSGZONELIST, retval);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutUcdvar
+ * Function:    DBPutCsgvar
  *
- * Purpose:     Writes a variable associated with a UCD mesh into the
- *              database.  Note that variables will be either node-centered
- *              or zone-centered.  A UCD-var object contains the variable
- *              values, plus the object ID of the associated UCD mesh.  Other
- *              information can also be included.  This function is useful
- *              for writing vector and tensor fields, wereas the companion
- *              function, DBPutUcdvar1(), is appropriate for writing
- *              scalar fields.
+ * Purpose:     Writes a variable associated with a CSG mesh into the
+ *              database.  Note that variables will be either
+ *              boundary-centered or zone-centered. A CSG-var object
+ *              contains the variable values, plus the object ID of the
+ *              associated CSG mesh.  Other information can also be included.
  *
  * Return:      Success:        Object ID
  *
  *              Failure:        -1
  *
- * Programmer:  robb@cloud
- *              Wed Nov  9 12:02:56 EST 1994
- *
- * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
- *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
- *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
- *
- *    Robb Matzke, 2000-05-23
- *    The old table of contents is discarded if the directory changes.
- *
- *    Mark C. Miller, Wed Nov 11 09:19:20 PST 2009
- *    Added check for valid centering.
+ * Programmer:  Mark C. Miller 
+ *              Wed Jul 27 14:22:03 PDT 2005 
  *
- *    Mark C. Miller, Thu Feb  4 11:28:55 PST 2010
- *    Removed upper bound restriction on nvars.
  *-------------------------------------------------------------------------*/
 PUBLIC int
-DBPutUcdvar(DBfile *dbfile, const char *vname, const char *mname, int nvars,
-            char const * const *varnames, DBVCP2_t vars, int nels, DBVCP2_t mixvars,
-            int mixlen, int datatype, int centering, DBoptlist const *optlist)
+DBPutCsgvar(DBfile *dbfile, const char *vname, const char *meshname,
+            int nvars, char const * const *varnames, DBVCP2_t _vars,
+            int nvals, int datatype, int centering, DBoptlist const *optlist)
 {
     int retval;
+    void const * const *vars = (void const * const *) _vars;
 
-    API_BEGIN2("DBPutUcdvar", int, -1, vname) {
+    API_BEGIN2("DBPutCsgvar", int, -1, vname) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutUcdvar", E_GRABBED) ; 
+            API_ERROR("DBPutCsgvar", E_GRABBED) ; 
         if (!vname || !*vname)
-            API_ERROR("UCDvar name", E_BADARGS);
+            API_ERROR("CSGvar name", E_BADARGS);
         if (db_VariableNameValid(vname) == 0)
-            API_ERROR("UCDvar name", E_INVALIDNAME);
+            API_ERROR("CSGvar name", E_INVALIDNAME);
         if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, vname))
             API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (!mname || !*mname)
-            API_ERROR("UCDmesh name", E_BADARGS);
-        if (db_VariableNameValid(mname) == 0)
-            API_ERROR("UCDmesh name", E_INVALIDNAME);
-        if (nels < 0)
-            API_ERROR("nels<0", E_BADARGS);
-        if (nels)
+        if (nvals < 0)
+            API_ERROR("nvals<0", E_BADARGS);
+        if (nvals)
         {
             int i;
-            void **vars2 = (void**) vars;
+            if (!meshname || !*meshname)
+                API_ERROR("CSGmesh name", E_BADARGS);
             if (nvars <= 0)
                 API_ERROR("nvars<0", E_BADARGS);
+            if (db_VariableNameValid(meshname) == 0)
+                API_ERROR("CSGmesh name", E_INVALIDNAME);
             for (i = 0; i < nvars && vars; i++)
-                if (vars2[i] == 0) vars = 0;
+                if (!vars[i]) vars = 0;
             for (i = 0; i < nvars && varnames; i++)
                 if (!varnames[i] && !*varnames[i]) varnames = 0;
-            if (mixlen < 0)
-                API_ERROR("mixlen", E_BADARGS);
-            if (mixvars)
-            {
-                vars2 = (void**) mixvars;
-                for (i = 0; i < nvars && mixvars; i++)
-                    if (vars2[i] == 0) mixvars = 0;
-            }
-            if (!vars)
-                API_ERROR("vars=0 || vars[i]=0", E_BADARGS);
-            if (!varnames)
-                API_ERROR("varnames=0 || varnames[i]=0", E_BADARGS);
-            if (mixlen && !mixvars)
-                API_ERROR("mixvars=0 || mixvars[i]=0", E_BADARGS);
+            if (!vars) API_ERROR("vars==0 || vars[i]==0", E_BADARGS);
+            if (!varnames) API_ERROR("varnames==0 || varnames[i]==0", E_BADARGS);
+            if (!(centering == DB_ZONECENT || centering == DB_BNDCENT)) 
+                API_ERROR("centering", E_BADARGS);
         }
         else if (!DBGetAllowEmptyObjectsFile(dbfile))
         {
-            /* this is an empty object but we don't know if it was intentional */
-            API_ERROR("nvars=0 || nels==0", E_EMPTYOBJECT);
+            API_ERROR("nvars=0 || nvals=0", E_EMPTYOBJECT);
         }
-        if (centering != DB_NODECENT && centering != DB_ZONECENT &&
-            centering != DB_FACECENT && centering != DB_BNDCENT &&
-            centering != DB_EDGECENT && centering != DB_BLOCKCENT)
-            API_ERROR("centering", E_BADARGS);
-        if (!dbfile->pub.p_uv)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
-
-        retval = (dbfile->pub.p_uv) (dbfile, vname, mname,
-                                     nvars, varnames, vars, nels, mixvars,
-                                     mixlen, datatype, centering, optlist);
-        db_FreeToc(dbfile);
-        API_RETURN(retval);
-    }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
-}
-
-/*-------------------------------------------------------------------------
- * Function:    DBPutUcdvar1
- *
- * Purpose:     Same as DBPutUcdvar() except for scalar variables.
- *
- * Return:      Success:        Object ID
- *
- *              Failure:        -1
- *
- * Programmer:  robb@cloud
- *              Wed Nov  9 12:14:28 EST 1994
- *
- * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
- *
- *    Robb Matzke, 2000-05-23
- *    The old table of contents is discarded if the directory changes.
- *-------------------------------------------------------------------------*/
-PUBLIC int
-DBPutUcdvar1(DBfile *dbfile, const char *vname, const char *mname, void const *var,
-             int nels, void const *mixvar, int mixlen, int datatype, int centering,
-             DBoptlist const *optlist)
-{
-    void const *vars[1] = {var};
-    void const *mixvars[1] = {mixvar};
-    char const *varnames[1] = {vname};
-    int            retval;
-
-    API_BEGIN2("DBPutUcdvar1", int, -1, vname)
-    {
-
-        retval = DBPutUcdvar(dbfile, vname, mname, 1, varnames, vars,
-                     nels, mixvars, mixlen, datatype, centering, optlist);
+        if (!dbfile->pub.p_csgv)
+            API_ERROR(dbfile->pub.name, E_NOTIMP);
 
+        retval = (dbfile->pub.p_csgv) (dbfile, vname, meshname,
+                                     nvars, varnames, vars, nvals,
+                                     datatype, centering, optlist);
         db_FreeToc(dbfile);
         API_RETURN(retval);
     }
@@ -10237,958 +12826,1690 @@ DBPutUcdvar1(DBfile *dbfile, const char *vname, const char *mname, void const *v
 }
 
 /*-------------------------------------------------------------------------
- * Function:    DBPutZonelist
+ * Function:    DBGetCsgvar
  *
- * Purpose:     Writes a zonelist object into the open database.  The name
- *              assigned to this object can in turn be used as the
- *              `zonel_name' parameter to the DBPutUcdmesh() function.
+ * Purpose:     Allocates a DBcsgvar structure and reads a variable associated
+ *              with a CSG mesh from the database.
  *
- * Return:      Success:        0
+ * Return:      Success:        Pointer to the new DBucdvar struct
  *
- *              Failure:        -1
+ *              Failure:        NULL
  *
- * Programmer:  robb@cloud
- *              Wed Nov  9 12:20:22 EST 1994
+ * Programmer:  matzke@viper
+ *              Tue Nov  8 11:04:35 PST 1994
  *
  * Modifications:
- *    Eric Brugger, Tue Feb  7 08:09:26 PST 1995
- *    I replaced API_END with API_END_NOPOP.
- *
  *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
  *    Added a check for variable name validity.
  *
  *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
  *    Made the error messages a little better.
- *
- *    Robb Matzke, 2000-05-23
- *    The old table of contents is discarded if the directory changes.
  *-------------------------------------------------------------------------*/
-PUBLIC int
-DBPutZonelist(DBfile *dbfile, const char *name, int nzones, int ndims,
-              int const *nodelist, int lnodelist, int origin, int const *shapesize,
-              int const *shapecnt, int nshapes)
+PUBLIC DBcsgvar *
+DBGetCsgvar(DBfile *dbfile, const char *name)
 {
-    int retval;
+    DBcsgvar * retval = NULL;
 
-    API_DEPRECATE2("DBPutZonelist", int, -1, name, 4, 6, "DBPutZonelist2()") {
+    API_BEGIN2("DBGetCsgvar", DBcsgvar *, NULL, name) {
         if (!dbfile)
             API_ERROR(NULL, E_NOFILE);
         if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutZonelist", E_GRABBED) ; 
+            API_ERROR("DBGetCsgvar", E_GRABBED) ; 
         if (!name || !*name)
-            API_ERROR("zonelist name", E_BADARGS);
-        if (db_VariableNameValid(name) == 0)
-            API_ERROR("zonelist name", E_INVALIDNAME);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
-            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nzones < 0)
-            API_ERROR("nzones", E_BADARGS);
-        if (nzones)
-        {
-            if (ndims <= 0)
-                API_ERROR("ndims<=0", E_BADARGS);
-            if (lnodelist <= 0)
-                API_ERROR("lnodelist<=", E_BADARGS);
-            if (!nodelist)
-                API_ERROR("nodelist=0", E_BADARGS);
-            if (0 != origin && 1 != origin)
-                API_ERROR("origin!=0||1", E_BADARGS);
-            if (nshapes <= 0)
-                API_ERROR("nshapes<=0", E_BADARGS);
-            if (!shapesize)
-                API_ERROR("shapesize=0", E_BADARGS);
-            if (!shapecnt)
-                API_ERROR("shapecnt=0", E_BADARGS);
-        }
-        else if (!DBGetAllowEmptyObjectsFile(dbfile))
-        {
-            /* this is an empty object but we don't know if it was intentional */
-            API_ERROR("nzones=0", E_EMPTYOBJECT);
-        }
-        else
-        {
-            lnodelist = 0;
-            nshapes = 0;
-        }
-        if (!dbfile->pub.p_zl)
+            API_ERROR("CSGvar name", E_BADARGS);
+        if (!dbfile->pub.g_csgv)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
-        retval = (dbfile->pub.p_zl) (dbfile, name, nzones, ndims,
-                                     nodelist, lnodelist, origin, shapesize,
-                                     shapecnt, nshapes);
-        db_FreeToc(dbfile);
+        db_alloc_begin(dbfile);
+        retval = (dbfile->pub.g_csgv) (dbfile, name);
+        db_alloc_end(DB_CSGVAR, retval);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBPutZonelist2
- *
- * Purpose:     Writes a zonelist object into the open database.  The name
- *              assigned to this object can in turn be used as the
- *              `zonel_name' parameter to the DBPutUcdmesh() function.
- *
- * Return:      Success:        0
+
+/*----------------------------------------------------------------------
+ *  Routine                                                  _DBstrprint
  *
- *              Failure:        -1
+ *  Purpose
  *
- * Programmer:  brugger@kickit
- *              Tue Mar 30 10:41:12 PST 1999
+ *      This function prints an array of strings in either column- or
+ *      row-major order.
  *
- * Modifications:
- *    Jeremy Meredith, Fri May 21 10:04:25 PDT 1999
- *    Added an option list to the arguments and to the call to p_zl2().
+ *  Programmer
  *
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
+ *      Jeff Long
+ *  Arguments:
+ *      fp             File pointer for output of printing
+ *      strs           Array of character strings to print
+ *      nstrs          Number of character strings in 'strs'
+ *      order          Printing order: 'c' for by-column, 'r' for by-row
+ *      left_margin    Width of left margin (in chars)
+ *      col_margin     Width of empty spaces between columns (in chars)
+ *      line_width     Width of entire output line.
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
+ * Modified
+ *    Robb Matzke, Wed Jan 11 06:41:23 PST 1995
+ *    Changed name from strprint since that conflicted with MeshTV.
  *
- *    Robb Matzke, 2000-05-23
- *    The old table of contents is discarded if the directory changes.
- *-------------------------------------------------------------------------*/
-PUBLIC int
-DBPutZonelist2(DBfile *dbfile, const char *name, int nzones, int ndims,
-               int const *nodelist, int lnodelist, int origin, int lo_offset,
-               int hi_offset, int const *shapetype, int const *shapesize, int const *shapecnt,
-               int nshapes, DBoptlist const *optlist)
+ *    Eric Brugger, Tue Feb  7 09:06:58 PST 1995
+ *    I modified the argument declaration to reflect argument promotions.
+ *---------------------------------------------------------------------*/
+INTERNAL int
+_DBstrprint(FILE *fp, char *strs[], int nstrs, int order, int left_margin,
+            int col_margin, int line_width)
 {
-    int retval;
+    char         **sorted_strs = NULL;
+    int            i, j, index;
+    int            maxwidth;
+    int            nrows, ncols;
+    double         dtmp;
+    char          *me = "_DBstrprint";
 
-    API_BEGIN2("DBPutZonelist2", int, -1, name) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutZonelist2", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("zonelist name", E_BADARGS);
-        if (db_VariableNameValid(name) == 0)
-            API_ERROR("zonelist name", E_INVALIDNAME);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
-            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nzones < 0)
-            API_ERROR("nzones", E_BADARGS);
-        if (nzones)
-        {
-            if (ndims <= 0)
-                API_ERROR("ndims<=0", E_BADARGS);
-            if (lnodelist <= 0)
-                API_ERROR("lnodelist<=0", E_BADARGS);
-            if (nshapes <= 0)
-                API_ERROR("nshapes<=0", E_BADARGS);
-            if (!nodelist)
-                API_ERROR("nodelist=0", E_BADARGS);
-            if (!shapetype)
-                API_ERROR("shapetype=0", E_BADARGS);
-            if (!shapesize)
-                API_ERROR("shapesize=0", E_BADARGS);
-            if (!shapecnt)
-                API_ERROR("shapecnt=0", E_BADARGS);
-            if (0 != origin && 1 != origin)
-                API_ERROR("origin!=0||1", E_BADARGS);
-            if (lo_offset < 0)
-                API_ERROR("lo_offset<0", E_BADARGS);
-            if (hi_offset < 0)
-                API_ERROR("hi_offset<0", E_BADARGS);
-#ifndef _MSC_VER
-#warning HI AND LO OFFSET NOT VALID IN PRESENCE OF EXPLICIT GHOST LABELS
-#endif
-        }
-        else if (!DBGetAllowEmptyObjectsFile(dbfile))
-        {
-            /* this is an empty object but we don't know if it was intentional */
-            API_ERROR("nzones=0", E_EMPTYOBJECT);
+    if (nstrs <= 0)
+        return db_perror("nstrs", E_BADARGS, me);
+    if (left_margin < 0 || left_margin > line_width) {
+        return db_perror("left margin", E_BADARGS, me);
+    }
+
+     /*----------------------------------------
+      *  Sort strings into alphabetical order.
+      *---------------------------------------*/
+    sorted_strs = ALLOC_N(char *, nstrs);
+    for (i = 0; i < nstrs; i++)
+        sorted_strs[i] = strs[i];
+
+    _DBsort_list(sorted_strs, nstrs);
+
+     /*----------------------------------------
+      *  Find maximum string width.
+      *---------------------------------------*/
+    maxwidth = strlen(sorted_strs[0]);
+
+    for (i = 1; i < nstrs; i++) {
+        maxwidth = MAX(maxwidth, (int)strlen(sorted_strs[i]));
+    }
+
+     /*----------------------------------------
+      *  Determine number of columns and rows.
+      *---------------------------------------*/
+    ncols = (line_width - left_margin) / (maxwidth + col_margin);
+    if (ncols <= 0) {
+        FREE(sorted_strs);
+        return (OOPS);
+    }
+
+    dtmp = (double)nstrs / (double)ncols;
+    nrows = (int)ceil(dtmp);
+    if (nrows <= 0) {
+        FREE(sorted_strs);
+        return -1;
+    }
+
+     /*----------------------------------------
+      *  Print strings in requested order.
+      *---------------------------------------*/
+
+    if (order == 'c') {
+        /*------------------------------
+         *  Print by column
+         *-----------------------------*/
+
+        for (i = 0; i < nrows; i++) {
+            index = i;
+
+            fprintf(fp, "%*s", left_margin, " ");
+
+            for (j = 0; j < ncols; j++) {
+
+                fprintf(fp, "%-*s%*s", maxwidth, sorted_strs[index],
+                        col_margin, " ");
+
+                index += nrows;
+                if (index >= nstrs)
+                    break;
+            }
+            fprintf(fp, "\n");
         }
-        else
-        {
-            lnodelist = 0;
-            nshapes = 0;
+
+    }
+    else {
+        /*------------------------------
+         *  Print by row
+         *-----------------------------*/
+
+        for (i = 0; i < nrows; i++) {
+            index = i * ncols;
+
+            fprintf(fp, "%*s", left_margin, " ");
+
+            for (j = 0; j < ncols; j++) {
+
+                fprintf(fp, "%-*s%*s", maxwidth, sorted_strs[index],
+                        col_margin, " ");
+
+                index++;
+                if (index >= nstrs)
+                    break;
+            }
+            fprintf(fp, "\n");
         }
-        if (!dbfile->pub.p_zl2)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
-        retval = (dbfile->pub.p_zl2) (dbfile, name, nzones, ndims,
-                                      nodelist, lnodelist, origin, lo_offset,
-                                      hi_offset, shapetype, shapesize,
-                                      shapecnt, nshapes, optlist);
-        db_FreeToc(dbfile);
-        API_RETURN(retval);
+
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+
+    FREE(sorted_strs);
+    return 0;
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBPutPHZonelist 
+static int
+qsort_strcmp(const void *str1, const void *str2)
+{
+   return(strcmp(*((const char **)str1), *((const char **)str2)));
+}
+
+/*----------------------------------------------------------------------
+ *  Function                                                _DBsort_list
  *
- * Purpose:     Writes a polyhedral zonelist object into the open database.
- *              The name assigned to this object can in turn be used as the
- *              parameter to a DBOPT_PHZONELIST option in the optlist passed to
- *              the DBPutUcdmesh() function.
+ *  Purpose
  *
- * Return:      Success:        0
+ *      Sort a list of character strings. Algorithm taken from
+ *      _SX_sort_lists() -- courtesy of Stewart Brown.
  *
- *              Failure:        -1
+ * Modified
+ *    Robb Matzke, Wed Jan 11 06:39:16 PST 1995
+ *    Changed name from sort_list because it conflicts with MeshTV.
  *
- * Programmer:  Mark C. Miller
- *              Tuesday, July 26, 2004 
+ *    Sean Ahern, Fri Mar  2 09:45:05 PST 2001
+ *    Changed this sort to a qsort, as suggested by Dan Schikore.
+ *---------------------------------------------------------------------*/
+INTERNAL void
+_DBsort_list(char **ss, int n)
+{
+    qsort(ss, n, sizeof(char *), qsort_strcmp);
+}
+
+/*---------------------------------------------------------------------------
+ * Min/max engine for extents and data ranges.
+ *
+ * The values of interest in an array are a box of (node or zone) indices,
+ * which excludes any ghosts. Rather than test the indices of every value,
+ * the box is walked as a set of contiguous runs. Dimensions the box spans
+ * entirely are merged into longer runs, and long runs are split into
+ * chunks, so the work is a list of independent pieces. When compiled with
+ * OpenMP, the pieces of large arrays are spread over threads. Each run is
+ * reduced with 8 independent min/max lanes, which compilers vectorize.
+ *
+ * NaNs are ignored. Integer values are converted to double, so very large
+ * long long values may be rounded.
+ *---------------------------------------------------------------------------*/
+#define DB_MINMAX_CHUNK       (1<<16)     /* values per piece of work */
+#define DB_MINMAX_PARALLEL    (1<<20)     /* values before using threads */
+
+#define DB_MINMAX_RUN(T, NAME, LO, HI)                                   \
+static void NAME(T const *a, size_t n, double *amin, double *amax)      \
+{                                                                        \
+    T mn[8], mx[8];                                                      \
+    size_t i = 0;                                                        \
+    int l;                                                               \
+                                                                         \
+    for (l = 0; l < 8; l++)                                              \
+    {                                                                    \
+        mn[l] = HI;                                                      \
+        mx[l] = LO;                                                      \
+    }                                                                    \
+    for (; i + 8 <= n; i += 8)                                           \
+    {                                                                    \
+        for (l = 0; l < 8; l++)                                          \
+        {                                                                \
+            mn[l] = a[i+l] < mn[l] ? a[i+l] : mn[l];                     \
+            mx[l] = a[i+l] > mx[l] ? a[i+l] : mx[l];                     \
+        }                                                                \
+    }                                                                    \
+    for (; i < n; i++)                                                   \
+    {                                                                    \
+        mn[0] = a[i] < mn[0] ? a[i] : mn[0];                             \
+        mx[0] = a[i] > mx[0] ? a[i] : mx[0];                             \
+    }                                                                    \
+    for (l = 1; l < 8; l++)                                              \
+    {                                                                    \
+        mn[0] = mn[l] < mn[0] ? mn[l] : mn[0];                           \
+        mx[0] = mx[l] > mx[0] ? mx[l] : mx[0];                           \
+    }                                                                    \
+    if (mn[0] <= mx[0])                                                  \
+    {                                                                    \
+        if ((double) mn[0] < *amin) *amin = (double) mn[0];              \
+        if ((double) mx[0] > *amax) *amax = (double) mx[0];              \
+    }                                                                    \
+}
+
+DB_MINMAX_RUN(char,      db_minmax_run_char,     CHAR_MIN,   CHAR_MAX)
+DB_MINMAX_RUN(short,     db_minmax_run_short,    SHRT_MIN,   SHRT_MAX)
+DB_MINMAX_RUN(int,       db_minmax_run_int,      INT_MIN,    INT_MAX)
+DB_MINMAX_RUN(long,      db_minmax_run_long,     LONG_MIN,   LONG_MAX)
+DB_MINMAX_RUN(long long, db_minmax_run_longlong, LLONG_MIN,  LLONG_MAX)
+DB_MINMAX_RUN(float,     db_minmax_run_float,    -HUGE_VALF, HUGE_VALF)
+DB_MINMAX_RUN(double,    db_minmax_run_double,   -HUGE_VAL,  HUGE_VAL)
+
+static void
+db_minmax_run(void const *a, int datatype, size_t n, double *amin, double *amax)
+{
+    switch (datatype)
+    {
+        case DB_CHAR:      db_minmax_run_char((char const *) a, n, amin, amax); break;
+        case DB_SHORT:     db_minmax_run_short((short const *) a, n, amin, amax); break;
+        case DB_INT:       db_minmax_run_int((int const *) a, n, amin, amax); break;
+        case DB_LONG:      db_minmax_run_long((long const *) a, n, amin, amax); break;
+        case DB_LONG_LONG: db_minmax_run_longlong((long long const *) a, n, amin, amax); break;
+        case DB_DOUBLE:    db_minmax_run_double((double const *) a, n, amin, amax); break;
+        default:           db_minmax_run_float((float const *) a, n, amin, amax); break;
+    }
+}
+
+/*---------------------------------------------------------------------------
+ * Routine                                                        _DBminmax
  *
- *-------------------------------------------------------------------------*/
-PUBLIC int
-DBPutPHZonelist(DBfile *dbfile, const char *name,
-    int nfaces, int const *nodecnt, int lnodelist, int const *nodelist,
-    const char *extface, int nzones, int const *facecnt, int lfacelist,
-    int const *facelist, int origin, int lo_offset, int hi_offset,
-    DBoptlist const *optlist) 
+ * Purpose: Find the min and max of the values in the box of indices
+ *     [MINIDX[i],MAXIDX[i]] (inclusive) of an NDIMS dimensional array,
+ *     with the first dimension varying fastest. Null MINIDX or MAXIDX
+ *     select the whole array.
+ *
+ * Return: 0 if the box holds at least one (non-NaN) value, -1 otherwise.
+ *---------------------------------------------------------------------------*/
+INTERNAL int
+_DBminmax(void const *arr, int datatype, int ndims, int const *dims,
+    int const *minidx, int const *maxidx, double *arr_min, double *arr_max)
 {
-    int retval;
+    long long d[3] = {1, 1, 1}, lo[3] = {0, 0, 0}, hi[3] = {0, 0, 0};
+    long long runlen, nruns, nrows, nchunks, npieces, p;
+    size_t size = (size_t) db_GetMachDataSize(datatype);
+    double mn = HUGE_VAL, mx = -HUGE_VAL;
+    int i;
 
-    API_BEGIN2("DBPutPHZonelist", int, -1, name) {
+    if (!arr || ndims < 1 || ndims > 3 || !dims)
+        return -1;
 
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutPHZonelist", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("zonelist name", E_BADARGS);
-        if (db_VariableNameValid(name) == 0)
-            API_ERROR("zonelist name", E_INVALIDNAME);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
-            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nfaces < 0)
-            API_ERROR("nfaces<0", E_BADARGS);
-        if (nfaces)
-        {
-            if (0 != origin && 1 != origin)
-                API_ERROR("origin", E_BADARGS);
-            if (!nodecnt)
-                API_ERROR("nodecnt==0", E_BADARGS);
-            if (!lnodelist)
-                API_ERROR("lnodelist==0", E_BADARGS);
-            if (!nodelist)
-                API_ERROR("nodelist==0", E_BADARGS);
-            if (nzones < 0)
-                API_ERROR("nzones<0", E_BADARGS);
-            if (nzones)
-            {
-                if ((lo_offset < 0) || (lo_offset >= nzones))
-                    API_ERROR("lo_offset", E_BADARGS);
-                if ((hi_offset < 0) || (hi_offset >= nzones))
-                    API_ERROR("hi_offset", E_BADARGS);
-                if (lo_offset > hi_offset)
-                    API_ERROR("hi_offset", E_BADARGS);
-                if (!facecnt)
-                    API_ERROR("facecnt==0", E_BADARGS);
-                if (!lfacelist)
-                    API_ERROR("lfacelist==0", E_BADARGS);
-                if (!facelist)
-                    API_ERROR("facelist==0", E_BADARGS);
-            }
-        }
-        else if (!DBGetAllowEmptyObjectsFile(dbfile))
+    for (i = 0; i < ndims; i++)
+    {
+        d[i] = dims[i];
+        lo[i] = minidx ? MAX(minidx[i], 0) : 0;
+        hi[i] = maxidx ? MIN(maxidx[i], dims[i] - 1) : dims[i] - 1;
+        if (lo[i] > hi[i])
+            return -1;
+    }
+
+    /* Merge dimensions the box spans fully into longer contiguous runs */
+    runlen = hi[0] - lo[0] + 1;
+    nrows = hi[1] - lo[1] + 1;
+    nruns = nrows * (hi[2] - lo[2] + 1);
+    if (runlen == d[0])
+    {
+        runlen *= nrows;
+        nrows = 1;
+        nruns = hi[2] - lo[2] + 1;
+        if (runlen == d[0] * d[1])
         {
-            /* this is an empty object but we don't know if it was intentional */
-            API_ERROR("nfaces==0", E_EMPTYOBJECT);
+            runlen *= nruns;
+            nruns = 1;
         }
-        if (!dbfile->pub.p_phzl)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+    }
+    nchunks = (runlen + DB_MINMAX_CHUNK - 1) / DB_MINMAX_CHUNK;
+    npieces = nruns * nchunks;
 
-        retval = (dbfile->pub.p_phzl) (dbfile, name, nfaces, nodecnt,
-                                       lnodelist, nodelist, extface,
-                                       nzones, facecnt, lfacelist, facelist,
-                                       origin, lo_offset, hi_offset,
-                                       optlist);
+#ifdef _OPENMP
+#pragma omp parallel for reduction(min:mn) reduction(max:mx) \
+    if (npieces > 1 && nruns * runlen >= DB_MINMAX_PARALLEL)
+#endif
+    for (p = 0; p < npieces; p++)
+    {
+        long long r = p / nchunks, c = p % nchunks;
+        long long j = lo[1] + r % nrows, k = lo[2] + r / nrows;
+        long long start = (k * d[1] + j) * d[0] + lo[0] + c * DB_MINMAX_CHUNK;
+        long long n = MIN(DB_MINMAX_CHUNK, runlen - c * DB_MINMAX_CHUNK);
+        double pmn = HUGE_VAL, pmx = -HUGE_VAL;
 
-        db_FreeToc(dbfile);
-        API_RETURN(retval);
+        db_minmax_run((char const *) arr + start * size, datatype, (size_t) n, &pmn, &pmx);
+        mn = MIN(mn, pmn);
+        mx = MAX(mx, pmx);
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+
+    if (mn > mx)
+        return -1;
+    *arr_min = mn;
+    *arr_max = mx;
+    return 0;
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBPutCsgmesh
- *
- * Purpose:     Writes a CSG (Constructive Solid Geometry) mesh object to
- *              a silo database.
- *
- * Return:      Success:        Object ID
+/*---------------------------------------------------------------------------
+ * arrminmax - Return the min and max value of the given float array.
  *
- *              Failure:        -1
+ * Modified
+ *    Robb Matzke, Wed Jan 11 06:43:08 PST 1995
+ *    Changed name from arrminmax since that conflicted with MeshTV.
  *
- * Programmer:  Mark C. Miller
- *              Wed Jul 27 14:22:03 PDT 2005 
- *-------------------------------------------------------------------------*/
-PUBLIC int
-DBPutCsgmesh(DBfile *dbfile, const char *name, int ndims,
-             int nbounds,
-             const int *typeflags, const int *bndids/*optional*/,
-             const void *coeffs, int lcoeffs, int datatype,
-             const double *extents, const char *zonel_name, DBoptlist const *optlist)
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *---------------------------------------------------------------------------*/
+INTERNAL int
+_DBarrminmax(float arr[], int len, float *arr_min, float *arr_max)
 {
-    int retval;
+    char           *me = "_DBarrminmax";
+    double          mn, mx;
 
-    API_BEGIN2("DBPutCsgmesh", int, -1, name) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutCsgmesh", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("CSGmesh name", E_BADARGS);
-        if (db_VariableNameValid(name) == 0)
-            API_ERROR("CSGmesh name", E_INVALIDNAME);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
-            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nbounds < 0)
-            API_ERROR("nbounds<0", E_BADARGS);
-        if (nbounds)
-        {
-            if (ndims < 0)
-                API_ERROR("ndims<0", E_BADARGS);
-            if (lcoeffs < 0)
-                API_ERROR("lcoeffs<0", E_BADARGS);
-            if (!(ndims == 2 || ndims == 3))
-                API_ERROR("ndims must be either 2 or 3", E_BADARGS);
-            if (!typeflags) API_ERROR("typeflags==0", E_BADARGS);
-            if (!coeffs) API_ERROR("coeffs==0", E_BADARGS);
-            if (!extents) API_ERROR("extents==0", E_BADARGS);
-            if (!zonel_name || !*zonel_name) API_ERROR("zonel_name", E_BADARGS);
-            if (db_VariableNameValid(zonel_name) == 0)
-                API_ERROR("zonelist name", E_INVALIDNAME);
-        }
-        else if (!DBGetAllowEmptyObjectsFile(dbfile))
-        {
-            API_ERROR("nbounds==0 || ndims==0 || lcoeffs==0", E_EMPTYOBJECT);
-        }
-        if (!dbfile->pub.p_csgm)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+    if (!arr)
+        return db_perror("arr pointer", E_BADARGS, me);
+    if (len <= 0)
+        return db_perror("len", E_BADARGS, me);
 
-        retval = (dbfile->pub.p_csgm) (dbfile, name, ndims,
-                                     nbounds, typeflags, bndids, coeffs,
-                                     lcoeffs, datatype, extents, zonel_name,
-                                     optlist);
+    if (_DBminmax(arr, DB_FLOAT, 1, &len, 0, 0, &mn, &mx) < 0)
+        mn = mx = arr[0];
+    *arr_min = (float) mn;
+    *arr_max = (float) mx;
 
-        db_FreeToc(dbfile);
-        API_RETURN(retval);
-    }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    return 0;
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBGetCsgmesh
- *
- * Purpose:     Allocates a DBcsgmesh data structure and reads a CSG mesh
- *              from the data file.
+/*---------------------------------------------------------------------------
+ * iarrminmax - Return the min and max value of the given int array.
  *
- * Return:      Success:        Pointer to the new DBcsgmesh struct
+ * Modified:
+ *    Robb Matzke, Wed Jan 11 06:43:42 PST 1995
+ *    Changed name from iarrminmax since that conflicted with MeshTV.
  *
- *              Failure:        NULL
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *---------------------------------------------------------------------------*/
+INTERNAL int
+_DBiarrminmax(int arr[], int len, int *arr_min, int *arr_max)
+{
+    char           *me = "_DBiarrminmax";
+    double          mn, mx;
+
+    if (!arr)
+        return db_perror("arr pointer", E_BADARGS, me);
+    if (len <= 0)
+        return db_perror("len", E_BADARGS, me);
+
+    _DBminmax(arr, DB_INT, 1, &len, 0, 0, &mn, &mx);
+    *arr_min = (int) mn;
+    *arr_max = (int) mx;
+
+    return 0;
+}
+
+/*---------------------------------------------------------------------------
+ * darrminmax - Return the min and max value of the given double array.
  *
- * Programmer:  Mark C. Miller 
- *              Wed Jul 27 14:22:03 PDT 2005 
+ * Modified:
+ *    Robb Matzke, Wed Jan 11 06:44:16 PST 1995
+ *    Changed name from darrminmax since that conflicted with MeshTV.
  *
- *-------------------------------------------------------------------------*/
-PUBLIC DBcsgmesh *
-DBGetCsgmesh(DBfile *dbfile, const char *name)
+ *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
+ *    Made the error messages a little better.
+ *---------------------------------------------------------------------------*/
+INTERNAL int
+_DBdarrminmax(double arr[], int len, double *arr_min, double *arr_max)
 {
-    DBcsgmesh     *csgm = NULL;
+    char           *me = "_DBdarrminmax";
 
-    API_BEGIN2("DBGetCsgmesh", DBcsgmesh *, NULL, name) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetCsgmesh", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("CSGmesh name", E_BADARGS);
-        if (!dbfile->pub.g_csgm)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
-        csgm = ((dbfile->pub.g_csgm) (dbfile, name));
-        if (!csgm)
-        {
-            API_RETURN(NULL);
-        }
-        API_RETURN(csgm);
-    }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    if (!arr)
+        return db_perror("arr pointer", E_BADARGS, me);
+    if (len <= 0)
+        return db_perror("len", E_BADARGS, me);
+
+    if (_DBminmax(arr, DB_DOUBLE, 1, &len, 0, 0, arr_min, arr_max) < 0)
+        *arr_min = *arr_max = arr[0];
+
+    return 0;
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBPutCSGZonelist
- *
- * Purpose:     Writes a CSG zonelist object into the open database.
- *              The name assigned to this object can in turn be used as the
- *              `zonel_name' parameter to the DBPutCsgmesh() function.
+/*----------------------------------------------------------------------
+ * Routine                                               _CalcExtents
  *
- * Return:      Success:        0
+ * Purpose: Return min/max of each dimension of coordinate array data.
+ *     The extents of a dimension with no (non-NaN) values are NaN.
  *
- *              Failure:        -1
+ * Modifications:
+ *      Sean Ahern, Wed Oct 21 10:55:21 PDT 1998
+ *      Changed the function so that the min_extents and max_extents are 
+ *      passed in as void* variables.
  *
- * Programmer:  Mark C. Miller 
- *              Wed Jul 27 14:22:03 PDT 2005
- *-------------------------------------------------------------------------*/
-
-PUBLIC int
-DBPutCSGZonelist(DBfile *dbfile, const char *name, int nregs,
-                 const int *typeflags,
-                 const int *leftids, const int *rightids,
-                 const void *xforms, int lxforms, int datatype,
-                 int nzones, const int *zonelist, DBoptlist const *optlist)
+ *      Mark C. Miller, Mon May 20 12:25:25 PDT 2024
+ *      Adjusted to avoid strict pointer aliasing optimization issues.
+ *--------------------------------------------------------------------*/
+INTERNAL int
+_CalcExtents(DBVCP2_t coord_arrays, int datatype, int ndims, int npts,
+             void *min_extents, void *max_extents,
+             int const *dims, int const *minidx, int const *maxidx)
 {
-    int retval;
+    void const * const *_coord_arrays = (void const * const *) coord_arrays;
+    int i;
 
-    API_BEGIN2("DBPutCSGZonelist", int, -1, name) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutCSGZonelist", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("zonelist name", E_BADARGS);
-        if (db_VariableNameValid(name) == 0)
-            API_ERROR("zonelist name", E_INVALIDNAME);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, name))
-            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nzones)
+    if (npts <= 0) return 0;
+
+    for (i = 0; i < ndims; i++)
+    {
+        double mn, mx;
+
+        if (dims)
         {
-            if (nregs < 0)
-                API_ERROR("nregs", E_BADARGS);
-            if (nzones < 0)
-                API_ERROR("nzones", E_BADARGS);
-            if (!typeflags)
-                API_ERROR("typeflags", E_BADARGS);
-            if (!leftids)
-                API_ERROR("leftids", E_BADARGS);
-            if (!rightids)
-                API_ERROR("rightids", E_BADARGS);
-            if (!zonelist)
-                API_ERROR("zonelist", E_BADARGS);
-            if ((xforms && lxforms <= 0) || (!xforms && lxforms > 0))
-                API_ERROR("xforms and lxforms", E_BADARGS);
+            if (_DBminmax(_coord_arrays[i], datatype, ndims, dims, minidx, maxidx, &mn, &mx) < 0)
+                mn = mx = NAN;
         }
-        else if (!DBGetAllowEmptyObjectsFile(dbfile))
+        else if (_DBminmax(_coord_arrays[i], datatype, 1, &npts, 0, 0, &mn, &mx) < 0)
         {
-            /* this is an empty object but we don't know if it was intentional */
-            API_ERROR("nregs==0 || nzones==0", E_EMPTYOBJECT);
+            mn = mx = NAN;
         }
 
-        if (!dbfile->pub.p_csgzl)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
-
-        retval = (dbfile->pub.p_csgzl) (dbfile, name, nregs,
-                                        typeflags, leftids, rightids,
-                                        xforms, lxforms, datatype, 
-                                        nzones, zonelist, optlist);
-        db_FreeToc(dbfile);
-        API_RETURN(retval);
+        if (datatype == DB_DOUBLE)
+        {
+            ((double *) min_extents)[i] = mn;
+            ((double *) max_extents)[i] = mx;
+        }
+        else
+        {
+            ((float *) min_extents)[i] = (float) mn;
+            ((float *) max_extents)[i] = (float) mx;
+        }
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+
+    return 0;
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBGetCSGZonelist
- *
- * Purpose:     Allocate and read a DBcsgzonelist structure.
- *
- * Return:      Success:        ptr to new DBcsgzonelist.
- *
- *              Failure:        NULL
+/*----------------------------------------------------------------------
+ * Routine                                               _DBVarRange
  *
- * Programmer:  Mark C. Miller 
- *              Wed Jul 27 14:22:03 PDT 2005
+ * Purpose: Return min/max over all components of variable data,
+ *     excluding the ghost entries outside [MINIDX,MAXIDX].
  *
- *-------------------------------------------------------------------------*/
-PUBLIC DBcsgzonelist*
-DBGetCSGZonelist(DBfile *dbfile, const char *name)
+ * Return: 0 on success, -1 if there are no values.
+ *--------------------------------------------------------------------*/
+INTERNAL int
+_DBVarRange(int nvars, DBVCP2_t vars, int datatype, int ndims,
+    int const *dims, int const *minidx, int const *maxidx, double range[2])
 {
-    DBcsgzonelist * retval = NULL;
+    void const * const *_vars = (void const * const *) vars;
+    int i, found = 0;
 
-    API_BEGIN2("DBGetCSGZonelist", DBcsgzonelist *, NULL, name) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetCSGZonelist", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("CSG zonelist name", E_BADARGS);
-        if (!dbfile->pub.g_csgzl)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+    if (datatype != DB_CHAR && datatype != DB_SHORT && datatype != DB_INT &&
+        datatype != DB_LONG && datatype != DB_LONG_LONG &&
+        datatype != DB_FLOAT && datatype != DB_DOUBLE)
+        return -1;
 
-        retval = (dbfile->pub.g_csgzl) (dbfile, name);
-        API_RETURN(retval);
+    for (i = 0; i < nvars && _vars; i++)
+    {
+        double mn, mx;
+        if (_DBminmax(_vars[i], datatype, ndims, dims, minidx, maxidx, &mn, &mx) < 0)
+            continue;
+        range[0] = found ? MIN(range[0], mn) : mn;
+        range[1] = found ? MAX(range[1], mx) : mx;
+        found = 1;
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+
+    return found ? 0 : -1;
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBPutCsgvar
- *
- * Purpose:     Writes a variable associated with a CSG mesh into the
- *              database.  Note that variables will be either
- *              boundary-centered or zone-centered. A CSG-var object
- *              contains the variable values, plus the object ID of the
- *              associated CSG mesh.  Other information can also be included.
- *
- * Return:      Success:        Object ID
+/*----------------------------------------------------------------------
+ * Bounding volume hierarchy (BVH) of multi-block extents.
  *
- *              Failure:        -1
+ * The hierarchy is stored as a flat array of doubles so that it can be
+ * written as a component of the multi-block object by any driver.
  *
- * Programmer:  Mark C. Miller 
- *              Wed Jul 27 14:22:03 PDT 2005 
+ *     [0] version, [1] ndims, [2] nnodes, [3] nblocks in the tree
+ *     nnodes records of 2*ndims+2 doubles: lo[ndims], hi[ndims], a, b
  *
- *-------------------------------------------------------------------------*/
-PUBLIC int
-DBPutCsgvar(DBfile *dbfile, const char *vname, const char *meshname,
-            int nvars, char const * const *varnames, DBVCP2_t _vars,
-            int nvals, int datatype, int centering, DBoptlist const *optlist)
+ * Records are in depth-first order. For a leaf, a is the block index and
+ * b is 1. For an interior node, the left child is the next record, a is
+ * the index of the right child record and b is 0. Each leaf holds one
+ * block so queries are exact. Blocks that are empty or have invalid
+ * extents are left out.
+ *--------------------------------------------------------------------*/
+typedef struct db_bvh_build_t {
+    int ndims;
+    int esize;
+    double const *extents;
+    double *cent;
+    int *idx;
+    double *nodes;
+    int nnodes;
+} db_bvh_build_t;
+
+/* Partially sort idx[first..last] so idx[k] has the k'th centroid along axis */
+static void
+db_bvh_select(db_bvh_build_t *b, int first, int last, int k, int axis)
 {
-    int retval;
-    void const * const *vars = (void const * const *) _vars;
+    while (first < last)
+    {
+        double pivot = b->cent[b->idx[(first+last)/2]*b->ndims+axis];
+        int i = first, j = last;
+        while (i <= j)
+        {
+            while (b->cent[b->idx[i]*b->ndims+axis] < pivot) i++;
+            while (b->cent[b->idx[j]*b->ndims+axis] > pivot) j--;
+            if (i <= j)
+            {
+                int t = b->idx[i];
+                b->idx[i++] = b->idx[j];
+                b->idx[j--] = t;
+            }
+        }
+        if (k <= j) last = j;
+        else if (k >= i) first = i;
+        else break;
+    }
+}
 
-    API_BEGIN2("DBPutCsgvar", int, -1, vname) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBPutCsgvar", E_GRABBED) ; 
-        if (!vname || !*vname)
-            API_ERROR("CSGvar name", E_BADARGS);
-        if (db_VariableNameValid(vname) == 0)
-            API_ERROR("CSGvar name", E_INVALIDNAME);
-        if (!DBGetAllowOverwritesFile(dbfile) && DBInqVarExists(dbfile, vname))
-            API_ERROR("overwrite not allowed", E_NOOVERWRITE);
-        if (nvals < 0)
-            API_ERROR("nvals<0", E_BADARGS);
-        if (nvals)
+static int
+db_bvh_build(db_bvh_build_t *b, int first, int count)
+{
+    int nd = b->ndims, node = b->nnodes++;
+    double *rec = b->nodes + (size_t) node * DB_BVH_RECLEN(nd);
+    int i, d;
+
+    for (d = 0; d < nd; d++)
+    {
+        rec[d] = HUGE_VAL;
+        rec[nd+d] = -HUGE_VAL;
+    }
+    for (i = first; i < first + count; i++)
+    {
+        double const *e = b->extents + (size_t) b->idx[i] * b->esize;
+        for (d = 0; d < nd; d++)
         {
-            int i;
-            if (!meshname || !*meshname)
-                API_ERROR("CSGmesh name", E_BADARGS);
-            if (nvars <= 0)
-                API_ERROR("nvars<0", E_BADARGS);
-            if (db_VariableNameValid(meshname) == 0)
-                API_ERROR("CSGmesh name", E_INVALIDNAME);
-            for (i = 0; i < nvars && vars; i++)
-                if (!vars[i]) vars = 0;
-            for (i = 0; i < nvars && varnames; i++)
-                if (!varnames[i] && !*varnames[i]) varnames = 0;
-            if (!vars) API_ERROR("vars==0 || vars[i]==0", E_BADARGS);
-            if (!varnames) API_ERROR("varnames==0 || varnames[i]==0", E_BADARGS);
-            if (!(centering == DB_ZONECENT || centering == DB_BNDCENT)) 
-                API_ERROR("centering", E_BADARGS);
+            if (e[d] < rec[d]) rec[d] = e[d];
+            if (e[nd+d] > rec[nd+d]) rec[nd+d] = e[nd+d];
         }
-        else if (!DBGetAllowEmptyObjectsFile(dbfile))
+    }
+
+    if (count == 1)
+    {
+        rec[2*nd] = b->idx[first];
+        rec[2*nd+1] = 1;
+    }
+    else
+    {
+        /* Split at the median centroid along the axis of greatest spread */
+        int axis = 0, mid = first + count / 2, right;
+        double spread = -1;
+        for (d = 0; d < nd; d++)
         {
-            API_ERROR("nvars=0 || nvals=0", E_EMPTYOBJECT);
+            double lo = HUGE_VAL, hi = -HUGE_VAL;
+            for (i = first; i < first + count; i++)
+            {
+                double c = b->cent[b->idx[i]*nd+d];
+                if (c < lo) lo = c;
+                if (c > hi) hi = c;
+            }
+            if (hi - lo > spread)
+            {
+                spread = hi - lo;
+                axis = d;
+            }
         }
-        if (!dbfile->pub.p_csgv)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+        db_bvh_select(b, first, first + count - 1, mid, axis);
+        db_bvh_build(b, first, mid - first);
+        right = db_bvh_build(b, mid, first + count - mid);
+        rec = b->nodes + (size_t) node * DB_BVH_RECLEN(nd);
+        rec[2*nd] = right;
+        rec[2*nd+1] = 0;
+    }
+
+    return node;
+}
+
+/*----------------------------------------------------------------------
+ * Routine                                               db_MakeBlockBVH
+ *
+ * Purpose: Build the BVH of multi-block extents. EXTENTS holds
+ *     EXTENTSSIZE doubles per block, the ndims minimums followed by the
+ *     ndims maximums. Blocks named "EMPTY" in NAMES or listed in
+ *     EMPTY_LIST are left out.
+ *
+ * Return: Array of *LEN doubles to free with free(), or NULL if there
+ *     are no blocks with valid extents.
+ *--------------------------------------------------------------------*/
+INTERNAL double *
+db_MakeBlockBVH(int nblocks, int extentssize, double const *extents,
+    char const * const *names, int const *empty_list, int empty_cnt, int *len)
+{
+    db_bvh_build_t b;
+    char *skip;
+    double *retval = NULL;
+    int i, d, n = 0, nd = extentssize / 2;
+
+    *len = 0;
+    if (nblocks <= 0 || nd <= 0 || !extents)
+        return NULL;
+
+    skip = (char *) calloc(nblocks, 1);
+    memset(&b, 0, sizeof b);
+    b.ndims = nd;
+    b.esize = extentssize;
+    b.extents = extents;
+    b.cent = (double *) malloc((size_t) nblocks * nd * sizeof(double));
+    b.idx = (int *) malloc((size_t) nblocks * sizeof(int));
+    b.nodes = (double *) malloc((size_t) (2*nblocks) * DB_BVH_RECLEN(nd) * sizeof(double));
+    if (!skip || !b.cent || !b.idx || !b.nodes)
+        goto done;
+
+    for (i = 0; i < empty_cnt && empty_list; i++)
+        if (0 <= empty_list[i] && empty_list[i] < nblocks)
+            skip[empty_list[i]] = 1;
+
+    for (i = 0; i < nblocks; i++)
+    {
+        double const *e = extents + (size_t) i * extentssize;
+        if (skip[i] || (names && names[i] && !strcmp(names[i], "EMPTY")))
+            continue;
+        for (d = 0; d < nd; d++)
+            if (!(e[d] <= e[nd+d]))
+                break;
+        if (d < nd)
+            continue;
+        for (d = 0; d < nd; d++)
+            b.cent[i*nd+d] = 0.5 * (e[d] + e[nd+d]);
+        b.idx[n++] = i;
+    }
+    if (n == 0)
+        goto done;
+
+    db_bvh_build(&b, 0, n);
 
-        retval = (dbfile->pub.p_csgv) (dbfile, vname, meshname,
-                                     nvars, varnames, vars, nvals,
-                                     datatype, centering, optlist);
-        db_FreeToc(dbfile);
-        API_RETURN(retval);
+    *len = DB_BVH_HDRLEN + b.nnodes * DB_BVH_RECLEN(nd);
+    if ((retval = (double *) malloc(*len * sizeof(double))) == NULL)
+    {
+        *len = 0;
+        goto done;
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    retval[0] = DB_BVH_VERSION;
+    retval[1] = nd;
+    retval[2] = b.nnodes;
+    retval[3] = n;
+    memcpy(retval + DB_BVH_HDRLEN, b.nodes,
+        (size_t) b.nnodes * DB_BVH_RECLEN(nd) * sizeof(double));
+
+done:
+    free(skip);
+    free(b.cent);
+    free(b.idx);
+    free(b.nodes);
+    return retval;
 }
 
-/*-------------------------------------------------------------------------
- * Function:    DBGetCsgvar
- *
- * Purpose:     Allocates a DBcsgvar structure and reads a variable associated
- *              with a CSG mesh from the database.
- *
- * Return:      Success:        Pointer to the new DBucdvar struct
- *
- *              Failure:        NULL
- *
- * Programmer:  matzke@viper
- *              Tue Nov  8 11:04:35 PST 1994
+/*----------------------------------------------------------------------
+ * Routine                                          db_MakeBlockRangeBVH
  *
- * Modifications:
- *    Sean Ahern, Tue Sep 28 10:48:06 PDT 1999
- *    Added a check for variable name validity.
+ * Purpose: Build the BVH of multi-block variable value ranges. EXTENTS
+ *     holds EXTENTSSIZE doubles per block, the component minimums
+ *     followed by the component maximums. Each block is indexed by the
+ *     interval from its least minimum to its greatest maximum.
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
- *-------------------------------------------------------------------------*/
-PUBLIC DBcsgvar *
-DBGetCsgvar(DBfile *dbfile, const char *name)
+ * Return: As db_MakeBlockBVH.
+ *--------------------------------------------------------------------*/
+INTERNAL double *
+db_MakeBlockRangeBVH(int nblocks, int extentssize, double const *extents,
+    char const * const *names, int const *empty_list, int empty_cnt, int *len)
 {
-    DBcsgvar * retval = NULL;
+    double *hull, *retval;
+    int i, c, nc = extentssize / 2;
 
-    API_BEGIN2("DBGetCsgvar", DBcsgvar *, NULL, name) {
-        if (!dbfile)
-            API_ERROR(NULL, E_NOFILE);
-        if (SILO_Globals.enableGrabDriver == TRUE)
-            API_ERROR("DBGetCsgvar", E_GRABBED) ; 
-        if (!name || !*name)
-            API_ERROR("CSGvar name", E_BADARGS);
-        if (!dbfile->pub.g_csgv)
-            API_ERROR(dbfile->pub.name, E_NOTIMP);
+    *len = 0;
+    if (nblocks <= 0 || nc <= 0 || !extents)
+        return NULL;
+    if (nc == 1)
+        return db_MakeBlockBVH(nblocks, extentssize, extents, names,
+                   empty_list, empty_cnt, len);
 
-        retval = (dbfile->pub.g_csgv) (dbfile, name);
-        API_RETURN(retval);
+    if ((hull = (double *) malloc((size_t) nblocks * 2 * sizeof(double))) == NULL)
+        return NULL;
+    for (i = 0; i < nblocks; i++)
+    {
+        double const *e = extents + (size_t) i * extentssize;
+        hull[2*i] = e[0];
+        hull[2*i+1] = e[nc];
+        for (c = 1; c < nc; c++)
+        {
+            if (e[c] < hull[2*i]) hull[2*i] = e[c];
+            if (e[nc+c] > hull[2*i+1]) hull[2*i+1] = e[nc+c];
+        }
     }
-    API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
+    retval = db_MakeBlockBVH(nblocks, 2, hull, names, empty_list, empty_cnt, len);
+    free(hull);
+    return retval;
+}
+
+/* Does the box [lo,hi] meet the query? */
+static int
+db_bvh_hit(int qtype, int nd, double const *q, double const *lo, double const *hi)
+{
+    double tmin = 0, tmax = qtype == DB_QUERY_SEGMENT ? 1 : HUGE_VAL;
+    int d;
+
+    for (d = 0; d < nd; d++)
+    {
+        switch (qtype)
+        {
+            case DB_QUERY_POINT:
+                if (q[d] < lo[d] || q[d] > hi[d]) return 0;
+                break;
+            case DB_QUERY_BOX:
+                if (q[nd+d] < lo[d] || q[d] > hi[d]) return 0;
+                break;
+            default: /* ray or segment, by slabs */
+            {
+                double dir = qtype == DB_QUERY_RAY ? q[nd+d] : q[nd+d] - q[d];
+                if (dir == 0)
+                {
+                    if (q[d] < lo[d] || q[d] > hi[d]) return 0;
+                }
+                else
+                {
+                    double t0 = (lo[d] - q[d]) / dir, t1 = (hi[d] - q[d]) / dir;
+                    if (t0 > t1) { double t = t0; t0 = t1; t1 = t; }
+                    if (t0 > tmin) tmin = t0;
+                    if (t1 < tmax) tmax = t1;
+                    if (tmin > tmax) return 0;
+                }
+                break;
+            }
+        }
+    }
+    return 1;
 }
 
+static int
+db_int_compare(void const *a, void const *b)
+{
+    int ia = *(int const *) a, ib = *(int const *) b;
+    return ia < ib ? -1 : ia > ib;
+}
 
 /*----------------------------------------------------------------------
- *  Routine                                                  _DBstrprint
- *
- *  Purpose
- *
- *      This function prints an array of strings in either column- or
- *      row-major order.
- *
- *  Programmer
+ * Routine                                               db_QueryBlockBVH
  *
- *      Jeff Long
- *  Arguments:
- *      fp             File pointer for output of printing
- *      strs           Array of character strings to print
- *      nstrs          Number of character strings in 'strs'
- *      order          Printing order: 'c' for by-column, 'r' for by-row
- *      left_margin    Width of left margin (in chars)
- *      col_margin     Width of empty spaces between columns (in chars)
- *      line_width     Width of entire output line.
+ * Purpose: Find the blocks of a BVH made by db_MakeBlockBVH whose
+ *     extents meet the query. See DBQueryMultimeshBlocks.
  *
- * Modified
- *    Robb Matzke, Wed Jan 11 06:41:23 PST 1995
- *    Changed name from strprint since that conflicted with MeshTV.
+ * Return: Number of blocks (returned, sorted, in *BLOCKS to be freed
+ *     with free()) or -1 if the BVH is not valid or memory runs out.
  *
- *    Eric Brugger, Tue Feb  7 09:06:58 PST 1995
- *    I modified the argument declaration to reflect argument promotions.
- *---------------------------------------------------------------------*/
+ * Description: Children always follow their parent in the records, so
+ *     a child index not after its parent or past the last record means
+ *     the BVH is corrupt.
+ *--------------------------------------------------------------------*/
 INTERNAL int
-_DBstrprint(FILE *fp, char *strs[], int nstrs, int order, int left_margin,
-            int col_margin, int line_width)
+db_QueryBlockBVH(double const *bvh, int len, int qtype, double const *q, int **blocks)
 {
-    char         **sorted_strs = NULL;
-    int            i, j, index;
-    int            maxwidth;
-    int            nrows, ncols;
-    double         dtmp;
-    char          *me = "_DBstrprint";
-
-    if (nstrs <= 0)
-        return db_perror("nstrs", E_BADARGS, me);
-    if (left_margin < 0 || left_margin > line_width) {
-        return db_perror("left margin", E_BADARGS, me);
-    }
-
-     /*----------------------------------------
-      *  Sort strings into alphabetical order.
-      *---------------------------------------*/
-    sorted_strs = ALLOC_N(char *, nstrs);
-    for (i = 0; i < nstrs; i++)
-        sorted_strs[i] = strs[i];
-
-    _DBsort_list(sorted_strs, nstrs);
+    int nd, nnodes, n = 0, max = 0, sp = 0, maxsp = 64;
+    int *stack = NULL, *list = NULL;
 
-     /*----------------------------------------
-      *  Find maximum string width.
-      *---------------------------------------*/
-    maxwidth = strlen(sorted_strs[0]);
+    *blocks = NULL;
+    if (!bvh || len < DB_BVH_HDRLEN || bvh[0] != DB_BVH_VERSION)
+        return -1;
+    nd = (int) bvh[1];
+    nnodes = (int) bvh[2];
+    if (nd <= 0 || nnodes <= 0 || len < DB_BVH_HDRLEN + nnodes * DB_BVH_RECLEN(nd))
+        return -1;
+    if ((stack = (int *) malloc(maxsp * sizeof(int))) == NULL)
+        return -1;
 
-    for (i = 1; i < nstrs; i++) {
-        maxwidth = MAX(maxwidth, (int)strlen(sorted_strs[i]));
-    }
+    stack[sp++] = 0;
+    while (sp > 0)
+    {
+        int node = stack[--sp];
+        double const *rec = bvh + DB_BVH_HDRLEN + (size_t) node * DB_BVH_RECLEN(nd);
 
-     /*----------------------------------------
-      *  Determine number of columns and rows.
-      *---------------------------------------*/
-    ncols = (line_width - left_margin) / (maxwidth + col_margin);
-    if (ncols <= 0) {
-        FREE(sorted_strs);
-        return (OOPS);
-    }
+        if (!db_bvh_hit(qtype, nd, q, rec, rec + nd))
+            continue;
 
-    dtmp = (double)nstrs / (double)ncols;
-    nrows = (int)ceil(dtmp);
-    if (nrows <= 0) {
-        FREE(sorted_strs);
-        return -1;
+        if (rec[2*nd+1] != 0)
+        {
+            if (!(rec[2*nd] >= 0 && rec[2*nd] <= INT_MAX))
+                goto fail;
+            if (n == max)
+            {
+                int *tmp = (int *) realloc(list, (max = max ? 2*max : 64) * sizeof(int));
+                if (!tmp)
+                    goto fail;
+                list = tmp;
+            }
+            list[n++] = (int) rec[2*nd];
+        }
+        else
+        {
+            if (!(rec[2*nd] > node + 1 && rec[2*nd] < nnodes))
+                goto fail;
+            if (sp + 2 > maxsp)
+            {
+                int *tmp = (int *) realloc(stack, (maxsp *= 2) * sizeof(int));
+                if (!tmp)
+                    goto fail;
+                stack = tmp;
+            }
+            stack[sp++] = (int) rec[2*nd];
+            stack[sp++] = node + 1;
+        }
     }
 
-     /*----------------------------------------
-      *  Print strings in requested order.
-      *---------------------------------------*/
+    free(stack);
+    qsort(list, n, sizeof(int), db_int_compare);
+    *blocks = list;
+    return n;
 
-    if (order == 'c') {
-        /*------------------------------
-         *  Print by column
-         *-----------------------------*/
+fail:
+    free(stack);
+    free(list);
+    return -1;
+}
 
-        for (i = 0; i < nrows; i++) {
-            index = i;
+/* Spread the low 32 bits of X to the even bits of the result */
+static unsigned long long
+db_morton_spread2(unsigned long long x)
+{
+    x &= 0xFFFFFFFFULL;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x <<  8)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x <<  4)) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x <<  2)) & 0x3333333333333333ULL;
+    x = (x | (x <<  1)) & 0x5555555555555555ULL;
+    return x;
+}
+
+/* Spread the low 21 bits of X to every third bit of the result */
+static unsigned long long
+db_morton_spread3(unsigned long long x)
+{
+    x &= 0x1FFFFFULL;
+    x = (x | (x << 32)) & 0x001F00000000FFFFULL;
+    x = (x | (x << 16)) & 0x001F0000FF0000FFULL;
+    x = (x | (x <<  8)) & 0x100F00F00F00F00FULL;
+    x = (x | (x <<  4)) & 0x10C30C30C30C30C3ULL;
+    x = (x | (x <<  2)) & 0x1249249249249249ULL;
+    return x;
+}
 
-            fprintf(fp, "%*s", left_margin, " ");
+/*----------------------------------------------------------------------
+ * Routine                                                db_MortonOrder
+ *
+ * Purpose: Order N points along a Morton curve. ORDER[i] receives the
+ *     index of the i'th point on the curve.
+ *
+ * Return: 0 on success, -1 on failure.
+ *
+ * Description: The keys are made by scaling each coordinate to an
+ *     unsigned integer over the extents of the points and interleaving
+ *     the bits. They are sorted with an 8 bit least significant digit
+ *     radix sort, skipping passes on digits all keys share, so ties keep
+ *     input order. Key generation is threaded when OpenMP is enabled.
+ *--------------------------------------------------------------------*/
+static int
+db_MortonOrder(int ndims, void const * const *coords, int datatype, int n,
+    int *order)
+{
+    unsigned long long *key = NULL, *key2 = NULL;
+    int *idx = order, *idx2 = NULL;
+    double lo[3], hi[3], scale[3];
+    int bits = ndims == 1 ? 32 : (ndims == 2 ? 31 : 21);
+    int i, d, pass;
 
-            for (j = 0; j < ncols; j++) {
+    if (ndims < 1 || ndims > 3 || n <= 0)
+        return -1;
 
-                fprintf(fp, "%-*s%*s", maxwidth, sorted_strs[index],
-                        col_margin, " ");
+    key = (unsigned long long *) malloc(n * sizeof(unsigned long long));
+    key2 = (unsigned long long *) malloc(n * sizeof(unsigned long long));
+    idx2 = (int *) malloc(n * sizeof(int));
+    if (!key || !key2 || !idx2)
+    {
+        FREE(key);
+        FREE(key2);
+        FREE(idx2);
+        return -1;
+    }
 
-                index += nrows;
-                if (index >= nstrs)
-                    break;
-            }
-            fprintf(fp, "\n");
+    for (d = 0; d < ndims; d++)
+    {
+        lo[d] = HUGE_VAL;
+        hi[d] = -HUGE_VAL;
+        for (i = 0; i < n; i++)
+        {
+            double c = db_coord_value(coords[d], datatype, i);
+            if (c < lo[d]) lo[d] = c;
+            if (c > hi[d]) hi[d] = c;
         }
-
+        scale[d] = hi[d] > lo[d] ? (double) ((1ULL << bits) - 1) / (hi[d] - lo[d]) : 0;
     }
-    else {
-        /*------------------------------
-         *  Print by row
-         *-----------------------------*/
-
-        for (i = 0; i < nrows; i++) {
-            index = i * ncols;
-
-            fprintf(fp, "%*s", left_margin, " ");
 
-            for (j = 0; j < ncols; j++) {
+    /* Morton keys */
+#ifdef _OPENMP
+#pragma omp parallel for private(d) if (n >= DB_PMIDX_CHUNK * 16)
+#endif
+    for (i = 0; i < n; i++)
+    {
+        unsigned long long q[3] = {0, 0, 0};
+        for (d = 0; d < ndims; d++)
+        {
+            double c = db_coord_value(coords[d], datatype, i);
+            if (c > lo[d])
+                q[d] = (unsigned long long) ((c - lo[d]) * scale[d]);
+        }
+        if (ndims == 1)
+            key[i] = q[0];
+        else if (ndims == 2)
+            key[i] = db_morton_spread2(q[0]) | (db_morton_spread2(q[1]) << 1);
+        else
+            key[i] = db_morton_spread3(q[0]) | (db_morton_spread3(q[1]) << 1) |
+                     (db_morton_spread3(q[2]) << 2);
+        idx[i] = i;
+    }
 
-                fprintf(fp, "%-*s%*s", maxwidth, sorted_strs[index],
-                        col_margin, " ");
+    /* Radix sort of (key, idx) pairs */
+    for (pass = 0; pass < 8; pass++)
+    {
+        int shift = 8 * pass;
+        size_t count[256], sum = 0;
+        unsigned long long *kt;
+        int *it;
 
-                index++;
-                if (index >= nstrs)
-                    break;
-            }
-            fprintf(fp, "\n");
+        memset(count, 0, sizeof count);
+        for (i = 0; i < n; i++)
+            count[(key[i] >> shift) & 0xFF]++;
+        if (count[(key[0] >> shift) & 0xFF] == (size_t) n)
+            continue;
+        for (d = 0; d < 256; d++)
+        {
+            size_t c = count[d];
+            count[d] = sum;
+            sum += c;
         }
-
+        for (i = 0; i < n; i++)
+        {
+            size_t j = count[(key[i] >> shift) & 0xFF]++;
+            key2[j] = key[i];
+            idx2[j] = idx[i];
+        }
+        kt = key; key = key2; key2 = kt;
+        it = idx; idx = idx2; idx2 = it;
+    }
+    if (idx != order)
+    {
+        memcpy(order, idx, n * sizeof(int));
+        idx2 = idx;
     }
 
-    FREE(sorted_strs);
+    free(key);
+    free(key2);
+    free(idx2);
     return 0;
 }
 
-static int
-qsort_strcmp(const void *str1, const void *str2)
+/*----------------------------------------------------------------------
+ * Routine                                              db_SortPointmesh
+ *
+ * Purpose: Order the points of a point mesh along a Morton curve and
+ *     index them in chunks for DBGetPointmeshRegion. The LO ghost points
+ *     at the start and HI ghost points at the end keep their places so
+ *     that DBOPT_LO_OFFSET and DBOPT_HI_OFFSET still apply.
+ *
+ *     SORTED[d] receives a new copy of coordinate array d in curve order
+ *     and PERM[i] is the caller's index of the i'th sorted point. The
+ *     points are then cut into consecutive chunks of CHUNKSIZE points,
+ *     which are spatially compact because of the ordering. INDEX holds
+ *     *LEN doubles, a DB_PMIDX_HDRLEN header followed by a BVH of the
+ *     chunk bounding boxes made by db_MakeBlockBVH.
+ *
+ * Return: 0 on success, -1 on failure. All outputs are to be freed
+ *     with free().
+ *
+ * Description: The ordering is made by db_MortonOrder. The gathers
+ *     and chunk boxes are threaded when OpenMP is enabled.
+ *
+ * Modifications:
+ *--------------------------------------------------------------------*/
+INTERNAL int
+db_SortPointmesh(int ndims, DBVCP2_t _coords, int nels, int lo, int hi,
+    int datatype, int chunksize, void **sorted, int **perm, double **index,
+    int *len)
 {
-   return(strcmp(*((const char **)str1), *((const char **)str2)));
+    void const * const *coords = (void const * const *) _coords;
+    size_t size = datatype == DB_DOUBLE ? sizeof(double) : sizeof(float);
+    void const *real[3];
+    int *idx = NULL;
+    double *boxes = NULL, *bvh = NULL;
+    int i, d, nchunks, bvhlen = 0;
+
+    for (d = 0; d < 3; d++)
+        sorted[d] = NULL;
+    *perm = NULL;
+    *index = NULL;
+    *len = 0;
+    if (ndims < 1 || ndims > 3 || nels <= 0 || lo < 0 || hi < 0 ||
+        lo + hi >= nels || (datatype != DB_FLOAT && datatype != DB_DOUBLE))
+        return -1;
+    if (chunksize <= 0)
+        chunksize = DB_PMIDX_CHUNK;
+
+    /* Order only the real points, between the ghost points */
+    for (d = 0; d < ndims; d++)
+        real[d] = (char const *) coords[d] + (size_t) lo * size;
+    idx = (int *) malloc(nels * sizeof(int));
+    if (!idx || db_MortonOrder(ndims, real, datatype, nels - lo - hi, idx + lo) < 0)
+        goto fail;
+    for (i = 0; i < lo; i++)
+        idx[i] = i;
+    for (i = lo; i < nels - hi; i++)
+        idx[i] += lo;
+    for (i = nels - hi; i < nels; i++)
+        idx[i] = i;
+
+    /* Sorted copies of the coordinates */
+    for (d = 0; d < ndims; d++)
+        if ((sorted[d] = db_PermuteArray(coords[d], nels, size, idx)) == NULL)
+            goto fail;
+
+    /* Bounding box of each chunk, then the BVH of the boxes */
+    nchunks = (nels + chunksize - 1) / chunksize;
+    if ((boxes = (double *) malloc((size_t) nchunks * 2 * ndims * sizeof(double))) == NULL)
+        goto fail;
+#ifdef _OPENMP
+#pragma omp parallel for private(d) if (nchunks >= 16)
+#endif
+    for (i = 0; i < nchunks; i++)
+    {
+        double *b = boxes + (size_t) i * 2 * ndims;
+        int j, end = (int) MIN((long long) nels, (long long) (i + 1) * chunksize);
+        for (d = 0; d < ndims; d++)
+        {
+            b[d] = HUGE_VAL;
+            b[ndims+d] = -HUGE_VAL;
+            for (j = i * chunksize; j < end; j++)
+            {
+                double c = db_coord_value(sorted[d], datatype, j);
+                if (c < b[d]) b[d] = c;
+                if (c > b[ndims+d]) b[ndims+d] = c;
+            }
+        }
+    }
+    bvh = db_MakeBlockBVH(nchunks, 2 * ndims, boxes, NULL, NULL, 0, &bvhlen);
+    if (!bvh || (*index = (double *) malloc((DB_PMIDX_HDRLEN + bvhlen) * sizeof(double))) == NULL)
+        goto fail;
+    (*index)[0] = DB_PMIDX_VERSION;
+    (*index)[1] = ndims;
+    (*index)[2] = nels;
+    (*index)[3] = chunksize;
+    memcpy(*index + DB_PMIDX_HDRLEN, bvh, bvhlen * sizeof(double));
+    *len = DB_PMIDX_HDRLEN + bvhlen;
+    *perm = idx;
+
+    free(boxes);
+    free(bvh);
+    return 0;
+
+fail:
+    for (d = 0; d < 3; d++)
+    {
+        FREE(sorted[d]);
+    }
+    FREE(*index);
+    *perm = NULL;
+    *len = 0;
+    free(idx);
+    free(boxes);
+    free(bvh);
+    return -1;
 }
 
 /*----------------------------------------------------------------------
- *  Function                                                _DBsort_list
- *
- *  Purpose
- *
- *      Sort a list of character strings. Algorithm taken from
- *      _SX_sort_lists() -- courtesy of Stewart Brown.
+ * Routine                                               db_PermuteArray
  *
- * Modified
- *    Robb Matzke, Wed Jan 11 06:39:16 PST 1995
- *    Changed name from sort_list because it conflicts with MeshTV.
+ * Purpose: Gather N elements of SIZE bytes, the i'th from SRC[PERM[i]].
  *
- *    Sean Ahern, Fri Mar  2 09:45:05 PST 2001
- *    Changed this sort to a qsort, as suggested by Dan Schikore.
- *---------------------------------------------------------------------*/
-INTERNAL void
-_DBsort_list(char **ss, int n)
+ * Return: New array to be freed with free(), or NULL on failure.
+ *--------------------------------------------------------------------*/
+INTERNAL void *
+db_PermuteArray(void const *src, int n, size_t size, int const *perm)
 {
-    qsort(ss, n, sizeof(char *), qsort_strcmp);
+    char *dst;
+    int i;
+
+    if (!src || n <= 0 || (dst = (char *) malloc((size_t) n * size)) == NULL)
+        return NULL;
+
+    if (size == sizeof(double))
+    {
+#ifdef _OPENMP
+#pragma omp parallel for if (n >= DB_PMIDX_CHUNK * 16)
+#endif
+        for (i = 0; i < n; i++)
+            ((double *) dst)[i] = ((double const *) src)[perm[i]];
+    }
+    else if (size == sizeof(float))
+    {
+#ifdef _OPENMP
+#pragma omp parallel for if (n >= DB_PMIDX_CHUNK * 16)
+#endif
+        for (i = 0; i < n; i++)
+            ((float *) dst)[i] = ((float const *) src)[perm[i]];
+    }
+    else
+    {
+        for (i = 0; i < n; i++)
+            memcpy(dst + (size_t) i * size, (char const *) src + (size_t) perm[i] * size, size);
+    }
+    return dst;
 }
 
-/*---------------------------------------------------------------------------
- * arrminmax - Return the min and max value of the given float array.
+/*----------------------------------------------------------------------
+ * Routine                                                 db_InvertPerm
  *
- * Modified
- *    Robb Matzke, Wed Jan 11 06:43:08 PST 1995
- *    Changed name from arrminmax since that conflicted with MeshTV.
+ * Purpose: Invert a permutation. INV[PERM[i]] = i.
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
- *---------------------------------------------------------------------------*/
-INTERNAL int
-_DBarrminmax(float arr[], int len, float *arr_min, float *arr_max)
+ *     PERM is a permutation of [0,LEN). Only the positions of the values
+ *     below N <= LEN are wanted, which lets a zonelist that references
+ *     only some of the nodes of its mesh invert the mesh's permutation.
+ *     PERM is read only as far as needed to find them all.
+ *
+ * Return: New array of N ints to be freed with free(), or NULL if PERM
+ *     is not a permutation or memory is exhausted.
+ *--------------------------------------------------------------------*/
+INTERNAL int *
+db_InvertPerm(int const *perm, int n, int len)
 {
-    int             i;
-    char           *me = "_DBarrminmax";
-
-    if (!arr)
-        return db_perror("arr pointer", E_BADARGS, me);
-    if (len <= 0)
-        return db_perror("len", E_BADARGS, me);
+    int *inv;
+    int i, found = 0;
 
-    *arr_min = arr[0];
-    *arr_max = arr[0];
+    if (!perm || n <= 0 || len < n ||
+        (inv = (int *) malloc(n * sizeof(int))) == NULL)
+        return NULL;
+    for (i = 0; i < n; i++)
+        inv[i] = -1;
 
-    for (i = 1; i < len; i++)
+    for (i = 0; i < len && found < n; i++)
     {
-        *arr_min = MIN(*arr_min, arr[i]);
-        *arr_max = MAX(*arr_max, arr[i]);
+        int p = perm[i];
+        if (p < 0 || p >= len)
+            break;
+        if (p >= n)
+            continue;
+        if (inv[p] >= 0)
+            break;
+        inv[p] = i;
+        found++;
     }
 
-    return 0;
+    if (found < n)
+    {
+        free(inv);
+        return NULL;
+    }
+    return inv;
 }
 
-/*---------------------------------------------------------------------------
- * iarrminmax - Return the min and max value of the given int array.
+/*----------------------------------------------------------------------
+ * Routine                                                 db_ZoneStarts
  *
- * Modified:
- *    Robb Matzke, Wed Jan 11 06:43:42 PST 1995
- *    Changed name from iarrminmax since that conflicted with MeshTV.
+ * Purpose: Find where each zone of a zonelist starts in its nodelist.
  *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
- *---------------------------------------------------------------------------*/
-INTERNAL int
-_DBiarrminmax(int arr[], int len, int *arr_min, int *arr_max)
+ * Return: New array of NZONES+1 ints to be freed with free(), the last
+ *     being the used length of the nodelist, or NULL if the shape
+ *     counts and sizes do not fit NZONES and LNODELIST. If BLOCK is not
+ *     NULL, *BLOCK receives a new array giving, for each zone, 3 times
+ *     its shape index plus 0, 1 or 2 for a low ghost, real or high
+ *     ghost zone. Zones with the same block number are contiguous.
+ *
+ * Description: A zone of type DB_ZONETYPE_POLYHEDRON is walked face by
+ *     face since its length varies. SHAPETYPE may be NULL, as it is for
+ *     zonelists written with DBPutZonelist.
+ *--------------------------------------------------------------------*/
+INTERNAL int *
+db_ZoneStarts(int nzones, int const *nodelist, int lnodelist, int lo_offset,
+    int hi_offset, int const *shapetype, int const *shapesize,
+    int const *shapecnt, int nshapes, int **block)
 {
-    int             i;
-    char           *me = "_DBiarrminmax";
-
-    if (!arr)
-        return db_perror("arr pointer", E_BADARGS, me);
-    if (len <= 0)
-        return db_perror("len", E_BADARGS, me);
+    int *starts = NULL, *blk = NULL;
+    int s, k, z = 0, pos = 0;
 
-    *arr_min = arr[0];
-    *arr_max = arr[0];
+    if (block)
+        *block = NULL;
+    if (nzones <= 0 || !nodelist || !shapesize || !shapecnt)
+        return NULL;
+    starts = (int *) malloc((nzones + 1) * sizeof(int));
+    if (block)
+        blk = (int *) malloc(nzones * sizeof(int));
+    if (!starts || (block && !blk))
+        goto fail;
 
-    for (i = 1; i < len; i++)
+    for (s = 0; s < nshapes; s++)
     {
-        *arr_min = MIN(*arr_min, arr[i]);
-        *arr_max = MAX(*arr_max, arr[i]);
+        for (k = 0; k < shapecnt[s]; k++, z++)
+        {
+            if (z >= nzones)
+                goto fail;
+            starts[z] = pos;
+            if (blk)
+                blk[z] = 3 * s + (z < lo_offset ? 0 : (z >= nzones - hi_offset ? 2 : 1));
+            if (shapetype && shapetype[s] == DB_ZONETYPE_POLYHEDRON)
+            {
+                int f, nf;
+                if (pos >= lnodelist)
+                    goto fail;
+                nf = nodelist[pos++];
+                for (f = 0; f < nf && pos < lnodelist; f++)
+                    pos += nodelist[pos] + 1;
+                if (f < nf)
+                    goto fail;
+            }
+            else
+            {
+                pos += shapesize[s];
+            }
+            if (pos > lnodelist)
+                goto fail;
+        }
     }
+    if (z != nzones)
+        goto fail;
+    starts[nzones] = pos;
 
-    return 0;
+    if (block)
+        *block = blk;
+    return starts;
+
+fail:
+    FREE(starts);
+    FREE(blk);
+    return NULL;
 }
 
-/*---------------------------------------------------------------------------
- * darrminmax - Return the min and max value of the given double array.
- *
- * Modified:
- *    Robb Matzke, Wed Jan 11 06:44:16 PST 1995
- *    Changed name from darrminmax since that conflicted with MeshTV.
- *
- *    Sean Ahern, Tue Sep 28 11:00:13 PDT 1999
- *    Made the error messages a little better.
- *---------------------------------------------------------------------------*/
+/* Sorted, distinct 0-origin nodes of the zone in NL[START,END) into BUF */
 INTERNAL int
-_DBdarrminmax(double arr[], int len, double *arr_min, double *arr_max)
+db_ZoneNodes(int const *nl, int start, int end, int polyhedron, int origin,
+    int *buf)
 {
-    int             i;
-    char           *me = "_DBdarrminmax";
-
-    if (!arr)
-        return db_perror("arr pointer", E_BADARGS, me);
-    if (len <= 0)
-        return db_perror("len", E_BADARGS, me);
+    int i, j, n = 0;
 
-    *arr_min = arr[0];
-    *arr_max = arr[0];
+    if (polyhedron)
+    {
+        int f, nf = nl[start++];
+        for (f = 0; f < nf; f++)
+        {
+            int nn = nl[start++];
+            for (j = 0; j < nn; j++)
+                buf[n++] = nl[start++] - origin;
+        }
+    }
+    else
+    {
+        for (j = start; j < end; j++)
+            buf[n++] = nl[j] - origin;
+    }
 
-    for (i = 1; i < len; i++)
+    /* Insertion sort; zones are small */
+    for (i = 1; i < n; i++)
     {
-        *arr_min = MIN(*arr_min, arr[i]);
-        *arr_max = MAX(*arr_max, arr[i]);
+        int v = buf[i];
+        for (j = i; j > 0 && buf[j-1] > v; j--)
+            buf[j] = buf[j-1];
+        buf[j] = v;
     }
+    for (i = j = 0; i < n; i++)
+        if (j == 0 || buf[j-1] != buf[i])
+            buf[j++] = buf[i];
+    return j;
+}
 
-    return 0;
+/* Order (key << 32 | index) pairs */
+static int
+db_ull_compare(void const *a, void const *b)
+{
+    unsigned long long const x = *((unsigned long long const *) a);
+    unsigned long long const y = *((unsigned long long const *) b);
+    return x < y ? -1 : (x > y ? 1 : 0);
 }
 
-INTERNAL int
-include_point(int ptidx, int ndims, int const *dims,
-    int const *minidx, int const *maxidx)
+/* Breadth first search of the node graph from ROOT over nodes whose mark
+   is not STAMP, marking them. Neighbors are visited in order of
+   increasing degree. Appends to QUEUE and returns the new queue length.
+   *LAST receives the queue position of the last level. */
+static int
+db_rcm_bfs(int root, int const *xadj, int const *adj, int *mark, int stamp,
+    int *queue, int qlen, int *last)
 {
-    if (dims == 0) return 1;
+    int head = qlen, levelend;
 
-    int i = ndims>0 ? (ptidx)                   % dims[0] : 0;
-    int j = ndims>1 ? (ptidx/dims[0])           % dims[1] : 0;
-    int k = ndims>2 ? (ptidx/(dims[1]*dims[0])) % dims[2] : 0;
+    queue[qlen++] = root;
+    mark[root] = stamp;
+    *last = head;
+    levelend = qlen;
+    while (head < qlen)
+    {
+        int v = queue[head++], first = qlen, i, j;
 
-    if (i < minidx[0]) return 0;
-    if (i > maxidx[0]) return 0;
-    if (j < minidx[1]) return 0;
-    if (j > maxidx[1]) return 0;
-    if (k < minidx[2]) return 0;
-    if (k > maxidx[2]) return 0;
+        for (i = xadj[v]; i < xadj[v+1]; i++)
+        {
+            int w = adj[i];
+            if (mark[w] == stamp)
+                continue;
+            mark[w] = stamp;
+            queue[qlen++] = w;
+        }
+        for (i = first + 1; i < qlen; i++)
+        {
+            int w = queue[i], dw = xadj[w+1] - xadj[w];
+            for (j = i; j > first && xadj[queue[j-1]+1] - xadj[queue[j-1]] > dw; j--)
+                queue[j] = queue[j-1];
+            queue[j] = w;
+        }
+        if (head == levelend && head < qlen)
+        {
+            *last = head;
+            levelend = qlen;
+        }
+    }
+    return qlen;
+}
 
-    return 1;
+/* Order the zones of each block by ZKEY, (key << 32 | zone) pairs */
+static void
+db_SortZonesInBlocks(int nzones, int const *blk, unsigned long long *zkey,
+    int *zperm)
+{
+    int b, e;
+
+    for (b = 0; b < nzones; b = e)
+    {
+        for (e = b + 1; e < nzones && blk[e] == blk[b]; e++)
+            ;
+        qsort(zkey + b, e - b, sizeof(unsigned long long), db_ull_compare);
+    }
+    for (b = 0; b < nzones; b++)
+        zperm[b] = (int) (zkey[b] & 0xFFFFFFFFULL);
 }
 
 /*----------------------------------------------------------------------
- * Routine                                               _CalcExtents
- *
- * Purpose: Return min/max of each dimension of coordinate array data
+ * Routine                                          db_CalcUcdmeshReorder
  *
- * Modifications:
- *      Sean Ahern, Wed Oct 21 10:55:21 PDT 1998
- *      Changed the function so that the min_extents and max_extents are 
- *      passed in as void* variables.
+ * Purpose: Does the work of DBCalcUcdmeshReorder on checked arguments.
  *
- *      Mark C. Miller, Mon May 20 12:25:25 PDT 2024
- *      Adjusted to avoid strict pointer aliasing optimization issues.
+ * Return: 0 on success, -1 if memory is exhausted.
  *--------------------------------------------------------------------*/
-INTERNAL int
-_CalcExtents(DBVCP2_t coord_arrays, int datatype, int ndims, int npts,
-             void *min_extents, void *max_extents,
-             int const *dims, int const *minidx, int const *maxidx)
+static int
+db_CalcUcdmeshReorder(int method, int ndims, int nnodes,
+    void const * const *coords, int datatype, int nzones, int const *nodelist,
+    int origin, int const *shapetype, int const *starts, int const *blk,
+    int *nperm, int *zperm)
 {
-    int i, j, first;
+    int *buf = NULL, *newidx = NULL, *xadj = NULL, *adj = NULL;
+    int *order = NULL, *mark = NULL, *bydeg = NULL;
+    unsigned long long *zkey = NULL, *dk = NULL;
+    double *cent[3] = {NULL, NULL, NULL};
+    int i, j, z, d, n, maxlen = 0, retval = -1;
+
+    for (z = 0; z < nzones; z++)
+        maxlen = MAX(maxlen, starts[z+1] - starts[z]);
+    buf = (int *) malloc((maxlen + 1) * sizeof(int));
+    newidx = (int *) malloc(nnodes * sizeof(int));
+    zkey = (unsigned long long *) malloc(nzones * sizeof(unsigned long long));
+    if (!buf || !newidx || !zkey)
+        goto done;
+
+#define POLY(Z) (shapetype && shapetype[blk[Z]/3] == DB_ZONETYPE_POLYHEDRON)
+#define DEG(V) (xadj[(V)+1] - xadj[V])
+
+    if (method == DB_SORT_RCM)
+    {
+        int next = 0, qlen = 0, stamp = 0, nused;
 
-    if (npts <= 0) return 0;
+        /* Node graph joining the nodes of each zone */
+        if ((xadj = (int *) calloc(nnodes + 1, sizeof(int))) == NULL)
+            goto done;
+        for (z = 0; z < nzones; z++)
+        {
+            n = db_ZoneNodes(nodelist, starts[z], starts[z+1], POLY(z), origin, buf);
+            for (j = 0; j < n; j++)
+                xadj[buf[j]+1] += n - 1;
+        }
+        for (i = 0; i < nnodes; i++)
+            xadj[i+1] += xadj[i];
+        if ((adj = (int *) malloc(((size_t) xadj[nnodes] + 1) * sizeof(int))) == NULL)
+            goto done;
+        memcpy(newidx, xadj, nnodes * sizeof(int));
+        for (z = 0; z < nzones; z++)
+        {
+            n = db_ZoneNodes(nodelist, starts[z], starts[z+1], POLY(z), origin, buf);
+            for (j = 0; j < n; j++)
+                for (i = 0; i < n; i++)
+                    if (i != j)
+                        adj[newidx[buf[j]]++] = buf[i];
+        }
 
-    if (datatype == DB_DOUBLE) {
+        /* Drop repeated edges, compacting the rows */
+        for (i = n = 0; i < nnodes; i++)
+        {
+            int b = xadj[i], e = xadj[i+1], k;
+            qsort(adj + b, e - b, sizeof(int), db_int_compare);
+            xadj[i] = n;
+            for (k = b; k < e; k++)
+                if (k == b || adj[k] != adj[k-1])
+                    adj[n++] = adj[k];
+        }
+        xadj[nnodes] = n;
+
+        /* Nodes by increasing degree, for picking start nodes */
+        mark = (int *) calloc(nnodes, sizeof(int));
+        bydeg = (int *) malloc(nnodes * sizeof(int));
+        order = (int *) malloc(nnodes * sizeof(int));
+        dk = (unsigned long long *) malloc(nnodes * sizeof(unsigned long long));
+        if (!mark || !bydeg || !order || !dk)
+            goto done;
+        for (i = 0; i < nnodes; i++)
+            dk[i] = ((unsigned long long) DEG(i) << 32) | (unsigned) i;
+        qsort(dk, nnodes, sizeof(unsigned long long), db_ull_compare);
+        for (i = 0; i < nnodes; i++)
+            bydeg[i] = (int) (dk[i] & 0xFFFFFFFFULL);
+
+        /* Cuthill-McKee on each connected piece, started from the least
+           connected node of the last level of a search from its least
+           connected node */
+        for (;;)
+        {
+            int root, last, end, k;
 
-        double *dmin_extents = (double *) min_extents;
-        double *dmax_extents = (double *) max_extents;
-        double const * const * _coord_arrays = (double const * const *) coord_arrays;
-        double const *dcoord_arrays[3] = {_coord_arrays[0], _coord_arrays[1], _coord_arrays[2]};
+            while (next < nnodes && (mark[bydeg[next]] || DEG(bydeg[next]) == 0))
+                next++;
+            if (next == nnodes)
+                break;
+            root = bydeg[next];
+            end = db_rcm_bfs(root, xadj, adj, mark, ++stamp, order, qlen, &last);
+            for (k = last, root = order[last]; k < end; k++)
+                if (DEG(order[k]) < DEG(root))
+                    root = order[k];
+            qlen = db_rcm_bfs(root, xadj, adj, mark, ++stamp, order, qlen, &last);
+        }
 
-        for (i = 0; i < ndims; i++)
+        /* Reversed, then the unused nodes */
+        nused = qlen;
+        for (i = 0; i < nused; i++)
+            nperm[i] = order[nused-1-i];
+        for (i = 0; i < nnodes; i++)
+            if (!mark[i])
+                nperm[qlen++] = i;
+
+        /* Zones by their lowest new node number */
+        for (i = 0; i < nnodes; i++)
+            newidx[nperm[i]] = i;
+        for (z = 0; z < nzones; z++)
         {
-            for (j = 0, first = 1; j < npts; j++)
-            {
-                if (include_point(j, ndims, dims, minidx, maxidx))
-                {
-                    if (first)
-                    {
-                        first = 0;
-                        dmin_extents[i] = dcoord_arrays[i][j];
-                        dmax_extents[i] = dcoord_arrays[i][j];
-                    }
-                    else
-                    {
-                        dmin_extents[i] = MIN(dmin_extents[i], dcoord_arrays[i][j]);
-                        dmax_extents[i] = MAX(dmax_extents[i], dcoord_arrays[i][j]);
-                    }
-                }
-            }
+            int lo = nnodes;
+            n = db_ZoneNodes(nodelist, starts[z], starts[z+1], POLY(z), origin, buf);
+            for (j = 0; j < n; j++)
+                lo = MIN(lo, newidx[buf[j]]);
+            zkey[z] = ((unsigned long long) lo << 32) | (unsigned) z;
         }
+        db_SortZonesInBlocks(nzones, blk, zkey, zperm);
     }
     else
     {
-        float *fmin_extents = (float *) min_extents;
-        float *fmax_extents = (float *) max_extents;
-        float  const * const * _coord_arrays = (float const * const *) coord_arrays;
-        float const *fcoord_arrays[3] = {_coord_arrays[0], _coord_arrays[1], _coord_arrays[2]};
-
-        for (i = 0; i < ndims; i++)
+        int nnew = 0;
+
+        /* Zones along a Morton curve through their centroids */
+        order = (int *) malloc(nzones * sizeof(int));
+        if (!order)
+            goto done;
+        for (d = 0; d < ndims; d++)
+            if ((cent[d] = (double *) malloc(nzones * sizeof(double))) == NULL)
+                goto done;
+        for (z = 0; z < nzones; z++)
         {
-            for (j = 0, first = 1; j < npts; j++)
+            n = db_ZoneNodes(nodelist, starts[z], starts[z+1], POLY(z), origin, buf);
+            for (d = 0; d < ndims; d++)
             {
-                if (include_point(j, ndims, dims, minidx, maxidx))
+                double sum = 0;
+                for (j = 0; j < n; j++)
+                    sum += db_coord_value(coords[d], datatype, buf[j]);
+                cent[d][z] = n > 0 ? sum / n : 0;
+            }
+        }
+        if (db_MortonOrder(ndims, (void const * const *) cent, DB_DOUBLE, nzones, order) < 0)
+            goto done;
+        for (i = 0; i < nzones; i++)
+            zkey[order[i]] = ((unsigned long long) i << 32) | (unsigned) order[i];
+        db_SortZonesInBlocks(nzones, blk, zkey, zperm);
+
+        /* Nodes in the order the zones first touch them */
+        for (i = 0; i < nnodes; i++)
+            newidx[i] = -1;
+        for (i = 0; i < nzones; i++)
+        {
+            z = zperm[i];
+            n = db_ZoneNodes(nodelist, starts[z], starts[z+1], POLY(z), origin, buf);
+            for (j = 0; j < n; j++)
+                if (newidx[buf[j]] < 0)
                 {
-                    if (first)
-                    {
-                        first = 0;
-                        fmin_extents[i] = fcoord_arrays[i][j];
-                        fmax_extents[i] = fcoord_arrays[i][j];
-                    }
-                    else
-                    {
-                        fmin_extents[i] = MIN(fmin_extents[i], fcoord_arrays[i][j]);
-                        fmax_extents[i] = MAX(fmax_extents[i], fcoord_arrays[i][j]);
-                    }
+                    newidx[buf[j]] = nnew;
+                    nperm[nnew++] = buf[j];
                 }
-            }
         }
+        for (i = 0; i < nnodes; i++)
+            if (newidx[i] < 0)
+                nperm[nnew++] = i;
     }
+#undef POLY
+#undef DEG
+    retval = 0;
 
-    return 0;
+done:
+    FREE(buf);
+    FREE(newidx);
+    FREE(xadj);
+    FREE(adj);
+    FREE(order);
+    FREE(mark);
+    FREE(bydeg);
+    FREE(zkey);
+    FREE(dk);
+    for (d = 0; d < 3; d++)
+        FREE(cent[d]);
+    return retval;
+}
+
+/*----------------------------------------------------------------------
+ * Routine                                          DBCalcUcdmeshReorder
+ *
+ * Purpose: Compute node and zone orderings of an unstructured mesh that
+ *     improve memory locality.
+ *
+ * Return: 0 on success, -1 on failure. *NODEPERM (NNODES ints) and
+ *     *ZONEPERM (NZONES ints) are to be freed with free(). Entry i of
+ *     each is the caller's index of the node or zone to be stored i'th.
+ *
+ * Description: With DB_SORT_RCM, nodes are numbered by reverse
+ *     Cuthill-McKee on the graph joining nodes that share a zone and
+ *     zones are then ordered by their lowest new node number. With
+ *     DB_SORT_MORTON, zones are ordered along a Morton curve through
+ *     their centroids and nodes are numbered in the order the zones
+ *     first touch them. COORDS is only needed for DB_SORT_MORTON.
+ *
+ *     Zones are only moved within their shape group and within the low
+ *     ghost, real and high ghost ranges, so the permuted zonelist keeps
+ *     its shape and ghost arguments. Nodes no zone uses go last, in
+ *     their original order. The results are meant to be passed to the
+ *     Put calls with DBOPT_NODE_PERM and DBOPT_ZONE_PERM.
+ *--------------------------------------------------------------------*/
+PUBLIC int
+DBCalcUcdmeshReorder(int method, int ndims, int nnodes, DBVCP2_t _coords,
+    int datatype, int nzones, int const *nodelist, int lnodelist, int origin,
+    int lo_offset, int hi_offset, int const *shapetype, int const *shapesize,
+    int const *shapecnt, int nshapes, int **nodeperm, int **zoneperm)
+{
+    void const * const *coords = (void const * const *) _coords;
+    int *starts = NULL, *blk = NULL, *nperm = NULL, *zperm = NULL;
+    int i, d, z, err;
+
+    API_BEGIN("DBCalcUcdmeshReorder", int, -1) {
+        if (!nodeperm || !zoneperm)
+            API_ERROR("nodeperm=0 || zoneperm=0", E_BADARGS);
+        *nodeperm = *zoneperm = NULL;
+        if (method != DB_SORT_RCM && method != DB_SORT_MORTON)
+            API_ERROR("method", E_BADARGS);
+        if (nnodes <= 0 || nzones <= 0)
+            API_ERROR("nnodes<=0 || nzones<=0", E_BADARGS);
+        if (!nodelist)
+            API_ERROR("nodelist=0", E_BADARGS);
+        if (0 != origin && 1 != origin)
+            API_ERROR("origin!=0||1", E_BADARGS);
+        if (lo_offset < 0 || hi_offset < 0 || lo_offset + hi_offset > nzones)
+            API_ERROR("lo_offset, hi_offset", E_BADARGS);
+        if (method == DB_SORT_MORTON)
+        {
+            if (ndims < 1 || ndims > 3)
+                API_ERROR("ndims", E_BADARGS);
+            if (datatype != DB_FLOAT && datatype != DB_DOUBLE)
+                API_ERROR("datatype", E_BADARGS);
+            for (d = 0; d < ndims && coords; d++)
+                if (!coords[d]) coords = 0;
+            if (!coords)
+                API_ERROR("coords==0 || coords[i]==0", E_BADARGS);
+        }
+
+        starts = db_ZoneStarts(nzones, nodelist, lnodelist, lo_offset,
+                     hi_offset, shapetype, shapesize, shapecnt, nshapes, &blk);
+        if (!starts)
+            API_ERROR("shapecnt, shapesize", E_BADARGS);
+        nperm = (int *) malloc((starts[nzones] + 1) * sizeof(int));
+        for (z = 0, err = 0; nperm && z < nzones && !err; z++)
+        {
+            int poly = shapetype && shapetype[blk[z]/3] == DB_ZONETYPE_POLYHEDRON;
+            int n = db_ZoneNodes(nodelist, starts[z], starts[z+1], poly, origin, nperm);
+            for (i = 0; i < n; i++)
+                if (nperm[i] < 0 || nperm[i] >= nnodes) err = 1;
+        }
+        FREE(nperm);
+        if (err)
+        {
+            FREE(starts);
+            FREE(blk);
+            API_ERROR("nodelist entry out of range", E_BADARGS);
+        }
+
+        nperm = (int *) malloc(nnodes * sizeof(int));
+        zperm = (int *) malloc(nzones * sizeof(int));
+        err = !nperm || !zperm ||
+              db_CalcUcdmeshReorder(method, ndims, nnodes, coords, datatype,
+                  nzones, nodelist, origin, shapetype, starts, blk, nperm, zperm) < 0;
+        FREE(starts);
+        FREE(blk);
+        if (err)
+        {
+            FREE(nperm);
+            FREE(zperm);
+            API_ERROR(NULL, E_NOMEM);
+        }
+        *nodeperm = nperm;
+        *zoneperm = zperm;
+    }
+    API_END;
+
+    return(0);
 }
 
 /*----------------------------------------------------------------------
@@ -11697,6 +15018,14 @@ db_ProcessOptlist(int objtype, DBoptlist const * const optlist)
                         _pm._alt_nodenum_vars = (char **) optlist->values[i];
                         break;
 
+                    case DBOPT_SPATIAL_SORT:
+                        _pm._spatial_sort = DEREF(int, optlist->values[i]);
+                        break;
+
+                    case DBOPT_SORT_CHUNK_SIZE:
+                        _pm._sort_chunk_size = DEREF(int, optlist->values[i]);
+                        break;
+
                     default:
                         unused++;
                         break;
@@ -13274,7 +16603,6 @@ db_StringListToStringArrayMBOpt(char *strList, char ***retArray, char **alloc_fl
                 slashCharsToSwap[s++] = i;
                 if (s == sizeof(slashCharsToSwap)/sizeof(slashCharsToSwap[0]))
                 {
-                    free(strList);
                     free(strArray);
                     return db_perror("exceeded slashCharsToSwap size", E_INTERNAL, me);
                 }
@@ -13347,6 +16675,154 @@ DBSortObjectsByOffset(DBfile *dbfile, int nobjs,
     API_END_NOPOP;  /* If API_RETURN above is removed, use API_END instead */
 }
 
+/* Read an object of any of the types DBReadObjects supports */
+PRIVATE void *
+db_GetObjectOfType(DBfile *dbfile, int type, char const *name)
+{
+    switch (type)
+    {
+        case DB_QUADMESH:
+        case DB_QUADRECT:
+        case DB_QUADCURV:       return DBGetQuadmesh(dbfile, name);
+        case DB_QUADVAR:        return DBGetQuadvar(dbfile, name);
+        case DB_UCDMESH:        return DBGetUcdmesh(dbfile, name);
+        case DB_UCDVAR:         return DBGetUcdvar(dbfile, name);
+        case DB_POINTMESH:      return DBGetPointmesh(dbfile, name);
+        case DB_POINTVAR:       return DBGetPointvar(dbfile, name);
+        case DB_CSGMESH:        return DBGetCsgmesh(dbfile, name);
+        case DB_CSGVAR:         return DBGetCsgvar(dbfile, name);
+        case DB_MATERIAL:       return DBGetMaterial(dbfile, name);
+        case DB_MATSPECIES:     return DBGetMatspecies(dbfile, name);
+        case DB_MULTIMESH:      return DBGetMultimesh(dbfile, name);
+        case DB_MULTIVAR:       return DBGetMultivar(dbfile, name);
+        case DB_MULTIMAT:       return DBGetMultimat(dbfile, name);
+        case DB_MULTIMATSPECIES: return DBGetMultimatspecies(dbfile, name);
+        case DB_FACELIST:       return DBGetFacelist(dbfile, name);
+        case DB_ZONELIST:       return DBGetZonelist(dbfile, name);
+        case DB_PHZONELIST:     return DBGetPHZonelist(dbfile, name);
+        case DB_CSGZONELIST:    return DBGetCSGZonelist(dbfile, name);
+        case DB_CURVE:          return DBGetCurve(dbfile, name);
+        case DB_DEFVARS:        return DBGetDefvars(dbfile, name);
+        case DB_ARRAY:          return DBGetCompoundarray(dbfile, name);
+        case DB_MRGTREE:        return DBGetMrgtree(dbfile, name);
+        case DB_GROUPELMAP:     return DBGetGroupelmap(dbfile, name);
+        case DB_MRGVAR:         return DBGetMrgvar(dbfile, name);
+        case DB_VARIABLE:       return DBGetVar(dbfile, name);
+    }
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBReadObjects
+ *
+ * Purpose:     Read a list of objects, of any type, in one call. Drivers
+ *              able to do so first read the raw data of all the objects
+ *              in file offset order, merging the byte ranges of data
+ *              separated by no more than GAP bytes into single reads.
+ *              The objects are then decoded from the data in memory.
+ *              A negative GAP selects the driver's default.
+ *
+ *              On return, types[i] holds the DBObjectType of the i'th
+ *              object and objs[i] the object as returned by its DBGetXxx
+ *              call or NULL if it could not be read.
+ *
+ * Return:      Success:        Number of objects read.
+ *              Failure:        -1
+ *-------------------------------------------------------------------------*/
+PUBLIC int
+DBReadObjects(DBfile *dbfile, int nobjs, char const * const *names, int gap,
+    int *types, void **objs)
+{
+    int i, n = 0;
+
+    API_BEGIN2("DBReadObjects", int, -1, api_dummy);
+    {
+        if (!dbfile)
+            API_ERROR(NULL, E_NOFILE);
+        if (nobjs < 0)
+            API_ERROR("nobjs", E_BADARGS);
+        if (nobjs && !names)
+            API_ERROR("names", E_BADARGS);
+        if (nobjs && !types)
+            API_ERROR("types", E_BADARGS);
+        if (nobjs && !objs)
+            API_ERROR("objs", E_BADARGS);
+
+        /* Staging is only an optimization. So, ignore its failure. */
+        if (dbfile->pub.stage_objs)
+            (dbfile->pub.stage_objs) (dbfile, nobjs, names, gap);
+
+        for (i = 0; i < nobjs; i++)
+        {
+            types[i] = DB_INVALID_OBJECT;
+            objs[i] = 0;
+            if (!names[i] || !DBInqVarExists(dbfile, names[i]))
+                continue;
+            types[i] = DBInqVarType(dbfile, names[i]);
+            if ((objs[i] = db_GetObjectOfType(dbfile, types[i], names[i])))
+                n++;
+        }
+
+        if (dbfile->pub.stage_objs)
+            (dbfile->pub.stage_objs) (dbfile, 0, 0, 0);
+
+        API_RETURN(n);
+    }
+    API_END_NOPOP;  /* If API_RETURN above is removed, use API_END instead */
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    DBFreeObjects
+ *
+ * Purpose:     Free objects returned by DBReadObjects.
+ *-------------------------------------------------------------------------*/
+PUBLIC void
+DBFreeObjects(int nobjs, int const *types, void **objs)
+{
+    int i;
+
+    if (!types || !objs)
+        return;
+
+    for (i = 0; i < nobjs; i++)
+    {
+        void *o = objs[i];
+        if (!o) continue;
+        switch (types[i])
+        {
+            case DB_QUADMESH:
+            case DB_QUADRECT:
+            case DB_QUADCURV:       DBFreeQuadmesh((DBquadmesh*)o); break;
+            case DB_QUADVAR:        DBFreeQuadvar((DBquadvar*)o); break;
+            case DB_UCDMESH:        DBFreeUcdmesh((DBucdmesh*)o); break;
+            case DB_UCDVAR:         DBFreeUcdvar((DBucdvar*)o); break;
+            case DB_POINTMESH:      DBFreePointmesh((DBpointmesh*)o); break;
+            case DB_POINTVAR:       DBFreeMeshvar((DBmeshvar*)o); break;
+            case DB_CSGMESH:        DBFreeCsgmesh((DBcsgmesh*)o); break;
+            case DB_CSGVAR:         DBFreeCsgvar((DBcsgvar*)o); break;
+            case DB_MATERIAL:       DBFreeMaterial((DBmaterial*)o); break;
+            case DB_MATSPECIES:     DBFreeMatspecies((DBmatspecies*)o); break;
+            case DB_MULTIMESH:      DBFreeMultimesh((DBmultimesh*)o); break;
+            case DB_MULTIMESHADJ:   DBFreeMultimeshadj((DBmultimeshadj*)o); break;
+            case DB_MULTIVAR:       DBFreeMultivar((DBmultivar*)o); break;
+            case DB_MULTIMAT:       DBFreeMultimat((DBmultimat*)o); break;
+            case DB_MULTIMATSPECIES: DBFreeMultimatspecies((DBmultimatspecies*)o); break;
+            case DB_FACELIST:       DBFreeFacelist((DBfacelist*)o); break;
+            case DB_ZONELIST:       DBFreeZonelist((DBzonelist*)o); break;
+            case DB_PHZONELIST:     DBFreePHZonelist((DBphzonelist*)o); break;
+            case DB_CSGZONELIST:    DBFreeCSGZonelist((DBcsgzonelist*)o); break;
+            case DB_CURVE:          DBFreeCurve((DBcurve*)o); break;
+            case DB_DEFVARS:        DBFreeDefvars((DBdefvars*)o); break;
+            case DB_ARRAY:          DBFreeCompoundarray((DBcompoundarray*)o); break;
+            case DB_MRGTREE:        DBFreeMrgtree((DBmrgtree*)o); break;
+            case DB_GROUPELMAP:     DBFreeGroupelmap((DBgroupelmap*)o); break;
+            case DB_MRGVAR:         DBFreeMrgvar((DBmrgvar*)o); break;
+            default:                free(o); break;
+        }
+        objs[i] = 0;
+    }
+}
+
 /*----------------------------------------------------------------------
  * Purpose
  *
@@ -14613,7 +18089,9 @@ DBGetMrgtree(DBfile *dbfile, const char *name)
         if (!dbfile->pub.g_mrgt)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
+        db_alloc_begin(dbfile);
         retval = (dbfile->pub.g_mrgt) (dbfile, name);
+        db_alloc_end(DB_MRGTREE, retval);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
@@ -14674,7 +18152,9 @@ DBGetGroupelmap(DBfile *dbfile, const char *name)
         if (!dbfile->pub.g_grplm)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
+        db_alloc_begin(dbfile);
         retval = (dbfile->pub.g_grplm) (dbfile, name);
+        db_alloc_end(DB_GROUPELMAP, retval);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
@@ -14737,7 +18217,9 @@ DBGetMrgvar(DBfile *dbfile, const char *name)
         if (!dbfile->pub.g_mrgv)
             API_ERROR(dbfile->pub.name, E_NOTIMP);
 
+        db_alloc_begin(dbfile);
         retval = (dbfile->pub.g_mrgv) (dbfile, name);
+        db_alloc_end(DB_MRGVAR, retval);
         API_RETURN(retval);
     }
     API_END_NOPOP; /*BEWARE: If API_RETURN above is removed use API_END */
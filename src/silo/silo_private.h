@@ -271,11 +271,14 @@ typedef struct context_t {
                         if (!SILO_Globals.Jstk){                              \
                            jstk_push() ;                                      \
                            if (setjmp(SILO_Globals.Jstk->jbuf)) {             \
+                              db_stats_end () ;                               \
                               while (SILO_Globals.Jstk) jstk_pop () ;         \
+                              db_alloc_reset () ;                             \
                               db_perror ("", db_errno, me) ;                  \
                               return R ;                                      \
                            }                                                  \
                            jstat = 1 ;                                        \
+                           db_stats_begin (NULL, me) ;                        \
                         }
 
 #define API_DEPRECATE2(M,T,R,NM,Maj,Min,Alt)                                  \
@@ -306,11 +309,14 @@ typedef struct context_t {
                               if (jold) {                                     \
                                  context_restore (jdbfile, jold) ;            \
                               }                                               \
+                              db_stats_end () ;                               \
                               while (SILO_Globals.Jstk) jstk_pop () ;         \
+                              db_alloc_reset () ;                             \
                               db_perror ("", db_errno, me) ;                  \
                               return R ;                                      \
                            }                                                  \
                            jstat = 1 ;                                        \
+                           db_stats_begin (jdbfile, me) ;                     \
                            if (NM && jdbfile && !jdbfile->pub.pathok) {       \
                               char const *jr ;                                \
                               jold = context_switch (jdbfile,NM,&jr) ;        \
@@ -320,7 +326,7 @@ typedef struct context_t {
                         }
 
 #define API_END         if (jold) context_restore (jdbfile, jold) ;     \
-                        if (jstat) jstk_pop() ;                         \
+                        if (jstat) {db_stats_end(); jstk_pop();}        \
                      }                        /*API_BEGIN or API_BEGIN2 */
 
 #define API_END_NOPOP   }         /*API_BEGIN or API_BEGIN2 */
@@ -328,14 +334,14 @@ typedef struct context_t {
 #define API_ERROR(S,N)  {                                               \
                            db_perror (S,N,me) ; /*might never return*/  \
                            if (jold) context_restore (jdbfile, jold) ;  \
-                           if (jstat) jstk_pop() ;                      \
+                           if (jstat) {db_stats_end(); jstk_pop();}     \
                            return jrv ;                                 \
                         }
 
 #define API_RETURN(R)   {                                               \
                            jrv = R ; /*might be a calculation*/         \
                            if (jold) context_restore (jdbfile, jold) ;  \
-                           if (jstat) jstk_pop() ;                      \
+                           if (jstat) {db_stats_end(); jstk_pop();}     \
                            return jrv ;                                 \
                         }
 
@@ -380,12 +386,16 @@ typedef struct context_t {
  * drivers which is visible to any other device driver or
  * SILO proper must be allocated with the C library memory
  * management (malloc, calloc, realloc, strdup, free...).
+ * The exception is the memory of objects built during a DBGetXxx
+ * call, which db_malloc/db_calloc may take from a DBarena or a user
+ * allocator (see alloc.c). Such memory is released with db_free,
+ * which FREE uses and which hands any other pointer to free().
  */
 #define ALLOC(T)                ((T*)calloc((size_t)1,sizeof(T)))
 #define ALLOC_N(T,N)            ((T*)((N)>0?calloc((size_t)(N),sizeof(T)):0))
 #define REALLOC(P,T,N)  REALLOC_N((P),(T),(N))
 #define REALLOC_N(P,T,N)        ((T*)((N)>0?realloc((P),(size_t)((N)*sizeof(T))):0))
-#define FREE(M)         if(M){free(M);(M)=NULL;}
+#define FREE(M)         if(M){db_free(M);(M)=NULL;}
 #define STRDUP(S)               _db_safe_strdup((S))
 #define STRNDUP(S,N)            db_strndup((S),(N))
 
@@ -432,6 +442,23 @@ typedef struct context_t {
     }                                      \
 }
 
+/*
+ * Layout of the multi-block bounding volume hierarchy made by
+ * db_MakeBlockBVH: a header followed by one record per tree node.
+ */
+#define DB_BVH_VERSION          1
+#define DB_BVH_HDRLEN           4
+#define DB_BVH_RECLEN(ND)       (2*(ND)+2)
+
+/*
+ * Layout of the chunk index of a spatially sorted point mesh made by
+ * db_SortPointmesh: ndims, nels and the chunk size followed by a BVH
+ * of the chunk bounding boxes.
+ */
+#define DB_PMIDX_VERSION        1
+#define DB_PMIDX_HDRLEN         4
+#define DB_PMIDX_CHUNK          4096
+
 /*
  * Global data for Material
  */
@@ -491,6 +518,8 @@ struct _pm {
     double         _missing_value;
     char          *_ghost_node_labels;
     char         **_alt_nodenum_vars;
+    int            _spatial_sort;
+    int            _sort_chunk_size;
 
     /*These used only by NetCDF driver */
     int            _dim_ndims;
@@ -845,6 +874,12 @@ typedef struct SILO_Globals_t {
     char *compressionParams;
     float compressionMinratio;
     int compressionErrmode;
+    char *dedupParams;
+    int floatStorage;
+    DBAllocFunc allocFunc;
+    DBFreeFunc freeFunc;
+    void *allocUser;
+    DBarena *arena;
     int compatibilityMode;
     const DBoptlist *fileOptionsSets[MAX_FILE_OPTIONS_SETS];
     int _db_err_level;
@@ -892,6 +927,22 @@ INTERNAL void _DBsort_list (char **, int);
 INTERNAL int _DBarrminmax (float *, int, float *, float *);
 INTERNAL int _DBiarrminmax (int *, int, int *, int *);
 INTERNAL int _DBdarrminmax (double *, int, double *, double *);
+INTERNAL int _DBminmax (void const *, int, int, int const *, int const *, int const *,
+                       double *, double *);
+INTERNAL int _DBVarRange (int, DBVCP2_t, int, int, int const *, int const *, int const *,
+                          double [2]);
+INTERNAL double *db_MakeBlockBVH (int, int, double const *, char const * const *,
+                                  int const *, int, int *);
+INTERNAL double *db_MakeBlockRangeBVH (int, int, double const *, char const * const *,
+                                       int const *, int, int *);
+INTERNAL int db_QueryBlockBVH (double const *, int, int, double const *, int **);
+INTERNAL int db_SortPointmesh (int, DBVCP2_t, int, int, int, int, int,
+                               void **, int **, double **, int *);
+INTERNAL void *db_PermuteArray (void const *, int, size_t, int const *);
+INTERNAL int *db_InvertPerm (int const *, int, int);
+INTERNAL int *db_ZoneStarts (int, int const *, int, int, int, int const *,
+                             int const *, int const *, int, int **);
+INTERNAL int db_ZoneNodes (int const *, int, int, int, int, int *);
 INTERNAL char *db_strerror (int);
 INTERNAL int db_ListDir2 (DBfile *, char **, int, int, char **,
                               int *);
@@ -935,5 +986,26 @@ INTERNAL const int *db_get_used_file_options_sets_ids();
 
 INTERNAL int db_StringListToStringArrayMBOpt(char *strList, char ***strArray, char **alloc_flag, int nblocks);
 INTERNAL int db_fix_obsolete_centering(int ndims, float const *align, int carfm);
+INTERNAL unsigned long long db_hash64(void const *buf, size_t len, unsigned long long seed);
+INTERNAL void *db_malloc(size_t nbytes);
+INTERNAL void *db_calloc(size_t n, size_t size);
+INTERNAL void db_free(void *ptr);
+INTERNAL void db_alloc_begin(DBfile *dbfile);
+INTERNAL void db_alloc_push(DBarena *arena, DBAllocFunc alloc, DBFreeFunc free, void *user);
+INTERNAL void db_alloc_end(int type, void *obj);
+INTERNAL void db_alloc_reset(void);
+INTERNAL void db_ForgetArena(DBarena *arena);
+INTERNAL double db_stats_clock(void);
+INTERNAL void db_stats_begin(DBfile *dbfile, char const *name);
+INTERNAL void db_stats_file(DBfile *dbfile);
+INTERNAL void db_stats_cancel(void);
+INTERNAL void db_stats_end(void);
+INTERNAL int db_stats_active(void);
+INTERNAL unsigned long db_stats_call_id(void);
+INTERNAL void db_stats_read(long long nbytes, long long stored);
+INTERNAL void db_stats_write(long long nbytes, long long stored);
+INTERNAL void db_stats_dataset(void);
+INTERNAL void db_stats_filter(double seconds);
+INTERNAL void db_stats_forget(int fileid);
 
 #endif /* !SILO_PRIVATE_H */
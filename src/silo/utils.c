@@ -449,3 +449,419 @@ int DBCalcDenseArraysFromMaterial(DBmaterial const *mat, int datatype, int *narr
     }
     API_END_NOPOP;
 }
+
+/*----------------------------------------------------------------------
+ * Routine:  db_CalcMaterialCSRFromMaterial
+ *
+ * Purpose:  Convert a material's mixed linked lists to compressed sparse
+ *    row (CSR) form.
+ *
+ * Description:  Every zone gets a contiguous run of (material, fraction)
+ *    entries. Clean zones get one entry with a fraction of one. Mixed zones
+ *    get one entry for each link of their mix_next chain, in chain order.
+ *    The work is done in two passes over zones, each of which is threaded
+ *    when OpenMP is enabled. The first counts the entries for each zone.
+ *    An exclusive prefix sum of the counts gives the offsets. The second
+ *    pass fills each zone's run independently of all the others. Chain
+ *    walks are bounded by mixlen so a corrupt (cyclic) chain cannot hang.
+ *--------------------------------------------------------------------*/
+#define DB_CSR_PARALLEL (1<<16) /* zones before using threads */
+
+static
+DBmaterialcsr *db_CalcMaterialCSRFromMaterial(DBmaterial const *mat)
+{
+    int i, nzones = 1, bad = 0;
+    int *offsets = 0, *matids = 0, *matnos = 0;
+    void *vf = 0;
+    size_t vfsize = mat->datatype == DB_FLOAT ? sizeof(float) : sizeof(double);
+    DBmaterialcsr *csr = 0;
+
+    for (i = 0; i < mat->ndims; i++)
+        nzones *= mat->dims[i];
+
+    offsets = (int *) malloc((nzones+1) * sizeof(int));
+    if (!offsets) goto cleanup;
+    matnos = (int *) malloc(mat->nmat * sizeof(int) + 1);
+    if (!matnos) goto cleanup;
+    memcpy(matnos, mat->matnos, mat->nmat * sizeof(int));
+
+    /* pass 1: count entries for each zone */
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:bad) if (nzones >= DB_CSR_PARALLEL)
+#endif
+    for (i = 0; i < nzones; i++)
+    {
+        int n = 1;
+        if (mat->matlist[i] < 0)
+        {
+            int mix_idx = -mat->matlist[i] - 1;
+            n = 0;
+            while (0 <= mix_idx && mix_idx < mat->mixlen && n <= mat->mixlen)
+            {
+                n++;
+                mix_idx = mat->mix_next[mix_idx] - 1;
+            }
+            if (mix_idx >= 0 || n == 0)
+                bad++;
+        }
+        offsets[i+1] = n;
+    }
+    if (bad) goto cleanup;
+
+    /* exclusive prefix sum of the counts */
+    offsets[0] = 0;
+    for (i = 0; i < nzones; i++)
+        offsets[i+1] += offsets[i];
+
+    matids = (int *) malloc(offsets[nzones] * sizeof(int) + 1);
+    if (!matids) goto cleanup;
+    vf = malloc(offsets[nzones] * vfsize + 1);
+    if (!vf) goto cleanup;
+
+    /* pass 2: fill each zone's run */
+#ifdef _OPENMP
+#pragma omp parallel for if (nzones >= DB_CSR_PARALLEL)
+#endif
+    for (i = 0; i < nzones; i++)
+    {
+        int k = offsets[i];
+        if (mat->matlist[i] >= 0)
+        {
+            matids[k] = mat->matlist[i];
+            put_frac(vf, k, mat->datatype, 1.0);
+        }
+        else
+        {
+            int mix_idx = -mat->matlist[i] - 1;
+            for (; k < offsets[i+1]; k++)
+            {
+                double f = mat->datatype == DB_FLOAT ?
+                    ((float const *) mat->mix_vf)[mix_idx] :
+                    ((double const *) mat->mix_vf)[mix_idx];
+                matids[k] = mat->mix_mat[mix_idx];
+                put_frac(vf, k, mat->datatype, f);
+                mix_idx = mat->mix_next[mix_idx] - 1;
+            }
+        }
+    }
+
+    csr = DBAllocMaterialCSR();
+    if (!csr) goto cleanup;
+    csr->nzones = nzones;
+    csr->ndims = mat->ndims;
+    for (i = 0; i < mat->ndims; i++)
+        csr->dims[i] = mat->dims[i];
+    csr->nmat = mat->nmat;
+    csr->matnos = matnos;
+    csr->offsets = offsets;
+    csr->matids = matids;
+    csr->datatype = mat->datatype;
+    csr->vf = vf;
+
+    return csr;
+
+cleanup:
+
+    FREE(offsets);
+    FREE(matnos);
+    FREE(matids);
+    FREE(vf);
+
+    return 0;
+}
+
+PUBLIC
+DBmaterialcsr *DBCalcMaterialCSRFromMaterial(DBmaterial const *mat)
+{
+    DBmaterialcsr *retval = 0;
+
+    API_BEGIN("DBCalcMaterialCSRFromMaterial", DBmaterialcsr*, 0) {
+        if (!mat)
+            API_ERROR("mat pointer", E_BADARGS);
+        if (DBIsEmptyMaterial(mat))
+            API_ERROR("Empty DBmaterial object", E_BADARGS);
+        if (!((mat->datatype == DB_FLOAT) || (mat->datatype == DB_DOUBLE)))
+            API_ERROR("datatype must be DB_FLOAT or DB_DOUBLE", E_BADARGS);
+        if (!mat->matlist || (mat->mixlen > 0 &&
+            (!mat->mix_next || !mat->mix_mat || !mat->mix_vf)))
+            API_ERROR("incomplete material object", E_BADARGS);
+        retval = db_CalcMaterialCSRFromMaterial(mat);
+        if (!retval)
+            API_ERROR("malformed mix_next chain or out of memory", E_INTERNAL);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP;
+}
+
+/*----------------------------------------------------------------------
+ * Routine:  db_CalcMaterialFromMaterialCSR
+ *
+ * Purpose:  Convert compressed sparse row (CSR) material data to the
+ *    standard matlist and mixed linked list layout.
+ *
+ * Description:  This inverts db_CalcMaterialCSRFromMaterial. A zone with
+ *    one entry is clean. A zone with two or more entries is mixed and gets
+ *    a chain of consecutive mix entries in the order given. A zone with no
+ *    entries gets material number zero. Like the forward conversion, this
+ *    is a threaded count pass, a prefix sum and a threaded fill pass. The
+ *    result uses the same 1-origin mix_next and mix_zone conventions as
+ *    DBCalcMaterialFromDenseArrays.
+ *--------------------------------------------------------------------*/
+static
+DBmaterial *db_CalcMaterialFromMaterialCSR(int nmat, int const *matnos, int ndims,
+    int const *dims, int const *offsets, int const *matids, int datatype,
+    void const *vf)
+{
+    int i, nzones = 1;
+    int *mixoff = 0, *matlist = 0, *matnos_copy = 0;
+    int *mix_next = 0, *mix_mat = 0, *mix_zone = 0;
+    void *mix_vf = 0;
+    size_t vfsize = datatype == DB_FLOAT ? sizeof(float) : sizeof(double);
+    DBmaterial *mat = 0;
+
+    for (i = 0; i < ndims; i++)
+        nzones *= dims[i];
+
+    matnos_copy = (int *) malloc(nmat * sizeof(int) + 1);
+    if (!matnos_copy) goto cleanup;
+    memcpy(matnos_copy, matnos, nmat * sizeof(int));
+    mixoff = (int *) malloc((nzones+1) * sizeof(int));
+    if (!mixoff) goto cleanup;
+    matlist = (int *) malloc(nzones * sizeof(int) + 1);
+    if (!matlist) goto cleanup;
+
+    /* pass 1: count mix entries for each zone */
+#ifdef _OPENMP
+#pragma omp parallel for if (nzones >= DB_CSR_PARALLEL)
+#endif
+    for (i = 0; i < nzones; i++)
+    {
+        int n = offsets[i+1] - offsets[i];
+        mixoff[i+1] = n > 1 ? n : 0;
+    }
+
+    /* exclusive prefix sum of the counts */
+    mixoff[0] = 0;
+    for (i = 0; i < nzones; i++)
+        mixoff[i+1] += mixoff[i];
+
+    mix_vf   = malloc(mixoff[nzones] * vfsize + 1);
+    if (!mix_vf) goto cleanup;
+    mix_mat  = (int *) malloc(mixoff[nzones] * sizeof(int) + 1);
+    if (!mix_mat) goto cleanup;
+    mix_zone = (int *) malloc(mixoff[nzones] * sizeof(int) + 1);
+    if (!mix_zone) goto cleanup;
+    mix_next = (int *) malloc(mixoff[nzones] * sizeof(int) + 1);
+    if (!mix_next) goto cleanup;
+
+    /* pass 2: fill matlist and each mixed zone's chain */
+#ifdef _OPENMP
+#pragma omp parallel for if (nzones >= DB_CSR_PARALLEL)
+#endif
+    for (i = 0; i < nzones; i++)
+    {
+        int k, m = mixoff[i], n = offsets[i+1] - offsets[i];
+
+        if (n == 0)
+            matlist[i] = 0;
+        else if (n == 1)
+            matlist[i] = matids[offsets[i]];
+        else
+        {
+            matlist[i] = -(m+1);
+            for (k = 0; k < n; k++, m++)
+            {
+                double f = datatype == DB_FLOAT ?
+                    ((float const *) vf)[offsets[i]+k] :
+                    ((double const *) vf)[offsets[i]+k];
+                mix_mat [m] = matids[offsets[i]+k];
+                put_frac(mix_vf, m, datatype, f);
+                mix_zone[m] = i+1; /* one origin */
+                mix_next[m] = k < n-1 ? m+2 : 0; /* one origin */
+            }
+        }
+    }
+
+    mat = DBAllocMaterial();
+    if (!mat) goto cleanup;
+    mat->origin = 0;
+    mat->ndims = ndims;
+    for (i = 0; i < ndims; i++)
+        mat->dims[i] = dims[i];
+    mat->nmat = nmat;
+    mat->matnos = matnos_copy;
+    mat->matlist = matlist;
+    mat->datatype = datatype;
+    mat->mix_vf = mix_vf;
+    mat->mix_next = mix_next;
+    mat->mix_mat = mix_mat;
+    mat->mix_zone = mix_zone;
+    mat->mixlen = mixoff[nzones];
+    FREE(mixoff);
+
+    return mat;
+
+cleanup:
+
+    FREE(mixoff);
+    FREE(matnos_copy);
+    FREE(matlist);
+    FREE(mix_vf);
+    FREE(mix_mat);
+    FREE(mix_zone);
+    FREE(mix_next);
+
+    return 0;
+}
+
+PUBLIC
+DBmaterial *DBCalcMaterialFromMaterialCSR(int nmat, int const *matnos, int ndims,
+    int const *dims, int const *offsets, int const *matids, int datatype,
+    void const *vf)
+{
+    int i, nzones = 1;
+    DBmaterial *retval = 0;
+
+    API_BEGIN("DBCalcMaterialFromMaterialCSR", DBmaterial*, 0) {
+        if (nmat<=0)
+            API_ERROR("nmat<=0", E_BADARGS);
+        if (ndims<=0 || ndims>3)
+            API_ERROR("ndims must be 1, 2 or 3", E_BADARGS);
+        if (!dims)
+            API_ERROR("dims==0", E_BADARGS);
+        if (!matnos)
+            API_ERROR("matnos==0", E_BADARGS);
+        if (!offsets)
+            API_ERROR("offsets==0", E_BADARGS);
+        if (!matids)
+            API_ERROR("matids==0", E_BADARGS);
+        if (!vf)
+            API_ERROR("vf==0", E_BADARGS);
+        if (!((datatype == DB_FLOAT) || (datatype == DB_DOUBLE)))
+            API_ERROR("datatype must be DB_FLOAT or DB_DOUBLE", E_BADARGS);
+        for (i = 0; i < ndims; i++)
+            nzones *= dims[i];
+        if (offsets[0] != 0)
+            API_ERROR("offsets[0]!=0", E_BADARGS);
+        for (i = 0; i < nzones; i++)
+        {
+            if (offsets[i+1] < offsets[i])
+                API_ERROR("offsets not monotone", E_BADARGS);
+        }
+        retval = db_CalcMaterialFromMaterialCSR(nmat, matnos, ndims, dims,
+                     offsets, matids, datatype, vf);
+        if (!retval)
+            API_ERROR(NULL, E_NOMEM);
+        API_RETURN(retval);
+    }
+    API_END_NOPOP;
+}
+
+/*----------------------------------------------------------------------
+ * Routine:  db_hash64
+ *
+ * Purpose:  Compute a 64 bit, non-cryptographic hash of a buffer.
+ *
+ * Description:  This is an implementation of the well known xxHash64
+ *    algorithm. It consumes the buffer 32 bytes at a time in 4 independent
+ *    lanes and so runs at near memory bandwidth. It is used to detect
+ *    duplicate array data. Different seeds yield independent hashes so
+ *    that callers can combine two of them to reduce collision probability.
+ *    Multi-byte words are assembled byte-wise so the result does not
+ *    depend on the alignment of the buffer or the endianness of the host.
+ *--------------------------------------------------------------------*/
+#define DB_HASH_P1 0x9E3779B185EBCA87ULL
+#define DB_HASH_P2 0xC2B2AE3D27D4EB4FULL
+#define DB_HASH_P3 0x165667B19E3779F9ULL
+#define DB_HASH_P4 0x85EBCA77C2B2AE63ULL
+#define DB_HASH_P5 0x27D4EB2F165667C5ULL
+#define DB_HASH_ROTL(x,r) (((x) << (r)) | ((x) >> (64 - (r))))
+
+static unsigned long long db_hash_read64(unsigned char const *p)
+{
+    return  (unsigned long long) p[0]        | ((unsigned long long) p[1] << 8)  |
+           ((unsigned long long) p[2] << 16) | ((unsigned long long) p[3] << 24) |
+           ((unsigned long long) p[4] << 32) | ((unsigned long long) p[5] << 40) |
+           ((unsigned long long) p[6] << 48) | ((unsigned long long) p[7] << 56);
+}
+
+static unsigned long long db_hash_round(unsigned long long acc, unsigned long long val)
+{
+    acc += val * DB_HASH_P2;
+    acc = DB_HASH_ROTL(acc, 31);
+    return acc * DB_HASH_P1;
+}
+
+static unsigned long long db_hash_merge(unsigned long long acc, unsigned long long val)
+{
+    acc ^= db_hash_round(0, val);
+    return acc * DB_HASH_P1 + DB_HASH_P4;
+}
+
+INTERNAL unsigned long long
+db_hash64(void const *buf, size_t len, unsigned long long seed)
+{
+    unsigned char const *p = (unsigned char const *) buf;
+    unsigned char const *end = p + len;
+    unsigned long long h;
+
+    if (len >= 32)
+    {
+        unsigned char const *limit = end - 32;
+        unsigned long long v1 = seed + DB_HASH_P1 + DB_HASH_P2;
+        unsigned long long v2 = seed + DB_HASH_P2;
+        unsigned long long v3 = seed;
+        unsigned long long v4 = seed - DB_HASH_P1;
+
+        do {
+            v1 = db_hash_round(v1, db_hash_read64(p));    p += 8;
+            v2 = db_hash_round(v2, db_hash_read64(p));    p += 8;
+            v3 = db_hash_round(v3, db_hash_read64(p));    p += 8;
+            v4 = db_hash_round(v4, db_hash_read64(p));    p += 8;
+        } while (p <= limit);
+
+        h = DB_HASH_ROTL(v1, 1) + DB_HASH_ROTL(v2, 7) +
+            DB_HASH_ROTL(v3, 12) + DB_HASH_ROTL(v4, 18);
+        h = db_hash_merge(h, v1);
+        h = db_hash_merge(h, v2);
+        h = db_hash_merge(h, v3);
+        h = db_hash_merge(h, v4);
+    }
+    else
+    {
+        h = seed + DB_HASH_P5;
+    }
+
+    h += (unsigned long long) len;
+
+    while (p + 8 <= end)
+    {
+        h ^= db_hash_round(0, db_hash_read64(p));
+        h = DB_HASH_ROTL(h, 27) * DB_HASH_P1 + DB_HASH_P4;
+        p += 8;
+    }
+
+    if (p + 4 <= end)
+    {
+        unsigned long long w = (unsigned long long) p[0]        | ((unsigned long long) p[1] << 8) |
+                              ((unsigned long long) p[2] << 16) | ((unsigned long long) p[3] << 24);
+        h ^= w * DB_HASH_P1;
+        h = DB_HASH_ROTL(h, 23) * DB_HASH_P2 + DB_HASH_P3;
+        p += 4;
+    }
+
+    while (p < end)
+    {
+        h ^= (*p) * DB_HASH_P5;
+        h = DB_HASH_ROTL(h, 11) * DB_HASH_P1;
+        p++;
+    }
+
+    h ^= h >> 33;
+    h *= DB_HASH_P2;
+    h ^= h >> 29;
+    h *= DB_HASH_P3;
+    h ^= h >> 32;
+
+    return h;
+}
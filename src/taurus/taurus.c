@@ -76,8 +76,11 @@ be used for advertising or product endorsement purposes.
 #include <sys/stat.h>           /*stat */
 #endif
 #include <ctype.h>		/*isspace */
+#if HAVE_SYS_MMAN_H
+#include <sys/mman.h>           /*mmap, madvise */
+#endif
 
-#define MAXBUF 100000
+#define TAURUS_PARALLEL (1<<14) /* elements before using threads */
 
 #ifndef FALSE
 #define FALSE  0
@@ -414,14 +417,31 @@ init_file_info (TAURUSfile *taurus)
     taurus->nfiles = nfiles;
 
     /*
-     * Determine the size of each file in the family.
+     * Determine the size of each file in the family and open it.
      */
-    taurus->filesize = ALLOC_N(int, nfiles);
+    taurus->filesize = ALLOC_N(long long, nfiles);
+    taurus->fds = ALLOC_N(int, nfiles);
+    taurus->maps = ALLOC_N(char *, nfiles);
 
     for (i = 0; i < nfiles; i++) {
         fam_name(taurus->basename, i, taurus->filename);
         stat(taurus->filename, &statbuf);
         taurus->filesize[i] = statbuf.st_size;
+        taurus->fds[i] = open(taurus->filename, O_RDONLY);
+        taurus->maps[i] = NULL;
+
+#if HAVE_SYS_MMAN_H
+        if (taurus->fds[i] >= 0 && taurus->filesize[i] > 0 &&
+            (unsigned long long) taurus->filesize[i] <= (size_t) -1) {
+            void *map = mmap(NULL, (size_t) taurus->filesize[i], PROT_READ,
+                             MAP_SHARED, taurus->fds[i], 0);
+            if (map != MAP_FAILED) {
+                taurus->maps[i] = (char *) map;
+                close(taurus->fds[i]);
+                taurus->fds[i] = -1;
+            }
+        }
+#endif
     }
 }
 
@@ -448,17 +468,16 @@ init_file_info (TAURUSfile *taurus)
  *-------------------------------------------------------------------------
  */
 static int
-taurus_read (TAURUSfile *taurus, int ifile, int iadd, int length, char *buffer)
+taurus_read (TAURUSfile *taurus, int ifile, long long iadd, long long length,
+             char *buffer)
 {
-    int            n;
-    int            ibuf;
-    int            idisk;
+    long long      n;
 
     /*
      * Skip to the correct file if the address is not in the
      * specified file.
      */
-    while (iadd > taurus->filesize[ifile]) {
+    while (ifile < taurus->nfiles && iadd > taurus->filesize[ifile]) {
         iadd -= taurus->filesize[ifile];
         ifile++;
     }
@@ -466,42 +485,79 @@ taurus_read (TAURUSfile *taurus, int ifile, int iadd, int length, char *buffer)
     /*
      * Read the file.
      */
-    ibuf = 0;
-    idisk = iadd;
     while (length > 0) {
-        /*
-         * If the desired file is not open, close the current file
-         * and open the desired file.
-         */
-        if (taurus->ifile != ifile) {
-            if (taurus->fd != -1)
-                close(taurus->fd);
-            fam_name(taurus->basename, ifile, taurus->filename);
-            if ((taurus->fd = open(taurus->filename, O_RDONLY)) < 0) {
-                return (-1);
-            }
-            taurus->ifile = ifile;
-        }
+        if (ifile >= taurus->nfiles)
+            return (-2);
 
         /*
          * Read the maximum amount from the current file.
          */
-        n = MIN(taurus->filesize[ifile] - idisk, length);
-        lseek(taurus->fd, idisk, SEEK_SET);
+        n = MIN(taurus->filesize[ifile] - iadd, length);
 
-        if (read(taurus->fd, &buffer[ibuf], n) != n) {
-            return (-2);
+        if (taurus->maps[ifile] != NULL) {
+            memcpy(buffer, taurus->maps[ifile] + iadd, (size_t) n);
+        }
+        else {
+            if (taurus->fds[ifile] < 0)
+                return (-1);
+            if (lseek(taurus->fds[ifile], (off_t) iadd, SEEK_SET) < 0 ||
+                read(taurus->fds[ifile], buffer, (size_t) n) != n)
+                return (-2);
         }
 
-        ibuf += n;
+        buffer += n;
         length -= n;
         ifile++;
-        idisk = 0;
+        iadd = 0;
     }
 
     return (0);
 }
 
+/*-------------------------------------------------------------------------
+ * Function:    taurus_view
+ *
+ * Purpose:     Return a pointer to the mapped bytes at the given address
+ *              of the family and ask for them to be read ahead. There is
+ *              no view if the bytes are not all in one mapped member.
+ *
+ * Return:      Success:        pointer into the mapping
+ *
+ *              Failure:        NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static char *
+taurus_view (TAURUSfile *taurus, int ifile, long long iadd, long long length)
+{
+#if HAVE_SYS_MMAN_H
+    long long      start;
+    long           pagesize;
+
+    while (ifile < taurus->nfiles && iadd > taurus->filesize[ifile]) {
+        iadd -= taurus->filesize[ifile];
+        ifile++;
+    }
+
+    if (ifile >= taurus->nfiles || taurus->maps[ifile] == NULL ||
+        iadd + length > taurus->filesize[ifile] || iadd % sizeof(float) != 0)
+        return (NULL);
+
+#ifdef MADV_WILLNEED
+    pagesize = sysconf(_SC_PAGESIZE);
+    if (pagesize > 0) {
+        start = iadd - iadd % pagesize;
+        madvise(taurus->maps[ifile] + start, (size_t) (iadd + length - start),
+                MADV_WILLNEED);
+    }
+#endif
+
+    return (taurus->maps[ifile] + iadd);
+#else
+    return (NULL);
+#endif
+}
+
 /*-------------------------------------------------------------------------
  * Function:    init_state_info
  *
@@ -536,12 +592,12 @@ static void
 init_state_info (TAURUSfile *taurus)
 {
     int            i;
-    int            geomsize;
-    int            statesize;
-    int            totsize;
+    long long      geomsize;
+    long long      statesize;
+    long long      totsize;
     int            maxstates;
     int            nstates;
-    int            loc;
+    long long      loc;
     int            ifile;
     int            nfiles;
     int            nv1dact, nv2dact, nv3dact;
@@ -564,7 +620,7 @@ init_state_info (TAURUSfile *taurus)
      * Determine the file and disk address for the start of each
      * state in the database.
      */
-    geomsize = (taurus->ndim * taurus->numnp +
+    geomsize = ((long long) taurus->ndim * taurus->numnp +
                 9 * taurus->nel8 +
                 5 * taurus->nel4 +
                 6 * taurus->nel2) * sizeof(int);
@@ -579,10 +635,10 @@ init_state_info (TAURUSfile *taurus)
              * is four then fluxes are present.
              */
             if (taurus->it == 4)
-                statesize = (4 * taurus->numnp + 1) * sizeof(int);
+                statesize = (4 * (long long) taurus->numnp + 1) * sizeof(int);
 
             else
-                statesize = (1 * taurus->numnp + 1) * sizeof(int);
+                statesize = (1 * (long long) taurus->numnp + 1) * sizeof(int);
 
             break;
             /*
@@ -591,12 +647,12 @@ init_state_info (TAURUSfile *taurus)
         case 2:
         case 6:
         case 200:
-            statesize = (taurus->it * taurus->numnp +
-                         taurus->ndim * taurus->numnp *
+            statesize = ((long long) taurus->it * taurus->numnp +
+                         (long long) taurus->ndim * taurus->numnp *
                          (taurus->iu + taurus->iv + taurus->ia) +
-                         taurus->nel8 * nv3dact +
-                         taurus->nel4 * nv2dact +
-                         taurus->nel2 * nv1dact +
+                         (long long) taurus->nel8 * nv3dact +
+                         (long long) taurus->nel4 * nv2dact +
+                         (long long) taurus->nel2 * nv1dact +
                          taurus->nglbv + 1) * sizeof(int);
 
             break;
@@ -605,9 +661,9 @@ init_state_info (TAURUSfile *taurus)
     totsize = 0;
     for (i = 0; i < nfiles; i++)
         totsize += taurus->filesize[i];
-    maxstates = (totsize / statesize) + 1;
+    maxstates = (int) (totsize / statesize) + 1;
     taurus->state_file = ALLOC_N(int, maxstates);
-    taurus->state_loc = ALLOC_N(int, maxstates);
+    taurus->state_loc = ALLOC_N(long long, maxstates);
     taurus->state_time = ALLOC_N(float, maxstates);
 
     loc = 64 * sizeof(int) + geomsize;
@@ -1057,6 +1113,112 @@ init_mat_info (TAURUSfile *taurus)
     taurus->matnos = matnos;
 }
 
+/*-------------------------------------------------------------------------
+ * Function:    taurus_invariants
+ *
+ * Purpose:     Calculate the pressure and the second and third invariants
+ *              of the deviatoric stress for nel elements whose first six
+ *              components are the stress tensor. The results are stored
+ *              as floats, in separate arrays, so the loops over them
+ *              vectorize and the raw values are left untouched.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+taurus_invariants (float const *buf, int nel, int ncomps, float *aa,
+                   float *bb, float *pr)
+{
+    int            i;
+
+#ifdef _OPENMP
+#pragma omp parallel for if (nel >= TAURUS_PARALLEL)
+#endif
+    for (i = 0; i < nel; i++) {
+        float const   *b = buf + (size_t) i * ncomps;
+        double         p = -(b[0] + b[1] + b[2]) / 3.0;
+        float          s0 = b[0] + p;
+        float          s1 = b[1] + p;
+        float          s2 = b[2] + p;
+
+        aa[i] = b[3] * b[3] + b[4] * b[4] + b[5] * b[5] -
+            s0 * s1 - s1 * s2 - s0 * s2;
+        bb[i] = s0 * b[4] * b[4] + s1 * b[5] * b[5] + s2 * b[3] * b[3] -
+            s0 * s1 * s2 - 2.0 * b[3] * b[4] * b[5];
+        pr[i] = p;
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    taurus_roots
+ *
+ * Purpose:     Calculate a deviatoric or principal stress, or the maximum
+ *              shear stress, from the stress invariants.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+taurus_roots (float const *aa, float const *bb, float const *pr, int nel,
+              int var_id, float *var)
+{
+    int            i;
+    int            shear = var_id == VAR_MAX_SHEAR_STR;
+    int            princ = var_id >= VAR_PRINC_STRESS_1 &&
+                           var_id <= VAR_PRINC_STRESS_3;
+    double         phase = 0.;
+
+    if (var_id == VAR_DEV_STRESS_2 || var_id == VAR_PRINC_STRESS_2)
+        phase = ftpi;
+    else if (var_id == VAR_DEV_STRESS_3 || var_id == VAR_PRINC_STRESS_3)
+        phase = ttpi;
+
+    /*
+     * Degenerate elements are evaluated with a harmless aa and then
+     * selected away, so the loop body has no branches.
+     */
+#ifdef _OPENMP
+#pragma omp parallel for if (nel >= TAURUS_PARALLEL)
+#endif
+    for (i = 0; i < nel; i++) {
+        int            tiny = aa[i] < 1.0e-25;
+        double         a = tiny ? 1.0 : aa[i];
+        double         cc, angp, v;
+
+        cc = -sqrt(27.0 / a) * bb[i] * 0.5 / a;
+        cc = MAX(MIN(cc, 1.0), -1.0);
+        angp = acos(cc) / 3.0;
+        if (shear)
+            v = sqrt(a / 3.0) * (cos(angp) - cos(angp + ttpi));
+        else
+            v = 2.0 * sqrt(a / 3.0) * cos(angp + phase);
+
+        if (princ)
+            var[i] = tiny ? -pr[i] : v - pr[i];
+        else
+            var[i] = tiny ? 0. : v;
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    taurus_surf
+ *
+ * Purpose:     Calculate component k of the upper (sign 1) or lower
+ *              (sign -1) surface stress of a shell element.
+ *
+ * Return:      The stress.
+ *
+ *-------------------------------------------------------------------------
+ */
+static double
+taurus_surf (float const *b, int k, double sign)
+{
+    return ((b[26 + k] / b[29]) +
+            sign * (6.0 * (b[21 + k] / (b[29] * b[29]))));
+}
+
 /*-------------------------------------------------------------------------
  * Function:    taurus_calc
  *
@@ -1081,13 +1243,12 @@ init_mat_info (TAURUSfile *taurus)
  *-------------------------------------------------------------------------
  */
 static void
-taurus_calc (TAURUSfile *taurus, float *buf, int lbuf, int ncomps, int offset,
-             int var_id, float *var, int ivar)
+taurus_calc (TAURUSfile *taurus, float const *buf, int nel, int ncomps,
+             int offset, int var_id, float *var)
 {
-    int            ibuf;
-    double         t1, t2, t3, t4, t5;
-    double         pr, aa, bb, cc, dd, angp;
-    float         *buf2, *buf3, *buf4;
+    int            i;
+    float         *aa, *bb, *pr;
+    float const   *x, *y, *z;
 
     switch (var_id) {
         case VAR_NORMAL:
@@ -1098,391 +1259,198 @@ taurus_calc (TAURUSfile *taurus, float *buf, int lbuf, int ncomps, int offset,
         case VAR_SIGYZ:
         case VAR_SIGZX:
         case VAR_EPS:
-            for (ibuf = offset; ibuf < lbuf; ibuf += ncomps) {
-                var[ivar] = buf[ibuf];
-                ivar++;
-            }
+#ifdef _OPENMP
+#pragma omp parallel for if (nel >= TAURUS_PARALLEL)
+#endif
+            for (i = 0; i < nel; i++)
+                var[i] = buf[(size_t) i * ncomps + offset];
             break;
         case VAR_PRESSURE:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                var[ivar] = -(buf[ibuf] + buf[ibuf + 1] + buf[ibuf + 2]) / 3.0;
-                ivar++;
+#ifdef _OPENMP
+#pragma omp parallel for if (nel >= TAURUS_PARALLEL)
+#endif
+            for (i = 0; i < nel; i++) {
+                float const   *b = buf + (size_t) i * ncomps;
+
+                var[i] = -(b[0] + b[1] + b[2]) / 3.0;
             }
             break;
         case VAR_SIG_EFF:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                pr = -(buf[ibuf] + buf[ibuf + 1] + buf[ibuf + 2]) / 3.0;
-                buf[ibuf] += pr;
-                buf[ibuf + 1] += pr;
-                buf[ibuf + 2] += pr;
-                aa = buf[ibuf + 3] * buf[ibuf + 3] + buf[ibuf + 4] * buf[ibuf + 4] +
-                    buf[ibuf + 5] * buf[ibuf + 5] - buf[ibuf] * buf[ibuf + 1] -
-                    buf[ibuf + 1] * buf[ibuf + 2] - buf[ibuf] * buf[ibuf + 2];
-                var[ivar] = sqrt(3.0 * fabs(aa));
-                ivar++;
-            }
-            break;
         case VAR_DEV_STRESS_1:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                pr = -(buf[ibuf] + buf[ibuf + 1] + buf[ibuf + 2]) / 3.0;
-                buf[ibuf] += pr;
-                buf[ibuf + 1] += pr;
-                buf[ibuf + 2] += pr;
-                aa = buf[ibuf + 3] * buf[ibuf + 3] + buf[ibuf + 4] * buf[ibuf + 4] +
-                    buf[ibuf + 5] * buf[ibuf + 5] - buf[ibuf] * buf[ibuf + 1] -
-                    buf[ibuf + 1] * buf[ibuf + 2] - buf[ibuf] * buf[ibuf + 2];
-                bb = buf[ibuf] * buf[ibuf + 4] * buf[ibuf + 4] +
-                    buf[ibuf + 1] * buf[ibuf + 5] * buf[ibuf + 5] +
-                    buf[ibuf + 2] * buf[ibuf + 3] * buf[ibuf + 3] -
-                    buf[ibuf] * buf[ibuf + 1] * buf[ibuf + 2] - 2.0 *
-                    buf[ibuf + 3] * buf[ibuf + 4] * buf[ibuf + 5];
-                buf[ibuf] = aa;
-                buf[ibuf + 1] = bb;
-            }
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                if (buf[ibuf] < 1.0e-25)
-                    var[ivar] = 0.;
-                else {
-                    aa = buf[ibuf];
-                    bb = buf[ibuf + 1];
-                    cc = -sqrt(27.0 / aa) * bb * 0.5 / aa;
-                    cc = MAX(MIN(cc, 1.0), -1.0);
-                    angp = acos(cc) / 3.0;
-                    dd = 2.0 * sqrt(aa / 3.0);
-                    var[ivar] = dd * cos(angp);
-                }
-                ivar++;
-            }
-            break;
         case VAR_DEV_STRESS_2:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                pr = -(buf[ibuf] + buf[ibuf + 1] + buf[ibuf + 2]) / 3.0;
-                buf[ibuf] += pr;
-                buf[ibuf + 1] += pr;
-                buf[ibuf + 2] += pr;
-                aa = buf[ibuf + 3] * buf[ibuf + 3] + buf[ibuf + 4] * buf[ibuf + 4] +
-                    buf[ibuf + 5] * buf[ibuf + 5] - buf[ibuf] * buf[ibuf + 1] -
-                    buf[ibuf + 1] * buf[ibuf + 2] - buf[ibuf] * buf[ibuf + 2];
-                bb = buf[ibuf] * buf[ibuf + 4] * buf[ibuf + 4] +
-                    buf[ibuf + 1] * buf[ibuf + 5] * buf[ibuf + 5] +
-                    buf[ibuf + 2] * buf[ibuf + 3] * buf[ibuf + 3] -
-                    buf[ibuf] * buf[ibuf + 1] * buf[ibuf + 2] - 2.0 *
-                    buf[ibuf + 3] * buf[ibuf + 4] * buf[ibuf + 5];
-                buf[ibuf] = aa;
-                buf[ibuf + 1] = bb;
-            }
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                if (buf[ibuf] < 1.0e-25)
-                    var[ivar] = 0.;
-                else {
-                    aa = buf[ibuf];
-                    bb = buf[ibuf + 1];
-                    cc = -sqrt(27.0 / aa) * bb * 0.5 / aa;
-                    cc = MAX(MIN(cc, 1.0), -1.0);
-                    angp = acos(cc) / 3.0;
-                    dd = 2.0 * sqrt(aa / 3.0);
-                    var[ivar] = dd * cos(angp + ftpi);
-                }
-                ivar++;
-            }
-            break;
         case VAR_DEV_STRESS_3:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                pr = -(buf[ibuf] + buf[ibuf + 1] + buf[ibuf + 2]) / 3.0;
-                buf[ibuf] += pr;
-                buf[ibuf + 1] += pr;
-                buf[ibuf + 2] += pr;
-                aa = buf[ibuf + 3] * buf[ibuf + 3] + buf[ibuf + 4] * buf[ibuf + 4] +
-                    buf[ibuf + 5] * buf[ibuf + 5] - buf[ibuf] * buf[ibuf + 1] -
-                    buf[ibuf + 1] * buf[ibuf + 2] - buf[ibuf] * buf[ibuf + 2];
-                bb = buf[ibuf] * buf[ibuf + 4] * buf[ibuf + 4] +
-                    buf[ibuf + 1] * buf[ibuf + 5] * buf[ibuf + 5] +
-                    buf[ibuf + 2] * buf[ibuf + 3] * buf[ibuf + 3] -
-                    buf[ibuf] * buf[ibuf + 1] * buf[ibuf + 2] - 2.0 *
-                    buf[ibuf + 3] * buf[ibuf + 4] * buf[ibuf + 5];
-                buf[ibuf] = aa;
-                buf[ibuf + 1] = bb;
-            }
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                if (buf[ibuf] < 1.0e-25)
-                    var[ivar] = 0.;
-                else {
-                    aa = buf[ibuf];
-                    bb = buf[ibuf + 1];
-                    cc = -sqrt(27.0 / aa) * bb * 0.5 / aa;
-                    cc = MAX(MIN(cc, 1.0), -1.0);
-                    angp = acos(cc) / 3.0;
-                    dd = 2.0 * sqrt(aa / 3.0);
-                    var[ivar] = dd * cos(angp + ttpi);
-                }
-                ivar++;
-            }
-            break;
         case VAR_MAX_SHEAR_STR:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                pr = -(buf[ibuf] + buf[ibuf + 1] + buf[ibuf + 2]) / 3.0;
-                buf[ibuf] += pr;
-                buf[ibuf + 1] += pr;
-                buf[ibuf + 2] += pr;
-                aa = buf[ibuf + 3] * buf[ibuf + 3] + buf[ibuf + 4] * buf[ibuf + 4] +
-                    buf[ibuf + 5] * buf[ibuf + 5] - buf[ibuf] * buf[ibuf + 1] -
-                    buf[ibuf + 1] * buf[ibuf + 2] - buf[ibuf] * buf[ibuf + 2];
-                bb = buf[ibuf] * buf[ibuf + 4] * buf[ibuf + 4] +
-                    buf[ibuf + 1] * buf[ibuf + 5] * buf[ibuf + 5] +
-                    buf[ibuf + 2] * buf[ibuf + 3] * buf[ibuf + 3] -
-                    buf[ibuf] * buf[ibuf + 1] * buf[ibuf + 2] - 2.0 *
-                    buf[ibuf + 3] * buf[ibuf + 4] * buf[ibuf + 5];
-                buf[ibuf] = aa;
-                buf[ibuf + 1] = bb;
-            }
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                if (buf[ibuf] < 1.0e-25)
-                    var[ivar] = 0.;
-                else {
-                    aa = buf[ibuf];
-                    bb = buf[ibuf + 1];
-                    cc = -sqrt(27.0 / aa) * bb * 0.5 / aa;
-                    cc = MAX(MIN(cc, 1.0), -1.0);
-                    angp = acos(cc) / 3.0;
-                    dd = sqrt(aa / 3.0);
-                    var[ivar] = dd * (cos(angp) - cos(angp + ttpi));
-                }
-                ivar++;
-            }
-            break;
         case VAR_PRINC_STRESS_1:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                pr = -(buf[ibuf] + buf[ibuf + 1] + buf[ibuf + 2]) / 3.0;
-                buf[ibuf] += pr;
-                buf[ibuf + 1] += pr;
-                buf[ibuf + 2] += pr;
-                aa = buf[ibuf + 3] * buf[ibuf + 3] + buf[ibuf + 4] * buf[ibuf + 4] +
-                    buf[ibuf + 5] * buf[ibuf + 5] - buf[ibuf] * buf[ibuf + 1] -
-                    buf[ibuf + 1] * buf[ibuf + 2] - buf[ibuf] * buf[ibuf + 2];
-                bb = buf[ibuf] * buf[ibuf + 4] * buf[ibuf + 4] +
-                    buf[ibuf + 1] * buf[ibuf + 5] * buf[ibuf + 5] +
-                    buf[ibuf + 2] * buf[ibuf + 3] * buf[ibuf + 3] -
-                    buf[ibuf] * buf[ibuf + 1] * buf[ibuf + 2] - 2.0 *
-                    buf[ibuf + 3] * buf[ibuf + 4] * buf[ibuf + 5];
-                buf[ibuf] = aa;
-                buf[ibuf + 1] = bb;
-                buf[ibuf + 2] = pr;
-            }
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                if (buf[ibuf] < 1.0e-25)
-                    var[ivar] = -buf[ibuf + 2];
-                else {
-                    aa = buf[ibuf];
-                    bb = buf[ibuf + 1];
-                    cc = -sqrt(27.0 / aa) * bb * 0.5 / aa;
-                    cc = MAX(MIN(cc, 1.0), -1.0);
-                    angp = acos(cc) / 3.0;
-                    dd = 2.0 * sqrt(aa / 3.0);
-                    var[ivar] = dd * cos(angp) - buf[ibuf + 2];
-                }
-                ivar++;
-            }
-            break;
         case VAR_PRINC_STRESS_2:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                pr = -(buf[ibuf] + buf[ibuf + 1] + buf[ibuf + 2]) / 3.0;
-                buf[ibuf] += pr;
-                buf[ibuf + 1] += pr;
-                buf[ibuf + 2] += pr;
-                aa = buf[ibuf + 3] * buf[ibuf + 3] + buf[ibuf + 4] * buf[ibuf + 4] +
-                    buf[ibuf + 5] * buf[ibuf + 5] - buf[ibuf] * buf[ibuf + 1] -
-                    buf[ibuf + 1] * buf[ibuf + 2] - buf[ibuf] * buf[ibuf + 2];
-                bb = buf[ibuf] * buf[ibuf + 4] * buf[ibuf + 4] +
-                    buf[ibuf + 1] * buf[ibuf + 5] * buf[ibuf + 5] +
-                    buf[ibuf + 2] * buf[ibuf + 3] * buf[ibuf + 3] -
-                    buf[ibuf] * buf[ibuf + 1] * buf[ibuf + 2] - 2.0 *
-                    buf[ibuf + 3] * buf[ibuf + 4] * buf[ibuf + 5];
-                buf[ibuf] = aa;
-                buf[ibuf + 1] = bb;
-                buf[ibuf + 2] = pr;
-            }
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                if (buf[ibuf] < 1.0e-25)
-                    var[ivar] = -buf[ibuf + 2];
-                else {
-                    aa = buf[ibuf];
-                    bb = buf[ibuf + 1];
-                    cc = -sqrt(27.0 / aa) * bb * 0.5 / aa;
-                    cc = MAX(MIN(cc, 1.0), -1.0);
-                    angp = acos(cc) / 3.0;
-                    dd = 2.0 * sqrt(aa / 3.0);
-                    var[ivar] = dd * cos(angp + ftpi) - buf[ibuf + 2];
-                }
-                ivar++;
-            }
-            break;
         case VAR_PRINC_STRESS_3:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                pr = -(buf[ibuf] + buf[ibuf + 1] + buf[ibuf + 2]) / 3.0;
-                buf[ibuf] += pr;
-                buf[ibuf + 1] += pr;
-                buf[ibuf + 2] += pr;
-                aa = buf[ibuf + 3] * buf[ibuf + 3] + buf[ibuf + 4] * buf[ibuf + 4] +
-                    buf[ibuf + 5] * buf[ibuf + 5] - buf[ibuf] * buf[ibuf + 1] -
-                    buf[ibuf + 1] * buf[ibuf + 2] - buf[ibuf] * buf[ibuf + 2];
-                bb = buf[ibuf] * buf[ibuf + 4] * buf[ibuf + 4] +
-                    buf[ibuf + 1] * buf[ibuf + 5] * buf[ibuf + 5] +
-                    buf[ibuf + 2] * buf[ibuf + 3] * buf[ibuf + 3] -
-                    buf[ibuf] * buf[ibuf + 1] * buf[ibuf + 2] - 2.0 *
-                    buf[ibuf + 3] * buf[ibuf + 4] * buf[ibuf + 5];
-                buf[ibuf] = aa;
-                buf[ibuf + 1] = bb;
-                buf[ibuf + 2] = pr;
+            aa = ALLOC_N(float, 3 * nel);
+            if (aa == NULL)
+                break;
+            bb = aa + nel;
+            pr = bb + nel;
+            taurus_invariants(buf, nel, ncomps, aa, bb, pr);
+            if (var_id == VAR_SIG_EFF) {
+#ifdef _OPENMP
+#pragma omp parallel for if (nel >= TAURUS_PARALLEL)
+#endif
+                for (i = 0; i < nel; i++)
+                    var[i] = sqrt(3.0 * fabs(aa[i]));
             }
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                if (buf[ibuf] < 1.0e-25)
-                    var[ivar] = -buf[ibuf + 2];
-                else {
-                    aa = buf[ibuf];
-                    bb = buf[ibuf + 1];
-                    cc = -sqrt(27.0 / aa) * bb * 0.5 / aa;
-                    cc = MAX(MIN(cc, 1.0), -1.0);
-                    angp = acos(cc) / 3.0;
-                    dd = 2.0 * sqrt(aa / 3.0);
-                    var[ivar] = dd * cos(angp + ttpi) - buf[ibuf + 2];
-                }
-                ivar++;
+            else {
+                taurus_roots(aa, bb, pr, nel, var_id, var);
             }
+            FREE(aa);
             break;
         case VAR_DISPX:
-            buf2 = taurus->coords[0];
-            for (ibuf = offset; ibuf < lbuf; ibuf += ncomps) {
-                var[ivar] = buf2[ivar] - buf[ibuf];
-                ivar++;
-            }
-            break;
         case VAR_DISPY:
-            buf2 = taurus->coords[1];
-            for (ibuf = offset; ibuf < lbuf; ibuf += ncomps) {
-                var[ivar] = buf2[ivar] - buf[ibuf];
-                ivar++;
-            }
-            break;
         case VAR_DISPZ:
-            buf2 = taurus->coords[2];
-            for (ibuf = offset; ibuf < lbuf; ibuf += ncomps) {
-                var[ivar] = buf2[ivar] - buf[ibuf];
-                ivar++;
-            }
+            x = taurus->coords[var_id - VAR_DISPX];
+#ifdef _OPENMP
+#pragma omp parallel for if (nel >= TAURUS_PARALLEL)
+#endif
+            for (i = 0; i < nel; i++)
+                var[i] = x[i] - buf[(size_t) i * ncomps + offset];
             break;
         case VAR_DISP_MAG:
-            buf2 = taurus->coords[0];
-            buf3 = taurus->coords[1];
-            buf4 = taurus->coords[2];
-            for (ibuf = offset; ibuf < lbuf; ibuf += ncomps) {
-                var[ivar] = sqrt((buf2[ivar] - buf[ibuf]) *
-                                 (buf2[ivar] - buf[ibuf]) +
-                                 (buf3[ivar] - buf[ibuf + 1]) *
-                                 (buf3[ivar] - buf[ibuf + 1]) +
-                                 (buf4[ivar] - buf[ibuf + 2]) *
-                                 (buf4[ivar] - buf[ibuf + 2]));
-                ivar++;
+            x = taurus->coords[0];
+            y = taurus->coords[1];
+            z = taurus->coords[2];
+#ifdef _OPENMP
+#pragma omp parallel for if (nel >= TAURUS_PARALLEL)
+#endif
+            for (i = 0; i < nel; i++) {
+                float const   *b = buf + (size_t) i * ncomps + offset;
+
+                var[i] = sqrt((x[i] - b[0]) * (x[i] - b[0]) +
+                              (y[i] - b[1]) * (y[i] - b[1]) +
+                              (z[i] - b[2]) * (z[i] - b[2]));
             }
             break;
         case VAR_VEL_MAG:
         case VAR_ACC_MAG:
         case VAR_VORT_MAG:
-            for (ibuf = offset; ibuf < lbuf; ibuf += ncomps) {
-                var[ivar] = sqrt(buf[ibuf] * buf[ibuf] +
-                                 buf[ibuf + 1] * buf[ibuf + 1] +
-                                 buf[ibuf + 2] * buf[ibuf + 2]);
-                ivar++;
+#ifdef _OPENMP
+#pragma omp parallel for if (nel >= TAURUS_PARALLEL)
+#endif
+            for (i = 0; i < nel; i++) {
+                float const   *b = buf + (size_t) i * ncomps + offset;
+
+                var[i] = sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2]);
             }
             break;
         case VAR_SURF_STRESS_1:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                var[ivar] = (buf[ibuf + 26] / buf[ibuf + 29]) + 6.0 *
-                    (buf[ibuf + 21] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                ivar++;
-            }
-            break;
         case VAR_SURF_STRESS_2:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                var[ivar] = (buf[ibuf + 26] / buf[ibuf + 29]) - 6.0 *
-                    (buf[ibuf + 21] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                ivar++;
-            }
-            break;
         case VAR_SURF_STRESS_3:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                var[ivar] = (buf[ibuf + 27] / buf[ibuf + 29]) + 6.0 *
-                    (buf[ibuf + 22] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                ivar++;
-            }
-            break;
         case VAR_SURF_STRESS_4:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                var[ivar] = (buf[ibuf + 27] / buf[ibuf + 29]) - 6.0 *
-                    (buf[ibuf + 22] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                ivar++;
-            }
-            break;
         case VAR_SURF_STRESS_5:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                var[ivar] = (buf[ibuf + 28] / buf[ibuf + 29]) + 6.0 *
-                    (buf[ibuf + 23] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                ivar++;
-            }
-            break;
         case VAR_SURF_STRESS_6:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                var[ivar] = (buf[ibuf + 28] / buf[ibuf + 29]) - 6.0 *
-                    (buf[ibuf + 23] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                ivar++;
-            }
+        {
+            int            k = (var_id - VAR_SURF_STRESS_1) / 2;
+            double         sign = (var_id - VAR_SURF_STRESS_1) % 2 ? -1. : 1.;
+
+#ifdef _OPENMP
+#pragma omp parallel for if (nel >= TAURUS_PARALLEL)
+#endif
+            for (i = 0; i < nel; i++)
+                var[i] = taurus_surf(buf + (size_t) i * ncomps, k, sign);
             break;
+        }
         case VAR_UP_STRESS:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                t1 = (buf[ibuf + 26] / buf[ibuf + 29]) + 6.0 *
-                    (buf[ibuf + 21] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                t2 = (buf[ibuf + 27] / buf[ibuf + 29]) + 6.0 *
-                    (buf[ibuf + 22] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                t3 = (buf[ibuf + 28] / buf[ibuf + 29]) + 6.0 *
-                    (buf[ibuf + 23] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                var[ivar] = sqrt(t1 * t1 - t1 * t2 + t2 * t2 + 3.0 * t3 * t3);
-                ivar++;
-            }
-            break;
         case VAR_LOW_STRESS:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                t1 = (buf[ibuf + 26] / buf[ibuf + 29]) - 6.0 *
-                    (buf[ibuf + 21] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                t2 = (buf[ibuf + 27] / buf[ibuf + 29]) - 6.0 *
-                    (buf[ibuf + 22] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                t3 = (buf[ibuf + 28] / buf[ibuf + 29]) - 6.0 *
-                    (buf[ibuf + 23] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                var[ivar] = sqrt(t1 * t1 - t1 * t2 + t2 * t2 + 3.0 * t3 * t3);
-                ivar++;
-            }
-            break;
         case VAR_MAX_STRESS:
-            for (ibuf = 0; ibuf < lbuf; ibuf += ncomps) {
-                t1 = (buf[ibuf + 26] / buf[ibuf + 29]) + 6.0 *
-                    (buf[ibuf + 21] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                t2 = (buf[ibuf + 27] / buf[ibuf + 29]) + 6.0 *
-                    (buf[ibuf + 22] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                t3 = (buf[ibuf + 28] / buf[ibuf + 29]) + 6.0 *
-                    (buf[ibuf + 23] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                t4 = sqrt(t1 * t1 - t1 * t2 + t2 * t2 + 3.0 * t3 * t3);
-                t1 = (buf[ibuf + 26] / buf[ibuf + 29]) - 6.0 *
-                    (buf[ibuf + 21] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                t2 = (buf[ibuf + 27] / buf[ibuf + 29]) - 6.0 *
-                    (buf[ibuf + 22] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                t3 = (buf[ibuf + 28] / buf[ibuf + 29]) - 6.0 *
-                    (buf[ibuf + 23] / (buf[ibuf + 29] * buf[ibuf + 29]));
-                t5 = sqrt(t1 * t1 - t1 * t2 + t2 * t2 + 3.0 * t3 * t3);
-                var[ivar] = MAX(t4, t5);
-                ivar++;
+#ifdef _OPENMP
+#pragma omp parallel for if (nel >= TAURUS_PARALLEL)
+#endif
+            for (i = 0; i < nel; i++) {
+                float const   *b = buf + (size_t) i * ncomps;
+                double         t1, t2, t3, up = 0., low = 0.;
+
+                if (var_id != VAR_LOW_STRESS) {
+                    t1 = taurus_surf(b, 0, 1.);
+                    t2 = taurus_surf(b, 1, 1.);
+                    t3 = taurus_surf(b, 2, 1.);
+                    up = sqrt(t1 * t1 - t1 * t2 + t2 * t2 + 3.0 * t3 * t3);
+                }
+                if (var_id != VAR_UP_STRESS) {
+                    t1 = taurus_surf(b, 0, -1.);
+                    t2 = taurus_surf(b, 1, -1.);
+                    t3 = taurus_surf(b, 2, -1.);
+                    low = sqrt(t1 * t1 - t1 * t2 + t2 * t2 + 3.0 * t3 * t3);
+                }
+                if (var_id == VAR_UP_STRESS)
+                    var[i] = up;
+                else if (var_id == VAR_LOW_STRESS)
+                    var[i] = low;
+                else
+                    var[i] = MAX(up, low);
             }
             break;
     }
 }
 
+/*-------------------------------------------------------------------------
+ * Function:    taurus_readraw
+ *
+ * Purpose:     Return size raw values starting at the given address of
+ *              the family. Mapped values are returned in place. Otherwise
+ *              the values are read into a small cache of blocks, so the
+ *              several variables calculated from one block of a state
+ *              share a single read.
+ *
+ * Return:      Success:        pointer to the values, owned by taurus
+ *
+ *              Failure:        NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static float const *
+taurus_readraw (TAURUSfile *taurus, int ifile, long long iadd, int size)
+{
+    char          *view;
+    long long      length;
+    int            i;
+
+    view = taurus_view(taurus, ifile, iadd,
+                       (long long) size * (long long) sizeof(float));
+    if (view != NULL)
+        return ((float const *) view);
+
+    for (i = 0; i < MAX_RAW; i++) {
+        if (taurus->raw_buf[i] != NULL && taurus->raw_file[i] == ifile &&
+            taurus->raw_addr[i] == iadd && taurus->raw_size[i] >= size)
+            return (taurus->raw_buf[i]);
+    }
+
+    /*
+     * A block that runs past the end of the family keeps the values
+     * that are there and is zero for the rest.
+     */
+    length = -iadd;
+    for (i = ifile; i < taurus->nfiles; i++)
+        length += taurus->filesize[i];
+    length = MAX(MIN(length, (long long) size * (long long) sizeof(float)), 0);
+
+    /*
+     * Replace the cached blocks in turn.
+     */
+    i = taurus->raw_next;
+    taurus->raw_next = (i + 1) % MAX_RAW;
+
+    FREE(taurus->raw_buf[i]);
+    taurus->raw_buf[i] = ALLOC_N(float, size);
+    if (taurus->raw_buf[i] == NULL ||
+        taurus_read(taurus, ifile, iadd, length,
+                    (char *) taurus->raw_buf[i]) < 0) {
+        FREE(taurus->raw_buf[i]);
+        return (NULL);
+    }
+    taurus->raw_file[i] = ifile;
+    taurus->raw_addr[i] = iadd;
+    taurus->raw_size[i] = size;
+
+    return (taurus->raw_buf[i]);
+}
+
 /*-------------------------------------------------------------------------
  * Function:    taurus_readblockvar
  *
@@ -1506,12 +1474,9 @@ taurus_calc (TAURUSfile *taurus, float *buf, int lbuf, int ncomps, int offset,
 static int
 taurus_readblockvar (TAURUSfile *taurus, int var_id, int val_id, float *var)
 {
-    int            size;
-    int            lbuf;
-    float         *buf;
-    int            ivar;
-    int            n;
-    int            ifile, iadd, nel, offset, ncomps;
+    float const   *buf;
+    int            ifile, nel, offset, ncomps;
+    long long      iadd;
 
     /*
      * When reading displacements we are reading the coordinates in
@@ -1531,35 +1496,14 @@ taurus_readblockvar (TAURUSfile *taurus, int var_id, int val_id, float *var)
     offset = taurus->var_offset[val_id];
     ncomps = taurus->var_ncomps[val_id];
 
-    /*
-     * Allocate space for the buffer.
-     */
-    size = nel * ncomps;
-
-    if (size < MAXBUF)
-        lbuf = size;
-    else
-        lbuf = (MAXBUF / ncomps) * ncomps;
-
-    buf = ALLOC_N(float, lbuf);
+    if (nel <= 0)
+        return (0);
 
-    /*
-     * Read a buffer full of data at a time, and transfer it to
-     * the real variable using the appropriate stride.
-     */
-    ivar = 0;
-    while (size > 0) {
-        n = MIN(size, lbuf);
-        taurus_read(taurus, ifile, iadd, n * sizeof(int), (char*)buf);
-
-        taurus_calc(taurus, buf, n, ncomps, offset, var_id, var, ivar);
-        ivar += n / ncomps;
-        iadd += n * sizeof(int);
+    buf = taurus_readraw(taurus, ifile, iadd, nel * ncomps);
+    if (buf == NULL)
+        return (-1);
 
-        size -= n;
-    }
-
-    FREE(buf);
+    taurus_calc(taurus, buf, nel, ncomps, offset, var_id, var);
 
     return (0);
 }
@@ -1613,8 +1557,6 @@ db_taur_open (char const *basename)
         return (NULL);
     }
 
-    taurus->ifile = 0;
-    taurus->fd = fd;
     taurus->basename = ALLOC_N(char, strlen(basename) + 1);
     strcpy(taurus->basename, basename);
     taurus->filename = ALLOC_N(char, strlen(basename) + 4);
@@ -1695,6 +1637,7 @@ db_taur_open (char const *basename)
     title[40] = '\0';
     fix_title(title);
     strcpy(taurus->title, title);
+    close(fd);
 
     /*
      * Initialize the file information.
@@ -1744,8 +1687,20 @@ db_taur_open (char const *basename)
 int
 db_taur_close (TAURUSfile *taurus)
 {
+    int            i;
 
-    close(taurus->fd);
+    for (i = 0; i < taurus->nfiles; i++) {
+#if HAVE_SYS_MMAN_H
+        if (taurus->maps[i] != NULL)
+            munmap(taurus->maps[i], (size_t) taurus->filesize[i]);
+#endif
+        if (taurus->fds[i] >= 0)
+            close(taurus->fds[i]);
+    }
+    FREE(taurus->maps);
+    FREE(taurus->fds);
+    for (i = 0; i < MAX_RAW; i++)
+        FREE(taurus->raw_buf[i]);
     FREE(taurus->basename);
     FREE(taurus->filename);
     FREE(taurus->filesize);
@@ -2095,8 +2050,9 @@ init_coord_info (TAURUSfile *taurus)
 {
     int            i;
     int            ndim, numnp;
-    int            state_loc, state_file;
-    int            loc, len, lbuf;
+    int            state_file;
+    long long      state_loc, loc;
+    int            len, lbuf;
     float         *buf;
     float         *coords;
 
@@ -2179,7 +2135,8 @@ void
 init_zone_info (TAURUSfile *taurus)
 {
     int            i, j;
-    int            ifile, loc;
+    int            ifile;
+    long long      loc;
     int           *zones, *mats;
     int           *faces, nfaces, *zoneno;
 
@@ -2209,8 +2166,8 @@ init_zone_info (TAURUSfile *taurus)
      */
     ifile = taurus->state_file [taurus->state];
     loc  = taurus->state_loc [taurus->state];
-    loc += (taurus->it * taurus->numnp +
-            taurus->ndim * taurus->numnp *
+    loc += ((long long) taurus->it * taurus->numnp +
+            (long long) taurus->ndim * taurus->numnp *
             (taurus->iu + taurus->iv + taurus->ia) +
             taurus->nel8 * taurus->nv3d +
             taurus->nel4 * taurus->nv2d +
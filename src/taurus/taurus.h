@@ -59,6 +59,7 @@ be used for advertising or product endorsement purposes.
 
 #define MAX_MESH  5
 #define MAX_VAL  69
+#define MAX_RAW   4
 
 #define VAR_NORMAL          0
 #define VAR_SIGX            1
@@ -185,20 +186,20 @@ typedef struct {
 /*
  * File information.
  */
-    int            ifile;       /* The number of the currently open file */
     char           title[48];   /* The title associated with the file */
-    int            fd;          /* File descriptor of currently open file */
     char          *basename;    /* The file root name */
-    char          *filename;    /* The name of the currently open file */
+    char          *filename;    /* Space for the name of a family member */
     int            nfiles;      /* The number of files in the family */
-    int           *filesize;    /* The size of each file in the family */
+    long long     *filesize;    /* The size of each file in the family */
+    int           *fds;         /* Descriptor of each file, -1 if mapped */
+    char         **maps;        /* Mapping of each file, NULL if not mapped */
 /*
  * State information.
  */
     int            state;       /* The current state, -1 if not in one */
     int            nstates;     /* The number of states */
     int           *state_file;  /* The file that each state is in */
-    int           *state_loc;   /* The address of each state */
+    long long     *state_loc;   /* The address of each state */
     float         *state_time;  /* The time of each state */
     int            idir;        /* The current directory within a state */
 /*
@@ -209,6 +210,14 @@ typedef struct {
     int            var_len[MAX_VAL];  /* The length of the variable */
     int            var_offset[MAX_VAL];  /* The offset in the vector */
     int            var_ncomps[MAX_VAL];  /* The number of components to a vector */
+/*
+ * Raw blocks read when the family is not mapped.
+ */
+    int            raw_next;    /* The next cache entry to replace */
+    int            raw_file[MAX_RAW];  /* The file each block was read from */
+    long long      raw_addr[MAX_RAW];  /* The address of each block */
+    int            raw_size[MAX_RAW];  /* The number of values in each block */
+    float         *raw_buf[MAX_RAW];  /* The values, NULL if unused */
 /*
  * Mesh information.
  */
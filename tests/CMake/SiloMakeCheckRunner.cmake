@@ -156,6 +156,16 @@ foreach(driver ${drivers})
     silo_add_make_check_runner(NAME arbpoly3d ARGS ${driver})
     silo_add_make_check_runner(NAME multi_test ARGS ${driver})
     silo_add_make_check_runner(NAME readstuff ARGS ${driver})
+    silo_add_make_check_runner(NAME readobjects ARGS ${driver})
+    silo_add_make_check_runner(NAME arena ARGS ${driver})
+    silo_add_make_check_runner(NAME varrange ARGS ${driver})
+    silo_add_make_check_runner(NAME blockquery ARGS ${driver})
+    silo_add_make_check_runner(NAME mvquery ARGS ${driver})
+    silo_add_make_check_runner(NAME matcsr ARGS ${driver})
+    silo_add_make_check_runner(NAME pmregion ARGS ${driver})
+    silo_add_make_check_runner(NAME ucdreorder ARGS ${driver})
+    silo_add_make_check_runner(NAME phextface ARGS ${driver})
+    silo_add_make_check_runner(NAME filestats ARGS ${driver})
     silo_add_make_check_runner(NAME testfs ARGS ${driver})
     silo_add_make_check_runner(NAME empty ARGS ${driver})
     silo_add_make_check_runner(NAME efcentering ARGS ${driver})
@@ -164,6 +174,9 @@ if(${HDF5})
     # multi_file test doesn't compile without hdf5
     silo_add_make_check_runner(NAME multi_file ARGS ${driver})
     silo_add_make_check_runner(NAME multi_file ARGS use-ns ${driver})
+    silo_add_make_check_runner(NAME dedup ARGS ${driver})
+    silo_add_make_check_runner(NAME float_storage ARGS ${driver})
+    silo_add_make_check_runner(NAME groom ARGS ${driver})
 endif()
 
     silo_add_make_check_runner(NAME testall ARGS -small -fortran ${driver})
@@ -0,0 +1,305 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <silo.h>
+
+#include <std.c>
+
+#define NX 40
+#define NY 30
+
+static void
+write_file(char const *filename, int driver)
+{
+    int i, j, dims[2] = {NX, NY};
+    int nodelist[(NX-1)*(NY-1)*4], shapesize = 4, shapecnt = (NX-1)*(NY-1);
+    int meshtypes[2] = {DB_QUADMESH, DB_UCDMESH};
+    char *meshnames[2] = {"qmesh", "umesh"};
+    float x[NX], y[NY], ux[NX*NY], uy[NX*NY];
+    double vals[NX*NY];
+    void *coords[3];
+    DBfile *dbfile = DBCreate(filename, DB_CLOBBER, DB_LOCAL, "arena test", driver);
+
+    for (i = 0; i < NX; i++) x[i] = i;
+    for (i = 0; i < NY; i++) y[i] = i * 0.5;
+    for (j = 0; j < NY; j++)
+    {
+        for (i = 0; i < NX; i++)
+        {
+            ux[j*NX+i] = x[i];
+            uy[j*NX+i] = y[j];
+            vals[j*NX+i] = x[i] * y[j];
+        }
+    }
+    for (j = 0; j < NY-1; j++)
+    {
+        for (i = 0; i < NX-1; i++)
+        {
+            int z = j*(NX-1)+i;
+            nodelist[4*z+0] = j*NX+i;
+            nodelist[4*z+1] = j*NX+i+1;
+            nodelist[4*z+2] = (j+1)*NX+i+1;
+            nodelist[4*z+3] = (j+1)*NX+i;
+        }
+    }
+
+    coords[0] = x;
+    coords[1] = y;
+    coords[2] = 0;
+    DBPutQuadmesh(dbfile, "qmesh", 0, coords, dims, 2, DB_FLOAT, DB_COLLINEAR, 0);
+    DBPutQuadvar1(dbfile, "qvar", "qmesh", vals, dims, 2, 0, 0, DB_DOUBLE, DB_NODECENT, 0);
+    coords[0] = ux;
+    coords[1] = uy;
+    DBPutZonelist2(dbfile, "zl", (NX-1)*(NY-1), 2, nodelist, (NX-1)*(NY-1)*4, 0, 0, 0,
+        &shapesize, &shapecnt, &shapesize, 1, 0);
+    DBPutUcdmesh(dbfile, "umesh", 2, 0, coords, NX*NY, (NX-1)*(NY-1), "zl", 0, DB_FLOAT, 0);
+    DBPutMultimesh(dbfile, "mmesh", 2, (char const * const *) meshnames, meshtypes, 0);
+
+    DBClose(dbfile);
+}
+
+/* An allocator that counts what it hands out */
+typedef struct counts_t {
+    int nallocs;
+    int nfrees;
+    long long nbytes;
+} counts_t;
+
+static void *
+counting_alloc(size_t nbytes, void *user)
+{
+    counts_t *c = (counts_t *) user;
+    size_t *p = (size_t *) malloc(nbytes + 2*sizeof(size_t));
+    if (!p) return 0;
+    c->nallocs++;
+    c->nbytes += nbytes;
+    p[0] = nbytes;
+    return p + 2;
+}
+
+static void
+counting_free(void *ptr, void *user)
+{
+    counts_t *c = (counts_t *) user;
+    size_t *p = (size_t *) ptr - 2;
+    c->nfrees++;
+    c->nbytes -= p[0];
+    free(p);
+}
+
+typedef struct objs_t {
+    DBquadmesh *qm;
+    DBquadvar *qv;
+    DBucdmesh *um;
+    DBmultimesh *mm;
+} objs_t;
+
+static void
+get_objects(DBfile *dbfile, objs_t *o)
+{
+    o->qm = DBGetQuadmesh(dbfile, "qmesh");
+    o->qv = DBGetQuadvar(dbfile, "qvar");
+    o->um = DBGetUcdmesh(dbfile, "umesh");
+    o->mm = DBGetMultimesh(dbfile, "mmesh");
+}
+
+static void
+free_objects(objs_t *o)
+{
+    DBFreeQuadmesh(o->qm);
+    DBFreeQuadvar(o->qv);
+    DBFreeUcdmesh(o->um);
+    DBFreeMultimesh(o->mm);
+}
+
+/* Compare objects read with an arena or allocator to reference ones */
+static int
+check_objects(objs_t const *a, objs_t const *b, char const *what)
+{
+    int nerrors = 0;
+
+    if (!a->qm || !a->qv || !a->um || !a->um->zones || !a->mm)
+    {
+        fprintf(stderr, "%s: unable to read objects\n", what);
+        return 1;
+    }
+    if (memcmp(a->qm->coords[0], b->qm->coords[0], NX * sizeof(float)) ||
+        memcmp(a->qm->coords[1], b->qm->coords[1], NY * sizeof(float)) ||
+        strcmp(a->qm->labels[0], b->qm->labels[0]))
+        nerrors++;
+    if (a->qv->nels != b->qv->nels ||
+        memcmp(a->qv->vals[0], b->qv->vals[0], b->qv->nels * sizeof(double)))
+        nerrors++;
+    if (a->um->nnodes != b->um->nnodes ||
+        a->um->zones->lnodelist != b->um->zones->lnodelist ||
+        memcmp(a->um->coords[0], b->um->coords[0], b->um->nnodes * sizeof(float)) ||
+        memcmp(a->um->zones->nodelist, b->um->zones->nodelist,
+            b->um->zones->lnodelist * sizeof(int)))
+        nerrors++;
+    /* Compare the names to those written, not only to b's, so a name list
+       freed while still in use cannot match itself */
+    if (a->mm->nblocks != 2 || b->mm->nblocks != 2 ||
+        strcmp(a->mm->meshnames[0], "qmesh") || strcmp(a->mm->meshnames[1], "umesh") ||
+        strcmp(b->mm->meshnames[0], "qmesh") || strcmp(b->mm->meshnames[1], "umesh"))
+        nerrors++;
+    if (nerrors)
+        fprintf(stderr, "%s: objects differ\n", what);
+    return nerrors;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Test allocating the objects returned by DBGetXxx calls
+ *              from an arena and from a user allocator.
+ *
+ * Return:      0 on success, 1 on failure
+ *-------------------------------------------------------------------------
+ */
+int
+main(int argc, char *argv[])
+{
+    int            i, nerrors = 0;
+    int            driver = DB_PDB;
+    int            show_all_errors = FALSE;
+    char          *filename = "arena.pdb";
+    char const    *names[] = {"qmesh", "qvar", "umesh", "mmesh"};
+    int            types[4];
+    void          *ptrs[4];
+    objs_t         ref, o;
+    counts_t       counts = {0, 0, 0};
+    DBarena       *arena;
+    DBfile        *dbfile;
+
+    for (i=1; i<argc; i++) {
+        if (!strncmp(argv[i], "DB_PDB", 6)) {
+            driver = StringToDriver(argv[i]);
+            filename = "arena.pdb";
+        } else if (!strncmp(argv[i], "DB_HDF5", 7)) {
+            driver = StringToDriver(argv[i]);
+            filename = "arena.h5";
+        } else if (!strcmp(argv[i], "show-all-errors")) {
+            show_all_errors = 1;
+        } else if (argv[i][0] != '\0') {
+            fprintf(stderr, "%s: ignored argument `%s'\n", argv[0], argv[i]);
+        }
+    }
+
+    DBShowErrors(show_all_errors?DB_ALL_AND_DRVR:DB_NONE, NULL);
+
+    write_file(filename, driver);
+
+    dbfile = DBOpen(filename, DB_UNKNOWN, DB_READ);
+    get_objects(dbfile, &ref);
+
+    /* Global arena, some objects freed individually, the rest by the arena */
+    arena = DBMakeArena(0);
+    DBSetArena(arena);
+    get_objects(dbfile, &o);
+    nerrors += check_objects(&o, &ref, "arena");
+    if (DBGetArenaFile(dbfile) != arena || DBGetArenaSize(arena) == 0)
+    {
+        fprintf(stderr, "arena not used\n");
+        nerrors++;
+    }
+    DBFreeQuadvar(o.qv);
+    DBFreeMultimesh(o.mm);
+    DBReadObjects(dbfile, 4, names, -1, types, ptrs);
+    if (DBFreeArena(arena) != 0 || DBGetArena() != 0)
+    {
+        fprintf(stderr, "DBFreeArena failed\n");
+        nerrors++;
+    }
+
+    /* File-level user allocator, objects freed individually */
+    DBSetAllocatorFile(dbfile, counting_alloc, counting_free, &counts);
+    get_objects(dbfile, &o);
+    nerrors += check_objects(&o, &ref, "allocator");
+    if (counts.nallocs == 0)
+    {
+        fprintf(stderr, "allocator not used\n");
+        nerrors++;
+    }
+    free_objects(&o);
+    if (counts.nfrees != counts.nallocs || counts.nbytes != 0)
+    {
+        fprintf(stderr, "allocator: %d allocs, %d frees, %lld bytes outstanding\n",
+            counts.nallocs, counts.nfrees, counts.nbytes);
+        nerrors++;
+    }
+    DBSetAllocatorFile(dbfile, 0, 0, 0);
+
+    /* File-level arena holding a batch of objects */
+    arena = DBMakeArena(4096);
+    DBSetArenaFile(dbfile, arena);
+    if (DBReadObjects(dbfile, 4, names, -1, types, ptrs) != 4)
+    {
+        fprintf(stderr, "DBReadObjects into arena failed\n");
+        nerrors++;
+    }
+    DBFreeArena(arena);
+    if (DBGetArenaFile(dbfile) != 0)
+    {
+        fprintf(stderr, "arena not unset by DBFreeArena\n");
+        nerrors++;
+    }
+
+    free_objects(&ref);
+    DBClose(dbfile);
+
+    CleanupDriverStuff();
+    return nerrors > 0;
+}
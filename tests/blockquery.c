@@ -0,0 +1,264 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <silo.h>
+
+#include <std.c>
+
+#define NI 20
+#define NJ 16
+#define NK 10
+#define NBLOCKS (NI*NJ*NK)
+#define NQUERIES 200
+
+static unsigned int seed = 12345;
+
+static double
+urand(double lo, double hi)
+{
+    seed = seed * 1103515245u + 12345u;
+    return lo + (hi - lo) * ((seed >> 8) & 0xFFFF) / 65535.0;
+}
+
+/* Brute force test of one block against a query */
+static int
+hit(int qtype, double const *q, double const *lo, double const *hi)
+{
+    double tmin = 0, tmax = qtype == DB_QUERY_SEGMENT ? 1 : HUGE_VAL;
+    int d;
+    for (d = 0; d < 3; d++)
+    {
+        if (qtype == DB_QUERY_POINT)
+        {
+            if (q[d] < lo[d] || q[d] > hi[d]) return 0;
+        }
+        else if (qtype == DB_QUERY_BOX)
+        {
+            if (q[3+d] < lo[d] || q[d] > hi[d]) return 0;
+        }
+        else
+        {
+            double dir = qtype == DB_QUERY_RAY ? q[3+d] : q[3+d] - q[d];
+            if (dir == 0)
+            {
+                if (q[d] < lo[d] || q[d] > hi[d]) return 0;
+            }
+            else
+            {
+                double t0 = (lo[d] - q[d]) / dir, t1 = (hi[d] - q[d]) / dir;
+                if (t0 > t1) { double t = t0; t0 = t1; t1 = t; }
+                if (t0 > tmin) tmin = t0;
+                if (t1 < tmax) tmax = t1;
+                if (tmin > tmax) return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+static int
+check_query(DBfile *dbfile, char const *name, int qtype, double const *q,
+    double const *extents, char const * const *names)
+{
+    int i, n, nexp = 0, nerrors = 0;
+    int *blocks = NULL;
+
+    n = DBQueryMultimeshBlocks(dbfile, name, qtype, q, &blocks);
+    for (i = 0; i < NBLOCKS; i++)
+    {
+        if (!strcmp(names[i], "EMPTY"))
+            continue;
+        if (extents && !hit(qtype, q, &extents[6*i], &extents[6*i+3]))
+            continue;
+        if (nexp >= n || blocks[nexp] != i)
+        {
+            fprintf(stderr, "%s: query type %d: block %d expected\n", name, qtype, i);
+            nerrors++;
+            break;
+        }
+        nexp++;
+    }
+    if (!nerrors && n != nexp)
+    {
+        fprintf(stderr, "%s: query type %d: got %d blocks, expected %d\n", name, qtype, n, nexp);
+        nerrors++;
+    }
+    free(blocks);
+    return nerrors;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Test DBQueryMultimeshBlocks against a brute force search
+ *              of the multimesh extents.
+ *
+ * Return:      0 on success, 1 on failure
+ *-------------------------------------------------------------------------
+ */
+int
+main(int argc, char *argv[])
+{
+    int            i, j, k, nerrors = 0;
+    int            driver = DB_PDB;
+    int            show_all_errors = FALSE;
+    char          *filename = "blockquery.pdb";
+    int            extsize = 6, n;
+    int           *types, *blocks;
+    char         **names;
+    double        *extents;
+    DBoptlist     *ol;
+    DBfile        *dbfile;
+
+    for (i=1; i<argc; i++) {
+        if (!strncmp(argv[i], "DB_PDB", 6)) {
+            driver = StringToDriver(argv[i]);
+            filename = "blockquery.pdb";
+        } else if (!strncmp(argv[i], "DB_HDF5", 7)) {
+            driver = StringToDriver(argv[i]);
+            filename = "blockquery.h5";
+        } else if (!strcmp(argv[i], "show-all-errors")) {
+            show_all_errors = 1;
+        } else if (argv[i][0] != '\0') {
+            fprintf(stderr, "%s: ignored argument `%s'\n", argv[0], argv[i]);
+        }
+    }
+
+    DBShowErrors(show_all_errors?DB_ALL_AND_DRVR:DB_ABORT, NULL);
+
+    /* Slightly overlapping blocks on a stretched grid, some empty */
+    types = (int *) malloc(NBLOCKS * sizeof(int));
+    names = (char **) malloc(NBLOCKS * sizeof(char *));
+    extents = (double *) malloc(NBLOCKS * 6 * sizeof(double));
+    for (k = 0; k < NK; k++)
+        for (j = 0; j < NJ; j++)
+            for (i = 0; i < NI; i++)
+            {
+                int b = (k*NJ+j)*NI+i;
+                double *e = &extents[6*b];
+                names[b] = (char *) malloc(32);
+                if (b % 7 == 3)
+                    strcpy(names[b], "EMPTY");
+                else
+                    sprintf(names[b], "block%d/mesh", b);
+                types[b] = DB_QUADMESH;
+                e[0] = i * 1.5 - 0.01;  e[3] = (i+1) * 1.5 + 0.01;
+                e[1] = j - 0.01;        e[4] = j + 1 + 0.01;
+                e[2] = 0.5 * k * k;     e[5] = 0.5 * (k+1) * (k+1);
+            }
+
+    dbfile = DBCreate(filename, DB_CLOBBER, DB_LOCAL, "block query test", driver);
+    ol = DBMakeOptlist(2);
+    DBAddOption(ol, DBOPT_EXTENTS_SIZE, &extsize);
+    DBAddOption(ol, DBOPT_EXTENTS, extents);
+    DBPutMultimesh(dbfile, "mmesh", NBLOCKS, (DBCAS_t) names, types, ol);
+    DBFreeOptlist(ol);
+    DBPutMultimesh(dbfile, "mmesh_noext", NBLOCKS, (DBCAS_t) names, types, 0);
+    DBClose(dbfile);
+
+    dbfile = DBOpen(filename, DB_UNKNOWN, DB_READ);
+
+    for (i = 0; i < NQUERIES && !nerrors; i++)
+    {
+        double q[6];
+        int d;
+        for (d = 0; d < 3; d++)
+            q[d] = urand(-2, 32);
+        q[1] = urand(-2, 18);
+        q[2] = urand(-2, 52);
+        nerrors += check_query(dbfile, "mmesh", DB_QUERY_POINT, q, extents, (char const * const *) names);
+
+        q[3] = q[0] + urand(0, 4);
+        q[4] = q[1] + urand(0, 3);
+        q[5] = q[2] + urand(0, 10);
+        nerrors += check_query(dbfile, "mmesh", DB_QUERY_BOX, q, extents, (char const * const *) names);
+        nerrors += check_query(dbfile, "mmesh", DB_QUERY_SEGMENT, q, extents, (char const * const *) names);
+
+        q[3] = urand(-1, 1);
+        q[4] = urand(-1, 1);
+        q[5] = i % 5 ? urand(-1, 1) : 0;
+        nerrors += check_query(dbfile, "mmesh", DB_QUERY_RAY, q, extents, (char const * const *) names);
+    }
+
+    /* A point on a shared face is in both blocks */
+    {
+        double q[3] = {3.0, 2.5, 2.0};
+        n = DBQueryMultimeshBlocks(dbfile, "mmesh", DB_QUERY_POINT, q, &blocks);
+        if (n < 2)
+        {
+            fprintf(stderr, "face point found in %d blocks\n", n);
+            nerrors++;
+        }
+        free(blocks);
+    }
+
+    /* Without extents, all non-empty blocks are returned */
+    {
+        double q[3] = {1, 1, 1};
+        nerrors += check_query(dbfile, "mmesh_noext", DB_QUERY_POINT, q, 0, (char const * const *) names);
+    }
+
+    DBClose(dbfile);
+
+    for (i = 0; i < NBLOCKS; i++)
+        free(names[i]);
+    free(names);
+    free(types);
+    free(extents);
+
+    CleanupDriverStuff();
+    return nerrors > 0;
+}
@@ -141,6 +141,12 @@ main(int argc, char *argv[])
           DBSetCompression("METHOD=GZIP");
        } else if (!strcmp(argv[i], "gzip9")) {
           DBSetCompression("METHOD=GZIP LEVEL=9");
+       } else if (!strcmp(argv[i], "auto")) {
+          DBSetCompression("METHOD=AUTO");
+       } else if (!strcmp(argv[i], "zstd")) {
+          DBSetCompression("METHOD=ZSTD LEVEL=3");
+       } else if (!strcmp(argv[i], "lz4")) {
+          DBSetCompression("METHOD=LZ4");
        } else if (!strcmp(argv[i], "fpzip")) {
           DBSetCompression("METHOD=FPZIP");
        } else if (!strcmp(argv[i], "zfp")) {
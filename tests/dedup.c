@@ -0,0 +1,350 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <silo.h>
+
+#include <std.c>
+
+#define NX 64
+#define NY 48
+#define NBLOCKS 8
+
+/* Write NBLOCKS quadmeshes and node-centered vars whose coordinates (and
+   for even blocks, variable values) are all identical. */
+static void
+write_file(char const *filename, int driver, double *x, double *y, double *v, int cycle)
+{
+    int i, dims[2] = {NX, NY};
+    char const * const cnames[2] = {"x", "y"};
+    DBfile *dbfile = DBCreate(filename, DB_CLOBBER, DB_LOCAL, "dedup test", driver);
+    DBoptlist *ol = DBMakeOptlist(1);
+
+    DBAddOption(ol, DBOPT_CYCLE, &cycle);
+    for (i = 0; i < NBLOCKS; i++)
+    {
+        char mname[32], vname[32];
+        void *coords[3];
+        coords[0] = x;
+        coords[1] = y;
+        coords[2] = 0;
+        sprintf(mname, "mesh%d", i);
+        sprintf(vname, "var%d", i);
+        DBPutQuadmesh(dbfile, mname, (DBCAS_t) cnames, coords, dims, 2,
+            DB_DOUBLE, DB_NONCOLLINEAR, ol);
+        DBPutQuadvar1(dbfile, vname, mname, v + (i%2), dims, 2, 0, 0,
+            DB_DOUBLE, DB_NODECENT, ol);
+    }
+    DBFreeOptlist(ol);
+    DBClose(dbfile);
+}
+
+/* Compare a block read back to the data written */
+static int
+check_block(char const *filename, int i, DBquadmesh const *qm, DBquadvar const *qv,
+    double const *x, double const *y, double const *v)
+{
+    int j;
+
+    if (!qm || !qv)
+    {
+        fprintf(stderr, "unable to read block %d from \"%s\"\n", i, filename);
+        return 1;
+    }
+    for (j = 0; j < NX*NY; j++)
+    {
+        if (((double*)qm->coords[0])[j] != x[j] ||
+            ((double*)qm->coords[1])[j] != y[j] ||
+            ((double*)qv->vals[0])[j] != v[j+(i%2)])
+        {
+            fprintf(stderr, "data mismatch at index %d of block %d in \"%s\"\n",
+                j, i, filename);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Read everything back, one object at a time and then with
+   DBReadObjects, and compare */
+static int
+check_file(char const *filename, double const *x, double const *y, double const *v)
+{
+    int i, nerrors = 0;
+    char names[2*NBLOCKS][32];
+    char const *pnames[2*NBLOCKS];
+    int types[2*NBLOCKS];
+    void *objs[2*NBLOCKS];
+    DBfile *dbfile = DBOpen(filename, DB_UNKNOWN, DB_READ);
+
+    if (!dbfile)
+    {
+        fprintf(stderr, "unable to open \"%s\"\n", filename);
+        return 1;
+    }
+
+    for (i = 0; i < NBLOCKS; i++)
+    {
+        DBquadmesh *qm;
+        DBquadvar *qv;
+
+        sprintf(names[2*i], "mesh%d", i);
+        sprintf(names[2*i+1], "var%d", i);
+        pnames[2*i] = names[2*i];
+        pnames[2*i+1] = names[2*i+1];
+        qm = DBGetQuadmesh(dbfile, names[2*i]);
+        qv = DBGetQuadvar(dbfile, names[2*i+1]);
+        nerrors += check_block(filename, i, qm, qv, x, y, v);
+        DBFreeQuadmesh(qm);
+        DBFreeQuadvar(qv);
+    }
+
+    /* Linked arrays, within the file or into the previous one, read in
+       a batch must match too */
+    if (DBReadObjects(dbfile, 2*NBLOCKS, pnames, -1, types, objs) != 2*NBLOCKS)
+    {
+        fprintf(stderr, "DBReadObjects failed on \"%s\"\n", filename);
+        nerrors++;
+    }
+    else
+    {
+        for (i = 0; i < NBLOCKS; i++)
+            nerrors += check_block(filename, i, (DBquadmesh *) objs[2*i],
+                (DBquadvar *) objs[2*i+1], x, y, v);
+    }
+    DBFreeObjects(2*NBLOCKS, types, objs);
+
+    DBClose(dbfile);
+    return nerrors;
+}
+
+static off_t
+file_size(char const *filename)
+{
+    struct stat buf;
+    if (stat(filename, &buf) != 0)
+        return 0;
+    return buf.st_size;
+}
+
+static int
+make_dir(char const *dirname)
+{
+#ifdef _WIN32
+    return _mkdir(dirname);
+#else
+    return mkdir(dirname, S_IRWXU|S_IRWXG|S_IRWXO);
+#endif
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Test content-hash deduplication of array data both within
+ *              a file and, via PREVFILE=, across files. Data written with
+ *              lossy compression must not stand in for lossless data and
+ *              links into a previous file in another directory must
+ *              resolve from any working directory, or not be made when
+ *              the path of the previous file is too long to record.
+ *
+ * Return:      0 on success, 1 on failure
+ *-------------------------------------------------------------------------
+ */
+int
+main(int argc, char *argv[])
+{
+    int            i, j, nerrors = 0;
+    int            driver = DB_HDF5;
+    int            show_all_errors = FALSE;
+    double        *x, *y, *v;
+    off_t          plain_size, dedup_size, next_size;
+    char           longdir[251];
+
+    for (i=1; i<argc; i++) {
+        if (!strncmp(argv[i], "DB_PDB", 6)) {
+            fprintf(stderr, "This test only supported on HDF5 driver\n");
+            exit(EXIT_SUCCESS);
+        } else if (!strncmp(argv[i], "DB_HDF5", 7)) {
+            driver = StringToDriver(argv[i]);
+        } else if (!strcmp(argv[i], "show-all-errors")) {
+            show_all_errors = 1;
+        } else if (argv[i][0] != '\0') {
+            fprintf(stderr, "%s: ignored argument `%s'\n", argv[0], argv[i]);
+        }
+    }
+
+    DBShowErrors(show_all_errors?DB_ALL_AND_DRVR:DB_ABORT, NULL);
+
+    x = (double *) malloc(NX * NY * sizeof(double));
+    y = (double *) malloc(NX * NY * sizeof(double));
+    v = (double *) malloc((NX * NY + 1) * sizeof(double));
+    for (j = 0; j < NY; j++)
+    {
+        for (i = 0; i < NX; i++)
+        {
+            x[j*NX+i] = i + 0.1 * sin(j);
+            y[j*NX+i] = j + 0.1 * cos(i);
+            v[j*NX+i] = x[j*NX+i] * y[j*NX+i];
+        }
+    }
+    v[NX*NY] = 1;
+
+    /* Baseline without deduplication */
+    DBSetDeduplication(0);
+    write_file("dedup_none.h5", driver, x, y, v, 0);
+    plain_size = file_size("dedup_none.h5");
+
+    /* Deduplicate within a single file */
+    DBSetDeduplication("");
+    write_file("dedup0.h5", driver, x, y, v, 0);
+    dedup_size = file_size("dedup0.h5");
+
+    /* Deduplicate against the previous file */
+    DBSetDeduplication("PREVFILE=dedup0.h5");
+    write_file("dedup1.h5", driver, x, y, v, 1);
+    next_size = file_size("dedup1.h5");
+    DBSetDeduplication(0);
+
+    /* Lossy data in the previous file is not used for lossless data */
+    DBSetCompression("METHOD=GZIP PRECISION=12");
+    DBSetDeduplication("");
+    write_file("dedup_lossy.h5", driver, x, y, v, 0);
+    DBSetCompression(0);
+    DBSetDeduplication("PREVFILE=dedup_lossy.h5");
+    write_file("dedup2.h5", driver, x, y, v, 1);
+    DBSetDeduplication(0);
+
+    /* Previous file in a subdirectory of the working directory */
+    make_dir("dedup_dir");
+    DBSetDeduplication("");
+    write_file("dedup_dir/dedup0.h5", driver, x, y, v, 0);
+    DBSetDeduplication("PREVFILE=dedup_dir/dedup0.h5");
+    write_file("dedup_dir/dedup1.h5", driver, x, y, v, 1);
+    DBSetDeduplication(0);
+
+    nerrors += check_file("dedup_none.h5", x, y, v);
+    nerrors += check_file("dedup0.h5", x, y, v);
+    nerrors += check_file("dedup1.h5", x, y, v);
+    nerrors += check_file("dedup2.h5", x, y, v);
+    if (chdir("dedup_dir") == 0)
+    {
+        nerrors += check_file("dedup1.h5", x, y, v);
+        if (chdir("..") != 0) nerrors++;
+    }
+    else
+    {
+        fprintf(stderr, "unable to chdir to \"dedup_dir\"\n");
+        nerrors++;
+    }
+
+    /* Previous file whose absolute path does not fit in the dedup index */
+    memset(longdir, 'd', sizeof(longdir)-1);
+    longdir[sizeof(longdir)-1] = '\0';
+    make_dir(longdir);
+    if (chdir(longdir) == 0)
+    {
+        make_dir("sub");
+        DBSetDeduplication("");
+        write_file("dedup0.h5", driver, x, y, v, 0);
+        DBSetDeduplication("PREVFILE=dedup0.h5");
+        write_file("sub/dedup1.h5", driver, x, y, v, 1);
+        DBSetDeduplication(0);
+        if (chdir("sub") == 0)
+        {
+            nerrors += check_file("dedup1.h5", x, y, v);
+            if (chdir("..") != 0) nerrors++;
+        }
+        else
+        {
+            nerrors++;
+        }
+        if (chdir("..") != 0) nerrors++;
+    }
+    else
+    {
+        fprintf(stderr, "unable to chdir to long directory\n");
+        nerrors++;
+    }
+
+    /* Of the 4*NBLOCKS arrays only 4 are unique */
+    if (dedup_size > plain_size / 2)
+    {
+        fprintf(stderr, "deduplicated file size %lld not much less than %lld\n",
+            (long long) dedup_size, (long long) plain_size);
+        nerrors++;
+    }
+
+    /* All of the arrays are in the previous file */
+    if (next_size >= dedup_size)
+    {
+        fprintf(stderr, "cross-file deduplicated size %lld not less than %lld\n",
+            (long long) next_size, (long long) dedup_size);
+        nerrors++;
+    }
+
+    free(x);
+    free(y);
+    free(v);
+
+    CleanupDriverStuff();
+    return nerrors > 0;
+}
@@ -0,0 +1,185 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <math.h>
+#include <stdio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <silo.h>
+
+#include <std.c>
+
+#define NX 40
+#define NY 30
+
+/* Find the entry of call NAME in STATS */
+static DBcallstats const *
+find_call(DBfilestats const *stats, char const *name)
+{
+    int i;
+    for (i = 0; i < stats->ncalls; i++)
+        if (!strcmp(stats->calls[i].name, name))
+            return &stats->calls[i];
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Test the per-file call statistics and the trace event log.
+ *
+ * Return:      0 on success, 1 on failure
+ *-------------------------------------------------------------------------
+ */
+int
+main(int argc, char *argv[])
+{
+    int            i, nerrors = 0;
+    int            driver = DB_PDB;
+    int            show_all_errors = FALSE;
+    char          *filename = "filestats.pdb";
+    int            dims[2] = {NX, NY};
+    float          x[NX], y[NY];
+    double         vals[NX*NY];
+    void          *coords[2];
+    DBfile        *dbfile;
+    DBfilestats   *stats;
+    DBcallstats const *c;
+    DBquadvar     *qv;
+    FILE          *trace;
+    char           buf[256];
+
+    for (i=1; i<argc; i++) {
+        if (!strncmp(argv[i], "DB_PDB", 6)) {
+            driver = StringToDriver(argv[i]);
+            filename = "filestats.pdb";
+        } else if (!strncmp(argv[i], "DB_HDF5", 7)) {
+            driver = StringToDriver(argv[i]);
+            filename = "filestats.h5";
+        } else if (!strcmp(argv[i], "show-all-errors")) {
+            show_all_errors = 1;
+        } else if (argv[i][0] != '\0') {
+            fprintf(stderr, "%s: ignored argument `%s'\n", argv[0], argv[i]);
+        }
+    }
+
+    DBShowErrors(show_all_errors?DB_ALL_AND_DRVR:DB_NONE, NULL);
+
+    for (i = 0; i < NX; i++) x[i] = i;
+    for (i = 0; i < NY; i++) y[i] = i * 0.5;
+    for (i = 0; i < NX*NY; i++) vals[i] = i;
+    coords[0] = x;
+    coords[1] = y;
+
+    DBSetTraceFile("filestats.json");
+
+    /* Writing */
+    dbfile = DBCreate(filename, DB_CLOBBER, DB_LOCAL, "filestats test", driver);
+    DBPutQuadmesh(dbfile, "qmesh", 0, coords, dims, 2, DB_FLOAT, DB_COLLINEAR, 0);
+    DBPutQuadvar1(dbfile, "qvar", "qmesh", vals, dims, 2, 0, 0, DB_DOUBLE, DB_NODECENT, 0);
+    DBPutQuadvar1(dbfile, "qvar2", "qmesh", vals, dims, 2, 0, 0, DB_DOUBLE, DB_NODECENT, 0);
+    stats = DBGetFileStats(dbfile);
+    if (!stats || !(c = find_call(stats, "DBPutQuadvar1")) ||
+        c->count != 2 || c->objtype != DB_QUADVAR ||
+        c->bytes_written < 2 * NX * NY * (long long) sizeof(double) ||
+        c->datasets < 2 || stats->total.count < 3 ||
+        stats->total.bytes_written < c->bytes_written)
+    {
+        fprintf(stderr, "unexpected write statistics\n");
+        nerrors++;
+    }
+    DBFreeFileStats(stats);
+    DBClose(dbfile);
+
+    /* Reading, after a reset */
+    dbfile = DBOpen(filename, DB_UNKNOWN, DB_READ);
+    qv = DBGetQuadvar(dbfile, "qvar");
+    DBResetFileStats(dbfile);
+    stats = DBGetFileStats(dbfile);
+    if (!stats || stats->ncalls != 0 || stats->total.count != 0)
+    {
+        fprintf(stderr, "statistics not reset\n");
+        nerrors++;
+    }
+    DBFreeFileStats(stats);
+    DBFreeQuadvar(qv);
+    qv = DBGetQuadvar(dbfile, "qvar2");
+    stats = DBGetFileStats(dbfile);
+    if (!stats || stats->ncalls != 1 || !(c = find_call(stats, "DBGetQuadvar")) ||
+        c->count != 1 || c->objtype != DB_QUADVAR ||
+        c->bytes_read < NX * NY * (long long) sizeof(double) ||
+        c->seconds < 0)
+    {
+        fprintf(stderr, "unexpected read statistics\n");
+        nerrors++;
+    }
+    DBFreeFileStats(stats);
+    DBFreeQuadvar(qv);
+    DBClose(dbfile);
+
+    DBSetTraceFile(0);
+
+    /* The trace is a JSON array of complete events */
+    if (!(trace = fopen("filestats.json", "r")) ||
+        !fgets(buf, sizeof(buf), trace) || strcmp(buf, "[\n") ||
+        !fgets(buf, sizeof(buf), trace) || !strstr(buf, "\"ph\":\"X\"") ||
+        !strstr(buf, "\"name\":\"DBCreate\""))
+    {
+        fprintf(stderr, "unexpected trace file\n");
+        nerrors++;
+    }
+    if (trace) fclose(trace);
+
+    CleanupDriverStuff();
+    return nerrors > 0;
+}
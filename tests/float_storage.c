@@ -0,0 +1,289 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <silo.h>
+
+#include <std.c>
+
+#define NX 100
+#define NY 80
+#define NSPECIAL 8
+
+static off_t
+file_size(char const *filename)
+{
+    struct stat buf;
+    if (stat(filename, &buf) != 0)
+        return 0;
+    return buf.st_size;
+}
+
+static void
+write_file(char const *filename, int driver, int storage, float *fvals, double *dvals)
+{
+    int i, dims[2] = {NX, NY};
+    int bf16 = DB_FLOAT_STORAGE_BFLOAT16;
+    float x[NX], y[NY];
+    void *coords[3];
+    DBfile *dbfile = DBCreate(filename, DB_CLOBBER, DB_LOCAL, "float storage test", driver);
+    DBoptlist *ol = DBMakeOptlist(1);
+
+    for (i = 0; i < NX; i++) x[i] = i;
+    for (i = 0; i < NY; i++) y[i] = i;
+    coords[0] = x;
+    coords[1] = y;
+    coords[2] = 0;
+
+    DBSetFloatStorageFile(dbfile, storage);
+    DBPutQuadmesh(dbfile, "mesh", 0, coords, dims, 2, DB_FLOAT, DB_COLLINEAR, 0);
+    DBPutQuadvar1(dbfile, "fvar", "mesh", fvals, dims, 2, 0, 0, DB_FLOAT, DB_NODECENT, 0);
+    DBPutQuadvar1(dbfile, "dvar", "mesh", dvals, dims, 2, 0, 0, DB_DOUBLE, DB_NODECENT, 0);
+
+    /* per-call hint overrides the file setting */
+    DBAddOption(ol, DBOPT_FLOAT_STORAGE, &bf16);
+    DBPutQuadvar1(dbfile, "bvar", "mesh", fvals, dims, 2, 0, 0, DB_FLOAT, DB_NODECENT, ol);
+    DBFreeOptlist(ol);
+
+    DBClose(dbfile);
+}
+
+/* Relative error bound for half (11 bit) and bfloat16 (8 bit) significands */
+static int
+check_var(DBfile *dbfile, char const *name, double const *expected, double tol)
+{
+    int i, nerrors = 0;
+    int half = tol > 0 && tol < 1.0/1024;
+    DBquadvar *qv = DBGetQuadvar(dbfile, name);
+
+    if (!qv)
+    {
+        fprintf(stderr, "unable to read \"%s\"\n", name);
+        return 1;
+    }
+
+    for (i = 0; i < NX*NY && nerrors < 10; i++)
+    {
+        double v = qv->datatype == DB_DOUBLE ? ((double*)qv->vals[0])[i] :
+                                               ((float*)qv->vals[0])[i];
+        double e = expected[i];
+        if (isnan(e))
+        {
+            if (!isnan(v))
+            {
+                fprintf(stderr, "%s[%d]: expected nan, got %g\n", name, i, v);
+                nerrors++;
+            }
+        }
+        else if (isinf(e) || (half && fabs(e) >= 65520))
+        {
+            if (!(isinf(v) && (v > 0) == (e > 0)))
+            {
+                fprintf(stderr, "%s[%d]: expected inf, got %g\n", name, i, v);
+                nerrors++;
+            }
+        }
+        else if (fabs(v - e) > tol * fabs(e) + 6e-8)
+        {
+            fprintf(stderr, "%s[%d]: expected %g, got %g\n", name, i, e, v);
+            nerrors++;
+        }
+    }
+
+    DBFreeQuadvar(qv);
+    return nerrors;
+}
+
+/* Doubles round to half once and values too large for half are refused */
+static int
+check_half_edges(int driver)
+{
+    int nerrors = 0, dims[1] = {2};
+    double tie[2], big[2] = {1.0, 70000.0};
+    float big_f[2] = {1.0f, 70000.0f};
+    float x[2] = {0.0f, 1.0f};
+    void *coords[1];
+    DBquadvar *qv;
+    DBfile *dbfile = DBCreate("float_storage_edges.h5", DB_CLOBBER, DB_LOCAL,
+                         "float storage test", driver);
+
+    /* just above the midpoint of 1 and 1+2^-10; rounding via float ties to 1 */
+    tie[0] = 1.0 + ldexp(1.0, -11) + ldexp(1.0, -40);
+    tie[1] = -tie[0];
+    coords[0] = x;
+    DBSetFloatStorageFile(dbfile, DB_FLOAT_STORAGE_HALF);
+    DBPutQuadmesh(dbfile, "mesh", 0, coords, dims, 1, DB_FLOAT, DB_COLLINEAR, 0);
+    DBPutQuadvar1(dbfile, "tie", "mesh", tie, dims, 1, 0, 0, DB_DOUBLE, DB_NODECENT, 0);
+
+    DBShowErrors(DB_NONE, NULL);
+    if (DBPutQuadvar1(dbfile, "big", "mesh", big, dims, 1, 0, 0, DB_DOUBLE, DB_NODECENT, 0) == 0 ||
+        DBErrno() != E_COMPRESSION)
+    {
+        fprintf(stderr, "double overflow of half storage not reported\n");
+        nerrors++;
+    }
+    if (DBPutQuadvar1(dbfile, "big_f", "mesh", big_f, dims, 1, 0, 0, DB_FLOAT, DB_NODECENT, 0) == 0 ||
+        DBErrno() != E_COMPRESSION)
+    {
+        fprintf(stderr, "float overflow of half storage not reported\n");
+        nerrors++;
+    }
+    DBShowErrors(DB_ABORT, NULL);
+    DBClose(dbfile);
+
+    dbfile = DBOpen("float_storage_edges.h5", DB_UNKNOWN, DB_READ);
+    qv = DBGetQuadvar(dbfile, "tie");
+    if (!qv || qv->datatype != DB_FLOAT ||
+        ((float*)qv->vals[0])[0] != 1.0f + 1.0f/1024 ||
+        ((float*)qv->vals[0])[1] != -1.0f - 1.0f/1024)
+    {
+        fprintf(stderr, "double to half conversion rounded twice\n");
+        nerrors++;
+    }
+    DBFreeQuadvar(qv);
+    DBClose(dbfile);
+
+    return nerrors;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Test reduced precision (half and bfloat16) storage of
+ *              floating point arrays and their widening on read.
+ *
+ * Return:      0 on success, 1 on failure
+ *-------------------------------------------------------------------------
+ */
+int
+main(int argc, char *argv[])
+{
+    int            i, nerrors = 0;
+    int            driver = DB_HDF5;
+    int            show_all_errors = FALSE;
+    float         *fvals;
+    double        *dvals, *expected;
+    double         special[NSPECIAL];
+    off_t          native_size, half_size;
+    DBfile        *dbfile;
+
+    for (i=1; i<argc; i++) {
+        if (!strncmp(argv[i], "DB_PDB", 6)) {
+            fprintf(stderr, "This test only supported on HDF5 driver\n");
+            exit(EXIT_SUCCESS);
+        } else if (!strncmp(argv[i], "DB_HDF5", 7)) {
+            driver = StringToDriver(argv[i]);
+        } else if (!strcmp(argv[i], "show-all-errors")) {
+            show_all_errors = 1;
+        } else if (argv[i][0] != '\0') {
+            fprintf(stderr, "%s: ignored argument `%s'\n", argv[0], argv[i]);
+        }
+    }
+
+    DBShowErrors(show_all_errors?DB_ALL_AND_DRVR:DB_ABORT, NULL);
+
+    special[0] = 0.0;
+    special[1] = -1.0;
+    special[2] = 65504.0;       /* largest half */
+    special[3] = 1.0e-7;        /* half subnormal */
+    special[4] = 65519.0;       /* rounds down to largest half */
+    special[5] = INFINITY;
+    special[6] = NAN;
+    special[7] = 6.103515625e-05; /* smallest normal half */
+
+    fvals = (float *) malloc(NX * NY * sizeof(float));
+    dvals = (double *) malloc(NX * NY * sizeof(double));
+    expected = (double *) malloc(NX * NY * sizeof(double));
+    for (i = 0; i < NX*NY; i++)
+    {
+        double x = i < NSPECIAL ? special[i] : 1000.0 * sin(0.001 * i);
+        fvals[i] = (float) x;
+        dvals[i] = x;
+        expected[i] = (float) x;
+    }
+
+    write_file("float_storage_native.h5", driver, DB_FLOAT_STORAGE_NATIVE, fvals, dvals);
+    write_file("float_storage_half.h5", driver, DB_FLOAT_STORAGE_HALF, fvals, dvals);
+    native_size = file_size("float_storage_native.h5");
+    half_size = file_size("float_storage_half.h5");
+
+    dbfile = DBOpen("float_storage_native.h5", DB_UNKNOWN, DB_READ);
+    nerrors += check_var(dbfile, "fvar", expected, 0);
+    DBClose(dbfile);
+
+    dbfile = DBOpen("float_storage_half.h5", DB_UNKNOWN, DB_READ);
+    nerrors += check_var(dbfile, "fvar", expected, 1.0/2048);
+    nerrors += check_var(dbfile, "dvar", expected, 1.0/2048);
+    nerrors += check_var(dbfile, "bvar", expected, 1.0/256);
+    DBClose(dbfile);
+
+    nerrors += check_half_edges(driver);
+
+    if (half_size > native_size * 3 / 4)
+    {
+        fprintf(stderr, "half precision file size %lld not much less than %lld\n",
+            (long long) half_size, (long long) native_size);
+        nerrors++;
+    }
+
+    free(fvals);
+    free(dvals);
+    free(expected);
+
+    CleanupDriverStuff();
+    return nerrors > 0;
+}
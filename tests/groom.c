@@ -0,0 +1,265 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <math.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <silo.h>
+
+#include <std.c>
+
+#define NX 100
+#define NY 80
+#define NSPECIAL 6
+
+static off_t
+file_size(char const *filename)
+{
+    struct stat buf;
+    if (stat(filename, &buf) != 0)
+        return 0;
+    return buf.st_size;
+}
+
+static void
+write_file(char const *filename, int driver, char const *compression,
+    float *fvals, double *dvals, int *ivals)
+{
+    int i, dims[2] = {NX, NY};
+    float x[NX], y[NY];
+    void *coords[3];
+    DBfile *dbfile;
+
+    DBSetCompression(compression);
+    dbfile = DBCreate(filename, DB_CLOBBER, DB_LOCAL, "precision trimming test", driver);
+
+    for (i = 0; i < NX; i++) x[i] = i;
+    for (i = 0; i < NY; i++) y[i] = i;
+    coords[0] = x;
+    coords[1] = y;
+    coords[2] = 0;
+
+    DBPutQuadmesh(dbfile, "mesh", 0, coords, dims, 2, DB_FLOAT, DB_COLLINEAR, 0);
+    DBPutQuadvar1(dbfile, "fvar", "mesh", fvals, dims, 2, 0, 0, DB_FLOAT, DB_NODECENT, 0);
+    DBPutQuadvar1(dbfile, "dvar", "mesh", dvals, dims, 2, 0, 0, DB_DOUBLE, DB_NODECENT, 0);
+    DBPutQuadvar1(dbfile, "ivar", "mesh", ivals, dims, 2, 0, 0, DB_INT, DB_NODECENT, 0);
+
+    DBClose(dbfile);
+    DBSetCompression(0);
+}
+
+/* tol is the relative error bound of rounding to the kept mantissa bits.
+   Subnormals have fewer bits so the bound is relative to FLT_MIN there. */
+static int
+check_var(DBfile *dbfile, char const *name, void const *expected, int dtype, double tol)
+{
+    int i, nerrors = 0;
+    DBquadvar *qv = DBGetQuadvar(dbfile, name);
+
+    if (!qv)
+    {
+        fprintf(stderr, "unable to read \"%s\"\n", name);
+        return 1;
+    }
+
+    for (i = 0; i < NX*NY && nerrors < 10; i++)
+    {
+        double v, e;
+        if (dtype == DB_INT)
+        {
+            if (((int*)qv->vals[0])[i] != ((int*)expected)[i])
+            {
+                fprintf(stderr, "%s[%d]: expected %d, got %d\n", name, i,
+                    ((int*)expected)[i], ((int*)qv->vals[0])[i]);
+                nerrors++;
+            }
+            continue;
+        }
+        v = qv->datatype == DB_DOUBLE ? ((double*)qv->vals[0])[i] :
+                                        ((float*)qv->vals[0])[i];
+        e = dtype == DB_DOUBLE ? ((double*)expected)[i] : ((float*)expected)[i];
+        if (isnan(e))
+        {
+            if (!isnan(v))
+            {
+                fprintf(stderr, "%s[%d]: expected nan, got %g\n", name, i, v);
+                nerrors++;
+            }
+        }
+        else if (isinf(e))
+        {
+            if (v != e)
+            {
+                fprintf(stderr, "%s[%d]: expected %g, got %g\n", name, i, e, v);
+                nerrors++;
+            }
+        }
+        else if (fabs(v - e) > tol * (fabs(e) > FLT_MIN ? fabs(e) : FLT_MIN) || isinf(v))
+        {
+            fprintf(stderr, "%s[%d]: expected %.17g, got %.17g\n", name, i, e, v);
+            nerrors++;
+        }
+    }
+
+    DBFreeQuadvar(qv);
+    return nerrors;
+}
+
+static int
+check_file(char const *filename, float const *fvals, double const *dvals,
+    int const *ivals, double tol)
+{
+    int nerrors = 0;
+    DBfile *dbfile = DBOpen(filename, DB_UNKNOWN, DB_READ);
+    if (!dbfile)
+        return 1;
+    nerrors += check_var(dbfile, "fvar", fvals, DB_FLOAT, tol);
+    nerrors += check_var(dbfile, "dvar", dvals, DB_DOUBLE, tol);
+    nerrors += check_var(dbfile, "ivar", ivals, DB_INT, 0);
+    DBClose(dbfile);
+    return nerrors;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Test PRECISION= and DIGITS= precision trimming ahead of
+ *              GZIP compression.
+ *
+ * Return:      0 on success, 1 on failure
+ *-------------------------------------------------------------------------
+ */
+int
+main(int argc, char *argv[])
+{
+    int            i, nerrors = 0;
+    int            driver = DB_HDF5;
+    int            show_all_errors = FALSE;
+    float         *fvals;
+    double        *dvals;
+    int           *ivals;
+    double         special[NSPECIAL];
+    off_t          gzip_size, prec_size;
+
+    for (i=1; i<argc; i++) {
+        if (!strncmp(argv[i], "DB_PDB", 6)) {
+            fprintf(stderr, "This test only supported on HDF5 driver\n");
+            exit(EXIT_SUCCESS);
+        } else if (!strncmp(argv[i], "DB_HDF5", 7)) {
+            driver = StringToDriver(argv[i]);
+        } else if (!strcmp(argv[i], "show-all-errors")) {
+            show_all_errors = 1;
+        } else if (argv[i][0] != '\0') {
+            fprintf(stderr, "%s: ignored argument `%s'\n", argv[0], argv[i]);
+        }
+    }
+
+    DBShowErrors(show_all_errors?DB_ALL_AND_DRVR:DB_ABORT, NULL);
+
+    /* Checksums must be computed on the trimmed data */
+    DBSetEnableChecksums(1);
+
+    special[0] = 0.0;
+    special[1] = -1.0;
+    special[2] = FLT_MAX;       /* would round up to inf */
+    special[3] = -INFINITY;
+    special[4] = NAN;
+    special[5] = 1.0e-40;       /* float subnormal */
+
+    /* smooth field with noise in all of the low order mantissa bits */
+    srand(0xBEEF);
+    fvals = (float *) malloc(NX * NY * sizeof(float));
+    dvals = (double *) malloc(NX * NY * sizeof(double));
+    ivals = (int *) malloc(NX * NY * sizeof(int));
+    for (i = 0; i < NX*NY; i++)
+    {
+        double x = i < NSPECIAL ? special[i] :
+            1000.0 * sin(0.001 * i) * (1.0 + 1.0e-3 * rand() / RAND_MAX);
+        fvals[i] = (float) x;
+        dvals[i] = x;
+        ivals[i] = rand();
+    }
+
+    write_file("groom_gzip.h5", driver, "METHOD=GZIP", fvals, dvals, ivals);
+    write_file("groom_prec.h5", driver, "METHOD=GZIP PRECISION=10", fvals, dvals, ivals);
+    write_file("groom_digits.h5", driver, "METHOD=GZIP DIGITS=4", fvals, dvals, ivals);
+    gzip_size = file_size("groom_gzip.h5");
+    prec_size = file_size("groom_prec.h5");
+
+    nerrors += check_file("groom_gzip.h5", fvals, dvals, ivals, 0);
+
+    /* 10 bits kept */
+    nerrors += check_file("groom_prec.h5", fvals, dvals, ivals, 1.0/2048);
+
+    /* 4 digits is 14 bits kept */
+    nerrors += check_file("groom_digits.h5", fvals, dvals, ivals, 1.0/32768);
+
+    /* integer data is incompressible so expect a modest reduction */
+    if (prec_size > gzip_size * 4 / 5)
+    {
+        fprintf(stderr, "trimmed file size %lld not much less than %lld\n",
+            (long long) prec_size, (long long) gzip_size);
+        nerrors++;
+    }
+
+    free(fvals);
+    free(dvals);
+    free(ivals);
+
+    CleanupDriverStuff();
+    return nerrors > 0;
+}
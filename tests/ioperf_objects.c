@@ -0,0 +1,738 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <math.h>
+#include <stdio.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <sys/time.h>
+#else
+#include <time.h>
+#endif
+
+#include <silo.h>
+
+#include <std.c>
+
+/*
+ * Object-level companion to ioperf. Where ioperf times streams of equal
+ * size raw requests through its plugins, this writes and reads back
+ * synthetic workloads made of the heterogeneous objects real Silo files
+ * hold and reports, per phase and per Silo call, throughput and latency
+ * percentiles as JSON.
+ *
+ * Workloads (--workload, may be repeated, default all)
+ *   multiblock  --blocks N domains, each a directory holding a hex ucd
+ *               mesh of --zones N^3 zones, its zonelist, a material and
+ *               three variables, plus multi-block objects at the root
+ *   dirtree     a directory tree --fanout F wide and --depth D deep with
+ *               a small array and a curve in every directory
+ *   multimesh   a root with a multimesh and a multivar of --mblocks N
+ *               blocks (default 100000)
+ *
+ * Read-back patterns (--read, may be repeated, default all)
+ *   full        every object
+ *   partial     the root objects and one variable of every 4th block
+ *   toc         the table of contents of every directory, no objects
+ *
+ * The driver (DB_PDB, DB_HDF5, DB_HDF5_SEC2, DB_HDF5_OPTS(...), ...) and
+ * a compression string (--compression "METHOD=GZIP LEVEL=1") select the
+ * configuration. ioperf_objects_tests sweeps them.
+ */
+
+/* Latency samples of one Silo call */
+typedef struct op_t {
+    char const *name;
+    int n, max;
+    double *us;
+} op_t;
+
+#define MAX_OPS 32
+static op_t ops[MAX_OPS];
+static int nops = 0;
+
+static int nzones = 10, nblocks = 8, depth = 3, fanout = 4, nmblocks = 100000;
+static FILE *out;
+static int nphases = 0;
+
+/* Microseconds; std.c's GetTime needs config.h, which tests do not see */
+static double
+now_us(void)
+{
+#ifndef _WIN32
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return (double) tv.tv_sec * 1e+6 + (double) tv.tv_usec;
+#else
+    return (double) clock() * 1e+6 / CLOCKS_PER_SEC;
+#endif
+}
+
+static void
+add_sample(char const *name, double us)
+{
+    int i;
+    for (i = 0; i < nops; i++)
+        if (!strcmp(ops[i].name, name))
+            break;
+    if (i == nops)
+    {
+        if (nops == MAX_OPS) return;
+        ops[nops].name = name;
+        ops[nops].n = ops[nops].max = 0;
+        ops[nops].us = 0;
+        nops++;
+    }
+    if (ops[i].n == ops[i].max)
+    {
+        ops[i].max = ops[i].max ? 2 * ops[i].max : 64;
+        ops[i].us = (double *) realloc(ops[i].us, ops[i].max * sizeof(double));
+    }
+    ops[i].us[ops[i].n++] = us;
+}
+
+/* Time CALL and record its latency under the name of the Silo call */
+#define TIMED(NAME, CALL)                                                   \
+{                                                                           \
+    double _t0 = now_us();                                                 \
+    CALL;                                                                   \
+    add_sample(NAME, now_us() - _t0);                                      \
+}
+
+static int
+cmp_double(void const *a, void const *b)
+{
+    double x = *(double const *) a, y = *(double const *) b;
+    return x < y ? -1 : x > y;
+}
+
+/* Nearest-rank percentile of sorted samples */
+static double
+percentile(op_t const *op, double q)
+{
+    int i = (int) ceil(q * op->n) - 1;
+    return op->us[i < 0 ? 0 : i];
+}
+
+/* Start a phase; its samples are those recorded until end_phase */
+static double
+begin_phase(void)
+{
+    int i;
+    for (i = 0; i < nops; i++)
+        free(ops[i].us);
+    nops = 0;
+    return now_us();
+}
+
+/* Emit the JSON record of a phase. STATS are those of the file just
+   before it was closed and supply the bytes moved by each call. */
+static void
+end_phase(char const *workload, char const *phase, double t0,
+    DBfilestats const *stats)
+{
+    double seconds = (now_us() - t0) * 1e-6;
+    long long bytes = 0, nobjs = 0;
+    int i, j;
+
+    if (stats)
+        bytes = stats->total.bytes_read + stats->total.bytes_written;
+    for (i = 0; i < nops; i++)
+        nobjs += ops[i].n;
+
+    fprintf(out, "%s    {\"workload\":\"%s\",\"phase\":\"%s\",\"seconds\":%.6f,"
+        "\"bytes\":%lld,\"MBps\":%.3f,\"calls\":%lld,\"calls_per_sec\":%.1f,\"ops\":[",
+        nphases++ ? ",\n" : "", workload, phase, seconds, bytes,
+        seconds > 0 ? bytes / seconds / (1<<20) : 0.0, nobjs,
+        seconds > 0 ? nobjs / seconds : 0.0);
+    for (i = 0; i < nops; i++)
+    {
+        op_t *op = &ops[i];
+        long long opbytes = 0;
+        double sum = 0;
+
+        if (stats)
+        {
+            for (j = 0; j < stats->ncalls; j++)
+            {
+                if (!strcmp(stats->calls[j].name, op->name))
+                {
+                    opbytes = stats->calls[j].bytes_read + stats->calls[j].bytes_written;
+                    break;
+                }
+            }
+        }
+        qsort(op->us, op->n, sizeof(double), cmp_double);
+        for (j = 0; j < op->n; j++)
+            sum += op->us[j];
+        fprintf(out, "%s\n      {\"name\":\"%s\",\"count\":%d,\"bytes\":%lld,\"MBps\":%.3f,"
+            "\"mean_us\":%.1f,\"p50_us\":%.1f,\"p90_us\":%.1f,\"p99_us\":%.1f,\"max_us\":%.1f}",
+            i ? "," : "", op->name, op->n, opbytes,
+            sum > 0 ? opbytes / (sum * 1e-6) / (1<<20) : 0.0, sum / op->n,
+            percentile(op, 0.5), percentile(op, 0.9), percentile(op, 0.99),
+            op->us[op->n-1]);
+    }
+    fprintf(out, "]}");
+}
+
+/* Close DBFILE as the last call of a phase */
+static void
+close_phase(DBfile *dbfile, char const *workload, char const *phase, double t0)
+{
+    DBfilestats *stats = DBGetFileStats(dbfile);
+    TIMED("DBClose", DBClose(dbfile));
+    end_phase(workload, phase, t0, stats);
+    DBFreeFileStats(stats);
+}
+
+static DBfile *
+create_file(char const *filename, int driver)
+{
+    DBfile *dbfile = DBCreate(filename, DB_CLOBBER, DB_LOCAL, "ioperf_objects", driver);
+    if (!dbfile)
+    {
+        fprintf(stderr, "unable to create \"%s\"\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    return dbfile;
+}
+
+static void
+check_toc(DBtoc const *toc)
+{
+    if (!toc)
+    {
+        fprintf(stderr, "unable to get table of contents\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static DBfile *
+open_file(char const *filename)
+{
+    DBfile *dbfile = DBOpen(filename, DB_UNKNOWN, DB_READ);
+    if (!dbfile)
+    {
+        fprintf(stderr, "unable to open \"%s\"\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    return dbfile;
+}
+
+/*-------------------------------------------------------------------------
+ * multiblock workload
+ *-------------------------------------------------------------------------
+ */
+static void
+write_multiblock(char const *filename, int driver)
+{
+    int nn = nzones + 1, nnodes = nn * nn * nn, nz = nzones * nzones * nzones;
+    int shapetype = DB_ZONETYPE_HEX, shapesize = 8, shapecnt = nz;
+    int matnos[3] = {1, 2, 3};
+    int i, j, k, b, dims[1];
+    float *x = (float *) malloc(nnodes * sizeof(float));
+    float *y = (float *) malloc(nnodes * sizeof(float));
+    float *z = (float *) malloc(nnodes * sizeof(float));
+    float *v = (float *) malloc(nnodes * sizeof(float));
+    double *p = (double *) malloc(nz * sizeof(double));
+    double *d = (double *) malloc(nz * sizeof(double));
+    int *nodelist = (int *) malloc(8 * nz * sizeof(int));
+    int *matlist = (int *) malloc(nz * sizeof(int));
+    char **names[5], dirname[64];
+    int *types[5];
+    char const *objs[5] = {"mesh", "p", "d", "v", "mat"};
+    void *coords[3];
+    double t0;
+    DBfile *dbfile;
+
+    for (k = 0; k < nzones; k++)
+    for (j = 0; j < nzones; j++)
+    for (i = 0; i < nzones; i++)
+    {
+        int zi = (k * nzones + j) * nzones + i, n0 = (k * nn + j) * nn + i;
+        nodelist[8*zi+0] = n0;
+        nodelist[8*zi+1] = n0 + 1;
+        nodelist[8*zi+2] = n0 + nn + 1;
+        nodelist[8*zi+3] = n0 + nn;
+        nodelist[8*zi+4] = n0 + nn*nn;
+        nodelist[8*zi+5] = n0 + nn*nn + 1;
+        nodelist[8*zi+6] = n0 + nn*nn + nn + 1;
+        nodelist[8*zi+7] = n0 + nn*nn + nn;
+        matlist[zi] = 1 + (i * 3) / nzones;
+    }
+    for (i = 0; i < 5; i++)
+    {
+        names[i] = (char **) malloc(nblocks * sizeof(char *));
+        types[i] = (int *) malloc(nblocks * sizeof(int));
+    }
+    coords[0] = x; coords[1] = y; coords[2] = z;
+
+    t0 = begin_phase();
+    dbfile = create_file(filename, driver);
+    for (b = 0; b < nblocks; b++)
+    {
+        for (k = 0; k < nn; k++)
+        for (j = 0; j < nn; j++)
+        for (i = 0; i < nn; i++)
+        {
+            int ni = (k * nn + j) * nn + i;
+            x[ni] = b * nzones + i;
+            y[ni] = j;
+            z[ni] = k;
+            v[ni] = sin(0.1 * x[ni]) * cos(0.1 * (y[ni] + z[ni]));
+        }
+        for (i = 0; i < nz; i++)
+        {
+            p[i] = 1e5 * (1 + 0.01 * ((b + i) % 97));
+            d[i] = 1 + 0.5 * matlist[i] + 1e-3 * i;
+        }
+
+        sprintf(dirname, "domain_%06d", b);
+        TIMED("DBMkDir", DBMkDir(dbfile, dirname));
+        TIMED("DBSetDir", DBSetDir(dbfile, dirname));
+        TIMED("DBPutZonelist2", DBPutZonelist2(dbfile, "zl", nz, 3, nodelist, 8*nz,
+            0, 0, 0, &shapetype, &shapesize, &shapecnt, 1, 0));
+        TIMED("DBPutUcdmesh", DBPutUcdmesh(dbfile, "mesh", 3, 0, coords, nnodes, nz,
+            "zl", 0, DB_FLOAT, 0));
+        dims[0] = nz;
+        TIMED("DBPutMaterial", DBPutMaterial(dbfile, "mat", "mesh", 3, matnos, matlist,
+            dims, 1, 0, 0, 0, 0, 0, DB_FLOAT, 0));
+        TIMED("DBPutUcdvar1", DBPutUcdvar1(dbfile, "p", "mesh", p, nz, 0, 0,
+            DB_DOUBLE, DB_ZONECENT, 0));
+        TIMED("DBPutUcdvar1", DBPutUcdvar1(dbfile, "d", "mesh", d, nz, 0, 0,
+            DB_DOUBLE, DB_ZONECENT, 0));
+        TIMED("DBPutUcdvar1", DBPutUcdvar1(dbfile, "v", "mesh", v, nnodes, 0, 0,
+            DB_FLOAT, DB_NODECENT, 0));
+        TIMED("DBSetDir", DBSetDir(dbfile, ".."));
+
+        for (i = 0; i < 5; i++)
+        {
+            char name[128];
+            sprintf(name, "%s/%s", dirname, objs[i]);
+            names[i][b] = strdup(name);
+            types[i][b] = i == 0 ? DB_UCDMESH : DB_UCDVAR;
+        }
+    }
+    TIMED("DBPutMultimesh", DBPutMultimesh(dbfile, "mesh", nblocks,
+        (char const * const *) names[0], types[0], 0));
+    for (i = 1; i < 4; i++)
+        TIMED("DBPutMultivar", DBPutMultivar(dbfile, objs[i], nblocks,
+            (char const * const *) names[i], types[i], 0));
+    TIMED("DBPutMultimat", DBPutMultimat(dbfile, "mat", nblocks,
+        (char const * const *) names[4], 0));
+    close_phase(dbfile, "multiblock", "write", t0);
+
+    for (i = 0; i < 5; i++)
+    {
+        for (b = 0; b < nblocks; b++)
+            free(names[i][b]);
+        free(names[i]);
+        free(types[i]);
+    }
+    free(x); free(y); free(z); free(v); free(p); free(d);
+    free(nodelist); free(matlist);
+}
+
+static void
+read_multiblock(char const *filename, char const *pattern)
+{
+    DBfile *dbfile;
+    DBtoc *toc;
+    DBmultimesh *mm = 0;
+    DBmultivar *mv = 0;
+    DBmultimat *mmat = 0;
+    DBucdmesh *um;
+    DBucdvar *uv;
+    DBmaterial *mat;
+    char dirname[64];
+    double t0;
+    int b, i;
+
+    t0 = begin_phase();
+    dbfile = open_file(filename);
+    if (!strcmp(pattern, "toc"))
+    {
+        TIMED("DBGetToc", toc = DBGetToc(dbfile));
+        check_toc(toc);
+        for (b = 0; b < nblocks; b++)
+        {
+            sprintf(dirname, "domain_%06d", b);
+            TIMED("DBSetDir", DBSetDir(dbfile, dirname));
+            TIMED("DBGetToc", toc = DBGetToc(dbfile));
+            check_toc(toc);
+            TIMED("DBSetDir", DBSetDir(dbfile, ".."));
+        }
+    }
+    else
+    {
+        TIMED("DBGetMultimesh", mm = DBGetMultimesh(dbfile, "mesh"));
+        TIMED("DBGetMultivar", mv = DBGetMultivar(dbfile, "p"));
+        DBFreeMultivar(mv);
+        if (!strcmp(pattern, "full"))
+        {
+            TIMED("DBGetMultivar", mv = DBGetMultivar(dbfile, "d"));
+            DBFreeMultivar(mv);
+            TIMED("DBGetMultivar", mv = DBGetMultivar(dbfile, "v"));
+            DBFreeMultivar(mv);
+            TIMED("DBGetMultimat", mmat = DBGetMultimat(dbfile, "mat"));
+            DBFreeMultimat(mmat);
+        }
+        for (b = 0; b < nblocks; b++)
+        {
+            if (!strcmp(pattern, "partial"))
+            {
+                if (b % 4) continue;
+                sprintf(dirname, "domain_%06d/p", b);
+                TIMED("DBGetUcdvar", uv = DBGetUcdvar(dbfile, dirname));
+                DBFreeUcdvar(uv);
+                continue;
+            }
+            sprintf(dirname, "domain_%06d", b);
+            TIMED("DBSetDir", DBSetDir(dbfile, dirname));
+            TIMED("DBGetUcdmesh", um = DBGetUcdmesh(dbfile, "mesh"));
+            DBFreeUcdmesh(um);
+            TIMED("DBGetMaterial", mat = DBGetMaterial(dbfile, "mat"));
+            DBFreeMaterial(mat);
+            for (i = 1; i < 4; i++)
+            {
+                char const *vnames[] = {0, "p", "d", "v"};
+                TIMED("DBGetUcdvar", uv = DBGetUcdvar(dbfile, vnames[i]));
+                DBFreeUcdvar(uv);
+            }
+            TIMED("DBSetDir", DBSetDir(dbfile, ".."));
+        }
+        DBFreeMultimesh(mm);
+    }
+    close_phase(dbfile, "multiblock", pattern, t0);
+}
+
+/*-------------------------------------------------------------------------
+ * dirtree workload
+ *-------------------------------------------------------------------------
+ */
+#define DIRTREE_NVALS 64
+
+static void
+write_dirtree_level(DBfile *dbfile, int level)
+{
+    double vals[DIRTREE_NVALS], xc[DIRTREE_NVALS/2], yc[DIRTREE_NVALS/2];
+    int i, dims[1] = {DIRTREE_NVALS};
+    char dirname[32];
+
+    for (i = 0; i < DIRTREE_NVALS; i++)
+        vals[i] = level + 0.01 * i;
+    for (i = 0; i < DIRTREE_NVALS/2; i++)
+    {
+        xc[i] = i;
+        yc[i] = level * sin(0.2 * i);
+    }
+    TIMED("DBWrite", DBWrite(dbfile, "vals", vals, dims, 1, DB_DOUBLE));
+    TIMED("DBPutCurve", DBPutCurve(dbfile, "curve", xc, yc, DB_DOUBLE, DIRTREE_NVALS/2, 0));
+    if (level == depth)
+        return;
+    for (i = 0; i < fanout; i++)
+    {
+        sprintf(dirname, "dir_%d", i);
+        TIMED("DBMkDir", DBMkDir(dbfile, dirname));
+        TIMED("DBSetDir", DBSetDir(dbfile, dirname));
+        write_dirtree_level(dbfile, level + 1);
+        TIMED("DBSetDir", DBSetDir(dbfile, ".."));
+    }
+}
+
+static void
+read_dirtree_level(DBfile *dbfile, char const *pattern, int level, int *ndirs)
+{
+    double vals[DIRTREE_NVALS];
+    DBtoc *toc;
+    DBcurve *c;
+    char dirname[32];
+    int i;
+
+    if (!strcmp(pattern, "toc"))
+    {
+        TIMED("DBGetToc", toc = DBGetToc(dbfile));
+        check_toc(toc);
+    }
+    else if (!strcmp(pattern, "full") || (*ndirs)++ % 2 == 0)
+    {
+        TIMED("DBReadVar", DBReadVar(dbfile, "vals", vals));
+        if (!strcmp(pattern, "full"))
+        {
+            TIMED("DBGetCurve", c = DBGetCurve(dbfile, "curve"));
+            DBFreeCurve(c);
+        }
+    }
+    if (level == depth)
+        return;
+    for (i = 0; i < fanout; i++)
+    {
+        sprintf(dirname, "dir_%d", i);
+        TIMED("DBSetDir", DBSetDir(dbfile, dirname));
+        read_dirtree_level(dbfile, pattern, level + 1, ndirs);
+        TIMED("DBSetDir", DBSetDir(dbfile, ".."));
+    }
+}
+
+static void
+write_dirtree(char const *filename, int driver)
+{
+    double t0 = begin_phase();
+    DBfile *dbfile = create_file(filename, driver);
+    write_dirtree_level(dbfile, 0);
+    close_phase(dbfile, "dirtree", "write", t0);
+}
+
+static void
+read_dirtree(char const *filename, char const *pattern)
+{
+    int ndirs = 0;
+    double t0 = begin_phase();
+    DBfile *dbfile = open_file(filename);
+    read_dirtree_level(dbfile, pattern, 0, &ndirs);
+    close_phase(dbfile, "dirtree", pattern, t0);
+}
+
+/*-------------------------------------------------------------------------
+ * multimesh workload
+ *-------------------------------------------------------------------------
+ */
+static void
+write_multimesh(char const *filename, int driver)
+{
+    char **mnames = (char **) malloc(nmblocks * sizeof(char *));
+    char **vnames = (char **) malloc(nmblocks * sizeof(char *));
+    int *mtypes = (int *) malloc(nmblocks * sizeof(int));
+    int *vtypes = (int *) malloc(nmblocks * sizeof(int));
+    DBfile *dbfile;
+    double t0;
+    int i;
+
+    for (i = 0; i < nmblocks; i++)
+    {
+        char name[64];
+        sprintf(name, "data_%04d.silo:/domain_%06d/mesh", i / 1000, i);
+        mnames[i] = strdup(name);
+        sprintf(name, "data_%04d.silo:/domain_%06d/p", i / 1000, i);
+        vnames[i] = strdup(name);
+        mtypes[i] = DB_UCDMESH;
+        vtypes[i] = DB_UCDVAR;
+    }
+
+    t0 = begin_phase();
+    dbfile = create_file(filename, driver);
+    TIMED("DBPutMultimesh", DBPutMultimesh(dbfile, "mesh", nmblocks,
+        (char const * const *) mnames, mtypes, 0));
+    TIMED("DBPutMultivar", DBPutMultivar(dbfile, "p", nmblocks,
+        (char const * const *) vnames, vtypes, 0));
+    close_phase(dbfile, "multimesh", "write", t0);
+
+    for (i = 0; i < nmblocks; i++)
+    {
+        free(mnames[i]);
+        free(vnames[i]);
+    }
+    free(mnames); free(vnames); free(mtypes); free(vtypes);
+}
+
+static void
+read_multimesh(char const *filename, char const *pattern)
+{
+    DBmultimesh *mm;
+    DBmultivar *mv;
+    DBtoc *toc;
+    double t0 = begin_phase();
+    DBfile *dbfile = open_file(filename);
+
+    if (!strcmp(pattern, "toc"))
+    {
+        TIMED("DBGetToc", toc = DBGetToc(dbfile));
+        check_toc(toc);
+    }
+    else
+    {
+        TIMED("DBGetMultimesh", mm = DBGetMultimesh(dbfile, "mesh"));
+        DBFreeMultimesh(mm);
+        if (!strcmp(pattern, "full"))
+        {
+            TIMED("DBGetMultivar", mv = DBGetMultivar(dbfile, "p"));
+            DBFreeMultivar(mv);
+        }
+    }
+    close_phase(dbfile, "multimesh", pattern, t0);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Write and read back synthetic object-level workloads and
+ *              report their throughput and latency percentiles as JSON.
+ *
+ * Return:      0 on success, 1 on failure
+ *-------------------------------------------------------------------------
+ */
+int
+main(int argc, char *argv[])
+{
+    int            i, j, driver = DB_HDF5;
+    int            show_all_errors = FALSE;
+    char const    *drivername = "DB_HDF5";
+    char const    *compression = "";
+    char const    *outname = 0;
+    char const    *allworkloads[] = {"multiblock", "dirtree", "multimesh"};
+    char const    *allreads[] = {"full", "partial", "toc"};
+    char const    *workloads[3], *reads[3];
+    int            nworkloads = 0, nreads = 0;
+
+    for (i=1; i<argc; i++) {
+        if (!strncmp(argv[i], "DB_", 3)) {
+            driver = StringToDriver(argv[i]);
+            drivername = argv[i];
+        } else if (!strcmp(argv[i], "--workload") && i+1 < argc && nworkloads < 3) {
+            workloads[nworkloads++] = argv[++i];
+        } else if (!strcmp(argv[i], "--read") && i+1 < argc && nreads < 3) {
+            reads[nreads++] = argv[++i];
+        } else if (!strcmp(argv[i], "--blocks") && i+1 < argc) {
+            nblocks = (int) strtol(argv[++i], 0, 10);
+        } else if (!strcmp(argv[i], "--zones") && i+1 < argc) {
+            nzones = (int) strtol(argv[++i], 0, 10);
+        } else if (!strcmp(argv[i], "--depth") && i+1 < argc) {
+            depth = (int) strtol(argv[++i], 0, 10);
+        } else if (!strcmp(argv[i], "--fanout") && i+1 < argc) {
+            fanout = (int) strtol(argv[++i], 0, 10);
+        } else if (!strcmp(argv[i], "--mblocks") && i+1 < argc) {
+            nmblocks = (int) strtol(argv[++i], 0, 10);
+        } else if (!strcmp(argv[i], "--compression") && i+1 < argc) {
+            compression = argv[++i];
+        } else if (!strcmp(argv[i], "--output") && i+1 < argc) {
+            outname = argv[++i];
+        } else if (!strcmp(argv[i], "show-all-errors")) {
+            show_all_errors = 1;
+        } else if (argv[i][0] != '\0') {
+            fprintf(stderr, "%s: ignored argument `%s'\n", argv[0], argv[i]);
+        }
+    }
+    if (nblocks < 1 || nzones < 1 || depth < 0 || fanout < 1 || nmblocks < 1)
+    {
+        fprintf(stderr, "%s: bad workload size\n", argv[0]);
+        return 1;
+    }
+    if (!nworkloads)
+        for (; nworkloads < 3; nworkloads++)
+            workloads[nworkloads] = allworkloads[nworkloads];
+    if (!nreads)
+        for (; nreads < 3; nreads++)
+            reads[nreads] = allreads[nreads];
+
+    DBShowErrors(show_all_errors?DB_ALL_AND_DRVR:DB_ALL, NULL);
+    if (compression[0])
+        DBSetCompression(compression);
+
+    if (!outname)
+        out = stdout;
+    else if (!(out = fopen(outname, "w")))
+    {
+        fprintf(stderr, "%s: unable to open \"%s\"\n", argv[0], outname);
+        return 1;
+    }
+    fprintf(out, "{\"driver\":\"%s\",\"compression\":\"%s\",\"blocks\":%d,\"zones\":%d,"
+        "\"depth\":%d,\"fanout\":%d,\"mblocks\":%d,\"phases\":[\n",
+        drivername, compression, nblocks, nzones, depth, fanout, nmblocks);
+    for (i = 0; i < nworkloads; i++)
+    {
+        char filename[64];
+        int pdb = (driver & 0xF) == DB_PDB || (driver & 0xF) == DB_PDBP;
+
+        sprintf(filename, "ioperf_objects_%s.%s", workloads[i], pdb ? "pdb" : "h5");
+        for (j = 0; j < nreads; j++)
+        {
+            if (strcmp(reads[j], "full") && strcmp(reads[j], "partial") &&
+                strcmp(reads[j], "toc"))
+            {
+                fprintf(stderr, "%s: unknown read pattern `%s'\n", argv[0], reads[j]);
+                return 1;
+            }
+        }
+        if (!strcmp(workloads[i], "multiblock"))
+        {
+            write_multiblock(filename, driver);
+            for (j = 0; j < nreads; j++)
+                read_multiblock(filename, reads[j]);
+        }
+        else if (!strcmp(workloads[i], "dirtree"))
+        {
+            write_dirtree(filename, driver);
+            for (j = 0; j < nreads; j++)
+                read_dirtree(filename, reads[j]);
+        }
+        else if (!strcmp(workloads[i], "multimesh"))
+        {
+            write_multimesh(filename, driver);
+            for (j = 0; j < nreads; j++)
+                read_multimesh(filename, reads[j]);
+        }
+        else
+        {
+            fprintf(stderr, "%s: unknown workload `%s'\n", argv[0], workloads[i]);
+            return 1;
+        }
+    }
+    fprintf(out, "\n]}\n");
+    if (out != stdout)
+        fclose(out);
+
+    begin_phase(); /* releases the last latency samples */
+    CleanupDriverStuff();
+    return 0;
+}
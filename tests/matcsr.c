@@ -0,0 +1,281 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <silo.h>
+
+#include <std.c>
+
+#define NX 40
+#define NY 30
+#define NMAT 4
+
+static unsigned int seed = 8765;
+
+static int
+irand(int n)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (int) ((seed >> 8) % (unsigned int) n);
+}
+
+/* Compare a CSR material against the expected CSR arrays */
+static int
+check_csr(char const *what, DBmaterialcsr const *csr, int const *offsets,
+    int const *matids, double const *vf)
+{
+    int i;
+
+    if (!csr)
+    {
+        fprintf(stderr, "%s: no CSR material\n", what);
+        return 1;
+    }
+    if (csr->nzones != NX*NY || csr->nmat != NMAT || csr->datatype != DB_DOUBLE)
+    {
+        fprintf(stderr, "%s: wrong nzones, nmat or datatype\n", what);
+        return 1;
+    }
+    for (i = 0; i <= NX*NY; i++)
+    {
+        if (csr->offsets[i] != offsets[i])
+        {
+            fprintf(stderr, "%s: offsets[%d] is %d, expected %d\n", what, i,
+                csr->offsets[i], offsets[i]);
+            return 1;
+        }
+    }
+    for (i = 0; i < offsets[NX*NY]; i++)
+    {
+        if (csr->matids[i] != matids[i] || ((double *) csr->vf)[i] != vf[i])
+        {
+            fprintf(stderr, "%s: entry %d is (%d,%g), expected (%d,%g)\n", what,
+                i, csr->matids[i], ((double *) csr->vf)[i], matids[i], vf[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Walk the mix_next chains of MAT and compare them against the CSR arrays */
+static int
+check_lists(DBmaterial const *mat, int const *offsets, int const *matids,
+    double const *vf)
+{
+    int i, k, mix_idx;
+
+    for (i = 0; i < NX*NY; i++)
+    {
+        int n = offsets[i+1] - offsets[i];
+        if (n == 1)
+        {
+            if (mat->matlist[i] != matids[offsets[i]])
+            {
+                fprintf(stderr, "zone %d: matlist is %d, expected %d\n", i,
+                    mat->matlist[i], matids[offsets[i]]);
+                return 1;
+            }
+            continue;
+        }
+        if (mat->matlist[i] >= 0)
+        {
+            fprintf(stderr, "zone %d: expected a mixed zone\n", i);
+            return 1;
+        }
+        k = offsets[i];
+        for (mix_idx = -mat->matlist[i]-1; mix_idx >= 0; mix_idx = mat->mix_next[mix_idx]-1, k++)
+        {
+            if (k == offsets[i+1] || mat->mix_mat[mix_idx] != matids[k] ||
+                ((double *) mat->mix_vf)[mix_idx] != vf[k] ||
+                mat->mix_zone[mix_idx] != i+1)
+            {
+                fprintf(stderr, "zone %d: mix entry %d does not match\n", i, mix_idx);
+                return 1;
+            }
+        }
+        if (k != offsets[i+1])
+        {
+            fprintf(stderr, "zone %d: chain too short\n", i);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Round trip random material data through DBPutMaterialCSR,
+ *              DBGetMaterial and DBGetMaterialCSR, and convert a material
+ *              whose mix chains are interleaved to CSR.
+ *
+ * Return:      0 on success, 1 on failure
+ *-------------------------------------------------------------------------
+ */
+int
+main(int argc, char *argv[])
+{
+    int            i, nerrors = 0;
+    int            driver = DB_PDB;
+    int            show_all_errors = FALSE;
+    char          *filename = "matcsr.pdb";
+    int            dims[2] = {NX, NY};
+    int            matnos[NMAT] = {1, 2, 5, 7};
+    int            offsets[NX*NY+1], *matids;
+    double        *vf;
+    DBmaterial    *mat;
+    DBmaterialcsr *csr;
+    DBfile        *dbfile;
+
+    for (i=1; i<argc; i++) {
+        if (!strncmp(argv[i], "DB_PDB", 6)) {
+            driver = StringToDriver(argv[i]);
+            filename = "matcsr.pdb";
+        } else if (!strncmp(argv[i], "DB_HDF5", 7)) {
+            driver = StringToDriver(argv[i]);
+            filename = "matcsr.h5";
+        } else if (!strcmp(argv[i], "show-all-errors")) {
+            show_all_errors = 1;
+        } else if (argv[i][0] != '\0') {
+            fprintf(stderr, "%s: ignored argument `%s'\n", argv[0], argv[i]);
+        }
+    }
+
+    DBShowErrors(show_all_errors?DB_ALL_AND_DRVR:DB_ABORT, NULL);
+
+    /* Zones have 1 to NMAT distinct materials with fractions summing to 1 */
+    matids = (int *) malloc(NX*NY*NMAT * sizeof(int));
+    vf = (double *) malloc(NX*NY*NMAT * sizeof(double));
+    offsets[0] = 0;
+    for (i = 0; i < NX*NY; i++)
+    {
+        int k, n = irand(3) ? 1 : 2 + irand(NMAT-1), first = irand(NMAT);
+        for (k = 0; k < n; k++)
+        {
+            matids[offsets[i]+k] = matnos[(first + k) % NMAT];
+            vf[offsets[i]+k] = n == 1 ? 1.0 : (k < n-1 ? 1.0 / (1 << (k+1)) : 1.0 / (1 << k));
+        }
+        offsets[i+1] = offsets[i] + n;
+    }
+
+    dbfile = DBCreate(filename, DB_CLOBBER, DB_LOCAL, "CSR material test", driver);
+    DBPutMaterialCSR(dbfile, "mat", "mesh", NMAT, matnos, offsets, matids, vf,
+        dims, 2, DB_DOUBLE, NULL);
+    DBClose(dbfile);
+
+    dbfile = DBOpen(filename, DB_UNKNOWN, DB_READ);
+    mat = DBGetMaterial(dbfile, "mat");
+    nerrors += check_lists(mat, offsets, matids, vf);
+    DBFreeMaterial(mat);
+    csr = DBGetMaterialCSR(dbfile, "mat");
+    nerrors += check_csr("DBGetMaterialCSR", csr, offsets, matids, vf);
+    DBFreeMaterialCSR(csr);
+    DBClose(dbfile);
+
+    /* Chains that are interleaved in the mix arrays, as a simulation code
+       that appends entries as materials move would write them. Zones 0 and
+       2 are mixed, zone 1 is clean and zone 3 is the rest of the mesh. */
+    {
+        int      zdims[1] = {4};
+        int      ml[4] = {-1, 2, -2, 1};
+        int      nxt[5] = {3, 4, 5, 0, 0};
+        int      mm[5] = {1, 2, 5, 7, 7};
+        int      mz[5] = {1, 3, 1, 3, 1};
+        double   mvf[5] = {0.5, 0.25, 0.25, 0.75, 0.25};
+        int      xoff[5] = {0, 3, 4, 6, 7};
+        int      xids[7] = {1, 5, 7, 2, 2, 7, 1};
+        double   xvf[7] = {0.5, 0.25, 0.25, 1, 0.25, 0.75, 1};
+
+        mat = DBAllocMaterial();
+        mat->ndims = 1;
+        mat->dims[0] = zdims[0];
+        mat->nmat = NMAT;
+        mat->matnos = matnos;
+        mat->matlist = ml;
+        mat->mixlen = 5;
+        mat->datatype = DB_DOUBLE;
+        mat->mix_vf = mvf;
+        mat->mix_next = nxt;
+        mat->mix_mat = mm;
+        mat->mix_zone = mz;
+        csr = DBCalcMaterialCSRFromMaterial(mat);
+        for (i = 0; csr && i < 7; i++)
+        {
+            if (csr->matids[i] != xids[i] || ((double *) csr->vf)[i] != xvf[i])
+            {
+                fprintf(stderr, "interleaved: entry %d does not match\n", i);
+                nerrors++;
+                break;
+            }
+        }
+        for (i = 0; csr && i < 5; i++)
+        {
+            if (csr->offsets[i] != xoff[i])
+            {
+                fprintf(stderr, "interleaved: offsets[%d] does not match\n", i);
+                nerrors++;
+                break;
+            }
+        }
+        if (!csr) nerrors++;
+        DBFreeMaterialCSR(csr);
+        free(mat);
+    }
+
+    free(matids);
+    free(vf);
+
+    CleanupDriverStuff();
+    return nerrors > 0;
+}
@@ -0,0 +1,276 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <silo.h>
+
+#include <std.c>
+
+#define NBLOCKS 300
+#define NX 8
+#define NY 6
+#define NQUERIES 500
+
+static unsigned int seed = 4321;
+
+static double
+urand(double lo, double hi)
+{
+    seed = seed * 1103515245u + 12345u;
+    return lo + (hi - lo) * ((seed >> 8) & 0xFFFF) / 65535.0;
+}
+
+/* Compare DBQueryMultivarBlocks against a brute force search of RANGES */
+static int
+check_query(DBfile *dbfile, char const *name, double lo, double hi,
+    double const *ranges, char const * const *names)
+{
+    int i, n, nexp = 0, nerrors = 0;
+    int *blocks = NULL;
+
+    n = DBQueryMultivarBlocks(dbfile, name, lo, hi, &blocks);
+    for (i = 0; i < NBLOCKS; i++)
+    {
+        if (!strcmp(names[i], "EMPTY"))
+            continue;
+        if (ranges && (hi < ranges[2*i] || lo > ranges[2*i+1]))
+            continue;
+        if (nexp >= n || blocks[nexp] != i)
+        {
+            fprintf(stderr, "%s: [%g,%g]: block %d expected\n", name, lo, hi, i);
+            nerrors++;
+            break;
+        }
+        nexp++;
+    }
+    if (!nerrors && n != nexp)
+    {
+        fprintf(stderr, "%s: [%g,%g]: got %d blocks, expected %d\n", name, lo, hi, n, nexp);
+        nerrors++;
+    }
+    free(blocks);
+    return nerrors;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Test DBQueryMultivarBlocks against a brute force search of
+ *              the block value ranges, both for ranges DBPutMultivar
+ *              gathers from the blocks and for ranges given by the caller.
+ *
+ * Return:      0 on success, 1 on failure
+ *-------------------------------------------------------------------------
+ */
+int
+main(int argc, char *argv[])
+{
+    int            i, j, nerrors = 0;
+    int            driver = DB_PDB;
+    int            show_all_errors = FALSE;
+    char          *filename = "mvquery.pdb";
+    int            dims[2] = {NX, NY}, extsize = 4, one = 1;
+    int           *types;
+    char         **names, **foreign;
+    double        *ranges, *extents, *hull;
+    float          x[NX], y[NY], v[NX*NY];
+    float         *coords[2];
+    DBoptlist     *ol;
+    DBfile        *dbfile;
+
+    for (i=1; i<argc; i++) {
+        if (!strncmp(argv[i], "DB_PDB", 6)) {
+            driver = StringToDriver(argv[i]);
+            filename = "mvquery.pdb";
+        } else if (!strncmp(argv[i], "DB_HDF5", 7)) {
+            driver = StringToDriver(argv[i]);
+            filename = "mvquery.h5";
+        } else if (!strcmp(argv[i], "show-all-errors")) {
+            show_all_errors = 1;
+        } else if (argv[i][0] != '\0') {
+            fprintf(stderr, "%s: ignored argument `%s'\n", argv[0], argv[i]);
+        }
+    }
+
+    DBShowErrors(show_all_errors?DB_ALL_AND_DRVR:DB_ABORT, NULL);
+
+    types = (int *) malloc(NBLOCKS * sizeof(int));
+    names = (char **) malloc(NBLOCKS * sizeof(char *));
+    foreign = (char **) malloc(NBLOCKS * sizeof(char *));
+    ranges = (double *) malloc(NBLOCKS * 2 * sizeof(double));
+    extents = (double *) malloc(NBLOCKS * 4 * sizeof(double));
+    hull = (double *) malloc(NBLOCKS * 2 * sizeof(double));
+    for (i = 0; i < NX; i++) x[i] = i;
+    for (j = 0; j < NY; j++) y[j] = j;
+    coords[0] = x;
+    coords[1] = y;
+
+    dbfile = DBCreate(filename, DB_CLOBBER, DB_LOCAL, "multivar query test", driver);
+
+    /* Blocks whose values drift and widen with the block index */
+    for (i = 0; i < NBLOCKS; i++)
+    {
+        char dir[32];
+        names[i] = (char *) malloc(32);
+        foreign[i] = (char *) malloc(48);
+        types[i] = DB_QUADVAR;
+        ranges[2*i] = 1;
+        ranges[2*i+1] = 0;
+        if (i % 11 == 5)
+        {
+            strcpy(names[i], "EMPTY");
+            strcpy(foreign[i], "EMPTY");
+            continue;
+        }
+        sprintf(dir, "block%d", i);
+        sprintf(names[i], "block%d/v", i);
+        sprintf(foreign[i], "other.silo:/block%d/v", i);
+        DBMkDir(dbfile, dir);
+        DBSetDir(dbfile, dir);
+        DBPutQuadmesh(dbfile, "mesh", NULL, coords, dims, 2, DB_FLOAT, DB_COLLINEAR, NULL);
+        for (j = 0; j < NX*NY; j++)
+        {
+            v[j] = (float) urand(i * 0.1, i * 0.1 + 1 + (i % 17));
+            if (j == 0 || v[j] < ranges[2*i]) ranges[2*i] = v[j];
+            if (j == 0 || v[j] > ranges[2*i+1]) ranges[2*i+1] = v[j];
+        }
+        DBPutQuadvar1(dbfile, "v", "mesh", v, dims, 2, NULL, 0, DB_FLOAT, DB_NODECENT, NULL);
+        DBSetDir(dbfile, "..");
+    }
+
+    /* Ranges gathered from the blocks, only when asked for */
+    ol = DBMakeOptlist(1);
+    DBAddOption(ol, DBOPT_MB_BLOCK_RANGES, &one);
+    DBPutMultivar(dbfile, "mvar", NBLOCKS, (DBCAS_t) names, types, ol);
+    DBFreeOptlist(ol);
+    DBPutMultivar(dbfile, "mvar_plain", NBLOCKS, (DBCAS_t) names, types, 0);
+
+    /* Two component ranges given by the caller */
+    for (i = 0; i < NBLOCKS; i++)
+    {
+        double *e = &extents[4*i];
+        e[0] = urand(-10, 10);  e[2] = e[0] + urand(0, 3);
+        e[1] = urand(-10, 10);  e[3] = e[1] + urand(0, 3);
+        hull[2*i] = e[0] < e[1] ? e[0] : e[1];
+        hull[2*i+1] = e[2] > e[3] ? e[2] : e[3];
+    }
+    ol = DBMakeOptlist(2);
+    DBAddOption(ol, DBOPT_EXTENTS_SIZE, &extsize);
+    DBAddOption(ol, DBOPT_EXTENTS, extents);
+    DBPutMultivar(dbfile, "mvar_ext", NBLOCKS, (DBCAS_t) names, types, ol);
+    DBFreeOptlist(ol);
+
+    /* Blocks in another file have no ranges to gather */
+    DBPutMultivar(dbfile, "mvar_noext", NBLOCKS, (DBCAS_t) foreign, types, 0);
+    DBClose(dbfile);
+
+    dbfile = DBOpen(filename, DB_UNKNOWN, DB_READ);
+
+    {
+        DBmultivar *mv = DBGetMultivar(dbfile, "mvar");
+        if (!mv || mv->extentssize != 2 || !mv->extents)
+        {
+            fprintf(stderr, "mvar: block ranges not stored as extents\n");
+            nerrors++;
+        }
+        for (i = 0; mv && mv->extents && i < NBLOCKS; i++)
+        {
+            if (!strcmp(names[i], "EMPTY") &&
+                !(isnan(mv->extents[2*i]) && isnan(mv->extents[2*i+1])))
+            {
+                fprintf(stderr, "mvar: empty block %d has extents\n", i);
+                nerrors++;
+                break;
+            }
+        }
+        DBFreeMultivar(mv);
+        mv = DBGetMultivar(dbfile, "mvar_plain");
+        if (!mv || mv->extents)
+        {
+            fprintf(stderr, "mvar_plain: extents gathered without DBOPT_MB_BLOCK_RANGES\n");
+            nerrors++;
+        }
+        DBFreeMultivar(mv);
+    }
+
+    for (i = 0; i < NQUERIES && !nerrors; i++)
+    {
+        double lo = urand(-2, 50), hi = lo + (i % 3 ? urand(0, 5) : 0);
+        nerrors += check_query(dbfile, "mvar", lo, hi, ranges, (char const * const *) names);
+        lo = urand(-12, 12);
+        hi = lo + urand(0, 2);
+        nerrors += check_query(dbfile, "mvar_ext", lo, hi, hull, (char const * const *) names);
+    }
+
+    /* Without extents, all non-empty blocks are returned */
+    nerrors += check_query(dbfile, "mvar_noext", 0, 1, 0, (char const * const *) names);
+
+    DBClose(dbfile);
+
+    for (i = 0; i < NBLOCKS; i++)
+    {
+        free(names[i]);
+        free(foreign[i]);
+    }
+    free(names);
+    free(foreign);
+    free(types);
+    free(ranges);
+    free(extents);
+    free(hull);
+
+    CleanupDriverStuff();
+    return nerrors > 0;
+}
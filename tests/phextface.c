@@ -0,0 +1,314 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <silo.h>
+
+#include <std.c>
+
+#define N 6
+#define NP (N+1)
+#define NZONES (N*N*N)
+#define NODE(i,j,k) ((i)+NP*((j)+NP*(k)))
+#define ZONE(i,j,k) ((i)+N*((j)+N*(k)))
+
+/* Index of the shared face normal to axis a on the low side of cell (i,j,k) */
+static int
+face_id(int a, int i, int j, int k)
+{
+    if (a == 0) return i + NP*(j + N*k);
+    if (a == 1) return NP*N*N + j + NP*(i + N*k);
+    return 2*NP*N*N + k + NP*(i + N*j);
+}
+
+/* The nodes of that face, ordered so its normal points along +a */
+static void
+face_nodes(int a, int i, int j, int k, int *n)
+{
+    if (a == 0)
+    {
+        n[0] = NODE(i,j,k);   n[1] = NODE(i,j+1,k);
+        n[2] = NODE(i,j+1,k+1); n[3] = NODE(i,j,k+1);
+    }
+    else if (a == 1)
+    {
+        n[0] = NODE(i,j,k);   n[1] = NODE(i,j,k+1);
+        n[2] = NODE(i+1,j,k+1); n[3] = NODE(i+1,j,k);
+    }
+    else
+    {
+        n[0] = NODE(i,j,k);   n[1] = NODE(i+1,j,k);
+        n[2] = NODE(i+1,j+1,k); n[3] = NODE(i,j+1,k);
+    }
+}
+
+/* Check both sides of each material boundary face are listed in zone order */
+static int
+check_side_order(char const *label, DBfacelist const *fl)
+{
+    int f, m, nerrors = 0;
+
+    for (f = 0; fl && f + 1 < fl->nfaces; f++)
+    {
+        int const *a = fl->nodelist + 4*f, *b = a + 4;
+        int same = 1;
+        for (m = 0; m < 4 && same; m++)
+            same = a[m] == b[0] || a[m] == b[1] || a[m] == b[2] || a[m] == b[3];
+        if (same && fl->zoneno[f] > fl->zoneno[f+1])
+        {
+            fprintf(stderr, "%s: sides of face %d out of zone order\n", label, f);
+            nerrors++;
+        }
+    }
+    return nerrors;
+}
+
+/* Check each face lies on the boundary of its zone and points out of it */
+static int
+check_facelist(char const *label, DBfacelist const *fl, int nexpected,
+               int lo, int hi)
+{
+    int f, m, nerrors = 0;
+
+    if (!fl || fl->nfaces != nexpected || fl->nshapes != 1 ||
+        fl->shapesize[0] != 4 || fl->shapecnt[0] != nexpected ||
+        fl->lnodelist != 4 * nexpected || fl->ndims != 3)
+    {
+        fprintf(stderr, "%s: expected %d external faces, got %d\n", label,
+            nexpected, fl ? fl->nfaces : -1);
+        return 1;
+    }
+
+    for (f = 0; f < fl->nfaces && nerrors < 10; f++)
+    {
+        int const *n = fl->nodelist + 4*f;
+        int z = fl->zoneno[f] - fl->origin;
+        int zc[3], p[4][3], e1[3], e2[3], nrm[3], c[3];
+        double dot = 0;
+
+        zc[0] = z % N; zc[1] = (z / N) % N; zc[2] = z / (N*N);
+        for (m = 0; m < 4; m++)
+        {
+            p[m][0] = n[m] % NP;
+            p[m][1] = (n[m] / NP) % NP;
+            p[m][2] = n[m] / (NP*NP);
+        }
+        for (m = 0; m < 3; m++)
+        {
+            e1[m] = p[1][m] - p[0][m];
+            e2[m] = p[2][m] - p[1][m];
+            c[m] = 2 * p[0][m] + e1[m] + e2[m] - 2 * zc[m] - 1;
+        }
+        nrm[0] = e1[1]*e2[2] - e1[2]*e2[1];
+        nrm[1] = e1[2]*e2[0] - e1[0]*e2[2];
+        nrm[2] = e1[0]*e2[1] - e1[1]*e2[0];
+        for (m = 0; m < 3; m++)
+            dot += nrm[m] * c[m];
+        if (z < lo || z > hi || dot <= 0 ||
+            n[0] > n[1] || n[0] > n[2] || n[0] > n[3])
+        {
+            fprintf(stderr, "%s: bad face %d of zone %d\n", label, f, z);
+            nerrors++;
+        }
+    }
+    return nerrors;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int            i, j, k, a, nerrors = 0;
+    int            driver = DB_PDB;
+    char          *filename = "phextface.pdb";
+    int            show_all_errors = FALSE;
+    int            nfaces = 3*NP*N*N, nfaces2 = 6*NZONES;
+    int           *nodecnt, *nodelist, *facecnt, *facelist;
+    int           *nodecnt2, *nodelist2, *facelist2, matlist[NZONES];
+    int            nsides = 6*N*N;
+    DBphzonelist   zl, zl2;
+    DBphzonelist  *rzl;
+    DBfacelist    *fl, *rfl;
+    DBfile        *dbfile;
+
+    for (i=1; i<argc; i++) {
+        if (!strncmp(argv[i], "DB_PDB", 6)) {
+            driver = StringToDriver(argv[i]);
+            filename = "phextface.pdb";
+        } else if (!strncmp(argv[i], "DB_HDF5", 7)) {
+            driver = StringToDriver(argv[i]);
+            filename = "phextface.h5";
+        } else if (!strcmp(argv[i], "show-all-errors")) {
+            show_all_errors = 1;
+        } else if (argv[i][0] != '\0') {
+            fprintf(stderr, "%s: ignored argument `%s'\n", argv[0], argv[i]);
+        }
+    }
+
+    DBShowErrors(show_all_errors?DB_ALL_AND_DRVR:DB_ABORT, NULL);
+
+    /* An NxNxN hex mesh as polyhedra sharing their faces, each face used
+       reversed by the zone on its positive side */
+    nodecnt = (int *) malloc(nfaces * sizeof(int));
+    nodelist = (int *) malloc(4 * nfaces * sizeof(int));
+    for (a = 0; a < 3; a++)
+        for (k = 0; k < (a == 2 ? NP : N); k++)
+            for (j = 0; j < (a == 1 ? NP : N); j++)
+                for (i = 0; i < (a == 0 ? NP : N); i++)
+                {
+                    int f = face_id(a, i, j, k);
+                    nodecnt[f] = 4;
+                    face_nodes(a, i, j, k, nodelist + 4*f);
+                }
+    facecnt = (int *) malloc(NZONES * sizeof(int));
+    facelist = (int *) malloc(6 * NZONES * sizeof(int));
+    for (k = 0; k < N; k++)
+        for (j = 0; j < N; j++)
+            for (i = 0; i < N; i++)
+            {
+                int *fz = facelist + 6*ZONE(i,j,k);
+                facecnt[ZONE(i,j,k)] = 6;
+                fz[0] = ~face_id(0, i, j, k); fz[1] = face_id(0, i+1, j, k);
+                fz[2] = ~face_id(1, i, j, k); fz[3] = face_id(1, i, j+1, k);
+                fz[4] = ~face_id(2, i, j, k); fz[5] = face_id(2, i, j, k+1);
+                matlist[ZONE(i,j,k)] = i < N/2 ? 1 : 2;
+            }
+
+    memset(&zl, 0, sizeof(zl));
+    zl.nfaces = nfaces;
+    zl.nodecnt = nodecnt;
+    zl.lnodelist = 4 * nfaces;
+    zl.nodelist = nodelist;
+    zl.nzones = NZONES;
+    zl.facecnt = facecnt;
+    zl.lfacelist = 6 * NZONES;
+    zl.facelist = facelist;
+    zl.lo_offset = 0;
+    zl.hi_offset = NZONES - 1;
+
+    fl = DBCalcExternalFacelistPH(&zl, NULL, 0);
+    nerrors += check_facelist("shared", fl, nsides, 0, NZONES - 1);
+    DBFreeFacelist(fl);
+
+    /* Material boundaries are kept once for each side */
+    fl = DBCalcExternalFacelistPH(&zl, matlist, 1);
+    nerrors += check_facelist("materials", fl, nsides + 2*N*N, 0, NZONES - 1);
+    nerrors += check_side_order("materials", fl);
+    DBFreeFacelist(fl);
+
+    /* The same mesh with every zone listing its own copy of its faces,
+       rotated, so that shared faces must be matched by their nodes */
+    nodecnt2 = (int *) malloc(nfaces2 * sizeof(int));
+    nodelist2 = (int *) malloc(4 * nfaces2 * sizeof(int));
+    facelist2 = (int *) malloc(nfaces2 * sizeof(int));
+    for (i = 0; i < nfaces2; i++)
+    {
+        int id = facelist[i], f = id < 0 ? ~id : id, r = i % 4, m;
+        nodecnt2[i] = 4;
+        for (m = 0; m < 4; m++)
+            nodelist2[4*i+m] = nodelist[4*f + (id < 0 ? 7 - m - r : m + r) % 4];
+        facelist2[i] = i;
+    }
+    zl2 = zl;
+    zl2.nfaces = nfaces2;
+    zl2.nodecnt = nodecnt2;
+    zl2.lnodelist = 4 * nfaces2;
+    zl2.nodelist = nodelist2;
+    zl2.facelist = facelist2;
+
+    fl = DBCalcExternalFacelistPH(&zl2, NULL, 0);
+    nerrors += check_facelist("duplicated", fl, nsides, 0, NZONES - 1);
+    DBFreeFacelist(fl);
+
+    fl = DBCalcExternalFacelistPH(&zl2, matlist, 1);
+    nerrors += check_facelist("duplicated materials", fl, nsides + 2*N*N, 0, NZONES - 1);
+    DBFreeFacelist(fl);
+
+    /* Round trip a zonelist whose bottom layer of zones are ghosts and
+       the facelist computed from it */
+    dbfile = DBCreate(filename, DB_CLOBBER, DB_LOCAL, "polyhedral external faces", driver);
+    DBPutPHZonelist(dbfile, "phzl", nfaces, nodecnt, 4 * nfaces, nodelist, 0,
+        NZONES, facecnt, 6 * NZONES, facelist, 0, N*N, NZONES - 1, 0);
+    rzl = DBGetPHZonelist(dbfile, "phzl");
+    fl = DBCalcExternalFacelistPH(rzl, NULL, 0);
+    nerrors += check_facelist("ghosts", fl, 4*N*(N-1) + N*N, N*N, NZONES - 1);
+    if (fl)
+    {
+        DBPutFacelist(dbfile, "fl", fl->nfaces, fl->ndims, fl->nodelist,
+            fl->lnodelist, fl->origin, fl->zoneno, fl->shapesize, fl->shapecnt,
+            fl->nshapes, 0, 0, 0);
+        rfl = DBGetFacelist(dbfile, "fl");
+        if (!rfl || rfl->nfaces != fl->nfaces ||
+            memcmp(rfl->nodelist, fl->nodelist, fl->lnodelist * sizeof(int)) ||
+            memcmp(rfl->zoneno, fl->zoneno, fl->nfaces * sizeof(int)))
+        {
+            fprintf(stderr, "facelist did not round trip\n");
+            nerrors++;
+        }
+        DBFreeFacelist(rfl);
+    }
+    DBFreeFacelist(fl);
+    DBFreePHZonelist(rzl);
+    DBClose(dbfile);
+
+    free(nodecnt);
+    free(nodelist);
+    free(facecnt);
+    free(facelist);
+    free(nodecnt2);
+    free(nodelist2);
+    free(facelist2);
+
+    CleanupDriverStuff();
+    return nerrors > 0;
+}
@@ -0,0 +1,253 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <mpi.h>
+
+#include <silo.h>
+#include <pmpio.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*-----------------------------------------------------------------------------
+ * Purpose:     Impliment the create callback. With aggregation, the
+ *              namespace is created by the write buffer callback instead.
+ *-----------------------------------------------------------------------------
+ */
+static void *CreateSiloFile(const char *fname, const char *nsname, void *userData)
+{
+    int driver = *((int*) userData);
+    DBfile *siloFile = DBCreate(fname, DB_CLOBBER, DB_LOCAL, "pmpio aggregate testing", driver);
+    if (siloFile && nsname)
+    {
+        DBMkDir(siloFile, nsname);
+        DBSetDir(siloFile, nsname);
+    }
+    return (void *) siloFile;
+}
+
+static void *OpenSiloFile(const char *fname, const char *nsname, PMPIO_iomode_t ioMode,
+    void *userData)
+{
+    DBfile *siloFile = DBOpen(fname, DB_UNKNOWN,
+        ioMode == PMPIO_WRITE ? DB_APPEND : DB_READ);
+    if (siloFile && nsname)
+    {
+        if (ioMode == PMPIO_WRITE)
+            DBMkDir(siloFile, nsname);
+        DBSetDir(siloFile, nsname);
+    }
+    return (void *) siloFile;
+}
+
+static void CloseSiloFile(void *file, void *userData)
+{
+    DBfile *siloFile = (DBfile *) file;
+    if (siloFile)
+        DBClose(siloFile);
+}
+
+/*-----------------------------------------------------------------------------
+ * Purpose:     A processor's block serialized as {nx, ny}, nx x coords,
+ *              ny y coords and nx*ny nodal values, all as floats after the
+ *              two ints.
+ *-----------------------------------------------------------------------------
+ */
+static void *PackBlock(int rank, size_t *len)
+{
+    int nx = 5 + rank % 7, ny = 4 + (3 * rank) % 5, i, j;
+    char *buf;
+    float *x, *y, *v;
+
+    *len = 2 * sizeof(int) + (nx + ny + nx * ny) * sizeof(float);
+    buf = (char *) malloc(*len);
+    ((int *) buf)[0] = nx;
+    ((int *) buf)[1] = ny;
+    x = (float *) (buf + 2 * sizeof(int));
+    y = x + nx;
+    v = y + ny;
+    for (i = 0; i < nx; i++)
+        x[i] = rank * 10 + i;
+    for (j = 0; j < ny; j++)
+        y[j] = j;
+    for (j = 0; j < ny; j++)
+        for (i = 0; i < nx; i++)
+            v[j*nx+i] = rank * 1000 + j * nx + i;
+    return buf;
+}
+
+/*-----------------------------------------------------------------------------
+ * Purpose:     Impliment the write buffer callback. Makes the processor's
+ *              directory and writes its mesh and variable from the buffer.
+ *-----------------------------------------------------------------------------
+ */
+static int WriteBlock(void *file, const char *nsname, const void *buf, size_t len,
+    void *userData)
+{
+    DBfile *siloFile = (DBfile *) file;
+    int dims[2];
+    float *coords[2];
+    float *v;
+
+    if (len < 2 * sizeof(int))
+        return 1;
+    dims[0] = ((int const *) buf)[0];
+    dims[1] = ((int const *) buf)[1];
+    coords[0] = (float *) ((char const *) buf + 2 * sizeof(int));
+    coords[1] = coords[0] + dims[0];
+    v = coords[1] + dims[1];
+
+    if (DBMkDir(siloFile, nsname) < 0 || DBSetDir(siloFile, nsname) < 0)
+        return 1;
+    if (DBPutQuadmesh(siloFile, "qmesh", NULL, coords, dims, 2, DB_FLOAT,
+            DB_COLLINEAR, NULL) < 0)
+        return 1;
+    if (DBPutQuadvar1(siloFile, "temp", "qmesh", v, dims, 2, NULL, 0, DB_FLOAT,
+            DB_NODECENT, NULL) < 0)
+        return 1;
+    return DBSetDir(siloFile, "/") < 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * Purpose:     Demonstrate and test PMPIO_Aggregate
+ * Description:
+ * Every processor serializes a small, differently sized block and the first
+ * processor of each group writes them all to the group's file. Then every
+ * processor reads its block back and checks it. By default, 3 files are
+ * written with at most 1 kilobyte of buffers held at once, so that the bound
+ * is exercised. Try something like...
+ *
+ *     mpirun -np 11 pmpio_aggregate 3 DB_HDF5
+ *-----------------------------------------------------------------------------
+ */
+int main(int argc, char **argv)
+{
+    int size, rank, i, numGroups = 3, driver = DB_PDB;
+    int nerrors = 0, allerrors = 0;
+    char fileName[256], nsName[256];
+    char const *file_ext = "pdb";
+    size_t len;
+    void *buf;
+    PMPIO_baton_t *bat;
+    DBfile *dbfile;
+    DBquadvar *qv;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strncmp(argv[i], "DB_HDF5", 7))
+        {
+            driver = DB_HDF5;
+            file_ext = "h5";
+        }
+        else if (!strncmp(argv[i], "DB_PDB", 6))
+        {
+            driver = DB_PDB;
+            file_ext = "pdb";
+        }
+        else if (atoi(argv[i]) > 0)
+        {
+            numGroups = atoi(argv[i]);
+        }
+    }
+    if (numGroups > size)
+        numGroups = size;
+
+    bat = PMPIO_Init(numGroups, PMPIO_WRITE, MPI_COMM_WORLD, 1,
+        CreateSiloFile, OpenSiloFile, CloseSiloFile, &driver);
+
+    sprintf(fileName, "pmpio_aggregate_%03d.%s", PMPIO_GroupRank(bat, rank), file_ext);
+    sprintf(nsName, "domain_%03d", rank);
+
+    buf = PackBlock(rank, &len);
+    if (PMPIO_Aggregate(bat, fileName, nsName, buf, len, WriteBlock, 1024) != PMPIO_BATON_OK)
+    {
+        fprintf(stderr, "rank %d: PMPIO_Aggregate failed\n", rank);
+        nerrors++;
+    }
+    PMPIO_Finish(bat);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    /* Read back this processor's block */
+    dbfile = DBOpen(fileName, DB_UNKNOWN, DB_READ);
+    if (dbfile && DBSetDir(dbfile, nsName) == 0 &&
+        (qv = DBGetQuadvar(dbfile, "temp")) != NULL)
+    {
+        float const *v = (float const *) ((char *) buf + 2 * sizeof(int)) +
+                         qv->dims[0] + qv->dims[1];
+        if (qv->dims[0] != ((int *) buf)[0] || qv->dims[1] != ((int *) buf)[1] ||
+            memcmp(qv->vals[0], v, qv->nels * sizeof(float)))
+        {
+            fprintf(stderr, "rank %d: wrong data in %s:%s\n", rank, fileName, nsName);
+            nerrors++;
+        }
+        DBFreeQuadvar(qv);
+    }
+    else
+    {
+        fprintf(stderr, "rank %d: cannot read %s:%s/temp\n", rank, fileName, nsName);
+        nerrors++;
+    }
+    if (dbfile)
+        DBClose(dbfile);
+    free(buf);
+
+    MPI_Allreduce(&nerrors, &allerrors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+
+    MPI_Finalize();
+
+    return allerrors > 0;
+}
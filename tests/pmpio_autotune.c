@@ -0,0 +1,108 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <mpi.h>
+#include <pmpio.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*-----------------------------------------------------------------------------
+ * Purpose:     Demonstrate and test PMPIO_AutoNumFiles
+ * Description:
+ * Probes for the number of files, logs the measurements and checks that a
+ * second call takes the same choice from the profile the first one wrote.
+ * Try something like...
+ *
+ *     mpirun -np 8 pmpio_autotune
+ *-----------------------------------------------------------------------------
+ */
+int main(int argc, char **argv)
+{
+    int size, rank, i, numFiles, numFiles2, nerrors = 0;
+    char const *profile = "pmpio_autotune.profile";
+    PMPIO_autotune_t info, info2;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    if (rank == 0)
+        remove(profile);
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    numFiles = PMPIO_AutoNumFiles(MPI_COMM_WORLD, 1, 0, profile, 0, 0, 1<<16, &info);
+    if (rank == 0)
+    {
+        for (i = 0; i < info.numCandidates; i++)
+            printf("%d files: %g bytes/sec\n", info.candidates[i], info.throughput[i]);
+        printf("chose %d files for %d processors\n", numFiles, size);
+    }
+    if (info.fromProfile || numFiles < 1 || numFiles > size || numFiles != info.numFiles)
+        nerrors++;
+
+    numFiles2 = PMPIO_AutoNumFiles(MPI_COMM_WORLD, 1, 0, profile, 0, 0, 1<<16, &info2);
+    if (!info2.fromProfile || numFiles2 != numFiles ||
+        info2.numCandidates != info.numCandidates)
+        nerrors++;
+
+    if (rank == 0)
+    {
+        if (nerrors)
+            fprintf(stderr, "PMPIO_AutoNumFiles check failed\n");
+        remove(profile);
+    }
+
+    MPI_Finalize();
+
+    return nerrors > 0;
+}
@@ -0,0 +1,303 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <mpi.h>
+
+#include <silo.h>
+#include <pmpio.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 4
+#define NY 3
+
+static void *CreateSiloFile(const char *fname, const char *nsname, void *userData)
+{
+    int driver = *((int*) userData);
+    DBfile *siloFile = DBCreate(fname, DB_CLOBBER, DB_LOCAL, "pmpio restart testing", driver);
+    if (siloFile && nsname)
+    {
+        DBMkDir(siloFile, nsname);
+        DBSetDir(siloFile, nsname);
+    }
+    return (void *) siloFile;
+}
+
+static void *OpenSiloFile(const char *fname, const char *nsname, PMPIO_iomode_t ioMode,
+    void *userData)
+{
+    DBfile *siloFile = DBOpen(fname, DB_UNKNOWN,
+        ioMode == PMPIO_WRITE ? DB_APPEND : DB_READ);
+    if (siloFile && nsname)
+    {
+        if (ioMode == PMPIO_WRITE)
+            DBMkDir(siloFile, nsname);
+        DBSetDir(siloFile, nsname);
+    }
+    return (void *) siloFile;
+}
+
+static void CloseSiloFile(void *file, void *userData)
+{
+    DBfile *siloFile = (DBfile *) file;
+    if (siloFile)
+        DBClose(siloFile);
+}
+
+/* Each domain's mesh and a variable whose values are its index */
+static void WriteDomain(DBfile *siloFile, int domain)
+{
+    int dims[2] = {NX, NY}, i;
+    float x[NX], y[NY], v[NX*NY];
+    float *coords[2];
+    char dir[32];
+
+    for (i = 0; i < NX; i++) x[i] = domain * NX + i;
+    for (i = 0; i < NY; i++) y[i] = i;
+    for (i = 0; i < NX*NY; i++) v[i] = domain;
+    coords[0] = x;
+    coords[1] = y;
+    sprintf(dir, "/domain_%03d", domain);
+    DBMkDir(siloFile, dir);
+    DBSetDir(siloFile, dir);
+    DBPutQuadmesh(siloFile, "qmesh", NULL, coords, dims, 2, DB_FLOAT, DB_COLLINEAR, NULL);
+    DBPutQuadvar1(siloFile, "v", "qmesh", v, dims, 2, NULL, 0, DB_FLOAT, DB_NODECENT, NULL);
+    DBSetDir(siloFile, "/");
+}
+
+static int *readCounts;
+
+/*-----------------------------------------------------------------------------
+ * Purpose:     Impliment the read domain callback. Checks the domain's
+ *              values and counts the read.
+ *-----------------------------------------------------------------------------
+ */
+static int ReadDomain(void *file, const char *nsname, int domain, void *userData)
+{
+    DBfile *siloFile = (DBfile *) file;
+    DBquadvar *qv;
+    int i, bad = 0;
+
+    if (DBSetDir(siloFile, "/") < 0 || DBSetDir(siloFile, nsname) < 0)
+        return 1;
+    if ((qv = DBGetQuadvar(siloFile, "v")) == NULL)
+        return 1;
+    for (i = 0; i < qv->nels; i++)
+        if (((float *) qv->vals[0])[i] != domain)
+            bad = 1;
+    DBFreeQuadvar(qv);
+    readCounts[domain]++;
+    return bad;
+}
+
+/*-----------------------------------------------------------------------------
+ * Purpose:     Read the dump back with a given number of processors
+ *-----------------------------------------------------------------------------
+ */
+static int RestartRead(int numReaders, int numDomains, const char *rootName, int driver)
+{
+    int rank, i, nerrors = 0;
+    MPI_Comm comm;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_split(MPI_COMM_WORLD, rank < numReaders ? 0 : MPI_UNDEFINED, rank, &comm);
+    if (comm == MPI_COMM_NULL)
+        return 0;
+
+    {
+        PMPIO_readplan_t *plan;
+        char **fnames = 0, **nsnames = 0;
+        int n = 0, *allCounts, minDoms, maxDoms, sumFiles;
+
+        if (rank == 0)
+        {
+            DBfile *root = DBOpen(rootName, DB_UNKNOWN, DB_READ);
+            DBmultimesh *mm = DBGetMultimesh(root, "mesh");
+            n = PMPIO_SiloDomainInventory(rootName, mm, &fnames, &nsnames);
+            DBFreeMultimesh(mm);
+            DBClose(root);
+        }
+
+        plan = PMPIO_PlanRead(comm, n, (const char * const *) fnames,
+                   (const char * const *) nsnames, 0);
+
+        readCounts = (int *) calloc(plan->numDomains, sizeof(int));
+        allCounts = (int *) calloc(plan->numDomains, sizeof(int));
+        if (PMPIO_ExecuteRead(plan, OpenSiloFile, ReadDomain, CloseSiloFile, &driver) !=
+            PMPIO_BATON_OK)
+        {
+            fprintf(stderr, "rank %d: reading with %d processors failed\n", rank, numReaders);
+            nerrors++;
+        }
+
+        /* Every domain but the empty one read exactly once, with balance */
+        MPI_Allreduce(readCounts, allCounts, plan->numDomains, MPI_INT, MPI_SUM, comm);
+        MPI_Allreduce(&plan->myNumDomains, &minDoms, 1, MPI_INT, MPI_MIN, comm);
+        MPI_Allreduce(&plan->myNumDomains, &maxDoms, 1, MPI_INT, MPI_MAX, comm);
+        MPI_Allreduce(&plan->myNumFiles, &sumFiles, 1, MPI_INT, MPI_SUM, comm);
+        if (plan->numDomains != numDomains)
+            nerrors++;
+        for (i = 0; i < plan->numDomains; i++)
+            if (allCounts[i] != (i == 1 ? 0 : 1))
+                nerrors++;
+        if (maxDoms - minDoms > 1)
+            nerrors++;
+        if (rank == 0)
+            printf("%d readers: %d to %d domains each, %d file opens\n",
+                numReaders, minDoms, maxDoms, sumFiles);
+
+        free(readCounts);
+        free(allCounts);
+        PMPIO_FreeReadPlan(plan);
+        for (i = 0; i < n; i++)
+        {
+            free(fnames[i]);
+            free(nsnames[i]);
+        }
+        free(fnames);
+        free(nsnames);
+    }
+
+    MPI_Comm_free(&comm);
+    return nerrors;
+}
+
+/*-----------------------------------------------------------------------------
+ * Purpose:     Demonstrate and test PMPIO_PlanRead and PMPIO_ExecuteRead
+ * Description:
+ * Writes 3 domains per processor, except one "EMPTY" domain, to 3 files with
+ * the baton, and a root file with the multimesh. Then reads them back with
+ * about half as many processors and with all of them, checking every domain
+ * is read exactly once and the reads are balanced. Try something like...
+ *
+ *     mpirun -np 7 pmpio_restart DB_HDF5
+ *-----------------------------------------------------------------------------
+ */
+int main(int argc, char **argv)
+{
+    int size, rank, i, numGroups = 3, driver = DB_PDB;
+    int numDomains, nerrors = 0, allerrors = 0;
+    char fileName[256];
+    char const *file_ext = "pdb";
+    char rootName[256];
+    PMPIO_baton_t *bat;
+    DBfile *siloFile;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strncmp(argv[i], "DB_HDF5", 7))
+        {
+            driver = DB_HDF5;
+            file_ext = "h5";
+        }
+        else if (!strncmp(argv[i], "DB_PDB", 6))
+        {
+            driver = DB_PDB;
+            file_ext = "pdb";
+        }
+    }
+    if (numGroups > size)
+        numGroups = size;
+    numDomains = 3 * size;
+
+    bat = PMPIO_Init(numGroups, PMPIO_WRITE, MPI_COMM_WORLD, 1,
+        CreateSiloFile, OpenSiloFile, CloseSiloFile, &driver);
+    sprintf(fileName, "pmpio_restart_%03d.%s", PMPIO_GroupRank(bat, rank), file_ext);
+    siloFile = (DBfile *) PMPIO_WaitForBaton(bat, fileName, 0);
+    for (i = rank; i < numDomains; i += size)
+        if (i != 1)
+            WriteDomain(siloFile, i);
+    PMPIO_HandOffBaton(bat, siloFile);
+
+    sprintf(rootName, "pmpio_restart_root.%s", file_ext);
+    if (rank == 0)
+    {
+        char **names = (char **) malloc(numDomains * sizeof(char *));
+        int *types = (int *) malloc(numDomains * sizeof(int));
+        for (i = 0; i < numDomains; i++)
+        {
+            names[i] = (char *) malloc(64);
+            if (i == 1)
+                strcpy(names[i], "EMPTY");
+            else
+                sprintf(names[i], "pmpio_restart_%03d.%s:/domain_%03d/qmesh",
+                    PMPIO_GroupRank(bat, i % size), file_ext, i);
+            types[i] = DB_QUADMESH;
+        }
+        siloFile = DBCreate(rootName, DB_CLOBBER, DB_LOCAL, "pmpio restart root", driver);
+        DBPutMultimesh(siloFile, "mesh", numDomains, (DBCAS_t) names, types, NULL);
+        DBClose(siloFile);
+        for (i = 0; i < numDomains; i++)
+            free(names[i]);
+        free(names);
+        free(types);
+    }
+    PMPIO_Finish(bat);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    nerrors += RestartRead((size + 1) / 2, numDomains, rootName, driver);
+    nerrors += RestartRead(size, numDomains, rootName, driver);
+
+    MPI_Allreduce(&nerrors, &allerrors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (rank == 0 && allerrors)
+        fprintf(stderr, "pmpio_restart: %d errors\n", allerrors);
+
+    MPI_Finalize();
+
+    return allerrors > 0;
+}
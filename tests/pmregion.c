@@ -0,0 +1,266 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <silo.h>
+
+#include <std.c>
+
+#define NPTS 40000
+#define NQUERIES 60
+
+static unsigned int seed = 2468;
+
+static double
+urand(double lo, double hi)
+{
+    seed = seed * 1103515245u + 12345u;
+    return lo + (hi - lo) * ((seed >> 8) & 0xFFFF) / 65535.0;
+}
+
+/* Compare a region read against a brute force search of the points */
+static int
+check_region(DBfile *dbfile, char const *mname, char const *vname, int idoff,
+    double const *box, double * const *xyz)
+{
+    int i, n = 0, nerrors = 0;
+    char *hit = (char *) calloc(NPTS, 1);
+    DBpointmesh *pm = DBGetPointmeshRegion(dbfile, mname, box);
+    DBmeshvar *pv = vname ? DBGetPointvarRegion(dbfile, vname, box) : 0;
+
+    for (i = 0; i < NPTS; i++)
+    {
+        if (box[0] <= xyz[0][i] && xyz[0][i] <= box[3] &&
+            box[1] <= xyz[1][i] && xyz[1][i] <= box[4] &&
+            box[2] <= xyz[2][i] && xyz[2][i] <= box[5])
+            n++;
+    }
+    if (!pm || pm->nels != n || (vname && (!pv || pv->nels != n)))
+    {
+        fprintf(stderr, "%s: got %d points, expected %d\n", mname, pm ? pm->nels : -1, n);
+        nerrors++;
+    }
+    for (i = 0; !nerrors && i < n; i++)
+    {
+        int id = ((int *) pm->gnodeno)[i] - idoff, d;
+        if (id < 0 || id >= NPTS || hit[id])
+        {
+            fprintf(stderr, "%s: bad or repeated point id %d\n", mname, id);
+            nerrors++;
+            break;
+        }
+        hit[id] = 1;
+        for (d = 0; d < 3; d++)
+        {
+            if (((double *) pm->coords[d])[i] != xyz[d][id])
+            {
+                fprintf(stderr, "%s: point %d coordinates do not match\n", mname, id);
+                nerrors++;
+            }
+        }
+        if (vname && (((double *) pv->vals[0])[i] != id ||
+                      ((double *) pv->vals[1])[i] != xyz[0][id] + xyz[1][id]))
+        {
+            fprintf(stderr, "%s: point %d values do not match\n", vname, id);
+            nerrors++;
+        }
+    }
+    DBFreePointmesh(pm);
+    DBFreeMeshvar(pv);
+    free(hit);
+    return nerrors;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Test DBGetPointmeshRegion and DBGetPointvarRegion on point
+ *              meshes written with and without DBOPT_SPATIAL_SORT against
+ *              a brute force search of the points.
+ *
+ * Return:      0 on success, 1 on failure
+ *-------------------------------------------------------------------------
+ */
+int
+main(int argc, char *argv[])
+{
+    int            i, nerrors = 0;
+    int            driver = DB_PDB;
+    int            show_all_errors = FALSE;
+    char          *filename = "pmregion.pdb";
+    int            sort = DB_SORT_MORTON, chunk = 512, lo = 100, hi = 50;
+    int           *nodenum;
+    double        *xyz[3], *vals[2];
+    DBpointmesh   *pm;
+    DBmeshvar     *pv;
+    DBoptlist     *ol, *olnn, *olgh;
+    DBfile        *dbfile;
+
+    for (i=1; i<argc; i++) {
+        if (!strncmp(argv[i], "DB_PDB", 6)) {
+            driver = StringToDriver(argv[i]);
+            filename = "pmregion.pdb";
+        } else if (!strncmp(argv[i], "DB_HDF5", 7)) {
+            driver = StringToDriver(argv[i]);
+            filename = "pmregion.h5";
+        } else if (!strcmp(argv[i], "show-all-errors")) {
+            show_all_errors = 1;
+        } else if (argv[i][0] != '\0') {
+            fprintf(stderr, "%s: ignored argument `%s'\n", argv[0], argv[i]);
+        }
+    }
+
+    DBShowErrors(show_all_errors?DB_ALL_AND_DRVR:DB_ABORT, NULL);
+
+    /* Clustered points so that boxes hit some chunks and miss others */
+    for (i = 0; i < 3; i++)
+        xyz[i] = (double *) malloc(NPTS * sizeof(double));
+    vals[0] = (double *) malloc(NPTS * sizeof(double));
+    vals[1] = (double *) malloc(NPTS * sizeof(double));
+    nodenum = (int *) malloc(NPTS * sizeof(int));
+    for (i = 0; i < NPTS; i++)
+    {
+        double cx = (i % 7) * 10, cy = (i % 5) * 10;
+        xyz[0][i] = cx + urand(-3, 3);
+        xyz[1][i] = cy + urand(-3, 3);
+        xyz[2][i] = urand(0, 20);
+        vals[0][i] = i;
+        vals[1][i] = xyz[0][i] + xyz[1][i];
+        nodenum[i] = 1000 + i;
+    }
+
+    ol = DBMakeOptlist(2);
+    DBAddOption(ol, DBOPT_SPATIAL_SORT, &sort);
+    DBAddOption(ol, DBOPT_SORT_CHUNK_SIZE, &chunk);
+    olnn = DBMakeOptlist(3);
+    DBAddOption(olnn, DBOPT_SPATIAL_SORT, &sort);
+    DBAddOption(olnn, DBOPT_NODENUM, nodenum);
+    olgh = DBMakeOptlist(3);
+    DBAddOption(olgh, DBOPT_SPATIAL_SORT, &sort);
+    DBAddOption(olgh, DBOPT_LO_OFFSET, &lo);
+    DBAddOption(olgh, DBOPT_HI_OFFSET, &hi);
+
+    dbfile = DBCreate(filename, DB_CLOBBER, DB_LOCAL, "point mesh region test", driver);
+    DBPutPointmesh(dbfile, "pm", 3, (DBVCP2_t) xyz, NPTS, DB_DOUBLE, ol);
+    DBPutPointvar(dbfile, "pv", "pm", 2, (DBVCP2_t) vals, NPTS, DB_DOUBLE, NULL);
+    DBPutPointmesh(dbfile, "pm_plain", 3, (DBVCP2_t) xyz, NPTS, DB_DOUBLE, NULL);
+    DBPutPointvar(dbfile, "pv_plain", "pm_plain", 2, (DBVCP2_t) vals, NPTS, DB_DOUBLE, NULL);
+    DBPutPointmesh(dbfile, "pm_nn", 3, (DBVCP2_t) xyz, NPTS, DB_DOUBLE, olnn);
+    DBPutPointmesh(dbfile, "pm_gh", 3, (DBVCP2_t) xyz, NPTS, DB_DOUBLE, olgh);
+    DBPutPointvar(dbfile, "pv_gh", "pm_gh", 2, (DBVCP2_t) vals, NPTS, DB_DOUBLE, NULL);
+    DBClose(dbfile);
+    DBFreeOptlist(ol);
+    DBFreeOptlist(olnn);
+    DBFreeOptlist(olgh);
+
+    dbfile = DBOpen(filename, DB_UNKNOWN, DB_READ);
+
+    /* Whole sorted mesh and its variable are still consistent */
+    pm = DBGetPointmesh(dbfile, "pm");
+    pv = DBGetPointvar(dbfile, "pv");
+    for (i = 0; i < NPTS && !nerrors; i++)
+    {
+        int id = (int) ((double *) pv->vals[0])[i];
+        if (id < 0 || id >= NPTS || ((double *) pm->coords[0])[i] != xyz[0][id] ||
+            ((double *) pm->coords[2])[i] != xyz[2][id])
+        {
+            fprintf(stderr, "sorted point %d does not match its variable\n", i);
+            nerrors++;
+        }
+    }
+    DBFreePointmesh(pm);
+    DBFreeMeshvar(pv);
+
+    /* Ghost points stay where DBOPT_LO_OFFSET and DBOPT_HI_OFFSET say */
+    pm = DBGetPointmesh(dbfile, "pm_gh");
+    pv = DBGetPointvar(dbfile, "pv_gh");
+    for (i = 0; i < NPTS && !nerrors; i++)
+    {
+        int id = (int) ((double *) pv->vals[0])[i];
+        if ((i < lo || i >= NPTS - hi) ? id != i : (id < lo || id >= NPTS - hi))
+        {
+            fprintf(stderr, "point %d of ghosted mesh moved across a ghost boundary\n", i);
+            nerrors++;
+        }
+        else if (((double *) pm->coords[0])[i] != xyz[0][id])
+        {
+            fprintf(stderr, "ghosted point %d does not match its variable\n", i);
+            nerrors++;
+        }
+    }
+    DBFreePointmesh(pm);
+    DBFreeMeshvar(pv);
+
+    for (i = 0; i < NQUERIES && !nerrors; i++)
+    {
+        double box[6];
+        box[0] = urand(-5, 65); box[3] = box[0] + urand(0, i % 4 ? 8 : 40);
+        box[1] = urand(-5, 45); box[4] = box[1] + urand(0, i % 4 ? 8 : 40);
+        box[2] = urand(0, 20);  box[5] = box[2] + urand(0, 10);
+        nerrors += check_region(dbfile, "pm", "pv", 0, box, xyz);
+        nerrors += check_region(dbfile, "pm_plain", "pv_plain", 0, box, xyz);
+        nerrors += check_region(dbfile, "pm_nn", 0, 1000, box, xyz);
+    }
+
+    DBClose(dbfile);
+
+    for (i = 0; i < 3; i++)
+        free(xyz[i]);
+    free(vals[0]);
+    free(vals[1]);
+    free(nodenum);
+
+    CleanupDriverStuff();
+    return nerrors > 0;
+}
@@ -0,0 +1,338 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <silo.h>
+
+#include <config.h>
+#ifdef HAVE_HDF5_H
+#include <hdf5.h> /* for a file with a userblock */
+#endif
+
+#include <std.c>
+
+#define NX 30
+#define NY 20
+#define NVARS 6
+
+/* Write the objects at the root and again, with other variable values,
+   in the directory "sub" */
+static void
+write_file(char const *filename, int driver)
+{
+    int d, i, j, dims[2] = {NX, NY}, zdims[2] = {NX-1, NY-1};
+    int nodelist[(NX-1)*(NY-1)*4], shapesize = 4, shapecnt = (NX-1)*(NY-1);
+    int matnos[2] = {1, 2}, matlist[(NX-1)*(NY-1)];
+    float x[NX], y[NY], ux[NX*NY], uy[NX*NY], cx[NX], cy[NX];
+    double vals[NX*NY];
+    void *coords[3];
+    DBfile *dbfile = DBCreate(filename, DB_CLOBBER, DB_LOCAL, "batch read test", driver);
+
+    for (i = 0; i < NX; i++) x[i] = cx[i] = i;
+    for (i = 0; i < NY; i++) y[i] = i;
+    for (j = 0; j < NY; j++)
+    {
+        for (i = 0; i < NX; i++)
+        {
+            ux[j*NX+i] = x[i];
+            uy[j*NX+i] = y[j];
+        }
+    }
+    for (j = 0; j < NY-1; j++)
+    {
+        for (i = 0; i < NX-1; i++)
+        {
+            int z = j*(NX-1)+i;
+            nodelist[4*z+0] = j*NX+i;
+            nodelist[4*z+1] = j*NX+i+1;
+            nodelist[4*z+2] = (j+1)*NX+i+1;
+            nodelist[4*z+3] = (j+1)*NX+i;
+            matlist[z] = i < NX/2 ? 1 : 2;
+        }
+    }
+    for (i = 0; i < NX; i++) cy[i] = i * i;
+
+    for (d = 0; d < 2; d++)
+    {
+        if (d == 1)
+        {
+            DBMkDir(dbfile, "sub");
+            DBSetDir(dbfile, "sub");
+        }
+
+        coords[0] = x;
+        coords[1] = y;
+        coords[2] = 0;
+        DBPutQuadmesh(dbfile, "qmesh", 0, coords, dims, 2, DB_FLOAT, DB_COLLINEAR, 0);
+        for (i = 0; i < NVARS; i++)
+        {
+            char name[32];
+            for (j = 0; j < NX*NY; j++) vals[j] = i * 1000 + j + d * 0.5;
+            sprintf(name, "qvar%d", i);
+            DBPutQuadvar1(dbfile, name, "qmesh", vals, dims, 2, 0, 0, DB_DOUBLE, DB_NODECENT, 0);
+        }
+
+        coords[0] = ux;
+        coords[1] = uy;
+        DBPutZonelist2(dbfile, "zl", (NX-1)*(NY-1), 2, nodelist, (NX-1)*(NY-1)*4, 0, 0, 0,
+            &shapesize, &shapecnt, &shapesize, 1, 0);
+        DBPutUcdmesh(dbfile, "umesh", 2, 0, coords, NX*NY, (NX-1)*(NY-1), "zl", 0, DB_FLOAT, 0);
+        DBPutUcdvar1(dbfile, "uvar", "umesh", ux, NX*NY, 0, 0, DB_FLOAT, DB_NODECENT, 0);
+        DBPutMaterial(dbfile, "mat", "qmesh", 2, matnos, matlist, zdims, 2, 0, 0, 0, 0, 0, DB_FLOAT, 0);
+        DBPutCurve(dbfile, "curve", cx, cy, DB_FLOAT, NX, 0);
+    }
+
+    DBClose(dbfile);
+}
+
+/* Compare an object read by DBReadObjects with one read on its own */
+static int
+check_object(DBfile *dbfile, char const *name, int type, void *obj)
+{
+    int i, nerrors = 0;
+
+    switch (type)
+    {
+        case DB_QUADVAR:
+        {
+            DBquadvar *a = (DBquadvar *) obj, *b = DBGetQuadvar(dbfile, name);
+            if (a->nels != b->nels || a->datatype != b->datatype ||
+                memcmp(a->vals[0], b->vals[0], a->nels * sizeof(double)))
+                nerrors++;
+            DBFreeQuadvar(b);
+            break;
+        }
+        case DB_QUADMESH:
+        case DB_QUADRECT:
+        {
+            DBquadmesh *a = (DBquadmesh *) obj, *b = DBGetQuadmesh(dbfile, name);
+            if (memcmp(a->coords[0], b->coords[0], NX * sizeof(float)) ||
+                memcmp(a->coords[1], b->coords[1], NY * sizeof(float)))
+                nerrors++;
+            DBFreeQuadmesh(b);
+            break;
+        }
+        case DB_UCDMESH:
+        {
+            DBucdmesh *a = (DBucdmesh *) obj, *b = DBGetUcdmesh(dbfile, name);
+            if (a->nnodes != b->nnodes || !a->zones ||
+                a->zones->lnodelist != b->zones->lnodelist ||
+                memcmp(a->coords[0], b->coords[0], a->nnodes * sizeof(float)) ||
+                memcmp(a->coords[1], b->coords[1], a->nnodes * sizeof(float)) ||
+                memcmp(a->zones->nodelist, b->zones->nodelist, a->zones->lnodelist * sizeof(int)))
+                nerrors++;
+            DBFreeUcdmesh(b);
+            break;
+        }
+        case DB_UCDVAR:
+        {
+            DBucdvar *a = (DBucdvar *) obj, *b = DBGetUcdvar(dbfile, name);
+            if (a->nels != b->nels ||
+                memcmp(a->vals[0], b->vals[0], a->nels * sizeof(float)))
+                nerrors++;
+            DBFreeUcdvar(b);
+            break;
+        }
+        case DB_MATERIAL:
+        {
+            DBmaterial *a = (DBmaterial *) obj, *b = DBGetMaterial(dbfile, name);
+            for (i = 0; i < (NX-1)*(NY-1); i++)
+                if (a->matlist[i] != b->matlist[i]) nerrors++;
+            DBFreeMaterial(b);
+            break;
+        }
+        case DB_CURVE:
+        {
+            DBcurve *a = (DBcurve *) obj, *b = DBGetCurve(dbfile, name);
+            if (a->npts != b->npts ||
+                memcmp(a->y, b->y, a->npts * sizeof(float)))
+                nerrors++;
+            DBFreeCurve(b);
+            break;
+        }
+        default:
+            fprintf(stderr, "unexpected type %d for \"%s\"\n", type, name);
+            nerrors++;
+    }
+
+    if (nerrors)
+        fprintf(stderr, "\"%s\" from DBReadObjects differs\n", name);
+    return nerrors;
+}
+
+/* Read the objects in batches with a range of gaps and compare */
+static int
+check_file(char const *filename)
+{
+    int            i, g, n, nerrors = 0;
+    char const    *names[] = {"qvar3", "umesh", "qvar0", "curve", "qvar5", "mat",
+                              "uvar", "qvar1", "qmesh", "qvar4", "nosuchobj", "qvar2",
+                              "sub/qvar0", "sub/umesh", "sub/qvar2", "/sub/mat"};
+    int const      nobjs = sizeof(names) / sizeof(names[0]);
+    int            types[sizeof(names) / sizeof(names[0])];
+    void          *objs[sizeof(names) / sizeof(names[0])];
+    int const      gaps[] = {-1, 0, 1<<20};
+    DBfile        *dbfile;
+
+    dbfile = DBOpen(filename, DB_UNKNOWN, DB_READ);
+    for (g = 0; g < (int) (sizeof(gaps)/sizeof(gaps[0])); g++)
+    {
+        n = DBReadObjects(dbfile, nobjs, names, gaps[g], types, objs);
+        if (n != nobjs - 1)
+        {
+            fprintf(stderr, "DBReadObjects read %d objects, expected %d\n", n, nobjs - 1);
+            nerrors++;
+            if (n < 0)
+                continue;
+        }
+        for (i = 0; i < nobjs; i++)
+        {
+            if (!strcmp(names[i], "nosuchobj"))
+            {
+                if (objs[i] || types[i] != DB_INVALID_OBJECT)
+                {
+                    fprintf(stderr, "unexpected object for \"%s\"\n", names[i]);
+                    nerrors++;
+                }
+            }
+            else if (!objs[i])
+            {
+                fprintf(stderr, "unable to read \"%s\"\n", names[i]);
+                nerrors++;
+            }
+            else
+            {
+                nerrors += check_object(dbfile, names[i], types[i], objs[i]);
+            }
+        }
+        DBFreeObjects(nobjs, types, objs);
+    }
+    DBClose(dbfile);
+
+    return nerrors;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Test reading many objects in one DBReadObjects call.
+ *
+ * Return:      0 on success, 1 on failure
+ *-------------------------------------------------------------------------
+ */
+int
+main(int argc, char *argv[])
+{
+    int            i, nerrors = 0;
+    int            driver = DB_PDB;
+    int            show_all_errors = FALSE;
+    char          *filename = "readobjects.pdb";
+
+    for (i=1; i<argc; i++) {
+        if (!strncmp(argv[i], "DB_PDB", 6)) {
+            driver = StringToDriver(argv[i]);
+            filename = "readobjects.pdb";
+        } else if (!strncmp(argv[i], "DB_HDF5", 7)) {
+            driver = StringToDriver(argv[i]);
+            filename = "readobjects.h5";
+        } else if (!strcmp(argv[i], "show-all-errors")) {
+            show_all_errors = 1;
+        } else if (argv[i][0] != '\0') {
+            fprintf(stderr, "%s: ignored argument `%s'\n", argv[0], argv[i]);
+        }
+    }
+
+    DBShowErrors(show_all_errors?DB_ALL_AND_DRVR:DB_NONE, NULL);
+
+    write_file(filename, driver);
+
+    nerrors += check_file(filename);
+
+#ifdef HAVE_HDF5_H
+    /* Batch reads of a file which starts with a userblock */
+    if (driver != DB_PDB)
+    {
+        hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+        hid_t fcpl = H5Pcreate(H5P_FILE_CREATE);
+        DBoptlist *opts = DBMakeOptlist(2);
+        int opts_id;
+
+        H5Pset_fapl_sec2(fapl);
+        H5Pset_userblock(fcpl, 512);
+        DBAddOption(opts, DBOPT_H5_FAPL_HID_T, &fapl);
+        DBAddOption(opts, DBOPT_H5_FCPL_HID_T, &fcpl);
+        opts_id = DBRegisterFileOptionsSet(opts);
+        write_file("readobjects_ub.h5", DB_HDF5_OPTS(opts_id));
+        nerrors += check_file("readobjects_ub.h5");
+        DBUnregisterFileOptionsSet(opts_id);
+        DBFreeOptlist(opts);
+        H5Pclose(fcpl);
+        H5Pclose(fapl);
+    }
+#endif
+
+    /* Batch reads of a file with friendly names written in place, whose
+       objects refer to their data by names relative to their directories */
+    if (driver != DB_PDB)
+    {
+        DBSetFriendlyHDF5Names(2);
+        write_file("readobjects_fn.h5", driver);
+        DBSetFriendlyHDF5Names(0);
+        nerrors += check_file("readobjects_fn.h5");
+    }
+
+    CleanupDriverStuff();
+    return nerrors > 0;
+}
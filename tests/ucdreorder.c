@@ -0,0 +1,392 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <silo.h>
+
+#include <std.c>
+
+#define NX 14
+#define NNODES ((NX+1)*(NX+1)*(NX+1))
+#define NZONES (NX*NX*NX)
+#define LO_GHOST 3
+#define HI_GHOST 5
+
+static unsigned int seed = 1357;
+
+static int
+irand(int n)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (int) ((seed >> 8) % (unsigned) n);
+}
+
+/* Random permutation of [lo,hi) into p[lo,hi) */
+static void
+shuffle(int *p, int lo, int hi)
+{
+    int i;
+    for (i = lo; i < hi; i++)
+        p[i] = i;
+    for (i = hi - 1; i > lo; i--)
+    {
+        int j = lo + irand(i - lo + 1), t = p[i];
+        p[i] = p[j];
+        p[j] = t;
+    }
+}
+
+/* Total spread of node numbers within the zones */
+static long
+spread(int const *nodelist)
+{
+    int z, k;
+    long sum = 0;
+    for (z = 0; z < NZONES; z++)
+    {
+        int lo = NNODES, hi = -1;
+        for (k = 0; k < 8; k++)
+        {
+            int n = nodelist[8*z+k];
+            if (n < lo) lo = n;
+            if (n > hi) hi = n;
+        }
+        sum += hi - lo;
+    }
+    return sum;
+}
+
+static int
+is_perm(int const *p, int n)
+{
+    int i, ok = 1;
+    char *seen = (char *) calloc(n, 1);
+    for (i = 0; i < n && ok; i++)
+    {
+        if (p[i] < 0 || p[i] >= n || seen[p[i]])
+            ok = 0;
+        else
+            seen[p[i]] = 1;
+    }
+    free(seen);
+    return ok;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int            i, j, k, m, nerrors = 0;
+    int            driver = DB_PDB;
+    char          *filename = "ucdreorder.pdb";
+    int            show_all_errors = FALSE;
+    DBfile        *dbfile;
+    double        *coords[3], *nval, *zval, mix_vf[4];
+    int           *nodelist, *nodeid, *zoneid, *gnodeno, *matlist;
+    int            shapetype = DB_ZONETYPE_HEX, shapesize = 8, shapecnt = NZONES;
+    int            matnos[2] = {1, 2}, mix_next[4] = {2, 0, 4, 0};
+    int            mix_mat[4] = {1, 2, 1, 2}, mix_zone[4], mixed[2];
+    int            methods[2] = {DB_SORT_RCM, DB_SORT_MORTON}, dims, one = 1;
+    int            nnodes = NNODES;
+    char const    *mnames[2] = {"rcm", "morton"};
+    char          *coordnames[3] = {"x", "y", "z"};
+    long           spread0;
+
+    for (i=1; i<argc; i++) {
+        if (!strncmp(argv[i], "DB_PDB", 6)) {
+            driver = StringToDriver(argv[i]);
+            filename = "ucdreorder.pdb";
+        } else if (!strncmp(argv[i], "DB_HDF5", 7)) {
+            driver = StringToDriver(argv[i]);
+            filename = "ucdreorder.h5";
+        } else if (!strcmp(argv[i], "show-all-errors")) {
+            show_all_errors = 1;
+        } else if (argv[i][0] != '\0') {
+            fprintf(stderr, "%s: ignored argument `%s'\n", argv[0], argv[i]);
+        }
+    }
+
+    DBShowErrors(show_all_errors?DB_ALL_AND_DRVR:DB_ABORT, NULL);
+
+    /* A hex mesh with its nodes numbered at random and its real zones in
+       random order. The first LO_GHOST and last HI_GHOST zones are ghosts. */
+    nodeid = (int *) malloc(NNODES * sizeof(int));
+    zoneid = (int *) malloc(NZONES * sizeof(int));
+    shuffle(nodeid, 0, NNODES);
+    shuffle(zoneid, 0, LO_GHOST);
+    shuffle(zoneid, LO_GHOST, NZONES - HI_GHOST);
+    shuffle(zoneid, NZONES - HI_GHOST, NZONES);
+    for (i = 0; i < 3; i++)
+        coords[i] = (double *) malloc(NNODES * sizeof(double));
+    nval = (double *) malloc(NNODES * sizeof(double));
+    gnodeno = (int *) malloc(NNODES * sizeof(int));
+    for (k = 0; k <= NX; k++)
+        for (j = 0; j <= NX; j++)
+            for (i = 0; i <= NX; i++)
+            {
+                int n = nodeid[(k*(NX+1)+j)*(NX+1)+i];
+                coords[0][n] = i;
+                coords[1][n] = j;
+                coords[2][n] = k;
+                nval[n] = i + 100 * j + 10000 * k;
+                gnodeno[n] = 5000 + n;
+            }
+    nodelist = (int *) malloc(8 * NZONES * sizeof(int));
+    zval = (double *) malloc(NZONES * sizeof(double));
+    matlist = (int *) malloc(NZONES * sizeof(int));
+    for (k = 0; k < NX; k++)
+        for (j = 0; j < NX; j++)
+            for (i = 0; i < NX; i++)
+            {
+                int z = zoneid[(k*NX+j)*NX+i], *nl = nodelist + 8 * z;
+                int n0 = (k*(NX+1)+j)*(NX+1)+i, sj = NX+1, sk = (NX+1)*(NX+1);
+                nl[0] = nodeid[n0];       nl[1] = nodeid[n0+1];
+                nl[2] = nodeid[n0+sj+1];  nl[3] = nodeid[n0+sj];
+                nl[4] = nodeid[n0+sk];    nl[5] = nodeid[n0+sk+1];
+                nl[6] = nodeid[n0+sk+sj+1]; nl[7] = nodeid[n0+sk+sj];
+                zval[z] = z;
+                matlist[z] = i < NX/2 ? 1 : 2;
+            }
+    mixed[0] = 17;
+    mixed[1] = NZONES / 2;
+    for (i = 0; i < 2; i++)
+    {
+        matlist[mixed[i]] = -(2*i+1);
+        mix_zone[2*i] = mix_zone[2*i+1] = mixed[i] + 1;
+        mix_vf[2*i] = 0.25;
+        mix_vf[2*i+1] = 0.75;
+    }
+    spread0 = spread(nodelist);
+
+    dbfile = DBCreate(filename, DB_CLOBBER, DB_LOCAL, "ucd mesh reordering test", driver);
+    for (m = 0; m < 2; m++)
+    {
+        int *nperm = 0, *zperm = 0;
+        long sp;
+        int *pnl;
+        DBoptlist *ol = DBMakeOptlist(6);
+        char mesh[32], zl[32], nv[32], zv[32], mat[32];
+
+        if (DBCalcUcdmeshReorder(methods[m], 3, NNODES, (DBVCP2_t) coords, DB_DOUBLE,
+                NZONES, nodelist, 8 * NZONES, 0, LO_GHOST, HI_GHOST, &shapetype,
+                &shapesize, &shapecnt, 1, &nperm, &zperm) < 0 ||
+            !is_perm(nperm, NNODES) || !is_perm(zperm, NZONES))
+        {
+            fprintf(stderr, "%s: bad permutations\n", mnames[m]);
+            nerrors++;
+            continue;
+        }
+        for (i = 0; i < NZONES; i++)
+        {
+            int g = i < LO_GHOST ? 0 : (i >= NZONES - HI_GHOST ? 2 : 1);
+            int gp = zperm[i] < LO_GHOST ? 0 : (zperm[i] >= NZONES - HI_GHOST ? 2 : 1);
+            if (g != gp)
+            {
+                fprintf(stderr, "%s: zone %d moved across a ghost range\n", mnames[m], zperm[i]);
+                nerrors++;
+                break;
+            }
+        }
+
+        /* The reordering should bring the nodes of each zone closer */
+        {
+            int *inv = (int *) malloc(NNODES * sizeof(int));
+            pnl = (int *) malloc(8 * NZONES * sizeof(int));
+            for (i = 0; i < NNODES; i++)
+                inv[nperm[i]] = i;
+            for (i = 0; i < NZONES; i++)
+                for (k = 0; k < 8; k++)
+                    pnl[8*i+k] = inv[nodelist[8*zperm[i]+k]];
+            sp = spread(pnl);
+            free(inv);
+        }
+        if (sp * 4 > spread0)
+        {
+            fprintf(stderr, "%s: node spread %ld, was %ld\n", mnames[m], sp, spread0);
+            nerrors++;
+        }
+
+        /* Write the mesh in the new order */
+        sprintf(mesh, "%s_mesh", mnames[m]);
+        sprintf(zl, "%s_zl", mnames[m]);
+        sprintf(nv, "%s_nv", mnames[m]);
+        sprintf(zv, "%s_zv", mnames[m]);
+        sprintf(mat, "%s_mat", mnames[m]);
+        DBAddOption(ol, DBOPT_NODE_PERM, nperm);
+        DBAddOption(ol, DBOPT_ZONE_PERM, zperm);
+        DBAddOption(ol, DBOPT_NNODES, &nnodes);
+        DBPutZonelist2(dbfile, zl, NZONES, 3, nodelist, 8 * NZONES, 0, LO_GHOST,
+            HI_GHOST, &shapetype, &shapesize, &shapecnt, 1, ol);
+        DBAddOption(ol, DBOPT_NODENUM, gnodeno);
+        DBPutUcdmesh(dbfile, mesh, 3, (char const * const *) coordnames,
+            (DBVCP2_t) coords, NNODES, NZONES, zl, 0, DB_DOUBLE, ol);
+        DBPutUcdvar1(dbfile, nv, mesh, nval, NNODES, 0, 0, DB_DOUBLE, DB_NODECENT, ol);
+        DBPutUcdvar1(dbfile, zv, mesh, zval, NZONES, 0, 0, DB_DOUBLE, DB_ZONECENT, ol);
+        dims = NZONES;
+        DBAddOption(ol, DBOPT_ORIGIN, &one);
+        DBPutMaterial(dbfile, mat, mesh, 2, matnos, matlist, &dims, 1, mix_next,
+            mix_mat, mix_zone, mix_vf, 4, DB_DOUBLE, ol);
+        DBFreeOptlist(ol);
+        free(pnl);
+        free(nperm);
+        free(zperm);
+    }
+    DBClose(dbfile);
+
+    /* Read it back and check it against the original mesh */
+    dbfile = DBOpen(filename, DB_UNKNOWN, DB_READ);
+    for (m = 0; m < 2 && !nerrors; m++)
+    {
+        char name[64];
+        DBucdmesh *um;
+        DBzonelist *zl;
+        DBucdvar *nv, *zv;
+        DBmaterial *mat;
+        int *nperm, *zperm;
+
+        sprintf(name, "%s_mesh", mnames[m]);
+        um = DBGetUcdmesh(dbfile, name);
+        sprintf(name, "%s_zl", mnames[m]);
+        zl = DBGetZonelist(dbfile, name);
+        sprintf(name, "%s_nv", mnames[m]);
+        nv = DBGetUcdvar(dbfile, name);
+        sprintf(name, "%s_zv", mnames[m]);
+        zv = DBGetUcdvar(dbfile, name);
+        sprintf(name, "%s_mat", mnames[m]);
+        mat = DBGetMaterial(dbfile, name);
+        if (!um || !zl || !nv || !zv || !mat ||
+            !um->alt_nodenum_vars || !zl->alt_zonenum_vars)
+        {
+            fprintf(stderr, "%s: objects missing\n", mnames[m]);
+            nerrors++;
+            break;
+        }
+        nperm = (int *) DBGetVar(dbfile, um->alt_nodenum_vars[0]);
+        zperm = (int *) DBGetVar(dbfile, zl->alt_zonenum_vars[0]);
+        if (!nperm || !zperm || !is_perm(nperm, NNODES) || !is_perm(zperm, NZONES))
+        {
+            fprintf(stderr, "%s: stored permutations missing\n", mnames[m]);
+            nerrors++;
+            break;
+        }
+
+        for (i = 0; i < NNODES; i++)
+        {
+            int n = nperm[i];
+            if (((double *) um->coords[0])[i] != coords[0][n] ||
+                ((double *) um->coords[2])[i] != coords[2][n] ||
+                ((double *) nv->vals[0])[i] != nval[n] ||
+                ((int *) um->gnodeno)[i] != gnodeno[n])
+            {
+                fprintf(stderr, "%s: node %d does not match\n", mnames[m], n);
+                nerrors++;
+                break;
+            }
+        }
+        for (i = 0; i < NZONES; i++)
+        {
+            int z = zperm[i];
+            if (((double *) zv->vals[0])[i] != z)
+            {
+                fprintf(stderr, "%s: zone %d value does not match\n", mnames[m], z);
+                nerrors++;
+                break;
+            }
+            for (k = 0; k < 8; k++)
+                if (nperm[zl->nodelist[8*i+k]] != nodelist[8*z+k])
+                    break;
+            if (k < 8)
+            {
+                fprintf(stderr, "%s: zone %d nodes do not match\n", mnames[m], z);
+                nerrors++;
+                break;
+            }
+            if (matlist[z] >= 0 ? mat->matlist[i] != matlist[z] :
+                (mat->matlist[i] >= 0 ||
+                 mat->mix_zone[-mat->matlist[i]-1] != i + 1))
+            {
+                fprintf(stderr, "%s: zone %d material does not match\n", mnames[m], z);
+                nerrors++;
+                break;
+            }
+        }
+        if (!um->zones || um->zones->min_index != LO_GHOST ||
+            um->zones->max_index != NZONES - HI_GHOST - 1)
+        {
+            fprintf(stderr, "%s: ghost zone range changed\n", mnames[m]);
+            nerrors++;
+        }
+
+        free(nperm);
+        free(zperm);
+        DBFreeUcdmesh(um);
+        DBFreeZonelist(zl);
+        DBFreeUcdvar(nv);
+        DBFreeUcdvar(zv);
+        DBFreeMaterial(mat);
+    }
+    DBClose(dbfile);
+
+    for (i = 0; i < 3; i++)
+        free(coords[i]);
+    free(nval);
+    free(zval);
+    free(gnodeno);
+    free(nodelist);
+    free(nodeid);
+    free(zoneid);
+    free(matlist);
+
+    CleanupDriverStuff();
+    return nerrors > 0;
+}
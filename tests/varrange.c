@@ -0,0 +1,370 @@
+/*
+Copyright (C) 1994-2016 Lawrence Livermore National Security, LLC.
+LLNL-CODE-425250.
+All rights reserved.
+
+This file is part of Silo. For details, see silo.llnl.gov.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the disclaimer below.
+   * Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the disclaimer (as noted
+     below) in the documentation and/or other materials provided with
+     the distribution.
+   * Neither the name of the LLNS/LLNL nor the names of its
+     contributors may be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE  IS PROVIDED BY  THE COPYRIGHT HOLDERS  AND CONTRIBUTORS
+"AS  IS" AND  ANY EXPRESS  OR IMPLIED  WARRANTIES, INCLUDING,  BUT NOT
+LIMITED TO, THE IMPLIED  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A  PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN  NO  EVENT SHALL  LAWRENCE
+LIVERMORE  NATIONAL SECURITY, LLC,  THE U.S.  DEPARTMENT OF  ENERGY OR
+CONTRIBUTORS BE LIABLE FOR  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR  CONSEQUENTIAL DAMAGES  (INCLUDING, BUT NOT  LIMITED TO,
+PROCUREMENT OF  SUBSTITUTE GOODS  OR SERVICES; LOSS  OF USE,  DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER  IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING
+NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT  OF THE USE  OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This work was produced at Lawrence Livermore National Laboratory under
+Contract  No.   DE-AC52-07NA27344 with  the  DOE.  Neither the  United
+States Government  nor Lawrence  Livermore National Security,  LLC nor
+any of  their employees,  makes any warranty,  express or  implied, or
+assumes   any   liability   or   responsibility  for   the   accuracy,
+completeness, or usefulness of any information, apparatus, product, or
+process  disclosed, or  represents  that its  use  would not  infringe
+privately-owned   rights.  Any  reference   herein  to   any  specific
+commercial products,  process, or  services by trade  name, trademark,
+manufacturer or otherwise does not necessarily constitute or imply its
+endorsement,  recommendation,   or  favoring  by   the  United  States
+Government or Lawrence Livermore National Security, LLC. The views and
+opinions  of authors  expressed  herein do  not  necessarily state  or
+reflect those  of the United  States Government or  Lawrence Livermore
+National  Security, LLC,  and shall  not  be used  for advertising  or
+product endorsement purposes.
+*/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <silo.h>
+
+#include <std.c>
+
+#define NX 40
+#define NY 30
+#define NZ 20
+#define NU 200000
+#define GHOST 1.0e6
+
+/* Brute force min/max of the box [lo,hi] of a NX*NY*NZ array */
+static void
+box_range(double const *a, int const *lo, int const *hi, double *mn, double *mx)
+{
+    int i, j, k;
+    *mn = HUGE_VAL;
+    *mx = -HUGE_VAL;
+    for (k = lo[2]; k <= hi[2]; k++)
+        for (j = lo[1]; j <= hi[1]; j++)
+            for (i = lo[0]; i <= hi[0]; i++)
+            {
+                double v = a[(k*NY+j)*NX+i];
+                if (isnan(v)) continue;
+                if (v < *mn) *mn = v;
+                if (v > *mx) *mx = v;
+            }
+}
+
+static int
+check_range(char const *name, int has_range, double mn, double mx,
+    int expect_range, double emn, double emx)
+{
+    if (has_range != expect_range)
+    {
+        fprintf(stderr, "%s: has_range %d, expected %d\n", name, has_range, expect_range);
+        return 1;
+    }
+    if (expect_range && (mn != emn || mx != emx))
+    {
+        fprintf(stderr, "%s: range [%g,%g], expected [%g,%g]\n", name, mn, mx, emn, emx);
+        return 1;
+    }
+    return 0;
+}
+
+static int
+check_quadvar(DBfile *dbfile, char const *name, int expect_range, double emn, double emx)
+{
+    int nerrors;
+    DBquadvar *qv = DBGetQuadvar(dbfile, name);
+    if (!qv)
+    {
+        fprintf(stderr, "unable to read \"%s\"\n", name);
+        return 1;
+    }
+    nerrors = check_range(name, qv->has_range, qv->min_value, qv->max_value,
+        expect_range, emn, emx);
+    DBFreeQuadvar(qv);
+    return nerrors;
+}
+
+static int
+check_ucdvar(DBfile *dbfile, char const *name, int expect_range, double emn, double emx)
+{
+    int nerrors;
+    DBucdvar *uv = DBGetUcdvar(dbfile, name);
+    if (!uv)
+    {
+        fprintf(stderr, "unable to read \"%s\"\n", name);
+        return 1;
+    }
+    nerrors = check_range(name, uv->has_range, uv->min_value, uv->max_value,
+        expect_range, emn, emx);
+    DBFreeUcdvar(uv);
+    return nerrors;
+}
+
+static int
+check_extents(DBfile *dbfile, char const *name, double const *emin, double const *emax)
+{
+    int i, nerrors = 0;
+    DBquadmesh *qm = DBGetQuadmesh(dbfile, name);
+    if (!qm)
+    {
+        fprintf(stderr, "unable to read \"%s\"\n", name);
+        return 1;
+    }
+    for (i = 0; i < qm->ndims; i++)
+    {
+        double mn = qm->datatype == DB_DOUBLE ? ((double*)qm->min_extents)[i] : qm->min_extents[i];
+        double mx = qm->datatype == DB_DOUBLE ? ((double*)qm->max_extents)[i] : qm->max_extents[i];
+        if (mn != emin[i] || mx != emax[i])
+        {
+            fprintf(stderr, "%s: extents[%d] [%g,%g], expected [%g,%g]\n",
+                name, i, mn, mx, emin[i], emax[i]);
+            nerrors++;
+        }
+    }
+    DBFreeQuadmesh(qm);
+    return nerrors;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Test that mesh extents and variable data ranges computed
+ *              at write time exclude ghosts and NaNs.
+ *
+ * Return:      0 on success, 1 on failure
+ *-------------------------------------------------------------------------
+ */
+int
+main(int argc, char *argv[])
+{
+    int            i, j, k, nerrors = 0;
+    int            driver = DB_PDB;
+    int            show_all_errors = FALSE;
+    char          *filename = "varrange.pdb";
+    int            dims[3] = {NX, NY, NZ}, zdims[3] = {NX-1, NY-1, NZ-1};
+    int            lo[3] = {2, 3, 1}, hi[3] = {1, 2, 4};
+    int            flo[3] = {0, 0, 2}, fhi[3] = {0, 0, 3};
+    int            box_lo[3], box_hi[3];
+    int            nu = NU, ulo = 10, uhi = NU-20;
+    double         missing = -1.0;
+    double        *x, *y, *z, *nvals, *zvals, *uvals;
+    float         *fvals;
+    int           *ivals;
+    double         emin[3], emax[3], mn, mx, fmn, fmx;
+    void          *coords[3], *vars[2];
+    char const    *zvarnames[2] = {"zvar_a", "zvar_b"};
+    DBoptlist     *ol;
+    DBfile        *dbfile;
+
+    for (i=1; i<argc; i++) {
+        if (!strncmp(argv[i], "DB_PDB", 6)) {
+            driver = StringToDriver(argv[i]);
+            filename = "varrange.pdb";
+        } else if (!strncmp(argv[i], "DB_HDF5", 7)) {
+            driver = StringToDriver(argv[i]);
+            filename = "varrange.h5";
+        } else if (!strcmp(argv[i], "show-all-errors")) {
+            show_all_errors = 1;
+        } else if (argv[i][0] != '\0') {
+            fprintf(stderr, "%s: ignored argument `%s'\n", argv[0], argv[i]);
+        }
+    }
+
+    DBShowErrors(show_all_errors?DB_ALL_AND_DRVR:DB_ABORT, NULL);
+
+    /* Curvilinear coordinates with huge values in the ghosts */
+    x = (double *) malloc(NX*NY*NZ*sizeof(double));
+    y = (double *) malloc(NX*NY*NZ*sizeof(double));
+    z = (double *) malloc(NX*NY*NZ*sizeof(double));
+    nvals = (double *) malloc(NX*NY*NZ*sizeof(double));
+    zvals = (double *) malloc(NX*NY*NZ*sizeof(double));
+    fvals = (float *) malloc(NX*NY*NZ*sizeof(float));
+    ivals = (int *) malloc(NX*NY*NZ*sizeof(int));
+    uvals = (double *) malloc(NU*sizeof(double));
+    for (k = 0; k < NZ; k++)
+        for (j = 0; j < NY; j++)
+            for (i = 0; i < NX; i++)
+            {
+                int n = (k*NY+j)*NX+i;
+                int ghost = i < lo[0] || i > NX-1-hi[0] ||
+                            j < lo[1] || j > NY-1-hi[1] ||
+                            k < lo[2] || k > NZ-1-hi[2];
+                x[n] = ghost ? -GHOST : i + 0.5*sin(j+k);
+                y[n] = ghost ?  GHOST : j + 0.5*cos(i+k);
+                z[n] = k + 0.25*sin(i*j);
+                nvals[n] = ghost ? GHOST : sin(0.01*n) * (1 + 0.001*n);
+                fvals[n] = (float) (k >= flo[2] && k <= NZ-1-fhi[2] ? cos(0.02*n) : -GHOST);
+                ivals[n] = ghost ? -7 : (n * 7919) % 1000;
+            }
+    nvals[(5*NY+5)*NX+5] = NAN;
+    for (i = 0; i < NX*NY*NZ; i++)
+        zvals[i] = cos(0.003*i);
+    for (i = 0; i < NU; i++)
+        uvals[i] = i < ulo || i > uhi ? -GHOST : sin(0.0001*i);
+    uvals[150000] = 2.5;
+
+    dbfile = DBCreate(filename, DB_CLOBBER, DB_LOCAL, "var range test", driver);
+
+    coords[0] = x; coords[1] = y; coords[2] = z;
+    ol = DBMakeOptlist(3);
+    DBAddOption(ol, DBOPT_LO_OFFSET, lo);
+    DBAddOption(ol, DBOPT_HI_OFFSET, hi);
+    DBPutQuadmesh(dbfile, "cmesh", 0, coords, dims, 3, DB_DOUBLE, DB_NONCOLLINEAR, ol);
+
+    /* Collinear mesh, one coordinate array per dimension */
+    coords[0] = nvals + 1000; coords[1] = zvals; coords[2] = uvals;
+    DBPutQuadmesh(dbfile, "rmesh", 0, coords, dims, 3, DB_DOUBLE, DB_COLLINEAR, ol);
+
+    DBPutQuadvar1(dbfile, "nvar", "cmesh", nvals, dims, 3, 0, 0, DB_DOUBLE, DB_NODECENT, ol);
+    DBPutQuadvar1(dbfile, "ivar", "cmesh", ivals, dims, 3, 0, 0, DB_INT, DB_NODECENT, ol);
+    vars[0] = zvals; vars[1] = nvals;
+    DBPutQuadvar(dbfile, "zvar", "cmesh", 2, (DBCAS_t) zvarnames, vars, zdims, 3,
+        0, 0, DB_DOUBLE, DB_ZONECENT, ol);
+    DBFreeOptlist(ol);
+
+    /* Ghosts only in the slowest dimension make the box one long run */
+    ol = DBMakeOptlist(2);
+    DBAddOption(ol, DBOPT_LO_OFFSET, flo);
+    DBAddOption(ol, DBOPT_HI_OFFSET, fhi);
+    DBPutQuadvar1(dbfile, "fvar", "cmesh", fvals, dims, 3, 0, 0, DB_FLOAT, DB_NODECENT, ol);
+    DBFreeOptlist(ol);
+
+    ol = DBMakeOptlist(2);
+    DBAddOption(ol, DBOPT_LO_OFFSET, &ulo);
+    DBAddOption(ol, DBOPT_HI_OFFSET, &uhi);
+    DBPutUcdvar1(dbfile, "uvar", "umesh", uvals, nu, 0, 0, DB_DOUBLE, DB_ZONECENT, ol);
+    DBPutUcdvar1(dbfile, "unvar", "umesh", uvals, nu, 0, 0, DB_DOUBLE, DB_NODECENT, ol);
+    DBFreeOptlist(ol);
+
+    ol = DBMakeOptlist(1);
+    DBAddOption(ol, DBOPT_MISSING_VALUE, &missing);
+    DBPutUcdvar1(dbfile, "mvar", "umesh", uvals, nu, 0, 0, DB_DOUBLE, DB_ZONECENT, ol);
+    DBFreeOptlist(ol);
+
+    DBClose(dbfile);
+
+    dbfile = DBOpen(filename, DB_UNKNOWN, DB_READ);
+
+    for (i = 0; i < 3; i++)
+    {
+        box_lo[i] = lo[i];
+        box_hi[i] = dims[i] - 1 - hi[i];
+    }
+    box_range(x, box_lo, box_hi, &emin[0], &emax[0]);
+    box_range(y, box_lo, box_hi, &emin[1], &emax[1]);
+    box_range(z, box_lo, box_hi, &emin[2], &emax[2]);
+    nerrors += check_extents(dbfile, "cmesh", emin, emax);
+
+    emin[0] = emax[0] = nvals[1000+lo[0]];
+    for (i = lo[0]; i < NX-hi[0]; i++)
+    {
+        if (nvals[1000+i] < emin[0]) emin[0] = nvals[1000+i];
+        if (nvals[1000+i] > emax[0]) emax[0] = nvals[1000+i];
+    }
+    emin[1] = emax[1] = zvals[lo[1]];
+    for (i = lo[1]; i < NY-hi[1]; i++)
+    {
+        if (zvals[i] < emin[1]) emin[1] = zvals[i];
+        if (zvals[i] > emax[1]) emax[1] = zvals[i];
+    }
+    emin[2] = emax[2] = uvals[lo[2]];
+    for (i = lo[2]; i < NZ-hi[2]; i++)
+    {
+        if (uvals[i] < emin[2]) emin[2] = uvals[i];
+        if (uvals[i] > emax[2]) emax[2] = uvals[i];
+    }
+    nerrors += check_extents(dbfile, "rmesh", emin, emax);
+
+    box_range(nvals, box_lo, box_hi, &mn, &mx);
+    nerrors += check_quadvar(dbfile, "nvar", 1, mn, mx);
+
+    mn = HUGE_VAL; mx = -HUGE_VAL;
+    for (k = box_lo[2]; k <= box_hi[2]; k++)
+        for (j = box_lo[1]; j <= box_hi[1]; j++)
+            for (i = box_lo[0]; i <= box_hi[0]; i++)
+            {
+                int v = ivals[(k*NY+j)*NX+i];
+                if (v < mn) mn = v;
+                if (v > mx) mx = v;
+            }
+    nerrors += check_quadvar(dbfile, "ivar", 1, mn, mx);
+
+    for (i = 0; i < 3; i++)
+        box_hi[i] = zdims[i] - 1 - hi[i];
+    {
+        /* zone-centered components are zdims shaped */
+        double zmn = HUGE_VAL, zmx = -HUGE_VAL;
+        for (k = box_lo[2]; k <= box_hi[2]; k++)
+            for (j = box_lo[1]; j <= box_hi[1]; j++)
+                for (i = box_lo[0]; i <= box_hi[0]; i++)
+                {
+                    int n = (k*zdims[1]+j)*zdims[0]+i;
+                    double v[2] = {zvals[n], nvals[n]};
+                    int c;
+                    for (c = 0; c < 2; c++)
+                    {
+                        if (isnan(v[c])) continue;
+                        if (v[c] < zmn) zmn = v[c];
+                        if (v[c] > zmx) zmx = v[c];
+                    }
+                }
+        nerrors += check_quadvar(dbfile, "zvar", 1, zmn, zmx);
+    }
+
+    fmn = HUGE_VAL; fmx = -HUGE_VAL;
+    for (i = flo[2]*NX*NY; i < (NZ-fhi[2])*NX*NY; i++)
+    {
+        if (fvals[i] < fmn) fmn = fvals[i];
+        if (fvals[i] > fmx) fmx = fvals[i];
+    }
+    nerrors += check_quadvar(dbfile, "fvar", 1, fmn, fmx);
+
+    mn = HUGE_VAL; mx = -HUGE_VAL;
+    for (i = ulo; i <= uhi; i++)
+    {
+        if (uvals[i] < mn) mn = uvals[i];
+        if (uvals[i] > mx) mx = uvals[i];
+    }
+    nerrors += check_ucdvar(dbfile, "uvar", 1, mn, mx);
+    nerrors += check_ucdvar(dbfile, "unvar", 1, -GHOST, 2.5);
+    nerrors += check_ucdvar(dbfile, "mvar", 0, 0, 0);
+
+    DBClose(dbfile);
+
+    free(x); free(y); free(z);
+    free(nvals); free(zvals); free(fvals); free(ivals); free(uvals);
+
+    CleanupDriverStuff();
+    return nerrors > 0;
+}
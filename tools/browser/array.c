@@ -75,6 +75,7 @@ be used for advertising or product endorsement purposes.
 #include <assert.h>
 #include <browser.h>
 #include <ctype.h>
+#include <math.h>
 #include <stdint.h>
 #define MYCLASS(X)      ((obj_ary_t*)(X))
 
@@ -629,6 +630,91 @@ ary_walk1 (obj_t _self, void *mem, int operation, walk_t *wdata) {
 }
 
 
+/*
+ * Summary of the differences between two arrays of the same floating
+ * point type.
+ */
+typedef struct ary_diffsum_t {
+    int         ndiff;                  /*number of differing elements  */
+    int         first;                  /*first differing element       */
+    double      max_abs;                /*largest |A-B|                 */
+    double      max_rel;                /*largest |A-B|/max(|A|,|B|)    */
+} ary_diffsum_t;
+
+#define ARY_DIFF_BLOCK  1024            /*elements compared per block   */
+
+/*-------------------------------------------------------------------------
+ * Function:    ary_diff_float, ary_diff_double
+ *
+ * Purpose:     Compares N elements of A and B with the same tests as
+ *              DBIsDifferentDouble() and summarizes the differences in S.
+ *              The tests are written without branches so the compiler
+ *              can vectorize them.  Each block of elements is counted
+ *              first and only a block holding differences is walked again
+ *              to find the first difference and the largest ones.
+ *
+ * Return:      void
+ *
+ * Modifications:
+ *
+ *-------------------------------------------------------------------------
+ */
+#define ARY_DIFF_ELMT(X,Y,D) {                                                \
+    double x = (X), y = (Y);                                                  \
+    int    nan_x = x!=x, nan_y = y!=y, nan_xy = nan_x | nan_y;                \
+    int    opp = ((x<0) & (y>0)) | ((y<0) & (x>0));                           \
+    double h = opp ? 0.5 : 1.0;                                               \
+    double num = fabs(x*h - y*h);                                             \
+    double den_e = fabs(x*h) + fabs(y*h) + reltol_eps*h;                      \
+    double den_r = fabs(x*0.5 + y*0.5);                                       \
+    int    t_e = ((0.0==den_e) & (num!=0.0)) | (num/den_e > reltol*h);        \
+    int    t_a = num > abstol*h;                                              \
+    int    t_r = ((0.0==den_r) & (num!=0.0)) | (num/den_r > reltol*h);        \
+    int    t = (use_eps & t_e) | (use_abs & t_a) | (use_rel & t_r) |          \
+                (use_ne & (x!=y));                                            \
+    D = (nan_xy & (nan_x ^ nan_y)) | ((!nan_xy) & t);                         \
+}
+
+#define ARY_DIFF_FUNC(NAME,TYPE)                                              \
+static void                                                                   \
+NAME (TYPE const *a, TYPE const *b, int n, double abstol, double reltol,      \
+      double reltol_eps, ary_diffsum_t *s) {                                  \
+    int    use_eps = reltol_eps>=0 && reltol>0;                               \
+    int    use_abs = !use_eps && abstol>0;                                    \
+    int    use_rel = !use_eps && reltol>0;                                    \
+    int    use_ne = !use_eps && !use_abs && !use_rel;                         \
+    int    i, j, d, cnt;                                                      \
+                                                                              \
+    s->ndiff = 0;                                                             \
+    s->first = -1;                                                            \
+    s->max_abs = 0.0;                                                         \
+    s->max_rel = 0.0;                                                         \
+    for (i=0; i<n; i+=ARY_DIFF_BLOCK) {                                       \
+        int e = MIN(i+ARY_DIFF_BLOCK, n);                                     \
+        for (j=i, cnt=0; j<e; j++) {                                          \
+            ARY_DIFF_ELMT(a[j], b[j], d);                                     \
+            cnt += d;                                                         \
+        }                                                                     \
+        if (!cnt) continue;                                                   \
+        for (j=i; j<e; j++) {                                                 \
+            double da, big;                                                   \
+            ARY_DIFF_ELMT(a[j], b[j], d);                                     \
+            if (!d) continue;                                                 \
+            if (s->first<0) s->first = j;                                     \
+            if (a[j]!=a[j] || b[j]!=b[j]) continue;                           \
+            da = fabs((double)a[j] - (double)b[j]);                           \
+            big = MAX(fabs((double)a[j]), fabs((double)b[j]));                \
+            if (da > s->max_abs) s->max_abs = da;                             \
+            if (big > 0 && da/big > s->max_rel) s->max_rel = da/big;          \
+        }                                                                     \
+        s->ndiff += cnt;                                                      \
+    }                                                                         \
+}
+
+ARY_DIFF_FUNC(ary_diff_float, float)
+ARY_DIFF_FUNC(ary_diff_double, double)
+
+
 /*-------------------------------------------------------------------------
  * Function:    ary_walk2
  *
@@ -679,6 +765,9 @@ ary_walk2 (obj_t _a, void *a_mem, obj_t _b, void *b_mem, walk_t *wdata) {
     int         i, j, n, status, differ=0, oldlit;
     int         a_ndims=0, a_dim[NDIMS];
     int         b_ndims=0, b_dim[NDIMS];
+    int         have_mem = a_mem && b_mem;
+    DBdatatype  a_type, b_type;
+    ary_diffsum_t diffsum;
     out_t       *f = wdata->f;
     char        buf[256];
 
@@ -814,6 +903,43 @@ ary_walk2 (obj_t _a, void *a_mem, obj_t _b, void *b_mem, walk_t *wdata) {
         }
     }
 
+    /* Arrays of the same primitive type whose bytes are identical are
+     * the same.  Otherwise float and double arrays are compared in bulk
+     * and only walked element by element if they differ and the full
+     * difference is wanted. */
+    if (have_mem && a_total==b_total && a_nbytes==b_nbytes &&
+        a->sub && b->sub &&
+        C_PRIM==a->sub->pub.cls && C_PRIM==b->sub->pub.cls &&
+        DB_NOTYPE!=(a_type=prim_silotype(a->sub)) &&
+        (b_type=prim_silotype(b->sub))==a_type) {
+        if (0==memcmp(a_mem, b_mem, (size_t)a_total*a_nbytes)) return 0;
+        if (DB_FLOAT==a_type || DB_DOUBLE==a_type) {
+            if (DB_FLOAT==a_type) {
+                ary_diff_float((float*)a_mem, (float*)b_mem, a_total,
+                               DiffOpt.f_abs, DiffOpt.f_rel, DiffOpt.f_eps,
+                               &diffsum);
+            } else {
+                ary_diff_double((double*)a_mem, (double*)b_mem, a_total,
+                                DiffOpt.d_abs, DiffOpt.d_rel, DiffOpt.d_eps,
+                                &diffsum);
+            }
+            if (0==diffsum.ndiff) return 0;
+            switch (DiffOpt.report) {
+            case DIFF_REP_ALL:
+                break;
+            case DIFF_REP_BRIEF:
+                out_printf(f, "different value(s) [%d of %d; max abs %g; "
+                           "max rel %g; first at %d]", diffsum.ndiff,
+                           a_total, diffsum.max_abs, diffsum.max_rel,
+                           diffsum.first);
+                out_nl(f);
+                return 1;
+            case DIFF_REP_SUMMARY:
+                return 1;
+            }
+        }
+    }
+
     /* Only print array indices if we're doing a full difference. */
     if (DIFF_REP_ALL==DiffOpt.report) {
         elmtno = out_push_array(f, NULL, a_ndims, a->offset, a_dim);
@@ -1860,6 +1860,10 @@ stc_silo_types (void) {
       COMP (conserved,          "primitive 'int'");
       COMP (extensive,          "primitive 'int'");
       COMP (missing_value,      "primitive 'double'"); IOASSOC (PA_MISSING_VALUE);
+      COMP (has_range,          "primitive 'int'");
+      IOASSOC (PA_BOOLEAN);
+      COMP (min_value,          "primitive 'double'");
+      COMP (max_value,          "primitive 'double'");
       COMP (region_pnames,      "pointer (array 'SH5 0, self.region_pnames' (primitive 'string'))");
       COMP (mixvals,            "pointer (array 'self.nvals' (pointer (array 'self.mixlen' "
             "(primitive 'self.datatype'))))");
@@ -2107,6 +2111,10 @@ stc_silo_types (void) {
       COMP (extensive,          "primitive 'int'");
       COMP (missing_value,      "primitive 'double'");
       IOASSOC (PA_MISSING_VALUE);
+      COMP (has_range,          "primitive 'int'");
+      IOASSOC (PA_BOOLEAN);
+      COMP (min_value,          "primitive 'double'");
+      COMP (max_value,          "primitive 'double'");
       COMP (region_pnames,      "pointer (array 'SH5 0, self.region_pnames' (primitive 'string'))");
       COMP (vals,
             "pointer (array 'self.nvals' (pointer "
@@ -1,22 +1,75 @@
 #include <silo.h>
 
-#include <map>
 #include <string>
+#include <vector>
 #include <iostream>
 
 #include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
-using std::map;
 using std::string;
+using std::vector;
 using std::cout;
 using std::endl;
 using std::cerr;
 
-typedef map<string, string> strmap_t;
+//
+// stream_silo writes the zones of the ucd meshes in a Silo file, one
+// domain at a time, in one of two formats.
+//
+// --format text (the default) writes one line per zone for mapper.py,
+//
+//     <key>\t<nodes>|<coords>|<var>:<var>:...
+//
+// --format columnar writes record batches of typed arrays. All integers
+// are in the byte order of the writer, which is identified by the endian
+// marker in the file header, and everything is padded to 8 byte
+// boundaries.
+//
+//     file header   char[8] "SILOCOLS", int32 version (1),
+//                   int32 endian marker (0x01020304)
+//     batch         char[4] "SBAT", int32 kind (0 zones, 1 nodes),
+//                   int32 domain (-1 if none), int32 reserved (0),
+//                   int64 nrows, int32 ncols, int32 prefix length,
+//                   char[] mesh path, padded
+//     column        int32 type, int32 ncomp, int32 name length,
+//                   int32 reserved (0), int64 data bytes, char[] name,
+//                   padded, data as nrows x ncomp values, padded
+//     end           char[4] "SEND", int32 reserved (0)
+//
+// Column types are 1 int32, 2 int64, 3 float32 and 4 float64. Each domain
+// gets a zones batch with columns zoneid (int64 global zone number, or
+// the zone index when the zonelist has none), nnodes (int32) and nodes
+// (int32, padded with -1 to the largest zone) followed by a column per
+// component of each zone centered variable, named <var><comp>. It is
+// followed by a nodes batch with the columns x, y, z in the mesh's
+// datatype and a column per component of each node centered variable.
+//
+// Domains are read one batch at a time and the zones of the domains in a
+// batch are formatted in parallel when built with OpenMP.
+//
 
 #define ARG_OPT(A) (!strncmp(argv[i],#A,sizeof(#A)))
 
+#define COL_INT32    1
+#define COL_INT64    2
+#define COL_FLOAT32  3
+#define COL_FLOAT64  4
+
+// A mesh and the variables defined on it, read and waiting to be streamed
+typedef struct domain_t {
+    DBucdmesh *mesh;
+    vector<DBucdvar*> vars;
+    string prefix;
+    int dom;
+    string out;
+} domain_t;
+
 static void get_coord(DBucdmesh const *ucdm, int nid, double* x, double* y, double* z)
 {
     if (ucdm->datatype == DB_DOUBLE)
@@ -48,17 +101,23 @@ static unsigned long long get_zoneid(DBzonelist const *zl, int zidx)
         case DB_LONG_LONG: { long long *p = (long long *) zl->gzoneno; return (unsigned long long) p[zidx]; }
         default: assert(0);
     }
+    return (unsigned long long)-1;
 }
 
 static double get_var_value(void *vdata, int datatype, int idx)
 {
     switch (datatype)
     {
-        case DB_INT: {int *p = (int*)vdata; return p[idx];} 
-        case DB_FLOAT: {float *p = (float*)vdata; return p[idx];} 
-        case DB_DOUBLE: {double *p = (double*)vdata; return p[idx];} 
+        case DB_CHAR: {char *p = (char*)vdata; return p[idx];}
+        case DB_SHORT: {short *p = (short*)vdata; return p[idx];}
+        case DB_INT: {int *p = (int*)vdata; return p[idx];}
+        case DB_LONG: {long *p = (long*)vdata; return p[idx];}
+        case DB_LONG_LONG: {long long *p = (long long*)vdata; return p[idx];}
+        case DB_FLOAT: {float *p = (float*)vdata; return p[idx];}
+        case DB_DOUBLE: {double *p = (double*)vdata; return p[idx];}
         default: assert(0);
     }
+    return 0;
 }
 
 static string genkey(DBucdmesh const* ucdm, string const& prefix, int dom, int zidx)
@@ -68,205 +127,390 @@ static string genkey(DBucdmesh const* ucdm, string const& prefix, int dom, int z
     if (gzoneno != (unsigned long long)-1)
     {
         if (dom == -1)
-            sprintf(tmp, "%llx:%d", gzoneno, zidx);
+            snprintf(tmp, sizeof(tmp), "%llx:%d", gzoneno, zidx);
         else
-            sprintf(tmp, "%llx:%d:%d", gzoneno, dom, zidx);
+            snprintf(tmp, sizeof(tmp), "%llx:%d:%d", gzoneno, dom, zidx);
     }
     else
     {
         if (dom == -1)
-            sprintf(tmp, "%d", zidx);
+            snprintf(tmp, sizeof(tmp), "%d", zidx);
         else
-            sprintf(tmp, "%d:%d", dom, zidx);
+            snprintf(tmp, sizeof(tmp), "%d:%d", dom, zidx);
     }
-    string zkey = prefix + ":" + string(tmp); 
+    string zkey = prefix + ":" + string(tmp);
     return zkey;
 }
 
-static double retvals[256];
-static double *get_var_values(void **vdata, int nvars, int datatype, int idx)
+static void append_var_values(DBucdvar const *ucdv, int idx, string& line)
 {
-    for (int i = 0; i < nvars; i++)
-        retvals[i] = get_var_value(vdata[i], datatype, idx);
-    return retvals;
+    for (int j = 0; j < ucdv->nvals; j++)
+    {
+        char tmp[256];
+        snprintf(tmp, sizeof(tmp), "%s%1d=%f", ucdv->name, j,
+            get_var_value(ucdv->vals[j], ucdv->datatype, idx));
+        line += tmp;
+        if (j < ucdv->nvals-1) line += ";";
+    }
 }
 
-static void stream_ucdvar(DBucdmesh const *ucdm, DBucdvar const *ucdv, string const& prefix, int dom, strmap_t& fmap)
+//
+// Format one zone as a line of text. The nodes and coordinates sections
+// come from the mesh, then each variable adds its values for the zone,
+// or for each of the zone's nodes.
+//
+static void stream_zone_text(domain_t const& d, int zidx, int const *nodes, int nnodes, string& line)
 {
-    if (ucdv->centering == DB_ZONECENT)
+    char tmp[256];
+
+    line = genkey(d.mesh, d.prefix, d.dom, zidx);
+    line += "\t";
+
+    // nodes  section (probaly not necessary)
+    for (int k = 0; k < nnodes; k++)
     {
-        for (int i = 0; i < ucdm->zones->nzones; i++)
-        {
-            string zkey = genkey(ucdm, prefix, dom, i);
-            double *vals = get_var_values(ucdv->vals, ucdv->nvals, ucdv->datatype, i);
-            for (int j = 0; j < ucdv->nvals; j++)
-            {
-                char tmp[256];
-                sprintf(tmp, "%s%1d=%f", ucdv->name, j, vals[j]);
-                fmap[zkey] += string(tmp);
-                if (j < ucdv->nvals-1) fmap[zkey] += ";";
-            }
-            fmap[zkey] += ":";
-        }
+        snprintf(tmp, sizeof(tmp), "n%1d=%d", k, nodes[k]);
+        line += tmp;
+        if (k < nnodes-1) line += ":";
+    }
+    line += "|";
+
+    // coordinates section
+    for (int k = 0; k < nnodes; k++)
+    {
+        double x, y, z;
+        get_coord(d.mesh, nodes[k], &x, &y, &z);
+        snprintf(tmp, sizeof(tmp), "x%1d=%f$y%1d=%f$z%1d=%f", k, x, k, y, k, z);
+        line += tmp;
+        if (k < nnodes-1) line += ":";
     }
-    else if (ucdv->centering == DB_NODECENT)
+    line += "|";
+
+    // variables section
+    for (size_t v = 0; v < d.vars.size(); v++)
     {
-        int zlidx = 0;
-        int zidx = 0;
-        DBzonelist const *zl = ucdm->zones;
-        for (int i = 0; i < zl->nshapes; i++)
+        DBucdvar const *ucdv = d.vars[v];
+        if (ucdv->centering == DB_ZONECENT)
         {
-            const int shapecnt = zl->shapecnt[i];
-            const int shapesize = zl->shapesize[i];
-            const int shapetype = zl->shapetype[i];
-            for (int j = 0; j < shapecnt; j++)
+            append_var_values(ucdv, zidx, line);
+        }
+        else
+        {
+            for (int k = 0; k < nnodes; k++)
             {
-                char tmp[256];
-                string zkey = genkey(ucdm, prefix, dom, zidx);
-                for (int k = 0; k < shapesize; k++)
-                {
-                    int nodeid = zl->nodelist[zlidx+k];
-                    double *vals = get_var_values(ucdv->vals, ucdv->nvals, ucdv->datatype, nodeid);
-                    for (int j = 0; j < ucdv->nvals; j++)
-                    {
-                        char tmp[256];
-                        sprintf(tmp, "%s%1d=%f", ucdv->name, j, vals[j]);
-                        fmap[zkey] += string(tmp);
-                        if (j < ucdv->nvals-1) fmap[zkey] += ";";
-                    }
-                    if (k < shapesize-1) fmap[zkey] += "$";
-                }
-                zlidx += shapesize;
-                zidx++;
-                fmap[zkey] += ":";
+                append_var_values(ucdv, nodes[k], line);
+                if (k < nnodes-1) line += "$";
             }
         }
+        line += ":";
     }
-    else
-    {
-        assert(0);
-    }
+    line += "\n";
 }
 
-static void stream_ucdmesh(DBucdmesh const *ucdm, string const& prefix, int dom, strmap_t& fmap)
+static void stream_domain_text(domain_t& d)
 {
+    DBzonelist const *zl = d.mesh->zones;
     int zlidx = 0;
     int zidx = 0;
-    DBzonelist const *zl = ucdm->zones;
+    string line;
+
     for (int i = 0; i < zl->nshapes; i++)
     {
         const int shapecnt = zl->shapecnt[i];
         const int shapesize = zl->shapesize[i];
-        const int shapetype = zl->shapetype[i];
         for (int j = 0; j < shapecnt; j++)
         {
-            // Zone key section
-            char tmp[256];
-            string zkey = genkey(ucdm, prefix, dom, zidx);
-            fmap[zkey] = "";
-            // nodes  section (probaly not necessary)
-            for (int k = 0; k < shapesize; k++)
-            {
-                int nodeid = zl->nodelist[zlidx+k];
-                sprintf(tmp, "n%1d=%d", k, nodeid);
-                fmap[zkey] += string(tmp);
-                if (k < shapesize-1) fmap[zkey] += ":";
-            }
-            fmap[zkey] += "|";
-            // coordinates section
-            for (int k = 0; k < shapesize; k++)
-            {
-                int nodeid = zl->nodelist[zlidx+k];
-                double x, y, z;
-                get_coord(ucdm, nodeid, &x, &y, &z);
-                sprintf(tmp, "x%1d=%f$y%1d=%f$z%1d=%f", k, x, k, y, k, z);
-                fmap[zkey] += string(tmp);
-                if (k < shapesize-1) fmap[zkey] += ":";
-            }
-            fmap[zkey] += "|";
+            stream_zone_text(d, zidx, zl->nodelist + zlidx, shapesize, line);
+            d.out += line;
             zlidx += shapesize;
             zidx++;
         }
     }
 }
 
-static void stream_cwdir(DBfile *dbfile, string prefix, int dom, strmap_t &fmap)
+static void put_bytes(string& out, void const *p, size_t n)
 {
-    DBtoc *toc = DBGetToc (dbfile);
+    out.append((char const *) p, n);
+}
+
+static void put_i32(string& out, int v)
+{
+    put_bytes(out, &v, sizeof(v));
+}
 
-    for (int i = 0; i < toc->nucdmesh; i++)
+static void put_i64(string& out, long long v)
+{
+    put_bytes(out, &v, sizeof(v));
+}
+
+static void put_pad(string& out)
+{
+    while (out.size() % 8)
+        out += '\0';
+}
+
+static int col_type(int datatype)
+{
+    switch (datatype)
     {
-        DBucdmesh *m = DBGetUcdmesh(dbfile, toc->ucdmesh_names[i]);
-        string newprefix = prefix + "/" + string(toc->ucdmesh_names[i]);
-        stream_ucdmesh(m, newprefix, dom, fmap);
-        long oldmask = DBGetDataReadMask();
-        for (int j = 0; j < toc->nucdvar; j++)
+        case DB_INT: return COL_INT32;
+        case DB_LONG_LONG: return COL_INT64;
+        case DB_FLOAT: return COL_FLOAT32;
+        case DB_DOUBLE: return COL_FLOAT64;
+        default: return 0;
+    }
+}
+
+static int col_size(int type)
+{
+    return type == COL_INT32 || type == COL_FLOAT32 ? 4 : 8;
+}
+
+static void put_column(string& out, char const *name, int type, int ncomp, long long nrows, void const *data)
+{
+    long long nbytes = nrows * ncomp * col_size(type);
+    int len = (int) strlen(name);
+
+    put_i32(out, type);
+    put_i32(out, ncomp);
+    put_i32(out, len);
+    put_i32(out, 0);
+    put_i64(out, nbytes);
+    put_bytes(out, name, len);
+    put_pad(out);
+    put_bytes(out, data, (size_t) nbytes);
+    put_pad(out);
+}
+
+static void put_batch_header(string& out, int kind, domain_t const& d, long long nrows, int ncols)
+{
+    put_bytes(out, "SBAT", 4);
+    put_i32(out, kind);
+    put_i32(out, d.dom);
+    put_i32(out, 0);
+    put_i64(out, nrows);
+    put_i32(out, ncols);
+    put_i32(out, (int) d.prefix.size());
+    put_bytes(out, d.prefix.data(), d.prefix.size());
+    put_pad(out);
+}
+
+static int count_var_columns(domain_t const& d, int centering)
+{
+    int ncols = 0;
+    for (size_t v = 0; v < d.vars.size(); v++)
+        if (d.vars[v]->centering == centering && col_type(d.vars[v]->datatype))
+            ncols += d.vars[v]->nvals;
+    return ncols;
+}
+
+static void put_var_columns(string& out, domain_t const& d, int centering, long long nrows)
+{
+    for (size_t v = 0; v < d.vars.size(); v++)
+    {
+        DBucdvar const *ucdv = d.vars[v];
+        int type = col_type(ucdv->datatype);
+        if (ucdv->centering != centering || !type) continue;
+        for (int j = 0; j < ucdv->nvals; j++)
         {
-            DBSetDataReadMask(DBNone); 
-            DBucdvar *v = DBGetUcdvar(dbfile, toc->ucdvar_names[j]);
-            if (!strcmp(v->meshname, toc->ucdmesh_names[i]))
-            {
-                DBFreeUcdvar(v);
-                DBSetDataReadMask(DBAll); 
-                v = DBGetUcdvar(dbfile, toc->ucdvar_names[j]);
-                stream_ucdvar(m, v, newprefix, dom, fmap);
-                DBFreeUcdvar(v);
-            }
+            char name[256];
+            snprintf(name, sizeof(name), "%s%1d", ucdv->name, j);
+            put_column(out, name, type, 1, nrows, ucdv->vals[j]);
+        }
+    }
+}
+
+//
+// Format a domain as a zones batch and a nodes batch. Values are copied
+// as they were read, without conversion.
+//
+static void stream_domain_columnar(domain_t& d)
+{
+    DBucdmesh const *ucdm = d.mesh;
+    DBzonelist const *zl = ucdm->zones;
+    long long nzones = zl->nzones;
+    int maxsize = 0, zlidx = 0, zidx = 0;
+
+    for (int i = 0; i < zl->nshapes; i++)
+        if (zl->shapesize[i] > maxsize) maxsize = zl->shapesize[i];
+
+    vector<long long> zoneid(nzones);
+    vector<int> nnodes(nzones);
+    vector<int> nodes(nzones * maxsize, -1);
+    for (int i = 0; i < zl->nshapes; i++)
+    {
+        for (int j = 0; j < zl->shapecnt[i]; j++, zidx++)
+        {
+            unsigned long long gz = get_zoneid(zl, zidx);
+            zoneid[zidx] = gz == (unsigned long long)-1 ? zidx : (long long) gz;
+            nnodes[zidx] = zl->shapesize[i];
+            memcpy(&nodes[zidx * maxsize], zl->nodelist + zlidx, zl->shapesize[i] * sizeof(int));
+            zlidx += zl->shapesize[i];
         }
-        DBSetDataReadMask(oldmask);
-        DBFreeUcdmesh(m);
     }
 
-    if (!toc->ndir) return;
+    put_batch_header(d.out, 0, d, nzones, 3 + count_var_columns(d, DB_ZONECENT));
+    put_column(d.out, "zoneid", COL_INT64, 1, nzones, nzones ? &zoneid[0] : 0);
+    put_column(d.out, "nnodes", COL_INT32, 1, nzones, nzones ? &nnodes[0] : 0);
+    put_column(d.out, "nodes", COL_INT32, maxsize, nzones, nzones ? &nodes[0] : 0);
+    put_var_columns(d.out, d, DB_ZONECENT, nzones);
+
+    static char const *coordnames[3] = {"x", "y", "z"};
+    int ctype = col_type(ucdm->datatype);
+    put_batch_header(d.out, 1, d, ucdm->nnodes, ucdm->ndims + count_var_columns(d, DB_NODECENT));
+    for (int i = 0; i < ucdm->ndims; i++)
+        put_column(d.out, coordnames[i], ctype, 1, ucdm->nnodes, ucdm->coords[i]);
+    put_var_columns(d.out, d, DB_NODECENT, ucdm->nnodes);
+}
+
+static void free_domain(domain_t& d)
+{
+    for (size_t v = 0; v < d.vars.size(); v++)
+        DBFreeUcdvar(d.vars[v]);
+    DBFreeUcdmesh(d.mesh);
+    d.vars.clear();
+    d.mesh = 0;
+}
+
+//
+// Format the pending domains, in parallel, and write them out in order
+//
+static void flush_domains(vector<domain_t>& pending, bool columnar, FILE *outfile)
+{
+    int n = (int) pending.size();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < n; i++)
+    {
+        if (columnar)
+            stream_domain_columnar(pending[i]);
+        else
+            stream_domain_text(pending[i]);
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        fwrite(pending[i].out.data(), 1, pending[i].out.size(), outfile);
+        free_domain(pending[i]);
+    }
+    pending.clear();
+}
+
+typedef struct stream_state_t {
+    vector<domain_t> pending;
+    size_t batch;
+    bool columnar;
+    FILE *outfile;
+} stream_state_t;
+
+static void stream_cwdir(DBfile *dbfile, string prefix, int dom, stream_state_t &st)
+{
+    DBtoc *toc = DBGetToc (dbfile);
 
     //
     // Copy relevant info from the toc. Otherwise, it'll get lost on
-    // successive calls to DBSetDir().
+    // successive calls to DBGetUcdvar() and DBSetDir().
     //
-    int      norigdir      = toc->ndir;
-    char   **origdir_names = new char*[norigdir];
-    for (int i = 0 ; i < norigdir ; i++)
+    vector<string> mesh_names(toc->ucdmesh_names, toc->ucdmesh_names + toc->nucdmesh);
+    vector<string> var_names(toc->ucdvar_names, toc->ucdvar_names + toc->nucdvar);
+    vector<string> dir_names(toc->dir_names, toc->dir_names + toc->ndir);
+
+    for (size_t i = 0; i < mesh_names.size(); i++)
     {
-        origdir_names[i] = new char[strlen(toc->dir_names[i])+1];
-        strcpy(origdir_names[i], toc->dir_names[i]);
+        domain_t d;
+        d.mesh = DBGetUcdmesh(dbfile, mesh_names[i].c_str());
+        if (!d.mesh || !d.mesh->zones) continue;
+        d.prefix = prefix + "/" + mesh_names[i];
+        d.dom = dom;
+        unsigned long long oldmask = DBGetDataReadMask2();
+        for (size_t j = 0; j < var_names.size(); j++)
+        {
+            DBSetDataReadMask2(DBNone);
+            DBucdvar *v = DBGetUcdvar(dbfile, var_names[j].c_str());
+            if (v && !strcmp(v->meshname, mesh_names[i].c_str()))
+            {
+                DBFreeUcdvar(v);
+                DBSetDataReadMask2(DBAll);
+                v = DBGetUcdvar(dbfile, var_names[j].c_str());
+                if (v->centering == DB_ZONECENT || v->centering == DB_NODECENT)
+                    d.vars.push_back(v);
+                else
+                    DBFreeUcdvar(v);
+            }
+            else if (v)
+            {
+                DBFreeUcdvar(v);
+            }
+        }
+        DBSetDataReadMask2(oldmask);
+        st.pending.push_back(d);
+        if (st.pending.size() >= st.batch)
+            flush_domains(st.pending, st.columnar, st.outfile);
     }
 
-    for (int i = 0; i <norigdir; i++)
+    for (size_t i = 0; i < dir_names.size(); i++)
     {
         int newdom;
-        int n = sscanf(origdir_names[i], "domain_%d", &newdom);
+        int n = sscanf(dir_names[i].c_str(), "domain_%d", &newdom);
         if (n != 1)
-            n = sscanf(origdir_names[i], "block%d", &newdom);
+            n = sscanf(dir_names[i].c_str(), "block%d", &newdom);
         if (n != 1) continue;
-        string new_prefix = prefix + "/" + string(origdir_names[i]);
-        DBSetDir(dbfile, origdir_names[i]);
-        stream_cwdir(dbfile, new_prefix, newdom, fmap);
+        string new_prefix = prefix + "/" + dir_names[i];
+        DBSetDir(dbfile, dir_names[i].c_str());
+        stream_cwdir(dbfile, new_prefix, newdom, st);
         DBSetDir(dbfile, "..");
     }
-
-    for (int i = 0; i <norigdir; i++)
-        delete [] origdir_names[i];
-    delete [] origdir_names;
-
 }
 
-static void stream_file(char const *filename)
+static void stream_file(char const *filename, stream_state_t& st)
 {
     DBfile *dbfile = DBOpen(filename, DB_UNKNOWN, DB_READ);
-    strmap_t stream_map;
-    stream_cwdir(dbfile, "", -1, stream_map);
+    if (!dbfile)
+    {
+        cerr << "unable to open \"" << filename << "\"" << endl;
+        exit(1);
+    }
+
+    if (st.columnar)
+    {
+        string header;
+        put_bytes(header, "SILOCOLS", 8);
+        put_i32(header, 1);
+        put_i32(header, 0x01020304);
+        fwrite(header.data(), 1, header.size(), st.outfile);
+    }
+
+    stream_cwdir(dbfile, "", -1, st);
+    flush_domains(st.pending, st.columnar, st.outfile);
+
+    if (st.columnar)
+    {
+        string trailer;
+        put_bytes(trailer, "SEND", 4);
+        put_i32(trailer, 0);
+        fwrite(trailer.data(), 1, trailer.size(), st.outfile);
+    }
 
-    for (strmap_t::const_iterator cit = stream_map.begin(); cit != stream_map.end(); cit++)
-        cout << cit->first << "\t" << cit->second << endl;
+    DBClose(dbfile);
 }
 
 int main(int argc, char **argv)
 {
     char filename[1024];
     char varname[256];
+    char const *outname = 0;
+    stream_state_t st;
 
     filename[0] = '\0';
     varname[0] = '\0';
+    st.columnar = false;
+#ifdef _OPENMP
+    st.batch = omp_get_max_threads();
+#else
+    st.batch = 1;
+#endif
     for (int i = 0; i < argc; i++)
     {
         if (ARG_OPT(--fn))
@@ -281,6 +525,27 @@ int main(int argc, char **argv)
             assert(strlen(argv[i])<sizeof(varname));
             strcpy(varname, argv[i]);
         }
+        else if (ARG_OPT(--format))
+        {
+            i++;
+            if (!strcmp(argv[i], "columnar"))
+                st.columnar = true;
+            else if (strcmp(argv[i], "text"))
+            {
+                cerr << "unknown format \"" << argv[i] << "\"" << endl;
+                exit(1);
+            }
+        }
+        else if (ARG_OPT(--out))
+        {
+            i++;
+            outname = argv[i];
+        }
+        else if (ARG_OPT(--batch))
+        {
+            i++;
+            st.batch = atoi(argv[i]) > 0 ? atoi(argv[i]) : 1;
+        }
     }
 
     if (!strcmp(filename, ""))
@@ -289,7 +554,17 @@ int main(int argc, char **argv)
         exit(1);
     }
 
-    stream_file(filename);
+    st.outfile = outname ? fopen(outname, st.columnar ? "wb" : "w") : stdout;
+    if (!st.outfile)
+    {
+        cerr << "unable to open \"" << outname << "\"" << endl;
+        exit(1);
+    }
+
+    stream_file(filename, st);
+
+    if (st.outfile != stdout)
+        fclose(st.outfile);
 
     return 0;
 }
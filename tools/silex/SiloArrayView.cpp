@@ -54,11 +54,324 @@ be used for advertising or product endorsement purposes.
 
 #include "SiloArrayView.h"
 #include <SiloFile.h>
+#include <QHeaderView>
+#include <QLabel>
 #include <QListWidget>
+#include <QTableView>
+#include <QVBoxLayout>
 #include <iostream>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
 #include <cstdlib>
 using std::cerr;
 
+// Values per page read by the table model and the number of pages kept
+#define ARRAY_PAGE_SIZE   4096
+#define ARRAY_PAGE_CACHE  64
+
+// Values per read and number of histogram bins of the summary
+#define SUMMARY_CHUNK     (1<<20)
+#define SUMMARY_BINS      32
+
+// Longest DB_CHAR array that is checked for being a printable string
+#define ARRAY_STRING_MAX  (1<<20)
+
+// ----------------------------------------------------------------------------
+//                            Array Model
+// ----------------------------------------------------------------------------
+
+// ****************************************************************************
+//  Constructor: SiloArrayModel::SiloArrayModel
+//
+// ****************************************************************************
+SiloArrayModel::SiloArrayModel(SiloFile *s, const QString &n, QObject *p)
+    : QAbstractTableModel(p), silo(s), name(n), pages(ARRAY_PAGE_CACHE)
+{
+    int d[32];
+
+    type  = silo->GetVarType(name);
+    len   = silo->GetVarLength(name);
+    if (len < 0)
+        len = 0;
+    esize = len ? silo->GetVarByteLength(name) / len : 0;
+
+    int ndims = silo->GetVarDims(name, 32, d);
+    if (ndims < 1)
+    {
+        ndims = 1;
+        d[0] = len;
+    }
+    for (int i=0; i<ndims; i++)
+        dims.append(d[i]);
+}
+
+int
+SiloArrayModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : len;
+}
+
+int
+SiloArrayModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : 1;
+}
+
+// ****************************************************************************
+//  Method:  SiloArrayModel::GetPage
+//
+//  Purpose:
+//    Return the values of a page, reading them if the page is not cached.
+//    The returned page is only good until the next call.
+//
+// ****************************************************************************
+QByteArray const *
+SiloArrayModel::GetPage(int page) const
+{
+    QByteArray *buf = pages.object(page);
+    if (buf)
+        return buf;
+
+    long long start = (long long) page * ARRAY_PAGE_SIZE;
+    int count = len - start < ARRAY_PAGE_SIZE ? (int) (len - start)
+                                              : ARRAY_PAGE_SIZE;
+    buf = new QByteArray(count * esize, 0);
+    if (!silo->ReadVarRange(name, dims.size(), dims.constData(), start,
+                            count, esize, buf->data()))
+    {
+        delete buf;
+        return 0;
+    }
+    pages.insert(page, buf);
+    return buf;
+}
+
+// ****************************************************************************
+//  Method:  SiloArrayModel::FormatValue
+//
+//  Purpose:
+//    Format the i'th value of a buffer of the given Silo type.
+//
+// ****************************************************************************
+QString
+SiloArrayModel::FormatValue(int type, void const *buf, int i)
+{
+    char str[256];
+    switch (type)
+    {
+      case DB_INT:
+        snprintf(str, sizeof(str), "%d", ((int const*)buf)[i]);
+        break;
+      case DB_SHORT:
+        snprintf(str, sizeof(str), "%d", ((short const*)buf)[i]);
+        break;
+      case DB_LONG:
+        snprintf(str, sizeof(str), "%ld", ((long const*)buf)[i]);
+        break;
+      case DB_LONG_LONG:
+        snprintf(str, sizeof(str), "%lld", ((long long const*)buf)[i]);
+        break;
+      case DB_FLOAT:
+        snprintf(str, sizeof(str), "%g", ((float const*)buf)[i]);
+        break;
+      case DB_DOUBLE:
+        snprintf(str, sizeof(str), "%g", ((double const*)buf)[i]);
+        break;
+      case DB_CHAR:
+        snprintf(str, sizeof(str), "%hhd", ((char const*)buf)[i]);
+        break;
+      case DB_NOTYPE:
+        snprintf(str, sizeof(str), "NOTYPE");
+        break;
+      default:
+        snprintf(str, sizeof(str), "type ???");
+        break;
+    }
+    return QString(str);
+}
+
+QVariant
+SiloArrayModel::data(const QModelIndex &index, int role) const
+{
+    if (role != Qt::DisplayRole || !index.isValid() || index.row() >= len)
+        return QVariant();
+
+    if (type == DB_NOTYPE || esize <= 0)
+        return FormatValue(type, 0, 0);
+
+    QByteArray const *page = GetPage(index.row() / ARRAY_PAGE_SIZE);
+    if (!page)
+        return QString("read error");
+    return FormatValue(type, page->constData(), index.row() % ARRAY_PAGE_SIZE);
+}
+
+QVariant
+SiloArrayModel::headerData(int section, Qt::Orientation orientation,
+                           int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    if (orientation == Qt::Horizontal)
+        return QString("value");
+    return QString::number(section);
+}
+
+// ----------------------------------------------------------------------------
+//                            Array Summary
+// ----------------------------------------------------------------------------
+
+// ****************************************************************************
+//  Constructor: SiloArraySummary::SiloArraySummary
+//
+// ****************************************************************************
+SiloArraySummary::SiloArraySummary(SiloFile *s, const QString &n, QObject *p)
+    : QThread(p), ok(false), min(0), max(0), nfinite(0), nnonfinite(0),
+      hist(SUMMARY_BINS, 0), silo(s), name(n)
+{
+    type = silo->GetVarType(name);
+    len  = silo->GetVarLength(name);
+}
+
+SiloArraySummary::~SiloArraySummary()
+{
+    requestInterruption();
+    wait();
+}
+
+static void
+ToDouble(int type, void const *buf, int n, double *out)
+{
+    int i;
+    switch (type)
+    {
+      case DB_INT:
+        for (i=0; i<n; i++) out[i] = ((int const*)buf)[i];
+        break;
+      case DB_SHORT:
+        for (i=0; i<n; i++) out[i] = ((short const*)buf)[i];
+        break;
+      case DB_LONG:
+        for (i=0; i<n; i++) out[i] = (double) ((long const*)buf)[i];
+        break;
+      case DB_LONG_LONG:
+        for (i=0; i<n; i++) out[i] = (double) ((long long const*)buf)[i];
+        break;
+      case DB_FLOAT:
+        for (i=0; i<n; i++) out[i] = ((float const*)buf)[i];
+        break;
+      case DB_DOUBLE:
+        for (i=0; i<n; i++) out[i] = ((double const*)buf)[i];
+        break;
+      case DB_CHAR:
+        for (i=0; i<n; i++) out[i] = ((signed char const*)buf)[i];
+        break;
+    }
+}
+
+// ****************************************************************************
+//  Method:  SiloArraySummary::Pass
+//
+//  Purpose:
+//    Read the whole array a chunk at a time. Pass 0 finds the extents of
+//    the finite values and pass 1 bins them. Each read takes the Silo lock
+//    only for its own duration so the GUI thread can page in between.
+//    Values are halved before binning so neither the range of extents
+//    near the largest double nor a subnormal range overflows.
+//
+// ****************************************************************************
+bool
+SiloArraySummary::Pass(int pass, int ndims, int const *dims, int esize)
+{
+    int chunk = len < SUMMARY_CHUNK ? len : SUMMARY_CHUNK;
+    QByteArray buf(chunk * esize, 0);
+    QVector<double> vals(chunk);
+    double lo    = min / 2;
+    double range = max / 2 - lo;
+
+    for (long long start = 0; start < len; start += chunk)
+    {
+        if (isInterruptionRequested())
+            return false;
+
+        int n = len - start < chunk ? (int) (len - start) : chunk;
+        if (!silo->ReadVarRange(name, ndims, dims, start, n, esize, buf.data()))
+            return false;
+        ToDouble(type, buf.constData(), n, vals.data());
+
+        for (int i=0; i<n; i++)
+        {
+            double v = vals[i];
+            if (!std::isfinite(v))
+            {
+                if (pass == 0) nnonfinite++;
+                continue;
+            }
+            if (pass == 0)
+            {
+                if (nfinite == 0 || v < min) min = v;
+                if (nfinite == 0 || v > max) max = v;
+                nfinite++;
+            }
+            else
+            {
+                double t = range > 0 ? (v / 2 - lo) / range * SUMMARY_BINS : 0;
+                hist[t < SUMMARY_BINS ? (int) t : SUMMARY_BINS-1]++;
+            }
+        }
+
+        emit progress((int) (((pass * (long long) len) + start + n) * 50 / len));
+    }
+    return true;
+}
+
+void
+SiloArraySummary::run()
+{
+    int dims[32];
+
+    if (len <= 0 || type == DB_NOTYPE)
+        return;
+
+    int esize = silo->GetVarByteLength(name) / len;
+    int ndims = silo->GetVarDims(name, 32, dims);
+    if (ndims < 1)
+    {
+        ndims = 1;
+        dims[0] = len;
+    }
+
+    ok = esize > 0 && Pass(0, ndims, dims, esize) &&
+         Pass(1, ndims, dims, esize);
+}
+
+// ****************************************************************************
+//  Method:  SiloArraySummary::Text
+//
+//  Purpose:
+//    Describe the summary in two lines, the extents and counts and then
+//    the histogram drawn with block characters.
+//
+// ****************************************************************************
+QString
+SiloArraySummary::Text() const
+{
+    if (!ok)
+        return QString("no summary");
+    if (!nfinite)
+        return QString("no finite values (%1 non-finite)").arg(nnonfinite);
+
+    QString s = QString("min %1   max %2   finite %3   non-finite %4\n")
+        .arg(min, 0, 'g', 6).arg(max, 0, 'g', 6).arg(nfinite).arg(nnonfinite);
+
+    long long most = 1;
+    for (int i=0; i<hist.size(); i++)
+        if (hist[i] > most) most = hist[i];
+    for (int i=0; i<hist.size(); i++)
+        s += hist[i] ? QChar(0x2581 + (int) (hist[i] * 7 / most)) : QChar(' ');
+    return s;
+}
+
 // ----------------------------------------------------------------------------
 //                            Array View
 // ----------------------------------------------------------------------------
@@ -105,181 +418,210 @@ using std::cerr;
 // ****************************************************************************
 SiloArrayViewWindow::SiloArrayViewWindow(SiloFile *s, const QString &n,
                                          QWidget *p)
-    : QMainWindow(p), silo(s), name(n)
+    : QMainWindow(p), lb(0), tv(0), model(0), summary(0), summaryLabel(0),
+      silo(s), name(n)
 {
     setWindowTitle(QString("Array: ")+name);
+    setAttribute(Qt::WA_DeleteOnClose);
 
-    lb = new QListWidget(this);
-    setCentralWidget(lb);
-
-    void *var = silo->GetVar(name);
-    if (!var)
+    int type = silo->GetVarType(name);
+    int len  = silo->GetVarLength(name);
+    if (len <= 0)
     {
         cerr << "SiloArrayViewWindow::SiloArrayViewWindow -- not an array var\n";
         throw;
     }
 
-    int type = silo->GetVarType(name);
-    int len  = silo->GetVarLength(name);
+    if (type == DB_CHAR && len <= ARRAY_STRING_MAX && AddStringItems(len))
+        return;
+
+    QWidget *w = new QWidget(this);
+    QVBoxLayout *layout = new QVBoxLayout(w);
+
+    model = new SiloArrayModel(silo, name, this);
+    tv = new QTableView(w);
+    tv->setModel(model);
+    tv->horizontalHeader()->setStretchLastSection(true);
+    tv->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    tv->verticalHeader()->setDefaultSectionSize(tv->fontMetrics().height()+4);
+    layout->addWidget(tv);
+
+    summaryLabel = new QLabel("summarizing...", w);
+    summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layout->addWidget(summaryLabel);
+    setCentralWidget(w);
+
+    summary = new SiloArraySummary(silo, name, this);
+    connect(summary, SIGNAL(progress(int)),
+            this,    SLOT(ShowSummaryProgress(int)));
+    connect(summary, SIGNAL(finished()),
+            this,    SLOT(ShowSummary()));
+    summary->start(QThread::LowPriority);
+}
+
+// ****************************************************************************
+//  Destructor: SiloArrayViewWindow::~SiloArrayViewWindow
+//
+// ****************************************************************************
+SiloArrayViewWindow::~SiloArrayViewWindow()
+{
+    if (summary)
+    {
+        summary->requestInterruption();
+        summary->wait();
+    }
+}
+
+void
+SiloArrayViewWindow::ShowSummaryProgress(int percent)
+{
+    summaryLabel->setText(QString("summarizing... %1%").arg(percent));
+}
+
+void
+SiloArrayViewWindow::ShowSummary()
+{
+    summaryLabel->setText(summary->Text());
+}
+
+// ****************************************************************************
+//  Method:  SiloArrayViewWindow::AddStringItems
+//
+//  Purpose:
+//    Show a DB_CHAR array as a list of strings if all of it is printable.
+//    Returns false, having added nothing, if it is not.
+//
+// ****************************************************************************
+bool
+SiloArrayViewWindow::AddStringItems(int len)
+{
+    void *var = silo->GetVar(name);
+    if (!var)
+        return false;
 
     bool isString= true;
-    if (type == DB_CHAR)
+    char *c = (char*)var;
+    for (int i=0; i<len-1 && isString; i++)
     {
-        char *p = (char*)var;
-        for (int i=0; i<len-1 && isString; i++)
-        {
-            if (!isprint(p[i]))
-                isString = false;
-        }
-        if (p[len-1] != '\0')
+        if (!isprint(c[i]))
             isString = false;
     }
+    if (c[len-1] != '\0')
+        isString = false;
 
-    if (type == DB_CHAR && isString)
+    if (!isString)
     {
-        // Guess how to split the string based on a heuristic:
-        //  - If the length is short, just stick it in
-        //  - If there are an appropriate number of semicolons or spaces, 
-        //                                      split on them
-        //  - Otherwise, split by a constant length
-        int numSemi = 0;
-        int numSpace = 0;
-        int numIdeal = (len/100) + 1;
-        int numMax   = (len/400) + 1;
-        for (int j=0; j<len; j++)
-        {
-            if (((char*)var)[j] == ' ')
-                numSpace++;
-            if (((char*)var)[j] == ';')
-                numSemi++;
-        }
-        if (len < 400)
-        {
-            lb->addItem((char*)var);
-        }
-        else if (numSpace < numMax && numSemi < numMax)
+        free(var);
+        return false;
+    }
+
+    lb = new QListWidget(this);
+    setCentralWidget(lb);
+
+    // Guess how to split the string based on a heuristic:
+    //  - If the length is short, just stick it in
+    //  - If there are an appropriate number of semicolons or spaces, 
+    //                                      split on them
+    //  - Otherwise, split by a constant length
+    int numSemi = 0;
+    int numSpace = 0;
+    int numIdeal = (len/100) + 1;
+    int numMax   = (len/400) + 1;
+    for (int j=0; j<len; j++)
+    {
+        if (((char*)var)[j] == ' ')
+            numSpace++;
+        if (((char*)var)[j] == ';')
+            numSemi++;
+    }
+    if (len < 400)
+    {
+        lb->addItem((char*)var);
+    }
+    else if (numSpace < numMax && numSemi < numMax)
+    {
+        // Copy the character array into a temporary buffer,
+        // splitting by length
+        char *str = new char[len+1];
+        char *p = str;
+        int tmplen = 0;
+        for (int i=0; i<len; i++)
         {
-            // Copy the character array into a temporary buffer,
-            // splitting by length
-            char *str = new char[len+1];
-            char *p = str;
-            int tmplen = 0;
-            for (int i=0; i<len; i++)
-            {
-                *p = ((char*)var)[i];
-                if (tmplen == 400)
-                {
-                    p++;
-                    *p = '\0';
-                    lb->addItem(str);
-                    p = str;
-                    tmplen = 0;
-                }
-                else
-                {
-                    p++;
-                    tmplen++;
-                }
-            }
-            if (p != str)
+            *p = ((char*)var)[i];
+            if (tmplen == 400)
             {
+                p++;
                 *p = '\0';
                 lb->addItem(str);
+                p = str;
+                tmplen = 0;
             }
             else
             {
-                lb->addItem("(null)");
+                p++;
+                tmplen++;
             }
-            delete[] str;
+        }
+        if (p != str)
+        {
+            *p = '\0';
+            lb->addItem(str);
         }
         else
         {
-            // Copy the character array into a temporary buffer,
-            // splitting at the separator, and putting the result in a list box
-            char splitChar;
-            if (numSpace==0)
-                splitChar = ';';
-            else if (numSemi==0)
-                splitChar = ' ';
-            else if (abs(numSpace-numIdeal) > abs(numSemi-numIdeal))
-                splitChar = ';';
-            else
-                splitChar = ' ';
-            
-            char *str = new char[len+1];
-            char *p = str;
-            for (int i=0; i<len; i++)
+            lb->addItem("(null)");
+        }
+        delete[] str;
+    }
+    else
+    {
+        // Copy the character array into a temporary buffer,
+        // splitting at the separator, and putting the result in a list box
+        char splitChar;
+        if (numSpace==0)
+            splitChar = ';';
+        else if (numSemi==0)
+            splitChar = ' ';
+        else if (abs(numSpace-numIdeal) > abs(numSemi-numIdeal))
+            splitChar = ';';
+        else
+            splitChar = ' ';
+        
+        char *str = new char[len+1];
+        char *p = str;
+        for (int i=0; i<len; i++)
+        {
+            *p = ((char*)var)[i];
+            if (*p == splitChar)
             {
-                *p = ((char*)var)[i];
-                if (*p == splitChar)
+                if (p != str)
                 {
-                    if (p != str)
-                    {
-                        *p = '\0';
-                        lb->addItem(str);
-                    }
-                    else
-                    {
-                        lb->addItem("(null)");
-                    }
-                    p = str;
+                    *p = '\0';
+                    lb->addItem(str);
                 }
                 else
                 {
-                    p++;
+                    lb->addItem("(null)");
                 }
-            }
-            if (p != str)
-            {
-                *p = '\0';
-                lb->addItem(str);
+                p = str;
             }
             else
             {
-                lb->addItem("(null)");
+                p++;
             }
-            delete[] str;
         }
-    }
-    else
-    {
-        // Just a bunch of numbers: one per line
-        for (int i=0; i<len; i++)
+        if (p != str)
         {
-            char str[256];
-            switch (type)
-            {
-              case DB_INT:
-                sprintf(str, "%-4d: %d", i, ((int*)var)[i]);
-                break;
-              case DB_SHORT:
-                sprintf(str, "%-4d: %d", i, ((short*)var)[i]);
-                break;
-              case DB_LONG:
-                sprintf(str, "%-4d: %ld", i, ((long*)var)[i]);
-                break;
-              case DB_LONG_LONG:
-                sprintf(str, "%-4d: %lld", i, ((long long*)var)[i]);
-                break;
-              case DB_FLOAT:
-                sprintf(str, "%-4d: %g", i, ((float*)var)[i]);
-                break;
-              case DB_DOUBLE:
-                sprintf(str, "%-4d: %g", i, ((double*)var)[i]);
-                break;
-              case DB_CHAR:
-                sprintf(str, "%-4d: %hhd", i, ((char*)var)[i]);
-                break;
-              case DB_NOTYPE:
-                sprintf(str, "%-4d: NOTYPE", i);
-                break;
-              default:
-                sprintf(str, "%-4d: type ???", i);
-                break;
-            }
+            *p = '\0';
             lb->addItem(str);
         }
+        else
+        {
+            lb->addItem("(null)");
+        }
+        delete[] str;
     }
 
     free(var);
+    return true;
 }
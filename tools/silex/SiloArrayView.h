@@ -56,8 +56,89 @@ be used for advertising or product endorsement purposes.
 #define SILOARRAYVIEW_H
 
 #include <QMainWindow>
+#include <QAbstractTableModel>
+#include <QCache>
+#include <QThread>
+#include <QVector>
 class SiloFile;
 class QListWidget;
+class QTableView;
+class QLabel;
+
+// ****************************************************************************
+//  Class:  SiloArrayModel
+//
+//  Purpose:
+//    Table model of a simple array, one value per row. Values are read
+//    on demand a page at a time and only the most recently used pages
+//    are kept, so only what is visible is ever read or formatted.
+//
+// ****************************************************************************
+class SiloArrayModel : public QAbstractTableModel
+{
+    Q_OBJECT
+  public:
+    SiloArrayModel(SiloFile *s, const QString &n, QObject *p);
+
+    virtual int      rowCount(const QModelIndex &parent = QModelIndex()) const;
+    virtual int      columnCount(const QModelIndex &parent = QModelIndex()) const;
+    virtual QVariant data(const QModelIndex &index,
+                          int role = Qt::DisplayRole) const;
+    virtual QVariant headerData(int section, Qt::Orientation orientation,
+                                int role = Qt::DisplayRole) const;
+
+    static QString FormatValue(int type, void const *page, int i);
+
+  private:
+    QByteArray const *GetPage(int page) const;
+
+    SiloFile    *silo;
+    QString      name;
+    int          type;
+    int          len;
+    int          esize;
+    QVector<int> dims;
+    mutable QCache<int, QByteArray> pages;
+};
+
+// ****************************************************************************
+//  Class:  SiloArraySummary
+//
+//  Purpose:
+//    Worker thread computing the minimum, maximum and a histogram of the
+//    finite values of a simple array, reading it a chunk at a time.
+//
+// ****************************************************************************
+class SiloArraySummary : public QThread
+{
+    Q_OBJECT
+  public:
+    SiloArraySummary(SiloFile *s, const QString &n, QObject *p);
+    virtual ~SiloArraySummary();
+
+    QString Text() const;
+
+    bool               ok;
+    double             min;
+    double             max;
+    long long          nfinite;
+    long long          nnonfinite;
+    QVector<long long> hist;
+
+  signals:
+    void progress(int percent);
+
+  protected:
+    virtual void run();
+
+  private:
+    bool Pass(int pass, int ndims, int const *dims, int esize);
+
+    SiloFile *silo;
+    QString   name;
+    int       type;
+    int       len;
+};
 
 // ****************************************************************************
 //  Class:  SiloArrayViewWindow
@@ -78,8 +159,20 @@ class SiloArrayViewWindow : public QMainWindow
     Q_OBJECT
   public:
     SiloArrayViewWindow(SiloFile *s, const QString &n, QWidget *p);
+    virtual ~SiloArrayViewWindow();
+
+  private slots:
+    void ShowSummaryProgress(int percent);
+    void ShowSummary();
+
   private:
-    QListWidget *lb;
+    bool AddStringItems(int len);
+
+    QListWidget      *lb;
+    QTableView       *tv;
+    SiloArrayModel   *model;
+    SiloArraySummary *summary;
+    QLabel           *summaryLabel;
     SiloFile *silo;
     QString   name;
 };
@@ -56,6 +56,14 @@ be used for advertising or product endorsement purposes.
 
 #include <silo.h>
 
+#include <QMutex>
+#include <QMutexLocker>
+
+// The Silo library is not thread safe. Every call into it from SiloFile
+// holds this lock so array summaries can read in a worker thread while
+// the GUI thread keeps reading pages.
+static QMutex siloLock;
+
 // ----------------------------------------------------------------------------
 //                             Silo Dir
 // ----------------------------------------------------------------------------
@@ -196,6 +204,7 @@ SiloDir::~SiloDir()
 // ****************************************************************************
 SiloFile::SiloFile(const QString &name)
 {
+    QMutexLocker lock(&siloLock);
     db = DBOpen((const char*)name.toLatin1(), DB_UNKNOWN, DB_READ);
     if (db)
         root = new SiloDir(db, "/", "/");
@@ -217,6 +226,7 @@ SiloFile::SiloFile(const QString &name)
 // ****************************************************************************
 SiloFile::~SiloFile()
 {
+    QMutexLocker lock(&siloLock);
     if (root) delete root;
     root = 0;
     if (db) DBClose(db);
@@ -239,47 +249,132 @@ SiloFile::~SiloFile()
 void*
 SiloFile::GetVar(const QString &name)
 {
+    QMutexLocker lock(&siloLock);
     return DBGetVar(db, (const char*)name.toLatin1());
 }
 
 int
 SiloFile::GetVarType(const QString &name)
 {
+    QMutexLocker lock(&siloLock);
     return DBGetVarType(db, (const char*)name.toLatin1());
 }
 
 int
 SiloFile::GetVarLength(const QString &name)
 {
+    QMutexLocker lock(&siloLock);
     return DBGetVarLength(db, (const char*)name.toLatin1());
 }
 
+int
+SiloFile::GetVarByteLength(const QString &name)
+{
+    QMutexLocker lock(&siloLock);
+    return DBGetVarByteLength(db, (const char*)name.toLatin1());
+}
+
+int
+SiloFile::GetVarDims(const QString &name, int maxdims, int *dims)
+{
+    QMutexLocker lock(&siloLock);
+    return DBGetVarDims(db, (const char*)name.toLatin1(), maxdims, dims);
+}
+
 DBobject*
 SiloFile::GetObject(const QString &name)
 {
+    QMutexLocker lock(&siloLock);
     return DBGetObject(db, (const char*)name.toLatin1());
 }
 
 void*
 SiloFile::GetComponent(const QString &oname, const QString &cname)
 {
+    QMutexLocker lock(&siloLock);
     return DBGetComponent(db, (const char*)oname.toLatin1(), (const char*)cname.toLatin1());
 }
 
 int
 SiloFile::GetComponentType(const QString &oname, const QString &cname)
 {
+    QMutexLocker lock(&siloLock);
     return DBGetComponentType(db, (const char*)oname.toLatin1(), (const char*)cname.toLatin1());
 }
 
 DBObjectType
 SiloFile::InqVarType(const QString &name)
 {
+    QMutexLocker lock(&siloLock);
     return DBInqVarType(db, (const char*)name.toLatin1());
 }
 
 bool
 SiloFile::InqVarExists(const QString &name)
 {
+    QMutexLocker lock(&siloLock);
     return DBInqVarExists(db, (const char*)name.toLatin1());
 }
+
+// ****************************************************************************
+//  Method:  SiloFile::ReadVarRange
+//
+//  Purpose:
+//    Read count values, starting at the flat (C order) index start, of a
+//    simple array with the given dimensions. The range is split into the
+//    fewest hyperslabs DBReadVarSlice can read, each a run along one
+//    dimension of full extents in all the faster varying dimensions.
+//
+// ****************************************************************************
+bool
+SiloFile::ReadVarRange(const QString &name, int ndims, int const *dims,
+                       long long start, int count, int esize, void *buf)
+{
+    int offset[32], length[32], stride[32], idx[32];
+    char *out = (char *) buf;
+    long long left = count;
+
+    if (ndims < 1 || ndims > 32)
+        return false;
+
+    QByteArray vname = name.toLatin1();
+    QMutexLocker lock(&siloLock);
+    while (left > 0)
+    {
+        long long rem = start;
+        for (int d = ndims-1; d >= 0; d--)
+        {
+            idx[d] = (int) (rem % dims[d]);
+            rem /= dims[d];
+        }
+
+        // Find the slowest dimension d we can run along while reading
+        // all of every faster varying dimension.
+        long long inner = 1;
+        int d;
+        for (d = ndims-1; d > 0; d--)
+        {
+            if (idx[d] != 0 || inner * dims[d] > left)
+                break;
+            inner *= dims[d];
+        }
+        long long n = left / inner;
+        if (n > dims[d] - idx[d])
+            n = dims[d] - idx[d];
+
+        for (int k = 0; k < ndims; k++)
+        {
+            stride[k] = 1;
+            offset[k] = k > d ? 0 : idx[k];
+            length[k] = k > d ? dims[k] : (k == d ? (int) n : 1);
+        }
+        if (DBReadVarSlice(db, (const char*)vname, offset, length, stride,
+                           ndims, out) < 0)
+            return false;
+
+        out   += n * inner * esize;
+        start += n * inner;
+        left  -= n * inner;
+    }
+    return true;
+}
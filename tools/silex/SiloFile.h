@@ -150,6 +150,11 @@ class SiloFile
     void         *GetVar(const QString &name);
     int           GetVarType(const QString &name);
     int           GetVarLength(const QString &name);
+    int           GetVarByteLength(const QString &name);
+    int           GetVarDims(const QString &name, int maxdims, int *dims);
+    bool          ReadVarRange(const QString &name, int ndims, int const *dims,
+                               long long start, int count, int esize,
+                               void *buf);
     DBobject     *GetObject(const QString &name);
     void         *GetComponent(const QString &oname, const QString &cname);
     int           GetComponentType(const QString &oname, const QString &cname);
@@ -157,6 +157,10 @@ SiloView::~SiloView()
 void
 SiloView::Set(const QString &file)
 {
+    QList<SiloArrayViewWindow*> arrays = findChildren<SiloArrayViewWindow*>();
+    for (int i = 0; i < arrays.size(); i++)
+        delete arrays[i];
+
     delete silo;
     silo = new SiloFile(file);
     if (!silo->IsOpen())
@@ -54,8 +54,11 @@ be used for advertising or product endorsement purposes.
 
 #include <QApplication>
 #include "Explorer.h"
+#include "SiloArrayView.h"
+#include "SiloFile.h"
 
 #include <cstdlib>
+#include <cstring>
 
 #include <QStyle>
 #include <QFileDialog>
@@ -86,12 +89,51 @@ be used for advertising or product endorsement purposes.
 
 int main( int argc, char **argv )
 {
+    if (argc > 3 && !strcmp(argv[1], "-summary"))
+    {
+        SiloFile silo(argv[3]);
+        if (!silo.IsOpen())
+        {
+            std::cerr << "Unable to open file \"" << argv[3] << "\"" << std::endl;
+            return 1;
+        }
+        SiloArraySummary summary(&silo, argv[2], NULL);
+        summary.start();
+        summary.wait();
+        std::cout << (const char*) summary.Text().toUtf8() << std::endl;
+
+        SiloArrayModel model(&silo, argv[2], NULL);
+        int n = model.rowCount();
+        if (n > 0)
+        {
+            std::cout << "0: " << (const char*)
+                model.data(model.index(0,0)).toString().toLatin1() << std::endl;
+            std::cout << n-1 << ": " << (const char*)
+                model.data(model.index(n-1,0)).toString().toLatin1() << std::endl;
+        }
+        return summary.ok ? 0 : 1;
+    }
+
 #if 0
     QCoreApplication::setLibraryPaths(QStringList()); // work-around Qt bug
     QApplication::setColorSpec(QApplication::ManyColor);
 #endif
     QApplication a(argc, argv);
     a.setStyle(QApplication::style());
+    if (argc > 3 && !strcmp(argv[1], "-array"))
+    {
+        SiloFile *silo = new SiloFile(argv[3]);
+        if (!silo->IsOpen())
+        {
+            std::cerr << "Unable to open file \"" << argv[3] << "\"" << std::endl;
+            return 1;
+        }
+        SiloArrayViewWindow *av = new SiloArrayViewWindow(silo, argv[2], NULL);
+        av->show();
+        av->resize(av->sizeHint());
+        return a.exec();
+    }
+
     Explorer *w = 0;
     if (argc > 1)
     {
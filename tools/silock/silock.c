@@ -71,6 +71,9 @@ be used for advertising or product endorsement purposes.
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include <silo.h>
 #ifdef HAVE_IEEEFP_H
 #include <ieeefp.h>
@@ -78,37 +81,68 @@ be used for advertising or product endorsement purposes.
 
 #define True                    1
 #define False                   0
-#define UPDATE_INTERVAL         5      /* seconds */
-#define INITIAL_CHECK_RATE      500000 /* tests per second */
-
-
-/* if isnan is not available, this tool cannot operate. So, we define
-   bogus tests for these macros and then add code in main to print a
-   useful error message and then exit */
-#ifdef HAVE_ISNAN
-#define IS_VALID_FLOAT(val)        (!isnan((double)(val))&&!isinf((double)(val)))
-#define IS_VALID_DOUBLE(val)        (!isnan(val)&&!isinf(val))
-#else
-#define IS_VALID_FLOAT(val)        ((val)!=0.0)  /* bogus test */
-#define IS_VALID_DOUBLE(val)        ((val)!=0.0)  /* bogus test */
-#endif
+#define UPDATE_INTERVAL         5         /* seconds */
+#define SCAN_BLOCK              4096      /* values tested without branching */
+#define SCAN_CHUNK              (1<<20)   /* values scanned by one task */
+#define READ_AHEAD              256       /* megabytes read but not scanned */
+
+/* IEEE 754 exponent and mantissa masks. A value whose exponent bits are
+   all set is a NaN if its mantissa is non-zero and an Inf otherwise. */
+#define FLOAT_EXP_MASK          0x7F800000U
+#define FLOAT_MANT_MASK         0x007FFFFFU
+#define DOUBLE_EXP_MASK         0x7FF0000000000000ULL
+#define DOUBLE_MANT_MASK        0x000FFFFFFFFFFFFFULL
+
+/* An array read from a file and waiting to be scanned. Large arrays are
+   scanned in several chunks and the last chunk to finish retires the
+   array. */
+typedef struct arrayJob {
+   int fileIndex;
+   char *varName;
+   int dbType;
+   void *buf;
+   long long n;
+   long long nBytes;
+   int pending;
+   long long nNan;
+   long long nInf;
+   long long first;
+} arrayJob;
+
+/* An array found to contain bad values, kept for the summary */
+typedef struct arrayIssue {
+   int fileIndex;
+   char *varName;
+   int dbType;
+   long long nNan;
+   long long nInf;
+   long long first;
+} arrayIssue;
 
 int disableProgress;
 int disableVerbose;
-int totalBytes;
-char fileName[1024];
+long long totalBytes;
+long long readAhead;
+long long pendingBytes;
+char **fileNames;
+int nFiles;
+
+/* totals for the summary */
+long long nArrays, nValues, nBytesScanned, nNanTotal, nInfTotal;
+arrayIssue *issues;
+int nIssues, maxIssues;
 
-int fBufSize;
-int dBufSize;
-float  *fBuf;
-double *dBuf;
+/* names of the arrays of the current file already queued */
+char **seenTable;
+int seenSize, seenCount;
 
 
 /* this function is only called if a NaN issue has been discovered */
 static void
-handleInvalidValue(char *theDir, char *varName, int index, double value)
+handleInvalidValue(char const *fileName, char const *varName,
+   long long index, double value)
 {
-   static char lastDir[1024], lastVar[1024];
+   static char lastFile[1024], lastVar[1024];
    char errMsg[128];
 
    /* try to produce a useful error message regarding the kind of NaN */
@@ -129,20 +163,22 @@ handleInvalidValue(char *theDir, char *varName, int index, double value)
       }
    }
 #else
-   strcpy(errMsg, "unkown NaN");
+   if (value != value)
+      strcpy(errMsg, "NaN");
+   else
+      strcpy(errMsg, value < 0 ? "negative infinity" : "positive infinity");
 #endif
 
    if (!disableVerbose)
    {
-      /* strip off leading slash for root dir */
-      if (strcmp(lastDir, theDir) || strcmp(lastVar, varName))
+      if (strcmp(lastFile, fileName) || strcmp(lastVar, varName))
       {
-         if (!strcmp(theDir,"/"))
-            printf("   simple array /%s...\n", varName);
+         if (nFiles > 1)
+            printf("   simple array %s:%s...\n", fileName, varName);
          else
-            printf("   simple array %s/%s...\n", theDir, varName);
+            printf("   simple array %s...\n", varName);
       }
-      printf("   ...has %s issue at index %d\n", errMsg, index);
+      printf("   ...has %s issue at index %lld\n", errMsg, index);
    }
    else
    {
@@ -151,201 +187,583 @@ handleInvalidValue(char *theDir, char *varName, int index, double value)
       exit(-1);
    }
 
-   /* keep a record of last dir and varname we used so we don't keep
+   /* keep a record of last file and varname we used so we don't keep
       issuing the `  simple array ... statement ' */
-   strcpy(lastDir, theDir);
-   strcpy(lastVar, varName);
+   strncpy(lastFile, fileName, sizeof(lastFile)-1);
+   strncpy(lastVar, varName, sizeof(lastVar)-1);
 }
 
 
-/* We provide progress mainly for very large files, hundreds of megabytes
-   or more. The % complete is computed by assuming that the total number
-   of bytes in the file is primarily float and double data. Of course, there
-   can be a lot of integer data too, but rarely is it more than 10-20% of
-   the whole file. So, our % complete measure is a rough approximation that
-   is always an underestimate. Next, we would like to update the user about
-   progress on an elapsed time basis. So, we need to know how much time has
-   gone by. However, if we call gettimeofday after every NaN test, that would
-   kill us! So, we predict how long in the future, in terms of number of
-   NaN checks, we can go before we need to peek at the time. Then, we call
-   gettimeofday. At that point, we know how much time has passed since the
-   last call and we know how many checks we've done. We can compute the
-   current check rate and a new count of checks into the future before we
-   need to call gettimeofday again. */
+/* Progress is reported on the basis of the bytes of float and double data
+   read so far against the total size of the files. Of course, there can
+   be a lot of integer data too, but rarely is it more than 10-20% of the
+   whole file. So, our % complete measure is a rough approximation that is
+   always an underestimate. The time is checked once per array read which
+   is cheap compared to reading the array. */
 static void
-updateProgress(int bytes)
+updateProgress(long long bytes)
 {
-   static int nextUpdate;
-   static int processedBytes;
-   static int checksPerformed;
+   static long long processedBytes;
    static double tLast;
    struct timeval timeVal;
-   struct timezone timeZone;
+   double tNow;
+
+   gettimeofday(&timeVal, NULL);
+   tNow = (double) timeVal.tv_sec + (double) timeVal.tv_usec * 1.0E-6;
 
    /* bytes==0 ==> initialization */
    if (bytes == 0)
    {
-      nextUpdate = INITIAL_CHECK_RATE * UPDATE_INTERVAL;
       processedBytes = 0;
-      checksPerformed = 0;
-      gettimeofday(&timeVal, &timeZone);
-      tLast = (double) timeVal.tv_sec + (double) timeVal.tv_usec * 1.0E-6;
+      tLast = tNow;
+      return;
    }
-   else
+
+   processedBytes += bytes;
+   if (!disableProgress && tNow - tLast >= UPDATE_INTERVAL && totalBytes > 0)
    {
+      long long pct = processedBytes * 100 / totalBytes;
+      printf("\n*** %2lld %% completed ***\n", pct > 99 ? 99 : pct);
+      tLast = tNow;
+   }
+}
 
-      processedBytes += bytes;
-      checksPerformed++;
 
-      if (checksPerformed >= nextUpdate)
-      {
-         double currentCheckRate;
-         double tNow;
+/* Record that an array of the current file has been queued. Arrays shared
+   by several objects or also listed as simple arrays are scanned only
+   once. Returns True if the array was not seen before. */
+static int
+markSeen(char const *name)
+{
+   unsigned long h = 5381;
+   char const *p;
+   int i;
 
-         printf("\n*** %2d %% completed ***\n", processedBytes*100/totalBytes);
+   if (2 * (seenCount + 1) > seenSize)
+   {
+      char **oldTable = seenTable;
+      int oldSize = seenSize;
 
-         gettimeofday(&timeVal, &timeZone);
-         tNow = (double) timeVal.tv_sec + (double) timeVal.tv_usec * 1.0E-6;
-         currentCheckRate = checksPerformed / (tNow - tLast);
-         nextUpdate += (currentCheckRate * UPDATE_INTERVAL);
-         tLast = tNow;
+      seenSize = seenSize ? 2 * seenSize : 1024;
+      seenTable = (char **) calloc(seenSize, sizeof(char*));
+      seenCount = 0;
+      for (i = 0; i < oldSize; i++)
+      {
+         if (oldTable[i] != NULL)
+         {
+            markSeen(oldTable[i]);
+            free(oldTable[i]);
+         }
       }
+      free(oldTable);
+   }
+
+   for (p = name; *p; p++)
+      h = h * 33 + (unsigned char) *p;
+   for (i = (int) (h % seenSize); seenTable[i] != NULL; i = (i + 1) % seenSize)
+   {
+      if (!strcmp(seenTable[i], name))
+         return False;
    }
+   seenTable[i] = strdup(name);
+   seenCount++;
+   return True;
 }
 
+static void
+clearSeen(void)
+{
+   int i;
+   for (i = 0; i < seenSize; i++)
+      free(seenTable[i]);
+   free(seenTable);
+   seenTable = NULL;
+   seenSize = seenCount = 0;
+}
 
-/* We examine all of Silo's data by traversing the all the "simple" arrays
-   in the file. Ultimately, the data associated with all of Silo's abstract
-   objects, excpet for object headers, is implemented in terms of simple
-   arrays. This function finds all the simple arrays in the current dir
-   and for each float or double array, reads it and examines it for NaNs.
-   To avoid constantly allocating and freeing the buffers for arrays, we
-   simply keep a growing buffer that grows to the largest array in the file
-   and is freed only upon exit. We use Silo's non-allocating simple array
-   read function. To make the loops for checking a NaN as fast as possible,
-   we have two versions of the loop, one where progress is checked and 
-   one where progress is not checked. We first examine all the simple
-   arrays in the current dir, then we loop over subdirs and recurse */
+
+/* Add the counts of a finished chunk to its array. The last chunk of an
+   array adds the array to the totals and frees it. */
 static void
-scanSiloDir(DBfile *siloFile, char *theDir)
+finishChunk(arrayJob *job, long long nNan, long long nInf, long long first)
 {
-   char **dirNames;
-   int i,nDirs,nObjects;
-   DBtoc *toc;
+   int last;
 
-   DBNewToc(siloFile);
-   toc = DBGetToc(siloFile);
+#ifdef _OPENMP
+#pragma omp critical(silock_job)
+#endif
+   {
+      job->nNan += nNan;
+      job->nInf += nInf;
+      if (first >= 0 && (job->first < 0 || first < job->first))
+         job->first = first;
+      last = --job->pending == 0;
+   }
 
-   if (toc == NULL)
-      return ;
+   if (!last)
+      return;
+
+#ifdef _OPENMP
+#pragma omp critical(silock_summary)
+#endif
+   {
+      nArrays++;
+      nValues += job->n;
+      nBytesScanned += job->nBytes;
+      nNanTotal += job->nNan;
+      nInfTotal += job->nInf;
+      if (job->nNan || job->nInf)
+      {
+         if (nIssues == maxIssues)
+         {
+            maxIssues = maxIssues ? 2 * maxIssues : 64;
+            issues = (arrayIssue *) realloc(issues, maxIssues * sizeof(arrayIssue));
+         }
+         issues[nIssues].fileIndex = job->fileIndex;
+         issues[nIssues].varName = job->varName;
+         issues[nIssues].dbType = job->dbType;
+         issues[nIssues].nNan = job->nNan;
+         issues[nIssues].nInf = job->nInf;
+         issues[nIssues].first = job->first;
+         nIssues++;
+         job->varName = NULL;
+      }
+      pendingBytes -= job->nBytes;
+   }
 
-   nObjects = toc->nvar + toc->ndir;
+   free(job->varName);
+   free(job->buf);
+   free(job);
+}
 
-   if (!nObjects)
-      return ;
 
-   /* process the simple arrays in this dir */
-   for (i = 0; i < toc->nvar; i++)
+/* Scan values [lo,hi) of an array for NaNs and Infs. Each block of values
+   is first tested without branching so that the compiler can vectorize
+   the loop. Only a block holding a bad value is examined value by value. */
+static void
+scanFloats(arrayJob *job, long long lo, long long hi)
+{
+   unsigned int const *bits = (unsigned int const *) job->buf;
+   long long b, j, nNan = 0, nInf = 0, first = -1;
+
+   for (b = lo; b < hi; b += SCAN_BLOCK)
    {
-      char *varName = toc->var_names[i];
-      int n         = DBGetVarLength(siloFile, varName);
-      int dbType    = DBGetVarType(siloFile, varName);
-      int j;
+      long long e = b + SCAN_BLOCK < hi ? b + SCAN_BLOCK : hi;
+      unsigned int bad = 0;
+
+#ifdef _OPENMP
+#pragma omp simd reduction(|:bad)
+#endif
+      for (j = b; j < e; j++)
+         bad |= (bits[j] & FLOAT_EXP_MASK) == FLOAT_EXP_MASK;
 
-      if (!disableVerbose)
+      if (!bad)
+         continue;
+
+      for (j = b; j < e; j++)
       {
-         if (dbType == DB_FLOAT || dbType == DB_DOUBLE)
-            printf("CHECKING array %-56s\r", varName);
+         float value;
+
+         if ((bits[j] & FLOAT_EXP_MASK) != FLOAT_EXP_MASK)
+            continue;
+         if (bits[j] & FLOAT_MANT_MASK)
+            nNan++;
          else
-            printf("skipping array %-56s\r", varName);
+            nInf++;
+         if (first < 0)
+            first = j;
+         memcpy(&value, &bits[j], sizeof(value));
+#ifdef _OPENMP
+#pragma omp critical(silock_report)
+#endif
+         handleInvalidValue(fileNames[job->fileIndex], job->varName, j,
+            (double) value);
       }
+   }
 
-      /* for float arrays */
-      if (dbType == DB_FLOAT)
-      {
+   finishChunk(job, nNan, nInf, first);
+}
 
-         /* increase allocated buffer if necessary */
-         if (n*sizeof(float) > fBufSize)
-         {
-            if (fBuf != NULL)
-               free(fBuf);
-            fBuf = (float *) malloc(n * sizeof(float));
-            fBufSize = n;
-         }
+static void
+scanDoubles(arrayJob *job, long long lo, long long hi)
+{
+   unsigned long long const *bits = (unsigned long long const *) job->buf;
+   long long b, j, nNan = 0, nInf = 0, first = -1;
 
-         DBReadVar(siloFile, varName, fBuf);
+   for (b = lo; b < hi; b += SCAN_BLOCK)
+   {
+      long long e = b + SCAN_BLOCK < hi ? b + SCAN_BLOCK : hi;
+      unsigned int bad = 0;
 
-         if (disableProgress)
-         {
-            for (j = 0; j < n; j++)
-               if (!IS_VALID_FLOAT(fBuf[j]))
-                  handleInvalidValue(theDir, varName, j, (double) fBuf[j]);
-         }
+#ifdef _OPENMP
+#pragma omp simd reduction(|:bad)
+#endif
+      for (j = b; j < e; j++)
+         bad |= (bits[j] & DOUBLE_EXP_MASK) == DOUBLE_EXP_MASK;
+
+      if (!bad)
+         continue;
+
+      for (j = b; j < e; j++)
+      {
+         double value;
+
+         if ((bits[j] & DOUBLE_EXP_MASK) != DOUBLE_EXP_MASK)
+            continue;
+         if (bits[j] & DOUBLE_MANT_MASK)
+            nNan++;
          else
-         {
-            for (j = 0; j < n; j++)
-            {
-               if (!IS_VALID_FLOAT(fBuf[j]))
-                  handleInvalidValue(theDir, varName, j, (double) fBuf[j]);
-               updateProgress(sizeof(float));
-            }
-         }
+            nInf++;
+         if (first < 0)
+            first = j;
+         memcpy(&value, &bits[j], sizeof(value));
+#ifdef _OPENMP
+#pragma omp critical(silock_report)
+#endif
+         handleInvalidValue(fileNames[job->fileIndex], job->varName, j, value);
       }
+   }
 
-      /* for double arrays */
-      if (dbType == DB_DOUBLE)
-      {
-         /* increase allocated buffer if necessary */
-         if (n*sizeof(double) > dBufSize)
-         {
-            if (dBuf != NULL)
-               free(dBuf);
-            dBuf = (double *) malloc(n * sizeof(double));
-            dBufSize = n;
-         }
+   finishChunk(job, nNan, nInf, first);
+}
 
-         DBReadVar(siloFile, varName, dBuf);
 
-         if (disableProgress)
-         {
-            for (j = 0; j < n; j++)
-               if (!IS_VALID_DOUBLE(dBuf[j]))
-                  handleInvalidValue(theDir, varName, j, dBuf[j]);
-         }
+/* Read a float or double array and queue it for scanning. Reads happen
+   on one thread because the Silo library is not thread safe. The scans
+   are handed to the other threads as tasks, one per chunk of the array.
+   To bound the memory held by arrays read but not yet scanned, the reader
+   waits for the queued scans to finish once the read-ahead limit would
+   be exceeded. */
+static void
+queueArray(DBfile *siloFile, int fileIndex, char const *varName)
+{
+   int dbType = DBGetVarType(siloFile, varName);
+   long long n, lo, nBytes, pending;
+   arrayJob *job;
+
+   if (dbType != DB_FLOAT && dbType != DB_DOUBLE)
+   {
+      if (!disableVerbose && dbType >= 0)
+         printf("skipping array %-56s\r", varName);
+      return;
+   }
+
+   n = DBGetVarLength(siloFile, varName);
+   if (n <= 0)
+      return;
+
+   if (!disableVerbose)
+      printf("CHECKING array %-56s\r", varName);
+
+   nBytes = n * (dbType == DB_FLOAT ? sizeof(float) : sizeof(double));
+
+#ifdef _OPENMP
+#pragma omp critical(silock_summary)
+#endif
+   pending = pendingBytes;
+   if (pending > 0 && pending + nBytes > readAhead)
+   {
+#ifdef _OPENMP
+#pragma omp taskwait
+#endif
+   }
+
+   job = (arrayJob *) calloc(1, sizeof(arrayJob));
+   job->buf = malloc(nBytes);
+   if (job->buf == NULL || DBReadVar(siloFile, varName, job->buf) < 0)
+   {
+      fprintf(stderr, "unable to read array \"%s\"\n", varName);
+      free(job->buf);
+      free(job);
+      return;
+   }
+   job->fileIndex = fileIndex;
+   job->varName = strdup(varName);
+   job->dbType = dbType;
+   job->n = n;
+   job->nBytes = nBytes;
+   job->pending = (int) ((n + SCAN_CHUNK - 1) / SCAN_CHUNK);
+   job->first = -1;
+
+#ifdef _OPENMP
+#pragma omp critical(silock_summary)
+#endif
+   pendingBytes += nBytes;
+
+   for (lo = 0; lo < n; lo += SCAN_CHUNK)
+   {
+      long long hi = lo + SCAN_CHUNK < n ? lo + SCAN_CHUNK : n;
+#ifdef _OPENMP
+#pragma omp task firstprivate(job, lo, hi)
+#endif
+      {
+         if (job->dbType == DB_FLOAT)
+            scanFloats(job, lo, hi);
          else
-         {
-            for (j = 0; j < n; j++)
-            {
-               if (!IS_VALID_DOUBLE(dBuf[j]))
-                  handleInvalidValue(theDir, varName, j, dBuf[j]);
-               updateProgress(sizeof(double));
-            }
-         }
+            scanDoubles(job, lo, hi);
       }
-   } /* for i */
+   }
 
-   /* save off the dir-stuff out of the toc so we don't loose it during the
-      recursions */
-   nDirs = toc->ndir;
-   dirNames = (char **) malloc(nDirs * sizeof(char*));
-   for (i = 0; i < nDirs; i++)
+   updateProgress(nBytes);
+}
+
+
+/* Form the absolute name of a name relative to the current dir */
+static void
+absoluteName(char const *theDir, char const *name, char *absName, int len)
+{
+   if (name[0] == '/')
+      snprintf(absName, len, "%s", name);
+   else if (!strcmp(theDir, "/"))
+      snprintf(absName, len, "/%s", name);
+   else
+      snprintf(absName, len, "%s/%s", theDir, name);
+}
+
+
+/* The data of Silo's objects is stored in arrays whose names are held in
+   the object's components. With the PDB driver these arrays also show up
+   as simple arrays in the toc but with the HDF5 driver they live in the
+   hidden /.silo dir. So, we find the arrays of each object here. A
+   component naming an array is either a bare name or a string value,
+   '<s>name'. Other string valued components name sub-objects or hold
+   labels and are weeded out by DBGetVarType failing on them. */
+static void
+queueObjectArrays(DBfile *siloFile, int fileIndex, char const *theDir,
+   char const *objName)
+{
+   DBobject *obj;
+   int i;
+
+   obj = DBGetObject(siloFile, objName);
+   if (obj == NULL)
+      return;
+
+   for (i = 0; i < obj->ncomponents; i++)
+   {
+      char const *pdbName = obj->pdb_names[i];
+      char name[1024], absName[1024];
+
+      if (pdbName == NULL)
+         continue;
+      if (!strncmp(pdbName, "'<s>", 4))
+      {
+         size_t len = strlen(pdbName + 4);
+         if (len == 0 || len >= sizeof(name))
+            continue;
+         strcpy(name, pdbName + 4);
+         if (name[len-1] == '\'')
+            name[len-1] = '\0';
+      }
+      else if (pdbName[0] == '\'')
+      {
+         continue;
+      }
+      else
+      {
+         strncpy(name, pdbName, sizeof(name)-1);
+         name[sizeof(name)-1] = '\0';
+      }
+
+      absoluteName(theDir, name, absName, sizeof(absName));
+      if (markSeen(absName))
+         queueArray(siloFile, fileIndex, absName);
+   }
+
+   DBFreeObject(obj);
+}
+
+
+/* Copy a list of names out of the toc */
+static void
+appendNames(char ***list, int *n, char **names, int count)
+{
+   int i;
+
+   if (count <= 0)
+      return;
+   *list = (char **) realloc(*list, (*n + count) * sizeof(char*));
+   for (i = 0; i < count; i++)
+      (*list)[(*n)++] = strdup(names[i]);
+}
+
+static void
+freeNames(char **list, int n)
+{
+   int i;
+   for (i = 0; i < n; i++)
+      free(list[i]);
+   free(list);
+}
+
+
+/* We examine all of Silo's data by traversing all the "simple" arrays in
+   the file and the arrays of all the objects. This function queues every
+   float or double array in the current dir for scanning, then we loop
+   over subdirs and recurse. The names are copied out of the toc first
+   because reading objects and changing dirs invalidates the toc. */
+static void
+scanSiloDir(DBfile *siloFile, int fileIndex, char *theDir)
+{
+   char **varNames = NULL, **objNames = NULL, **dirNames = NULL;
+   int i, nVars = 0, nObjs = 0, nDirs = 0;
+   DBtoc *toc;
+
+   DBNewToc(siloFile);
+   toc = DBGetToc(siloFile);
+
+   if (toc == NULL)
+      return ;
+
+   appendNames(&varNames, &nVars, toc->var_names, toc->nvar);
+   appendNames(&objNames, &nObjs, toc->curve_names, toc->ncurve);
+   appendNames(&objNames, &nObjs, toc->csgmesh_names, toc->ncsgmesh);
+   appendNames(&objNames, &nObjs, toc->csgvar_names, toc->ncsgvar);
+   appendNames(&objNames, &nObjs, toc->qmesh_names, toc->nqmesh);
+   appendNames(&objNames, &nObjs, toc->qvar_names, toc->nqvar);
+   appendNames(&objNames, &nObjs, toc->ucdmesh_names, toc->nucdmesh);
+   appendNames(&objNames, &nObjs, toc->ucdvar_names, toc->nucdvar);
+   appendNames(&objNames, &nObjs, toc->ptmesh_names, toc->nptmesh);
+   appendNames(&objNames, &nObjs, toc->ptvar_names, toc->nptvar);
+   appendNames(&objNames, &nObjs, toc->mat_names, toc->nmat);
+   appendNames(&objNames, &nObjs, toc->matspecies_names, toc->nmatspecies);
+   appendNames(&objNames, &nObjs, toc->obj_names, toc->nobj);
+   appendNames(&dirNames, &nDirs, toc->dir_names, toc->ndir);
+
+   /* process the simple arrays in this dir */
+   for (i = 0; i < nVars; i++)
    {
-      dirNames[i] = (char *) malloc(strlen(toc->dir_names[i])+1);
-      strcpy(dirNames[i], toc->dir_names[i]);
+      char absName[1024];
+      absoluteName(theDir, varNames[i], absName, sizeof(absName));
+      if (markSeen(absName))
+         queueArray(siloFile, fileIndex, absName);
    }
 
+   /* process the arrays of the objects in this dir */
+   DBShowErrors(DB_NONE, NULL);
+   for (i = 0; i < nObjs; i++)
+      queueObjectArrays(siloFile, fileIndex, theDir, objNames[i]);
+   DBShowErrors(DB_TOP, NULL);
+
    /* recurse on any subdirs */
    for (i = 0; i < nDirs; i++)
    {
+      char absDir[1024];
+      absoluteName(theDir, dirNames[i], absDir, sizeof(absDir));
       DBSetDir(siloFile, dirNames[i]);
-      scanSiloDir(siloFile, dirNames[i]); 
+      scanSiloDir(siloFile, fileIndex, absDir);
       DBSetDir(siloFile, "..");
-      free(dirNames[i]);
    }
 
-   /* free the dir-stuff we set aside */
-   free(dirNames);
+   freeNames(varNames, nVars);
+   freeNames(objNames, nObjs);
+   freeNames(dirNames, nDirs);
+}
+
 
+static void
+scanSiloFile(int fileIndex, char const *progName)
+{
+   DBfile *siloFile;
+
+   DBShowErrors(DB_NONE, NULL);
+
+   siloFile = DBOpen(fileNames[fileIndex], DB_UNKNOWN, DB_READ);
+
+   if (siloFile == NULL)
+   {
+      fprintf(stderr, "unable to open silo file \"%s\"\n", fileNames[fileIndex]);
+      exit(-1);
+   }
+
+   DBShowErrors(DB_TOP, NULL);
+
+   if (DBGetDriverType(siloFile) == DB_HDF5 && !DBGuessHasFriendlyHDF5Names(siloFile))
+   {
+       fprintf(stderr,"WARNING: This is an HDF5 file without \"Friendly\" HDF5 array names.\n");
+       fprintf(stderr,"WARNING: Consequently, while %s will be able to find/detect nans/infs,\n",
+           strrchr(progName,'/')?strrchr(progName,'/')+1:progName);
+       fprintf(stderr,"WARNING: the names of the arrays in which it finds them will be cryptic.\n");
+       fprintf(stderr,"WARNING: You will most likely have to use h5ls/h5dump to determine which\n");
+       fprintf(stderr,"WARNING: Silo objects are involved.\n");
+       DBSetDir(siloFile, "/.silo");
+       scanSiloDir(siloFile, fileIndex, "/.silo");
+   }
+   else
+   {
+       scanSiloDir(siloFile, fileIndex, "/");
+   }
+
+   DBClose(siloFile);
+   clearSeen();
+}
+
+
+static int
+compareIssues(void const *a, void const *b)
+{
+   arrayIssue const *ia = (arrayIssue const *) a;
+   arrayIssue const *ib = (arrayIssue const *) b;
+
+   if (ia->fileIndex != ib->fileIndex)
+      return ia->fileIndex < ib->fileIndex ? -1 : 1;
+   return strcmp(ia->varName, ib->varName);
+}
+
+static void
+writeJsonString(FILE *out, char const *s)
+{
+   fputc('"', out);
+   for (; *s; s++)
+   {
+      if (*s == '"' || *s == '\\')
+         fprintf(out, "\\%c", *s);
+      else if ((unsigned char) *s < 0x20)
+         fprintf(out, "\\u%04x", (unsigned char) *s);
+      else
+         fputc(*s, out);
+   }
+   fputc('"', out);
+}
+
+/* Write a JSON summary of the scan, with one entry for each array found
+   to contain bad values. */
+static void
+writeSummary(char const *summaryName)
+{
+   FILE *out = strcmp(summaryName, "-") ? fopen(summaryName, "w") : stdout;
+   int i;
+
+   if (out == NULL)
+   {
+      fprintf(stderr, "unable to open summary file \"%s\"\n", summaryName);
+      return;
+   }
+
+   qsort(issues, nIssues, sizeof(arrayIssue), compareIssues);
+
+   fprintf(out, "{\n");
+   fprintf(out, "  \"files\": %d,\n", nFiles);
+   fprintf(out, "  \"arrays\": %lld,\n", nArrays);
+   fprintf(out, "  \"values\": %lld,\n", nValues);
+   fprintf(out, "  \"bytes\": %lld,\n", nBytesScanned);
+   fprintf(out, "  \"nan\": %lld,\n", nNanTotal);
+   fprintf(out, "  \"inf\": %lld,\n", nInfTotal);
+   fprintf(out, "  \"issues\": [");
+   for (i = 0; i < nIssues; i++)
+   {
+      fprintf(out, "%s\n    {\"file\": ", i ? "," : "");
+      writeJsonString(out, fileNames[issues[i].fileIndex]);
+      fprintf(out, ", \"array\": ");
+      writeJsonString(out, issues[i].varName);
+      fprintf(out, ", \"type\": \"%s\", \"nan\": %lld, \"inf\": %lld, \"first\": %lld}",
+         issues[i].dbType == DB_FLOAT ? "float" : "double",
+         issues[i].nNan, issues[i].nInf, issues[i].first);
+   }
+   fprintf(out, "%s]\n}\n", nIssues ? "\n  " : "");
+
+   if (out != stdout)
+      fclose(out);
 }
 
 
@@ -353,24 +771,15 @@ int
 main(int argc, char *argv[])
 {
    int i;
-   DBfile *siloFile;
+   char *summaryName = NULL;
 
    /* set default values */
    disableProgress = False;
    disableVerbose  = False;
+   readAhead = (long long) READ_AHEAD << 20;
 
-   /* initialization */
-   fBufSize = 0;
-   dBufSize = 0;
-   fBuf = NULL;
-   dBuf = NULL;
-
-   /* here's where we issue an error message if we have no isnan() test */
-#ifndef HAVE_ISNAN
-   fprintf(stderr,"silock cannot operate on this platform.\n");
-   fprintf(stderr,"No isnan() function was found during configure\n");
-   exit(-1);
-#endif
+   fileNames = (char **) malloc(argc * sizeof(char*));
+   nFiles = 0;
 
    /* process the command line */
    for (i = 1; i < argc; i++)
@@ -379,78 +788,78 @@ main(int argc, char *argv[])
          disableProgress = True;
       else if (!strcmp(argv[i], "-q"))
          disableVerbose = True;
+      else if (!strcmp(argv[i], "-j") && i+1 < argc)
+      {
+#ifdef _OPENMP
+         omp_set_num_threads(atoi(argv[++i]));
+#else
+         fprintf(stderr,"-j ignored; silock was built without OpenMP\n");
+         i++;
+#endif
+      }
+      else if (!strcmp(argv[i], "-readahead") && i+1 < argc)
+         readAhead = atoll(argv[++i]) << 20;
+      else if (!strcmp(argv[i], "-summary") && i+1 < argc)
+         summaryName = argv[++i];
       else if (!strcmp(argv[i], "-help"))
       {
-         fprintf(stderr,"Scan a silo file for NaN/Inf floating point data\n"); 
+         fprintf(stderr,"Scan silo files for NaN/Inf floating point data\n"); 
          fprintf(stderr,"Warning: As a precaution, you should use this tool\n");
          fprintf(stderr,"         only on the same class of platform the\n");
          fprintf(stderr,"         data was generated on.\n");
-         fprintf(stderr,"usage: silock [-q] [-progress]"
-            " silofile\n");
+         fprintf(stderr,"usage: silock [-q] [-progress] [-j n] [-readahead mb]"
+            " [-summary file] silofile...\n");
          fprintf(stderr,"available options...\n");
-         fprintf(stderr,"   -progress: Disable progress display\n");
-         fprintf(stderr,"   -q:        Quiet. Report only if bad values\n");
-         fprintf(stderr,"              exist and exit on first occurence\n");
+         fprintf(stderr,"   -progress:     Disable progress display\n");
+         fprintf(stderr,"   -q:            Quiet. Report only if bad values\n");
+         fprintf(stderr,"                  exist and exit on first occurence\n");
+         fprintf(stderr,"   -j n:          Scan with n threads\n");
+         fprintf(stderr,"   -readahead mb: Megabytes of arrays to read ahead\n");
+         fprintf(stderr,"                  of the scanning threads [%d]\n", READ_AHEAD);
+         fprintf(stderr,"   -summary file: Write a JSON summary to file (- for stdout)\n");
          exit(-1);
       }
       else /* assume its a file and try to open it */
       {
          struct stat stat_buf;
 
-         strncpy(fileName, argv[i], sizeof(fileName)-1);
-         if (stat(fileName, &stat_buf) != 0)
+         if (stat(argv[i], &stat_buf) != 0)
          {
             fprintf(stderr,"unrecognized option \"%s\". Use -help for usage\n",
-               fileName);
+               argv[i]);
             exit(-1);
          }
-         totalBytes = stat_buf.st_size;
+         fileNames[nFiles++] = argv[i];
+         totalBytes += stat_buf.st_size;
       }
    }
 
    /* initialize progress meter */
    updateProgress(0);
 
-   DBShowErrors(DB_NONE, NULL);
-
-   siloFile = DBOpen(fileName, DB_UNKNOWN, DB_READ);
-
-   if (siloFile == NULL)
-   {
-      fprintf(stderr, "unable to open silo file \"%s\"\n", fileName);
-      exit(-1);
-   }
-
-   DBShowErrors(DB_TOP, NULL);
-
-   if (DBGetDriverType(siloFile) == DB_HDF5 && !DBGuessHasFriendlyHDF5Names(siloFile))
-   {
-       fprintf(stderr,"WARNING: This is an HDF5 file without \"Friendly\" HDF5 array names.\n");
-       fprintf(stderr,"WARNING: Consequently, while %s will be able to find/detect nans/infs,\n",
-           strrchr(argv[0],'/')?strrchr(argv[0],'/')+1:argv[0]);
-       fprintf(stderr,"WARNING: the names of the arrays in which it finds them will be cryptic.\n");
-       fprintf(stderr,"WARNING: You will most likely have to use h5ls/h5dump to determine which\n");
-       fprintf(stderr,"WARNING: Silo objects are involved.\n");
-       DBSetDir(siloFile, "/.silo");
-       scanSiloDir(siloFile, "/.silo");
-   }
-   else
+   /* One thread reads the files while the others scan what it has read */
+#ifdef _OPENMP
+#pragma omp parallel
+#pragma omp single
+#endif
    {
-       scanSiloDir(siloFile, "/");
+      for (i = 0; i < nFiles; i++)
+         scanSiloFile(i, argv[0]);
+#ifdef _OPENMP
+#pragma omp taskwait
+#endif
    }
 
-   DBClose(siloFile);
-
-   if (fBuf != NULL)
-      free(fBuf);
-   if (dBuf != NULL)
-      free(dBuf);
-
    if (!disableProgress)
       printf("\n*** 100 %% completed ***\n");
 
    if (!disableVerbose)
       printf("\n");
 
+   if (summaryName != NULL)
+      writeSummary(summaryName);
+
+   free(fileNames);
+
    return 0;
 }